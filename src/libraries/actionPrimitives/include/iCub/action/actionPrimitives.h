@@ -181,6 +181,31 @@ struct ActionPrimitivesWayPoint
 };
 
 
+/**
+* \ingroup ActionPrimitives
+*
+* Samples the cubic spline employed to blend the waypoints in the
+* joint space. The spline passes through the points at the given
+* times and is at rest at both ends.
+* @param t the times [s] of the points, starting from 0 and
+*          strictly increasing.
+* @param qWP the points, one for each time.
+* @param dt the sampling period [s].
+* @param qMin the lower bounds the samples are clipped to.
+* @param qMax the upper bounds the samples are clipped to.
+* @param traj the samples, one per row: the first is taken at dt,
+*             the last at the final time.
+* @param wpSample the row at which each point but the first one is
+*                 attained.
+* @return true/false on success/failure.
+*/
+bool blendWayPoints(const std::vector<double> &t,
+                    const std::vector<yarp::sig::Vector> &qWP,
+                    const double dt, const yarp::sig::Vector &qMin,
+                    const yarp::sig::Vector &qMax, yarp::sig::Matrix &traj,
+                    std::vector<size_t> &wpSample);
+
+
 /**
 * \ingroup ActionPrimitives
 *
@@ -202,6 +227,7 @@ protected:
     yarp::dev::IControlMode      *modCtrl;
     yarp::dev::IEncoders         *encCtrl;
     yarp::dev::IPositionControl  *posCtrl;
+    yarp::dev::IPositionDirect   *posDirCtrl;
     yarp::dev::ICartesianControl *cartCtrl;
 
     perception::Model            *graspModel;
@@ -229,6 +255,8 @@ protected:
     bool reachTmoEnabled;
     bool locked;
     bool verbose;
+    bool blendedWayPoints;
+    bool timingWayPoints;
 
     double default_exec_time;
     double waitTmo;
@@ -236,6 +264,9 @@ protected:
     double latchTimerWait;
     double latchTimerReach;
     double latchTimerReachLog;
+    double latchTimerWayPoints;
+    double wayPointsPlanningTime;
+    double wayPointsExecTime;
 
     int jHandMin;
     int jHandMax;
@@ -255,6 +286,7 @@ protected:
     std::multimap<int,int> fingers2JntsMap;
 
     friend class ArmWayPoints;
+    friend class ArmBlendedWayPoints;
 
     struct HandWayPoint
     {
@@ -311,6 +343,7 @@ protected:
     virtual bool _pushAction(const yarp::sig::Vector &x, const yarp::sig::Vector &o,
                              const std::string &handSeqKey, const double execTime,
                              ActionPrimitivesCallback *clb, const bool oEnabled);
+    virtual yarp::os::PeriodicThread *createWayPointsThread(const std::deque<ActionPrimitivesWayPoint> &wayPoints);
     virtual bool handCheckMotionDone(const int jnt);
     virtual bool wait(const Action &action);
     virtual bool cmdArm(const Action &action);
@@ -376,6 +409,10 @@ public:
     *  
     * @b verbosity <string>: enable/disable the verbose mode; 
     *    possible values: "on"/"off".
+    *  
+    * @b blended_waypoints <string>: enable/disable the blended 
+    *    execution of waypoints; possible values: "on"/"off".
+    * @see setBlendedWayPoints
     *
     * @b torso_pitch <string>: if "on" it enables the control of the
     *    pitch of the torso.
@@ -827,6 +864,42 @@ public:
     */
     virtual bool getTrackingMode() const;
 
+    /**
+    * Select how the trajectories given in terms of waypoints are 
+    * executed. 
+    * @param f true for the blended execution, false for the 
+    *          execution waypoint by waypoint through the Cartesian
+    *          controller.
+    * @return true/false on success/failure. 
+    * @note In blended mode the joints configurations of all the 
+    *       waypoints are solved in advance, each one starting off
+    *       the previous solution, and then joined by a cubic
+    *       spline that is streamed to the arm joints in position
+    *       direct mode, without stopping at the waypoints. Only the
+    *       waypoints durations are taken into account and the torso
+    *       is kept still. Fingers sequences run concurrently as
+    *       usual.
+    */
+    virtual bool setBlendedWayPoints(const bool f);
+
+    /**
+    * Get the current execution mode of waypoints.
+    * @return true/false on blended/waypoint by waypoint execution.
+    */
+    virtual bool getBlendedWayPoints() const;
+
+    /**
+    * Retrieve the timings of the last trajectory executed in terms 
+    * of waypoints, useful to compare the execution modes. 
+    * @param planning the time [s] spent before moving (i.e. the 
+    *                 solution of all the waypoints in blended
+    *                 mode).
+    * @param execution the time [s] elapsed from the start of the 
+    *                  action until the arm came to rest.
+    * @return true/false on success/fail. 
+    */
+    virtual bool getWayPointsTimes(double &planning, double &execution) const;
+
     /**
     * Enable the waving mode that keeps on moving the arm around a 
     * predefined position. 
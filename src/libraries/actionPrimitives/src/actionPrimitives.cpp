@@ -41,6 +41,8 @@
 #define ACTIONPRIM_DEFAULT_PART                     "right_arm"
 #define ACTIONPRIM_DEFAULT_TRACKINGMODE             "off"
 #define ACTIONPRIM_DEFAULT_VERBOSITY                "off"
+#define ACTIONPRIM_DEFAULT_BLENDEDWP                "off"
+#define ACTIONPRIM_BLENDEDWP_PER                    0.01    // [s]
 #define ACTIONPRIM_DEFAULT_WBDYN_STEMNAME           "wholeBodyDynamics"
 #define ACTIONPRIM_DEFAULT_WBDYN_PORTNAME           "cartesianEndEffectorWrench:o"
 
@@ -200,6 +202,207 @@ public:
 };
 
 
+// This class streams the arm way points as one blended joint-space trajectory
+/************************************************************************/
+class ArmBlendedWayPoints : public PeriodicThread
+{
+    deque<ActionPrimitivesWayPoint> wayPoints;
+    ActionPrimitives  *action;
+    ICartesianControl *cartCtrl;
+    double default_exec_time;
+    vector<int> armJnts;
+    vector<int> modes;
+    vector<size_t> wpSample;
+    Matrix traj;
+    size_t i,k;
+
+    /************************************************************************/
+    double checkTime(const double time) const
+    {
+        return std::max(time,0.01);
+    }
+
+    /************************************************************************/
+    double checkDefaultTime(const double time) const
+    {
+        return (time>0.0?time:default_exec_time);
+    }
+
+    /************************************************************************/
+    void execCallback()
+    {
+        if (wayPoints[i].callback!=NULL)
+        {
+            action->printMessage(log::no_info,"executing waypoint(%d)-end callback ...",i);
+            wayPoints[i].callback->exec();
+            action->printMessage(log::no_info,"... waypoint(%d)-end callback executed",i);
+        }
+    }
+
+    /************************************************************************/
+    bool solveWayPoints(vector<Vector> &qWP)
+    {
+        Vector dof;
+        if (!cartCtrl->getDOF(dof))
+            return false;
+
+        Vector q0,xdhat,odhat,qdhat;
+        for (size_t j=0; j<wayPoints.size(); j++)
+        {
+            // each solution starts off the previous one
+            bool ok;
+            if (j==0)
+                ok=wayPoints[j].oEnabled?
+                   cartCtrl->askForPose(wayPoints[j].x,wayPoints[j].o,xdhat,odhat,qdhat):
+                   cartCtrl->askForPosition(wayPoints[j].x,xdhat,odhat,qdhat);
+            else
+                ok=wayPoints[j].oEnabled?
+                   cartCtrl->askForPose(q0,wayPoints[j].x,wayPoints[j].o,xdhat,odhat,qdhat):
+                   cartCtrl->askForPosition(q0,wayPoints[j].x,xdhat,odhat,qdhat);
+
+            if (!ok || (qdhat.length()<armJnts.size()) || (qdhat.length()!=dof.length()))
+            {
+                action->printMessage(log::error,"unable to solve waypoint(%d)",j);
+                return false;
+            }
+
+            q0.clear();
+            for (size_t n=0; n<dof.length(); n++)
+                if (dof[n]!=0.0)
+                    q0.push_back(qdhat[n]);
+
+            // the arm comes last in the chain
+            qWP.push_back(qdhat.subVector(qdhat.length()-armJnts.size(),qdhat.length()-1));
+        }
+
+        return true;
+    }
+
+    /************************************************************************/
+    bool interpolate(const vector<double> &t, const vector<Vector> &qWP, const double dt)
+    {
+        Vector qMin(armJnts.size(),-std::numeric_limits<double>::max());
+        Vector qMax(armJnts.size(),std::numeric_limits<double>::max());
+
+        IControlLimits *lim=NULL;
+        action->polyHand.view(lim);
+        if (lim!=NULL)
+            for (size_t jnt=0; jnt<armJnts.size(); jnt++)
+                lim->getLimits(armJnts[jnt],&qMin[jnt],&qMax[jnt]);
+
+        return blendWayPoints(t,qWP,dt,qMin,qMax,traj,wpSample);
+    }
+
+public:
+    /************************************************************************/
+    ArmBlendedWayPoints(ActionPrimitives *_action, const deque<ActionPrimitivesWayPoint> &_wayPoints) :
+                        PeriodicThread(ACTIONPRIM_BLENDEDWP_PER)
+    {
+        action=_action;
+        action->getCartesianIF(cartCtrl);
+        wayPoints=_wayPoints;
+        default_exec_time=ACTIONPRIM_DEFAULT_EXECTIME;
+    }
+
+    /************************************************************************/
+    void set_default_exec_time(const double exec_time)
+    {
+        default_exec_time=exec_time;
+    }
+
+    /************************************************************************/
+    bool threadInit()
+    {
+        if ((cartCtrl==NULL) || (action->posDirCtrl==NULL) || (wayPoints.size()==0))
+            return false;
+
+        armJnts.clear();
+        for (int j=0; j<action->jHandMin; j++)
+            armJnts.push_back(j);
+
+        // the whole path is solved before moving
+        double t0=Time::now();
+        vector<Vector> qWP(1,Vector(armJnts.size()));
+        for (size_t j=0; j<armJnts.size(); j++)
+            if (!action->encCtrl->getEncoder(armJnts[j],&qWP[0][j]))
+                return false;
+
+        if (!solveWayPoints(qWP))
+            return false;
+
+        vector<double> t(1,0.0);
+        for (size_t j=0; j<wayPoints.size(); j++)
+            t.push_back(t.back()+checkTime(checkDefaultTime(wayPoints[j].duration)));
+
+        if (!interpolate(t,qWP,getPeriod()))
+        {
+            action->printMessage(log::error,"unable to blend the waypoints");
+            return false;
+        }
+
+        action->printMessage(log::info,"%d waypoints solved and blended in %g [s]",
+                             (int)wayPoints.size(),Time::now()-t0);
+
+        // the joints are streamed directly, without the Cartesian controller
+        cartCtrl->stopControl();
+        modes.assign(armJnts.size(),VOCAB_CM_POSITION_DIRECT);
+        if (!action->modCtrl->setControlModes((int)armJnts.size(),armJnts.data(),modes.data()))
+        {
+            action->printMessage(log::error,"unable to switch the arm to position direct mode");
+
+            // threadRelease() is not called when threadInit() fails
+            modes.assign(armJnts.size(),VOCAB_CM_POSITION);
+            action->modCtrl->setControlModes((int)armJnts.size(),armJnts.data(),modes.data());
+            return false;
+        }
+
+        i=k=0;
+        return true;
+    }
+
+    /************************************************************************/
+    void run()
+    {
+        if (k==0)
+            action->printMessage(log::no_info,"streaming %d waypoints in %g [s]",
+                                 (int)wayPoints.size(),traj.rows()*getPeriod());
+
+        action->posDirCtrl->setPositions((int)armJnts.size(),armJnts.data(),traj[k]);
+
+        // waypoint attained
+        while ((i<wpSample.size()) && (k>=wpSample[i]))
+        {
+            execCallback();
+            i++;
+        }
+
+        if (++k>=traj.rows())
+            askToStop();
+    }
+
+    /************************************************************************/
+    void threadRelease()
+    {
+        modes.assign(armJnts.size(),VOCAB_CM_POSITION);
+        if (!action->modCtrl->setControlModes((int)armJnts.size(),armJnts.data(),modes.data()))
+            action->printMessage(log::error,"unable to switch the arm back to position mode");
+    }
+
+    /************************************************************************/
+    const deque<ActionPrimitivesWayPoint> &get_waypoints() const
+    {
+        return wayPoints;
+    }
+
+    /************************************************************************/
+    virtual ~ArmBlendedWayPoints()
+    {
+        if (isRunning())
+            stop();
+    }
+};
+
+
 // This class handles the automatic arm-waving
 /************************************************************************/
 class ArmWavingMonitor : public PeriodicThread
@@ -305,6 +508,84 @@ ActionPrimitivesWayPoint::ActionPrimitivesWayPoint()
 }
 
 
+/************************************************************************/
+bool iCub::action::blendWayPoints(const vector<double> &t, const vector<Vector> &qWP,
+                                  const double dt, const Vector &qMin, const Vector &qMax,
+                                  Matrix &traj, vector<size_t> &wpSample)
+{
+    if ((t.size()<2) || (qWP.size()!=t.size()) || (dt<=0.0) || (t[0]!=0.0))
+        return false;
+
+    // cubic spline through the waypoints, at rest at the ends
+    size_t n=t.size()-1;
+    size_t nJnts=qMin.length();
+    if (qMax.length()!=nJnts)
+        return false;
+
+    vector<double> h(n),a(n+1),b(n+1),c(n+1),d(n+1);
+    for (size_t m=0; m<n; m++)
+    {
+        h[m]=t[m+1]-t[m];
+        if (!(h[m]>0.0))
+            return false;
+    }
+
+    for (size_t m=0; m<=n; m++)
+        if (qWP[m].length()!=nJnts)
+            return false;
+
+    size_t samples=(size_t)ceil(t[n]/dt);
+    traj.resize(samples,nJnts);
+
+    wpSample.resize(n);
+    for (size_t m=0; m<n; m++)
+        wpSample[m]=std::min(samples,(size_t)ceil(t[m+1]/dt))-1;
+
+    for (size_t jnt=0; jnt<nJnts; jnt++)
+    {
+        // tridiagonal system in the second derivatives M (Thomas algorithm)
+        vector<double> y(n+1),M(n+1);
+        for (size_t m=0; m<=n; m++)
+            y[m]=qWP[m][jnt];
+
+        for (size_t m=0; m<=n; m++)
+        {
+            double hl=(m>0?h[m-1]:0.0);
+            double hr=(m<n?h[m]:0.0);
+            double sl=(m>0?(y[m]-y[m-1])/hl:0.0);
+            double sr=(m<n?(y[m+1]-y[m])/hr:0.0);
+            a[m]=hl; b[m]=2.0*(hl+hr); c[m]=hr;
+            d[m]=6.0*(sr-sl);
+        }
+
+        for (size_t m=1; m<=n; m++)
+        {
+            double w=a[m]/b[m-1];
+            b[m]-=w*c[m-1];
+            d[m]-=w*d[m-1];
+        }
+        M[n]=d[n]/b[n];
+        for (size_t m=n; m-->0;)
+            M[m]=(d[m]-c[m]*M[m+1])/b[m];
+
+        size_t m=0;
+        for (size_t s=0; s<samples; s++)
+        {
+            double ts=std::min((s+1)*dt,t[n]);
+            while ((m<n-1) && (ts>t[m+1]))
+                m++;
+
+            double l=(t[m+1]-ts)/h[m];
+            double r=(ts-t[m])/h[m];
+            double q=l*y[m]+r*y[m+1]+((l*l*l-l)*M[m]+(r*r*r-r)*M[m+1])*h[m]*h[m]/6.0;
+            traj(s,jnt)=std::min(std::max(q,qMin[jnt]),qMax[jnt]);
+        }
+    }
+
+    return true;
+}
+
+
 /************************************************************************/
 void ActionPrimitives::ActionsQueue::clear()
 {
@@ -340,6 +621,7 @@ ActionPrimitives::ActionPrimitives(Property &opt) :
 void ActionPrimitives::init()
 {
     armWaver=NULL;
+    posDirCtrl=NULL;
     actionClb=NULL;
     actionWP=NULL;
     graspModel=NULL;
@@ -354,11 +636,15 @@ void ActionPrimitives::init()
     fingerInPosition.insert(fingerInPosition.begin(),5,true);
     reachTmoEnabled=false;
     locked=false;    
+    blendedWayPoints=false;
+    timingWayPoints=false;
 
     latchTimerWait=waitTmo=0.0;
     latchTimerReach=reachTmo=0.0;
     latchTimerHand=curHandTmo=0.0;
     latchTimerReachLog=0.0;
+    latchTimerWayPoints=0.0;
+    wayPointsPlanningTime=wayPointsExecTime=0.0;
 }
 
 
@@ -601,6 +887,7 @@ bool ActionPrimitives::open(Property &opt)
     default_exec_time=opt.check("default_exec_time",Value(ACTIONPRIM_DEFAULT_EXECTIME)).asFloat64();
     tracking_mode=opt.check("tracking_mode",Value(ACTIONPRIM_DEFAULT_TRACKINGMODE)).asString()=="on"?true:false;
     verbose=opt.check("verbosity",Value(ACTIONPRIM_DEFAULT_VERBOSITY)).asString()=="on"?true:false;    
+    blendedWayPoints=opt.check("blended_waypoints",Value(ACTIONPRIM_DEFAULT_BLENDEDWP)).asString()=="on"?true:false;
 
     int period=opt.check("thread_period",Value(ACTIONPRIM_DEFAULT_PER)).asInt32();    
     double reach_tol=opt.check("reach_tol",Value(ACTIONPRIM_DEFAULT_REACHTOL)).asFloat64();
@@ -639,8 +926,15 @@ bool ActionPrimitives::open(Property &opt)
     polyHand.view(modCtrl);
     polyHand.view(encCtrl);    
     polyHand.view(posCtrl);
+    polyHand.view(posDirCtrl);
     polyCart.view(cartCtrl);
 
+    if (blendedWayPoints && (posDirCtrl==NULL))
+    {
+        printMessage(log::warning,"position direct control unavailable => blended waypoints disabled");
+        blendedWayPoints=false;
+    }
+
     // set tolerance
     cartCtrl->setInTargetTol(reach_tol);
 
@@ -759,13 +1053,21 @@ bool ActionPrimitives::isHandSeqEnded()
     // get data from the grasp model
     if (graspModel!=NULL)
     {
-        Value out; graspModel->getOutput(out);
-        Bottle *pB=out.asList();
+        Vector fingersOut(5,0.0);
+        if (SpringyFingersModel *springyModel=dynamic_cast<SpringyFingersModel*>(graspModel))
+            springyModel->getOutput(fingersOut);
+        else
+        {
+            Value out; graspModel->getOutput(out);
+            if (Bottle *pB=out.asList())
+                for (int fng=0; fng<std::min(5,(int)pB->size()); fng++)
+                    fingersOut[fng]=pB->get(fng).asFloat64();
+        }
 
         // span over fingers
         for (int fng=0; fng<5; fng++)
         {
-            double val=pB->get(fng).asFloat64();
+            double val=fingersOut[fng];
             double thres=curGraspDetectionThres[fng];
 
             // detect contact on the finger
@@ -1044,8 +1346,7 @@ bool ActionPrimitives::pushAction(const deque<ActionPrimitivesWayPoint> &wayPoin
     {
         lock_guard<mutex> lck(mtx);
         Action action;
-        ArmWayPoints *thr=new ArmWayPoints(this,wayPoints);
-        thr->set_default_exec_time(default_exec_time);
+        PeriodicThread *thr=createWayPointsThread(wayPoints);
 
         action.waitState=false;
         action.execArm=false;
@@ -1078,8 +1379,7 @@ bool ActionPrimitives::pushAction(const deque<ActionPrimitivesWayPoint> &wayPoin
             {
                 // combined action
                 Action action;
-                ArmWayPoints *thr=new ArmWayPoints(this,wayPoints);
-                thr->set_default_exec_time(default_exec_time);
+                PeriodicThread *thr=createWayPointsThread(wayPoints);
 
                 action.waitState=false;
                 action.execArm=false;
@@ -1121,6 +1421,24 @@ bool ActionPrimitives::pushAction(const deque<ActionPrimitivesWayPoint> &wayPoin
 }
 
 
+/************************************************************************/
+PeriodicThread *ActionPrimitives::createWayPointsThread(const deque<ActionPrimitivesWayPoint> &wayPoints)
+{
+    if (blendedWayPoints)
+    {
+        ArmBlendedWayPoints *thr=new ArmBlendedWayPoints(this,wayPoints);
+        thr->set_default_exec_time(default_exec_time);
+        return thr;
+    }
+    else
+    {
+        ArmWayPoints *thr=new ArmWayPoints(this,wayPoints);
+        thr->set_default_exec_time(default_exec_time);
+        return thr;
+    }
+}
+
+
 /************************************************************************/
 bool ActionPrimitives::pushWaitState(const double tmo, ActionPrimitivesCallback *clb)
 {
@@ -1314,6 +1632,15 @@ void ActionPrimitives::run()
         {    
             printMessage(log::no_info,"reaching complete");
             disableTorsoDof();
+
+            if (timingWayPoints)
+            {
+                wayPointsExecTime=t-latchTimerWayPoints;
+                printMessage(log::info,"%s waypoints executed in %g [s] (%g [s] before moving)",
+                             blendedWayPoints?"blended":"single",wayPointsExecTime,
+                             wayPointsPlanningTime);
+                timingWayPoints=false;
+            }
         }
     }
 
@@ -1470,8 +1797,42 @@ bool ActionPrimitives::cmdArmWP(const Action &action)
     if (configured && action.execWayPoints)
     {
         disableArmWaving();
-        enableTorsoDof();
-        action.wayPointsThr->start();
+
+        // in blended mode the torso is kept still
+        if (!blendedWayPoints)
+            enableTorsoDof();
+
+        // start() returns once the thread is initialized
+        latchTimerWayPoints=Time::now();
+        bool started=action.wayPointsThr->start();
+        if (!started)
+        {
+            // the blended waypoints can still be executed one at a time
+            // (actionWP is action.wayPointsThr, see execQueue())
+            if (ArmBlendedWayPoints *blended=dynamic_cast<ArmBlendedWayPoints*>(actionWP))
+            {
+                printMessage(log::error,"unable to start the blended waypoints, executing them one at a time");
+                ArmWayPoints *thr=new ArmWayPoints(this,blended->get_waypoints());
+                thr->set_default_exec_time(default_exec_time);
+                delete actionWP;
+                actionWP=thr;
+
+                enableTorsoDof();
+                started=thr->start();
+            }
+
+            if (!started)
+            {
+                printMessage(log::error,"unable to start the waypoints, the action is skipped");
+                delete actionWP;
+                actionWP=NULL;
+                return false;
+            }
+        }
+
+        wayPointsPlanningTime=Time::now()-latchTimerWayPoints;
+        timingWayPoints=true;
+
         postReachCallback();
         latchTimerReachLog=latchTimerReach=Time::now();
 
@@ -1882,6 +2243,7 @@ bool ActionPrimitives::stopControl()
 
         armMoveDone =latchArmMoveDone =true;
         handMoveDone=latchHandMoveDone=true;
+        timingWayPoints=false;
 
         resume();
 
@@ -1937,6 +2299,46 @@ bool ActionPrimitives::getTrackingMode() const
 }
 
 
+/************************************************************************/
+bool ActionPrimitives::setBlendedWayPoints(const bool f)
+{
+    if (configured)
+    {
+        if (f && (posDirCtrl==NULL))
+        {
+            printMessage(log::warning,"position direct control unavailable");
+            return false;
+        }
+
+        blendedWayPoints=f;
+        return true;
+    }
+    else
+        return false;
+}
+
+
+/************************************************************************/
+bool ActionPrimitives::getBlendedWayPoints() const
+{
+    return blendedWayPoints;
+}
+
+
+/************************************************************************/
+bool ActionPrimitives::getWayPointsTimes(double &planning, double &execution) const
+{
+    if (configured)
+    {
+        planning=wayPointsPlanningTime;
+        execution=wayPointsExecTime;
+        return true;
+    }
+    else
+        return false;
+}
+
+
 /************************************************************************/
 bool ActionPrimitives::enableArmWaving(const Vector &restPos)
 {
@@ -0,0 +1,128 @@
+/*
+ * Copyright (C) 2022 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+// Time per step of a set of position/velocity/acceleration estimators fed by
+// encoder-like measurements, implemented as many Kalman, as many FixedKalman,
+// as one FixedKalmanBank and as one FixedKalmanBank with steady-state gains,
+// together with the largest deviation of the bank from Kalman.
+//
+// kalmanBenchmark [--filters "(1 32 128)"] [--dt 0.001] [--samples 20000]
+
+#include <cstdio>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+
+#include <yarp/os/all.h>
+#include <yarp/sig/all.h>
+#include <yarp/math/Math.h>
+#include <yarp/math/Rand.h>
+
+#include <iCub/ctrl/kalman.h>
+#include <iCub/ctrl/fixedKalman.h>
+
+using namespace std;
+using namespace yarp::os;
+using namespace yarp::sig;
+using namespace yarp::math;
+using namespace iCub::ctrl;
+
+
+/***************************************************************************/
+int main(int argc, char *argv[])
+{
+    Property options;
+    options.fromCommand(argc,argv);
+
+    Bottle defFilters; defFilters.fromString("1 32 128");
+    Bottle *filters=options.find("filters").asList();
+    if (filters==NULL)
+        filters=&defFilters;
+
+    double dt=options.check("dt",Value(0.001)).asFloat64();
+    int N=options.check("samples",Value(20000)).asInt32();
+    Rand::init(1);
+
+    Matrix A=eye(3,3);
+    A(0,1)=A(1,2)=dt;
+    A(0,2)=0.5*dt*dt;
+    Matrix H=zeros(1,3); H(0,0)=1.0;
+    Matrix Q=zeros(3,3); Q(2,2)=1e-2;
+    Matrix R=eye(1,1)*1e-6;
+    Matrix P0=eye(3,3);
+
+    printf("filters | Kalman [us/step] | FixedKalman [us/step] | bank [us/step] | steady-state bank [us/step] | max deviation\n");
+    for (size_t f=0; f<filters->size(); f++)
+    {
+        int count=filters->get(f).asInt32();
+
+        // every filter tracks its own sinusoid
+        Vector freq=Rand::vector(Vector(count,0.1),Vector(count,2.0));
+        Matrix Z(N,count);
+        for (int k=0; k<N; k++)
+            for (int i=0; i<count; i++)
+                Z(k,i)=sin(2.0*M_PI*freq[i]*k*dt)+1e-3*Rand::scalar(-1.0,1.0);
+
+        // the measurements are prepared in both layouts to leave the copies out of the timings
+        vector<vector<Vector>> z(N,vector<Vector>(count));
+        vector<Matrix> zBank(N,Matrix(1,count));
+        for (int k=0; k<N; k++)
+        {
+            for (int i=0; i<count; i++)
+                z[k][i]=Vector(1,Z(k,i));
+            zBank[k].setRow(0,Z.getRow(k));
+        }
+
+        vector<Kalman> kalman(count,Kalman(A,H,Q,R));
+        for (auto &kf:kalman)
+            kf.init(zeros(3),P0);
+        double t0=Time::now();
+        for (int k=0; k<N; k++)
+            for (int i=0; i<count; i++)
+                kalman[i].filt(z[k][i]);
+        double tKalman=Time::now()-t0;
+
+        vector<FixedKalman<3,1>> fixed(count,FixedKalman<3,1>(A,H,Q,R));
+        for (auto &kf:fixed)
+            kf.init(zeros(3),P0);
+        t0=Time::now();
+        for (int k=0; k<N; k++)
+            for (int i=0; i<count; i++)
+                fixed[i].filt(z[k][i]);
+        double tFixed=Time::now()-t0;
+
+        FixedKalmanBank<3,1> bank(count,A,H,Q,R);
+        for (int i=0; i<count; i++)
+            bank.init(i,zeros(3),P0);
+        t0=Time::now();
+        for (int k=0; k<N; k++)
+            bank.filt(zBank[k]);
+        double tBank=Time::now()-t0;
+
+        FixedKalmanBank<3,1> steady(count,A,H,Q,R);
+        for (int i=0; i<count; i++)
+            steady.init(i,zeros(3),P0);
+        steady.computeSteadyState();
+        t0=Time::now();
+        for (int k=0; k<N; k++)
+            steady.filt(zBank[k]);
+        double tSteady=Time::now()-t0;
+
+        double dev=0.0;
+        for (int i=0; i<count; i++)
+        {
+            Vector d=bank.get_x(i)-kalman[i].get_x();
+            for (size_t j=0; j<d.length(); j++)
+                dev=std::max(dev,fabs(d[j]));
+        }
+
+        printf("%7d | %16.3f | %21.3f | %14.3f | %27.3f | %.2e\n",count,
+               1e6*tKalman/N,1e6*tFixed/N,1e6*tBank/N,1e6*tSteady/N,dev);
+    }
+
+    return 0;
+}
@@ -0,0 +1,122 @@
+/*
+ * Copyright (C) 2022 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+// Time per sample of ff2LayNN_tansig_purelin predicting one input at a time
+// and in batches, for networks of different sizes, together with the largest
+// deviation of the batched outputs from the single ones.
+//
+// neuralNetworksBenchmark [--hidden "(10 50 200)"] [--inputs 4] [--outputs 3] [--samples 100000]
+
+#include <cstdio>
+#include <cmath>
+#include <sstream>
+#include <algorithm>
+
+#include <yarp/os/all.h>
+#include <yarp/sig/all.h>
+#include <yarp/math/Rand.h>
+
+#include <iCub/ctrl/neuralNetworks.h>
+
+using namespace std;
+using namespace yarp::os;
+using namespace yarp::sig;
+using namespace yarp::math;
+using namespace iCub::ctrl;
+
+
+/***************************************************************************/
+string randomList(const int n, const double gain)
+{
+    ostringstream str;
+    str<<"(";
+    for (int i=0; i<n; i++)
+        str<<" "<<gain*Rand::scalar(-1.0,1.0);
+    str<<" )";
+
+    return str.str();
+}
+
+
+/***************************************************************************/
+Property randomNetwork(const int numInput, const int numHidden, const int numOutput)
+{
+    ostringstream str;
+    str<<"(numInputNodes "<<numInput<<") (numHiddenNodes "<<numHidden
+       <<") (numOutputNodes "<<numOutput<<")";
+
+    for (int j=0; j<numHidden; j++)
+        str<<" (IW_"<<j<<" "<<randomList(numInput,2.0)<<")";
+    str<<" (b1 "<<randomList(numHidden,1.0)<<")";
+
+    for (int k=0; k<numOutput; k++)
+        str<<" (LW_"<<k<<" "<<randomList(numHidden,1.0)<<")";
+    str<<" (b2 "<<randomList(numOutput,1.0)<<")";
+
+    for (int i=0; i<numInput; i++)
+        str<<" (inMinMaxX_"<<i<<" (-1.0 1.0)) (inMinMaxY_"<<i<<" (-1.0 1.0))";
+    for (int k=0; k<numOutput; k++)
+        str<<" (outMinMaxX_"<<k<<" (-2.0 2.0)) (outMinMaxY_"<<k<<" (-1.0 1.0))";
+
+    Property options;
+    options.fromString(str.str());
+
+    return options;
+}
+
+
+/***************************************************************************/
+int main(int argc, char *argv[])
+{
+    Property options;
+    options.fromCommand(argc,argv);
+
+    Bottle defHidden; defHidden.fromString("10 50 200");
+    Bottle *hidden=options.find("hidden").asList();
+    if (hidden==NULL)
+        hidden=&defHidden;
+
+    int numInput=options.check("inputs",Value(4)).asInt32();
+    int numOutput=options.check("outputs",Value(3)).asInt32();
+    int N=options.check("samples",Value(100000)).asInt32();
+    Rand::init(1);
+
+    Matrix X(N,numInput);
+    for (int n=0; n<N; n++)
+        for (int i=0; i<numInput; i++)
+            X(n,i)=Rand::scalar(-1.0,1.0);
+
+    printf("hidden | single [us/sample] | batch [us/sample] | speed-up | max deviation\n");
+    for (size_t h=0; h<hidden->size(); h++)
+    {
+        ff2LayNN_tansig_purelin net(randomNetwork(numInput,hidden->get(h).asInt32(),numOutput));
+
+        Matrix Ysingle(N,numOutput);
+        double t0=Time::now();
+        for (int n=0; n<N; n++)
+            Ysingle.setRow(n,net.predict(X.getRow(n)));
+        double tSingle=Time::now()-t0;
+
+        // warm up the workspaces first
+        Matrix Ybatch;
+        net.predict(X,Ybatch);
+        t0=Time::now();
+        net.predict(X,Ybatch);
+        double tBatch=Time::now()-t0;
+
+        double dev=0.0;
+        for (int n=0; n<N; n++)
+            for (int k=0; k<numOutput; k++)
+                dev=std::max(dev,fabs(Ysingle(n,k)-Ybatch(n,k)));
+
+        printf("%6d | %18.3f | %17.3f | %8.1f | %.2e\n",hidden->get(h).asInt32(),
+               1e6*tSingle/N,1e6*tBatch/N,tSingle/tBatch,dev);
+    }
+
+    return 0;
+}
@@ -23,6 +23,7 @@
 #define __FILTERS_H__
 
 #include <deque>
+#include <vector>
 
 #include <yarp/sig/Vector.h>
 #include <iCub/ctrl/math.h>
@@ -80,11 +81,20 @@ protected:
    yarp::sig::Vector a;
    yarp::sig::Vector y;
 
-   std::deque<yarp::sig::Vector> uold;
-   std::deque<yarp::sig::Vector> yold;
+   // past inputs and outputs in circular buffers allocated only when the
+   // number of coefficients or of channels changes: one row of channels
+   // per delay, uhead (yhead) being the row of the most recent input (output)
+   std::vector<double> uold;
+   std::vector<double> yold;
+   size_t uhead;
+   size_t yhead;
    size_t n;
    size_t m;
 
+   void allocStates(const size_t dim);
+   double *uRow(const size_t i) { return uold.data()+((uhead+i)%(m-1))*y.length(); }
+   double *yRow(const size_t i) { return yold.data()+((yhead+i)%(n-1))*y.length(); }
+
 public:
    /**
    * Creates a filter with specified numerator and denominator 
@@ -0,0 +1,1293 @@
+/*
+ * Copyright (C) 2022 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+/**
+ * @ingroup Kalman
+ *
+ * Kalman estimators whose dimensions are known at compile time:
+ * a single filter and a bank of independent filters sharing the
+ * same model structure.
+ */
+
+#ifndef __FIXEDKALMAN_H__
+#define __FIXEDKALMAN_H__
+
+#include <cmath>
+#include <cstddef>
+#include <vector>
+#include <array>
+#include <algorithm>
+
+#include <yarp/os/Log.h>
+#include <yarp/sig/Vector.h>
+#include <yarp/sig/Matrix.h>
+
+
+namespace iCub
+{
+
+namespace ctrl
+{
+
+namespace detail
+{
+
+/**
+* The computations of count Kalman filters with N states, M
+* measurements and U inputs, laid out component-major: the element
+* e of the filter k is stored at e*count+k, so that the innermost
+* loops run over the filters and can be vectorized. A, B and H are
+* shared and row-major. count is C if not null, n otherwise.
+*/
+template <size_t N, size_t M, size_t U, size_t C=0>
+struct KalmanLanes
+{
+    size_t n;
+    const double *A,*B,*H;
+    const double *Q,*R;
+    double *x,*P,*K,*S,*L,*gate;
+    double *ws;
+
+    static constexpr size_t workspaceSize(const size_t count)
+    {
+        return (N+2*M+2*N*N+N*M)*count;
+    }
+
+    // x=A*x+B*u, u may be NULL
+    void predictState(const double *u)
+    {
+        const size_t count=(C>0?C:n);
+        double *xn=ws;
+        std::fill(xn,xn+N*count,0.0);
+        for (size_t i=0; i<N; i++)
+        {
+            double *xi=xn+i*count;
+            for (size_t j=0; j<N; j++)
+            {
+                const double a=A[i*N+j];
+                const double *xj=x+j*count;
+                for (size_t k=0; k<count; k++)
+                    xi[k]+=a*xj[k];
+            }
+            if (u!=NULL)
+            {
+                for (size_t j=0; j<U; j++)
+                {
+                    const double b=B[i*U+j];
+                    const double *uj=u+j*count;
+                    for (size_t k=0; k<count; k++)
+                        xi[k]+=b*uj[k];
+                }
+            }
+        }
+        std::copy(xn,xn+N*count,x);
+    }
+
+    // P=A*P*A'+Q, S=H*P*H'+R and its Cholesky factor L
+    void predictCovariance()
+    {
+        double *AP=ws;
+        product(A,P,AP);
+        symmetricProduct(AP,A,Q,P);
+        innovation();
+    }
+
+    // S=H*P*H'+R and its Cholesky factor L
+    void innovation()
+    {
+        double *HP=ws;
+        productM(H,P,HP);
+        symmetricProductM(HP,H,R,S);
+        cholesky(S,L);
+    }
+
+    // K=P*H'*inv(S) through L
+    void gain()
+    {
+        const size_t count=(C>0?C:n);
+        for (size_t r=0; r<N; r++)
+        {
+            for (size_t j=0; j<M; j++)
+            {
+                double *Krj=K+(r*M+j)*count;
+                for (size_t k=0; k<count; k++)
+                    Krj[k]=0.0;
+                for (size_t l=0; l<N; l++)
+                {
+                    const double h=H[j*N+l];
+                    const double *Prl=P+(r*N+l)*count;
+                    for (size_t k=0; k<count; k++)
+                        Krj[k]+=Prl[k]*h;
+                }
+            }
+
+            // L*L'*K(r,:)'=(P*H')(r,:)'
+            for (size_t j=0; j<M; j++)
+            {
+                double *Krj=K+(r*M+j)*count;
+                for (size_t l=0; l<j; l++)
+                {
+                    const double *Ljl=L+(j*M+l)*count;
+                    const double *Krl=K+(r*M+l)*count;
+                    for (size_t k=0; k<count; k++)
+                        Krj[k]-=Ljl[k]*Krl[k];
+                }
+                const double *Ljj=L+(j*M+j)*count;
+                for (size_t k=0; k<count; k++)
+                    Krj[k]/=Ljj[k];
+            }
+            for (size_t j=M; j-->0;)
+            {
+                double *Krj=K+(r*M+j)*count;
+                for (size_t l=j+1; l<M; l++)
+                {
+                    const double *Llj=L+(l*M+j)*count;
+                    const double *Krl=K+(r*M+l)*count;
+                    for (size_t k=0; k<count; k++)
+                        Krj[k]-=Llj[k]*Krl[k];
+                }
+                const double *Ljj=L+(j*M+j)*count;
+                for (size_t k=0; k<count; k++)
+                    Krj[k]/=Ljj[k];
+            }
+        }
+    }
+
+    // x+=K*(z-H*x) and the validation gate (z-H*x)'*inv(S)*(z-H*x)
+    void correctState(const double *z)
+    {
+        const size_t count=(C>0?C:n);
+        double *e=ws;
+        double *w=ws+M*count;
+        for (size_t i=0; i<M; i++)
+        {
+            double *ei=e+i*count;
+            const double *zi=z+i*count;
+            for (size_t k=0; k<count; k++)
+                ei[k]=zi[k];
+            for (size_t l=0; l<N; l++)
+            {
+                const double h=H[i*N+l];
+                const double *xl=x+l*count;
+                for (size_t k=0; k<count; k++)
+                    ei[k]-=h*xl[k];
+            }
+        }
+
+        for (size_t i=0; i<N; i++)
+        {
+            double *xi=x+i*count;
+            for (size_t j=0; j<M; j++)
+            {
+                const double *Kij=K+(i*M+j)*count;
+                const double *ej=e+j*count;
+                for (size_t k=0; k<count; k++)
+                    xi[k]+=Kij[k]*ej[k];
+            }
+        }
+
+        std::fill(gate,gate+count,0.0);
+        for (size_t j=0; j<M; j++)
+        {
+            double *wj=w+j*count;
+            const double *ej=e+j*count;
+            for (size_t k=0; k<count; k++)
+                wj[k]=ej[k];
+            for (size_t l=0; l<j; l++)
+            {
+                const double *Ljl=L+(j*M+l)*count;
+                const double *wl=w+l*count;
+                for (size_t k=0; k<count; k++)
+                    wj[k]-=Ljl[k]*wl[k];
+            }
+            const double *Ljj=L+(j*M+j)*count;
+            for (size_t k=0; k<count; k++)
+            {
+                wj[k]/=Ljj[k];
+                gate[k]+=wj[k]*wj[k];
+            }
+        }
+    }
+
+    // Joseph form P=(I-K*H)*P*(I-K*H)'+K*R*K', which keeps P
+    // symmetric and positive definite
+    void correctCovariance()
+    {
+        const size_t count=(C>0?C:n);
+        double *IKH=ws;
+        double *T=IKH+N*N*count;
+        double *KR=T+N*N*count;
+
+        for (size_t i=0; i<N; i++)
+        {
+            for (size_t j=0; j<N; j++)
+            {
+                double *IKHij=IKH+(i*N+j)*count;
+                const double d=(i==j?1.0:0.0);
+                for (size_t k=0; k<count; k++)
+                    IKHij[k]=d;
+                for (size_t l=0; l<M; l++)
+                {
+                    const double h=H[l*N+j];
+                    const double *Kil=K+(i*M+l)*count;
+                    for (size_t k=0; k<count; k++)
+                        IKHij[k]-=Kil[k]*h;
+                }
+            }
+        }
+
+        for (size_t i=0; i<N; i++)
+        {
+            for (size_t j=0; j<N; j++)
+            {
+                double *Tij=T+(i*N+j)*count;
+                std::fill(Tij,Tij+count,0.0);
+                for (size_t l=0; l<N; l++)
+                {
+                    const double *IKHil=IKH+(i*N+l)*count;
+                    const double *Plj=P+(l*N+j)*count;
+                    for (size_t k=0; k<count; k++)
+                        Tij[k]+=IKHil[k]*Plj[k];
+                }
+            }
+
+            for (size_t b=0; b<M; b++)
+            {
+                double *KRib=KR+(i*M+b)*count;
+                std::fill(KRib,KRib+count,0.0);
+                for (size_t a=0; a<M; a++)
+                {
+                    const double *Kia=K+(i*M+a)*count;
+                    const double *Rab=R+(a*M+b)*count;
+                    for (size_t k=0; k<count; k++)
+                        KRib[k]+=Kia[k]*Rab[k];
+                }
+            }
+        }
+
+        for (size_t i=0; i<N; i++)
+        {
+            for (size_t j=i; j<N; j++)
+            {
+                double *Pij=P+(i*N+j)*count;
+                std::fill(Pij,Pij+count,0.0);
+                for (size_t l=0; l<N; l++)
+                {
+                    const double *Til=T+(i*N+l)*count;
+                    const double *IKHjl=IKH+(j*N+l)*count;
+                    for (size_t k=0; k<count; k++)
+                        Pij[k]+=Til[k]*IKHjl[k];
+                }
+                for (size_t b=0; b<M; b++)
+                {
+                    const double *KRib=KR+(i*M+b)*count;
+                    const double *Kjb=K+(j*M+b)*count;
+                    for (size_t k=0; k<count; k++)
+                        Pij[k]+=KRib[k]*Kjb[k];
+                }
+                if (j!=i)
+                    std::copy(Pij,Pij+count,P+(j*N+i)*count);
+            }
+        }
+    }
+
+    // lower Cholesky factor L of the symmetric matrices X (MxM);
+    // the pivots are kept positive to survive round-off
+    void cholesky(const double *X, double *L) const
+    {
+        const size_t count=(C>0?C:n);
+        const double tiny=1e-300;
+        for (size_t j=0; j<M; j++)
+        {
+            double *Ljj=L+(j*M+j)*count;
+            const double *Xjj=X+(j*M+j)*count;
+            for (size_t k=0; k<count; k++)
+                Ljj[k]=Xjj[k];
+            for (size_t l=0; l<j; l++)
+            {
+                const double *Ljl=L+(j*M+l)*count;
+                for (size_t k=0; k<count; k++)
+                    Ljj[k]-=Ljl[k]*Ljl[k];
+            }
+            for (size_t k=0; k<count; k++)
+                Ljj[k]=std::sqrt(std::max(Ljj[k],tiny));
+
+            for (size_t i=j+1; i<M; i++)
+            {
+                double *Lij=L+(i*M+j)*count;
+                const double *Xij=X+(i*M+j)*count;
+                for (size_t k=0; k<count; k++)
+                    Lij[k]=Xij[k];
+                for (size_t l=0; l<j; l++)
+                {
+                    const double *Lil=L+(i*M+l)*count;
+                    const double *Ljl=L+(j*M+l)*count;
+                    for (size_t k=0; k<count; k++)
+                        Lij[k]-=Lil[k]*Ljl[k];
+                }
+                for (size_t k=0; k<count; k++)
+                    Lij[k]/=Ljj[k];
+                std::fill(L+(j*M+i)*count,L+(j*M+i+1)*count,0.0);
+            }
+        }
+    }
+
+    // Y=X*Z, X shared (NxN), Z and Y by filter (NxN)
+    void product(const double *X, const double *Z, double *Y) const
+    {
+        const size_t count=(C>0?C:n);
+        for (size_t i=0; i<N; i++)
+        {
+            for (size_t j=0; j<N; j++)
+            {
+                double *Yij=Y+(i*N+j)*count;
+                std::fill(Yij,Yij+count,0.0);
+                for (size_t l=0; l<N; l++)
+                {
+                    const double a=X[i*N+l];
+                    const double *Zlj=Z+(l*N+j)*count;
+                    for (size_t k=0; k<count; k++)
+                        Yij[k]+=a*Zlj[k];
+                }
+            }
+        }
+    }
+
+    // Y=X*Z, X shared (MxN), Z by filter (NxN), Y by filter (MxN)
+    void productM(const double *X, const double *Z, double *Y) const
+    {
+        const size_t count=(C>0?C:n);
+        for (size_t i=0; i<M; i++)
+        {
+            for (size_t j=0; j<N; j++)
+            {
+                double *Yij=Y+(i*N+j)*count;
+                std::fill(Yij,Yij+count,0.0);
+                for (size_t l=0; l<N; l++)
+                {
+                    const double h=X[i*N+l];
+                    const double *Zlj=Z+(l*N+j)*count;
+                    for (size_t k=0; k<count; k++)
+                        Yij[k]+=h*Zlj[k];
+                }
+            }
+        }
+    }
+
+    // Y=XZ*X'+W with XZ by filter (NxN), X shared (NxN), W and Y by filter (NxN)
+    void symmetricProduct(const double *XZ, const double *X, const double *W, double *Y) const
+    {
+        const size_t count=(C>0?C:n);
+        for (size_t i=0; i<N; i++)
+        {
+            for (size_t j=i; j<N; j++)
+            {
+                double *Yij=Y+(i*N+j)*count;
+                std::copy(W+(i*N+j)*count,W+(i*N+j+1)*count,Yij);
+                for (size_t l=0; l<N; l++)
+                {
+                    const double a=X[j*N+l];
+                    const double *XZil=XZ+(i*N+l)*count;
+                    for (size_t k=0; k<count; k++)
+                        Yij[k]+=XZil[k]*a;
+                }
+                if (j!=i)
+                    std::copy(Yij,Yij+count,Y+(j*N+i)*count);
+            }
+        }
+    }
+
+    // Y=XZ*X'+W with XZ by filter (MxN), X shared (MxN), W and Y by filter (MxM)
+    void symmetricProductM(const double *XZ, const double *X, const double *W, double *Y) const
+    {
+        const size_t count=(C>0?C:n);
+        for (size_t i=0; i<M; i++)
+        {
+            for (size_t j=i; j<M; j++)
+            {
+                double *Yij=Y+(i*M+j)*count;
+                std::copy(W+(i*M+j)*count,W+(i*M+j+1)*count,Yij);
+                for (size_t l=0; l<N; l++)
+                {
+                    const double h=X[j*N+l];
+                    const double *XZil=XZ+(i*N+l)*count;
+                    for (size_t k=0; k<count; k++)
+                        Yij[k]+=XZil[k]*h;
+                }
+                if (j!=i)
+                    std::copy(Yij,Yij+count,Y+(j*M+i)*count);
+            }
+        }
+    }
+};
+
+// tells whether the symmetric matrix X (MxM, row-major) is positive definite
+template <size_t M>
+bool positiveDefinite(const double *X)
+{
+    std::array<double,M*M> C;
+    for (size_t j=0; j<M; j++)
+    {
+        double d=X[j*M+j];
+        for (size_t l=0; l<j; l++)
+            d-=C[j*M+l]*C[j*M+l];
+        if (!(d>0.0))
+            return false;
+        C[j*M+j]=std::sqrt(d);
+        for (size_t i=j+1; i<M; i++)
+        {
+            double s=X[i*M+j];
+            for (size_t l=0; l<j; l++)
+                s-=C[i*M+l]*C[j*M+l];
+            C[i*M+j]=s/C[j*M+j];
+        }
+    }
+    return true;
+}
+
+// copies the matrix src (rowsxcols) into the row-major array dst
+inline bool copyMatrix(const yarp::sig::Matrix &src, double *dst, const size_t rows, const size_t cols)
+{
+    if ((src.rows()!=rows) || (src.cols()!=cols))
+        return false;
+    for (size_t r=0; r<rows; r++)
+        for (size_t c=0; c<cols; c++)
+            dst[r*cols+c]=src(r,c);
+    return true;
+}
+
+// builds a matrix (rowsxcols) out of the element (r,c) of the filter k, at (r*cols+c)*count+k
+inline yarp::sig::Matrix toMatrix(const double *src, const size_t rows, const size_t cols,
+                                  const size_t k=0, const size_t count=1)
+{
+    yarp::sig::Matrix dst(rows,cols);
+    for (size_t r=0; r<rows; r++)
+        for (size_t c=0; c<cols; c++)
+            dst(r,c)=src[(r*cols+c)*count+k];
+    return dst;
+}
+
+}
+
+
+/**
+* \ingroup Kalman
+*
+* Kalman estimator with N states, M measurements and U inputs
+* fixed at compile time. It offers the same interface of Kalman,
+* without allocating memory while filtering: the inverse of the
+* innovation covariance is replaced by its Cholesky factorization
+* and the state covariance is corrected in Joseph form.
+* Optionally, the steady-state gain can be computed once and used
+* from then on, so that only the state is propagated.
+*/
+template <size_t N, size_t M, size_t U=N>
+class FixedKalman
+{
+protected:
+    std::array<double,N*N> A;
+    std::array<double,N*U> B;
+    std::array<double,M*N> H;
+    std::array<double,N*N> Q;
+    std::array<double,M*M> R;
+    std::array<double,M*M> L;
+    std::array<double,detail::KalmanLanes<N,M,U,1>::workspaceSize(1)> ws;
+
+    yarp::sig::Vector x;
+    yarp::sig::Matrix P;
+    yarp::sig::Matrix K;
+    yarp::sig::Matrix S;
+    double validationGate;
+    bool steadyState;
+
+    detail::KalmanLanes<N,M,U,1> lanes()
+    {
+        detail::KalmanLanes<N,M,U,1> l={1,A.data(),B.data(),H.data(),Q.data(),R.data(),
+                                      x.data(),P.data(),K.data(),S.data(),L.data(),
+                                      &validationGate,ws.data()};
+        return l;
+    }
+
+    void initialize(const yarp::sig::Matrix &_A, const yarp::sig::Matrix &_H,
+                    const yarp::sig::Matrix &_Q, const yarp::sig::Matrix &_R)
+    {
+        bool ok=detail::copyMatrix(_A,A.data(),N,N) && detail::copyMatrix(_H,H.data(),M,N) &&
+                detail::copyMatrix(_Q,Q.data(),N,N) && set_R(_R);
+        yAssert(ok);
+        YARP_UNUSED(ok);
+        x.resize(N,0.0);
+        P.resize(N,N); P.zero();
+        K.resize(N,M); K.zero();
+        S.resize(M,M); S.zero();
+        L.fill(0.0);
+        validationGate=0.0;
+        steadyState=false;
+
+        // a correction may come before any prediction
+        lanes().innovation();
+    }
+
+public:
+    /**
+     * Init a Kalman state estimator.
+     *
+     * @param _A State transition matrix (NxN).
+     * @param _H Measurement matrix (MxN).
+     * @param _Q Process noise covariance (NxN).
+     * @param _R Measurement noise covariance (MxM), positive
+     *           definite.
+     */
+    FixedKalman(const yarp::sig::Matrix &_A, const yarp::sig::Matrix &_H,
+                const yarp::sig::Matrix &_Q, const yarp::sig::Matrix &_R)
+    {
+        B.fill(0.0);
+        initialize(_A,_H,_Q,_R);
+    }
+
+    /**
+     * Init a Kalman state estimator.
+     *
+     * @param _A State transition matrix (NxN).
+     * @param _B Input matrix (NxU).
+     * @param _H Measurement matrix (MxN).
+     * @param _Q Process noise covariance (NxN).
+     * @param _R Measurement noise covariance (MxM), positive
+     *           definite.
+     */
+    FixedKalman(const yarp::sig::Matrix &_A, const yarp::sig::Matrix &_B,
+                const yarp::sig::Matrix &_H, const yarp::sig::Matrix &_Q,
+                const yarp::sig::Matrix &_R)
+    {
+        bool ok=detail::copyMatrix(_B,B.data(),N,U);
+        yAssert(ok);
+        YARP_UNUSED(ok);
+        initialize(_A,_H,_Q,_R);
+    }
+
+    /**
+     * Set initial state and error covariance.
+     *
+     * @param _x0 Initial condition for estimated state.
+     * @param _P0 Initial condition for estimated error covariance.
+     * @return true/false on success/failure.
+     * @note The steady-state gain, if in use, is kept; otherwise
+     *       the innovation covariance is computed from _P0.
+     */
+    bool init(const yarp::sig::Vector &_x0, const yarp::sig::Matrix &_P0)
+    {
+        if ((_x0.length()==N) && (_P0.rows()==N) && (_P0.cols()==N))
+        {
+            x=_x0;
+            P=_P0;
+            if (!steadyState)
+                lanes().innovation();
+            return true;
+        }
+        else
+            return false;
+    }
+
+    /**
+     * Predicts the next state vector given the current input.
+     *
+     * @param u Current input.
+     *
+     * @return Estimated state vector.
+     */
+    const yarp::sig::Vector& predict(const yarp::sig::Vector &u)
+    {
+        yAssert(u.length()==U);
+        detail::KalmanLanes<N,M,U,1> l=lanes();
+        l.predictState(u.data());
+        if (!steadyState)
+            l.predictCovariance();
+        validationGate=0.0;
+        return x;
+    }
+
+    /**
+     * Predicts the next state vector.
+     *
+     * @return Estimated state vector.
+     */
+    const yarp::sig::Vector& predict()
+    {
+        detail::KalmanLanes<N,M,U,1> l=lanes();
+        l.predictState(NULL);
+        if (!steadyState)
+            l.predictCovariance();
+        validationGate=0.0;
+        return x;
+    }
+
+    /**
+     * Corrects the current estimation of the state vector given the
+     * current measurement.
+     *
+     * @param z Current measurement.
+     *
+     * @return Estimated state vector.
+     */
+    const yarp::sig::Vector& correct(const yarp::sig::Vector &z)
+    {
+        yAssert(z.length()==M);
+        detail::KalmanLanes<N,M,U,1> l=lanes();
+        if (!steadyState)
+            l.gain();
+        l.correctState(z.data());
+        if (!steadyState)
+            l.correctCovariance();
+        return x;
+    }
+
+    /**
+     * Returns the estimated state vector given the current
+     * input and the current measurement by performing a prediction
+     * and then correcting the result.
+     *
+     * @param u Current input.
+     * @param z Current measurement.
+     *
+     * @return Estimated state vector.
+     */
+    const yarp::sig::Vector& filt(const yarp::sig::Vector &u, const yarp::sig::Vector &z)
+    {
+        predict(u);
+        return correct(z);
+    }
+
+    /**
+     * Returns the estimated state vector given the current
+     * measurement by performing a prediction and then correcting
+     * the result.
+     *
+     * @param z Current measurement.
+     *
+     * @return Estimated state vector.
+     */
+    const yarp::sig::Vector& filt(const yarp::sig::Vector &z)
+    {
+        predict();
+        return correct(z);
+    }
+
+    /**
+     * Computes the steady-state gain iterating the Riccati
+     * equation from the current covariance and, if it converges,
+     * uses it from then on: only the state is propagated, while
+     * P, S and K stay at their steady-state values.
+     *
+     * @param maxIter the maximum number of iterations.
+     * @param tol the largest change of the gain elements telling
+     *            the convergence.
+     * @return true/false on convergence/failure; in the latter
+     *         case the filter is left unchanged.
+     */
+    bool computeSteadyState(const size_t maxIter=10000, const double tol=1e-12)
+    {
+        yarp::sig::Matrix P0=P;
+        std::array<double,N*M> K0;
+        std::copy(K.data(),K.data()+N*M,K0.begin());
+
+        detail::KalmanLanes<N,M,U,1> l=lanes();
+        for (size_t iter=0; iter<maxIter; iter++)
+        {
+            std::array<double,N*M> Kprev;
+            std::copy(K.data(),K.data()+N*M,Kprev.begin());
+
+            l.predictCovariance();
+            l.gain();
+            l.correctCovariance();
+
+            double delta=0.0;
+            for (size_t i=0; i<N*M; i++)
+                delta=std::max(delta,std::fabs(K.data()[i]-Kprev[i]));
+
+            if ((iter>0) && (delta<tol))
+            {
+                // S and L are those of the prediction yielding K
+                steadyState=true;
+                return true;
+            }
+        }
+
+        P=P0;
+        std::copy(K0.begin(),K0.end(),K.data());
+        return false;
+    }
+
+    /**
+     * Goes back to propagating the covariance at each step.
+     */
+    void resetSteadyState() { steadyState=false; }
+
+    /**
+     * Tells whether the steady-state gain is in use.
+     *
+     * @return true/false.
+     */
+    bool isSteadyState() const { return steadyState; }
+
+    /**
+     * Returns the estimated state.
+     *
+     * @return Estimated state.
+     */
+    const yarp::sig::Vector& get_x() const { return x; }
+
+    /**
+     * Returns the estimated output.
+     *
+     * @return Estimated output.
+     */
+    yarp::sig::Vector get_y() const
+    {
+        yarp::sig::Vector y(M,0.0);
+        for (size_t i=0; i<M; i++)
+            for (size_t j=0; j<N; j++)
+                y[i]+=H[i*N+j]*x[j];
+        return y;
+    }
+
+    /**
+     * Returns the estimated state covariance.
+     *
+     * @return Estimated state covariance.
+     */
+    const yarp::sig::Matrix& get_P() const { return P; }
+
+    /**
+     * Returns the estimated measurement covariance.
+     *
+     * @return Estimated measurement covariance.
+     */
+    const yarp::sig::Matrix& get_S() const { return S; }
+
+    /**
+     * Returns the validation gate.
+     * @note The validation gate is meaningful only after
+     *       correction.
+     * @see correct
+     * @return validation gate.
+     */
+    double get_ValidationGate() const { return validationGate; }
+
+    /**
+     * Returns the Kalman gain matrix.
+     *
+     * @return Kalman gain matrix.
+     */
+    const yarp::sig::Matrix& get_K() const { return K; }
+
+    /**
+     * Returns the state transition matrix.
+     *
+     * @return State transition matrix.
+     */
+    yarp::sig::Matrix get_A() const { return detail::toMatrix(A.data(),N,N); }
+
+    /**
+     * Returns the input matrix.
+     *
+     * @return Input matrix.
+     */
+    yarp::sig::Matrix get_B() const { return detail::toMatrix(B.data(),N,U); }
+
+    /**
+     * Returns the measurement matrix.
+     *
+     * @return Measurement matrix.
+     */
+    yarp::sig::Matrix get_H() const { return detail::toMatrix(H.data(),M,N); }
+
+    /**
+     * Returns the process noise covariance matrix.
+     *
+     * @return Process noise covariance matrix.
+     */
+    yarp::sig::Matrix get_Q() const { return detail::toMatrix(Q.data(),N,N); }
+
+    /**
+     * Returns the measurement noise covariance matrix.
+     *
+     * @return Measurement noise covariance matrix.
+     */
+    yarp::sig::Matrix get_R() const { return detail::toMatrix(R.data(),M,M); }
+
+    /**
+     * Sets the state transition matrix.
+     *
+     * @param _A State transition matrix.
+     * @return true/false on success/failure.
+     * @note The steady-state gain is dropped.
+     */
+    bool set_A(const yarp::sig::Matrix &_A)
+    {
+        steadyState=false;
+        return detail::copyMatrix(_A,A.data(),N,N);
+    }
+
+    /**
+     * Sets the input matrix.
+     *
+     * @param _B Input matrix.
+     * @return true/false on success/failure.
+     */
+    bool set_B(const yarp::sig::Matrix &_B) { return detail::copyMatrix(_B,B.data(),N,U); }
+
+    /**
+     * Sets the measurement matrix.
+     *
+     * @param _H Measurement matrix.
+     * @return true/false on success/failure.
+     * @note The steady-state gain is dropped.
+     */
+    bool set_H(const yarp::sig::Matrix &_H)
+    {
+        steadyState=false;
+        return detail::copyMatrix(_H,H.data(),M,N);
+    }
+
+    /**
+     * Sets the process noise covariance matrix.
+     *
+     * @param _Q Process noise covariance matrix.
+     * @return true/false on success/failure.
+     * @note The steady-state gain is dropped.
+     */
+    bool set_Q(const yarp::sig::Matrix &_Q)
+    {
+        steadyState=false;
+        return detail::copyMatrix(_Q,Q.data(),N,N);
+    }
+
+    /**
+     * Sets the measurement noise covariance matrix.
+     *
+     * @param _R Measurement noise covariance matrix, positive
+     *           definite.
+     * @return true/false on success/failure.
+     * @note The steady-state gain is dropped.
+     */
+    bool set_R(const yarp::sig::Matrix &_R)
+    {
+        std::array<double,M*M> R0;
+        if (!detail::copyMatrix(_R,R0.data(),M,M))
+            return false;
+
+        if (!detail::positiveDefinite<M>(R0.data()))
+            return false;
+
+        R=R0;
+        steadyState=false;
+        return true;
+    }
+};
+
+
+/**
+* \ingroup Kalman
+*
+* Bank of independent Kalman estimators with N states, M
+* measurements and U inputs, sharing the matrices A, B and H and
+* each with its own noise covariances, state and covariance.
+* All the filters are updated in one pass whose innermost loops
+* run over the filters. Inputs, measurements and states are
+* exchanged as matrices with one column per filter.
+*/
+template <size_t N, size_t M, size_t U=N>
+class FixedKalmanBank
+{
+protected:
+    size_t count;
+    std::array<double,N*N> A;
+    std::array<double,N*U> B;
+    std::array<double,M*N> H;
+    std::vector<double> Q;
+    std::vector<double> R;
+    std::vector<double> P;
+    std::vector<double> K;
+    std::vector<double> S;
+    std::vector<double> L;
+    std::vector<double> ws;
+
+    yarp::sig::Matrix x;
+    yarp::sig::Vector validationGate;
+    bool steadyState;
+
+    detail::KalmanLanes<N,M,U> lanes()
+    {
+        detail::KalmanLanes<N,M,U> l={count,A.data(),B.data(),H.data(),Q.data(),R.data(),
+                                      x.data(),P.data(),K.data(),S.data(),L.data(),
+                                      validationGate.data(),ws.data()};
+        return l;
+    }
+
+    // element (r,c) of the matrix src goes into the filter k of the lanes dst
+    static bool scatter(const yarp::sig::Matrix &src, std::vector<double> &dst,
+                        const size_t rows, const size_t cols, const size_t k, const size_t count)
+    {
+        if ((src.rows()!=rows) || (src.cols()!=cols))
+            return false;
+        for (size_t r=0; r<rows; r++)
+            for (size_t c=0; c<cols; c++)
+                dst[(r*cols+c)*count+k]=src(r,c);
+        return true;
+    }
+
+
+    void initialize(const yarp::sig::Matrix &_A, const yarp::sig::Matrix &_H,
+                    const yarp::sig::Matrix &_Q, const yarp::sig::Matrix &_R)
+    {
+        yAssert(count>0);
+        bool ok=detail::copyMatrix(_A,A.data(),N,N) &&
+                detail::copyMatrix(_H,H.data(),M,N);
+
+        Q.assign(N*N*count,0.0);
+        R.assign(M*M*count,0.0);
+        P.assign(N*N*count,0.0);
+        K.assign(N*M*count,0.0);
+        S.assign(M*M*count,0.0);
+        L.assign(M*M*count,0.0);
+        ws.assign(detail::KalmanLanes<N,M,U>::workspaceSize(count),0.0);
+        x.resize(N,count); x.zero();
+        validationGate.resize(count,0.0);
+        steadyState=false;
+
+        for (size_t k=0; (k<count) && ok; k++)
+            ok=scatter(_Q,Q,N,N,k,count) && set_R(k,_R);
+        yAssert(ok);
+        YARP_UNUSED(ok);
+
+        // a correction may come before any prediction
+        lanes().innovation();
+    }
+
+    // S=H*P*H'+R and its Cholesky factor L of the filter k alone
+    void innovation(const size_t k)
+    {
+        std::array<double,N*N> Pk;
+        std::array<double,M*M> Rk,Sk,Lk;
+        std::array<double,detail::KalmanLanes<N,M,U,1>::workspaceSize(1)> wk;
+        for (size_t i=0; i<N*N; i++)
+            Pk[i]=P[i*count+k];
+        for (size_t i=0; i<M*M; i++)
+            Rk[i]=R[i*count+k];
+
+        detail::KalmanLanes<N,M,U,1> l={1,A.data(),B.data(),H.data(),NULL,Rk.data(),
+                                        NULL,Pk.data(),NULL,Sk.data(),Lk.data(),
+                                        NULL,wk.data()};
+        l.innovation();
+
+        for (size_t i=0; i<M*M; i++)
+        {
+            S[i*count+k]=Sk[i];
+            L[i*count+k]=Lk[i];
+        }
+    }
+
+public:
+    /**
+     * Init a bank of Kalman state estimators.
+     *
+     * @param _count Number of filters.
+     * @param _A State transition matrix (NxN).
+     * @param _H Measurement matrix (MxN).
+     * @param _Q Process noise covariance (NxN) of all the filters.
+     * @param _R Measurement noise covariance (MxM) of all the
+     *           filters, positive definite.
+     */
+    FixedKalmanBank(const size_t _count, const yarp::sig::Matrix &_A,
+                    const yarp::sig::Matrix &_H, const yarp::sig::Matrix &_Q,
+                    const yarp::sig::Matrix &_R) : count(_count)
+    {
+        B.fill(0.0);
+        initialize(_A,_H,_Q,_R);
+    }
+
+    /**
+     * Init a bank of Kalman state estimators.
+     *
+     * @param _count Number of filters.
+     * @param _A State transition matrix (NxN).
+     * @param _B Input matrix (NxU).
+     * @param _H Measurement matrix (MxN).
+     * @param _Q Process noise covariance (NxN) of all the filters.
+     * @param _R Measurement noise covariance (MxM) of all the
+     *           filters, positive definite.
+     */
+    FixedKalmanBank(const size_t _count, const yarp::sig::Matrix &_A,
+                    const yarp::sig::Matrix &_B, const yarp::sig::Matrix &_H,
+                    const yarp::sig::Matrix &_Q, const yarp::sig::Matrix &_R) : count(_count)
+    {
+        bool ok=detail::copyMatrix(_B,B.data(),N,U);
+        yAssert(ok);
+        YARP_UNUSED(ok);
+        initialize(_A,_H,_Q,_R);
+    }
+
+    /**
+     * Returns the number of filters.
+     *
+     * @return the number of filters.
+     */
+    size_t size() const { return count; }
+
+    /**
+     * Set initial state and error covariance of one filter.
+     *
+     * @param k The filter.
+     * @param _x0 Initial condition for estimated state.
+     * @param _P0 Initial condition for estimated error covariance.
+     * @return true/false on success/failure.
+     * @note The steady-state gains, if in use, are kept; otherwise
+     *       the innovation covariance of the filter is computed
+     *       from _P0.
+     */
+    bool init(const size_t k, const yarp::sig::Vector &_x0, const yarp::sig::Matrix &_P0)
+    {
+        if ((k<count) && (_x0.length()==N) && (_P0.rows()==N) && (_P0.cols()==N))
+        {
+            for (size_t i=0; i<N; i++)
+                x(i,k)=_x0[i];
+            scatter(_P0,P,N,N,k,count);
+            if (!steadyState)
+                innovation(k);
+            return true;
+        }
+        else
+            return false;
+    }
+
+    /**
+     * Predicts the next states given the current inputs.
+     *
+     * @param u Current inputs, one column per filter (Uxcount).
+     *
+     * @return Estimated states, one column per filter.
+     */
+    const yarp::sig::Matrix& predict(const yarp::sig::Matrix &u)
+    {
+        yAssert((u.rows()==U) && (u.cols()==count));
+        detail::KalmanLanes<N,M,U> l=lanes();
+        l.predictState(u.data());
+        if (!steadyState)
+            l.predictCovariance();
+        std::fill(validationGate.begin(),validationGate.end(),0.0);
+        return x;
+    }
+
+    /**
+     * Predicts the next states.
+     *
+     * @return Estimated states, one column per filter.
+     */
+    const yarp::sig::Matrix& predict()
+    {
+        detail::KalmanLanes<N,M,U> l=lanes();
+        l.predictState(NULL);
+        if (!steadyState)
+            l.predictCovariance();
+        std::fill(validationGate.begin(),validationGate.end(),0.0);
+        return x;
+    }
+
+    /**
+     * Corrects the current estimations of the states given the
+     * current measurements.
+     *
+     * @param z Current measurements, one column per filter
+     *          (Mxcount).
+     *
+     * @return Estimated states, one column per filter.
+     */
+    const yarp::sig::Matrix& correct(const yarp::sig::Matrix &z)
+    {
+        yAssert((z.rows()==M) && (z.cols()==count));
+        detail::KalmanLanes<N,M,U> l=lanes();
+        if (!steadyState)
+            l.gain();
+        l.correctState(z.data());
+        if (!steadyState)
+            l.correctCovariance();
+        return x;
+    }
+
+    /**
+     * Predicts and corrects all the filters.
+     *
+     * @param u Current inputs (Uxcount).
+     * @param z Current measurements (Mxcount).
+     *
+     * @return Estimated states, one column per filter.
+     */
+    const yarp::sig::Matrix& filt(const yarp::sig::Matrix &u, const yarp::sig::Matrix &z)
+    {
+        predict(u);
+        return correct(z);
+    }
+
+    /**
+     * Predicts and corrects all the filters.
+     *
+     * @param z Current measurements (Mxcount).
+     *
+     * @return Estimated states, one column per filter.
+     */
+    const yarp::sig::Matrix& filt(const yarp::sig::Matrix &z)
+    {
+        predict();
+        return correct(z);
+    }
+
+    /**
+     * Computes the steady-state gains of all the filters, as
+     * FixedKalman::computeSteadyState() does.
+     *
+     * @param maxIter the maximum number of iterations.
+     * @param tol the largest change of the gain elements telling
+     *            the convergence.
+     * @return true/false on convergence of all the
+     *         filters/failure; in the latter case the bank is left
+     *         unchanged.
+     */
+    bool computeSteadyState(const size_t maxIter=10000, const double tol=1e-12)
+    {
+        std::vector<double> P0=P;
+        std::vector<double> K0=K;
+        std::vector<double> Kprev(K.size());
+
+        detail::KalmanLanes<N,M,U> l=lanes();
+        for (size_t iter=0; iter<maxIter; iter++)
+        {
+            Kprev=K;
+
+            l.predictCovariance();
+            l.gain();
+            l.correctCovariance();
+
+            double delta=0.0;
+            for (size_t i=0; i<K.size(); i++)
+                delta=std::max(delta,std::fabs(K[i]-Kprev[i]));
+
+            if ((iter>0) && (delta<tol))
+            {
+                steadyState=true;
+                return true;
+            }
+        }
+
+        P=P0;
+        K=K0;
+        return false;
+    }
+
+    /**
+     * Goes back to propagating the covariances at each step.
+     */
+    void resetSteadyState() { steadyState=false; }
+
+    /**
+     * Tells whether the steady-state gains are in use.
+     *
+     * @return true/false.
+     */
+    bool isSteadyState() const { return steadyState; }
+
+    /**
+     * Returns the estimated states.
+     *
+     * @return Estimated states, one column per filter.
+     */
+    const yarp::sig::Matrix& get_x() const { return x; }
+
+    /**
+     * Returns the estimated state of one filter.
+     *
+     * @param k The filter.
+     * @return Estimated state.
+     */
+    yarp::sig::Vector get_x(const size_t k) const { return x.getCol(k); }
+
+    /**
+     * Returns the estimated state covariance of one filter.
+     *
+     * @param k The filter.
+     * @return Estimated state covariance.
+     */
+    yarp::sig::Matrix get_P(const size_t k) const { return detail::toMatrix(P.data(),N,N,k,count); }
+
+    /**
+     * Returns the estimated measurement covariance of one filter.
+     *
+     * @param k The filter.
+     * @return Estimated measurement covariance.
+     */
+    yarp::sig::Matrix get_S(const size_t k) const { return detail::toMatrix(S.data(),M,M,k,count); }
+
+    /**
+     * Returns the Kalman gain matrix of one filter.
+     *
+     * @param k The filter.
+     * @return Kalman gain matrix.
+     */
+    yarp::sig::Matrix get_K(const size_t k) const { return detail::toMatrix(K.data(),N,M,k,count); }
+
+    /**
+     * Returns the validation gates.
+     * @note The validation gates are meaningful only after
+     *       correction.
+     * @return validation gates, one per filter.
+     */
+    const yarp::sig::Vector& get_ValidationGate() const { return validationGate; }
+
+    /**
+     * Sets the process noise covariance matrix of one filter.
+     *
+     * @param k The filter.
+     * @param _Q Process noise covariance matrix.
+     * @return true/false on success/failure.
+     * @note The steady-state gains are dropped.
+     */
+    bool set_Q(const size_t k, const yarp::sig::Matrix &_Q)
+    {
+        if ((k>=count) || !scatter(_Q,Q,N,N,k,count))
+            return false;
+        steadyState=false;
+        return true;
+    }
+
+    /**
+     * Sets the measurement noise covariance matrix of one filter.
+     *
+     * @param k The filter.
+     * @param _R Measurement noise covariance matrix, positive
+     *           definite.
+     * @return true/false on success/failure.
+     * @note The steady-state gains are dropped.
+     */
+    bool set_R(const size_t k, const yarp::sig::Matrix &_R)
+    {
+        std::array<double,M*M> R0;
+        if ((k>=count) || !detail::copyMatrix(_R,R0.data(),M,M))
+            return false;
+
+        if (!detail::positiveDefinite<M>(R0.data()))
+            return false;
+
+        for (size_t i=0; i<M*M; i++)
+            R[i*count+k]=R0[i];
+        steadyState=false;
+        return true;
+    }
+};
+
+}
+
+}
+
+#endif
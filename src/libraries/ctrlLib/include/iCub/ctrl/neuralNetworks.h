@@ -28,6 +28,7 @@
 
 #include <yarp/os/Property.h>
 #include <yarp/sig/Vector.h>
+#include <yarp/sig/Matrix.h>
 #include <iCub/ctrl/math.h>
 
 
@@ -79,6 +80,12 @@ protected:
 
     bool configured;
 
+    // workspaces of the batched prediction
+    mutable yarp::sig::Matrix batchIW;
+    mutable yarp::sig::Matrix batchLW;
+    mutable yarp::sig::Vector batchB1;
+    mutable yarp::sig::Matrix batchHidden;
+
     void prepare();
     void setItem(yarp::os::Property &options, const std::string &tag, const yarp::sig::Vector &item) const;
     bool getItem(const yarp::os::Property &options, const std::string &tag, yarp::sig::Vector &item) const;
@@ -155,6 +162,22 @@ public:
     */ 
     virtual yarp::sig::Vector predict(const yarp::sig::Vector &x) const;
 
+    /**
+    * Predict the outputs for a batch of inputs to the network.
+    * @param X is the matrix of inputs, one per row.
+    * @param Y is the matrix of the predicted outputs, one per row;
+    *          it is resized only if needed.
+    * @return true/false on success/fail. 
+    *  
+    * @note the internal workspaces are reused across calls, hence 
+    *       concurrent batched predictions on the same network are
+    *       not allowed.
+    * @note the layer functions are applied through 
+    *       hiddenLayerBatchFcn() and outputLayerBatchFcn(), which
+    *       may trade some accuracy for speed.
+    */ 
+    virtual bool predict(const yarp::sig::Matrix &X, yarp::sig::Matrix &Y) const;
+
     /**
     * Retrieve the network structure as a Property object.
     * @param options is the output stream. 
@@ -249,6 +272,20 @@ public:
     * @return the output vector.
     */ 
     virtual yarp::sig::Vector outputLayerGrad(const yarp::sig::Vector &x) const=0;
+
+    /**
+    * Hidden Layer Function applied in place to a batch of inputs, 
+    * one per row. By default it relies on hiddenLayerFcn().
+    * @param x is the input/output matrix.
+    */ 
+    virtual void hiddenLayerBatchFcn(yarp::sig::Matrix &x) const;
+
+    /**
+    * Output Layer Function applied in place to a batch of inputs, 
+    * one per row. By default it relies on outputLayerFcn().
+    * @param x is the input/output matrix.
+    */ 
+    virtual void outputLayerBatchFcn(yarp::sig::Matrix &x) const;
 };
 
 
@@ -301,6 +338,20 @@ public:
     * @return the output vector.
     */ 
     virtual yarp::sig::Vector outputLayerGrad(const yarp::sig::Vector &x) const;
+
+    /**
+    * Hidden Layer Function applied in place to a batch of inputs. 
+    * The tansig is computed through a vectorizable approximation 
+    * whose absolute error is below 1e-14. 
+    * @param x is the input/output matrix.
+    */ 
+    virtual void hiddenLayerBatchFcn(yarp::sig::Matrix &x) const;
+
+    /**
+    * Output Layer Function applied in place to a batch of inputs. 
+    * @param x is the input/output matrix.
+    */ 
+    virtual void outputLayerBatchFcn(yarp::sig::Matrix &x) const;
 };
 
 }
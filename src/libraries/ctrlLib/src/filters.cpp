@@ -31,20 +31,30 @@ Filter::Filter(const Vector &num, const Vector &den, const Vector &y0)
     m=b.length(); n=a.length();
     yAssert((m>0)&&(n>0));
 
-    uold.insert(uold.begin(),m-1,zeros((int)y0.length()));
-    yold.insert(yold.begin(),n-1,zeros((int)y0.length()));
+    y=y0;
+    allocStates(y.length());
 
     init(y0);    
 }
 
 
+/***************************************************************************/
+void Filter::allocStates(const size_t dim)
+{
+    // the memory is kept when the sizes do not grow
+    uold.assign((m-1)*dim,0.0);
+    yold.assign((n-1)*dim,0.0);
+    uhead=yhead=0;
+}
+
+
 /***************************************************************************/
 void Filter::init(const Vector &y0)
 {
     // take the last input
     // as guess for the next input
-    if (uold.size()>0)
-        init(y0,uold[0]);
+    if ((m>1) && (y0.length()==y.length()))
+        init(y0,Vector(y.length(),uRow(0)));
     else    // otherwise use zero
         init(y0,zeros((int)y0.length()));    
 }
@@ -53,9 +63,10 @@ void Filter::init(const Vector &y0)
 /***************************************************************************/
 void Filter::init(const Vector &y0, const Vector &u0)
 {
-    Vector u_init(y0.length(),0.0);
-    Vector y_init=y0;
+    bool resize=(y0.length()!=y.length());
     y=y0;
+    if (resize)
+        allocStates(y.length());
 
     double sum_b=0.0;
     for (size_t i=0; i<b.length(); i++)
@@ -66,24 +77,30 @@ void Filter::init(const Vector &y0, const Vector &u0)
         sum_a+=a[i];
     
     // if filter DC gain is not zero
-    if (fabs(sum_b)>std::numeric_limits<double>::epsilon())
-        u_init=(sum_a/sum_b)*y0;
-    else
+    bool dcGain=(fabs(sum_b)>std::numeric_limits<double>::epsilon());
+    double ku=(dcGain?sum_a/sum_b:0.0);
+
+    // if filter gain is zero then you need to know in advance what
+    // the next input is going to be for initializing (that is u0)
+    // Note that, unless y0=0, the filter output is not going to be stable
+    bool scaleY=(!dcGain && (fabs(sum_a-a[0])>std::numeric_limits<double>::epsilon()));
+    double ky=(scaleY?a[0]/(a[0]-sum_a):1.0);
+    // if sum_a==a[0] then the filter can only be initialized to zero
+
+    const size_t dim=y.length();
+    for (size_t i=0; i+1<n; i++)
     {
-        // if filter gain is zero then you need to know in advance what
-        // the next input is going to be for initializing (that is u0)
-        // Note that, unless y0=0, the filter output is not going to be stable
-        u_init=u0;
-        if (fabs(sum_a-a[0])>std::numeric_limits<double>::epsilon())
-            y_init=a[0]/(a[0]-sum_a)*y;
-        // if sum_a==a[0] then the filter can only be initialized to zero
+        double *row=yRow(i);
+        for (size_t j=0; j<dim; j++)
+            row[j]=(scaleY?ky*y[j]:y[j]);
+    }
+
+    for (size_t i=0; i+1<m; i++)
+    {
+        double *row=uRow(i);
+        for (size_t j=0; j<dim; j++)
+            row[j]=(dcGain?ku*y[j]:u0[j]);
     }
-    
-    for (size_t i=0; i<yold.size(); i++)
-        yold[i]=y_init;
-    
-    for (size_t i=0; i<uold.size(); i++)
-        uold[i]=u_init;
 }
 
 
@@ -101,14 +118,10 @@ void Filter::setCoeffs(const Vector &num, const Vector &den)
     b=num;
     a=den;
 
-    uold.clear();
-    yold.clear();
-
     m=b.length(); n=a.length();
     yAssert((m>0)&&(n>0));
 
-    uold.insert(uold.begin(),m-1,zeros((int)y.length()));
-    yold.insert(yold.begin(),n-1,zeros((int)y.length()));
+    allocStates(y.length());
 
     init(y);
 }
@@ -131,8 +144,15 @@ bool Filter::adjustCoeffs(const Vector &num, const Vector &den)
 /***************************************************************************/
 void Filter::getStates(deque<Vector> &u, deque<Vector> &y)
 {
-    u=uold;
-    y=yold;
+    const size_t dim=this->y.length();
+
+    u.clear();
+    for (size_t i=0; i+1<m; i++)
+        u.push_back(Vector(dim,uRow(i)));
+
+    y.clear();
+    for (size_t i=0; i+1<n; i++)
+        y.push_back(Vector(dim,yRow(i)));
 }
 
 
@@ -140,25 +160,47 @@ void Filter::getStates(deque<Vector> &u, deque<Vector> &y)
 const Vector& Filter::filt(const Vector &u)
 {
     yAssert(y.length()==u.length());
-    for (size_t j=0; j<y.length(); j++)
-        y[j]=b[0]*u[j];
+    const size_t dim=y.length();
+    const double *pu=u.data();
+    double *py=y.data();
+
+    // channels are innermost to let the compiler vectorize
+    // while keeping the order of the operations on each channel
+    for (size_t j=0; j<dim; j++)
+        py[j]=b[0]*pu[j];
     
     for (size_t i=1; i<m; i++)
-        for (size_t j=0; j<y.length(); j++)
-            y[j]+=b[i]*uold[i-1][j];
+    {
+        const double bi=b[i];
+        const double *row=uRow(i-1);
+        for (size_t j=0; j<dim; j++)
+            py[j]+=bi*row[j];
+    }
     
     for (size_t i=1; i<n; i++)
-        for (size_t j=0; j<y.length(); j++)
-            y[j]-=a[i]*yold[i-1][j];
+    {
+        const double ai=a[i];
+        const double *row=yRow(i-1);
+        for (size_t j=0; j<dim; j++)
+            py[j]-=ai*row[j];
+    }
     
-    for (size_t j=0; j<y.length(); j++)
-        y[j]/=a[0];
+    const double a0=a[0];
+    for (size_t j=0; j<dim; j++)
+        py[j]/=a0;
     
-    uold.push_front(u);
-    uold.pop_back();
+    // the newest values take the place of the oldest ones
+    if (m>1)
+    {
+        uhead=(uhead+m-2)%(m-1);
+        std::copy(pu,pu+dim,uRow(0));
+    }
     
-    yold.push_front(y);
-    yold.pop_back();
+    if (n>1)
+    {
+        yhead=(yhead+n-2)%(n-1);
+        std::copy(py,py+dim,yRow(0));
+    }
     
     return y;
 }
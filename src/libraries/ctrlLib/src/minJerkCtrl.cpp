@@ -178,8 +178,7 @@ Vector minJerkVelCtrlForNonIdealPlant::computeCmd(const double _T, const Vector
     for (int i=0; i<dim; i++)
     {
         _e[0]=e[i];
-        Vector _y=F[i]->filt(_e);
-        y[i]=_y[0];
+        y[i]=F[i]->filt(_e)[0];
     }
 
     return y;
@@ -11,6 +11,8 @@
 #include <sstream>
 #include <iomanip>
 #include <cmath>
+#include <cstring>
+#include <cstdint>
 
 #include <yarp/math/Math.h>
 #include <iCub/ctrl/neuralNetworks.h>
@@ -256,6 +258,110 @@ Vector ff2LayNN::predict(const Vector &x) const
 }
 
 
+/***************************************************************************/
+bool ff2LayNN::predict(const Matrix &X, Matrix &Y) const
+{
+    size_t numInput=inMinX.length();
+    size_t numHidden=IW.size();
+    size_t numOutput=LW.size();
+    if (!configured || (X.cols()!=numInput))
+        return false;
+
+    // the input scaling is folded into the first layer, whose weights
+    // are transposed such that the inner loops run on contiguous memory;
+    // weights are packed at each call since they might be changed
+    // through get_IW() and get_LW()
+    if ((batchIW.rows()!=numInput) || (batchIW.cols()!=numHidden))
+        batchIW.resize(numInput,numHidden);
+    if (batchB1.length()!=numHidden)
+        batchB1.resize(numHidden);
+    if ((batchLW.rows()!=numHidden) || (batchLW.cols()!=numOutput))
+        batchLW.resize(numHidden,numOutput);
+
+    for (size_t j=0; j<numHidden; j++)
+    {
+        batchB1[j]=b1[j];
+        for (size_t i=0; i<numInput; i++)
+        {
+            batchIW(i,j)=IW[j][i]*inRatio[i];
+            batchB1[j]+=IW[j][i]*(inMinY[i]-inRatio[i]*inMinX[i]);
+        }
+    }
+
+    for (size_t k=0; k<numOutput; k++)
+        for (size_t j=0; j<numHidden; j++)
+            batchLW(j,k)=LW[k][j];
+
+    size_t N=X.rows();
+    if ((batchHidden.rows()!=N) || (batchHidden.cols()!=numHidden))
+        batchHidden.resize(N,numHidden);
+    if ((Y.rows()!=N) || (Y.cols()!=numOutput))
+        Y.resize(N,numOutput);
+
+    // compute the output a1 of hidden layer
+    for (size_t n=0; n<N; n++)
+    {
+        const double *x=X[n];
+        double *h=batchHidden[n];
+        for (size_t j=0; j<numHidden; j++)
+            h[j]=batchB1[j];
+
+        for (size_t i=0; i<numInput; i++)
+        {
+            const double *w=batchIW[i];
+            double xi=x[i];
+            for (size_t j=0; j<numHidden; j++)
+                h[j]+=xi*w[j];
+        }
+    }
+    hiddenLayerBatchFcn(batchHidden);
+
+    // compute the output a2 of the network
+    for (size_t n=0; n<N; n++)
+    {
+        const double *h=batchHidden[n];
+        double *y=Y[n];
+        for (size_t k=0; k<numOutput; k++)
+            y[k]=b2[k];
+
+        for (size_t j=0; j<numHidden; j++)
+        {
+            const double *w=batchLW[j];
+            double hj=h[j];
+            for (size_t k=0; k<numOutput; k++)
+                y[k]+=hj*w[k];
+        }
+    }
+    outputLayerBatchFcn(Y);
+
+    // output postprocessing
+    for (size_t n=0; n<N; n++)
+    {
+        double *y=Y[n];
+        for (size_t k=0; k<numOutput; k++)
+            y[k]=outRatio[k]*(y[k]-outMinY[k])+outMinX[k];
+    }
+
+    return true;
+}
+
+
+/***************************************************************************/
+void ff2LayNN::hiddenLayerBatchFcn(Matrix &x) const
+{
+    for (size_t r=0; r<x.rows(); r++)
+        x.setRow(r,hiddenLayerFcn(x.getRow(r)));
+}
+
+
+/***************************************************************************/
+void ff2LayNN::outputLayerBatchFcn(Matrix &x) const
+{
+    for (size_t r=0; r<x.rows(); r++)
+        x.setRow(r,outputLayerFcn(x.getRow(r)));
+}
+
+
 /***************************************************************************/
 bool ff2LayNN::getStructure(Property &options) const
 {
@@ -410,3 +516,45 @@ Vector ff2LayNN_tansig_purelin::outputLayerGrad(const Vector &x) const
 }
 
 
+/***************************************************************************/
+void ff2LayNN_tansig_purelin::hiddenLayerBatchFcn(Matrix &x) const
+{
+    // tansig(x)=1-2/(1+exp(2*x)), with exp(y)=2^k*exp(r), |r|<=log(2)/2,
+    // where exp(r) is expanded up to the 11th order and 2^k is built
+    // straight in the exponent bits; the saturation is written without
+    // branches to let the compiler vectorize the loop
+    const double magic=6755399441055744.0;     // 1.5*2^52
+    int64_t magicBits;
+    memcpy(&magicBits,&magic,sizeof(magic));
+
+    double *data=x.data();
+    size_t len=x.rows()*x.cols();
+    for (size_t i=0; i<len; i++)
+    {
+        double v=data[i];
+        double y=std::fabs(v+20.0)-std::fabs(v-20.0);  // 2*saturate(v,-20,20)
+
+        double t=y*1.4426950408889634+magic;
+        double k=t-magic;
+        double r=(y-k*0.6931471803691238)-k*1.9082149292705877e-10;
+        double p=1.0+r*(1.0+r*(1.0/2.0+r*(1.0/6.0+r*(1.0/24.0+r*(1.0/120.0+r*(1.0/720.0+
+                 r*(1.0/5040.0+r*(1.0/40320.0+r*(1.0/362880.0+r*(1.0/3628800.0+
+                 r*(1.0/39916800.0)))))))))));
+
+        int64_t bits;
+        memcpy(&bits,&t,sizeof(t));
+        bits=(bits-magicBits+1023)<<52;
+
+        double scale;
+        memcpy(&scale,&bits,sizeof(bits));
+        data[i]=1.0-2.0/(1.0+p*scale);
+    }
+}
+
+
+/***************************************************************************/
+void ff2LayNN_tansig_purelin::outputLayerBatchFcn(Matrix &x) const
+{
+}
+
+
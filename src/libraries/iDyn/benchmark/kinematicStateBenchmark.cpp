@@ -0,0 +1,255 @@
+/*
+ * Copyright (C) 2022 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+// CPU time per cycle spent by a number of dynamics modules (wholeBodyDynamics,
+// gravityCompensator, ...) to get the kinematic state of the robot, when each
+// of them estimates the joints velocities and accelerations and computes the
+// forward kinematics on its own and when only one of them does it and publishes
+// the result through iCubKinematicStateWriter, the others attaching with
+// iCubKinematicStateReader. The encoders follow a synthetic trajectory, hence
+// the time spent by the modules in reading the robot through the network is
+// not accounted for and comes on top of the "own" figures.
+//
+// kinematicStateBenchmark [--consumers 2] [--cycles 5000] [--name benchmark]
+
+#include <cstdio>
+#include <cmath>
+#include <ctime>
+#include <string>
+#include <vector>
+
+#include <yarp/os/all.h>
+#include <yarp/sig/all.h>
+#include <yarp/math/Math.h>
+
+#include <iCub/ctrl/math.h>
+#include <iCub/ctrl/adaptWinPolyEstimator.h>
+#include <iCub/iDyn/iDynBody.h>
+#include <iCub/iDyn/iDynSharedState.h>
+
+using namespace std;
+using namespace yarp::os;
+using namespace yarp::sig;
+using namespace yarp::math;
+using namespace iCub::ctrl;
+using namespace iCub::iDyn;
+
+
+/***************************************************************************/
+class Module
+{
+    iCubWholeBody icub;
+    AWLinEstimator  linEstUp,linEstLow;
+    AWQuadEstimator quadEstUp,quadEstLow;
+
+public:
+    Vector q_up,dq_up,d2q_up;
+    Vector q_low,dq_low,d2q_low;
+    Vector w0,dw0,d2p0;
+    Matrix H[ICUB_KINSTATE_LIMBS];
+
+    /***********************************************************************/
+    Module() : icub(version_tag(),DYNAMIC,iCub::skinDynLib::NO_VERBOSE),
+               linEstUp(16,1.0), linEstLow(16,1.0),
+               quadEstUp(25,1.0), quadEstLow(25,1.0),
+               q_up(ICUB_KINSTATE_UP_DOF,0.0), dq_up(ICUB_KINSTATE_UP_DOF,0.0),
+               d2q_up(ICUB_KINSTATE_UP_DOF,0.0), q_low(ICUB_KINSTATE_LOW_DOF,0.0),
+               dq_low(ICUB_KINSTATE_LOW_DOF,0.0), d2q_low(ICUB_KINSTATE_LOW_DOF,0.0),
+               w0(3,0.0), dw0(3,0.0), d2p0(3,0.0)
+    {
+        d2p0[2]=9.81;
+    }
+
+    /***********************************************************************/
+    void setMeasure()
+    {
+        icub.upperTorso->setAng("head",CTRL_DEG2RAD*q_up.subVector(0,2));
+        icub.upperTorso->setAng("left_arm",CTRL_DEG2RAD*q_up.subVector(3,9));
+        icub.upperTorso->setAng("right_arm",CTRL_DEG2RAD*q_up.subVector(10,16));
+        icub.upperTorso->setDAng("head",CTRL_DEG2RAD*dq_up.subVector(0,2));
+        icub.upperTorso->setDAng("left_arm",CTRL_DEG2RAD*dq_up.subVector(3,9));
+        icub.upperTorso->setDAng("right_arm",CTRL_DEG2RAD*dq_up.subVector(10,16));
+        icub.upperTorso->setD2Ang("head",CTRL_DEG2RAD*d2q_up.subVector(0,2));
+        icub.upperTorso->setD2Ang("left_arm",CTRL_DEG2RAD*d2q_up.subVector(3,9));
+        icub.upperTorso->setD2Ang("right_arm",CTRL_DEG2RAD*d2q_up.subVector(10,16));
+        icub.lowerTorso->setAng("torso",CTRL_DEG2RAD*q_low.subVector(0,2));
+        icub.lowerTorso->setAng("left_leg",CTRL_DEG2RAD*q_low.subVector(3,8));
+        icub.lowerTorso->setAng("right_leg",CTRL_DEG2RAD*q_low.subVector(9,14));
+        icub.lowerTorso->setDAng("torso",CTRL_DEG2RAD*dq_low.subVector(0,2));
+        icub.lowerTorso->setDAng("left_leg",CTRL_DEG2RAD*dq_low.subVector(3,8));
+        icub.lowerTorso->setDAng("right_leg",CTRL_DEG2RAD*dq_low.subVector(9,14));
+        icub.lowerTorso->setD2Ang("torso",CTRL_DEG2RAD*d2q_low.subVector(0,2));
+        icub.lowerTorso->setD2Ang("left_leg",CTRL_DEG2RAD*d2q_low.subVector(3,8));
+        icub.lowerTorso->setD2Ang("right_leg",CTRL_DEG2RAD*d2q_low.subVector(9,14));
+    }
+
+    /***********************************************************************/
+    void update(const double t)
+    {
+        AWPolyElement el;
+        el.time=t;
+
+        el.data=q_up;
+        dq_up=linEstUp.estimate(el);
+        d2q_up=quadEstUp.estimate(el);
+
+        el.data=q_low;
+        dq_low=linEstLow.estimate(el);
+        d2q_low=quadEstLow.estimate(el);
+
+        setMeasure();
+        icub.upperTorso->setInertialMeasure(w0,dw0,d2p0);
+        icub.upperTorso->solveKinematics();
+        icub.lowerTorso->setInertialMeasure(icub.upperTorso->getTorsoAngVel(),
+                                            icub.upperTorso->getTorsoAngAcc(),
+                                            icub.upperTorso->getTorsoLinAcc());
+        icub.lowerTorso->solveKinematics();
+
+        H[KINSTATE_HEAD]=icub.upperTorso->up->getH();
+        H[KINSTATE_LEFT_ARM]=icub.upperTorso->left->getH();
+        H[KINSTATE_RIGHT_ARM]=icub.upperTorso->right->getH();
+        H[KINSTATE_TORSO]=icub.lowerTorso->up->getH();
+        H[KINSTATE_LEFT_LEG]=icub.lowerTorso->left->getH();
+        H[KINSTATE_RIGHT_LEG]=icub.lowerTorso->right->getH();
+    }
+
+    /***********************************************************************/
+    void publish(iCubKinematicStateWriter &writer, const double t)
+    {
+        iCubKinematicState &state=writer.prepare();
+        state.timestamp=t;
+        for (int i=0; i<ICUB_KINSTATE_UP_DOF; i++)
+        {
+            state.q_up[i]=q_up[i];
+            state.dq_up[i]=dq_up[i];
+            state.d2q_up[i]=d2q_up[i];
+        }
+        for (int i=0; i<ICUB_KINSTATE_LOW_DOF; i++)
+        {
+            state.q_low[i]=q_low[i];
+            state.dq_low[i]=dq_low[i];
+            state.d2q_low[i]=d2q_low[i];
+        }
+        for (int i=0; i<3; i++)
+        {
+            state.w0[i]=w0[i];
+            state.dw0[i]=dw0[i];
+            state.d2p0[i]=d2p0[i];
+        }
+        for (int l=0; l<ICUB_KINSTATE_LIMBS; l++)
+            for (int i=0; i<16; i++)
+                state.H[l][i]=H[l].data()[i];
+
+        writer.write();
+    }
+
+    /***********************************************************************/
+    bool attach(const iCubKinematicStateReader &reader)
+    {
+        unsigned long long seq;
+        const iCubKinematicState *state=reader.read(seq);
+        if (state==NULL)
+            return false;
+
+        for (int i=0; i<ICUB_KINSTATE_UP_DOF; i++)
+        {
+            q_up[i]=state->q_up[i];
+            dq_up[i]=state->dq_up[i];
+            d2q_up[i]=state->d2q_up[i];
+        }
+        for (int i=0; i<ICUB_KINSTATE_LOW_DOF; i++)
+        {
+            q_low[i]=state->q_low[i];
+            dq_low[i]=state->dq_low[i];
+            d2q_low[i]=state->d2q_low[i];
+        }
+
+        if (!reader.check(seq))
+            return false;
+
+        // the consumer still needs the angles in its own model for the dynamics
+        setMeasure();
+        return true;
+    }
+};
+
+
+/***************************************************************************/
+void encoders(const double t, Vector &q_up, Vector &q_low)
+{
+    for (size_t i=0; i<q_up.length(); i++)
+        q_up[i]=20.0*sin(2.0*M_PI*0.2*t+0.1*i);
+    for (size_t i=0; i<q_low.length(); i++)
+        q_low[i]=10.0*sin(2.0*M_PI*0.1*t+0.1*i);
+}
+
+
+/***************************************************************************/
+int main(int argc, char *argv[])
+{
+    Property options;
+    options.fromCommand(argc,argv);
+
+    int numConsumers=options.check("consumers",Value(2)).asInt32();
+    int cycles=options.check("cycles",Value(5000)).asInt32();
+    string name=options.check("name",Value("benchmark")).asString();
+    const double Ts=0.01;
+
+    // each module on its own
+    vector<Module*> modules(numConsumers);
+    for (int m=0; m<numConsumers; m++)
+        modules[m]=new Module;
+
+    clock_t c0=clock();
+    for (int k=0; k<cycles; k++)
+    {
+        for (int m=0; m<numConsumers; m++)
+        {
+            encoders(k*Ts,modules[m]->q_up,modules[m]->q_low);
+            modules[m]->update(k*Ts);
+        }
+    }
+    double cOwn=(double)(clock()-c0)/CLOCKS_PER_SEC;
+
+    // one producer, the others attached to the shared state
+    iCubKinematicStateWriter writer;
+    iCubKinematicStateReader reader;
+    if (!writer.open(name) || !reader.open(name))
+    {
+        yError("shared memory not available");
+        return 1;
+    }
+
+    Module producer;
+    int failures=0;
+    double cProducer=0.0,cConsumers=0.0;
+    for (int k=0; k<cycles; k++)
+    {
+        c0=clock();
+        encoders(k*Ts,producer.q_up,producer.q_low);
+        producer.update(k*Ts);
+        producer.publish(writer,k*Ts);
+        clock_t c1=clock();
+        for (int m=1; m<numConsumers; m++)
+            failures+=modules[m]->attach(reader)?0:1;
+        clock_t c2=clock();
+
+        cProducer+=(double)(c1-c0)/CLOCKS_PER_SEC;
+        cConsumers+=(double)(c2-c1)/CLOCKS_PER_SEC;
+    }
+
+    printf("%d modules, %d cycles\n",numConsumers,cycles);
+    printf("own kinematics   : %8.2f us/cycle\n",1e6*cOwn/cycles);
+    printf("shared kinematics: %8.2f us/cycle (producer %.2f, consumers %.2f), %d failed reads\n",
+           1e6*(cProducer+cConsumers)/cycles,1e6*cProducer/cycles,1e6*cConsumers/cycles,failures);
+
+    for (int m=0; m<numConsumers; m++)
+        delete modules[m];
+
+    return 0;
+}
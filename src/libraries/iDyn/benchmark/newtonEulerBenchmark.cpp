@@ -0,0 +1,132 @@
+/*
+ * Copyright (C) 2022 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+// Time per call of computeNewtonEuler() on the iCub limbs, when the chain runs
+// on the packed fixed-size storage and when it runs on the classic path built
+// on yarp::sig::Vector/Matrix temporaries, together with the largest deviation
+// of the joint torques between the two. Joints angles, velocities and
+// accelerations follow a synthetic trajectory.
+//
+// newtonEulerBenchmark [--cycles 20000] [--mode dynamic|static|rotor|coriolis]
+
+#include <cstdio>
+#include <cmath>
+#include <string>
+#include <algorithm>
+
+#include <yarp/os/all.h>
+#include <yarp/sig/all.h>
+#include <yarp/math/Math.h>
+
+#include <iCub/iDyn/iDyn.h>
+
+using namespace std;
+using namespace yarp::os;
+using namespace yarp::sig;
+using namespace yarp::math;
+using namespace iCub::iDyn;
+
+
+/***************************************************************************/
+void setState(iDynChain &chain, const int k)
+{
+    unsigned int n=chain.getDOF();
+    Vector q(n),dq(n),ddq(n);
+    for (unsigned int i=0; i<n; i++)
+    {
+        double w=0.5+0.1*i;
+        double t=0.001*k;
+        q[i]=0.3*sin(w*t);
+        dq[i]=0.3*w*cos(w*t);
+        ddq[i]=-0.3*w*w*sin(w*t);
+    }
+
+    chain.setAng(q);
+    chain.setDAng(dq);
+    chain.setD2Ang(ddq);
+}
+
+
+/***************************************************************************/
+double run(iDynChain &chain, const NewEulMode mode, const int cycles)
+{
+    Vector w0(3,0.0),dw0(3,0.0),ddp0(3,0.0),z3(3,0.0);
+    ddp0[2]=9.81;
+
+    chain.prepareNewtonEuler(mode);
+    double t=0.0;
+    for (int k=0; k<cycles; k++)
+    {
+        setState(chain,k);
+        double t0=Time::now();
+        chain.computeNewtonEuler(w0,dw0,ddp0,z3,z3);
+        t+=Time::now()-t0;
+    }
+
+    return t;
+}
+
+
+/***************************************************************************/
+void compare(const string &name, iDynLimb &fixedLimb, iDynLimb &classicLimb,
+             const NewEulMode mode, const int cycles)
+{
+    iDynChain &fixed=*fixedLimb.asChain();
+    iDynChain &classic=*classicLimb.asChain();
+    fixed.setFixedStorageNewtonEuler(true);
+    classic.setFixedStorageNewtonEuler(false);
+
+    double tFixed=run(fixed,mode,cycles);
+    double tClassic=run(classic,mode,cycles);
+
+    Vector d=fixed.getTorques()-classic.getTorques();
+    double dev=0.0;
+    for (size_t i=0; i<d.length(); i++)
+        dev=std::max(dev,fabs(d[i]));
+
+    printf("%-10s | %17.3f | %15.3f | %8.2f | %.2e\n",name.c_str(),
+           1e6*tClassic/cycles,1e6*tFixed/cycles,tClassic/tFixed,dev);
+}
+
+
+/***************************************************************************/
+int main(int argc, char *argv[])
+{
+    Property options;
+    options.fromCommand(argc,argv);
+
+    int cycles=options.check("cycles",Value(20000)).asInt32();
+    string modeName=options.check("mode",Value("dynamic")).asString();
+
+    NewEulMode mode=DYNAMIC;
+    if (modeName=="static")
+        mode=STATIC;
+    else if (modeName=="rotor")
+        mode=DYNAMIC_W_ROTOR;
+    else if (modeName=="coriolis")
+        mode=DYNAMIC_CORIOLIS_GRAVITY;
+
+    printf("limb       | classic [us/call] | fixed [us/call] | speed-up | max torque deviation\n");
+
+    iCubArmDyn armFixedR("right"), armClassicR("right");
+    compare("right arm",armFixedR,armClassicR,mode,cycles);
+
+    iCubArmDyn armFixedL("left"), armClassicL("left");
+    compare("left arm",armFixedL,armClassicL,mode,cycles);
+
+    iCubLegDyn legFixedR("right"), legClassicR("right");
+    compare("right leg",legFixedR,legClassicR,mode,cycles);
+
+    iCubLegDyn legFixedL("left"), legClassicL("left");
+    compare("left leg",legFixedL,legClassicL,mode,cycles);
+
+    iCubTorsoDyn torsoFixed("lower"), torsoClassic("lower");
+    compare("torso",torsoFixed,torsoClassic,mode,cycles);
+
+    return 0;
+}
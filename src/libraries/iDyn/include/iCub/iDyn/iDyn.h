@@ -71,6 +71,7 @@
 #include <iCub/iKin/iKinFwd.h>
 #include <iCub/iDyn/iDynInv.h>
 
+#include <cstdint>
 #include <deque>
 #include <string>
 
@@ -118,6 +119,7 @@ class iDynLink : public iKin::iKinLink
 {
     friend class iDynChain;
     friend class OneLinkNewtonEuler;
+    friend class OneChainNewtonEuler;
 
 protected:
     // DH rototranslation matrix (it's the same matrix you get calling iKinLink->getH(true) but it's stored here for performance reason)
@@ -176,6 +178,9 @@ protected:
     ///F_{s,i}  static friction
     double Fs;                  
 
+    /// renewed from a counter shared by all the links whenever the dynamic parameters change, so that packed copies can be refreshed
+    std::uint64_t paramsVersion;
+
     /**
     * Default constructor : not implemented
     */
@@ -552,6 +557,8 @@ protected:
 
     ///pointer to OneChainNewtonEuler class, to be used for computing forces and torques
     OneChainNewtonEuler *NE;
+    ///true if NE runs on fixed-size storage (see OneChainNewtonEuler::setFixedStorage())
+    bool fixedStorageNE;
 
     const yarp::sig::Vector zero0;
 
@@ -854,6 +861,20 @@ public:
     */
     void setModeNewtonEuler(const NewEulMode NewEulMode_s=DYNAMIC);
 
+    /**
+    * Select whether Newton-Euler runs on fixed-size 3-vectors and 3x3 matrices with
+    * the link constants packed once (default), avoiding any allocation per call, or
+    * through the classic per-link computations; the outputs agree up to round-off.
+    * The choice holds also for the chains prepared afterwards.
+    * @param sw true for the fixed-size storage
+    */
+    void setFixedStorageNewtonEuler(const bool sw=true);
+
+    /**
+    * @return true if Newton-Euler runs on fixed-size storage
+    */
+    bool getFixedStorageNewtonEuler() const;
+
     /**
     * Returns the links forces as a matrix, where the (i+1)-th col is the i-th force
     * @return a 3x(N+2) matrix with forces, in the form: (i+1)-th col = F_i
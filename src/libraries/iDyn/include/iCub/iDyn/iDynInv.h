@@ -49,8 +49,10 @@
 #include <iCub/iKin/iKinFwd.h>
 #include <iCub/iDyn/iDyn.h>
 #include <iCub/skinDynLib/common.h>
+#include <cstdint>
 #include <deque>
 #include <string>
+#include <vector>
 
 
 namespace iCub
@@ -94,6 +96,8 @@ const std::string ChainComputationMode_s[4] = {"Kinematic Forward - Wrench Forwa
 */
 class OneLinkNewtonEuler
 {
+    friend class OneChainNewtonEuler;
+
 protected:
 
     /// STATIC/DYNAMIC/DYNAMIC_W_ROTOR/DYNAMIC_CORIOLIS_GRAVITY
@@ -490,6 +494,8 @@ public:
 */
 class BaseLinkNewtonEuler : public OneLinkNewtonEuler
 {
+    friend class OneChainNewtonEuler;
+
 protected:
     ///initial angular velocity
     yarp::sig::Vector w;    
@@ -901,6 +907,54 @@ protected:
     /// verbosity flag
     unsigned int verbose;
 
+    /// constants of a link packed for the fixed-storage recursion, and its DH rotation
+    struct FixedLink
+    {
+        /// iDynLink::paramsVersion at the time the constants were copied, 0 if never
+        std::uint64_t version;
+        double m;
+        double rc[3];
+        /// inertia, row-major
+        double I[9];
+        double kr, Im, Fv, Fs;
+        /// joint angle (with offset) the cosine and sine refer to
+        double theta, c_theta, s_theta;
+        /// R^{i-1}_i, row-major, and r^i_{i-1,i} projected in frame i
+        double R[9];
+        double r[3];
+    };
+
+    /// true if the recursion runs on the fixed-size storage of fixedLinks
+    bool fixedStorage;
+    /// one entry per link, allocated at construction
+    std::vector<FixedLink> fixedLinks;
+
+    /**
+    * Refresh the constants of the l-th link if its parameters changed, and its rotation.
+    */
+    const FixedLink& updateFixedLink(unsigned int l);
+
+    /**
+    * Fixed-storage counterpart of ForwardKinematicFromBase().
+    */
+    void fixedForwardKinematics();
+
+    /**
+    * Fixed-storage counterpart of the backward wrench phase: frames first...0 take their
+    * wrench from the following one, then the torques of frames lastTorque...1 are computed.
+    */
+    void fixedBackwardWrench(int first, int lastTorque);
+
+    /**
+    * Fixed-storage counterpart of ForwardWrenchToEnd().
+    */
+    void fixedForwardWrench(unsigned int lSens);
+
+    /**
+    * Fixed-storage counterpart of computeTorques() for frames first...1.
+    */
+    void fixedTorques(int first);
+
 public:
 
   /**
@@ -959,7 +1013,22 @@ public:
     void setVerbose(unsigned int verb=iCub::skinDynLib::VERBOSE);
     void setMode(const NewEulMode _mode);
     void setInfo(const std::string _info);
-    
+
+    /**
+    * Select how ForwardKinematicFromBase(), BackwardWrenchFromEnd(), computeTorques(),
+    * ForwardWrenchToEnd() and BackwardWrenchToBase() are carried out: on fixed-size
+    * 3-vectors and 3x3 matrices with the link constants packed once (default), or
+    * through the per-link OneLinkNewtonEuler methods. Results are stored in the
+    * links in both cases and agree up to round-off.
+    * @param sw true for the fixed-size storage
+    */
+    void setFixedStorage(const bool sw);
+
+    /**
+    * @return true if the fixed-size storage is in use
+    */
+    bool getFixedStorage() const;
+
     /**
     * [classic] Initialize the base with measured or known kinematics variables
     * @param w0 angular velocity
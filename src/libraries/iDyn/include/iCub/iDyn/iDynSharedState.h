@@ -0,0 +1,235 @@
+/*
+ * Copyright (C) 2022 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+/**
+ * \defgroup iDynSharedState iDynSharedState
+ *
+ * @ingroup iDyn
+ *
+ * Kinematic state of the whole iCub shared among processes of the
+ * same machine.
+ *
+ * \section intro_sec Description
+ *
+ * One producer (typically wholeBodyDynamics) reads the encoders
+ * and the inertial sensor, estimates velocities and accelerations
+ * and computes the forward kinematics once per cycle; then it
+ * publishes the result as a timestamped iCubKinematicState in a
+ * small ring of slots living in shared memory. Any number of
+ * consumers (e.g. gravityCompensator) attach to the ring by name
+ * and access the latest snapshot in place, without copies and
+ * without going through the network.
+ *
+ * Each slot is guarded by a sequence number (seqlock): the
+ * producer never waits for the consumers, while a consumer can
+ * tell whether the snapshot it was using got overwritten in the
+ * meanwhile, which happens only if it holds it for longer than
+ * (ICUB_KINSTATE_SLOTS-1) producer cycles.
+ *
+ * \code
+ * // producer
+ * iCubKinematicStateWriter writer;
+ * writer.open("icub");
+ * iCubKinematicState &state=writer.prepare();
+ * // ... fill in state ...
+ * writer.write();
+ *
+ * // consumer
+ * iCubKinematicStateReader reader;
+ * reader.open("icub");
+ * unsigned long long seq;
+ * if (const iCubKinematicState *state=reader.read(seq))
+ * {
+ *     // ... use *state ...
+ *     if (!reader.check(seq))
+ *         ; // overwritten while in use: discard the results
+ * }
+ * \endcode
+ *
+ * \section tested_os_sec Tested OS
+ *
+ * Linux. The shared memory is available on POSIX systems only:
+ * elsewhere open() fails and the modules keep on reading the
+ * robot themselves.
+ **/
+
+#ifndef __IDYNSHAREDSTATE_H__
+#define __IDYNSHAREDSTATE_H__
+
+#include <string>
+
+#define ICUB_KINSTATE_UP_DOF        17
+#define ICUB_KINSTATE_LOW_DOF       15
+#define ICUB_KINSTATE_LIMBS         6
+#define ICUB_KINSTATE_SLOTS         4
+
+namespace iCub
+{
+
+namespace iDyn
+{
+
+/**
+* \ingroup iDynSharedState
+* Limbs whose end-effector pose is part of the snapshot.
+*/
+enum iCubKinematicLimb
+{
+    KINSTATE_HEAD=0,
+    KINSTATE_LEFT_ARM,
+    KINSTATE_RIGHT_ARM,
+    KINSTATE_TORSO,
+    KINSTATE_LEFT_LEG,
+    KINSTATE_RIGHT_LEG
+};
+
+/**
+* \ingroup iDynSharedState
+* One snapshot of the kinematic state of the robot. It is a plain
+* structure with no pointers so that it can be placed in shared
+* memory as it is.
+*/
+struct iCubKinematicState
+{
+    /// time stamp of the encoders [s]
+    double timestamp;
+
+    /// joints of the upper part: head(3), left_arm(7), right_arm(7) [deg, deg/s, deg/s^2]
+    double q_up[ICUB_KINSTATE_UP_DOF];
+    double dq_up[ICUB_KINSTATE_UP_DOF];
+    double d2q_up[ICUB_KINSTATE_UP_DOF];
+
+    /// joints of the lower part: torso(3) in the iDyn order (yaw first), left_leg(6), right_leg(6) [deg, deg/s, deg/s^2]
+    double q_low[ICUB_KINSTATE_LOW_DOF];
+    double dq_low[ICUB_KINSTATE_LOW_DOF];
+    double d2q_low[ICUB_KINSTATE_LOW_DOF];
+
+    /// inertial measure: angular velocity [rad/s], angular acceleration [rad/s^2], linear acceleration [m/s^2]
+    double w0[3];
+    double dw0[3];
+    double d2p0[3];
+
+    /// end-effector poses of the limbs (row-major 4x4), each w.r.t. the base of its chain, indexed by iCubKinematicLimb
+    double H[ICUB_KINSTATE_LIMBS][16];
+};
+
+
+/**
+* \ingroup iDynSharedState
+* Publishes iCubKinematicState snapshots in shared memory.
+* Only one writer per name is allowed.
+*/
+class iCubKinematicStateWriter
+{
+protected:
+    std::string shmName;
+    void *region;
+    unsigned long long next;
+
+public:
+    iCubKinematicStateWriter();
+
+    /**
+    * Creates (or takes over) the shared ring.
+    * @param name the name of the ring (e.g. the robot name).
+    * @return true/false on success/failure.
+    */
+    bool open(const std::string &name);
+
+    /**
+    * Returns the snapshot to be filled in, which is not visible to
+    * the readers until write() is called.
+    */
+    iCubKinematicState &prepare();
+
+    /**
+    * Makes the snapshot returned by prepare() the latest one.
+    */
+    void write();
+
+    /**
+    * Returns true if the ring is open.
+    */
+    bool isOpen() const { return (region!=NULL); }
+
+    /**
+    * Releases the ring and removes its name from the system.
+    */
+    void close();
+
+    ~iCubKinematicStateWriter();
+};
+
+
+/**
+* \ingroup iDynSharedState
+* Attaches to the ring of an iCubKinematicStateWriter and gives
+* access to the latest snapshot.
+*/
+class iCubKinematicStateReader
+{
+protected:
+    void *region;
+
+public:
+    iCubKinematicStateReader();
+
+    /**
+    * Attaches to the shared ring, which must have been already
+    * created by the writer.
+    * @param name the name of the ring.
+    * @return true/false on success/failure.
+    */
+    bool open(const std::string &name);
+
+    /**
+    * Gives access in place to the latest snapshot.
+    * @param seq returns the sequence number of the snapshot, which
+    *            increases by one at each write().
+    * @return the snapshot, NULL if nothing has been written yet.
+    * @note the snapshot stays valid for at least
+    *       (ICUB_KINSTATE_SLOTS-1) cycles of the writer: call
+    *       check() once done with it to verify it has not been
+    *       overwritten in the meanwhile.
+    */
+    const iCubKinematicState *read(unsigned long long &seq) const;
+
+    /**
+    * Copies the latest snapshot.
+    * @param state the destination.
+    * @param seq returns the sequence number of the snapshot.
+    * @return true if a consistent snapshot has been copied.
+    */
+    bool read(iCubKinematicState &state, unsigned long long &seq) const;
+
+    /**
+    * Returns true if the snapshot with the given sequence number
+    * is still intact.
+    */
+    bool check(const unsigned long long seq) const;
+
+    /**
+    * Returns true if attached to the ring.
+    */
+    bool isOpen() const { return (region!=NULL); }
+
+    /**
+    * Detaches from the ring.
+    */
+    void close();
+
+    ~iCubKinematicStateReader();
+};
+
+}
+
+}
+
+#endif
+
+
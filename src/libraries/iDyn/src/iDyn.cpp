@@ -18,6 +18,8 @@
 
 #include <cmath>
 #include <cstdio>
+#include <cstdint>
+#include <atomic>
 #include <iostream>
 #include <iomanip>
 
@@ -44,6 +46,19 @@ using namespace iCub::iDyn;
 //#define mra 1e-11
 //#define mla 1e-11
 //#define mhd 1.0
+
+namespace
+{
+    // the versions of the dynamic parameters of all the links come from one counter,
+    // so that a value is never issued twice, not even to links cloned from each other;
+    // 0 is never issued
+    std::atomic<std::uint64_t> paramsVersionCounter(0);
+
+    std::uint64_t nextParamsVersion()
+    {
+        return ++paramsVersionCounter;
+    }
+}
 //================================
 //
 //      I DYN HELPERS
@@ -197,6 +212,7 @@ void iDynLink::clone(const iDynLink &c)
     Mu = c.getMoment();
     Tau = c.getTorque();
     H_store_valid = false;
+    paramsVersion = nextParamsVersion();
 }
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 
@@ -230,6 +246,7 @@ bool iDynLink::setStaticParameters(const double _m,  const yarp::sig::Matrix &_H
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 bool iDynLink::setInertia(const yarp::sig::Matrix &_I)
 {
+    paramsVersion = nextParamsVersion();
     if( (_I.rows()==3)&&(_I.cols()==3) )
     {
         I = _I;
@@ -245,6 +262,7 @@ bool iDynLink::setInertia(const yarp::sig::Matrix &_I)
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 void iDynLink::setInertia(const double Ixx, const double Ixy, const double Ixz, const double Iyy, const double Iyz, const double Izz)
 {
+    paramsVersion = nextParamsVersion();
     I.resize(3,3); I.zero();
     I(0,0) = Ixx;
     I(0,1) = I(1,0) = Ixy;
@@ -256,6 +274,7 @@ void iDynLink::setInertia(const double Ixx, const double Ixy, const double Ixz,
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 void iDynLink::setMass(const double _m)
 {
+    paramsVersion = nextParamsVersion();
     m = _m;
 }
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
@@ -286,6 +305,7 @@ void iDynLink::setAngPosVelAcc(const double _teta,const double _dteta,const doub
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 bool iDynLink::setCOM(const yarp::sig::Matrix &_HC)
 {
+    paramsVersion = nextParamsVersion();
     if((_HC.rows()==4) && (_HC.cols()==4))
     {
         HC = _HC;
@@ -307,6 +327,7 @@ bool iDynLink::setCOM(const yarp::sig::Matrix &_HC)
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 bool iDynLink::setCOM(const yarp::sig::Vector &_rC)
 {
+    paramsVersion = nextParamsVersion();
     if(_rC.length()==3)
     {
         HC = eye(4,4);
@@ -328,6 +349,7 @@ bool iDynLink::setCOM(const yarp::sig::Vector &_rC)
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 void iDynLink::setCOM(const double _rCx, const double _rCy, const double _rCz)
 {
+    paramsVersion = nextParamsVersion();
     HC = eye(4,4);
     HC(0,3) = _rCx;
     HC(1,3) = _rCy;
@@ -396,6 +418,7 @@ void iDynLink::zero()
     HC = eye(4,4); RC = eye(3,3); rc = zeros(3);
     H_store = eye(4,4); R_store = eye(3,3); r_store = zeros(3);
     H_store_valid = false;
+    paramsVersion = nextParamsVersion();
 }
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 
@@ -477,6 +500,7 @@ iDynChain::iDynChain()
 : iKinChain()
 {
     NE=NULL;
+    fixedStorageNE=true;
     setIterMode(KINFWD_WREBWD);
 }
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
@@ -488,6 +512,7 @@ void iDynChain::clone(const iDynChain &c)
     iterateMode_kinematics = c.iterateMode_kinematics;
     iterateMode_wrench = c.iterateMode_wrench;
     NE = c.NE;
+    fixedStorageNE = c.fixedStorageNE;
 }
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 void iDynChain::build()
@@ -924,6 +949,7 @@ void iDynChain::prepareNewtonEuler(const NewEulMode NewEulMode_s)
     if( NE != NULL)
         delete NE;
     NE = new OneChainNewtonEuler(const_cast<iDynChain *>(this),info,NewEulMode_s,verbose);
+    NE->setFixedStorage(fixedStorageNE);
 }
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 bool iDynChain::computeNewtonEuler(const Vector &w0, const Vector &dw0, const Vector &ddp0, const Vector &F0, const Vector &Mu0 )
@@ -1216,6 +1242,18 @@ void iDynChain::setModeNewtonEuler(const NewEulMode mode)
     NE->setMode(mode);
     if(verbose) yInfo("iDynChain: Newton-Euler mode set to %s \n",NewEulMode_s[mode].c_str());
 }
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+void iDynChain::setFixedStorageNewtonEuler(const bool sw)
+{
+    fixedStorageNE = sw;
+    if( NE != NULL)
+        NE->setFixedStorage(sw);
+}
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+bool iDynChain::getFixedStorageNewtonEuler() const
+{
+    return fixedStorageNE;
+}
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 
             //~~~~~~~~~~~~~~
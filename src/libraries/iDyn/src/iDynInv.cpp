@@ -26,6 +26,8 @@
 #include <deque>
 #include <string>
 #include <sstream>  // for debug
+#include <limits>
+#include <cmath>
 
 using namespace std;
 using namespace yarp::sig;
@@ -1708,6 +1710,14 @@ OneChainNewtonEuler::OneChainNewtonEuler(iDynChain *_c, string _info, const NewE
     //the end effector is the last (nLinks+2-1 because it's an index)
     nEndEff = nLinks+1;
 
+    //the packed constants, filled once here and then only when a link changes
+    fixedStorage = true;
+    fixedLinks.resize(nLinks);
+    for(unsigned int i=0; i<nLinks; i++)
+    {
+        fixedLinks[i].version = 0;
+        updateFixedLink(i);
+    }
 }
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 OneChainNewtonEuler::~OneChainNewtonEuler()
@@ -1815,6 +1825,16 @@ void OneChainNewtonEuler::setInfo(const string _info)
     info=_info;
 }
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+void OneChainNewtonEuler::setFixedStorage(const bool sw)
+{
+    fixedStorage=sw;
+}
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+bool OneChainNewtonEuler::getFixedStorage() const
+{
+    return fixedStorage;
+}
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 bool OneChainNewtonEuler::initKinematicBase(const Vector &w0,const Vector &dw0,const Vector &ddp0)
 {
     return neChain[0]->setAsBase(w0,dw0,ddp0);
@@ -1843,6 +1863,298 @@ bool OneChainNewtonEuler::initWrenchBase(const Vector &Fend,const Vector &Muend)
 string      OneChainNewtonEuler::getInfo()      const       {return info;}
 NewEulMode  OneChainNewtonEuler::getMode()      const       {return mode;}
 
+    //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+    //   fixed-size storage
+    //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+namespace
+{
+    // y = R*x, R row-major
+    inline void rot(const double *R, const double *x, double *y)
+    {
+        y[0]=R[0]*x[0]+R[1]*x[1]+R[2]*x[2];
+        y[1]=R[3]*x[0]+R[4]*x[1]+R[5]*x[2];
+        y[2]=R[6]*x[0]+R[7]*x[1]+R[8]*x[2];
+    }
+
+    // y = R'*x, R row-major
+    inline void rotT(const double *R, const double *x, double *y)
+    {
+        y[0]=R[0]*x[0]+R[3]*x[1]+R[6]*x[2];
+        y[1]=R[1]*x[0]+R[4]*x[1]+R[7]*x[2];
+        y[2]=R[2]*x[0]+R[5]*x[1]+R[8]*x[2];
+    }
+
+    // z = a x b
+    inline void cross3(const double *a, const double *b, double *z)
+    {
+        z[0]=a[1]*b[2]-a[2]*b[1];
+        z[1]=a[2]*b[0]-a[0]*b[2];
+        z[2]=a[0]*b[1]-a[1]*b[0];
+    }
+
+    // y += dw x r + w x (w x r)
+    inline void addCentripetal(const double *w, const double *dw, const double *r, double *y)
+    {
+        double a[3],b[3];
+        cross3(dw,r,a);
+        cross3(w,r,b);
+        y[0]+=a[0]; y[1]+=a[1]; y[2]+=a[2];
+        cross3(w,b,a);
+        y[0]+=a[0]; y[1]+=a[1]; y[2]+=a[2];
+    }
+
+    // y = I*dw + w x (I*w)
+    inline void eulerTerm(const double *I, const double *w, const double *dw, double *y)
+    {
+        double Iw[3],a[3];
+        rot(I,dw,y);
+        rot(I,w,Iw);
+        cross3(w,Iw,a);
+        y[0]+=a[0]; y[1]+=a[1]; y[2]+=a[2];
+    }
+}
+
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+const OneChainNewtonEuler::FixedLink& OneChainNewtonEuler::updateFixedLink(unsigned int l)
+{
+    iDynLink *link = chain->refLink(l);
+    FixedLink &fl = fixedLinks[l];
+
+    if(fl.version != link->paramsVersion)
+    {
+        fl.m = link->m;
+        for(int j=0; j<3; j++)
+            fl.rc[j] = link->rc[j];
+        for(int r=0; r<3; r++)
+            for(int c=0; c<3; c++)
+                fl.I[3*r+c] = link->I(r,c);
+        fl.kr = link->kr;
+        fl.Im = link->Im;
+        fl.Fv = link->Fv;
+        fl.Fs = link->Fs;
+        fl.theta = std::numeric_limits<double>::quiet_NaN();
+        fl.version = link->paramsVersion;
+    }
+
+    //cos and sin only when the joint moves
+    double theta = link->Ang + link->Offset;
+    if(theta != fl.theta)
+    {
+        fl.theta = theta;
+        fl.c_theta = cos(theta);
+        fl.s_theta = sin(theta);
+    }
+
+    //same rotation as iKinLink::getH(), while the projection r*R of the
+    //distance reduces to constants of the DH parameters
+    const double ca = link->c_alpha;
+    const double sa = link->s_alpha;
+    fl.R[0] = fl.c_theta;   fl.R[1] = -fl.s_theta*ca;   fl.R[2] = fl.s_theta*sa;
+    fl.R[3] = fl.s_theta;   fl.R[4] = fl.c_theta*ca;    fl.R[5] = -fl.c_theta*sa;
+    fl.R[6] = 0.0;          fl.R[7] = sa;               fl.R[8] = ca;
+    fl.r[0] = link->A;
+    fl.r[1] = link->D*sa;
+    fl.r[2] = link->D*ca;
+
+    return fl;
+}
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+void OneChainNewtonEuler::fixedForwardKinematics()
+{
+    const double *wp = neChain[0]->getAngVel().data();
+    const double *dwp = neChain[0]->getAngAcc().data();
+    const double *ddpp = neChain[0]->getLinAcc().data();
+
+    for(unsigned int l=0; l<nLinks; l++)
+    {
+        iDynLink *link = chain->refLink(l);
+        const FixedLink &fl = updateFixedLink(l);
+        double *w = link->w.data();
+        double *dw = link->dw.data();
+        double *ddp = link->ddp.data();
+        double *ddpC = link->ddpC.data();
+
+        switch(mode)
+        {
+        case DYNAMIC:
+        case DYNAMIC_CORIOLIS_GRAVITY:
+        case DYNAMIC_W_ROTOR:
+            {
+                const double dq = link->dq;
+                double a[3];
+                a[0] = wp[0]; a[1] = wp[1]; a[2] = wp[2] + dq;
+                rotT(fl.R,a,w);
+
+                a[0] = dwp[0] + dq*wp[1];
+                a[1] = dwp[1] - dq*wp[0];
+                a[2] = (mode == DYNAMIC_CORIOLIS_GRAVITY) ? dwp[2] : dwp[2] + link->ddq;
+                rotT(fl.R,a,dw);
+
+                rotT(fl.R,ddpp,ddp);
+                addCentripetal(w,dw,fl.r,ddp);
+
+                ddpC[0] = ddp[0]; ddpC[1] = ddp[1]; ddpC[2] = ddp[2];
+                addCentripetal(w,dw,fl.rc,ddpC);
+                break;
+            }
+        case STATIC:
+            w[0] = w[1] = w[2] = 0.0;
+            dw[0] = dw[1] = dw[2] = 0.0;
+            rotT(fl.R,ddpp,ddp);
+            ddpC[0] = ddp[0]; ddpC[1] = ddp[1]; ddpC[2] = ddp[2];
+            break;
+        }
+
+        wp = w; dwp = dw; ddpp = ddp;
+    }
+}
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+void OneChainNewtonEuler::fixedBackwardWrench(int first, int lastTorque)
+{
+    for(int i=first; i>=0; i--)
+    {
+        double F[3], Mu[3];
+        unsigned int next = i+1;
+        if(next == nEndEff)
+        {
+            //the final frame has no mass and the identity as rotation
+            const double *Fe = neChain[nEndEff]->getForce().data();
+            const double *Mue = neChain[nEndEff]->getMoment(false).data();
+            F[0] = Fe[0];   F[1] = Fe[1];   F[2] = Fe[2];
+            Mu[0] = Mue[0]; Mu[1] = Mue[1]; Mu[2] = Mue[2];
+        }
+        else
+        {
+            iDynLink *ln = chain->refLink(next-1);
+            const FixedLink &fn = updateFixedLink(next-1);
+            const double *Fn = ln->F.data();
+            const double *ddpC = ln->ddpC.data();
+
+            double mddpC[3], a[3], b[3], rrc[3];
+            mddpC[0] = fn.m*ddpC[0]; mddpC[1] = fn.m*ddpC[1]; mddpC[2] = fn.m*ddpC[2];
+            a[0] = mddpC[0]+Fn[0];   a[1] = mddpC[1]+Fn[1];   a[2] = mddpC[2]+Fn[2];
+            rot(fn.R,a,F);
+
+            rrc[0] = fn.r[0]+fn.rc[0]; rrc[1] = fn.r[1]+fn.rc[1]; rrc[2] = fn.r[2]+fn.rc[2];
+            cross3(fn.r,Fn,a);
+            cross3(rrc,mddpC,b);
+            a[0] += b[0]+ln->Mu[0]; a[1] += b[1]+ln->Mu[1]; a[2] += b[2]+ln->Mu[2];
+            if(mode != STATIC)
+            {
+                eulerTerm(fn.I,ln->w.data(),ln->dw.data(),b);
+                a[0] += b[0]; a[1] += b[1]; a[2] += b[2];
+            }
+            rot(fn.R,a,Mu);
+
+            if(mode == DYNAMIC_W_ROTOR)
+            {
+                const double *zm = neChain[next]->zm.data();
+                const double ka = fn.kr*ln->ddq*fn.Im;
+                const double kv = fn.kr*ln->dq*fn.Im;
+                cross3(ln->w.data(),zm,b);
+                for(int j=0; j<3; j++)
+                    Mu[j] += ka*zm[j] + kv*b[j];
+            }
+        }
+
+        if(i == 0)
+        {
+            //the base stores the wrench both in its own frame and rotated by H0
+            BaseLinkNewtonEuler *base = static_cast<BaseLinkNewtonEuler*>(neChain[0]);
+            if(base->Mu0.length() != 3)
+                base->Mu0.resize(3);
+            const Matrix &H0 = base->H0;
+            for(int j=0; j<3; j++)
+            {
+                base->F[j] = H0(j,0)*F[0] + H0(j,1)*F[1] + H0(j,2)*F[2];
+                base->Mu[j] = H0(j,0)*Mu[0] + H0(j,1)*Mu[1] + H0(j,2)*Mu[2];
+                base->Mu0[j] = Mu[j];
+            }
+        }
+        else
+        {
+            iDynLink *link = chain->refLink(i-1);
+            for(int j=0; j<3; j++)
+            {
+                link->F[j] = F[j];
+                link->Mu[j] = Mu[j];
+            }
+        }
+    }
+
+    fixedTorques(lastTorque);
+}
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+void OneChainNewtonEuler::fixedForwardWrench(unsigned int lSens)
+{
+    for(unsigned int i=lSens+2; i<nEndEff; i++)
+    {
+        iDynLink *link = chain->refLink(i-1);
+        iDynLink *prev = chain->refLink(i-2);
+        const FixedLink &fl = updateFixedLink(i-1);
+        const double *w = link->w.data();
+        const double *ddpC = link->ddpC.data();
+        double *F = link->F.data();
+        double *Mu = link->Mu.data();
+
+        double mddpC[3], a[3], b[3], rrc[3];
+        mddpC[0] = fl.m*ddpC[0]; mddpC[1] = fl.m*ddpC[1]; mddpC[2] = fl.m*ddpC[2];
+        rotT(fl.R,prev->F.data(),F);
+        F[0] -= mddpC[0]; F[1] -= mddpC[1]; F[2] -= mddpC[2];
+
+        a[0] = prev->Mu[0]; a[1] = prev->Mu[1]; a[2] = prev->Mu[2];
+        if(mode == DYNAMIC_W_ROTOR)
+        {
+            const double *zm = neChain[i]->zm.data();
+            const double ka = fl.kr*link->ddq*fl.Im;
+            const double kv = fl.kr*link->dq*fl.Im;
+            cross3(w,zm,b);
+            for(int j=0; j<3; j++)
+                a[j] -= ka*zm[j] + kv*b[j];
+        }
+        rotT(fl.R,a,Mu);
+
+        rrc[0] = fl.r[0]+fl.rc[0]; rrc[1] = fl.r[1]+fl.rc[1]; rrc[2] = fl.r[2]+fl.rc[2];
+        cross3(fl.r,F,a);
+        cross3(rrc,mddpC,b);
+        Mu[0] -= a[0]+b[0]; Mu[1] -= a[1]+b[1]; Mu[2] -= a[2]+b[2];
+        if(mode != STATIC)
+        {
+            eulerTerm(fl.I,w,link->dw.data(),b);
+            Mu[0] -= b[0]; Mu[1] -= b[1]; Mu[2] -= b[2];
+        }
+
+        link->Tau = prev->Mu[2];
+        if(mode == DYNAMIC_W_ROTOR)
+        {
+            const double *zm = neChain[i]->zm.data();
+            const double *dwM = link->dwM.data();
+            link->Tau += fl.kr*fl.Im*(dwM[0]*zm[0]+dwM[1]*zm[1]+dwM[2]*zm[2])
+                         + fl.Fv*link->dq + fl.Fs*sign(link->dq);
+        }
+    }
+}
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+void OneChainNewtonEuler::fixedTorques(int first)
+{
+    for(int i=first; i>0; i--)
+    {
+        iDynLink *link = chain->refLink(i-1);
+        //the base gives the moment in its own frame
+        double tau = (i == 1) ? neChain[0]->getMoment(true)[2] : chain->refLink(i-2)->Mu[2];
+        if(mode == DYNAMIC_W_ROTOR)
+        {
+            const FixedLink &fl = fixedLinks[i-1];
+            const double *zm = neChain[i]->zm.data();
+            const double *dwM = link->dwM.data();
+            tau += fl.kr*fl.Im*(dwM[0]*zm[0]+dwM[1]*zm[1]+dwM[2]*zm[2])
+                   + fl.Fv*link->dq + fl.Fs*sign(link->dq);
+        }
+        link->Tau = tau;
+    }
+}
+
     //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
     //   main computation methods
     //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
@@ -1850,6 +2162,12 @@ NewEulMode  OneChainNewtonEuler::getMode()      const       {return mode;}
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 void OneChainNewtonEuler::ForwardKinematicFromBase()
 {
+    if(fixedStorage)
+    {
+        fixedForwardKinematics();
+        return;
+    }
+
     for(unsigned int i=1;i<nEndEff;i++)
     {
         neChain[i]->ForwardKinematics(neChain[i-1]);
@@ -1882,6 +2200,12 @@ void OneChainNewtonEuler::BackwardKinematicFromEnd(const Vector &_w, const Vecto
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 void OneChainNewtonEuler::BackwardWrenchFromEnd()
 {    
+    if(fixedStorage)
+    {
+        fixedBackwardWrench(nEndEff-1,nEndEff-1);
+        return;
+    }
+
     for(int i=nEndEff-1; i>=0; i--)
         neChain[i]->BackwardWrench(neChain[i+1]);
 
@@ -1891,6 +2215,12 @@ void OneChainNewtonEuler::BackwardWrenchFromEnd()
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 void OneChainNewtonEuler::computeTorques()
 {
+    if(fixedStorage)
+    {
+        fixedTorques(nEndEff-1);
+        return;
+    }
+
     for(int i=nEndEff-1; i>0; i--){
         neChain[i]->computeTorque(neChain[i-1]);
     }
@@ -1933,8 +2263,11 @@ bool OneChainNewtonEuler::ForwardWrenchToEnd(unsigned int lSens)
         // indexed lSens+2 = lSens + baseLink + the next one
         // that's because link lSens = neChain[lSens+1] is already set before
         // with a specific sensor method
-        for(unsigned int i=lSens+2; i<nEndEff; i++)
-            neChain[i]->ForwardWrench(neChain[i-1]);
+        if(fixedStorage)
+            fixedForwardWrench(lSens);
+        else
+            for(unsigned int i=lSens+2; i<nEndEff; i++)
+                neChain[i]->ForwardWrench(neChain[i-1]);
         return true;
     }
     else
@@ -1954,6 +2287,11 @@ bool OneChainNewtonEuler::BackwardWrenchToBase(unsigned int lSens)
         // indexed lSens = lSens + baseLink - the previous one
         // that's because link lSens = neChain[lSens+1] is already set before
         // with a specific sensor method
+        if(fixedStorage)
+        {
+            fixedBackwardWrench(lSens,lSens+1);
+            return true;
+        }
         for(int i=lSens; i>=0; i--){
             neChain[i]->BackwardWrench(neChain[i+1]);
         }
@@ -0,0 +1,265 @@
+/*
+ * Copyright (C) 2022 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <cstring>
+#include <atomic>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
+
+#include <yarp/os/Log.h>
+#include <iCub/iDyn/iDynSharedState.h>
+
+#define KINSTATE_MAGIC      0x694b5354  // "iKST"
+#define KINSTATE_VERSION    1
+
+using namespace std;
+using namespace iCub::iDyn;
+
+namespace
+{
+    // a slot is valid when its seq matches the seq it is read for;
+    // the writer zeroes it while filling the slot in
+    struct KinStateSlot
+    {
+        atomic<unsigned long long> seq;
+        iCubKinematicState state;
+    };
+
+    struct KinStateRegion
+    {
+        atomic<unsigned int> magic;
+        unsigned int version;
+        atomic<unsigned long long> latest;
+        KinStateSlot slot[ICUB_KINSTATE_SLOTS];
+    };
+
+    string shmName(const string &name)
+    {
+        string str="/icub_kinstate_"+name;
+        for (size_t i=1; i<str.length(); i++)
+            if (str[i]=='/')
+                str[i]='_';
+
+        return str;
+    }
+
+    void *shmMap(const string &name, const bool create)
+    {
+    #ifndef _WIN32
+        int fd=shm_open(name.c_str(),create?(O_CREAT|O_RDWR):O_RDONLY,0666);
+        if (fd<0)
+            return NULL;
+
+        if (create && (ftruncate(fd,sizeof(KinStateRegion))!=0))
+        {
+            ::close(fd);
+            return NULL;
+        }
+
+        void *addr=mmap(NULL,sizeof(KinStateRegion),create?(PROT_READ|PROT_WRITE):PROT_READ,
+                        MAP_SHARED,fd,0);
+        ::close(fd);
+        return (addr!=MAP_FAILED)?addr:NULL;
+    #else
+        return NULL;
+    #endif
+    }
+
+    void shmUnmap(void *addr)
+    {
+    #ifndef _WIN32
+        munmap(addr,sizeof(KinStateRegion));
+    #endif
+    }
+}
+
+
+/************************************************************************/
+iCubKinematicStateWriter::iCubKinematicStateWriter() : region(NULL), next(0)
+{
+}
+
+
+/************************************************************************/
+bool iCubKinematicStateWriter::open(const string &name)
+{
+    close();
+
+    shmName=::shmName(name);
+    region=shmMap(shmName,true);
+    if (region==NULL)
+    {
+        yError("iCubKinematicStateWriter: unable to create the shared state %s",shmName.c_str());
+        return false;
+    }
+
+    // readers still attached to a previous instance see
+    // the ring empty until the first write()
+    KinStateRegion *r=static_cast<KinStateRegion*>(region);
+    r->magic.store(0,memory_order_relaxed);
+    r->version=KINSTATE_VERSION;
+    r->latest.store(0,memory_order_relaxed);
+    for (int i=0; i<ICUB_KINSTATE_SLOTS; i++)
+        r->slot[i].seq.store(0,memory_order_relaxed);
+    r->magic.store(KINSTATE_MAGIC,memory_order_release);
+
+    next=0;
+    return true;
+}
+
+
+/************************************************************************/
+iCubKinematicState &iCubKinematicStateWriter::prepare()
+{
+    KinStateRegion *r=static_cast<KinStateRegion*>(region);
+    KinStateSlot &slot=r->slot[(next+1)%ICUB_KINSTATE_SLOTS];
+
+    // invalidate the slot before touching its content
+    slot.seq.store(0,memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    return slot.state;
+}
+
+
+/************************************************************************/
+void iCubKinematicStateWriter::write()
+{
+    KinStateRegion *r=static_cast<KinStateRegion*>(region);
+    next++;
+    r->slot[next%ICUB_KINSTATE_SLOTS].seq.store(next,memory_order_release);
+    r->latest.store(next,memory_order_release);
+}
+
+
+/************************************************************************/
+void iCubKinematicStateWriter::close()
+{
+    if (region!=NULL)
+    {
+        shmUnmap(region);
+    #ifndef _WIN32
+        shm_unlink(shmName.c_str());
+    #endif
+        region=NULL;
+    }
+}
+
+
+/************************************************************************/
+iCubKinematicStateWriter::~iCubKinematicStateWriter()
+{
+    close();
+}
+
+
+/************************************************************************/
+iCubKinematicStateReader::iCubKinematicStateReader() : region(NULL)
+{
+}
+
+
+/************************************************************************/
+bool iCubKinematicStateReader::open(const string &name)
+{
+    close();
+
+    region=shmMap(shmName(name),false);
+    if (region==NULL)
+        return false;
+
+    const KinStateRegion *r=static_cast<const KinStateRegion*>(region);
+    if ((r->magic.load(memory_order_acquire)!=KINSTATE_MAGIC) || (r->version!=KINSTATE_VERSION))
+    {
+        close();
+        return false;
+    }
+
+    return true;
+}
+
+
+/************************************************************************/
+const iCubKinematicState *iCubKinematicStateReader::read(unsigned long long &seq) const
+{
+    const KinStateRegion *r=static_cast<const KinStateRegion*>(region);
+    if (r==NULL)
+        return NULL;
+
+    // the latest slot may be already under rewrite
+    // only if we are overtaken by the writer
+    for (int attempt=0; attempt<ICUB_KINSTATE_SLOTS; attempt++)
+    {
+        unsigned long long s=r->latest.load(memory_order_acquire);
+        if (s==0)
+            return NULL;
+
+        const KinStateSlot &slot=r->slot[s%ICUB_KINSTATE_SLOTS];
+        if (slot.seq.load(memory_order_acquire)==s)
+        {
+            seq=s;
+            return &slot.state;
+        }
+    }
+
+    return NULL;
+}
+
+
+/************************************************************************/
+bool iCubKinematicStateReader::read(iCubKinematicState &state, unsigned long long &seq) const
+{
+    for (int attempt=0; attempt<ICUB_KINSTATE_SLOTS; attempt++)
+    {
+        const iCubKinematicState *latest=read(seq);
+        if (latest==NULL)
+            return false;
+
+        memcpy(&state,latest,sizeof(iCubKinematicState));
+        if (check(seq))
+            return true;
+    }
+
+    return false;
+}
+
+
+/************************************************************************/
+bool iCubKinematicStateReader::check(const unsigned long long seq) const
+{
+    const KinStateRegion *r=static_cast<const KinStateRegion*>(region);
+    if (r==NULL)
+        return false;
+
+    // the content of the slot must be read before its seq
+    atomic_thread_fence(memory_order_acquire);
+    return (r->slot[seq%ICUB_KINSTATE_SLOTS].seq.load(memory_order_relaxed)==seq);
+}
+
+
+/************************************************************************/
+void iCubKinematicStateReader::close()
+{
+    if (region!=NULL)
+    {
+        shmUnmap(region);
+        region=NULL;
+    }
+}
+
+
+/************************************************************************/
+iCubKinematicStateReader::~iCubKinematicStateReader()
+{
+    close();
+}
+
+
@@ -0,0 +1,142 @@
+/*
+ * Copyright (C) 2022 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+// Time per iteration spent by the Levenberg-Marquardt controller to invert the
+// Jacobian of the 7-DOF and 10-DOF (torso included) iCub arm, when the plain
+// and the damped pseudo-inverses are computed through the SVD as formerly done
+// and when they come from DLSSolver, together with the largest deviation
+// between the two, the time of a complete LMCtrl iteration and the number of
+// iterations it takes to reach the target. The arm moves along a slow random
+// walk, as it happens within the control loop.
+//
+// dlsSolverBenchmark [--iterations 20000] [--step 0.01]
+
+#include <cstdio>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+
+#include <yarp/os/all.h>
+#include <yarp/sig/all.h>
+#include <yarp/math/Math.h>
+#include <yarp/math/SVD.h>
+#include <yarp/math/Rand.h>
+
+#include <iCub/iKin/iKinFwd.h>
+#include <iCub/iKin/iKinInv.h>
+
+using namespace std;
+using namespace yarp::os;
+using namespace yarp::sig;
+using namespace yarp::math;
+using namespace iCub::iKin;
+
+
+/***************************************************************************/
+Vector randomPose(iKinChain &chain)
+{
+    Vector q(chain.getDOF());
+    for (unsigned int i=0; i<chain.getDOF(); i++)
+        q[i]=Rand::scalar(0.1,0.9)*(chain(i).getMax()-chain(i).getMin())+chain(i).getMin();
+    return q;
+}
+
+
+/***************************************************************************/
+void run(iKinChain &chain, const int iterations, const double step)
+{
+    const double mu=1e-2;
+    unsigned int dof=chain.getDOF();
+    Vector q=randomPose(chain);
+
+    vector<Matrix> J(iterations);
+    for (int k=0; k<iterations; k++)
+    {
+        q+=Rand::vector(Vector(dof,-step),Vector(dof,step));
+        J[k]=chain.GeoJacobian(q);
+    }
+
+    Matrix pinvJ_svd,pinvLM_svd;
+    double t0=Time::now();
+    for (int k=0; k<iterations; k++)
+    {
+        Matrix Jt=J[k].transposed();
+        Matrix LM=J[k]*Jt;
+        for (int i=0; i<6; i++)
+            LM(i,i)+=mu*LM(i,i);
+        pinvLM_svd=Jt*pinv(LM);
+        pinvJ_svd=pinv(Jt).transposed();
+    }
+    double tSVD=Time::now()-t0;
+
+    DLSSolver dls;
+    Matrix pinvJ_dls,pinvLM_dls;
+    t0=Time::now();
+    for (int k=0; k<iterations; k++)
+    {
+        dls.setJacobian(J[k]);
+        dls.factorize();
+        pinvJ_dls=dls.getPinv();
+        dls.factorize(mu,true);
+        pinvLM_dls=dls.getPinv();
+    }
+    double tDLS=Time::now()-t0;
+
+    double dev=0.0;
+    for (size_t r=0; r<pinvJ_dls.rows(); r++)
+    {
+        for (size_t c=0; c<pinvJ_dls.cols(); c++)
+        {
+            dev=std::max(dev,fabs(pinvJ_dls(r,c)-pinvJ_svd(r,c)));
+            dev=std::max(dev,fabs(pinvLM_dls(r,c)-pinvLM_svd(r,c)));
+        }
+    }
+
+    // a complete controller reaching a random target
+    Vector xd=chain.EndEffPose(randomPose(chain));
+    Vector q0=randomPose(chain);
+    chain.setAng(q0);
+    LMCtrl ctrl(chain,IKINCTRL_POSE_FULL,1.0,mu,2.0,0.5,1e-6,1.0);
+    ctrl.restart(q0);
+    t0=Time::now();
+    int n=0;
+    while ((n<1000) && (ctrl.get_state()!=IKINCTRL_STATE_INTARGET))
+    {
+        ctrl.iterate(xd);
+        n++;
+    }
+    double tCtrl=Time::now()-t0;
+
+    printf("%3u | %13.3f | %13.3f | %8.2f | %13.2e | %16.3f | %10d\n",dof,
+           1e6*tSVD/iterations,1e6*tDLS/iterations,tSVD/tDLS,dev,
+           1e6*tCtrl/std::max(n,1),n);
+}
+
+
+/***************************************************************************/
+int main(int argc, char *argv[])
+{
+    Property options;
+    options.fromCommand(argc,argv);
+
+    int iterations=options.check("iterations",Value(20000)).asInt32();
+    double step=options.check("step",Value(0.01)).asFloat64();
+    Rand::init(1);
+
+    printf("dof | SVD [us/iter] | DLS [us/iter] | speed-up | max deviation | LMCtrl [us/iter] | iterations\n");
+
+    iCubArm arm7("right");
+    run(*arm7.asChain(),iterations,step);
+
+    iCubArm arm10("right");
+    for (unsigned int i=0; i<3; i++)
+        arm10.releaseLink(i);
+    run(*arm10.asChain(),iterations,step);
+
+    return 0;
+}
@@ -56,6 +56,135 @@ namespace iCub
 namespace iKin
 {
 
+/**
+* \ingroup iKinInv
+*
+* Damped least-squares inverse of a m x n Jacobian J:
+*
+* pinv=W*Jt*inv(J*W*Jt+D)
+*
+* with W=diag(w) optional joints weights and the damping
+* D=lambda*I or D=lambda*diag(J*W*Jt) (Marquardt scaling).
+* Without weights and damping and with m>n the n x n matrix
+* Jt*J is factorized instead.
+*
+* The symmetric positive definite matrix is factorized through
+* Cholesky into storage that is reused from one call to the
+* next, while the SVD is resorted to only when the matrix is
+* close to singular (condition number beyond 1e10), thus the
+* pseudo-inverse, the solution and the null space projection
+* all come from a single factorization. The smallest singular
+* value of J is obtained by inverse iteration warm-started from
+* the singular vector of the previous Jacobian, which is
+* normally a few steps away when the configuration moves little
+* between two calls.
+*/
+class DLSSolver
+{
+protected:
+    yarp::sig::Matrix J;
+    yarp::sig::Vector w;
+    yarp::sig::Matrix G;
+    yarp::sig::Matrix L;
+    yarp::sig::Matrix pinvG;
+    yarp::sig::Vector v;
+
+    bool weighted;
+    bool colForm;
+    bool gramValid;
+    bool cholesky;
+    bool factorized;
+    double svMin;
+
+    void   computeGram();
+    bool   choleskyFactor(const double lambda, const bool scaled);
+    void   svdFactor(const double lambda, const bool scaled);
+    void   applyInverse(yarp::sig::Vector &y) const;
+    double inverseIteration();
+
+public:
+    /**
+    * Default Constructor.
+    */
+    DLSSolver();
+
+    /**
+    * Sets a new Jacobian, without joints weights.
+    * @param _J is the m x n Jacobian.
+    * @return true/false on success/failure.
+    * @note factorize() shall be called afterwards.
+    */
+    bool setJacobian(const yarp::sig::Matrix &_J);
+
+    /**
+    * Sets a new Jacobian along with the joints weights.
+    * @param _J is the m x n Jacobian.
+    * @param _w is the n-dimensional vector of nonnegative weights,
+    *           i.e. the diagonal of W.
+    * @return true/false on success/failure.
+    * @note factorize() shall be called afterwards.
+    */
+    bool setJacobian(const yarp::sig::Matrix &_J, const yarp::sig::Vector &_w);
+
+    /**
+    * Factorizes the matrix to be inverted with the given damping.
+    * Can be called several times on the same Jacobian with
+    * different damping, without recomputing J*W*Jt.
+    * @param lambda is the damping factor.
+    * @param scaled if true the damping is lambda*diag(J*W*Jt),
+    *               otherwise lambda*I.
+    * @return true if the Cholesky factorization succeeded, false
+    *         if the matrix is close to singular and the SVD has
+    *         been used instead. The solver is usable in both
+    *         cases.
+    * @note The smallest singular value is refreshed only without
+    *       weights and damping.
+    */
+    bool factorize(const double lambda=0.0, const bool scaled=false);
+
+    /**
+    * Returns the (damped) pseudo-inverse.
+    * @return the n x m pseudo-inverse.
+    */
+    yarp::sig::Matrix getPinv() const;
+
+    /**
+    * Returns the least-squares solution pinv*e without forming the
+    * pseudo-inverse.
+    * @param e is the m-dimensional task vector.
+    * @return the n-dimensional solution.
+    */
+    yarp::sig::Vector solve(const yarp::sig::Vector &e) const;
+
+    /**
+    * Returns the projection (I-pinv*J)*z of z onto the null space
+    * of the task, without forming the projector.
+    * @param z is the n-dimensional vector to be projected.
+    * @return the projected vector.
+    */
+    yarp::sig::Vector projectNullSpace(const yarp::sig::Vector &z) const;
+
+    /**
+    * Returns the null space projector I-pinv*J.
+    * @return the n x n projector.
+    */
+    yarp::sig::Matrix getNullSpaceProjector() const;
+
+    /**
+    * Returns the smallest singular value of J as of the last
+    * factorization without weights and damping.
+    * @return the smallest singular value.
+    */
+    double getMinSingularValue() const { return svMin; }
+
+    /**
+    * Returns the Jacobian currently in use.
+    * @return the Jacobian.
+    */
+    const yarp::sig::Matrix &getJacobian() const { return J; }
+};
+
+
 /**
 * \ingroup iKinInv
 *
@@ -83,6 +212,7 @@ protected:
     yarp::sig::Matrix Jt;
     yarp::sig::Matrix pinvJ;
     yarp::sig::Vector grad;
+    DLSSolver dls;
 
     yarp::sig::Vector q_old;
 
@@ -22,6 +22,10 @@
 #define IKINCTRL_WATCHDOG_TOL       1e-4
 #define IKINCTRL_WATCHDOG_MAXITER   200
 
+#define DLSSOLVER_PIVOT_TOL         1e-10
+#define DLSSOLVER_SV_TOL            1e-12
+#define DLSSOLVER_SV_MAXITER        100
+
 using namespace std;
 using namespace yarp::os;
 using namespace yarp::sig;
@@ -30,6 +34,376 @@ using namespace iCub::ctrl;
 using namespace iCub::iKin;
 
 
+/************************************************************************/
+DLSSolver::DLSSolver()
+{
+    weighted=false;
+    colForm=false;
+    gramValid=false;
+    cholesky=false;
+    factorized=false;
+    svMin=0.0;
+}
+
+
+/************************************************************************/
+bool DLSSolver::setJacobian(const Matrix &_J)
+{
+    J=_J;
+    weighted=false;
+    gramValid=factorized=false;
+
+    return ((J.rows()>0) && (J.cols()>0));
+}
+
+
+/************************************************************************/
+bool DLSSolver::setJacobian(const Matrix &_J, const Vector &_w)
+{
+    if (_w.length()!=_J.cols())
+        return false;
+
+    J=_J;
+    w=_w;
+    weighted=true;
+    gramValid=factorized=false;
+
+    return ((J.rows()>0) && (J.cols()>0));
+}
+
+
+/************************************************************************/
+void DLSSolver::computeGram()
+{
+    int m=(int)J.rows();
+    int n=(int)J.cols();
+
+    if (colForm)
+    {
+        G.resize(n,n);
+        for (int r=0; r<n; r++)
+        {
+            for (int c=r; c<n; c++)
+            {
+                double s=0.0;
+                for (int i=0; i<m; i++)
+                    s+=J(i,r)*J(i,c);
+                G(r,c)=G(c,r)=s;
+            }
+        }
+    }
+    else
+    {
+        G.resize(m,m);
+        for (int r=0; r<m; r++)
+        {
+            for (int c=r; c<m; c++)
+            {
+                double s=0.0;
+                for (int i=0; i<n; i++)
+                    s+=(weighted ? w[i] : 1.0)*J(r,i)*J(c,i);
+                G(r,c)=G(c,r)=s;
+            }
+        }
+    }
+
+    gramValid=true;
+}
+
+
+/************************************************************************/
+bool DLSSolver::choleskyFactor(const double lambda, const bool scaled)
+{
+    int k=(int)G.rows();
+    L.resize(k,k);
+
+    double maxDiag=0.0;
+    for (int i=0; i<k; i++)
+    {
+        L(i,i)=scaled ? G(i,i)*(1.0+lambda) : G(i,i)+lambda;
+        maxDiag=std::max(maxDiag,L(i,i));
+    }
+
+    // the pivots are compared with the largest diagonal entry
+    // to detect the matrices that are close to singular
+    double tol=DLSSOLVER_PIVOT_TOL*maxDiag;
+    if (tol<=0.0)
+        return false;
+
+    for (int j=0; j<k; j++)
+    {
+        double s=L(j,j);
+        for (int p=0; p<j; p++)
+            s-=L(j,p)*L(j,p);
+
+        if (s<=tol)
+            return false;
+
+        L(j,j)=sqrt(s);
+        for (int i=j+1; i<k; i++)
+        {
+            double t=G(i,j);
+            for (int p=0; p<j; p++)
+                t-=L(i,p)*L(j,p);
+            L(i,j)=t/L(j,j);
+            L(j,i)=0.0;
+        }
+    }
+
+    return true;
+}
+
+
+/************************************************************************/
+void DLSSolver::svdFactor(const double lambda, const bool scaled)
+{
+    int k=(int)G.rows();
+    Matrix A=G;
+    for (int i=0; i<k; i++)
+        A(i,i)=scaled ? G(i,i)*(1.0+lambda) : G(i,i)+lambda;
+
+    Matrix U(k,k),V(k,k);
+    Vector Sdiag(k);
+    SVD(A,U,Sdiag,V);
+
+    pinvG.resize(k,k);
+    for (int r=0; r<k; r++)
+    {
+        for (int c=0; c<k; c++)
+        {
+            double s=0.0;
+            for (int i=0; i<k; i++)
+                if (Sdiag[i]>0.0)
+                    s+=V(r,i)*U(c,i)/Sdiag[i];
+            pinvG(r,c)=s;
+        }
+    }
+
+    if (!weighted && (lambda==0.0))
+        svMin=sqrt(std::max(Sdiag[k-1],0.0));
+}
+
+
+/************************************************************************/
+void DLSSolver::applyInverse(Vector &y) const
+{
+    int k=(int)y.length();
+
+    if (cholesky)
+    {
+        // forward substitution with L, then backward with Lt
+        for (int i=0; i<k; i++)
+        {
+            double s=y[i];
+            for (int p=0; p<i; p++)
+                s-=L(i,p)*y[p];
+            y[i]=s/L(i,i);
+        }
+
+        for (int i=k-1; i>=0; i--)
+        {
+            double s=y[i];
+            for (int p=i+1; p<k; p++)
+                s-=L(p,i)*y[p];
+            y[i]=s/L(i,i);
+        }
+    }
+    else
+        y=pinvG*y;
+}
+
+
+/************************************************************************/
+double DLSSolver::inverseIteration()
+{
+    int k=(int)G.rows();
+
+    // the singular vector found for the previous Jacobian is kept
+    // as starting point, as long as the size does not change
+    if ((int)v.length()!=k)
+    {
+        v.resize(k);
+        for (int i=0; i<k; i++)
+            v[i]=1.0/(i+1.0);
+        v/=norm(v);
+    }
+
+    double rq=0.0;
+    Vector y=v;
+    for (int iter=0; iter<DLSSOLVER_SV_MAXITER; iter++)
+    {
+        applyInverse(y);
+        double nrm=norm(y);
+        if (nrm==0.0)
+            break;
+
+        for (int i=0; i<k; i++)
+            v[i]=y[i]/nrm;
+
+        // Rayleigh quotient of the Gram matrix
+        double rq_new=0.0;
+        for (int r=0; r<k; r++)
+        {
+            double s=0.0;
+            for (int c=0; c<k; c++)
+                s+=G(r,c)*v[c];
+            rq_new+=v[r]*s;
+        }
+
+        bool converged=(fabs(rq_new-rq)<=DLSSOLVER_SV_TOL*rq_new);
+        rq=rq_new;
+        if (converged)
+            break;
+
+        y=v;
+    }
+
+    return rq;
+}
+
+
+/************************************************************************/
+bool DLSSolver::factorize(const double lambda, const bool scaled)
+{
+    if ((J.rows()==0) || (J.cols()==0))
+    {
+        factorized=false;
+        return false;
+    }
+
+    // with tall Jacobians the smaller Jt*J is preferred, unless
+    // weights or damping require the form J*W*Jt
+    bool col=(J.rows()>J.cols()) && !weighted && (lambda==0.0);
+    if (!gramValid || (col!=colForm))
+    {
+        colForm=col;
+        computeGram();
+    }
+
+    cholesky=choleskyFactor(lambda,scaled);
+    if (cholesky)
+    {
+        if (!weighted && (lambda==0.0))
+            svMin=sqrt(std::max(inverseIteration(),0.0));
+    }
+    else
+        svdFactor(lambda,scaled);
+
+    factorized=true;
+    return cholesky;
+}
+
+
+/************************************************************************/
+Matrix DLSSolver::getPinv() const
+{
+    int m=(int)J.rows();
+    int n=(int)J.cols();
+    Matrix P(n,m);
+    if (!factorized)
+    {
+        P.zero();
+        return P;
+    }
+
+    if (colForm)
+    {
+        // P=inv(Jt*J)*Jt, column by column
+        Vector y(n);
+        for (int c=0; c<m; c++)
+        {
+            for (int i=0; i<n; i++)
+                y[i]=J(c,i);
+            applyInverse(y);
+            for (int i=0; i<n; i++)
+                P(i,c)=y[i];
+        }
+    }
+    else
+    {
+        // P=W*Jt*inv(J*W*Jt+D), where the inverse is built column by column
+        Matrix Ginv(m,m);
+        Vector y(m);
+        for (int c=0; c<m; c++)
+        {
+            y=0.0;
+            y[c]=1.0;
+            applyInverse(y);
+            Ginv.setCol(c,y);
+        }
+
+        for (int r=0; r<n; r++)
+        {
+            double wr=weighted ? w[r] : 1.0;
+            for (int c=0; c<m; c++)
+            {
+                double s=0.0;
+                for (int i=0; i<m; i++)
+                    s+=J(i,r)*Ginv(i,c);
+                P(r,c)=wr*s;
+            }
+        }
+    }
+
+    return P;
+}
+
+
+/************************************************************************/
+Vector DLSSolver::solve(const Vector &e) const
+{
+    int m=(int)J.rows();
+    int n=(int)J.cols();
+    Vector x(n,0.0);
+    if (!factorized || ((int)e.length()!=m))
+        return x;
+
+    if (colForm)
+    {
+        for (int i=0; i<n; i++)
+        {
+            double s=0.0;
+            for (int r=0; r<m; r++)
+                s+=J(r,i)*e[r];
+            x[i]=s;
+        }
+        applyInverse(x);
+    }
+    else
+    {
+        Vector y=e;
+        applyInverse(y);
+        for (int i=0; i<n; i++)
+        {
+            double s=0.0;
+            for (int r=0; r<m; r++)
+                s+=J(r,i)*y[r];
+            x[i]=(weighted ? w[i] : 1.0)*s;
+        }
+    }
+
+    return x;
+}
+
+
+/************************************************************************/
+Vector DLSSolver::projectNullSpace(const Vector &z) const
+{
+    if (z.length()!=J.cols())
+        return z;
+
+    return z-solve(J*z);
+}
+
+
+/************************************************************************/
+Matrix DLSSolver::getNullSpaceProjector() const
+{
+    int n=(int)J.cols();
+    return eye(n,n)-getPinv()*J;
+}
+
+
 /************************************************************************/
 iKinCtrl::iKinCtrl(iKinChain &c, unsigned int _ctrlPose) : chain(c)
 {
@@ -323,10 +697,9 @@ Vector SteepCtrl::iterate(Vector &xd, const unsigned int verbose)
         J =chain.GeoJacobian();
         Jt=J.transposed();
 
-        if (J.rows()>=J.cols())
-            pinvJ=pinv(J);
-        else
-            pinvJ=pinv(J.transposed()).transposed();
+        dls.setJacobian(J);
+        dls.factorize();
+        pinvJ=dls.getPinv();
 
         if (type==IKINCTRL_STEEP_JT)
             grad=-1.0*(Jt*e);
@@ -582,19 +955,14 @@ Vector LMCtrl::iterate(Vector &xd, const unsigned int verbose)
         Jt=J.transposed();
         grad=-1.0*(Jt*e);
 
-        Matrix LM=J*Jt;
-        for (int i=0; i<6; i++)
-            LM(i,i)+=mu*LM(i,i);
+        // J*Jt is computed once for both the plain and the damped inverse
+        dls.setJacobian(J);
+        dls.factorize();
+        pinvJ=dls.getPinv();
+        svMin=dls.getMinSingularValue();
 
-        if (LM.rows()>=LM.cols())
-            pinvLM=Jt*pinv(LM);
-        else
-            pinvLM=Jt*pinv(LM.transposed()).transposed();
-
-        if (J.rows()>=J.cols())
-            pinvJ=LMCtrl::pinv(J);
-        else
-            pinvJ=LMCtrl::pinv(J.transposed()).transposed();
+        dls.factorize(mu,true);
+        pinvLM=dls.getPinv();
 
         gpm=computeGPM();
 
@@ -717,7 +1085,7 @@ Vector LMCtrl_GPM::computeGPM()
         w[i]+=d_max[i]<0.0 ? 0.0 : 2.0*d_max[i]/(span[i]*span[i]);
     }
 
-    return (Eye-pinvLM*J)*((-K)*w);
+    return dls.projectNullSpace((-K)*w);
 }
 
 
@@ -845,7 +1213,13 @@ Vector MultiRefMinJerkCtrl::iterate(Vector &xd, Vector &qd, Vector *xdot_set,
 
         computeWeight();
 
-        qdot=_qdot+W*(Jt*(pinv(Eye6+J*W*Jt)*(_xdot-J*_qdot)));        
+        Vector w(dim);
+        for (unsigned int i=0; i<dim; i++)
+            w[i]=W(i,i);
+
+        dls.setJacobian(J,w);
+        dls.factorize(1.0);
+        qdot=_qdot+dls.solve(_xdot-J*_qdot);
         xdot=J*qdot;
         q=chain.setAng(I->integrate(qdot));
         x=chain.EndEffPose();
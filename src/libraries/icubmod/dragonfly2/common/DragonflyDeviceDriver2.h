@@ -81,6 +81,10 @@ PGRFlyCapture (Windows)
 
 --feature          // camera feature setting, normalized between 0.0 and 1.0 (features listed below)
 
+--demosaic_method  // software Bayer decoding (Linux): bilinear (default), edge or dc1394
+
+--demosaic_threads // threads used by the software Bayer decoding, 0 (default) = automatic
+
 
 \subsection video_type The video_type parameter
 
@@ -92,6 +96,17 @@ The video_type parameter determines how images are acquired by the dragonfly chi
 
 -video_type 3: the image is acquired as a raw Bayer pattern 640x480 image, and transferred in this format to the framegrabber driver memory buffer. In this way, the bandwidth required to the Firewire bus is lower than in the previous format, allowing 60 fps. The Bayer decoding to the usual RGB format provided by the DragonflyDeviceDriver2 framegrabber is performed at software level by the driver itself. If specified, the --width and --height parameters will '''crop''' the original 640 x 480 image to the specified dimension.
 
+\subsection demosaic Software Bayer decoding
+
+On Linux the Bayer decoding of video_type 3 is done by the driver with its own kernels, which write
+the RGB rows straight into the output image and split the frame among --demosaic_threads threads.
+With --demosaic_method bilinear the result is identical to the bilinear decoding of libdc1394, with
+--demosaic_method edge the green channel is interpolated along the edges, and --demosaic_method dc1394
+falls back to the libdc1394 decoder. When the consumers do not need every frame in RGB, the
+dragonfly2raw device publishes the Bayer frames as they are (a quarter of the bandwidth of RGB): they
+can be decoded lazily on the receiving side with the same BayerDemosaic class, which depends neither
+on libdc1394 nor on YARP. The dragonfly2DemosaicCheck tool compares the decoders on recorded raw frames.
+
 \subsection port_units Port, Unit number and 64 bit Global Unique Identifier
 
 Many cameras can coexist on the same Firewire bus (port), sharing the available bandwidth. Each camera connected to the same Firewire bus is associated to a unit number. Port numbers, as well as unit numbers, are assigned increasingly starting from 0.
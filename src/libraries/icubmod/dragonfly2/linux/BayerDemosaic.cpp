@@ -0,0 +1,301 @@
+/*
+ * Copyright (C) 2022 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <cstring>
+#include <cstdlib>
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64)
+    #include <emmintrin.h>
+    #define BAYER_DEMOSAIC_SSE2
+#endif
+
+#include "BayerDemosaic.h"
+
+namespace
+{
+    // Per-row averages, for x in [1,w-2]:
+    //   H = horizontal pair, V = vertical pair, X = cross, D = diagonals,
+    //   E = green interpolated along the smaller gradient (EDGE_AWARE only).
+    // Rounding is the one of libdc1394: (a+b+1)>>1 and (a+b+c+d+2)>>2.
+    inline void averagesScalar(const unsigned char *up, const unsigned char *mid,
+                               const unsigned char *down, int x0, int x1, bool edge,
+                               unsigned char *H, unsigned char *V, unsigned char *X,
+                               unsigned char *D, unsigned char *E)
+    {
+        for (int x=x0; x<x1; x++)
+        {
+            H[x]=(unsigned char)((mid[x-1]+mid[x+1]+1)>>1);
+            V[x]=(unsigned char)((up[x]+down[x]+1)>>1);
+            X[x]=(unsigned char)((up[x]+down[x]+mid[x-1]+mid[x+1]+2)>>2);
+            D[x]=(unsigned char)((up[x-1]+up[x+1]+down[x-1]+down[x+1]+2)>>2);
+            if (edge)
+            {
+                int dh=std::abs(mid[x-1]-mid[x+1]);
+                int dv=std::abs(up[x]-down[x]);
+                E[x]=(dh<dv)?H[x]:((dv<dh)?V[x]:X[x]);
+            }
+        }
+    }
+
+#ifdef BAYER_DEMOSAIC_SSE2
+    inline __m128i quad(__m128i a, __m128i b, __m128i c, __m128i d)
+    {
+        const __m128i zero=_mm_setzero_si128();
+        const __m128i two=_mm_set1_epi16(2);
+        __m128i lo=_mm_add_epi16(_mm_add_epi16(_mm_unpacklo_epi8(a,zero),_mm_unpacklo_epi8(b,zero)),
+                                 _mm_add_epi16(_mm_unpacklo_epi8(c,zero),_mm_unpacklo_epi8(d,zero)));
+        __m128i hi=_mm_add_epi16(_mm_add_epi16(_mm_unpackhi_epi8(a,zero),_mm_unpackhi_epi8(b,zero)),
+                                 _mm_add_epi16(_mm_unpackhi_epi8(c,zero),_mm_unpackhi_epi8(d,zero)));
+        lo=_mm_srli_epi16(_mm_add_epi16(lo,two),2);
+        hi=_mm_srli_epi16(_mm_add_epi16(hi,two),2);
+        return _mm_packus_epi16(lo,hi);
+    }
+
+    inline __m128i absdiff(__m128i a, __m128i b)
+    {
+        return _mm_or_si128(_mm_subs_epu8(a,b),_mm_subs_epu8(b,a));
+    }
+#endif
+
+    void averages(const unsigned char *up, const unsigned char *mid,
+                  const unsigned char *down, int w, bool edge,
+                  unsigned char *H, unsigned char *V, unsigned char *X,
+                  unsigned char *D, unsigned char *E)
+    {
+        int x=1;
+#ifdef BAYER_DEMOSAIC_SSE2
+        for (; x+16<=w-1; x+=16)
+        {
+            __m128i l=_mm_loadu_si128((const __m128i*)(mid+x-1));
+            __m128i r=_mm_loadu_si128((const __m128i*)(mid+x+1));
+            __m128i u=_mm_loadu_si128((const __m128i*)(up+x));
+            __m128i d=_mm_loadu_si128((const __m128i*)(down+x));
+            __m128i ul=_mm_loadu_si128((const __m128i*)(up+x-1));
+            __m128i ur=_mm_loadu_si128((const __m128i*)(up+x+1));
+            __m128i dl=_mm_loadu_si128((const __m128i*)(down+x-1));
+            __m128i dr=_mm_loadu_si128((const __m128i*)(down+x+1));
+
+            // _mm_avg_epu8 computes (a+b+1)>>1
+            __m128i h=_mm_avg_epu8(l,r);
+            __m128i v=_mm_avg_epu8(u,d);
+            __m128i c=quad(u,d,l,r);
+            _mm_storeu_si128((__m128i*)(H+x),h);
+            _mm_storeu_si128((__m128i*)(V+x),v);
+            _mm_storeu_si128((__m128i*)(X+x),c);
+            _mm_storeu_si128((__m128i*)(D+x),quad(ul,ur,dl,dr));
+
+            if (edge)
+            {
+                __m128i dh=absdiff(l,r);
+                __m128i dv=absdiff(u,d);
+                __m128i eq=_mm_cmpeq_epi8(dh,dv);
+                __m128i hle=_mm_cmpeq_epi8(_mm_max_epu8(dh,dv),dv);   // dh<=dv
+                __m128i hlt=_mm_andnot_si128(eq,hle);
+                __m128i vlt=_mm_andnot_si128(hle,_mm_set1_epi8(-1));
+                __m128i e=_mm_or_si128(_mm_or_si128(_mm_and_si128(hlt,h),_mm_and_si128(vlt,v)),
+                                       _mm_and_si128(eq,c));
+                _mm_storeu_si128((__m128i*)(E+x),e);
+            }
+        }
+#endif
+        averagesScalar(up,mid,down,x,w-1,edge,H,V,X,D,E);
+    }
+}
+
+
+/************************************************************************/
+BayerDemosaic::BayerDemosaic(int threads) : m_Method(BILINEAR), m_Width(0),
+    m_pTask(nullptr), m_Rows(0), m_Generation(0), m_Pending(0), m_bQuit(false)
+{
+    if (threads<=0)
+        threads=std::min(4,std::max(1,(int)std::thread::hardware_concurrency()));
+
+    m_nThreads=threads;
+    m_Scratch.resize(m_nThreads);
+
+    // the calling thread processes the first stripe
+    for (int i=1; i<m_nThreads; i++)
+        m_Workers.push_back(std::thread(&BayerDemosaic::worker,this,i));
+}
+
+
+/************************************************************************/
+BayerDemosaic::~BayerDemosaic()
+{
+    {
+        std::lock_guard<std::mutex> lck(m_Mutex);
+        m_bQuit=true;
+    }
+    m_CvStart.notify_all();
+
+    for (auto &t:m_Workers)
+        t.join();
+}
+
+
+/************************************************************************/
+void BayerDemosaic::worker(int id)
+{
+    unsigned int generation=0;
+    while (true)
+    {
+        const std::function<void(int,int,int)> *task;
+        int rows;
+        {
+            std::unique_lock<std::mutex> lck(m_Mutex);
+            m_CvStart.wait(lck,[&]() { return m_bQuit || (m_Generation!=generation); });
+            if (m_bQuit)
+                return;
+
+            generation=m_Generation;
+            task=m_pTask;
+            rows=m_Rows;
+        }
+
+        (*task)(id,(int)((long)id*rows/m_nThreads),(int)((long)(id+1)*rows/m_nThreads));
+
+        {
+            std::lock_guard<std::mutex> lck(m_Mutex);
+            --m_Pending;
+        }
+        m_CvDone.notify_one();
+    }
+}
+
+
+/************************************************************************/
+void BayerDemosaic::run(const std::function<void(int,int,int)> &task, int rows)
+{
+    if (m_nThreads==1)
+    {
+        task(0,0,rows);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lck(m_Mutex);
+        m_pTask=&task;
+        m_Rows=rows;
+        m_Pending=m_nThreads-1;
+        ++m_Generation;
+    }
+    m_CvStart.notify_all();
+
+    task(0,0,rows/m_nThreads);
+
+    std::unique_lock<std::mutex> lck(m_Mutex);
+    m_CvDone.wait(lck,[&]() { return m_Pending==0; });
+}
+
+
+/************************************************************************/
+void BayerDemosaic::demosaicRows(const unsigned char *raw, size_t rawStride, int w, int h,
+                                 Pattern pattern, Method method, unsigned char *rgb,
+                                 size_t rgbStride, int r0, int r1, unsigned char *scratch)
+{
+    const bool edge=(method==EDGE_AWARE);
+    unsigned char *H=scratch;
+    unsigned char *V=H+w+16;
+    unsigned char *X=V+w+16;
+    unsigned char *D=X+w+16;
+    unsigned char *E=D+w+16;
+    const unsigned char *G=edge?E:X;
+
+    // layout of the even rows; odd rows swap both
+    const bool greenFirstEven=(pattern==GBRG) || (pattern==GRBG);
+    const bool redRowEven=(pattern==RGGB) || (pattern==GRBG);
+
+    for (int y=r0; y<r1; y++)
+    {
+        unsigned char *out=rgb+y*rgbStride;
+
+        // black borders, as libdc1394 does
+        if ((y==0) || (y==h-1) || (w<3) || (h<3))
+        {
+            memset(out,0,3*(size_t)w);
+            continue;
+        }
+
+        const unsigned char *mid=raw+y*rawStride;
+        averages(mid-rawStride,mid,mid+rawStride,w,edge,H,V,X,D,E);
+
+        const bool odd=((y&1)!=0);
+        const int greenParity=(greenFirstEven!=odd)?0:1;
+        const int cr=(redRowEven!=odd)?0:2;     // channel of the non-green pixels of this row
+        const int co=2-cr;
+
+        out[0]=out[1]=out[2]=0;
+        for (int x=1; x<w-1; x++)
+        {
+            unsigned char *px=out+3*x;
+            if ((x&1)==greenParity)
+            {
+                px[1]=mid[x];
+                px[cr]=H[x];
+                px[co]=V[x];
+            }
+            else
+            {
+                px[cr]=mid[x];
+                px[1]=G[x];
+                px[co]=D[x];
+            }
+        }
+        out[3*(w-1)]=out[3*(w-1)+1]=out[3*(w-1)+2]=0;
+    }
+}
+
+
+/************************************************************************/
+void BayerDemosaic::apply(const unsigned char *raw, size_t rawStride, int w, int h,
+                          Pattern pattern, unsigned char *rgb, size_t rgbStride)
+{
+    if (w!=m_Width)
+    {
+        for (auto &s:m_Scratch)
+            s.resize(scratchSize(w));
+        m_Width=w;
+    }
+
+    const Method method=m_Method;
+    std::function<void(int,int,int)> task=[&](int id, int r0, int r1)
+    {
+        demosaicRows(raw,rawStride,w,h,pattern,method,rgb,rgbStride,r0,r1,m_Scratch[id].data());
+    };
+
+    run(task,h);
+}
+
+
+/************************************************************************/
+void BayerDemosaic::apply16(const unsigned char *raw, size_t rawStride, int w, int h,
+                            int depth, bool littleEndian, Pattern pattern,
+                            unsigned char *rgb, size_t rgbStride)
+{
+    m_Raw8.resize((size_t)w*h);
+    const int shift=std::max(0,std::min(8,depth-8));
+    const int lsb=littleEndian?0:1;
+
+    std::function<void(int,int,int)> task=[&](int, int r0, int r1)
+    {
+        for (int y=r0; y<r1; y++)
+        {
+            const unsigned char *src=raw+y*rawStride;
+            unsigned char *dst=m_Raw8.data()+(size_t)y*w;
+            for (int x=0; x<w; x++)
+            {
+                unsigned int v=src[2*x+lsb]|(src[2*x+1-lsb]<<8);
+                dst[x]=(unsigned char)std::min(255u,v>>shift);
+            }
+        }
+    };
+
+    run(task,h);
+    apply(m_Raw8.data(),w,w,h,pattern,rgb,rgbStride);
+}
@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2022 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef __BAYER_DEMOSAIC_H__
+#define __BAYER_DEMOSAIC_H__
+
+#include <cstddef>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+/**
+ * Bayer demosaicing of 8 bit (or 16 bit, reduced to their 8 most
+ * significant bits) raw frames into packed RGB, written row by row
+ * straight into the destination buffer with any row stride.
+ *
+ * The BILINEAR method reproduces bit by bit the output of libdc1394
+ * with DC1394_BAYER_METHOD_BILINEAR (borders included, which are black).
+ * The EDGE_AWARE method interpolates green along the direction of the
+ * smaller gradient and is otherwise bilinear.
+ *
+ * The per-row averages are computed with SSE2 where available, and the
+ * frame is split into stripes of rows processed by a pool of persistent
+ * workers. The class has no dependency on libdc1394 nor on YARP, hence
+ * it can be used also by the consumers of the raw frames.
+ */
+class BayerDemosaic
+{
+public:
+    // same order as dc1394color_filter_t
+    enum Pattern { RGGB=0, GBRG, GRBG, BGGR };
+    enum Method { BILINEAR=0, EDGE_AWARE };
+
+    /**
+     * @param threads number of threads used on each frame (the caller
+     *        included); 0 picks it from the available cores.
+     */
+    explicit BayerDemosaic(int threads=0);
+    ~BayerDemosaic();
+
+    void setMethod(Method method) { m_Method=method; }
+    Method getMethod() const { return m_Method; }
+    int getThreads() const { return m_nThreads; }
+
+    /**
+     * Demosaics a 8 bit raw frame.
+     * @param raw first byte of the raw frame.
+     * @param rawStride bytes between two rows of the raw frame.
+     * @param rgb first byte of the destination, w*h packed RGB pixels.
+     * @param rgbStride bytes between two rows of the destination.
+     */
+    void apply(const unsigned char *raw, size_t rawStride, int w, int h,
+               Pattern pattern, unsigned char *rgb, size_t rgbStride);
+
+    /**
+     * Demosaics a 16 bit raw frame holding depth significant bits,
+     * which are reduced to 8 before the interpolation.
+     */
+    void apply16(const unsigned char *raw, size_t rawStride, int w, int h,
+                 int depth, bool littleEndian, Pattern pattern,
+                 unsigned char *rgb, size_t rgbStride);
+
+    /** Single-threaded kernel: demosaics the rows [r0,r1) of the frame. */
+    static void demosaicRows(const unsigned char *raw, size_t rawStride, int w, int h,
+                             Pattern pattern, Method method, unsigned char *rgb,
+                             size_t rgbStride, int r0, int r1, unsigned char *scratch);
+
+    /** Bytes of scratch memory needed by demosaicRows() for width w. */
+    static size_t scratchSize(int w) { return 5*(size_t)(w+16); }
+
+private:
+    void run(const std::function<void(int,int,int)> &task, int rows);
+    void worker(int id);
+
+    Method m_Method;
+    int m_nThreads;
+    int m_Width;
+    std::vector<std::vector<unsigned char>> m_Scratch;
+    std::vector<unsigned char> m_Raw8;
+
+    std::vector<std::thread> m_Workers;
+    std::mutex m_Mutex;
+    std::condition_variable m_CvStart;
+    std::condition_variable m_CvDone;
+    const std::function<void(int,int,int)> *m_pTask;
+    int m_Rows;
+    unsigned int m_Generation;
+    int m_Pending;
+    bool m_bQuit;
+};
+
+#endif
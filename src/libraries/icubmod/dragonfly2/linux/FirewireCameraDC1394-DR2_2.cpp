@@ -71,6 +71,7 @@ CFWCamera_DR2_2::CFWCamera_DR2_2(bool raw): mRawDriver(raw),
     configDistM = false;
     configIntrins = false;
     m_ConvFrame.image=NULL;
+    m_pDemosaic=NULL;
 }
 
 int CFWCamera_DR2_2::width() { return m_XDim; }
@@ -314,7 +315,27 @@ bool CFWCamera_DR2_2::Create(yarp::os::Searchable& config)
     m_nNumCameras=0;
     m_nInvalidFrames=0;
     m_ConvFrame.image=new unsigned char[1032*776*3*2];
+    m_ConvFrame.allocated_image_bytes=1032*776*3*2;
     m_ConvFrame_tmp.image=new unsigned char[1032*776*2];
+    m_ConvFrame_tmp.allocated_image_bytes=1032*776*2;
+
+    std::string demosaicMethod=config.check("demosaic_method",yarp::os::Value("bilinear"),
+        "Bayer demosaicing: bilinear, edge (edge aware) or dc1394 (libdc1394 debayer)").asString();
+    if (demosaicMethod!="dc1394")
+    {
+        int demosaicThreads=config.check("demosaic_threads",yarp::os::Value(0),
+            "threads used for Bayer demosaicing (0 = automatic)").asInt32();
+        m_pDemosaic=new BayerDemosaic(demosaicThreads);
+        if (demosaicMethod=="edge")
+        {
+            m_pDemosaic->setMethod(BayerDemosaic::EDGE_AWARE);
+        }
+        else if (demosaicMethod!="bilinear")
+        {
+            yWarning("unknown demosaic_method %s, using bilinear\n",demosaicMethod.c_str());
+        }
+        yInfo("Bayer demosaicing: %s, %d threads\n",demosaicMethod.c_str(),m_pDemosaic->getThreads());
+    }
 
     if (!(m_dc1394_handle=dc1394_new()))
     {
@@ -659,6 +680,9 @@ void CFWCamera_DR2_2::Close()
 
     if (m_ConvFrame.image) delete [] m_ConvFrame.image;
     m_ConvFrame.image=NULL;
+
+    if (m_pDemosaic) delete m_pDemosaic;
+    m_pDemosaic=NULL;
 }
 
 bool CFWCamera_DR2_2::CaptureImage(yarp::sig::ImageOf<yarp::sig::PixelRgb>& image)
@@ -1186,15 +1210,50 @@ bool CFWCamera_DR2_2::Capture(yarp::sig::ImageOf<yarp::sig::PixelRgb>* pImage,un
         m_Stamp.update();
     }
 
+    int w=m_pFrame->size[0];
+    int h=m_pFrame->size[1];
+    size_t stride=3*w;
+
     if (pImage)
     {
-        pImage->resize(m_pFrame->size[0],m_pFrame->size[1]);
+        if ((int)pImage->width()!=w || (int)pImage->height()!=h)
+        {
+            pImage->resize(w,h);
+        }
         pBuffer=pImage->getRawImage();
+        stride=pImage->getRowSize();
     }
 
-    if (m_pFrame->color_coding==DC1394_COLOR_CODING_RGB8 || bRaw)
+    // the Bayer kernels write each row straight into the destination,
+    // there is no intermediate frame to copy from
+    bool bBayer=(m_pFrame->color_coding==DC1394_COLOR_CODING_RAW8 ||
+                 m_pFrame->color_coding==DC1394_COLOR_CODING_RAW16);
+    BayerDemosaic::Pattern pattern=(BayerDemosaic::Pattern)(m_pFrame->color_filter-DC1394_COLOR_FILTER_MIN);
+
+    if (bRaw)
     {
-        memcpy(pBuffer,m_pFrame->image,m_pFrame->size[0]*m_pFrame->size[1]*(bRaw?1:3));
+        memcpy(pBuffer,m_pFrame->image,w*h);
+    }
+    else if (m_pFrame->color_coding==DC1394_COLOR_CODING_RGB8)
+    {
+        if (stride==(size_t)(3*w))
+        {
+            memcpy(pBuffer,m_pFrame->image,3*w*h);
+        }
+        else for (int r=0; r<h; ++r)
+        {
+            memcpy(pBuffer+r*stride,m_pFrame->image+r*3*w,3*w);
+        }
+    }
+    else if (bBayer && m_pDemosaic && m_pFrame->color_coding==DC1394_COLOR_CODING_RAW8)
+    {
+        m_pDemosaic->apply(m_pFrame->image,m_pFrame->stride?m_pFrame->stride:w,w,h,pattern,pBuffer,stride);
+    }
+    else if (bBayer && m_pDemosaic)
+    {
+        m_pDemosaic->apply16(m_pFrame->image,m_pFrame->stride?m_pFrame->stride:2*w,w,h,
+                             m_pFrame->data_depth,m_pFrame->little_endian==DC1394_TRUE,
+                             pattern,pBuffer,stride);
     }
     else if (m_pFrame->color_coding==DC1394_COLOR_CODING_RAW8)
     {
@@ -1220,21 +1279,34 @@ bool CFWCamera_DR2_2::Capture(yarp::sig::ImageOf<yarp::sig::PixelRgb>* pImage,un
     }
     else
     {
-        m_ConvFrame.size[0]=m_pFrame->size[0];
-        m_ConvFrame.size[1]=m_pFrame->size[1];
-        m_ConvFrame.position[0]=0;
-        m_ConvFrame.position[1]=0;
-        m_ConvFrame.color_coding=DC1394_COLOR_CODING_RGB8;
-        m_ConvFrame.data_depth=24;
-        m_ConvFrame.image_bytes=m_ConvFrame.total_bytes=3*m_pFrame->size[0]*m_pFrame->size[1];
-        m_ConvFrame.padding_bytes=0;
-        m_ConvFrame.stride=3*m_pFrame->size[0];
-        m_ConvFrame.data_in_padding=DC1394_FALSE;
-        m_ConvFrame.little_endian=m_pFrame->little_endian;
-
-        dc1394_convert_frames(m_pFrame,&m_ConvFrame);
+        // YUV: when the destination rows are contiguous libdc1394 converts
+        // straight into it, otherwise it goes through m_ConvFrame
+        dc1394video_frame_t dst=m_ConvFrame;
+        bool bDirect=(stride==(size_t)(3*w));
+        if (bDirect)
+        {
+            dst.image=pBuffer;
+            dst.allocated_image_bytes=3*w*h;
+        }
 
-        memcpy(pBuffer,m_ConvFrame.image,m_ConvFrame.size[0]*m_ConvFrame.size[1]*3);
+        dst.size[0]=w;
+        dst.size[1]=h;
+        dst.position[0]=0;
+        dst.position[1]=0;
+        dst.color_coding=DC1394_COLOR_CODING_RGB8;
+        dst.data_depth=24;
+        dst.image_bytes=dst.total_bytes=3*w*h;
+        dst.padding_bytes=0;
+        dst.stride=3*w;
+        dst.data_in_padding=DC1394_FALSE;
+        dst.little_endian=m_pFrame->little_endian;
+
+        dc1394_convert_frames(m_pFrame,&dst);
+
+        if (!bDirect) for (int r=0; r<h; ++r)
+        {
+            memcpy(pBuffer+r*stride,dst.image+r*3*w,3*w);
+        }
     }
 
     dc1394_capture_enqueue(m_pCamera,m_pFrame);
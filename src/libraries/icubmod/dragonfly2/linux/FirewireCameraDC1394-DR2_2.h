@@ -31,6 +31,8 @@
 #include <yarp/dev/IFrameGrabberControlsDC1394.h>
 #include <yarp/dev/IFrameGrabberControls.h>
 
+#include "BayerDemosaic.h"
+
 #define NUM_DMA_BUFFERS 4
 
 // formats
@@ -92,6 +94,7 @@ protected:
     dc1394camera_list_t *m_pCameraList;
     dc1394video_frame_t m_ConvFrame;
     dc1394video_frame_t m_ConvFrame_tmp;
+    BayerDemosaic *m_pDemosaic;
 
     int m_nNumCameras;
     int m_nActiveCams;
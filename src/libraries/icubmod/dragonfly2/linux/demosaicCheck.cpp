@@ -0,0 +1,155 @@
+/*
+ * Copyright (C) 2022 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+// Offline check of BayerDemosaic against the libdc1394 decoder.
+//
+// dragonfly2DemosaicCheck [--pattern rggb|gbrg|grbg|bggr] [--threads N]
+//                         [--method bilinear|edge] [--frames N] [file.pgm ...]
+//
+// The input files are binary PGM raw Bayer frames, as saved by yarpdatadumper
+// from the port of a dragonfly2raw device; without files a synthetic frame of
+// 640x480 is used. For each frame the tool reports the pixels differing from
+// dc1394_bayer_decoding_8bit() with DC1394_BAYER_METHOD_BILINEAR (there must
+// be none with --method bilinear) and the time per frame of both decoders.
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+
+#include <dc1394/dc1394.h>
+
+#include "BayerDemosaic.h"
+
+namespace
+{
+    bool loadPGM(const std::string &name, std::vector<unsigned char> &data, int &w, int &h)
+    {
+        FILE *f=fopen(name.c_str(),"rb");
+        if (!f)
+            return false;
+
+        int maxVal=0;
+        bool ok=(fscanf(f,"P5 %d %d %d",&w,&h,&maxVal)==3) && (maxVal<256) && (fgetc(f)!=EOF);
+        if (ok)
+        {
+            data.resize((size_t)w*h);
+            ok=(fread(data.data(),1,data.size(),f)==data.size());
+        }
+
+        fclose(f);
+        return ok;
+    }
+
+    void synthetic(std::vector<unsigned char> &data, int w, int h)
+    {
+        // gradients, stripes and noise
+        data.resize((size_t)w*h);
+        unsigned int seed=1;
+        for (int y=0; y<h; y++)
+            for (int x=0; x<w; x++)
+            {
+                seed=1103515245*seed+12345;
+                int v=(x*255)/w/2+(((x/8+y/8)&1)?96:0)+((seed>>16)&0x1f);
+                data[(size_t)y*w+x]=(unsigned char)std::min(255,v);
+            }
+    }
+
+    double now()
+    {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+}
+
+
+int main(int argc, char *argv[])
+{
+    BayerDemosaic::Pattern pattern=BayerDemosaic::RGGB;
+    BayerDemosaic::Method method=BayerDemosaic::BILINEAR;
+    int threads=0;
+    int frames=100;
+    std::vector<std::string> files;
+
+    for (int i=1; i<argc; i++)
+    {
+        std::string arg=argv[i];
+        if ((arg=="--pattern") && (i+1<argc))
+        {
+            std::string p=argv[++i];
+            const char *names[]={"rggb","gbrg","grbg","bggr"};
+            for (int k=0; k<4; k++)
+                if (p==names[k])
+                    pattern=(BayerDemosaic::Pattern)k;
+        }
+        else if ((arg=="--method") && (i+1<argc))
+            method=(std::string(argv[++i])=="edge")?BayerDemosaic::EDGE_AWARE:BayerDemosaic::BILINEAR;
+        else if ((arg=="--threads") && (i+1<argc))
+            threads=atoi(argv[++i]);
+        else if ((arg=="--frames") && (i+1<argc))
+            frames=std::max(1,atoi(argv[++i]));
+        else
+            files.push_back(arg);
+    }
+
+    if (files.empty())
+        files.push_back("");
+
+    BayerDemosaic demosaic(threads);
+    demosaic.setMethod(method);
+    printf("threads %d, method %s\n",demosaic.getThreads(),method==BayerDemosaic::EDGE_AWARE?"edge":"bilinear");
+
+    int failures=0;
+    for (auto &file:files)
+    {
+        std::vector<unsigned char> raw;
+        int w=640,h=480;
+        if (file.empty())
+            synthetic(raw,w,h);
+        else if (!loadPGM(file,raw,w,h))
+        {
+            printf("%s: cannot read the frame\n",file.c_str());
+            failures++;
+            continue;
+        }
+
+        std::vector<unsigned char> ref(3*(size_t)w*h),out(3*(size_t)w*h);
+        dc1394color_filter_t filter=(dc1394color_filter_t)(DC1394_COLOR_FILTER_MIN+pattern);
+
+        double t0=now();
+        for (int n=0; n<frames; n++)
+            dc1394_bayer_decoding_8bit(raw.data(),ref.data(),w,h,filter,DC1394_BAYER_METHOD_BILINEAR);
+        double t1=now();
+        for (int n=0; n<frames; n++)
+            demosaic.apply(raw.data(),w,w,h,pattern,out.data(),3*w);
+        double t2=now();
+
+        size_t diff=0;
+        int maxDiff=0;
+        for (size_t i=0; i<ref.size(); i++)
+        {
+            int d=std::abs(ref[i]-out[i]);
+            if (d)
+            {
+                diff++;
+                maxDiff=std::max(maxDiff,d);
+            }
+        }
+
+        if (diff && (method==BayerDemosaic::BILINEAR))
+            failures++;
+
+        printf("%s %dx%d: %zu values differ (max %d), dc1394 %.3f ms, BayerDemosaic %.3f ms\n",
+               file.empty()?"synthetic":file.c_str(),w,h,diff,maxDiff,
+               1000.0*(t1-t0)/frames,1000.0*(t2-t1)/frames);
+    }
+
+    return failures?1:0;
+}
@@ -193,6 +193,11 @@ bool embObjIMU::getThreeAxisGyroscopeMeasure(size_t sens_index, yarp::sig::Vecto
     return GET_privData(mPriv).sens.getSensorMeasure(sens_index, eoas_imu_gyr, out, timestamp);
 }
 
+bool embObjIMU::getThreeAxisGyroscopeSamples(size_t sens_index, uint64_t& after, std::vector<imuHistory_t::Sample>& samples, uint64_t& lost) const
+{
+    return GET_privData(mPriv).sens.getSensorSamples(sens_index, eoas_imu_gyr, after, samples, lost);
+}
+
 size_t embObjIMU::getNrOfThreeAxisLinearAccelerometers() const
 {
     return GET_privData(mPriv).sens.getNumOfSensors(eoas_imu_acc);
@@ -218,6 +223,11 @@ bool embObjIMU::getThreeAxisLinearAccelerometerMeasure(size_t sens_index, yarp::
     return GET_privData(mPriv).sens.getSensorMeasure(sens_index, eoas_imu_acc, out, timestamp);
 }
 
+bool embObjIMU::getThreeAxisLinearAccelerometerSamples(size_t sens_index, uint64_t& after, std::vector<imuHistory_t::Sample>& samples, uint64_t& lost) const
+{
+    return GET_privData(mPriv).sens.getSensorSamples(sens_index, eoas_imu_acc, after, samples, lost);
+}
+
 size_t embObjIMU::getNrOfThreeAxisMagnetometers() const
 {
     return GET_privData(mPriv).sens.getNumOfSensors(eoas_imu_mag);
@@ -243,6 +253,11 @@ bool embObjIMU::getThreeAxisMagnetometerMeasure(size_t sens_index, yarp::sig::Ve
     return GET_privData(mPriv).sens.getSensorMeasure(sens_index, eoas_imu_mag, out, timestamp);
 }
 
+bool embObjIMU::getThreeAxisMagnetometerSamples(size_t sens_index, uint64_t& after, std::vector<imuHistory_t::Sample>& samples, uint64_t& lost) const
+{
+    return GET_privData(mPriv).sens.getSensorSamples(sens_index, eoas_imu_mag, after, samples, lost);
+}
+
 size_t embObjIMU::getNrOfOrientationSensors() const
 {
     return GET_privData(mPriv).sens.getNumOfSensors(eoas_imu_eul);
@@ -269,6 +284,11 @@ bool embObjIMU::getOrientationSensorMeasureAsRollPitchYaw(size_t sens_index, yar
     
 }
 
+bool embObjIMU::getOrientationSensorSamplesAsRollPitchYaw(size_t sens_index, uint64_t& after, std::vector<imuHistory_t::Sample>& samples, uint64_t& lost) const
+{
+    return GET_privData(mPriv).sens.getSensorSamples(sens_index, eoas_imu_eul, after, samples, lost);
+}
+
 
 bool embObjIMU::initialised()
 {
@@ -11,11 +11,13 @@
 #define __embObjIMU_h__
 
 #include <string>
+#include <vector>
 #include <yarp/dev/DeviceDriver.h>
 
 #include <yarp/dev/MultipleAnalogSensorsInterfaces.h>
 
 #include "IethResource.h"
+#include "sampleHistory.h"
 
 
 
@@ -41,6 +43,14 @@ namespace yarp {
     }
 }
 
+// a measure as kept in the history of a sensor: x, y, z as given by the Measure methods
+typedef struct
+{
+    double values[3];
+} imuSample_t;
+
+typedef eth::SampleHistory<imuSample_t> imuHistory_t;
+
 class yarp::dev::embObjIMU :            public DeviceDriver,
                                         public yarp::dev::IThreeAxisGyroscopes,
                                         public yarp::dev::IThreeAxisLinearAccelerometers,
@@ -85,6 +95,14 @@ public:
     virtual bool getOrientationSensorFrameName(size_t sens_index, std::string &frameName) const override;
     virtual bool getOrientationSensorMeasureAsRollPitchYaw(size_t sens_index, yarp::sig::Vector& rpy, double& timestamp) const override;
 
+    /* lossless access to the measures: all those received after the one with sequence number after (0 for all
+     * those kept), oldest first. after is moved to the last one returned and lost tells how many were
+     * overwritten before being read */
+    bool getThreeAxisGyroscopeSamples(size_t sens_index, uint64_t& after, std::vector<imuHistory_t::Sample>& samples, uint64_t& lost) const;
+    bool getThreeAxisLinearAccelerometerSamples(size_t sens_index, uint64_t& after, std::vector<imuHistory_t::Sample>& samples, uint64_t& lost) const;
+    bool getThreeAxisMagnetometerSamples(size_t sens_index, uint64_t& after, std::vector<imuHistory_t::Sample>& samples, uint64_t& lost) const;
+    bool getOrientationSensorSamplesAsRollPitchYaw(size_t sens_index, uint64_t& after, std::vector<imuHistory_t::Sample>& samples, uint64_t& lost) const;
+
 
     /* Iethresource methods */
     virtual bool initialised();
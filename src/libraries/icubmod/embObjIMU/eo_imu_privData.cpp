@@ -115,6 +115,7 @@ SensorsData::SensorsData()
     errorstring = "embObjIMU";
 
     mysens.resize(eoas_sensors_numberof);
+    history.resize(eoas_sensors_numberof);
     for(int t=0; t<eoas_sensors_numberof; t++)
     { mysens[t].resize(0); }
 }
@@ -149,6 +150,7 @@ void SensorsData::init(servConfigImu_t &servCfg, string error_string)
                     newSensor.values.resize(3);
                 newSensor.state = 0;
                 mysens[des->typeofsensor].push_back(newSensor);
+                history[des->typeofsensor].emplace_back(historyCapacity);
             }
         }
     }
@@ -254,19 +256,59 @@ bool SensorsData::getSensorMeasure(size_t sens_index, eOas_sensor_t type, yarp::
 
 bool SensorsData::update(eOas_sensor_t type, uint8_t index, eOas_inertial3_data_t *newdata)
 {
-    std::lock_guard<std::mutex> lck (mutex);
+    double now = yarp::os::Time::now();
 
-    sensorInfo_t *info = &(mysens[type][index]);
+    {
+        std::lock_guard<std::mutex> lck (mutex);
+
+        sensorInfo_t *info = &(mysens[type][index]);
+
+        info->values[0] = newdata->x;
+        info->values[1] = newdata->y;
+        info->values[2] = newdata->z;
+        info->timestamp = now;
+    }
 
-    info->values[0] = newdata->x;
-    info->values[1] = newdata->y;
-    info->values[2] = newdata->z;
-    info->timestamp = yarp::os::Time::now();
+    // the history is kept raw: the conversion is done by the reader
+    imuSample_t sample = {{(double)newdata->x, (double)newdata->y, (double)newdata->z}};
+    history[type][index].push(now, sample);
 
     return true;
 
 }
 
+double SensorsData::raw2metric(eOas_sensor_t type, double value) const
+{
+    switch(type)
+    {
+        case eoas_imu_acc: return measConverter.convertAcc_raw2metric(value);
+        case eoas_imu_mag: return measConverter.convertMag_raw2metric(value);
+        case eoas_imu_gyr: return measConverter.convertGyr_raw2metric(value);
+        case eoas_imu_eul: return measConverter.convertEul_raw2metric(value);
+        default: return value;
+    };
+}
+
+bool SensorsData::getSensorSamples(size_t sens_index, eOas_sensor_t type, uint64_t& after, std::vector<imuHistory_t::Sample>& samples, uint64_t& lost) const
+{
+    lost = 0;
+    try
+    {
+        size_t first = samples.size();
+        after = history[type].at(sens_index).read(after, samples, lost);
+        for(size_t s=first; s<samples.size(); s++)
+        {
+            for(int i=0; i<3; i++)
+                samples[s].value.values[i] = raw2metric(type, samples[s].value.values[i]);
+        }
+    }
+    catch (const std::out_of_range& oor)
+    {
+        return outOfRangeErrorHandler(oor);
+    }
+    return true;
+}
+
 bool SensorsData::updateStatus(eOas_sensor_t type, uint8_t index, eOas_inertial3_sensorstatus_t &status)
 {
     std::lock_guard<std::mutex> lck (mutex);
@@ -10,6 +10,7 @@
 #define __eo_imu_privData_h__
 
 #include "embObjGeneralDevPrivData.h"
+#include "embObjIMU.h"
 #include "imuMeasureConverter.h"
 #include <yarp/sig/Vector.h>
 #include <mutex>
@@ -55,9 +56,14 @@ class yarp::dev::SensorsData
 {
 private:
     std::vector<std::vector<sensorInfo_t>> mysens;
+    std::vector<std::vector<imuHistory_t>> history; // as mysens, filled by update() and read without mutex
     mutable std::mutex mutex;
     string errorstring;
 
+    enum { historyCapacity = 1024 };    // about one second at the highest rate of the boards
+
+    double raw2metric(eOas_sensor_t type, double value) const;
+
 public:
     ImuMeasureConverter measConverter;
     SensorsData();
@@ -71,6 +77,7 @@ public:
     bool getSensorName(size_t sens_index, eOas_sensor_t type, std::string &name) const;
     bool getSensorFrameName(size_t sens_index, eOas_sensor_t type, std::string &frameName) const;
     bool getSensorMeasure(size_t sens_index, eOas_sensor_t type, yarp::sig::Vector& out, double& timestamp) const;
+    bool getSensorSamples(size_t sens_index, eOas_sensor_t type, uint64_t& after, std::vector<imuHistory_t::Sample>& samples, uint64_t& lost) const;
 };
 
 
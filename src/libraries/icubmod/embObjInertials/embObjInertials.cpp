@@ -514,6 +514,12 @@ bool embObjInertials::open(yarp::os::Searchable &config)
         }
     }
 
+    history.resize(serviceConfig.inertials.size());
+    for(size_t i=0; i<history.size(); i++)
+    {
+        history[i].reset(historyCapacity);
+    }
+
     opened = true;
     return true;
 }
@@ -728,6 +734,11 @@ bool embObjInertials::update(eOprotID32_t id32, double timestamp, void* rxdata)
         return(true);
     }
 
+    // the history has its own synchronization. it is stamped with the time of reception, as the histories of
+    // embObjIMU and embObjMultipleFTsensors, because the board time has a different base and unit
+    inertialSample_t sample = {{(double) status->data.x, (double) status->data.y, (double) status->data.z}};
+    history[status->data.id].push(timestamp, sample);
+
     std::lock_guard<std::mutex> lck(mtx);
 
 #if defined(EMBOBJINERTIALS_PUBLISH_OLDSTYLE)
@@ -852,6 +863,23 @@ bool embObjInertials::getThreeAxisGyroscopeMeasure(size_t sens_index, yarp::sig:
     return true;
 }
 
+bool embObjInertials::getThreeAxisGyroscopeSamples(size_t sens_index, uint64_t& after, std::vector<inertialHistory_t::Sample>& samples, uint64_t& lost) const
+{
+    lost = 0;
+    if(false == opened)
+    {
+        return false;
+    }
+
+    if(sens_index>= gyrSensors.size())
+    {
+        return false;
+    }
+
+    after = history[gyrSensors[sens_index]].read(after, samples, lost);
+    return true;
+}
+
 /* IThreeAxisLinearAccelerometers methods */
 size_t embObjInertials::getNrOfThreeAxisLinearAccelerometers() const
 {
@@ -902,6 +930,23 @@ bool embObjInertials::getThreeAxisLinearAccelerometerMeasure(size_t sens_index,
     return true;
 }
 
+bool embObjInertials::getThreeAxisLinearAccelerometerSamples(size_t sens_index, uint64_t& after, std::vector<inertialHistory_t::Sample>& samples, uint64_t& lost) const
+{
+    lost = 0;
+    if(false == opened)
+    {
+        return false;
+    }
+
+    if(sens_index>= accSensors.size())
+    {
+        return false;
+    }
+
+    after = history[accSensors[sens_index]].read(after, samples, lost);
+    return true;
+}
+
 
 // eof
 
@@ -16,6 +16,7 @@
 #include "IethResource.h"
 #include <ethManager.h>
 #include <abstractEthResource.h>
+#include "sampleHistory.h"
 
 
 #include "FeatureInterface.h"  
@@ -38,6 +39,15 @@ namespace yarp {
 #define EMBOBJINERTIALS_PUBLISH_OLDSTYLE
 
 
+// a measure as kept in the history of a sensor: x, y, z as given by the Measure methods
+typedef struct
+{
+    double values[3];
+} inertialSample_t;
+
+typedef eth::SampleHistory<inertialSample_t> inertialHistory_t;
+
+
 // -- class embObjInertials
 class yarp::dev::embObjInertials:       public yarp::dev::IAnalogSensor,
                                         public yarp::dev::DeviceDriver,
@@ -95,6 +105,13 @@ public:
     virtual bool getThreeAxisLinearAccelerometerFrameName(size_t sens_index, std::string &frameName) const override;
     virtual bool getThreeAxisLinearAccelerometerMeasure(size_t sens_index, yarp::sig::Vector& out, double& timestamp) const override;
 
+    // lossless access to the measures: all those received after the one with sequence number after (0 for all
+    // those kept), oldest first. after is moved to the last one returned and lost tells how many were
+    // overwritten before being read. the timestamp of the samples is their reception time, in seconds on the
+    // yarp clock, as for the other sensors
+    bool getThreeAxisGyroscopeSamples(size_t sens_index, uint64_t& after, std::vector<inertialHistory_t::Sample>& samples, uint64_t& lost) const;
+    bool getThreeAxisLinearAccelerometerSamples(size_t sens_index, uint64_t& after, std::vector<inertialHistory_t::Sample>& samples, uint64_t& lost) const;
+
 
 private:
 
@@ -122,6 +139,9 @@ private:
     vector<double> analogdata;
     vector<uint16_t> gyrSensors;
     vector<uint16_t> accSensors;
+    vector<inertialHistory_t> history;     // one per configured sensor, filled by update() and read without mtx
+
+    enum { historyCapacity = 1024 };        // about one second at the highest rate of the boards
 
 
     short status;
@@ -348,6 +348,13 @@ void feat_manage_diagnostic(eOmn_info_basic_t* infobasic, uint8_t * extra, const
         yError("the diagnostic service can not start. The interface to the eth manager is not working.");
         return;
     }
+
+    // we are in the receiver thread: if possible we leave the parsing and the logging to the diagnostic thread
+    if(_interface2ethManager->deferDiagnostic(eo_nv_GetIP(nv), infobasic, extra))
+    {
+        return;
+    }
+
     Diagnostic::LowLevel::InfoFormatter dngFormatter(_interface2ethManager, infobasic, extra, nv, rd);
 
     Diagnostic::EmbeddedInfo info;
@@ -78,6 +78,8 @@ namespace eth {
 
         virtual bool setcheckRemoteValue(const eOprotID32_t id32, void *value, const unsigned int retries = 10, const double waitbeforecheck = 0.001, const double timeout = 0.050) = 0;
 
+        virtual bool setcheckRemoteValues(const std::vector<eOprotID32_t> &id32s, const std::vector<const void*> &values, const unsigned int retries = 10, const double waitbeforecheck = 0.001, const double timeout = 0.050) = 0;
+
         virtual bool getLocalValue(const eOprotID32_t id32, void *value) = 0;
 
         virtual bool setLocalValue(eOprotID32_t id32, const void *value, bool overrideROprotection = false) = 0;
@@ -0,0 +1,235 @@
+/*
+ * Copyright (C) 2022 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+
+#include <asyncEthResource.h>
+
+#include <yarp/os/LogStream.h>
+
+
+using namespace eth;
+
+
+AsyncEthResource::AsyncEthResource(eth::AbstractEthResource *res) : res(res), state(State::idle)
+{
+}
+
+
+AsyncEthResource::~AsyncEthResource()
+{
+    if(worker.joinable())
+    {
+        worker.join();
+    }
+}
+
+
+bool AsyncEthResource::start(std::function<bool()> bringup)
+{
+    std::lock_guard<std::mutex> lck(mtx);
+
+    if(State::idle != state)
+    {
+        yError() << "AsyncEthResource::start() called twice for BOARD" << res->getProperties().boardnameString;
+        return false;
+    }
+
+    state = State::running;
+
+    // the new thread starts only after the lock is released, hence after worker holds its id
+    worker = std::thread([this, bringup]()
+    {
+        {
+            std::lock_guard<std::mutex> lck(mtx);
+        }
+
+        bool ok = bringup();
+
+        std::lock_guard<std::mutex> lck(mtx);
+        state = ok ? State::succeeded : State::failed;
+        cv.notify_all();
+    });
+
+    return true;
+}
+
+
+bool AsyncEthResource::wait()
+{
+    std::unique_lock<std::mutex> lck(mtx);
+
+    if(std::this_thread::get_id() == worker.get_id())
+    {
+        yError() << "AsyncEthResource::wait() called by the bring-up of BOARD" << res->getProperties().boardnameString;
+        return false;
+    }
+
+    cv.wait(lck, [this]() { return State::running != state; });
+
+    return State::failed != state;
+}
+
+
+eth::AbstractEthResource * AsyncEthResource::resource()
+{
+    return res;
+}
+
+
+bool AsyncEthResource::ready()
+{
+    std::unique_lock<std::mutex> lck(mtx);
+
+    if(std::this_thread::get_id() == worker.get_id())
+    {
+        return true;
+    }
+
+    cv.wait(lck, [this]() { return State::running != state; });
+
+    return State::failed != state;
+}
+
+
+// the calls which do not need the board go straight to the resource
+
+bool AsyncEthResource::open2(eOipv4addr_t remIP, yarp::os::Searchable &cfgtotal)
+{
+    return res->open2(remIP, cfgtotal);
+}
+
+
+bool AsyncEthResource::close()
+{
+    return res->close();
+}
+
+
+const AbstractEthResource::Properties & AsyncEthResource::getProperties()
+{
+    return res->getProperties();
+}
+
+
+const void * AsyncEthResource::getUDPtransmit(eOipv4addressing_t &destination, size_t &sizeofpacket, uint16_t &numofrops)
+{
+    return res->getUDPtransmit(destination, sizeofpacket, numofrops);
+}
+
+
+bool AsyncEthResource::processRXpacket(const void *data, const size_t size)
+{
+    return res->processRXpacket(data, size);
+}
+
+
+bool AsyncEthResource::CANPrintHandler(eOmn_info_basic_t* infobasic)
+{
+    return res->CANPrintHandler(infobasic);
+}
+
+
+bool AsyncEthResource::Tick()
+{
+    return res->Tick();
+}
+
+
+bool AsyncEthResource::Check()
+{
+    return res->Check();
+}
+
+
+bool AsyncEthResource::isFake()
+{
+    return res->isFake();
+}
+
+
+HostTransceiver * AsyncEthResource::getTransceiver()
+{
+    return res->getTransceiver();
+}
+
+
+// the calls which need the board wait for its bring-up
+
+bool AsyncEthResource::getRemoteValue(const eOprotID32_t id32, void *value, const double timeout, const unsigned int retries)
+{
+    return ready() && res->getRemoteValue(id32, value, timeout, retries);
+}
+
+
+bool AsyncEthResource::getRemoteValues(const std::vector<eOprotID32_t> &id32s, const std::vector<void*> &values, const double timeout)
+{
+    return ready() && res->getRemoteValues(id32s, values, timeout);
+}
+
+
+bool AsyncEthResource::setRemoteValue(const eOprotID32_t id32, void *value)
+{
+    return ready() && res->setRemoteValue(id32, value);
+}
+
+
+bool AsyncEthResource::setcheckRemoteValue(const eOprotID32_t id32, void *value, const unsigned int retries, const double waitbeforecheck, const double timeout)
+{
+    return ready() && res->setcheckRemoteValue(id32, value, retries, waitbeforecheck, timeout);
+}
+
+
+bool AsyncEthResource::setcheckRemoteValues(const std::vector<eOprotID32_t> &id32s, const std::vector<const void*> &values, const unsigned int retries, const double waitbeforecheck, const double timeout)
+{
+    return ready() && res->setcheckRemoteValues(id32s, values, retries, waitbeforecheck, timeout);
+}
+
+
+bool AsyncEthResource::getLocalValue(const eOprotID32_t id32, void *value)
+{
+    return ready() && res->getLocalValue(id32, value);
+}
+
+
+bool AsyncEthResource::setLocalValue(eOprotID32_t id32, const void *value, bool overrideROprotection)
+{
+    return ready() && res->setLocalValue(id32, value, overrideROprotection);
+}
+
+
+bool AsyncEthResource::verifyEPprotocol(eOprot_endpoint_t ep)
+{
+    return ready() && res->verifyEPprotocol(ep);
+}
+
+
+bool AsyncEthResource::serviceVerifyActivate(eOmn_serv_category_t category, const eOmn_serv_parameter_t* param, double timeout)
+{
+    return ready() && res->serviceVerifyActivate(category, param, timeout);
+}
+
+
+bool AsyncEthResource::serviceSetRegulars(eOmn_serv_category_t category, vector<eOprotID32_t> &id32vector, double timeout)
+{
+    return ready() && res->serviceSetRegulars(category, id32vector, timeout);
+}
+
+
+bool AsyncEthResource::serviceStart(eOmn_serv_category_t category, double timeout)
+{
+    return ready() && res->serviceStart(category, timeout);
+}
+
+
+bool AsyncEthResource::serviceStop(eOmn_serv_category_t category, double timeout)
+{
+    return ready() && res->serviceStop(category, timeout);
+}
+
+
+// - end-of-file (leave a blank line after)----------------------------------------------------------------------------
@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2022 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+
+#ifndef _ASYNCETHRESOURCE_H_
+#define _ASYNCETHRESOURCE_H_
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#include <abstractEthResource.h>
+
+
+namespace eth {
+
+    // It lets a device bring up its board in a thread of its own, so that the open() of the device returns
+    // at once and the boards of different devices are brought up at the same time.
+    // The device uses this object in place of the AbstractEthResource it got from TheEthManager.
+    // The calls of the bring-up thread go straight to the resource. The calls of any other thread
+    // which need the board wait for the end of the bring-up and fail if the bring-up has failed.
+    class AsyncEthResource : public eth::AbstractEthResource
+    {
+    public:
+
+        AsyncEthResource(eth::AbstractEthResource *res);
+        // it waits for the end of the bring-up
+        ~AsyncEthResource();
+
+        // it calls bringup() in a new thread. it can be called only once
+        bool start(std::function<bool()> bringup);
+        // it waits for the end of the bring-up and returns its result
+        bool wait();
+        // the resource given by TheEthManager, which is the one to release
+        eth::AbstractEthResource * resource();
+
+        bool open2(eOipv4addr_t remIP, yarp::os::Searchable &cfgtotal) override;
+        bool close() override;
+
+        const Properties & getProperties() override;
+
+        const void * getUDPtransmit(eOipv4addressing_t &destination, size_t &sizeofpacket, uint16_t &numofrops) override;
+        bool processRXpacket(const void *data, const size_t size) override;
+
+        bool getRemoteValue(const eOprotID32_t id32, void *value, const double timeout = 0.100, const unsigned int retries = 0) override;
+        bool getRemoteValues(const std::vector<eOprotID32_t> &id32s, const std::vector<void*> &values, const double timeout = 0.500) override;
+        bool setRemoteValue(const eOprotID32_t id32, void *value) override;
+        bool setcheckRemoteValue(const eOprotID32_t id32, void *value, const unsigned int retries = 10, const double waitbeforecheck = 0.001, const double timeout = 0.050) override;
+        bool setcheckRemoteValues(const std::vector<eOprotID32_t> &id32s, const std::vector<const void*> &values, const unsigned int retries = 10, const double waitbeforecheck = 0.001, const double timeout = 0.050) override;
+
+        bool getLocalValue(const eOprotID32_t id32, void *value) override;
+        bool setLocalValue(eOprotID32_t id32, const void *value, bool overrideROprotection = false) override;
+
+        bool verifyEPprotocol(eOprot_endpoint_t ep) override;
+
+        bool CANPrintHandler(eOmn_info_basic_t* infobasic) override;
+
+        bool serviceVerifyActivate(eOmn_serv_category_t category, const eOmn_serv_parameter_t* param, double timeout = 0.500) override;
+        bool serviceSetRegulars(eOmn_serv_category_t category, vector<eOprotID32_t> &id32vector, double timeout = 0.500) override;
+        bool serviceStart(eOmn_serv_category_t category, double timeout = 0.500) override;
+        bool serviceStop(eOmn_serv_category_t category, double timeout = 0.500) override;
+
+        bool Tick() override;
+        bool Check() override;
+
+        bool isFake() override;
+
+        HostTransceiver * getTransceiver() override;
+
+    private:
+
+        enum class State { idle, running, succeeded, failed };
+
+        // true if the caller may use the board: it is the bring-up thread or the bring-up has succeeded
+        bool ready();
+
+        eth::AbstractEthResource *res;
+        std::thread worker;
+        std::mutex mtx;
+        std::condition_variable cv;
+        State state;
+    };
+
+} // namespace eth
+
+
+#endif  // include-guard
+
+
+// - end-of-file (leave a blank line after)----------------------------------------------------------------------------
@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2022 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+// Cost paid by the receiver thread of a board which floods the same fault,
+// when the diagnostic messages go through the AsyncLogger: the latency of
+// every push into the queue is measured and compared with the time that
+// parsing a message on its own would take, together with the number of
+// messages lost because the queue was full.
+//
+// diagnosticAsyncLoggerBenchmark [--messages 200000] [--capacity 4096] [--threshold 5]
+
+#include <cstdio>
+#include <chrono>
+#include <vector>
+#include <algorithm>
+
+#include <yarp/os/Property.h>
+#include <yarp/os/Time.h>
+#include <yarp/os/Value.h>
+
+#include "EoError.h"
+#include "diagnosticAsyncLogger.h"
+
+using namespace yarp::os;
+using namespace Diagnostic::LowLevel;
+
+
+/***************************************************************************/
+int main(int argc, char *argv[])
+{
+    Property options;
+    options.fromCommand(argc,argv);
+
+    size_t messages=(size_t)options.check("messages",Value(200000)).asInt32();
+    if (messages==0)
+    {
+        printf("messages must be positive\n");
+        return 1;
+    }
+
+    AsyncLogger::Config config;
+    config.capacity=options.check("capacity",Value(4096)).asInt32();
+    config.aggregation.threshold=options.check("threshold",Value(5)).asInt32();
+    AsyncLogger logger(nullptr,config);
+    if (!logger.start())
+    {
+        printf("the logger did not start\n");
+        return 1;
+    }
+
+    const eOerror_code_t code=eoerror_code_get(eoerror_category_MotionControl,eoerror_value_MC_motor_external_fault);
+    const eOipv4addr_t board=eo_common_ipv4addr(10,0,1,1);
+
+    std::vector<double> latency;
+    latency.reserve(messages);
+    eOmn_info_basic_t info{};
+    info.properties.code=code;
+    for (size_t i=0; i<messages; i++)
+    {
+        info.timestamp=i;
+        info.properties.par64=i;
+        auto t0=std::chrono::steady_clock::now();
+        logger.push(board,&info,nullptr);
+        auto t1=std::chrono::steady_clock::now();
+        latency.push_back(std::chrono::duration<double,std::micro>(t1-t0).count());
+
+        // about 100 messages every millisecond
+        if ((i%100)==0)
+            Time::delay(0.001);
+    }
+
+    logger.stop();
+
+    // what the receiver would pay to parse every message on its own
+    Diagnostic::EmbeddedInfo parsed;
+    Record r;
+    info.timestamp=0;
+    info.properties.par64=0;
+    r.fill(0.0,board,&info,nullptr);
+    auto t0=std::chrono::steady_clock::now();
+    for (int i=0; i<1000; i++)
+        AsyncLogger::decode(nullptr,r,parsed);
+    double parse=std::chrono::duration<double,std::micro>(std::chrono::steady_clock::now()-t0).count()/1000;
+
+    std::sort(latency.begin(),latency.end());
+    printf("push latency [us] | median | 99.9%% | max | parsing alone [us] | lost\n");
+    printf("                  | %6.3f | %6.3f | %6.3f | %18.3f | %zu of %zu\n",
+           latency[messages/2],latency[messages*999/1000],latency.back(),parse,
+           logger.dropped(),messages);
+
+    return 0;
+}
@@ -0,0 +1,424 @@
+/*
+ * Copyright (C) Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <string.h>
+#include <yarp/os/Time.h>
+#include <yarp/os/LogStream.h>
+
+#include "diagnosticAsyncLogger.h"
+#include "diagnosticLowLevelFormatter.h"
+
+
+using namespace Diagnostic::LowLevel;
+using namespace Diagnostic;
+
+
+/**************************************************************************************************************************/
+/******************************************        Record       ***************************************************/
+/**************************************************************************************************************************/
+
+void Record::fill(double time, eOipv4addr_t from, const eOmn_info_basic_t *infobasic, const uint8_t *extrabytes)
+{
+    memset(this, 0, sizeof(Record));
+    arrivaltime = time;
+    ipv4 = from;
+    memcpy(&basic, infobasic, sizeof(basic));
+    if(nullptr != extrabytes)
+    {
+        hasextra = 1;
+        memcpy(extra, extrabytes, sizeof(extra));
+    }
+}
+
+
+/**************************************************************************************************************************/
+/******************************************        RecordQueue       ***************************************************/
+/**************************************************************************************************************************/
+
+RecordQueue::RecordQueue(size_t capacity) : enqueuepos(0), dequeuepos(0), numofdropped(0)
+{
+    size_t size = 2;
+    while(size < capacity)
+    {
+        size <<= 1;
+    }
+
+    cells.reset(new Cell[size]);
+    for(size_t i=0; i<size; i++)
+    {
+        cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    mask = size-1;
+}
+
+
+bool RecordQueue::push(const Record &record)
+{
+    Cell *cell = nullptr;
+    size_t pos = enqueuepos.load(std::memory_order_relaxed);
+    for(;;)
+    {
+        cell = &cells[pos & mask];
+        size_t seq = cell->sequence.load(std::memory_order_acquire);
+        intptr_t dif = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+        if(0 == dif)
+        {   // the cell is free: we take it unless another producer is faster
+            if(enqueuepos.compare_exchange_weak(pos, pos+1, std::memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else if(dif < 0)
+        {   // the consumer has not yet freed the cell: the queue is full
+            numofdropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        else
+        {
+            pos = enqueuepos.load(std::memory_order_relaxed);
+        }
+    }
+
+    // memcpy() also copies the padding, which the journal saves
+    memcpy(&cell->record, &record, sizeof(Record));
+    cell->sequence.store(pos+1, std::memory_order_release);
+    return true;
+}
+
+
+bool RecordQueue::pop(Record &record)
+{
+    Cell *cell = nullptr;
+    size_t pos = dequeuepos.load(std::memory_order_relaxed);
+    for(;;)
+    {
+        cell = &cells[pos & mask];
+        size_t seq = cell->sequence.load(std::memory_order_acquire);
+        intptr_t dif = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos+1);
+        if(0 == dif)
+        {
+            if(dequeuepos.compare_exchange_weak(pos, pos+1, std::memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else if(dif < 0)
+        {   // empty
+            return false;
+        }
+        else
+        {
+            pos = dequeuepos.load(std::memory_order_relaxed);
+        }
+    }
+
+    memcpy(&record, &cell->record, sizeof(Record));
+    cell->sequence.store(pos+mask+1, std::memory_order_release);
+    return true;
+}
+
+
+/**************************************************************************************************************************/
+/******************************************        Aggregator       ***************************************************/
+/**************************************************************************************************************************/
+
+Aggregator::Key Aggregator::keyOf(const Record &record)
+{
+    uint16_t source = (EOMN_INFO_PROPERTIES_FLAGS_get_source(record.basic.properties.flags) << 8) |
+                      EOMN_INFO_PROPERTIES_FLAGS_get_address(record.basic.properties.flags);
+    return Key(record.ipv4, record.basic.properties.code, source);
+}
+
+
+bool Aggregator::admit(const Record &record, double now)
+{
+    if(0 == config.threshold)
+    {
+        return true;
+    }
+
+    Key key = keyOf(record);
+    auto it = windows.find(key);
+    if(it == windows.end())
+    {
+        windows.emplace(key, Window{now, 1, record});
+        return true;
+    }
+
+    Window &w = it->second;
+    w.count++;
+    if(w.count <= config.threshold)
+    {
+        return true;
+    }
+
+    w.last = record;
+    return false;
+}
+
+
+void Aggregator::expire(double now, std::vector<Summary> &summaries)
+{
+    for(auto it = windows.begin(); it != windows.end();)
+    {
+        const Window &w = it->second;
+        if((now - w.start) < config.window)
+        {
+            ++it;
+            continue;
+        }
+
+        if(w.count > config.threshold)
+        {
+            summaries.push_back(Summary{w.last, w.count - config.threshold, now - w.start});
+        }
+        it = windows.erase(it);
+    }
+}
+
+
+void Aggregator::flush(double now, std::vector<Summary> &summaries)
+{
+    for(auto &item : windows)
+    {
+        const Window &w = item.second;
+        if(w.count > config.threshold)
+        {
+            summaries.push_back(Summary{w.last, w.count - config.threshold, now - w.start});
+        }
+    }
+    windows.clear();
+}
+
+
+/**************************************************************************************************************************/
+/******************************************        Journal       ***************************************************/
+/**************************************************************************************************************************/
+
+bool Journal::create(const std::string &filename)
+{
+    close();
+
+    file = fopen(filename.c_str(), "wb");
+    if(nullptr == file)
+    {
+        return false;
+    }
+
+    Header header {magic, version, sizeof(Record)};
+    if(1 != fwrite(&header, sizeof(header), 1, file))
+    {
+        close();
+        return false;
+    }
+
+    return true;
+}
+
+
+bool Journal::open(const std::string &filename)
+{
+    close();
+
+    file = fopen(filename.c_str(), "rb");
+    if(nullptr == file)
+    {
+        return false;
+    }
+
+    Header header {0, 0, 0};
+    if((1 != fread(&header, sizeof(header), 1, file)) ||
+       (magic != header.magic) || (version != header.version) || (sizeof(Record) != header.recordsize))
+    {
+        close();
+        return false;
+    }
+
+    return true;
+}
+
+
+bool Journal::write(const Record &record)
+{
+    return (nullptr != file) && (1 == fwrite(&record, sizeof(Record), 1, file));
+}
+
+
+bool Journal::read(Record &record)
+{
+    return (nullptr != file) && (1 == fread(&record, sizeof(Record), 1, file));
+}
+
+
+void Journal::flush()
+{
+    if(nullptr != file)
+    {
+        fflush(file);
+    }
+}
+
+
+void Journal::close()
+{
+    if(nullptr != file)
+    {
+        fclose(file);
+        file = nullptr;
+    }
+}
+
+
+/**************************************************************************************************************************/
+/******************************************        AsyncLogger       ***************************************************/
+/**************************************************************************************************************************/
+
+AsyncLogger::AsyncLogger(eth::TheEthManager* ethManager, const Config &config) :
+        yarp::os::PeriodicThread(config.period), ethManager(ethManager), config(config), queue(config.capacity), reporteddrops(0)
+{
+    aggregator.config = config.aggregation;
+}
+
+
+AsyncLogger::~AsyncLogger()
+{
+    // threadRelease() must run while the object is still whole
+    if(isRunning())
+    {
+        stop();
+    }
+}
+
+
+bool AsyncLogger::push(eOipv4addr_t ipv4, const eOmn_info_basic_t *infobasic, const uint8_t *extra)
+{
+    Record record;
+    record.fill(yarp::os::Time::now(), ipv4, infobasic, extra);
+    return queue.push(record);
+}
+
+
+bool AsyncLogger::lock(bool on)
+{
+    if(on)
+    {
+        decoding.lock();
+    }
+    else
+    {
+        decoding.unlock();
+    }
+
+    return true;
+}
+
+
+void AsyncLogger::decode(eth::TheEthManager* ethManager, const Record &record, EmbeddedInfo &info)
+{
+    // the formatter wants non const pointers and a verbal extra terminated by zero
+    eOmn_info_basic_t basic = record.basic;
+    char extra[sizeof(record.extra)+1] = {0};
+    memcpy(extra, record.extra, sizeof(record.extra));
+
+    InfoFormatter formatter(ethManager, record.ipv4, &basic, (0 != record.hasextra) ? (reinterpret_cast<uint8_t*>(extra)) : (nullptr));
+    formatter.getDiagnosticInfo(info);
+}
+
+
+bool AsyncLogger::threadInit()
+{
+    if(!config.journal.empty())
+    {
+        if(journal.create(config.journal))
+        {
+            yInfo() << "AsyncLogger: the diagnostic messages are saved in" << config.journal;
+        }
+        else
+        {
+            yWarning() << "AsyncLogger: cannot create the diagnostic journal" << config.journal << "thus the messages are only logged";
+        }
+    }
+
+    return true;
+}
+
+
+void AsyncLogger::run()
+{
+    drain(yarp::os::Time::now());
+}
+
+
+void AsyncLogger::threadRelease()
+{
+    double now = yarp::os::Time::now();
+    drain(now);
+
+    std::lock_guard<std::mutex> lck(decoding);
+    summaries.clear();
+    aggregator.flush(now, summaries);
+    for(auto &s : summaries)
+    {
+        log(s);
+    }
+
+    journal.close();
+}
+
+
+void AsyncLogger::drain(double now)
+{
+    std::lock_guard<std::mutex> lck(decoding);
+
+    summaries.clear();
+    aggregator.expire(now, summaries);
+    for(auto &s : summaries)
+    {
+        log(s);
+    }
+
+    // no more than a queue at each cycle, so that a flood does not keep the thread here forever
+    Record record;
+    for(size_t n=0; (n < queue.capacity()) && queue.pop(record); n++)
+    {
+        journal.write(record);
+        if(aggregator.admit(record, record.arrivaltime))
+        {
+            log(record);
+        }
+    }
+
+    journal.flush();
+
+    size_t drops = queue.dropped();
+    if(drops != reporteddrops)
+    {
+        yWarning() << "AsyncLogger: lost" << drops - reporteddrops << "diagnostic messages because the queue of" << queue.capacity() << "messages was full";
+        reporteddrops = drops;
+    }
+}
+
+
+void AsyncLogger::log(const Record &record)
+{
+    EmbeddedInfo info;
+    decode(ethManager, record, info);
+    info.printMessage();
+}
+
+
+void AsyncLogger::log(const Aggregator::Summary &summary)
+{
+    EmbeddedInfo info;
+    decode(ethManager, summary.last, info);
+
+    std::string str_toi;
+    info.timeOfInfo.toString(str_toi);
+    yWarning() << "from BOARD" << info.sourceBoardIpAddrStr << "(" << info.sourceBoardName << ") suppressed" << summary.suppressed
+               << "similar messages in the last" << summary.duration << "s, the last one at time=" << str_toi << ":" << info.finalMessage;
+}
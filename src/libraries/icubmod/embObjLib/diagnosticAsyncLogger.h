@@ -0,0 +1,223 @@
+/*
+ * Copyright (C) Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+
+#ifndef __diagnosticAsyncLogger_h__
+#define __diagnosticAsyncLogger_h__
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <vector>
+#include <stdio.h>
+
+#include <yarp/os/PeriodicThread.h>
+
+#include "EoManagement.h"
+#include "diagnosticInfo.h"
+
+
+namespace eth {
+    class TheEthManager;
+}
+
+namespace Diagnostic {
+    namespace LowLevel {
+        struct Record;
+        class RecordQueue;
+        class Aggregator;
+        class Journal;
+        class AsyncLogger;
+    }
+}
+
+
+// A diagnostic message as it arrives from a board, before any parsing. It has a fixed size so that
+// the receiver thread copies it into the queue without allocating and the journal stores it as it is.
+struct Diagnostic::LowLevel::Record
+{
+    double              arrivaltime;    // host time of reception (yarp::os::Time::now())
+    eOipv4addr_t        ipv4;           // the board which sent the message
+    uint32_t            hasextra;       // 1 if extra holds the extra bytes of the message
+    eOmn_info_basic_t   basic;
+    char                extra[sizeof(eOmn_info_status_t::extra)];
+
+    // it also zeroes the padding, so that the journal is reproducible
+    void fill(double time, eOipv4addr_t from, const eOmn_info_basic_t *infobasic, const uint8_t *extrabytes);
+};
+
+
+// Bounded multi-producer single-consumer queue of records which never blocks nor allocates.
+// Every cell carries a sequence number telling whether it is free for the producers or ready for
+// the consumer (D. Vyukov's bounded queue). When the queue is full the record is dropped and counted.
+class Diagnostic::LowLevel::RecordQueue
+{
+public:
+    // the capacity is rounded up to a power of two
+    RecordQueue(size_t capacity);
+    RecordQueue() = delete;
+    RecordQueue(const RecordQueue &) = delete;
+    RecordQueue & operator=(const RecordQueue &) = delete;
+    ~RecordQueue(){;};
+
+    bool push(const Record &record);
+    bool pop(Record &record);
+
+    size_t capacity() const { return mask+1; }
+    size_t dropped() const { return numofdropped.load(std::memory_order_relaxed); }
+
+private:
+    struct Cell
+    {
+        std::atomic<size_t> sequence;
+        Record record;
+    };
+
+    std::unique_ptr<Cell[]> cells;
+    size_t mask;
+    std::atomic<size_t> enqueuepos;
+    std::atomic<size_t> dequeuepos;
+    std::atomic<size_t> numofdropped;
+};
+
+
+// Rate limiter of the diagnostic messages. It generalises mced::mcEventDownsampler to every message:
+// the messages are grouped by board, error code and source (local, CAN port and address) and within
+// each window only the first config.threshold messages of a group are logged. The others are counted
+// and, when the window expires, reported in one summary together with the last of them.
+class Diagnostic::LowLevel::Aggregator
+{
+public:
+    struct Config
+    {
+        double window {1.0};
+        size_t threshold {10};   // 0 disables the rate limiting
+    };
+
+    struct Summary
+    {
+        Record last;            // the last suppressed message
+        size_t suppressed;
+        double duration;        // of the window
+    };
+
+    Config config;
+
+    // tells whether the record must be logged, otherwise it is accounted for in its window
+    bool admit(const Record &record, double now);
+
+    // closes the windows expired at time now and appends a summary for those which suppressed messages
+    void expire(double now, std::vector<Summary> &summaries);
+
+    // closes all the windows
+    void flush(double now, std::vector<Summary> &summaries);
+
+private:
+    typedef std::tuple<eOipv4addr_t, uint32_t, uint16_t> Key;
+
+    struct Window
+    {
+        double start;
+        size_t count;
+        Record last;
+    };
+
+    std::map<Key, Window> windows;
+
+    static Key keyOf(const Record &record);
+};
+
+
+// Binary file of records. It starts with a header (magic, version, size of the record) followed by
+// the records as they are in memory, hence it is read back on machines of the same architecture.
+class Diagnostic::LowLevel::Journal
+{
+public:
+    enum { magic = 0x4a474449, version = 1 };   // "IDGJ"
+
+    Journal() : file(nullptr) {;}
+    Journal(const Journal &) = delete;
+    Journal & operator=(const Journal &) = delete;
+    ~Journal() { close(); }
+
+    bool create(const std::string &filename);
+    bool open(const std::string &filename);
+    bool isOpen() const { return (nullptr != file); }
+
+    bool write(const Record &record);
+    bool read(Record &record);
+    void flush();
+    void close();
+
+private:
+    struct Header
+    {
+        uint32_t magic;
+        uint16_t version;
+        uint16_t recordsize;
+    };
+
+    FILE* file;
+};
+
+
+// It moves the handling of the diagnostic messages away from the receiver thread, which only copies
+// them into a RecordQueue with push(). This thread drains the queue, rate limits the messages with an
+// Aggregator, parses and logs them, and optionally saves them in a Journal.
+class Diagnostic::LowLevel::AsyncLogger : public yarp::os::PeriodicThread
+{
+public:
+    struct Config
+    {
+        double period {0.010};
+        size_t capacity {1024};
+        Aggregator::Config aggregation;
+        std::string journal {""};   // no journal if empty
+    };
+
+    // ethManager provides the names of boards and axes and can be nullptr
+    AsyncLogger(eth::TheEthManager* ethManager, const Config &config);
+    AsyncLogger() = delete;
+    ~AsyncLogger();
+
+    // called by the receiver thread. it returns false if the queue is full and the message is lost
+    bool push(eOipv4addr_t ipv4, const eOmn_info_basic_t *infobasic, const uint8_t *extra);
+
+    // held by the thread while it parses the messages. hold it when removing an interface which the
+    // parsers could use to find the name of an entity
+    bool lock(bool on);
+
+    size_t dropped() const { return queue.dropped(); }
+
+    // it parses a record into the info printed by the logger
+    static void decode(eth::TheEthManager* ethManager, const Record &record, Diagnostic::EmbeddedInfo &info);
+
+protected:
+    bool threadInit() override;
+    void run() override;
+    void threadRelease() override;
+
+private:
+    eth::TheEthManager* ethManager;
+    Config config;
+    RecordQueue queue;
+    Aggregator aggregator;
+    Journal journal;
+    std::mutex decoding;
+    size_t reporteddrops;
+    std::vector<Aggregator::Summary> summaries;
+
+    void drain(double now);
+    void log(const Record &record);
+    void log(const Aggregator::Summary &summary);
+};
+
+#endif //__diagnosticAsyncLogger_h__
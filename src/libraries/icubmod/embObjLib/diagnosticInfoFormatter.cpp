@@ -17,7 +17,11 @@ using namespace Diagnostic;
 
 
 InfoFormatter::InfoFormatter(eth::TheEthManager* ethManager, eOmn_info_basic_t* infobasic, uint8_t * extra, const EOnv* nv, const eOropdescriptor_t* rd) :
-        m_ethManager(ethManager),m_infobasic(infobasic), m_extra(extra), m_nv(nv), m_rd(rd)
+        m_ethManager(ethManager),m_infobasic(infobasic), m_extra(extra), m_nv(nv), m_rd(rd), m_ipv4(eo_nv_GetIP(nv))
+{;}
+
+InfoFormatter::InfoFormatter(eth::TheEthManager* ethManager, eOipv4addr_t ipv4, eOmn_info_basic_t* infobasic, uint8_t * extra) :
+        m_ethManager(ethManager),m_infobasic(infobasic), m_extra(extra), m_nv(nullptr), m_rd(nullptr), m_ipv4(ipv4)
 {;}
 
 
@@ -28,8 +32,8 @@ bool InfoFormatter::getDiagnosticInfo(EmbeddedInfo &info)
     AuxEmbeddedInfo dnginfo;
 
     //1. fill all the common info to all messages
-    dnginfo.sourceBoardIpAddr = eo_nv_GetIP(m_nv);
-    dnginfo.baseInfo.sourceBoardName = m_ethManager->getName(eo_nv_GetIP(m_nv));
+    dnginfo.sourceBoardIpAddr = m_ipv4;
+    dnginfo.baseInfo.sourceBoardName = (nullptr != m_ethManager) ? (m_ethManager->getName(m_ipv4)) : ("unknown");
     getTimeOfInfo(dnginfo.baseInfo.timeOfInfo);
     getSourceOfMessage(dnginfo.baseInfo);
     getSeverityOfError(dnginfo.baseInfo);
@@ -121,7 +125,7 @@ void InfoFormatter::getTimeOfInfo(TimeOfInfo &timeOfInfo)
 void InfoFormatter::ipv4ToString(EmbeddedInfo &info)
 {
     char ipinfo[20] = {0};
-    eo_common_ipv4addr_to_string(eo_nv_GetIP(m_nv), ipinfo, sizeof(ipinfo));
+    eo_common_ipv4addr_to_string(m_ipv4, ipinfo, sizeof(ipinfo));
     info.sourceBoardIpAddrStr.clear();
     info.sourceBoardIpAddrStr.append(ipinfo);
 }
@@ -144,9 +148,13 @@ void InfoFormatter::getSeverityOfError(EmbeddedInfo &info)
 /**************************************************************************************************************************/
 /******************************************        EntityNameProvider       ***************************************************/
 /**************************************************************************************************************************/
-EntityNameProvider::EntityNameProvider(eOipv4addr_t boardAddr, eth::TheEthManager* ethManager):m_ethManager(ethManager)
+EntityNameProvider::EntityNameProvider(eOipv4addr_t boardAddr, eth::TheEthManager* ethManager):m_ethManager(ethManager), m_MC_ethRes(nullptr)
 {
+    // without the eth manager (e.g. offline) the axes have no name
+    if(nullptr != m_ethManager)
+    {
        m_MC_ethRes = m_ethManager->getInterface(boardAddr, eth::iethresType_t::iethres_motioncontrol);
+    }
 }
 
 bool EntityNameProvider::getAxisName(uint32_t entityId, std::string &axisName)
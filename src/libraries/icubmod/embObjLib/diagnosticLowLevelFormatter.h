@@ -30,6 +30,8 @@ class Diagnostic::LowLevel::InfoFormatter
 {
 public:
     InfoFormatter(eth::TheEthManager* ethManager, eOmn_info_basic_t* infobasic, uint8_t * extra, const EOnv* nv, const eOropdescriptor_t* rd);
+    //used when the info is no more inside its network variable (e.g. it is queued or read from a journal). ethManager can be nullptr
+    InfoFormatter(eth::TheEthManager* ethManager, eOipv4addr_t ipv4, eOmn_info_basic_t* infobasic, uint8_t * extra);
     InfoFormatter() = delete;
     InfoFormatter(const Diagnostic::LowLevel::InfoFormatter &InfoFormatter){};
     ~InfoFormatter(){;};
@@ -44,6 +46,7 @@ private:
     const EOnv* m_nv;
     const eOropdescriptor_t* m_rd;
     eth::TheEthManager* m_ethManager;
+    eOipv4addr_t m_ipv4;
  
     void getTimeOfInfo(Diagnostic::TimeOfInfo &timeOfInfo);
     void getSourceOfMessage(Diagnostic::EmbeddedInfo &info);
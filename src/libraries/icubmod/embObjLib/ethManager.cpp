@@ -58,6 +58,7 @@ using namespace yarp::os::impl;
 #include <fakeEthResource.h>
 #include <ethResource.h>
 #include <ethParser.h>
+#include <diagnosticAsyncLogger.h>
 
 using namespace eth;
 
@@ -91,6 +92,7 @@ TheEthManager::TheEthManager()
     // it is a singleton. the constructor is private.
     communicationIsInitted = false;
     UDP_socket  = NULL;
+    diagnostics = NULL;
 
     // the container of ethernet boards: resources and attached interfaces
     ethBoards = new(eth::EthBoards);
@@ -142,6 +144,14 @@ TheEthManager::~TheEthManager()
         lock(false);
     }
 
+    // the receiver is stopped: the pending diagnostic messages are logged while the boards still have a name
+    if(NULL != diagnostics)
+    {
+        diagnostics->stop();
+        delete diagnostics;
+        diagnostics = NULL;
+    }
+
 
     lock(true);
 
@@ -317,6 +327,22 @@ bool TheEthManager::initCommunication(yarp::os::Searchable &cfgtotal)
     eOipv4addressing_t tmpaddress = pc104data.localaddressing;
     embBoardsConnected = pc104data.embBoardsConnected;
 
+    // the diagnostic thread is ready before the receiver gets any message
+    if((pc104data.diagnosticAsync) && (NULL == diagnostics))
+    {
+        Diagnostic::LowLevel::AsyncLogger::Config config;
+        config.capacity = pc104data.diagnosticQueueSize;
+        config.aggregation.threshold = pc104data.diagnosticThreshold;
+        config.journal = pc104data.diagnosticJournal;
+        diagnostics = new Diagnostic::LowLevel::AsyncLogger(this, config);
+        if(false == diagnostics->start())
+        {
+            yWarning() << "TheEthManager::initCommunication() cannot start the diagnostic thread, thus the diagnostic messages are logged by the receiver";
+            delete diagnostics;
+            diagnostics = NULL;
+        }
+    }
+
     // localaddress
     if(false == createCommunicationObjects(tmpaddress, txrate, rxrate) )
     {
@@ -483,6 +509,11 @@ int TheEthManager::releaseResource2(eth::AbstractEthResource* ethresource, IethR
     // to the resource, without any harm. only thing is: protect ethBoards with a mutex.
 
     // now we change internal data structure of ethBoards, thus .. must disable tx and rx
+    // and also the diagnostic thread, which looks up the interfaces to name the axes
+    if(NULL != diagnostics)
+    {
+        diagnostics->lock(true);
+    }
     lockTXRX(true);
 
     // remove the interface
@@ -502,6 +533,10 @@ int TheEthManager::releaseResource2(eth::AbstractEthResource* ethresource, IethR
     }
 
     lockTXRX(false);
+    if(NULL != diagnostics)
+    {
+        diagnostics->lock(false);
+    }
 
 
     return(ret);
@@ -710,6 +745,18 @@ const string & TheEthManager::getName(eOipv4addr_t ipv4)
 }
 
 
+bool TheEthManager::deferDiagnostic(eOipv4addr_t ipv4, const eOmn_info_basic_t *infobasic, const uint8_t *extra)
+{
+    if(NULL == diagnostics)
+    {
+        return false;
+    }
+
+    diagnostics->push(ipv4, infobasic, extra);
+    return true;
+}
+
+
 eth::AbstractEthResource* TheEthManager::getEthResource(eOipv4addr_t ipv4)
 {
     return(ethBoards->get_resource(ipv4));
@@ -71,6 +71,10 @@ using namespace std;
 #include <ethSender.h>
 #include <ethReceiver.h>
 
+namespace Diagnostic { namespace LowLevel {
+    class AsyncLogger;
+} }
+
 
 // -- class TheEthManager
 // -- it is the main singleton which delas with eth communication.
@@ -141,6 +145,10 @@ namespace eth {
 
         ACE_INET_Addr toaceinet(const eOipv4addressing_t &ipv4addressing);
 
+        // called on reception of a diagnostic message. it returns false if the message must be handled
+        // by the caller, true if it was given to the diagnostic thread (or lost because its queue was full)
+        bool deferDiagnostic(eOipv4addr_t ipv4, const eOmn_info_basic_t *infobasic, const uint8_t *extra);
+
     private:
 
 
@@ -184,6 +192,9 @@ namespace eth {
         ACE_SOCK_Dgram* UDP_socket;
         bool embBoardsConnected;
 
+        // parses and logs the diagnostic messages in place of the receiver thread
+        Diagnostic::LowLevel::AsyncLogger* diagnostics;
+
     };
 
 } // namespace eth
@@ -40,6 +40,8 @@ using yarp::os::Log;
 #include <yarp/os/Bottle.h>
 #include <yarp/os/Value.h>
 
+#include <cstdint>
+
 using namespace yarp::os;
 
 
@@ -62,6 +64,8 @@ bool eth::parser::print(const pc104Data &pc104data)
     yDebug() << "PC104/PC104IpAddress:PC104IpPort = " << pc104data.addressingstring;
     yDebug() << "PC104/PC104TXrate = " << pc104data.txrate;
     yDebug() << "PC104/PC104RXrate = " << pc104data.rxrate;
+    yDebug() << "PC104/(diagnosticAsync, diagnosticQueueSize, diagnosticThreshold, diagnosticJournal) = " <<
+                pc104data.diagnosticAsync << pc104data.diagnosticQueueSize << pc104data.diagnosticThreshold << pc104data.diagnosticJournal;
 
     return true;
 }
@@ -173,6 +177,41 @@ bool eth::parser::read(yarp::os::Searchable &cfgtotal, pc104Data &pc104data)
         yWarning () << "eth::parser::read() cannot find ETH/PC104RXrate. thus using default value" << pc104data.rxrate;
     }
 
+    // diagnostics: all optional
+    if(groupPC104.check("diagnosticAsync"))
+    {
+        pc104data.diagnosticAsync = groupPC104.find("diagnosticAsync").asBool();
+    }
+    if(groupPC104.check("diagnosticQueueSize"))
+    {
+        int value = groupPC104.find("diagnosticQueueSize").asInt32();
+        if((value > 0) && (value <= UINT16_MAX))
+        {
+            pc104data.diagnosticQueueSize = value;
+        }
+        else
+        {
+            yWarning() << "eth::parser::read() has ETH/diagnosticQueueSize =" << value << "out of [1, 65535], thus using default value" << pc104data.diagnosticQueueSize;
+        }
+    }
+    if(groupPC104.check("diagnosticThreshold"))
+    {
+        // 0 disables the rate limiting
+        int value = groupPC104.find("diagnosticThreshold").asInt32();
+        if((value >= 0) && (value <= UINT16_MAX))
+        {
+            pc104data.diagnosticThreshold = value;
+        }
+        else
+        {
+            yWarning() << "eth::parser::read() has ETH/diagnosticThreshold =" << value << "out of [0, 65535], thus using default value" << pc104data.diagnosticThreshold;
+        }
+    }
+    if(groupPC104.check("diagnosticJournal"))
+    {
+        pc104data.diagnosticJournal = groupPC104.find("diagnosticJournal").asString();
+    }
+
     // now i print all the found values
 
     //print(pc104data);
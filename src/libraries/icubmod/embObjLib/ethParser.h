@@ -101,17 +101,26 @@ namespace eth { namespace parser {
         std::uint16_t  txrate;
         std::uint16_t rxrate;
         std::string addressingstring;
+        // diagnostic messages: handled by a thread of their own, rate limit per second, optional journal
+        bool diagnosticAsync;
+        std::uint16_t diagnosticQueueSize;
+        std::uint16_t diagnosticThreshold;
+        std::string diagnosticJournal;
         void reset() {
             embBoardsConnected = true;
             localaddressing.addr = eo_common_ipv4addr(10, 0, 1, 104); localaddressing.port = 12345;
             txrate = 1; rxrate = 5;
             addressingstring = "10.0.1.104:12345";
+            diagnosticAsync = true; diagnosticQueueSize = 1024; diagnosticThreshold = 10;
+            diagnosticJournal = "";
         }
         void setdefault() {
             embBoardsConnected = true;
             localaddressing.addr = eo_common_ipv4addr(10, 0, 1, 104); localaddressing.port = 12345;
             txrate = 1; rxrate = 5;
             addressingstring = "10.0.1.104:12345";
+            diagnosticAsync = true; diagnosticQueueSize = 1024; diagnosticThreshold = 10;
+            diagnosticJournal = "";
         }
     };
 
@@ -109,6 +109,9 @@ bool EthResource::lock(bool on)
 
 bool EthResource::open2(eOipv4addr_t remIP, yarp::os::Searchable &cfgtotal)
 {
+    startuptimes = StartupTimes();
+    startuptimes.opened = yarp::os::Time::now();
+
     ethManager = eth::TheEthManager::instance();
 
     eth::parser::pc104Data pc104data;
@@ -489,11 +492,15 @@ bool EthResource::verifyEPprotocol(eOprot_endpoint_t ep)
         return(false);
     }
 
+    std::lock_guard<std::recursive_mutex> lck(commandLock);
+
     if(true == verifiedEPprotocol[ep])
     {
         return(true);
     }
 
+    double start_time = yarp::os::Time::now();
+
     if(false == verifyBoard())
     {
         yError() << "EthResource::verifyEPprotocol() cannot verify BOARD" << getProperties().boardnameString << "with IP" << getProperties().ipv4addrString << ": cannot proceed any further";
@@ -593,6 +600,7 @@ bool EthResource::verifyEPprotocol(eOprot_endpoint_t ep)
     }
 
     verifiedEPprotocol[ep] = true;
+    startuptimes.verify += yarp::os::Time::now() - start_time;
 
     return(true);
 
@@ -777,7 +785,25 @@ bool EthResource::setRemoteValue(const eOprotID32_t id32, void *value)
 bool EthResource::setcheckRemoteValue(const eOprotID32_t id32, void *value, const unsigned int retries, const double waitbeforecheck, const double timeout)
 {
     theNVmanager& nvman = theNVmanager::getInstance();
-    return nvman.setcheck(properties.ipv4addr, id32, value, retries, waitbeforecheck, timeout);
+    double start_time = yarp::os::Time::now();
+    bool ret = nvman.setcheck(&transceiver, id32, value, retries, waitbeforecheck, timeout);
+    commandLock.lock();
+    startuptimes.config += yarp::os::Time::now() - start_time;
+    startuptimes.numofconfigs++;
+    commandLock.unlock();
+    return ret;
+}
+
+bool EthResource::setcheckRemoteValues(const std::vector<eOprotID32_t> &id32s, const std::vector<const void*> &values, const unsigned int retries, const double waitbeforecheck, const double timeout)
+{
+    theNVmanager& nvman = theNVmanager::getInstance();
+    double start_time = yarp::os::Time::now();
+    bool ret = nvman.setcheck(&transceiver, id32s, values, retries, waitbeforecheck, timeout);
+    commandLock.lock();
+    startuptimes.config += yarp::os::Time::now() - start_time;
+    startuptimes.numofconfigs += id32s.size();
+    commandLock.unlock();
+    return ret;
 }
 
 bool EthResource::CANPrintHandler(eOmn_info_basic_t *infobasic)
@@ -914,7 +940,11 @@ bool EthResource::serviceCommand(eOmn_serv_operation_t operation, eOmn_serv_cate
 
 bool EthResource::serviceVerifyActivate(eOmn_serv_category_t category, const eOmn_serv_parameter_t* param, double timeout)
 {
-    return(serviceCommand(eomn_serv_operation_verifyactivate, category, param, timeout, 3));
+    std::lock_guard<std::recursive_mutex> lck(commandLock);
+    double start_time = yarp::os::Time::now();
+    bool ret = serviceCommand(eomn_serv_operation_verifyactivate, category, param, timeout, 3);
+    startuptimes.activate += yarp::os::Time::now() - start_time;
+    return ret;
 }
 
 
@@ -928,7 +958,10 @@ bool EthResource::serviceSetRegulars(eOmn_serv_category_t category, vector<eOpro
         eo_array_PushBack(array, &id32);
     }
 
+    std::lock_guard<std::recursive_mutex> lck(commandLock);
+    double start_time = yarp::os::Time::now();
     regularsAreSet = serviceCommand(eomn_serv_operation_regsig_load, category, &param, timeout, 3);
+    startuptimes.activate += yarp::os::Time::now() - start_time;
 
     return regularsAreSet;
 }
@@ -937,11 +970,20 @@ bool EthResource::serviceSetRegulars(eOmn_serv_category_t category, vector<eOpro
 
 bool EthResource::serviceStart(eOmn_serv_category_t category, double timeout)
 {
+    std::lock_guard<std::recursive_mutex> lck(commandLock);
+    double start_time = yarp::os::Time::now();
     bool ret = serviceCommand(eomn_serv_operation_start, category, NULL, timeout, 3);
+    double end_time = yarp::os::Time::now();
+    startuptimes.start += end_time - start_time;
 
     if(ret)
     {
         isInRunningMode = true;
+
+        // every service started adds up to the startup of the board: the report of the last one holds the total
+        yInfo() << "EthResource::serviceStart() has started service" << eomn_servicecategory2string(category) << "of BOARD" << getProperties().boardnameString << "with IP" << getProperties().ipv4addrString
+                << "after" << end_time - startuptimes.opened << "seconds from open, of which: verify protocol" << startuptimes.verify
+                << "activate" << startuptimes.activate << "config of" << startuptimes.numofconfigs << "variables" << startuptimes.config << "start" << startuptimes.start;
     }
 
     return ret;
@@ -950,6 +992,7 @@ bool EthResource::serviceStart(eOmn_serv_category_t category, double timeout)
 
 bool EthResource::serviceStop(eOmn_serv_category_t category, double timeout)
 {
+    std::lock_guard<std::recursive_mutex> lck(commandLock);
     bool ret = serviceCommand(eomn_serv_operation_stop, category, NULL, timeout, 3);
 
     if(ret && (category == eomn_serv_category_all))
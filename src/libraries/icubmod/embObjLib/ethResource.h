@@ -71,6 +71,9 @@ namespace eth {
         // FAKE: it just returns true.
         bool setcheckRemoteValue(const eOprotID32_t id32, void *value, const unsigned int retries = 10, const double waitbeforecheck = 0.001, const double timeout = 0.050);
 
+        // it sets all the values at once and verifies them with a single group of asks
+        bool setcheckRemoteValues(const std::vector<eOprotID32_t> &id32s, const std::vector<const void*> &values, const unsigned int retries = 10, const double waitbeforecheck = 0.001, const double timeout = 0.050);
+
         // FAKE: it just returns true.
         bool getLocalValue(const eOprotID32_t id32, void *value);
 
@@ -106,6 +109,10 @@ namespace eth {
         bool isInRunningMode;
 
         std::mutex          objLock;
+        // the commands wait their reply on variables shared by all the services, hence the devices of
+        // this board brought up by different threads send them one at a time. it also guards startuptimes.
+        // it is recursive because verifyEPprotocol() stops the services while it cleans the board
+        std::recursive_mutex commandLock;
 
 
 
@@ -135,6 +142,17 @@ namespace eth {
 
         Properties properties;
 
+        // the time spent in bringing up the board, reported by serviceStart()
+        struct StartupTimes
+        {
+            double opened {0};
+            double verify {0};
+            double activate {0};
+            double config {0};
+            double start {0};
+            size_t numofconfigs {0};
+        } startuptimes;
+
     private:
 
         enum { defTXrateOfRegularROPs = 3, defcycletime = 1000, defmaxtimeRX = 400, defmaxtimeDO = 300, defmaxtimeTX = 300 };
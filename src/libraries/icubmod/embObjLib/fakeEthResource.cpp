@@ -249,6 +249,11 @@ bool FakeEthResource::setcheckRemoteValue(const eOprotID32_t id32, void *value,
     return true;
 }
 
+bool FakeEthResource::setcheckRemoteValues(const std::vector<eOprotID32_t> &id32s, const std::vector<const void*> &values, const unsigned int retries, const double waitbeforecheck, const double timeout)
+{
+    return true;
+}
+
 
 
 bool FakeEthResource::CANPrintHandler(eOmn_info_basic_t *infobasic)
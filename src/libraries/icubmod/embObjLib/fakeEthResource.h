@@ -61,6 +61,8 @@ namespace eth {
 
         bool setcheckRemoteValue(const eOprotID32_t id32, void *value, const unsigned int retries = 10, const double waitbeforecheck = 0.001, const double timeout = 0.050);
 
+        bool setcheckRemoteValues(const std::vector<eOprotID32_t> &id32s, const std::vector<const void*> &values, const unsigned int retries = 10, const double waitbeforecheck = 0.001, const double timeout = 0.050);
+
         bool getLocalValue(const eOprotID32_t id32,  void *value);
 
         bool setLocalValue(const eOprotID32_t id32,  const void *value, bool overrideROprotection = false);
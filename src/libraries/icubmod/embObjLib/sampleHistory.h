@@ -0,0 +1,187 @@
+/*
+ * Copyright (C) Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+// - include guard ----------------------------------------------------------------------------------------------------
+
+#ifndef _SAMPLEHISTORY_H_
+#define _SAMPLEHISTORY_H_
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+
+namespace eth {
+
+    // -- class SampleHistory
+    // -- it keeps the last capacity() samples of a sensor, each one with a sequence number (1, 2, ...) and a timestamp,
+    // -- so that a reader which polls at a rate lower than the one of the sensor still gets all of them.
+    // -- it has a single writer (the EthReceiver thread, inside IethResource::update()) and any number of readers,
+    // -- and none of them ever waits: every slot carries the sequence number of the sample it holds, the writer
+    // -- zeroes it while it fills the slot in and the readers verify it after they have copied the slot.
+    // -- a reader which is lapped by the writer loses the overwritten samples and is told how many.
+    // -- the timestamp is in seconds on the clock of yarp::os::Time::now(), as the ones of the measures given
+    // -- by the yarp interfaces of the devices, so that the histories of different devices can be merged.
+
+    template <typename T>
+    class SampleHistory
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "SampleHistory needs trivially copyable samples");
+
+    public:
+
+        struct Sample
+        {
+            std::uint64_t seq;
+            double timestamp;   // [s], see above
+            T value;
+        };
+
+        // a history of capacity zero keeps nothing
+        SampleHistory(size_t capacity = 0) { reset(capacity); }
+
+        // it empties the history. it must not be called while the history is in use
+        void reset(size_t capacity)
+        {
+            ring.reset(new Ring);
+            ring->capacity = capacity;
+            ring->slots.reset((capacity > 0) ? (new Slot[capacity]) : (nullptr));
+            for(size_t i=0; i<capacity; i++)
+            {
+                ring->slots[i].seq.store(0, std::memory_order_relaxed);
+            }
+            ring->latest.store(0, std::memory_order_release);
+        }
+
+        size_t capacity() const { return ring->capacity; }
+
+        // the sequence number of the last sample, 0 if none
+        std::uint64_t latest() const { return ring->latest.load(std::memory_order_acquire); }
+
+        // called only by the writer
+        void push(double timestamp, const T &value)
+        {
+            if(0 == ring->capacity)
+            {
+                return;
+            }
+
+            std::uint64_t seq = ring->latest.load(std::memory_order_relaxed) + 1;
+            Slot &slot = ring->slots[seq % ring->capacity];
+
+            // invalidate the slot before touching its content
+            slot.seq.store(0, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            slot.sample.seq = seq;
+            slot.sample.timestamp = timestamp;
+            std::memcpy(&slot.sample.value, &value, sizeof(T));
+            slot.seq.store(seq, std::memory_order_release);
+
+            ring->latest.store(seq, std::memory_order_release);
+        }
+
+        // it appends to samples, oldest first, the samples with a sequence number higher than after.
+        // lost is the number of those no more available. it returns the sequence number of the last sample
+        // appended or lost, or after if none, so that it can be given back at the next call.
+        std::uint64_t read(std::uint64_t after, std::vector<Sample> &samples, std::uint64_t &lost) const
+        {
+            lost = 0;
+            std::uint64_t last = latest();
+            if(last <= after)
+            {
+                return after;
+            }
+
+            std::uint64_t first = after + 1;
+            if(last - after > ring->capacity)
+            {
+                first = last - ring->capacity + 1;
+                lost = first - (after + 1);
+            }
+
+            Sample sample;
+            for(std::uint64_t s=first; s<=last; s++)
+            {
+                if(get(s, sample))
+                {
+                    samples.push_back(sample);
+                }
+                else
+                {   // overwritten while we were reading
+                    lost++;
+                }
+            }
+
+            return last;
+        }
+
+        // as above, but the samples appended are those with a timestamp higher than since
+        std::uint64_t read(double since, std::vector<Sample> &samples) const
+        {
+            std::uint64_t last = latest();
+            std::uint64_t first = (last > ring->capacity) ? (last - ring->capacity + 1) : (1);
+            std::uint64_t ret = 0;
+
+            Sample sample;
+            for(std::uint64_t s=first; s<=last; s++)
+            {
+                if(get(s, sample) && (sample.timestamp > since))
+                {
+                    samples.push_back(sample);
+                    ret = s;
+                }
+            }
+
+            return ret;
+        }
+
+    private:
+
+        struct Slot
+        {
+            std::atomic<std::uint64_t> seq;
+            Sample sample;
+        };
+
+        // in one block, so that a history can be moved into a container before its use
+        struct Ring
+        {
+            std::atomic<std::uint64_t> latest;
+            size_t capacity;
+            std::unique_ptr<Slot[]> slots;
+        };
+
+        std::unique_ptr<Ring> ring;
+
+        bool get(std::uint64_t seq, Sample &sample) const
+        {
+            const Slot &slot = ring->slots[seq % ring->capacity];
+            if(slot.seq.load(std::memory_order_acquire) != seq)
+            {
+                return false;
+            }
+
+            std::memcpy(&sample, &slot.sample, sizeof(Sample));
+
+            // the content of the slot must be read before its seq
+            std::atomic_thread_fence(std::memory_order_acquire);
+            return (slot.seq.load(std::memory_order_relaxed) == seq);
+        }
+    };
+
+} // namespace eth
+
+
+#endif  // include-guard
+
+
+// - end-of-file (leave a blank line after)----------------------------------------------------------------------------
+
@@ -38,6 +38,7 @@
 #include <condition_variable>
 #include <chrono>
 #include <map>
+#include <thread>
 #include <cstring>
 
 #include "EoProtocol.h"
@@ -93,7 +94,12 @@ struct eth::theNVmanager::Impl
 
         void load(eOprotIP_t _ip, const std::vector<eOprotID32_t> &_ids, std::uint32_t _s)
         {
-            expectedrops = static_cast<uint16_t>(_ids.size()); // ok to downcast
+            load(_ip, _ids.size(), _s);
+        }
+
+        void load(eOprotIP_t _ip, const size_t numofrops, std::uint32_t _s)
+        {
+            expectedrops = static_cast<uint16_t>(numofrops); // ok to downcast
             receivedrops = 0;
 
             _ipv4 = _ip;
@@ -109,13 +115,16 @@ struct eth::theNVmanager::Impl
             timeofwait = SystemClock::nowSystem();
             const int timeout_millis = static_cast<int>(1000.0 * timeout);
             std::unique_lock<std::mutex> lck(mtx_semaphore);
-            bool r = (cv_semaphore.wait_for(lck, std::chrono::milliseconds(timeout_millis)) == cv_status::no_timeout);
+            // the replies may arrive while the asks are still being loaded, hence before we wait:
+            // we check the count and not only the notification
+            bool r = cv_semaphore.wait_for(lck, std::chrono::milliseconds(timeout_millis), [this]{ return receivedrops >= expectedrops; });
             numofrxrops = receivedrops;
             return r;
         }
 
         bool post()
         {
+            std::lock_guard<std::mutex> lck(mtx_semaphore);
             receivedrops++;
             if(receivedrops == expectedrops)
             {
@@ -175,6 +184,14 @@ struct eth::theNVmanager::Impl
             themap.insert(std::make_pair(key, transaction));
         }
 
+        void insert(askTransaction *transaction, const size_t numofrops, std::uint32_t &assignedsignature)
+        {
+            assignedsignature = uniquesignature();
+            transaction->load(0, numofrops, assignedsignature);
+            std::uint64_t key = static_cast<std::uint64_t>(assignedsignature);
+            themap.insert(std::make_pair(key, transaction));
+        }
+
         void remove(const std::uint32_t signature)
         {
             std::uint64_t key = static_cast<std::uint64_t>(signature);
@@ -246,12 +263,23 @@ struct eth::theNVmanager::Impl
 
     
 
+    // the asks collected by group_ask() between group_start() and group_stop() of a given thread
+    struct Group
+    {
+        std::vector<eth::HostTransceiver*> transceivers {};
+        std::vector<std::vector<eOprotID32_t>> id32s {};
+        std::vector<std::vector<void*>> values {};
+    };
+
+
     // see http://en.cppreference.com/w/cpp/container/map/find
 
 
 //    Config config;
            
     Data data;
+    std::mutex groupslocker {};
+    std::map<std::thread::id, Group> groups {};
 
     // we can use: std::map, std::multimap, std::set, std::multiset because therya re ordered and thus quicker. they have teh find method.
     // strategy: find by signature. in such a way every transaction is unique. it must have ....
@@ -289,6 +317,7 @@ struct eth::theNVmanager::Impl
 
     bool set(eth::HostTransceiver *t, const eOprotID32_t id32, const void *value);
     bool setcheck(eth::HostTransceiver *t, const eOprotID32_t id32, const void *value, const unsigned int retries, double waitbeforecheck, double timeout);
+    bool setcheck(eth::HostTransceiver *t, const std::vector<eOprotID32_t> &id32s, const std::vector<const void*> &values, const unsigned int retries, double waitbeforecheck, double timeout);
     
 
     //size_t maxSizeOfNV(const eOprotIP_t ipv4);
@@ -301,6 +330,10 @@ struct eth::theNVmanager::Impl
 
     bool check(eth::HostTransceiver *t, const eOprotID32_t id32, const void *value, const double timeout, const unsigned int retries);
 
+    bool group_start();
+    bool group_ask(eth::HostTransceiver *t, const std::vector<eOprotID32_t> &id32s, const std::vector<void*> &values);
+    bool group_stop(const double timeout);
+
     bool signatureisvalid(const std::uint32_t signature);
     bool onarrival(const ropCode ropcode, const eOprotIP_t ipv4, const eOprotID32_t id32, const std::uint32_t signature);
 
@@ -586,6 +619,236 @@ bool eth::theNVmanager::Impl::setcheck(eth::HostTransceiver *t, const eOprotID32
 }
 
 
+bool eth::theNVmanager::Impl::setcheck(eth::HostTransceiver *t, const std::vector<eOprotID32_t> &id32s, const std::vector<const void*> &values, const unsigned int retries, double waitbeforecheck, double timeout)
+{
+    if(id32s.size() != values.size())
+    {
+        yError() << "theNVmanager::Impl::setcheck(vector<>) called with" << id32s.size() << "ids and" << values.size() << "values";
+        return false;
+    }
+
+    for(size_t i=0; i<id32s.size(); i++)
+    {
+        if(false == validparameters(t, id32s[i], values[i]))
+        {
+            return false;
+        }
+    }
+
+    // the replies are compared vs the values, so we need a buffer for each of them
+    std::vector<std::vector<std::uint8_t>> replies(id32s.size());
+    for(size_t i=0; i<id32s.size(); i++)
+    {
+        replies[i].resize(sizeofnv(id32s[i]));
+    }
+
+    // the indices of the variables not verified yet
+    std::vector<size_t> pending(id32s.size());
+    for(size_t i=0; i<pending.size(); i++)
+    {
+        pending[i] = i;
+    }
+
+    int attempt = 0;
+    int maxattempts = retries + 1;
+
+    for(attempt=0; (attempt<maxattempts) && (false == pending.empty()); attempt++)
+    {
+        // all the set<> go in the occasional ROPs of the board, hence they leave in as few frames as they fit
+        for(size_t p : pending)
+        {
+            if(false == set(t, id32s[p], values[p]))
+            {
+                const AbstractEthResource::Properties & props = getboardproperties(t);
+                yWarning() << "theNVmanager::Impl::setcheck(vector<>) had an error while calling set() in BOARD" << props.boardnameString << "with IP" << props.ipv4addrString << "at attempt #" << attempt+1;
+            }
+        }
+
+        // ok, now i wait some time before asking the values back for verification
+        SystemClock::delaySystem(waitbeforecheck);
+
+        std::vector<eOprotID32_t> askid32s(pending.size());
+        std::vector<void*> askvalues(pending.size());
+        for(size_t i=0; i<pending.size(); i++)
+        {
+            askid32s[i] = id32s[pending[i]];
+            askvalues[i] = replies[pending[i]].data();
+        }
+
+        // a failed group_start() means that this thread already has a session: we must not close it
+        if(false == group_start())
+        {
+            const AbstractEthResource::Properties & props = getboardproperties(t);
+            yError() << "theNVmanager::Impl::setcheck(vector<>) cannot open a group of asks for BOARD" << props.boardnameString << "with IP" << props.ipv4addrString << "because the calling thread already has one";
+            return false;
+        }
+
+        // group_stop() is called also when group_ask() fails, because it is the one which closes the session
+        bool asked = group_ask(t, askid32s, askvalues);
+        bool replied = group_stop(timeout);
+        if((false == asked) || (false == replied))
+        {
+            const AbstractEthResource::Properties & props = getboardproperties(t);
+            yWarning() << "theNVmanager::Impl::setcheck(vector<>) had an error while asking back" << pending.size() << "values in BOARD" << props.boardnameString << "with IP" << props.ipv4addrString << "at attempt #" << attempt+1;
+            continue;
+        }
+
+        std::vector<size_t> failed;
+        for(size_t p : pending)
+        {
+            if(0 != std::memcmp(values[p], replies[p].data(), replies[p].size()))
+            {
+                failed.push_back(p);
+            }
+        }
+        pending.swap(failed);
+    }
+
+
+    if(false == pending.empty())
+    {
+        const AbstractEthResource::Properties & props = getboardproperties(t);
+        yError() << "FATAL: theNVmanager::Impl::setcheck(vector<>) could not set and verify" << pending.size() << "out of" << id32s.size() << "IDs in BOARD" << props.boardnameString << "with IP" << props.ipv4addrString << " even after " << attempt << "attempts, the first being" << getid32string(id32s[pending.front()]);
+        return false;
+    }
+
+    if(attempt > 1)
+    {
+        const AbstractEthResource::Properties & props = getboardproperties(t);
+        yWarning() << "theNVmanager::Impl::setcheck(vector<>) has set and verified" << id32s.size() << "IDs in BOARD" << props.boardnameString << "with IP" << props.ipv4addrString << "at attempt #" << attempt;
+    }
+
+    return true;
+}
+
+
+bool eth::theNVmanager::Impl::group_start()
+{
+    std::lock_guard<std::mutex> lck(groupslocker);
+
+    // every thread has its own session, so that boards brought up by different threads do not wait for each other
+    if(false == groups.emplace(std::this_thread::get_id(), Group()).second)
+    {
+        yError() << "theNVmanager::Impl::group_start() called twice by the same thread";
+        return false;
+    }
+
+    return true;
+}
+
+
+bool eth::theNVmanager::Impl::group_ask(eth::HostTransceiver *t, const std::vector<eOprotID32_t> &id32s, const std::vector<void*> &values)
+{
+    if(false == validparameters(t, id32s, values))
+    {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lck(groupslocker);
+
+    std::map<std::thread::id, Group>::iterator it = groups.find(std::this_thread::get_id());
+    if(groups.end() == it)
+    {
+        yError() << "theNVmanager::Impl::group_ask() called without a previous group_start()";
+        return false;
+    }
+
+    Group &group = it->second;
+    group.transceivers.push_back(t);
+    group.id32s.push_back(id32s);
+    group.values.push_back(values);
+
+    return true;
+}
+
+
+bool eth::theNVmanager::Impl::group_stop(const double timeout)
+{
+    Group group;
+
+    groupslocker.lock();
+    std::map<std::thread::id, Group>::iterator it = groups.find(std::this_thread::get_id());
+    if(groups.end() == it)
+    {
+        groupslocker.unlock();
+        yError() << "theNVmanager::Impl::group_stop() called without a previous group_start()";
+        return false;
+    }
+    group = std::move(it->second);
+    groups.erase(it);
+    groupslocker.unlock();
+
+    size_t numofrops = 0;
+    for(size_t g=0; g<group.id32s.size(); g++)
+    {
+        numofrops += group.id32s[g].size();
+    }
+
+    bool ok = true;
+
+    if(numofrops > 0)
+    {
+        // 1. a single transaction for all the boards of the group
+
+        askTransaction* transaction = new askTransaction;
+        std::uint32_t assignedsignature = 0;
+
+        data.lock();
+        data.insert(transaction, numofrops, assignedsignature);
+        data.unlock();
+
+        // 2. the requests go to the boards, which reply in parallel
+
+        for(size_t g=0; (g<group.transceivers.size()) && ok; g++)
+        {
+            for(size_t i=0; i<group.id32s[g].size(); i++)
+            {
+                if(false == group.transceivers[g]->addROPask(group.id32s[g][i], assignedsignature))
+                {
+                    const AbstractEthResource::Properties & props = getboardproperties(group.transceivers[g]);
+                    yError() << "theNVmanager::Impl::group_stop() fails t->addROPask() to BOARD" << props.boardnameString << "IP" << props.ipv4addrString << "for nv" << getid32string(group.id32s[g][i]);
+                    ok = false;
+                    break;
+                }
+            }
+        }
+
+        // 3. the wait and the possible timeout
+
+        std::uint16_t numberOfReceivedROPs = 0;
+
+        if(ok && (false == transaction->wait(numberOfReceivedROPs, timeout)))
+        {
+            yError() << "theNVmanager::Impl::group_stop() had a timeout w/" << group.transceivers.size() << "boards. Received only" << numberOfReceivedROPs << "out of" << numofrops;
+            ok = false;
+        }
+
+        data.lock();
+        data.remove(assignedsignature);
+        data.unlock();
+        delete transaction;
+
+        // 4. the values
+
+        for(size_t g=0; (g<group.transceivers.size()) && ok; g++)
+        {
+            for(size_t i=0; i<group.id32s[g].size(); i++)
+            {
+                if(false == group.transceivers[g]->read(group.id32s[g][i], group.values[g][i]))
+                {
+                    const AbstractEthResource::Properties & props = getboardproperties(group.transceivers[g]);
+                    yError() << "theNVmanager::Impl::group_stop() fails t->read() for BOARD" << props.boardnameString << "IP" << props.ipv4addrString << "and nv" << getid32string(group.id32s[g][i]);
+                    ok = false;
+                    break;
+                }
+            }
+        }
+    }
+
+    return ok;
+}
+
+
 bool eth::theNVmanager::Impl::check(eth::HostTransceiver *t, const eOprotID32_t id32, const void *value, const double timeout, const unsigned int retries)
 {    
     if(false == validparameters(t, id32, value))
@@ -952,7 +1215,7 @@ bool eth::theNVmanager::Impl::ask(eth::HostTransceiver *t, const std::vector<eOp
     // 4. must wait now and manage a possible timeout
     std::uint16_t numberOfReceivedROPs = 0;
 
-    if(false == transaction->wait(numberOfReceivedROPs))
+    if(false == transaction->wait(numberOfReceivedROPs, timeout))
     {
         // a timeout occurred .... manage it.
 
@@ -1218,6 +1481,32 @@ bool eth::theNVmanager::setcheck(eth::HostTransceiver *t, const eOprotID32_t id3
     return pImpl->setcheck(t, id32, value, retries, waitbeforecheck, timeout);
 }
 
+bool eth::theNVmanager::setcheck(const eOprotIP_t ipv4, const std::vector<eOprotID32_t> &id32s, const std::vector<const void*> &values, const unsigned int retries, double waitbeforecheck, double timeout)
+{
+    eth::HostTransceiver *t = pImpl->transceiver(ipv4);
+    return pImpl->setcheck(t, id32s, values, retries, waitbeforecheck, timeout);
+}
+
+bool eth::theNVmanager::setcheck(eth::HostTransceiver *t, const std::vector<eOprotID32_t> &id32s, const std::vector<const void*> &values, const unsigned int retries, double waitbeforecheck, double timeout)
+{
+    return pImpl->setcheck(t, id32s, values, retries, waitbeforecheck, timeout);
+}
+
+bool eth::theNVmanager::group_start()
+{
+    return pImpl->group_start();
+}
+
+bool eth::theNVmanager::group_ask(eth::HostTransceiver *t, const std::vector<eOprotID32_t> &id32s, const std::vector<void*> &values)
+{
+    return pImpl->group_ask(t, id32s, values);
+}
+
+bool eth::theNVmanager::group_stop(const double timeout)
+{
+    return pImpl->group_stop(timeout);
+}
+
 bool eth::theNVmanager::onarrival(const ropCode ropcode, const eOprotIP_t ipv4, const eOprotID32_t id32, const std::uint32_t signature)
 {
     return pImpl->onarrival(ropcode, ipv4, id32, signature);
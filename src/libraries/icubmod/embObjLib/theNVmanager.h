@@ -74,6 +74,10 @@ namespace eth {
         // it sends set<> ROP to a given varaible and it checks that the value is really written. it repeats this cycle until done, at most retries + 1 times.
         bool setcheck(const eOprotIP_t ipv4, const eOprotID32_t id32, const void *value, const unsigned int retries = 10, double waitbeforecheck = 0.001, double timeout = 0.5);
         bool setcheck(eth::HostTransceiver *t, const eOprotID32_t id32, const void *value, const unsigned int retries = 10, double waitbeforecheck = 0.001, double timeout = 0.5);
+        // as setcheck() but for many variables of the same board: it sends all the set<> ROPs at once and verifies them with a single
+        // group of asks, then it repeats the cycle only for the variables which are not verified yet, at most retries + 1 times.
+        bool setcheck(const eOprotIP_t ipv4, const std::vector<eOprotID32_t> &id32s, const std::vector<const void*> &values, const unsigned int retries = 10, double waitbeforecheck = 0.001, double timeout = 0.5);
+        bool setcheck(eth::HostTransceiver *t, const std::vector<eOprotID32_t> &id32s, const std::vector<const void*> &values, const unsigned int retries = 10, double waitbeforecheck = 0.001, double timeout = 0.5);
 
         // function which must be placed in the reception handlers to unblock the waiting of replies from a given board
         bool onarrival(const ropCode ropcode, const eOprotIP_t ipv4, const eOprotID32_t id32, const std::uint32_t signature);
@@ -98,23 +102,18 @@ namespace eth {
         bool ask(eth::HostTransceiver *t, const std::vector<eOprotID32_t> &id32s, const std::vector<void*> &values, const double timeout = 0.5);
 
 
-        // tobedone: i want to group several requests before i start to wait.
-        // i need:
+        // we can group several requests before we start to wait, also on different boards:
         // - group_start() which tells the nvmanager to use a given signature for all successive group_add_ask() until group_add_stop()
         // - group_ask() which adds to the nvmanager a vector of ask rops identified by the same signature.
         //   this function can be repeated as many times one want. typically by different devices but by the same thread.
         // - group_stop() which starts the wait for the replies. when this function returns, the various values vector will contain
         //   the replies.
         // some more explanation:
-        // we shall use the same signature if the calling thread is the same as the one which called group_start().
-        // in this way, we can target the operation to a given thread without blocking other threads using normal ask() requests. .
-        // i would say however, that if another thread starts a group_start() during an active session .... it musts wait.
-        // also let's give some limitations:
+        // we use the same signature for all the asks added by the thread which called group_start().
+        // in this way, we can target the operation to a given thread without blocking other threads using normal ask() requests.
+        // every thread can have its own active session, so that boards brought up by different threads proceed in parallel.
         // start of proper ask sending is done by group_stop() and not directly by group_ask().
-        // we can have at most one active session at any time.
-        // we can call group_ask() at most ... 8 times (boh, maybe it is not necessary to give a limit).
         // the calling thread will be retrieved inside.
-        // i use a ACE_Recursive_Thread_Mutex to perform synch amongst different threads.
 
         bool group_start();
         bool group_ask(eth::HostTransceiver *t, const std::vector<eOprotID32_t> &id32s, const std::vector<void*> &values);
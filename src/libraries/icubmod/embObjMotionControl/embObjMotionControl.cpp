@@ -227,6 +227,8 @@ embObjMotionControl::embObjMotionControl() :
     _cur_pids     = NULL;
     _spd_pids     = NULL;
     res           = NULL;
+    bringup       = NULL;
+    bringUpFailed = false;
     _njoints      = 0;
     _axisMap      = NULL;
     _encodersStamp = NULL;
@@ -375,20 +377,6 @@ bool embObjMotionControl::open(yarp::os::Searchable &config)
         return false;
     }
 
-    if(!res->verifyEPprotocol(eoprot_endpoint_motioncontrol))
-    {
-        yError() << "embObjMotionControl: failed verifyEPprotocol. Cannot continue!";
-        cleanup();
-        return false;
-    }
-
-
-    const eOmn_serv_parameter_t* servparam = &serviceConfig.ethservice;
-    if(eomn_serv_MC_generic == serviceConfig.ethservice.configuration.type)
-    {
-        servparam = NULL;
-    }
-
     // in here ...we open ports where to print AMO data
     mcdiagnostics.config.mode = serviceConfig.ethservice.configuration.diagnosticsmode;
     mcdiagnostics.config.par16 = serviceConfig.ethservice.configuration.diagnosticsparam;
@@ -412,10 +400,56 @@ bool embObjMotionControl::open(yarp::os::Searchable &config)
     event_downsampler->config.info = getBoardInfo();
     event_downsampler->start();
 
+    if(behFlags.asyncBringUp)
+    {
+        // open() returns now, so that the next devices bring up their boards while this one is brought up.
+        // the calls of the other threads to the board wait for the end of the bring-up
+        bringup = new eth::AsyncEthResource(res);
+        res = bringup;
+        // a failure is recorded, and the board is released by close(), which yarp calls as open() has succeeded
+        if(false == bringup->start([this]()
+        {
+            if(bringUp())
+                return true;
+            yError() << "embObjMotionControl: the bring-up of" << getBoardInfo() << "has failed: the device is unusable until it is closed";
+            bringUpFailed = true;
+            return false;
+        }))
+        {
+            cleanup();
+            return false;
+        }
+        return true;
+    }
+
+    if(false == bringUp())
+    {
+        cleanup();
+        return false;
+    }
+
+    return true;
+}
+
+
+bool embObjMotionControl::bringUp(void)
+{
+    if(!res->verifyEPprotocol(eoprot_endpoint_motioncontrol))
+    {
+        yError() << "embObjMotionControl: failed verifyEPprotocol. Cannot continue!";
+        return false;
+    }
+
+
+    const eOmn_serv_parameter_t* servparam = &serviceConfig.ethservice;
+    if(eomn_serv_MC_generic == serviceConfig.ethservice.configuration.type)
+    {
+        servparam = NULL;
+    }
+
     if(false == res->serviceVerifyActivate(eomn_serv_category_mc, servparam))
     {
         yError() << "embObjMotionControl::open() has an error in call of ethResources::serviceVerifyActivate() for" << getBoardInfo();
-        cleanup();
         return false;
     }
 
@@ -439,7 +473,6 @@ bool embObjMotionControl::open(yarp::os::Searchable &config)
     if(false == res->serviceStart(eomn_serv_category_mc))
     {
         yError() << "embObjMotionControl::open() fails to start mc service for" << getBoardInfo() << ": cannot continue";
-        cleanup();
         return false;
     }
     else
@@ -1207,7 +1240,7 @@ bool embObjMotionControl::fromConfig(yarp::os::Searchable &config)
         return false;
     }
 
-    if(!_mcparser->parseBehaviourFalgs(config, behFlags.useRawEncoderData, behFlags.pwmIsLimited ))//in general info group
+    if(!_mcparser->parseBehaviourFalgs(config, behFlags.useRawEncoderData, behFlags.pwmIsLimited, behFlags.batchedConfig, behFlags.asyncBringUp ))//in general info group
     {
         return false;
     }
@@ -1297,9 +1330,15 @@ bool embObjMotionControl::init()
 
 
 
+    // in batched mode the configurations of all joints (and then of all motors) are sent at once
+    // and verified with a single group of asks, rather than with a set and an ask for each of them
+    vector<eOprotID32_t> batchedIds(0);
+    vector<const void*> batchedValues(0);
+
     //////////////////////////////////////////
     // invia la configurazione dei GIUNTI   //
     //////////////////////////////////////////
+    vector<eOmc_joint_config_t> jconfigs(_njoints);
     for(int logico=0; logico< _njoints; logico++)
     {
         int fisico = _axisMap[logico];
@@ -1359,6 +1398,14 @@ bool embObjMotionControl::init()
         jconfig.kalman_params.R = _kalman_params[logico].R;
         jconfig.kalman_params.P0 = _kalman_params[logico].P0;
 
+        if(behFlags.batchedConfig)
+        {
+            memcpy(&jconfigs[logico], &jconfig, sizeof(eOmc_joint_config_t));
+            batchedIds.push_back(protid);
+            batchedValues.push_back(&jconfigs[logico]);
+            continue;
+        }
+
         if(false == res->setcheckRemoteValue(protid, &jconfig, 10, 0.010, 0.050))
         {
             yError() << "FATAL: embObjMotionControl::init() had an error while calling setcheckRemoteValue() for joint config fisico #" << fisico << "in "<< getBoardInfo();
@@ -1374,11 +1421,31 @@ bool embObjMotionControl::init()
     }
 
 
+    if(behFlags.batchedConfig)
+    {
+        if(false == res->setcheckRemoteValues(batchedIds, batchedValues, 10, 0.010, 0.100))
+        {
+            yError() << "FATAL: embObjMotionControl::init() had an error while calling setcheckRemoteValues() for the joint configs in "<< getBoardInfo();
+            return false;
+        }
+        else
+        {
+            if(behFlags.verbosewhenok)
+            {
+                yDebug() << "embObjMotionControl::init() correctly configured" << batchedIds.size() << "joints in "<< getBoardInfo();
+            }
+        }
+        batchedIds.clear();
+        batchedValues.clear();
+    }
+
+
     //////////////////////////////////////////
     // invia la configurazione dei MOTORI   //
     //////////////////////////////////////////
 
 
+    vector<eOmc_motor_config_t> motor_cfgs(_njoints);
     for(int logico=0; logico<_njoints; logico++)
     {
         int fisico = _axisMap[logico];
@@ -1412,6 +1479,14 @@ bool embObjMotionControl::init()
         tmp = _measureConverter->convert_pid_to_machine(yarp::dev::VOCAB_PIDTYPE_VELOCITY, _spd_pids[logico].pid, fisico);
         copyPid_iCub2eo(&tmp, &motor_cfg.pidspeed);
 
+        if(behFlags.batchedConfig)
+        {
+            memcpy(&motor_cfgs[logico], &motor_cfg, sizeof(eOmc_motor_config_t));
+            batchedIds.push_back(protid);
+            batchedValues.push_back(&motor_cfgs[logico]);
+            continue;
+        }
+
         if (false == res->setcheckRemoteValue(protid, &motor_cfg, 10, 0.010, 0.050))
         {
             yError() << "FATAL: embObjMotionControl::init() had an error while calling setcheckRemoteValue() for motor config fisico #" << fisico << "in "<< getBoardInfo();
@@ -1426,6 +1501,22 @@ bool embObjMotionControl::init()
         }
     }
 
+    if(behFlags.batchedConfig)
+    {
+        if(false == res->setcheckRemoteValues(batchedIds, batchedValues, 10, 0.010, 0.100))
+        {
+            yError() << "FATAL: embObjMotionControl::init() had an error while calling setcheckRemoteValues() for the motor configs in "<< getBoardInfo();
+            return false;
+        }
+        else
+        {
+            if(behFlags.verbosewhenok)
+            {
+                yDebug() << "embObjMotionControl::init() correctly configured" << batchedIds.size() << "motors in "<< getBoardInfo();
+            }
+        }
+    }
+
     /////////////////////////////////////////////
     // invia la configurazione del controller  //
     /////////////////////////////////////////////
@@ -1442,6 +1533,16 @@ bool embObjMotionControl::close()
 {
     yTrace() << " embObjMotionControl::close()";
 
+    if(NULL != bringup)
+    {
+        // init() uses what is released in here
+        bringup->wait();
+        if(bringUpFailed)
+        {
+            yWarning() << "embObjMotionControl::close() releases" << getBoardInfo() << "whose bring-up has failed";
+        }
+    }
+
     ImplementControlMode::uninitialize();
     ImplementEncodersTimed::uninitialize();
     ImplementMotorEncoders::uninitialize();
@@ -1496,6 +1597,18 @@ void embObjMotionControl::cleanup(void)
 {
     if(ethManager == NULL) return;
 
+    if(NULL != bringup)
+    {
+        // TheEthManager knows only the resource it gave
+        res = bringup->resource();
+        delete bringup;
+        bringup = NULL;
+        bringUpFailed = false;
+    }
+
+    // the resource may have been released already, by a failed open()
+    if(res == NULL) return;
+
     int ret = ethManager->releaseResource2(res, this);
     res = NULL;
     if(ret == -1)
@@ -32,6 +32,7 @@ using namespace std;
 
 #include <string>
 #include <mutex>
+#include <atomic>
 //  Yarp stuff
 #include <yarp/os/Bottle.h>
 #include <yarp/os/BufferedPort.h>
@@ -49,6 +50,7 @@ using namespace std;
 #include"EoError.h"
 #include <ethManager.h>
 #include <abstractEthResource.h>
+#include <asyncEthResource.h>
 
 #include "serviceParser.h"
 #include "eomcParser.h"
@@ -104,6 +106,8 @@ typedef struct
     bool verbosewhenok;         /** its value depends on environment variable "ETH_VERBOSEWHENOK" */
     bool useRawEncoderData;     /** if true than do not use calibration data */
     bool pwmIsLimited;          /** set to true if pwm is limited */
+    bool batchedConfig;         /** if true the joints and motors are configured all at once and not one at a time */
+    bool asyncBringUp;          /** if true open() returns before the board is brought up, which happens in a thread of its own */
 }behaviour_flags_t;
 
 }}};
@@ -189,12 +193,14 @@ private:
 
     eth::TheEthManager*        ethManager;
     eth::AbstractEthResource*  res;
+    eth::AsyncEthResource*     bringup;    // not NULL if the board is brought up in a thread of its own. then res points to it
+    std::atomic<bool>          bringUpFailed; // set by the thread of bringup if the bring-up fails. close() then releases the board
     ServiceParser*             parser;
     eomc::Parser *             _mcparser;
     ControlBoardHelper*        _measureConverter;
     std::mutex                 _mutex;
     
-    bool opened; //internal state
+    std::atomic<bool> opened; //internal state. it is written by the bring-up thread, if any
 
     MCdiagnostics mcdiagnostics;
 
@@ -314,6 +320,7 @@ private:
     bool initializeInterfaces(measureConvFactors &f);
     bool alloc(int njoints);
     bool init(void);
+    bool bringUp(void);
     
     //function used in the closing this object
     void cleanup(void);
@@ -1881,7 +1881,7 @@ bool Parser::isVerboseEnabled(yarp::os::Searchable &config)
     return ret;
 }
 
-bool Parser::parseBehaviourFalgs(yarp::os::Searchable &config, bool &useRawEncoderData, bool  &pwmIsLimited )
+bool Parser::parseBehaviourFalgs(yarp::os::Searchable &config, bool &useRawEncoderData, bool  &pwmIsLimited, bool &batchedConfig, bool &asyncBringUp )
 {
 
     // Check useRawEncoderData = do not use calibration data!
@@ -1929,6 +1929,44 @@ bool Parser::parseBehaviourFalgs(yarp::os::Searchable &config, bool &useRawEncod
         }
     }
 
+    // Check batchedConfig = send the configuration of all joints and motors at once
+    Value batched = config.findGroup("GENERAL").find("batchedConfig");
+    if(batched.isNull())
+    {
+        batchedConfig = false;
+    }
+    else
+    {
+        if(!batched.isBool())
+        {
+            yWarning() << "embObjMotionControl::open() detected that batchedConfig bool param is different from accepted values (true / false). Assuming false";
+            batchedConfig = false;
+        }
+        else
+        {
+            batchedConfig = batched.asBool();
+        }
+    }
+
+    // Check asyncBringUp = bring up the board in a thread of its own, so that the boards of different devices are brought up at the same time
+    Value async = config.findGroup("GENERAL").find("asyncBringUp");
+    if(async.isNull())
+    {
+        asyncBringUp = false;
+    }
+    else
+    {
+        if(!async.isBool())
+        {
+            yWarning() << "embObjMotionControl::open() detected that asyncBringUp bool param is different from accepted values (true / false). Assuming false";
+            asyncBringUp = false;
+        }
+        else
+        {
+            asyncBringUp = async.asBool();
+        }
+    }
+
     return true;
 }
 
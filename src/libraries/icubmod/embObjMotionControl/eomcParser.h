@@ -427,7 +427,7 @@ public:
     bool parseRotorsLimits(yarp::os::Searchable &config, std::vector<rotorLimits_t> &rotorsLimits);
     bool parseCouplingInfo(yarp::os::Searchable &config, couplingInfo_t &couplingInfo);
     bool parseMotioncontrolVersion(yarp::os::Searchable &config, int &version);
-    bool parseBehaviourFalgs(yarp::os::Searchable &config, bool &useRawEncoderData, bool  &pwmIsLimited );
+    bool parseBehaviourFalgs(yarp::os::Searchable &config, bool &useRawEncoderData, bool  &pwmIsLimited, bool &batchedConfig, bool &asyncBringUp );
     bool isVerboseEnabled(yarp::os::Searchable &config);
     bool parseAxisInfo(yarp::os::Searchable &config, int axisMap[], std::vector<axisInfo_t> &axisInfo);
     bool parseEncoderFactor(yarp::os::Searchable &config, double encoderFactor[]);
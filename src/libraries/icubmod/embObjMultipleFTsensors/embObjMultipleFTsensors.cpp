@@ -130,6 +130,20 @@ bool embObjMultipleFTsensors::open(yarp::os::Searchable &config)
 bool embObjMultipleFTsensors::sendConfig2boards(ServiceParserMultipleFt &parser, eth::AbstractEthResource *deviceRes)
 {
     auto &ftInfos = parser.getFtInfo();
+    if (ftInfos.size() > ftMaxSensors_)
+    {
+        yError() << device_->getBoardInfo() << " sendConfig2boards() too many sensors:" << ftInfos.size() << "instead of at most" << ftMaxSensors_;
+        return false;
+    }
+
+    {
+        // update() does not run until the device is open
+        std::unique_lock<std::shared_mutex> lck(mutex_);
+        ftSensorsData_.resize(ftInfos.size());
+        temperaturesensordata_.resize(ftInfos.size());
+        ftHistory_.resize(ftInfos.size());
+    }
+
     int index = 0;
     for (const auto &[id, data] : ftInfos)
     {
@@ -156,6 +170,7 @@ bool embObjMultipleFTsensors::sendConfig2boards(ServiceParserMultipleFt &parser,
         eOprotIndex_t eoprotIndex = eoprot_ID2index(id32);
         std::unique_lock<std::shared_mutex> lck(mutex_);
         ftSensorsData_[eoprotIndex] = {{0, 0, 0, 0, 0, 0}, 0, id,data.frameName};
+        ftHistory_[eoprotIndex].reset(historyCapacity_);
     }
     return true;
 }
@@ -235,7 +250,7 @@ bool embObjMultipleFTsensors::update(eOprotID32_t id32, double timestamp, void *
         return false;
 
     eOprotIndex_t eoprotIndex = eoprot_ID2index(id32);
-    if (eoprotIndex > 3)
+    if (eoprotIndex >= ftMaxSensors_)
     {
         yError() << device_->getBoardInfo() << " update() index too big";
         return false;
@@ -261,17 +276,39 @@ bool embObjMultipleFTsensors::update(eOprotID32_t id32, double timestamp, void *
         return false;
     }
 
-    std::unique_lock<std::shared_mutex> lck(mutex_);
+    if (eoprotIndex >= ftSensorsData_.size() || eoprotIndex >= temperaturesensordata_.size())
+    {
+        yError() << device_->getBoardInfo() << " update() sensor not configured, index:" << eoprotIndex;
+        return false;
+    }
+
+    double boardTime = calculateBoardTime(data->age);
 
-    for (int index = 0; index < eoas_ft_6axis; ++index)
     {
-        ftSensorsData_[eoprotIndex].data_[index] = data->values[index];
+        std::unique_lock<std::shared_mutex> lck(mutex_);
+
+        for (int index = 0; index < eoas_ft_6axis; ++index)
+        {
+            ftSensorsData_[eoprotIndex].data_[index] = data->values[index];
+        }
+        ftSensorsData_[eoprotIndex].timeStamp_ = data->age;
+        masStatus_[eoprotIndex] = MAS_OK;
+
+        temperaturesensordata_[eoprotIndex].data_ = data->temperature;
+        temperaturesensordata_[eoprotIndex].timeStamp_ = boardTime;
     }
-    ftSensorsData_[eoprotIndex].timeStamp_ = data->age;
-    masStatus_[eoprotIndex] = MAS_OK;
 
-    temperaturesensordata_[eoprotIndex].data_ = data->temperature;
-    temperaturesensordata_[eoprotIndex].timeStamp_ = calculateBoardTime(data->age);
+    // the history has its own synchronization
+    if (eoprotIndex < ftHistory_.size())
+    {
+        FtSample sample;
+        for (int index = 0; index < eoas_ft_6axis; ++index)
+        {
+            sample.data_[index] = data->values[index];
+        }
+        sample.temperature_ = 0.1 * data->temperature;
+        ftHistory_[eoprotIndex].push(boardTime, sample);
+    }
     return true;
 }
 
@@ -293,20 +330,51 @@ bool embObjMultipleFTsensors::getSixAxisForceTorqueSensorMeasure(size_t sensorIn
 
     std::shared_lock<std::shared_mutex> lck(mutex_);
 
-    if (ftSensorsData_.find(sensorIndex) == ftSensorsData_.end())
+    if (sensorIndex >= ftSensorsData_.size())
     {
         yError() << device_->getBoardInfo() << " getSixAxisForceTorqueSensorMeasure() fails data for index:" << sensorIndex << " not found";
         return false;
     }
 
-    FtData sensorData = ftSensorsData_.at(sensorIndex);
+    const FtData &sensorData = ftSensorsData_[sensorIndex];
 
     out.resize(ftChannels_);
     for (size_t k = 0; k < ftChannels_; k++)
     {
         out[k] = sensorData.data_[k];
     }
-    timestamp = ftSensorsData_.at(sensorIndex).timeStamp_;
+    timestamp = sensorData.timeStamp_;
+    return true;
+}
+
+bool embObjMultipleFTsensors::getSixAxisForceTorqueSensorSamples(size_t sensorIndex, uint64_t &after, std::vector<FtHistory::Sample> &samples, uint64_t &lost) const
+{
+    lost = 0;
+    if (!device_->isOpen())
+        return false;
+
+    if (sensorIndex >= ftHistory_.size())
+    {
+        yError() << device_->getBoardInfo() << " getSixAxisForceTorqueSensorSamples() fails data for index:" << sensorIndex << " not found";
+        return false;
+    }
+
+    after = ftHistory_[sensorIndex].read(after, samples, lost);
+    return true;
+}
+
+bool embObjMultipleFTsensors::getSixAxisForceTorqueSensorSamples(size_t sensorIndex, double since, std::vector<FtHistory::Sample> &samples) const
+{
+    if (!device_->isOpen())
+        return false;
+
+    if (sensorIndex >= ftHistory_.size())
+    {
+        yError() << device_->getBoardInfo() << " getSixAxisForceTorqueSensorSamples() fails data for index:" << sensorIndex << " not found";
+        return false;
+    }
+
+    ftHistory_[sensorIndex].read(since, samples);
     return true;
 }
 
@@ -365,14 +433,14 @@ bool embObjMultipleFTsensors::getTemperatureSensorMeasure(size_t sensorIndex, do
 
     std::shared_lock<std::shared_mutex> lck(mutex_);
 
-    if (temperaturesensordata_.find(sensorIndex) == temperaturesensordata_.end())
+    if (sensorIndex >= temperaturesensordata_.size())
     {
         yError() << device_->getBoardInfo() << " getTemperatureSensorMeasure() fails data for index:" << sensorIndex << " not found";
         return false;
     }
 
-    out = 0.1 * temperaturesensordata_.at(sensorIndex).data_;
-    timestamp = temperaturesensordata_.at(sensorIndex).timeStamp_;
+    out = 0.1 * temperaturesensordata_[sensorIndex].data_;
+    timestamp = temperaturesensordata_[sensorIndex].timeStamp_;
     return true;
 }
 
@@ -392,15 +460,16 @@ bool embObjMultipleFTsensors::checkUpdateTimeout(eOprotID32_t id32, eOabstime_t
         return true;
     }
 
-    eOabstime_t diff = current - timeoutUpdate_[id32];
-    if (timeoutUpdate_[id32] != 0 && current > timeoutUpdate_[id32] + updateTimeout_)
+    eOprotIndex_t eoprotIndex = eoprot_ID2index(id32);
+    eOabstime_t diff = current - timeoutUpdate_[eoprotIndex];
+    if (timeoutUpdate_[eoprotIndex] != 0 && current > timeoutUpdate_[eoprotIndex] + updateTimeout_)
     {
-        yError() << device_->getBoardInfo() << " update timeout for index:" << eoprot_ID2index(id32);
-        timeoutUpdate_[id32] = current;
-        masStatus_[eoprot_ID2index(id32)] = MAS_TIMEOUT;
+        yError() << device_->getBoardInfo() << " update timeout for index:" << eoprotIndex;
+        timeoutUpdate_[eoprotIndex] = current;
+        masStatus_[eoprotIndex] = MAS_TIMEOUT;
         return false;
     }
-    timeoutUpdate_[id32] = current;
+    timeoutUpdate_[eoprotIndex] = current;
     return true;
 }
 
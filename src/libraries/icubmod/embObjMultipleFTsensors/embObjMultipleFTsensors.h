@@ -13,12 +13,14 @@
 #include <yarp/dev/MultipleAnalogSensorsInterfaces.h>
 #include <yarp/sig/Vector.h>
 
-#include <map>
+#include <array>
 #include <shared_mutex>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "embObjGeneralDevPrivData.h"
+#include "sampleHistory.h"
 #include "serviceParserMultipleFt.h"
 
 namespace yarp::dev
@@ -27,6 +29,7 @@ class embObjMultipleFTsensors;
 }
 
 static constexpr int ftChannels_{6};
+static constexpr size_t ftMaxSensors_{4};
 
 class FtData
 {
@@ -40,10 +43,19 @@ class FtData
 class TemperatureData
 {
    public:
-    eOmeas_temperature_t data_;
-    double timeStamp_;
+    eOmeas_temperature_t data_{0};
+    double timeStamp_{0};
+};
+
+// One measure of a sensor as kept in its history
+struct FtSample
+{
+    double data_[ftChannels_];
+    double temperature_;  // celsius
 };
 
+typedef eth::SampleHistory<FtSample> FtHistory;
+
 class yarp::dev::embObjMultipleFTsensors : public yarp::dev::DeviceDriver, public eth::IethResource, public yarp::dev::ITemperatureSensors, public yarp::dev::ISixAxisForceTorqueSensors
 {
    public:
@@ -74,12 +86,20 @@ class yarp::dev::embObjMultipleFTsensors : public yarp::dev::DeviceDriver, publi
     virtual bool getSixAxisForceTorqueSensorFrameName(size_t sensorindex, std::string& frameName) const override;
     virtual bool getSixAxisForceTorqueSensorMeasure(size_t sensorindex, yarp::sig::Vector& out, double& timestamp) const override;
 
+    // All the measures received after the one with sequence number after (0 for all those kept), oldest first.
+    // after is moved to the last one returned and lost tells how many were overwritten before being read:
+    // none if called at least once every historyCapacity_ measures of the sensor.
+    bool getSixAxisForceTorqueSensorSamples(size_t sensorindex, uint64_t& after, std::vector<FtHistory::Sample>& samples, uint64_t& lost) const;
+    // All the measures kept with a timestamp after since, oldest first
+    bool getSixAxisForceTorqueSensorSamples(size_t sensorindex, double since, std::vector<FtHistory::Sample>& samples) const;
+
    protected:
     std::shared_ptr<yarp::dev::embObjDevPrivData> device_;
     mutable std::shared_mutex mutex_;
-    std::map<eOprotID32_t, FtData> ftSensorsData_;
-    std::map<eOprotID32_t, TemperatureData> temperaturesensordata_;
-    std::map<eOprotID32_t, eOabstime_t> timeoutUpdate_;
+    std::vector<FtData> ftSensorsData_;                  // indexed by sensor, sized by sendConfig2boards()
+    std::vector<TemperatureData> temperaturesensordata_;
+    std::vector<FtHistory> ftHistory_;                   // written by update() only, read without mutex_
+    std::array<eOabstime_t, ftMaxSensors_> timeoutUpdate_{};
 
     bool sendConfig2boards(ServiceParserMultipleFt& parser, eth::AbstractEthResource* deviceRes);
     bool sendStart2boards(ServiceParserMultipleFt& parser, eth::AbstractEthResource* deviceRes);
@@ -88,6 +108,7 @@ class yarp::dev::embObjMultipleFTsensors : public yarp::dev::DeviceDriver, publi
     double calculateBoardTime(eOabstime_t current);
     bool checkUpdateTimeout(eOprotID32_t id32, eOabstime_t current);
     static constexpr eOabstime_t updateTimeout_{11000};
+    static constexpr size_t historyCapacity_{1024};  // about one second at the highest rate of the boards
     std::vector<yarp::dev::MAS_status> masStatus_{MAS_WAITING_FOR_FIRST_READ, MAS_WAITING_FOR_FIRST_READ, MAS_WAITING_FOR_FIRST_READ, MAS_WAITING_FOR_FIRST_READ};
 
     static constexpr bool checkUpdateTimeoutFlag_{false};  // Check timer disabled
@@ -8,6 +8,15 @@
 #include "fakeBoard.h"
 #define CAN_BCAST_POSITION 0x001
 
+// the bootloader class and commands of the iCub CAN protocol
+#define CAN_CLASS_BOOTLOADER 0x07
+#define CAN_BL_BOARD         0x00
+#define CAN_BL_ADDRESS       0x01
+#define CAN_BL_START         0x02
+#define CAN_BL_DATA          0x03
+#define CAN_BL_END           0x04
+#define CAN_BL_BROADCAST     0xFF
+
 #include <iostream>
 #include <stdlib.h>
 
@@ -17,6 +26,9 @@ FakeBoard::FakeBoard(int id, int p):yarp::os::PeriodicThread((double)p/1000.0)
 {
     canId=id;
     outMessages=0;
+    blType=-1;
+    blExpected=0;
+    blReceived=0;
 }
 
 FakeBoard::~FakeBoard()
@@ -24,12 +36,72 @@ FakeBoard::~FakeBoard()
 
 }
 
+void FakeBoard::runBootloader(const FCMSG &m)
+{
+    int dest=m.id&0x0f;
+    if (((m.id>>8)&0x07)!=CAN_CLASS_BOOTLOADER || (dest!=canId && dest!=0x0f) || m.len<1)
+        return;
+
+    FCMSG reply;
+    reply.id=(CAN_CLASS_BOOTLOADER<<8)|(canId<<4);
+    reply.len=2;
+    reply.data[0]=m.data[0];
+    reply.data[1]=1;
+
+    switch (m.data[0])
+    {
+    case CAN_BL_BROADCAST:
+        // type and version of the bootloader
+        reply.len=4;
+        reply.data[1]=(unsigned char)blType;
+        reply.data[2]=1;
+        reply.data[3]=0;
+        break;
+
+    case CAN_BL_ADDRESS:
+        // the number of bytes of the record which follows
+        blExpected=(m.len>1)?m.data[1]:0;
+        blReceived=0;
+        return;
+
+    case CAN_BL_DATA:
+        // one ack for the whole record
+        blReceived+=m.len-1;
+        if (blReceived<blExpected)
+            return;
+        blExpected=blReceived=0;
+        break;
+
+    case CAN_BL_BOARD:
+    case CAN_BL_START:
+    case CAN_BL_END:
+        break;
+
+    default:
+        return;
+    }
+
+    outMessages->lock();
+    outMessages->push_back(reply);
+    outMessages->unlock();
+}
+
 void FakeBoard::run()
 {
     //pop from list of messages
     inMessages.lock();
     MsgIt it=inMessages.begin();
 
+    if (blType>=0)
+    {
+        for (; it!=inMessages.end(); it++)
+            runBootloader(*it);
+
+        inMessages.clear();
+        inMessages.unlock();
+        return;
+    }
+
     while(it!=inMessages.end())
     {
         FCMSG &m=(*it);
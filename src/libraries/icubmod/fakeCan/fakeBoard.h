@@ -17,6 +17,13 @@ class FakeBoard: public yarp::os::PeriodicThread
     MsgList inMessages;
     MsgList *outMessages;
 
+    // bootloader emulation, see setBootloader()
+    int blType;
+    int blExpected;
+    int blReceived;
+
+    void runBootloader(const FCMSG &m);
+
 public:
     FakeBoard(int id=0, int p=100);
 
@@ -31,6 +38,16 @@ public:
         canId=id;
     }
 
+    /**
+     * The board runs the bootloader of a board of the given type
+     * (-1 for none): it answers to the discovery and acks the firmware
+     * download as the canLoader expects, and it does not stream.
+     */
+    void setBootloader(int type)
+    {
+        blType=type;
+    }
+
     void setReplyFifo(MsgList *outBuffer)
     {
         outMessages=outBuffer;
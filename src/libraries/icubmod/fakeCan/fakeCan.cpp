@@ -111,11 +111,16 @@ bool FakeCan::open(yarp::os::Searchable &par)
         return false;
     }
     
+    // optionally the boards run the bootloader, to test the canLoader
+    int bootloaderType=can.check("bootloaderType",Value(-1)).asInt32();
+    int period=can.check("boardPeriod",Value(100)).asInt32();
+
     for(int i=1;i<=njoints/2;i++)
     {
-        FakeBoard *tmp=new FakeBoard;
+        FakeBoard *tmp=new FakeBoard(0,period);
         int id=ids.get(i).asInt32();
         tmp->setId(id);   //just as a test
+        tmp->setBootloader(bootloaderType);
         tmp->setReplyFifo(&replies);
         tmp->start();
         boardList.push_back(tmp);
@@ -267,6 +267,35 @@ public:
     virtual RBFKernel* getKernel() {
         return this->kernel;
     }
+
+    /**
+     * Accessor for the stored input samples, which make up the kernel
+     * expansion of the predictions.
+     *
+     * @returns a reference to the input samples
+     */
+    const std::vector<yarp::sig::Vector>& getInputs() const {
+        return this->inputs;
+    }
+
+    /**
+     * Accessor for the Lagrange multipliers, with one row per input sample
+     * and one column per output.
+     *
+     * @returns a reference to the matrix of coefficients
+     */
+    const yarp::sig::Matrix& getAlphas() const {
+        return this->alphas;
+    }
+
+    /**
+     * Accessor for the biases, one per output.
+     *
+     * @returns a reference to the vector of biases
+     */
+    const yarp::sig::Vector& getBias() const {
+        return this->bias;
+    }
 };
 
 } // learningmachine
@@ -0,0 +1,195 @@
+/*
+ * Copyright (C) 2022 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+// Solve time and iterations of CalibReferenceWithMatchedPoints and
+// AffinityWithMatchedPoints against the number of matched points, starting
+// either from the closed-form guess or from the middle of the bounds as
+// before; the distance between the two solutions is reported as well.
+//
+// calibReferenceBenchmark [--points "(100 1000 10000 100000)"] [--noise 0.001] [--seed 1]
+
+#include <cstdio>
+#include <cmath>
+
+#include <yarp/os/all.h>
+#include <yarp/sig/all.h>
+#include <yarp/math/Math.h>
+#include <yarp/math/Rand.h>
+
+#include <iCub/ctrl/math.h>
+#include <iCub/optimization/calibReference.h>
+#include <iCub/optimization/affinity.h>
+
+using namespace std;
+using namespace yarp::os;
+using namespace yarp::sig;
+using namespace yarp::math;
+using namespace iCub::ctrl;
+using namespace iCub::optimization;
+
+
+/****************************************************************/
+struct Outcome
+{
+    double time;
+    int iter;
+    double error;
+    Matrix H;
+};
+
+
+/****************************************************************/
+void fill(MatrixTransformationWithMatchedPoints &calib, const Matrix &M,
+          const size_t N, const double noise)
+{
+    calib.clearPoints();
+    for (size_t i=0; i<N; i++)
+    {
+        Vector p0=Rand::vector(Vector(3,-0.3),Vector(3,0.3));
+        p0.push_back(1.0);
+
+        Vector p1=M*p0;
+        for (int j=0; j<3; j++)
+            p1[j]+=noise*Rand::scalar(-1.0,1.0);
+
+        calib.addPoints(p0,p1);
+    }
+}
+
+
+/****************************************************************/
+Outcome runRigid(CalibReferenceWithMatchedPoints &calib, const bool init)
+{
+    Property options;
+    options.put("closed_form_init",init?"on":"off");
+    calib.setCalibrationOptions(options);
+
+    Outcome out;
+    double t0=Time::now();
+    calib.calibrate(out.H,out.error);
+    out.time=Time::now()-t0;
+    out.iter=calib.getNumIterations();
+
+    return out;
+}
+
+
+/****************************************************************/
+Outcome runScaled(CalibReferenceWithMatchedPoints &calib, const bool init)
+{
+    Property options;
+    options.put("closed_form_init",init?"on":"off");
+    calib.setCalibrationOptions(options);
+
+    Outcome out; double s;
+    double t0=Time::now();
+    calib.calibrate(out.H,s,out.error);
+    out.time=Time::now()-t0;
+    out.iter=calib.getNumIterations();
+
+    Matrix S=eye(4,4);
+    S(0,0)=S(1,1)=S(2,2)=s;
+    out.H=S*out.H;
+
+    return out;
+}
+
+
+/****************************************************************/
+Outcome runAffine(AffinityWithMatchedPoints &calib, const bool init)
+{
+    Property options;
+    options.put("closed_form_init",init?"on":"off");
+    calib.setCalibrationOptions(options);
+
+    Outcome out;
+    double t0=Time::now();
+    calib.calibrate(out.H,out.error);
+    out.time=Time::now()-t0;
+    out.iter=calib.getNumIterations();
+
+    return out;
+}
+
+
+/****************************************************************/
+void report(const char *problem, const size_t N, const Outcome &on,
+            const Outcome &off, const Matrix &M)
+{
+    double diff=0.0,truth=0.0;
+    for (int r=0; r<3; r++)
+    {
+        for (int c=0; c<4; c++)
+        {
+            diff=std::max(diff,fabs(on.H(r,c)-off.H(r,c)));
+            truth=std::max(truth,fabs(on.H(r,c)-M(r,c)));
+        }
+    }
+
+    printf("%-8s %7zu | %8.3f s %4d it %.6f | %8.3f s %4d it %.6f | %.2e %.2e\n",
+           problem,N,on.time,on.iter,on.error,off.time,off.iter,off.error,diff,truth);
+}
+
+
+/****************************************************************/
+int main(int argc, char *argv[])
+{
+    Property options;
+    options.fromCommand(argc,argv);
+
+    Bottle defPoints; defPoints.fromString("100 1000 10000 100000");
+    Bottle *points=options.find("points").asList();
+    if (points==NULL)
+        points=&defPoints;
+
+    double noise=options.check("noise",Value(0.001)).asFloat64();
+    Rand::init(options.check("seed",Value(1)).asInt32());
+
+    // ground truth within the default bounds
+    Vector x(4); x[0]=0.3; x[1]=-0.8; x[2]=0.5; x[3]=2.0;
+    Matrix H=axis2dcm(x);
+    H(0,3)=0.2; H(1,3)=-0.1; H(2,3)=0.35;
+
+    Matrix S=eye(4,4);
+    S(0,0)=S(1,1)=S(2,2)=1.2;
+
+    Matrix A=S*H;
+    A(0,1)+=0.1; A(2,0)-=0.05;
+
+    printf("problem        N |   closed-form init (time iter error) |       legacy init (time iter error) | |dH| |H-H*|\n");
+
+    CalibReferenceWithMatchedPoints calib;
+    AffinityWithMatchedPoints affinity;
+
+    Matrix min=eye(4,4),max=eye(4,4);
+    for (int r=0; r<3; r++)
+    {
+        for (int c=0; c<4; c++)
+        {
+            min(r,c)=-2.0;
+            max(r,c)=2.0;
+        }
+    }
+    affinity.setBounds(min,max);
+
+    for (size_t i=0; i<points->size(); i++)
+    {
+        size_t N=(size_t)points->get(i).asInt32();
+
+        fill(calib,H,N,noise);
+        report("rigid",N,runRigid(calib,true),runRigid(calib,false),H);
+
+        fill(calib,S*H,N,noise);
+        report("scaled",N,runScaled(calib,true),runScaled(calib,false),S*H);
+
+        fill(affinity,A,N,noise);
+        report("affine",N,runAffine(affinity,true),runAffine(affinity,false),A);
+    }
+
+    return 0;
+}
@@ -55,6 +55,10 @@ protected:
 
     int max_iter;
     double tol;
+
+    bool A0_given;
+    bool closed_form_init;
+    int iterations;
     
     std::deque<yarp::sig::Vector> p0;
     std::deque<yarp::sig::Vector> p1;
@@ -121,9 +125,28 @@ public:
     * @param options a Property-like object accounting for 
     *               calibration options.
     * @return true/false on success/fail. 
+    *  
+    * @note Available options are: 
+    *  
+    * \b max_iter <int>: maximum number of iterations. 
+    *  
+    * \b tol <double>: tolerance. 
+    *  
+    * \b closed_form_init <string>: "on" (default) to start the 
+    *    optimization from the unconstrained least-squares
+    *    solution, "off" to start from the middle of the bounds.
+    *    It does not apply to the guess given explicitly with
+    *    setInitialGuess().
     */
     virtual bool setCalibrationOptions(const yarp::os::Property &options);
 
+    /**
+    * Return the number of iterations performed by the solver 
+    * during the last optimization. 
+    * @return the number of iterations. 
+    */
+    virtual int getNumIterations() const { return iterations; }
+
     /**
     * Perform optimization to determine the affine matrix A. 
     * @param A the final affine matrix that links the two clouds of 
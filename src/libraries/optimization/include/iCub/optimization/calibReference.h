@@ -64,6 +64,11 @@ protected:
     double max_s_scalar;
     double s0_scalar;
 
+    bool x0_given;
+    bool s0_given;
+    bool closed_form_init;
+    int iterations;
+
     std::deque<yarp::sig::Vector> p0;
     std::deque<yarp::sig::Vector> p1;
 
@@ -188,9 +193,29 @@ public:
     * @param options a Property-like object accounting for 
     *               calibration options.
     * @return true/false on success/fail. 
+    *  
+    * @note Available options are: 
+    *  
+    * \b max_iter <int>: maximum number of iterations. 
+    *  
+    * \b tol <double>: tolerance. 
+    *  
+    * \b closed_form_init <string>: "on" (default) to start the 
+    *    optimization from the closed-form least-squares
+    *    similarity between the two sets of points, "off" to start
+    *    from the middle of the bounds. It does not apply to the
+    *    guesses given explicitly with setInitialGuess() and
+    *    setScalingInitialGuess().
     */
     virtual bool setCalibrationOptions(const yarp::os::Property &options);
 
+    /**
+    * Return the number of iterations performed by the solver 
+    * during the last calibration. 
+    * @return the number of iterations. 
+    */
+    virtual int getNumIterations() const { return iterations; }
+
     /**
     * Perform reference calibration to determine the matrix H. 
     * @param H the final roto-translation matrix that links the two 
@@ -23,6 +23,9 @@
 
 #include <IpTNLP.hpp>
 #include <IpIpoptApplication.hpp>
+#include <IpSolveStatistics.hpp>
+
+#include "matchedPoints.h"
 
 using namespace std;
 using namespace yarp::os;
@@ -50,14 +53,25 @@ inline Matrix computeA(const Ipopt::Number *x)
 }
 
 
+/****************************************************************/
+inline void computeAffine(const Ipopt::Number *x, double A[3][3], double b[3])
+{
+    for (int r=0; r<3; r++)
+    {
+        for (int c=0; c<3; c++)
+            A[r][c]=x[3*c+r];
+        b[r]=x[9+r];
+    }
+}
+
+
 /****************************************************************/
 class AffinityWithMatchedPointsNLP : public Ipopt::TNLP
 {
 protected:    
-    const deque<Vector> &p0;
-    const deque<Vector> &p1;
+    const MatchedPointsMoments &moments;
 
-    deque<Matrix> dA;
+    double G[4][4];
     Matrix min;
     Matrix max;
     Matrix A0;
@@ -65,23 +79,23 @@ protected:
 
 public:
     /****************************************************************/
-    AffinityWithMatchedPointsNLP(const deque<Vector> &_p0,
-                                 const deque<Vector> &_p1,
+    AffinityWithMatchedPointsNLP(const MatchedPointsMoments &_moments,
                                  const Matrix &_min, const Matrix &_max) :
-                                 p0(_p0), p1(_p1)
+                                 moments(_moments)
     {
         min=_min;
         max=_max;
         A0=0.5*(min+max);
-        
-        for (int c=0; c<A0.cols(); c++)
+
+        // (1/N)*sum(p0*p0^T) in homogeneous coordinates:
+        // the objective is quadratic, hence its hessian is constant
+        for (int r=0; r<3; r++)
         {
-            for (int r=0; r<A0.rows()-1; r++)
-            {
-                Matrix dA=zeros(4,4); dA(r,c)=1.0;
-                this->dA.push_back(dA);
-            }
+            for (int c=0; c<3; c++)
+                G[r][c]=moments.C00[r][c]+moments.m0[r]*moments.m0[c];
+            G[r][3]=G[3][r]=moments.m0[r];
         }
+        G[3][3]=1.0;
     }
 
     /****************************************************************/
@@ -103,7 +117,8 @@ public:
                       Ipopt::Index &nnz_h_lag, IndexStyleEnum &index_style)
     {
         n=12;
-        m=nnz_jac_g=nnz_h_lag=0;
+        m=nnz_jac_g=0;
+        nnz_h_lag=3*10;
         index_style=TNLP::C_STYLE;
 
         return true;
@@ -146,16 +161,9 @@ public:
     bool eval_f(Ipopt::Index n, const Ipopt::Number *x, bool new_x,
                 Ipopt::Number &obj_value)
     {
-        Matrix A=computeA(x);
-
-        obj_value=0.0;
-        if (p0.size()>0)
-        {
-            for (size_t i=0; i<p0.size(); i++)
-                obj_value+=norm2(p1[i]-A*p0[i]);
-
-            obj_value/=p0.size();
-        }
+        double A[3][3],b[3];
+        computeAffine(x,A,b);
+        obj_value=moments.eval(A,b);
 
         return true;
     }
@@ -164,21 +172,15 @@ public:
     bool eval_grad_f(Ipopt::Index n, const Ipopt::Number* x, bool new_x,
                      Ipopt::Number *grad_f)
     {
-        Matrix A=computeA(x);
-        for (Ipopt::Index i=0; i<n; i++)
-            grad_f[i]=0.0;
+        double A[3][3],b[3],dA[3][3],db[3];
+        computeAffine(x,A,b);
+        moments.grad(A,b,dA,db);
 
-        if (p0.size()>0)
+        for (int r=0; r<3; r++)
         {
-            for (size_t i=0; i<p0.size(); i++)
-            {
-                Vector d=p1[i]-A*p0[i];
-                for (Ipopt::Index j=0; j<n; j++)
-                    grad_f[j]-=2.0*dot(d,(dA[j]*p0[i]));
-            }
-
-            for (Ipopt::Index i=0; i<n; i++)
-                grad_f[i]/=p0.size();
+            for (int c=0; c<3; c++)
+                grad_f[3*c+r]=dA[r][c];
+            grad_f[9+r]=db[r];
         }
 
         return true;
@@ -205,6 +207,27 @@ public:
                 bool new_lambda, Ipopt::Index nele_hess, Ipopt::Index *iRow,
                 Ipopt::Index *jCol, Ipopt::Number *values)
     {
+        // lower triangle: the entries x[3*c+r] and x[3*c'+r'] are
+        // coupled only when r=r', by 2*G(c,c')
+        Ipopt::Index i=0;
+        for (int r=0; r<3; r++)
+        {
+            for (int c=0; c<4; c++)
+            {
+                for (int c_=0; c_<=c; c_++)
+                {
+                    if (values==NULL)
+                    {
+                        iRow[i]=3*c+r;
+                        jCol[i]=3*c_+r;
+                    }
+                    else
+                        values[i]=obj_factor*2.0*G[c][c_];
+                    i++;
+                }
+            }
+        }
+
         return true;
     }
     
@@ -242,6 +265,9 @@ AffinityWithMatchedPoints::AffinityWithMatchedPoints()
     }
 
     A0=0.5*(min+max);
+    A0_given=false;
+    closed_form_init=true;
+    iterations=0;
 }
 
 
@@ -264,16 +290,7 @@ void AffinityWithMatchedPoints::setBounds(const Matrix &min,
 /****************************************************************/
 double AffinityWithMatchedPoints::evalError(const Matrix &A)
 {
-    double error=0.0;
-    if (p0.size()>0)
-    {
-        for (size_t i=0; i<p0.size(); i++)
-            error+=norm(p1[i]-A*p0[i]);
-
-        error/=p0.size();
-    }
-
-    return error;
+    return evalMatchedPointsError(p0,p1,A);
 }
 
 
@@ -319,6 +336,7 @@ bool AffinityWithMatchedPoints::setInitialGuess(const Matrix &A)
     int row_max=(int)std::min(A0.rows()-1,A.rows()-1);
     int col_max=(int)std::min(A0.cols(),A.cols());
     A0.setSubmatrix(A.submatrix(0,row_max,0,col_max),0,0);
+    A0_given=true;
 
     return true;
 }
@@ -333,6 +351,9 @@ bool AffinityWithMatchedPoints::setCalibrationOptions(const Property &options)
     if (options.check("tol"))
         tol=options.find("tol").asFloat64();
 
+    if (options.check("closed_form_init"))
+        closed_form_init=(options.find("closed_form_init").asString()=="on");
+
     return true;
 }
 
@@ -351,15 +372,34 @@ bool AffinityWithMatchedPoints::calibrate(Matrix &A, double &error)
         app->Options()->SetStringValue("jac_c_constant","yes");
         app->Options()->SetStringValue("jac_d_constant","yes");
         app->Options()->SetStringValue("hessian_constant","yes");
-        app->Options()->SetStringValue("hessian_approximation","limited-memory");
+        app->Options()->SetStringValue("hessian_approximation","exact");
         app->Options()->SetIntegerValue("print_level",0);
         app->Options()->SetStringValue("derivative_test","none");
         app->Initialize();
 
-        Ipopt::SmartPtr<AffinityWithMatchedPointsNLP> nlp=new AffinityWithMatchedPointsNLP(p0,p1,min,max);
+        MatchedPointsMoments moments(p0,p1);
+        Ipopt::SmartPtr<AffinityWithMatchedPointsNLP> nlp=new AffinityWithMatchedPointsNLP(moments,min,max);
+
+        Matrix A_cf; Vector b_cf;
+        if (closed_form_init && !A0_given && moments.affinity(A_cf,b_cf))
+        {
+            // the unconstrained solution, clamped within the bounds
+            Matrix guess=eye(4,4);
+            for (int r=0; r<3; r++)
+            {
+                for (int c=0; c<4; c++)
+                {
+                    double v=(c<3)?A_cf(r,c):b_cf[r];
+                    guess(r,c)=std::max(min(r,c),std::min(max(r,c),v));
+                }
+            }
+            nlp->set_A0(guess);
+        }
+        else
+            nlp->set_A0(A0);
 
-        nlp->set_A0(A0);
         Ipopt::ApplicationReturnStatus status=app->OptimizeTNLP(GetRawPtr(nlp));
+        iterations=IsValid(app->Statistics())?app->Statistics()->IterationCount():0;
 
         A=nlp->get_result();
         error=evalError(A);
@@ -24,6 +24,9 @@
 
 #include <IpTNLP.hpp>
 #include <IpIpoptApplication.hpp>
+#include <IpSolveStatistics.hpp>
+
+#include "matchedPoints.h"
 
 using namespace std;
 using namespace yarp::os;
@@ -60,24 +63,116 @@ inline Matrix computeH(const Ipopt::Number *x)
 }
 
 
+/****************************************************************/
+inline void mul3(const double A[3][3], const double B[3][3], double C[3][3])
+{
+    for (int r=0; r<3; r++)
+        for (int c=0; c<3; c++)
+            C[r][c]=A[r][0]*B[0][c]+A[r][1]*B[1][c]+A[r][2]*B[2][c];
+}
+
+
+/****************************************************************/
+inline void computeR(const Ipopt::Number *x, double R[3][3], double dR[3][3][3])
+{
+    // R=Rz(x[3])*Ry(x[4])*Rz(x[5]), as euler2dcm() does
+    double ca=cos(x[3]);  double sa=sin(x[3]);
+    double cb=cos(x[4]);  double sb=sin(x[4]);
+    double cg=cos(x[5]);  double sg=sin(x[5]);
+
+    const double Rza[3][3]={{ca,-sa,0.0},{sa,ca,0.0},{0.0,0.0,1.0}};
+    const double dRza[3][3]={{-sa,-ca,0.0},{ca,-sa,0.0},{0.0,0.0,0.0}};
+    const double Ryb[3][3]={{cb,0.0,sb},{0.0,1.0,0.0},{-sb,0.0,cb}};
+    const double dRyb[3][3]={{-sb,0.0,cb},{0.0,0.0,0.0},{-cb,0.0,-sb}};
+    const double Rzg[3][3]={{cg,-sg,0.0},{sg,cg,0.0},{0.0,0.0,1.0}};
+    const double dRzg[3][3]={{-sg,-cg,0.0},{cg,-sg,0.0},{0.0,0.0,0.0}};
+
+    double T[3][3];
+    mul3(Ryb,Rzg,T);   mul3(Rza,T,R);   mul3(dRza,T,dR[0]);
+    mul3(dRyb,Rzg,T);  mul3(Rza,T,dR[1]);
+    mul3(Ryb,dRzg,T);  mul3(Rza,T,dR[2]);
+}
+
+
+/****************************************************************/
+inline bool computeClosedFormGuess(const MatchedPointsMoments &moments,
+                                   const bool scaled, Vector &x, double &c)
+{
+    // p1=c*R*p0+t in least-squares sense, to be expressed
+    // either as R*p0+t (c=1) or as c*(R*p0+t/c)
+    Matrix R; Vector t;
+    if (!moments.similarity(R,t,c))
+        return false;
+
+    Matrix H=eye(4,4);
+    H.setSubmatrix(R,0,0);
+    Vector euler=dcm2euler(H);
+
+    x.resize(6);
+    for (int i=0; i<3; i++)
+    {
+        double Rm0=R(i,0)*moments.m0[0]+R(i,1)*moments.m0[1]+R(i,2)*moments.m0[2];
+        x[i]=scaled?t[i]/c:moments.m1[i]-Rm0;
+        x[3+i]=euler[i];
+    }
+
+    return true;
+}
+
+
+/****************************************************************/
+inline Vector clampGuess(const Vector &x, const Vector &min, const Vector &max)
+{
+    Vector y=x;
+    for (size_t i=0; i<y.length(); i++)
+        y[i]=std::max(min[i],std::min(max[i],y[i]));
+
+    return y;
+}
+
+
 /****************************************************************/
 class CalibReferenceWithMatchedPointsNLP : public Ipopt::TNLP
 {
 protected:
-    const deque<Vector> &p0;
-    const deque<Vector> &p1;
+    const MatchedPointsMoments &moments;
 
     Vector min;
     Vector max;
     Vector x0;
     Vector x;
 
+    /****************************************************************/
+    virtual void get_scaling(const Ipopt::Number *x, double *s) const
+    {
+        s[0]=s[1]=s[2]=1.0;
+    }
+
+    /****************************************************************/
+    virtual void set_scaling_grad(const double *ds, Ipopt::Number *grad_f) const
+    {
+    }
+
+    /****************************************************************/
+    void computeAffine(const Ipopt::Number *x, double R[3][3], double dR[3][3][3],
+                       double s[3], double A[3][3], double b[3]) const
+    {
+        // S*H*p=A*p+b
+        computeR(x,R,dR);
+        get_scaling(x,s);
+        for (int r=0; r<3; r++)
+        {
+            for (int c=0; c<3; c++)
+                A[r][c]=s[r]*R[r][c];
+            b[r]=s[r]*x[r];
+        }
+    }
+
 public:
     /****************************************************************/
-    CalibReferenceWithMatchedPointsNLP(const deque<Vector> &_p0,
-                                       const deque<Vector> &_p1,
+    CalibReferenceWithMatchedPointsNLP(const MatchedPointsMoments &_moments,
                                        const Vector &_min, const Vector &_max) :
-                                       p0(_p0), p1(_p1)
+                                       moments(_moments)
     {
         min=_min;
         max=_max;
@@ -137,16 +232,9 @@ public:
     bool eval_f(Ipopt::Index n, const Ipopt::Number *x, bool new_x,
                 Ipopt::Number &obj_value)
     {
-        Matrix H=computeH(x);
-
-        obj_value=0.0;
-        if (p0.size()>0)
-        {
-            for (size_t i=0; i<p0.size(); i++)
-                obj_value+=norm2(p1[i]-H*p0[i]);
-
-            obj_value/=p0.size();
-        }
+        double R[3][3],dR[3][3][3],s[3],A[3][3],b[3];
+        computeAffine(x,R,dR,s,A,b);
+        obj_value=moments.eval(A,b);
 
         return true;
     }
@@ -155,52 +243,31 @@ public:
     bool eval_grad_f(Ipopt::Index n, const Ipopt::Number* x, bool new_x,
                      Ipopt::Number *grad_f)
     {
-        double ca=cos(x[3]);  double sa=sin(x[3]);
-        double cb=cos(x[4]);  double sb=sin(x[4]);
-        double cg=cos(x[5]);  double sg=sin(x[5]);
-
-        Matrix Rza=eye(4,4);
-        Rza(0,0)=ca;   Rza(1,1)=ca;   Rza(1,0)=sa;   Rza(0,1)=-sa;
-        Matrix dRza=zeros(4,4);
-        dRza(0,0)=-sa; dRza(1,1)=-sa; dRza(1,0)=ca;  dRza(0,1)=-ca;
-
-        Matrix Rzg=eye(4,4);
-        Rzg(0,0)=cg;   Rzg(1,1)=cg;   Rzg(1,0)=sg;   Rzg(0,1)=-sg;
-        Matrix dRzg=zeros(4,4);
-        dRzg(0,0)=-sg; dRzg(1,1)=-sg; dRzg(1,0)=cg;  dRzg(0,1)=-cg;
-
-        Matrix Ryb=eye(4,4);
-        Ryb(0,0)=cb;   Ryb(2,2)=cb;   Ryb(2,0)=-sb;  Ryb(0,2)=sb;
-        Matrix dRyb=zeros(4,4);
-        dRyb(0,0)=-sb; dRyb(2,2)=-sb; dRyb(2,0)=-cb; dRyb(0,2)=cb;
-
-        Matrix dHdx0=zeros(4,4); dHdx0(0,3)=1.0;
-        Matrix dHdx1=zeros(4,4); dHdx1(1,3)=1.0;
-        Matrix dHdx2=zeros(4,4); dHdx2(2,3)=1.0;
-        Matrix dHdx3=dRza*Ryb*Rzg;
-        Matrix dHdx4=Rza*dRyb*Rzg;
-        Matrix dHdx5=Rza*Ryb*dRzg;
-
-        Matrix H=computeH(x);
-        grad_f[0]=grad_f[1]=grad_f[2]=0.0;
-        grad_f[3]=grad_f[4]=grad_f[5]=0.0;
-        if (p0.size()>0)
+        double R[3][3],dR[3][3][3],s[3],A[3][3],b[3];
+        computeAffine(x,R,dR,s,A,b);
+
+        double dA[3][3],db[3];
+        moments.grad(A,b,dA,db);
+
+        double ds[3];
+        for (int r=0; r<3; r++)
         {
-            for (size_t i=0; i<p0.size(); i++)
-            {
-                Vector d=p1[i]-H*p0[i];
-                grad_f[0]-=2.0*dot(d,(dHdx0*p0[i]));
-                grad_f[1]-=2.0*dot(d,(dHdx1*p0[i]));
-                grad_f[2]-=2.0*dot(d,(dHdx2*p0[i]));
-                grad_f[3]-=2.0*dot(d,(dHdx3*p0[i]));
-                grad_f[4]-=2.0*dot(d,(dHdx4*p0[i]));
-                grad_f[5]-=2.0*dot(d,(dHdx5*p0[i]));
-            }
-
-            for (Ipopt::Index i=0; i<n; i++)
-                grad_f[i]/=p0.size();
+            grad_f[r]=s[r]*db[r];
+            ds[r]=db[r]*x[r];
+            for (int c=0; c<3; c++)
+                ds[r]+=dA[r][c]*R[r][c];
         }
 
+        for (int k=0; k<3; k++)
+        {
+            grad_f[3+k]=0.0;
+            for (int r=0; r<3; r++)
+                for (int c=0; c<3; c++)
+                    grad_f[3+k]+=dA[r][c]*s[r]*dR[k][r][c];
+        }
+
+        set_scaling_grad(ds,grad_f);
+
         return true;
     }
 
@@ -246,12 +313,28 @@ public:
 /****************************************************************/
 class CalibReferenceWithScaledMatchedPointsNLP : public CalibReferenceWithMatchedPointsNLP
 {
+protected:
+    /****************************************************************/
+    void get_scaling(const Ipopt::Number *x, double *s) const
+    {
+        s[0]=x[6];
+        s[1]=x[7];
+        s[2]=x[8];
+    }
+
+    /****************************************************************/
+    void set_scaling_grad(const double *ds, Ipopt::Number *grad_f) const
+    {
+        grad_f[6]=ds[0];
+        grad_f[7]=ds[1];
+        grad_f[8]=ds[2];
+    }
+
 public:
     /****************************************************************/
-    CalibReferenceWithScaledMatchedPointsNLP(const deque<Vector> &_p0,
-                                             const deque<Vector> &_p1,
+    CalibReferenceWithScaledMatchedPointsNLP(const MatchedPointsMoments &_moments,
                                              const Vector &_min, const Vector &_max) :
-                                             CalibReferenceWithMatchedPointsNLP(_p0,_p1,_min,_max) { }
+                                             CalibReferenceWithMatchedPointsNLP(_moments,_min,_max) { }
 
     /****************************************************************/
     bool get_nlp_info(Ipopt::Index &n, Ipopt::Index &m, Ipopt::Index &nnz_jac_g,
@@ -262,108 +345,30 @@ public:
 
         return true;
     }
+};
 
+
+/****************************************************************/
+class CalibReferenceWithScalarScaledMatchedPointsNLP : public CalibReferenceWithMatchedPointsNLP
+{
+protected:
     /****************************************************************/
-    bool eval_f(Ipopt::Index n, const Ipopt::Number *x, bool new_x,
-                Ipopt::Number &obj_value)
+    void get_scaling(const Ipopt::Number *x, double *s) const
     {
-        Matrix H=computeH(x);
-        Vector s(4);
-        s[0]=x[6];
-        s[1]=x[7];
-        s[2]=x[8];
-        s[3]=1.0;
-
-        obj_value=0.0;
-        if (p0.size()>0)
-        {
-            for (size_t i=0; i<p0.size(); i++)
-                obj_value+=norm2(p1[i]-s*(H*p0[i]));
-
-            obj_value/=p0.size();
-        }
-
-        return true;
+        s[0]=s[1]=s[2]=x[6];
     }
-    
+
     /****************************************************************/
-    bool eval_grad_f(Ipopt::Index n, const Ipopt::Number* x, bool new_x,
-                     Ipopt::Number *grad_f)
+    void set_scaling_grad(const double *ds, Ipopt::Number *grad_f) const
     {
-        double ca=cos(x[3]);  double sa=sin(x[3]);
-        double cb=cos(x[4]);  double sb=sin(x[4]);
-        double cg=cos(x[5]);  double sg=sin(x[5]);
-
-        Matrix Rza=eye(4,4);
-        Rza(0,0)=ca;   Rza(1,1)=ca;   Rza(1,0)=sa;   Rza(0,1)=-sa;
-        Matrix dRza=zeros(4,4);
-        dRza(0,0)=-sa; dRza(1,1)=-sa; dRza(1,0)=ca;  dRza(0,1)=-ca;
-
-        Matrix Rzg=eye(4,4);
-        Rzg(0,0)=cg;   Rzg(1,1)=cg;   Rzg(1,0)=sg;   Rzg(0,1)=-sg;
-        Matrix dRzg=zeros(4,4);
-        dRzg(0,0)=-sg; dRzg(1,1)=-sg; dRzg(1,0)=cg;  dRzg(0,1)=-cg;
-
-        Matrix Ryb=eye(4,4);
-        Ryb(0,0)=cb;   Ryb(2,2)=cb;   Ryb(2,0)=-sb;  Ryb(0,2)=sb;
-        Matrix dRyb=zeros(4,4);
-        dRyb(0,0)=-sb; dRyb(2,2)=-sb; dRyb(2,0)=-cb; dRyb(0,2)=cb;
-
-        Matrix dHdx0=zeros(4,4); dHdx0(0,3)=1.0;
-        Matrix dHdx1=zeros(4,4); dHdx1(1,3)=1.0;
-        Matrix dHdx2=zeros(4,4); dHdx2(2,3)=1.0;
-        Matrix dHdx3=dRza*Ryb*Rzg;
-        Matrix dHdx4=Rza*dRyb*Rzg;
-        Matrix dHdx5=Rza*Ryb*dRzg;
-
-        Matrix H=computeH(x);
-        Matrix dHdx6=zeros(4,4); dHdx6(0,0)=1.0; dHdx6*=H;
-        Matrix dHdx7=zeros(4,4); dHdx7(1,1)=1.0; dHdx7*=H;
-        Matrix dHdx8=zeros(4,4); dHdx8(2,2)=1.0; dHdx8*=H;
-
-        Vector s(4);
-        s[0]=x[6];
-        s[1]=x[7];
-        s[2]=x[8];
-        s[3]=1.0;
-
-        grad_f[0]=grad_f[1]=grad_f[2]=0.0;
-        grad_f[3]=grad_f[4]=grad_f[5]=0.0;
-        grad_f[6]=grad_f[7]=grad_f[8]=0.0;
-        if (p0.size()>0)
-        {
-            for (size_t i=0; i<p0.size(); i++)
-            {
-                Vector d=p1[i]-s*(H*p0[i]);
-                grad_f[0]-=2.0*dot(d,(dHdx0*p0[i]));
-                grad_f[1]-=2.0*dot(d,(dHdx1*p0[i]));
-                grad_f[2]-=2.0*dot(d,(dHdx2*p0[i]));
-                grad_f[3]-=2.0*dot(d,(dHdx3*p0[i]));
-                grad_f[4]-=2.0*dot(d,(dHdx4*p0[i]));
-                grad_f[5]-=2.0*dot(d,(dHdx5*p0[i]));
-                grad_f[6]-=2.0*dot(d,(dHdx6*p0[i]));
-                grad_f[7]-=2.0*dot(d,(dHdx7*p0[i]));
-                grad_f[8]-=2.0*dot(d,(dHdx8*p0[i]));
-            }
-
-            for (Ipopt::Index i=0; i<n; i++)
-                grad_f[i]/=p0.size();
-        }
-
-        return true;
+        grad_f[6]=ds[0]+ds[1]+ds[2];
     }
-};
-
 
-/****************************************************************/
-class CalibReferenceWithScalarScaledMatchedPointsNLP : public CalibReferenceWithMatchedPointsNLP
-{
 public:
     /****************************************************************/
-    CalibReferenceWithScalarScaledMatchedPointsNLP(const deque<Vector> &_p0,
-                                                   const deque<Vector> &_p1,
+    CalibReferenceWithScalarScaledMatchedPointsNLP(const MatchedPointsMoments &_moments,
                                                    const Vector &_min, const Vector &_max) :
-                                                   CalibReferenceWithMatchedPointsNLP(_p0,_p1,_min,_max) { }
+                                                   CalibReferenceWithMatchedPointsNLP(_moments,_min,_max) { }
 
     /****************************************************************/
     bool get_nlp_info(Ipopt::Index &n, Ipopt::Index &m, Ipopt::Index &nnz_jac_g,
@@ -374,88 +379,6 @@ public:
 
         return true;
     }
-
-    /****************************************************************/
-    bool eval_f(Ipopt::Index n, const Ipopt::Number *x, bool new_x,
-                Ipopt::Number &obj_value)
-    {
-        Matrix H=computeH(x);
-        Vector s(4);
-        s[0]=s[1]=s[2]=x[6];
-        s[3]=1.0;
-
-        obj_value=0.0;
-        if (p0.size()>0)
-        {
-            for (size_t i=0; i<p0.size(); i++)
-                obj_value+=norm2(p1[i]-s*(H*p0[i]));
-
-            obj_value/=p0.size();
-        }
-
-        return true;
-    }
-    
-    /****************************************************************/
-    bool eval_grad_f(Ipopt::Index n, const Ipopt::Number* x, bool new_x,
-                     Ipopt::Number *grad_f)
-    {
-        double ca=cos(x[3]);  double sa=sin(x[3]);
-        double cb=cos(x[4]);  double sb=sin(x[4]);
-        double cg=cos(x[5]);  double sg=sin(x[5]);
-
-        Matrix Rza=eye(4,4);
-        Rza(0,0)=ca;   Rza(1,1)=ca;   Rza(1,0)=sa;   Rza(0,1)=-sa;
-        Matrix dRza=zeros(4,4);
-        dRza(0,0)=-sa; dRza(1,1)=-sa; dRza(1,0)=ca;  dRza(0,1)=-ca;
-
-        Matrix Rzg=eye(4,4);
-        Rzg(0,0)=cg;   Rzg(1,1)=cg;   Rzg(1,0)=sg;   Rzg(0,1)=-sg;
-        Matrix dRzg=zeros(4,4);
-        dRzg(0,0)=-sg; dRzg(1,1)=-sg; dRzg(1,0)=cg;  dRzg(0,1)=-cg;
-
-        Matrix Ryb=eye(4,4);
-        Ryb(0,0)=cb;   Ryb(2,2)=cb;   Ryb(2,0)=-sb;  Ryb(0,2)=sb;
-        Matrix dRyb=zeros(4,4);
-        dRyb(0,0)=-sb; dRyb(2,2)=-sb; dRyb(2,0)=-cb; dRyb(0,2)=cb;
-
-        Matrix dHdx0=zeros(4,4); dHdx0(0,3)=1.0;
-        Matrix dHdx1=zeros(4,4); dHdx1(1,3)=1.0;
-        Matrix dHdx2=zeros(4,4); dHdx2(2,3)=1.0;
-        Matrix dHdx3=dRza*Ryb*Rzg;
-        Matrix dHdx4=Rza*dRyb*Rzg;
-        Matrix dHdx5=Rza*Ryb*dRzg;
-
-        Matrix H=computeH(x);
-        Matrix dHdx6=zeros(4,4); dHdx6(0,0)=1.0; dHdx6*=H;
-
-        Vector s(4);
-        s[0]=s[1]=s[2]=x[6];
-        s[3]=1.0;
-
-        grad_f[0]=grad_f[1]=grad_f[2]=0.0;
-        grad_f[3]=grad_f[4]=grad_f[5]=0.0;
-        grad_f[6]=0.0;
-        if (p0.size()>0)
-        {
-            for (size_t i=0; i<p0.size(); i++)
-            {
-                Vector d=p1[i]-s*(H*p0[i]);
-                grad_f[0]-=2.0*dot(d,(dHdx0*p0[i]));
-                grad_f[1]-=2.0*dot(d,(dHdx1*p0[i]));
-                grad_f[2]-=2.0*dot(d,(dHdx2*p0[i]));
-                grad_f[3]-=2.0*dot(d,(dHdx3*p0[i]));
-                grad_f[4]-=2.0*dot(d,(dHdx4*p0[i]));
-                grad_f[5]-=2.0*dot(d,(dHdx5*p0[i]));
-                grad_f[6]-=2.0*dot(d,(dHdx6*p0[i]));
-            }
-
-            for (Ipopt::Index i=0; i<n; i++)
-                grad_f[i]/=p0.size();
-        }
-
-        return true;
-    }
 };
 
 }
@@ -487,6 +410,10 @@ CalibReferenceWithMatchedPoints::CalibReferenceWithMatchedPoints()
     x0=0.5*(min+max);
     s0.resize(3,1.0);
     s0_scalar=1.0;
+
+    x0_given=s0_given=false;
+    closed_form_init=true;
+    iterations=0;
 }
 
 
@@ -550,16 +477,7 @@ void CalibReferenceWithMatchedPoints::setScalingBounds(const double min,
 /****************************************************************/
 double CalibReferenceWithMatchedPoints::evalError(const Matrix &H)
 {
-    double error=0.0;
-    if (p0.size()>0)
-    {
-        for (size_t i=0; i<p0.size(); i++)
-            error+=norm(p1[i]-H*p0[i]);
-
-        error/=p0.size();
-    }
-
-    return error;
+    return evalMatchedPointsError(p0,p1,H);
 }
 
 
@@ -607,6 +525,7 @@ bool CalibReferenceWithMatchedPoints::setInitialGuess(const Matrix &H)
         Vector euler=dcm2euler(H);
         x0[0]=H(0,3);   x0[1]=H(1,3);   x0[2]=H(2,3);
         x0[3]=euler[0]; x0[4]=euler[1]; x0[5]=euler[2];
+        x0_given=true;
 
         return true;
     }
@@ -621,6 +540,7 @@ bool CalibReferenceWithMatchedPoints::setScalingInitialGuess(const Vector &s)
     if (s.length()>=s0.length())
     {
         s0=s.subVector(0,(unsigned int)s0.length()-1);
+        s0_given=true;
         return true;
     }
     else
@@ -632,6 +552,7 @@ bool CalibReferenceWithMatchedPoints::setScalingInitialGuess(const Vector &s)
 bool CalibReferenceWithMatchedPoints::setScalingInitialGuess(const double s)
 {
     s0_scalar=s;
+    s0_given=true;
     return true;
 }
 
@@ -645,6 +566,9 @@ bool CalibReferenceWithMatchedPoints::setCalibrationOptions(const Property &opti
     if (options.check("tol"))
         tol=options.find("tol").asFloat64();
 
+    if (options.check("closed_form_init"))
+        closed_form_init=(options.find("closed_form_init").asString()=="on");
+
     return true;
 }
 
@@ -665,10 +589,17 @@ bool CalibReferenceWithMatchedPoints::calibrate(Matrix &H, double &error)
         app->Options()->SetStringValue("derivative_test","none");
         app->Initialize();
 
-        Ipopt::SmartPtr<CalibReferenceWithMatchedPointsNLP> nlp=new CalibReferenceWithMatchedPointsNLP(p0,p1,min,max);
+        MatchedPointsMoments moments(p0,p1);
+        Ipopt::SmartPtr<CalibReferenceWithMatchedPointsNLP> nlp=new CalibReferenceWithMatchedPointsNLP(moments,min,max);
+
+        Vector x_cf; double c;
+        if (closed_form_init && !x0_given && computeClosedFormGuess(moments,false,x_cf,c))
+            nlp->set_x0(clampGuess(x_cf,min,max));
+        else
+            nlp->set_x0(x0);
 
-        nlp->set_x0(x0);
         Ipopt::ApplicationReturnStatus status=app->OptimizeTNLP(GetRawPtr(nlp));
+        iterations=IsValid(app->Statistics())?app->Statistics()->IterationCount():0;
 
         Vector x=nlp->get_result();
         H=computeH(x);
@@ -698,10 +629,20 @@ bool CalibReferenceWithMatchedPoints::calibrate(Matrix &H, Vector &s,
         app->Options()->SetStringValue("derivative_test","none");
         app->Initialize();
 
-        Ipopt::SmartPtr<CalibReferenceWithScaledMatchedPointsNLP> nlp=new CalibReferenceWithScaledMatchedPointsNLP(p0,p1,cat(min,min_s),cat(max,max_s));
+        MatchedPointsMoments moments(p0,p1);
+        Ipopt::SmartPtr<CalibReferenceWithScaledMatchedPointsNLP> nlp=new CalibReferenceWithScaledMatchedPointsNLP(moments,cat(min,min_s),cat(max,max_s));
+
+        Vector x_cf; double c;
+        if (closed_form_init && !(x0_given && s0_given) && computeClosedFormGuess(moments,true,x_cf,c))
+        {
+            Vector guess=cat(x0_given?x0:x_cf,s0_given?s0:Vector(3,c));
+            nlp->set_x0(clampGuess(guess,cat(min,min_s),cat(max,max_s)));
+        }
+        else
+            nlp->set_x0(cat(x0,s0));
 
-        nlp->set_x0(cat(x0,s0));
         Ipopt::ApplicationReturnStatus status=app->OptimizeTNLP(GetRawPtr(nlp));
+        iterations=IsValid(app->Statistics())?app->Statistics()->IterationCount():0;
 
         Vector x=nlp->get_result();
         H=computeH(x);
@@ -734,10 +675,20 @@ bool CalibReferenceWithMatchedPoints::calibrate(Matrix &H, double &s,
         app->Options()->SetStringValue("derivative_test","none");
         app->Initialize();
 
-        Ipopt::SmartPtr<CalibReferenceWithScalarScaledMatchedPointsNLP> nlp=new CalibReferenceWithScalarScaledMatchedPointsNLP(p0,p1,cat(min,min_s_scalar),cat(max,max_s_scalar));
+        MatchedPointsMoments moments(p0,p1);
+        Ipopt::SmartPtr<CalibReferenceWithScalarScaledMatchedPointsNLP> nlp=new CalibReferenceWithScalarScaledMatchedPointsNLP(moments,cat(min,min_s_scalar),cat(max,max_s_scalar));
+
+        Vector x_cf; double c;
+        if (closed_form_init && !(x0_given && s0_given) && computeClosedFormGuess(moments,true,x_cf,c))
+        {
+            Vector guess=cat(x0_given?x0:x_cf,s0_given?s0_scalar:c);
+            nlp->set_x0(clampGuess(guess,cat(min,min_s_scalar),cat(max,max_s_scalar)));
+        }
+        else
+            nlp->set_x0(cat(x0,s0_scalar));
 
-        nlp->set_x0(cat(x0,s0_scalar));
         Ipopt::ApplicationReturnStatus status=app->OptimizeTNLP(GetRawPtr(nlp));
+        iterations=IsValid(app->Statistics())?app->Statistics()->IterationCount():0;
 
         Vector x=nlp->get_result();
         H=computeH(x);
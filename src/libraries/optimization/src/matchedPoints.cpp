@@ -0,0 +1,228 @@
+/*
+ * Copyright (C) 2022 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <cmath>
+
+#include <yarp/math/Math.h>
+#include <yarp/math/SVD.h>
+
+#include "matchedPoints.h"
+
+using namespace std;
+using namespace yarp::sig;
+using namespace yarp::math;
+using namespace iCub::optimization;
+
+
+/****************************************************************/
+MatchedPointsMoments::MatchedPointsMoments(const deque<Vector> &p0,
+                                           const deque<Vector> &p1)
+{
+    N=std::min(p0.size(),p1.size());
+    s11=0.0;
+    for (int r=0; r<3; r++)
+    {
+        m0[r]=m1[r]=0.0;
+        for (int c=0; c<3; c++)
+            C00[r][c]=C10[r][c]=0.0;
+    }
+
+    if (N==0)
+        return;
+
+    // two passes: centroids first, then the centered sums
+    for (size_t i=0; i<N; i++)
+    {
+        const double *a=p0[i].data();
+        const double *b=p1[i].data();
+        for (int r=0; r<3; r++)
+        {
+            m0[r]+=a[r];
+            m1[r]+=b[r];
+        }
+    }
+
+    for (int r=0; r<3; r++)
+    {
+        m0[r]/=N;
+        m1[r]/=N;
+    }
+
+    for (size_t i=0; i<N; i++)
+    {
+        const double *a=p0[i].data();
+        const double *b=p1[i].data();
+        double q0[3]={a[0]-m0[0],a[1]-m0[1],a[2]-m0[2]};
+        double q1[3]={b[0]-m1[0],b[1]-m1[1],b[2]-m1[2]};
+
+        s11+=q1[0]*q1[0]+q1[1]*q1[1]+q1[2]*q1[2];
+        for (int r=0; r<3; r++)
+        {
+            for (int c=0; c<3; c++)
+            {
+                C00[r][c]+=q0[r]*q0[c];
+                C10[r][c]+=q1[r]*q0[c];
+            }
+        }
+    }
+
+    s11/=N;
+    for (int r=0; r<3; r++)
+    {
+        for (int c=0; c<3; c++)
+        {
+            C00[r][c]/=N;
+            C10[r][c]/=N;
+        }
+    }
+}
+
+
+/****************************************************************/
+double MatchedPointsMoments::eval(const double A[3][3], const double b[3]) const
+{
+    // (1/N)*sum(|q1-A*q0|^2)+|m1-A*m0-b|^2, since q0 and q1 sum up to zero
+    double f=s11;
+    for (int r=0; r<3; r++)
+    {
+        double AC00[3]={0.0,0.0,0.0};
+        for (int c=0; c<3; c++)
+            for (int k=0; k<3; k++)
+                AC00[c]+=A[r][k]*C00[k][c];
+
+        double e=m1[r]-b[r];
+        for (int c=0; c<3; c++)
+        {
+            f+=AC00[c]*A[r][c]-2.0*A[r][c]*C10[r][c];
+            e-=A[r][c]*m0[c];
+        }
+
+        f+=e*e;
+    }
+
+    return f;
+}
+
+
+/****************************************************************/
+void MatchedPointsMoments::grad(const double A[3][3], const double b[3],
+                                double dA[3][3], double db[3]) const
+{
+    for (int r=0; r<3; r++)
+    {
+        double e=m1[r]-b[r];
+        for (int c=0; c<3; c++)
+            e-=A[r][c]*m0[c];
+
+        db[r]=-2.0*e;
+        for (int c=0; c<3; c++)
+        {
+            double AC00=0.0;
+            for (int k=0; k<3; k++)
+                AC00+=A[r][k]*C00[k][c];
+
+            dA[r][c]=2.0*(AC00-C10[r][c])-2.0*e*m0[c];
+        }
+    }
+}
+
+
+/****************************************************************/
+bool MatchedPointsMoments::similarity(Matrix &R, Vector &t, double &c) const
+{
+    double var0=C00[0][0]+C00[1][1]+C00[2][2];
+    if ((N<3) || (var0<=0.0))
+        return false;
+
+    Matrix C(3,3);
+    for (int r=0; r<3; r++)
+        for (int k=0; k<3; k++)
+            C(r,k)=C10[r][k];
+
+    Matrix U(3,3),V(3,3);
+    Vector D(3);
+    SVD(C,U,D,V);
+
+    // reflections are not rotations
+    Matrix S=eye(3,3);
+    if (det(U)*det(V)<0.0)
+        S(2,2)=-1.0;
+
+    R=U*S*V.transposed();
+    c=(D[0]+D[1]+S(2,2)*D[2])/var0;
+    if (c<=0.0)
+        return false;
+
+    t.resize(3);
+    for (int r=0; r<3; r++)
+        t[r]=m1[r]-c*(R(r,0)*m0[0]+R(r,1)*m0[1]+R(r,2)*m0[2]);
+
+    return true;
+}
+
+
+/****************************************************************/
+bool MatchedPointsMoments::affinity(Matrix &A, Vector &b) const
+{
+    if (N<4)
+        return false;
+
+    Matrix C(3,3);
+    for (int r=0; r<3; r++)
+        for (int k=0; k<3; k++)
+            C(r,k)=C00[r][k];
+
+    if (fabs(det(C))<1e-12*pow(C(0,0)+C(1,1)+C(2,2),3.0))
+        return false;
+
+    Matrix Ci=luinv(C);
+    A.resize(3,3);
+    b.resize(3);
+    for (int r=0; r<3; r++)
+    {
+        for (int k=0; k<3; k++)
+            A(r,k)=C10[r][0]*Ci(0,k)+C10[r][1]*Ci(1,k)+C10[r][2]*Ci(2,k);
+
+        b[r]=m1[r]-(A(r,0)*m0[0]+A(r,1)*m0[1]+A(r,2)*m0[2]);
+    }
+
+    return true;
+}
+
+
+/****************************************************************/
+double iCub::optimization::evalMatchedPointsError(const deque<Vector> &p0,
+                                                  const deque<Vector> &p1,
+                                                  const Matrix &M)
+{
+    double error=0.0;
+    if (p0.size()>0)
+    {
+        const double *m=M.data();
+        for (size_t i=0; i<p0.size(); i++)
+        {
+            const double *a=p0[i].data();
+            const double *b=p1[i].data();
+
+            double d2=0.0;
+            for (int r=0; r<4; r++)
+            {
+                const double *row=m+4*r;
+                double d=b[r]-(row[0]*a[0]+row[1]*a[1]+row[2]*a[2]+row[3]*a[3]);
+                d2+=d*d;
+            }
+
+            error+=sqrt(d2);
+        }
+
+        error/=p0.size();
+    }
+
+    return error;
+}
+
@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2022 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef __ICUB_OPT_MATCHEDPOINTS_H__
+#define __ICUB_OPT_MATCHEDPOINTS_H__
+
+#include <deque>
+#include <yarp/sig/all.h>
+
+namespace iCub
+{
+
+namespace optimization
+{
+
+/**
+* First and second order moments of two sets of matching 3D
+* points, out of which the mean squared residual
+* (1/N)*sum(|p1-A*p0-b|^2) of any affine map (A,b) and its
+* derivatives are computed in constant time, whatever the number
+* of points. The moments are taken about the centroids to
+* preserve the accuracy with clouds far from the origin.
+*/
+class MatchedPointsMoments
+{
+public:
+    size_t N;
+    double m0[3],m1[3];     // centroids
+    double C00[3][3];       // (1/N)*sum(q0*q0^T), with q0=p0-m0
+    double C10[3][3];       // (1/N)*sum(q1*q0^T), with q1=p1-m1
+    double s11;             // (1/N)*sum(q1^T*q1)
+
+    MatchedPointsMoments(const std::deque<yarp::sig::Vector> &p0,
+                         const std::deque<yarp::sig::Vector> &p1);
+
+    double eval(const double A[3][3], const double b[3]) const;
+    void grad(const double A[3][3], const double b[3],
+              double dA[3][3], double db[3]) const;
+
+    /**
+    * Closed-form least-squares similarity p1=c*R*p0+t (Umeyama).
+    * @return false if the points are degenerate.
+    */
+    bool similarity(yarp::sig::Matrix &R, yarp::sig::Vector &t, double &c) const;
+
+    /**
+    * Closed-form unconstrained least-squares affinity p1=A*p0+b.
+    * @return false if the points are degenerate.
+    */
+    bool affinity(yarp::sig::Matrix &A, yarp::sig::Vector &b) const;
+};
+
+
+/**
+* Mean norm of the residuals p1-M*p0 for a 4x4 homogeneous M.
+*/
+double evalMatchedPointsError(const std::deque<yarp::sig::Vector> &p0,
+                              const std::deque<yarp::sig::Vector> &p1,
+                              const yarp::sig::Matrix &M);
+
+}
+
+}
+
+#endif
+
@@ -0,0 +1,196 @@
+/*
+ * Copyright (C) 2022 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+// Calls per second of the springy fingers output of one hand, when the five
+// fingers are evaluated one by one through their sensors and the result is
+// packed in a Bottle, as SpringyFingersModel formerly did, and when the joints
+// and the analogs are read once and the fingers are evaluated all together by
+// SpringyFingersBatch, together with the largest deviation between the two.
+// The sensors replay a grasp from a synthetic recording; the machines are
+// trained with a given number of samples per finger.
+//
+// springyFingersBenchmark [--calls 20000] [--samples 60]
+
+#include <cstdio>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+
+#include <yarp/os/all.h>
+#include <yarp/dev/all.h>
+#include <yarp/sig/all.h>
+
+#include <iCub/perception/private/ports.h>
+#include <iCub/perception/sensors.h>
+#include <iCub/perception/springyFingers.h>
+
+using namespace std;
+using namespace yarp::os;
+using namespace yarp::dev;
+using namespace yarp::sig;
+using namespace iCub::perception;
+
+
+/***************************************************************************/
+class ReplayEncoders : public IEncoders
+{
+public:
+    Vector encs;
+
+    ReplayEncoders() : encs(16,0.0) { }
+    bool getAxes(int *ax) override { *ax=(int)encs.length(); return true; }
+    bool resetEncoder(int j) override { return false; }
+    bool resetEncoders() override { return false; }
+    bool setEncoder(int j, double val) override { return false; }
+    bool setEncoders(const double *vals) override { return false; }
+    bool getEncoder(int j, double *v) override { *v=encs[j]; return true; }
+    bool getEncoders(double *encs) override { for (size_t i=0; i<this->encs.length(); i++) encs[i]=this->encs[i]; return true; }
+    bool getEncoderSpeed(int j, double *sp) override { *sp=0.0; return true; }
+    bool getEncoderSpeeds(double *spds) override { return false; }
+    bool getEncoderAcceleration(int j, double *spds) override { *spds=0.0; return true; }
+    bool getEncoderAccelerations(double *accs) override { return false; }
+};
+
+
+/***************************************************************************/
+class ReplayPort : public iCub::perception::Port
+{
+public:
+    void replay(Bottle &analogs) { onRead(analogs); }
+};
+
+
+/***************************************************************************/
+const int joints[5]={10, 12, 14, 15, 15};
+const vector<int> analogs[5]={{1, 2}, {4, 5}, {7, 8}, {9, 10, 11}, {12, 13, 14}};
+
+
+/***************************************************************************/
+void setJoint(ReplayEncoders &encs, Vector &analog, const int f,
+              const double q, const double contact)
+{
+    encs.encs[joints[f]]=q;
+    for (size_t c=0; c<analogs[f].size(); c++)
+        analog[analogs[f][c]]=60.0+(1.2+0.3*c)*q+8.0*sin(0.05*q+f)+contact*(c+1);
+}
+
+
+/***************************************************************************/
+void replay(ReplayPort &port, const Vector &analog)
+{
+    Bottle b;
+    for (size_t i=0; i<analog.length(); i++)
+        b.addFloat64(analog[i]);
+    port.replay(b);
+}
+
+
+/***************************************************************************/
+int main(int argc, char *argv[])
+{
+    Network yarp;
+    Property options;
+    options.fromCommand(argc,argv);
+
+    int calls=options.check("calls",Value(20000)).asInt32();
+    int samples=options.check("samples",Value(60)).asInt32();
+
+    ReplayEncoders encs;
+    ReplayPort port;
+    Vector analog(15,0.0);
+    void *pEncs=static_cast<void*>(static_cast<IEncoders*>(&encs));
+    void *pPort=static_cast<void*>(static_cast<iCub::perception::Port*>(&port));
+
+    const char *names[5]={"thumb", "index", "middle", "ring", "little"};
+    SensorEncoders sensEncs[5];
+    SensorPort sensPort[5][3];
+    SpringyFinger fingers[5];
+    SpringyFingersBatch batch;
+
+    for (int f=0; f<5; f++)
+    {
+        Property prop;
+        prop.put("name",names[f]);
+        fingers[f].fromProperty(prop);
+
+        Property propEncs("(name In_0)");
+        propEncs.put("size",(int)encs.encs.length());
+        propEncs.put("index",joints[f]);
+        sensEncs[f].configure(pEncs,propEncs);
+        fingers[f].attachSensor(sensEncs[f]);
+
+        for (size_t c=0; c<analogs[f].size(); c++)
+        {
+            Property propPort;
+            propPort.put("name","Out_"+to_string(c));
+            propPort.put("index",analogs[f][c]);
+            sensPort[f][c].configure(pPort,propPort);
+            fingers[f].attachSensor(sensPort[f][c]);
+        }
+
+        // calibration sweep
+        for (int k=0; k<samples; k++)
+        {
+            double q=10.0+80.0*(0.5+0.5*sin(0.11*k+0.7*f));
+            setJoint(encs,analog,f,q,0.0);
+            replay(port,analog);
+            fingers[f].calibrate(Property("(feed)"));
+        }
+        fingers[f].calibrate(Property("(train)"));
+
+        batch.addFinger(fingers[f],joints[f],analogs[f]);
+    }
+
+    // the grasp: fingers closing at different speeds until they touch
+    vector<Vector> recEncs,recAnalogs;
+    for (int frame=0; frame<200; frame++)
+    {
+        for (int f=0; f<5; f++)
+        {
+            double q=std::min(90.0,10.0+(0.4+0.1*f)*frame);
+            double contact=(q>50.0+5.0*f)?0.8*(q-50.0-5.0*f):0.0;
+            setJoint(encs,analog,f,q,contact);
+        }
+        recEncs.push_back(encs.encs);
+        recAnalogs.push_back(analog);
+    }
+
+    double tFingers=0.0,tBatch=0.0,dev=0.0;
+    Vector batchEncs(encs.encs.length()),batchAnalogs,out;
+    for (int k=0; k<calls; k++)
+    {
+        size_t frame=k%recEncs.size();
+        encs.encs=recEncs[frame];
+        replay(port,recAnalogs[frame]);
+
+        double t0=Time::now();
+        Value val[5];
+        for (int f=0; f<5; f++)
+            fingers[f].getOutput(val[f]);
+        Bottle bOut; Bottle &ins=bOut.addList();
+        for (int f=0; f<5; f++)
+            ins.addFloat64(val[f].asFloat64());
+        Value fingersOut=bOut.get(0);
+        tFingers+=Time::now()-t0;
+
+        t0=Time::now();
+        encs.getEncoders(batchEncs.data());
+        port.getValues(batchAnalogs);
+        batch.evaluate(batchEncs,batchAnalogs,out);
+        tBatch+=Time::now()-t0;
+
+        for (int f=0; f<5; f++)
+            dev=std::max(dev,fabs(out[f]-fingersOut.asList()->get(f).asFloat64()));
+    }
+
+    printf("samples | fingers [calls/s] | batch [calls/s] | speed-up | max deviation\n");
+    printf("%7d | %17.0f | %15.0f | %8.2f | %.2e\n",samples,
+           calls/tFingers,calls/tBatch,tFingers/tBatch,dev);
+
+    return 0;
+}
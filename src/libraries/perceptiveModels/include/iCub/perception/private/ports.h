@@ -23,6 +23,7 @@
 #include <yarp/os/Value.h>
 #include <yarp/os/Bottle.h>
 #include <yarp/os/BufferedPort.h>
+#include <yarp/sig/Vector.h>
 
 
 namespace iCub
@@ -42,6 +43,7 @@ protected:
 public:
     Port();
     yarp::os::Value getValue(const int index);
+    void getValues(yarp::sig::Vector &values);
 };
 
 
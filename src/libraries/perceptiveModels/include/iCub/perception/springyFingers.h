@@ -57,6 +57,7 @@
 #define __PERCEPTIVEMODELS_SPRINGYFINGERS_H__
 
 #include <mutex>
+#include <vector>
 
 #include <yarp/os/all.h>
 #include <yarp/dev/all.h>
@@ -89,10 +90,17 @@ protected:
     double  calibratingVelocity;
     double  outputGain;
     bool    calibrated;
+    unsigned int version;
 
     bool extractSensorsData(yarp::sig::Vector &in, yarp::sig::Vector &out) const;
+    friend class SpringyFingersBatch;
 
 public:
+    /**
+    * Constructor. 
+    */
+    SpringyFinger();
+
     /**
     * Configure the finger taking its parameters from a Property 
     * object. 
@@ -194,6 +202,103 @@ public:
 };
 
 
+/**
+* @ingroup SpringyFingers
+*  
+* A class that evaluates a set of springy fingers all at once on 
+* raw data, i.e. on the joints and analogs readings acquired in 
+* one go for all the fingers, rather than through the sensors 
+* attached to each finger. 
+*  
+* The support vectors and the coefficients of the fingers 
+* machines are packed contiguously and refreshed whenever a 
+* finger gets configured or calibrated, so that every finger 
+* output is computed in one pass over its kernel expansion. 
+*/
+class SpringyFingersBatch
+{
+protected:
+    struct Item
+    {
+        const SpringyFinger *finger;
+        int          joint;
+        int          analogs[3];
+        int          numAnalogs;
+        unsigned int version;
+        size_t       offset;
+        size_t       size;
+        double       gamma;
+        double       bias[3];
+    };
+
+    std::vector<Item>   items;
+    std::vector<double> sv;
+    std::vector<double> alphas;
+    bool packed;
+
+    bool pack();
+
+public:
+    /**
+    * Constructor. 
+    */
+    SpringyFingersBatch();
+
+    /**
+    * Add a finger to the set. 
+    * @param finger the finger, which is referred to and not copied.
+    * @param joint the index of the finger joint within the joints 
+    *              readings, as for the "In_0" sensor.
+    * @param analogs the indexes of the distal joints within the 
+    *                analogs readings, as for the "Out_0", "Out_1"
+    *                and "Out_2" sensors.
+    * @return true/false on success/failure. 
+    */
+    bool addFinger(const SpringyFinger &finger, const int joint,
+                   const std::vector<int> &analogs);
+
+    /**
+    * Remove all the fingers from the set.
+    */
+    void clear();
+
+    /**
+    * Return the number of fingers in the set.
+    * @return the number of fingers.
+    */
+    size_t getNumFingers() const
+    {
+        return items.size();
+    }
+
+    /**
+    * Evaluate the outputs of all the fingers. 
+    * @param joints the joints readings.
+    * @param numJoints the number of joints readings.
+    * @param analogs the analogs readings; missing readings are 
+    *                taken as zero, as the port sensors do.
+    * @param numAnalogs the number of analogs readings.
+    * @param out the array filled with the fingers outputs, in the 
+    *            form output_gain*norm(out-pred), ordered as the
+    *            fingers were added.
+    * @return true/false on success/failure. 
+    */
+    bool evaluate(const double *joints, const size_t numJoints,
+                  const double *analogs, const size_t numAnalogs,
+                  double *out);
+
+    /**
+    * Evaluate the outputs of all the fingers. 
+    * @param joints the joints readings.
+    * @param analogs the analogs readings.
+    * @param out the vector filled with the fingers outputs.
+    * @return true/false on success/failure. 
+    */
+    bool evaluate(const yarp::sig::Vector &joints, const yarp::sig::Vector &analogs,
+                  yarp::sig::Vector &out);
+};
+
+
 /**
 * @ingroup SpringyFingers
 *  
@@ -215,6 +320,11 @@ private:
 
     yarp::os::BufferedPort<yarp::os::Bottle> *port;
     yarp::dev::PolyDriver                     driver;
+    yarp::dev::IEncoders                     *ienc;
+
+    // getOutput() is const but repacks the batch whenever a finger changes
+    mutable SpringyFingersBatch batch;
+    mutable std::mutex          mtxBatch;
 
     std::mutex mtx;
 
@@ -333,6 +443,17 @@ public:
     */
     bool getOutput(yarp::os::Value &out) const;    
 
+    /**
+    * Retrieve the complete output of the model as a vector. 
+    * The joints and the analogs are read once for all the fingers,
+    * which are then evaluated all together. 
+    * @param out a Vector containing the outputs of the fingers in 
+    *            the order thumb, index, middle, ring and little.
+    * @return true/false on success/failure. 
+    * @see SpringyFingersBatch 
+    */
+    bool getOutput(yarp::sig::Vector &out) const;
+
     /**
     * Destructor. 
     */
@@ -19,6 +19,7 @@
 
 using namespace std;
 using namespace yarp::os;
+using namespace yarp::sig;
 using namespace iCub::perception;
 
 
@@ -49,5 +50,15 @@ Value iCub::perception::Port::getValue(const int index)
 }
 
 
+/************************************************************************/
+void iCub::perception::Port::getValues(Vector &values)
+{
+    lock_guard<mutex> lck(mtx);
+
+    values.resize(bottle.size());
+    for (size_t i=0; i<values.length(); i++)
+        values[i]=bottle.get(i).asFloat64();
+}
+
 
 
@@ -38,6 +38,37 @@ using namespace iCub::ctrl;
 using namespace iCub::learningmachine;
 using namespace iCub::perception;
 
+namespace
+{
+    // layout of the sensors of the fingers, in the order thumb, index,
+    // middle, ring and little: the joint feeding "In_0" and the analogs
+    // feeding "Out_0", "Out_1" and "Out_2"
+    struct FingerLayout
+    {
+        int joint;
+        vector<int> analogs;
+    };
+
+    const FingerLayout fingersLayout[5]=
+    {
+        {10, {1, 2}},
+        {12, {4, 5}},
+        {14, {7, 8}},
+        {15, {9, 10, 11}},
+        {15, {12, 13, 14}}
+    };
+}
+
+
+/************************************************************************/
+SpringyFinger::SpringyFinger()
+{
+    calibratingVelocity=0.0;
+    outputGain=1.0;
+    calibrated=false;
+    version=0;
+}
+
 
 /************************************************************************/
 bool SpringyFinger::fromProperty(const Property &options)
@@ -49,6 +80,7 @@ bool SpringyFinger::fromProperty(const Property &options)
     callbacks.clear();
     neighbors.clear();
     lssvm.reset();
+    version++;
 
     name=options.find("name").asString();
 
@@ -229,6 +261,9 @@ bool SpringyFinger::getOutput(Value &out) const
 /************************************************************************/
 bool SpringyFinger::calibrate(const Property &options)
 {
+    // any change of the machine is to be caught by the batches
+    version++;
+
     if (options.check("reset"))
         lssvm.reset();
 
@@ -257,10 +292,164 @@ bool SpringyFinger::calibrate(const Property &options)
 }
 
 
+/************************************************************************/
+SpringyFingersBatch::SpringyFingersBatch()
+{
+    packed=false;
+}
+
+
+/************************************************************************/
+bool SpringyFingersBatch::addFinger(const SpringyFinger &finger, const int joint,
+                                    const vector<int> &analogs)
+{
+    if ((joint<0) || (analogs.size()<1) || (analogs.size()>3))
+        return false;
+
+    // the machine is packed at the next evaluation
+    Item item;
+    item.finger=&finger;
+    item.joint=joint;
+    item.numAnalogs=(int)analogs.size();
+    item.version=finger.version;
+    item.offset=0;
+    item.size=0;
+    item.gamma=0.0;
+    for (int i=0; i<3; i++)
+    {
+        item.analogs[i]=(i<item.numAnalogs)?analogs[i]:-1;
+        item.bias[i]=0.0;
+    }
+
+    items.push_back(item);
+    packed=false;
+
+    return true;
+}
+
+
+/************************************************************************/
+void SpringyFingersBatch::clear()
+{
+    items.clear();
+    sv.clear();
+    alphas.clear();
+    packed=false;
+}
+
+
+/************************************************************************/
+bool SpringyFingersBatch::pack()
+{
+    bool upToDate=packed;
+    for (size_t f=0; f<items.size(); f++)
+        upToDate&=(items[f].version==items[f].finger->version);
+
+    if (upToDate)
+        return true;
+
+    // support vectors of all the fingers lie one after the other,
+    // while the coefficients are laid out by output in blocks of
+    // three, padded with zeros for fingers having fewer outputs
+    packed=false;
+    sv.clear();
+    alphas.clear();
+    for (size_t f=0; f<items.size(); f++)
+    {
+        Item &item=items[f];
+        LSSVMLearner &lssvm=item.finger->lssvm;
+        if ((lssvm.getDomainSize()!=1) || ((int)lssvm.getCoDomainSize()!=item.numAnalogs))
+            return false;
+
+        const vector<Vector> &inputs=lssvm.getInputs();
+        const Matrix &A=lssvm.getAlphas();
+        const Vector &b=lssvm.getBias();
+
+        // an untrained machine predicts zeros
+        item.version=item.finger->version;
+        item.offset=sv.size();
+        item.size=((A.rows()==inputs.size()) && (b.length()==lssvm.getCoDomainSize()))?
+                  inputs.size():0;
+        item.gamma=lssvm.getKernel()->getGamma();
+        for (int c=0; c<3; c++)
+            item.bias[c]=((item.size>0) && (c<item.numAnalogs))?b[c]:0.0;
+
+        for (size_t i=0; i<item.size; i++)
+            sv.push_back(inputs[i][0]);
+
+        alphas.resize(3*sv.size(),0.0);
+        for (int c=0; c<item.numAnalogs; c++)
+            for (size_t i=0; i<item.size; i++)
+                alphas[3*item.offset+c*item.size+i]=A(i,c);
+    }
+
+    return packed=true;
+}
+
+
+/************************************************************************/
+bool SpringyFingersBatch::evaluate(const double *joints, const size_t numJoints,
+                                   const double *analogs, const size_t numAnalogs,
+                                   double *out)
+{
+    if (!pack())
+        return false;
+
+    for (size_t f=0; f<items.size(); f++)
+    {
+        const Item &item=items[f];
+        if ((size_t)item.joint>=numJoints)
+            return false;
+
+        IScaler &scaler=item.finger->scaler;
+        double x=scaler.transform(joints[item.joint]);
+
+        // one pass over the kernel expansion for all the outputs
+        const double *s=sv.data()+item.offset;
+        const double *a0=alphas.data()+3*item.offset;
+        const double *a1=a0+item.size;
+        const double *a2=a1+item.size;
+        double p0=0.0,p1=0.0,p2=0.0;
+        for (size_t i=0; i<item.size; i++)
+        {
+            double d=s[i]-x;
+            double k=exp(-item.gamma*(d*d));
+            p0+=a0[i]*k;
+            p1+=a1[i]*k;
+            p2+=a2[i]*k;
+        }
+
+        double pred[3]={p0+item.bias[0], p1+item.bias[1], p2+item.bias[2]};
+        double err2=0.0;
+        for (int c=0; c<item.numAnalogs; c++)
+        {
+            size_t j=(size_t)item.analogs[c];
+            double e=((j<numAnalogs)?analogs[j]:0.0)-scaler.unTransform(pred[c]);
+            err2+=e*e;
+        }
+
+        out[f]=item.finger->outputGain*sqrt(err2);
+    }
+
+    return true;
+}
+
+
+/************************************************************************/
+bool SpringyFingersBatch::evaluate(const Vector &joints, const Vector &analogs,
+                                   Vector &out)
+{
+    out.resize(items.size());
+    return evaluate(joints.data(),joints.length(),analogs.data(),
+                    analogs.length(),out.data());
+}
+
+
 /************************************************************************/
 SpringyFingersModel::SpringyFingersModel()
 {
     port=new iCub::perception::Port;
+    ienc=NULL;
     configured=false;
 }
 
@@ -302,7 +491,7 @@ bool SpringyFingersModel::fromProperty(const Property &options)
         return false;
     }
 
-    IEncoders *ienc; driver.view(ienc);
+    driver.view(ienc);
     int nAxes; ienc->getAxes(&nAxes);
 
     printMessage(log::info,1,"configuring interface-based sensors ...");
@@ -310,47 +499,27 @@ bool SpringyFingersModel::fromProperty(const Property &options)
     propGen.put("name","In_0");
     propGen.put("size",nAxes);
 
-    Property propThumb=propGen;  propThumb.put( "index",10);
-    Property propIndex=propGen;  propIndex.put( "index",12);
-    Property propMiddle=propGen; propMiddle.put("index",14);
-    Property propRing=propGen;   propRing.put(  "index",15);
-    Property propLittle=propGen; propLittle.put("index",15);
-
     bool sensors_ok=true;
     void *pEncs=static_cast<void*>(ienc);
-    sensors_ok&=sensEncs[0].configure(pEncs,propThumb);
-    sensors_ok&=sensEncs[1].configure(pEncs,propIndex);
-    sensors_ok&=sensEncs[2].configure(pEncs,propMiddle);
-    sensors_ok&=sensEncs[3].configure(pEncs,propRing);
-    sensors_ok&=sensEncs[4].configure(pEncs,propLittle);
+    for (int i=0; i<5; i++)
+    {
+        Property prop=propGen;
+        prop.put("index",fingersLayout[i].joint);
+        sensors_ok&=sensEncs[i].configure(pEncs,prop);
+    }
 
     printMessage(log::info,1,"configuring port-based sensors ...");
-    Property thumb_mp(  "(name Out_0) (index 1)" );
-    Property thumb_ip(  "(name Out_1) (index 2)" );
-    Property index_mp(  "(name Out_0) (index 4)" );
-    Property index_ip(  "(name Out_1) (index 5)" );
-    Property middle_mp( "(name Out_0) (index 7)" );
-    Property middle_ip( "(name Out_1) (index 8)" );
-    Property ring_mp(   "(name Out_0) (index 9)" );
-    Property ring_pip(  "(name Out_1) (index 10)");
-    Property ring_dip(  "(name Out_2) (index 11)");
-    Property little_mp( "(name Out_0) (index 12)");
-    Property little_pip("(name Out_1) (index 13)");
-    Property little_dip("(name Out_2) (index 14)");
-
     void *pPort=static_cast<void*>(port);
-    sensors_ok&=sensPort[0].configure(pPort,thumb_mp);
-    sensors_ok&=sensPort[1].configure(pPort,thumb_ip);
-    sensors_ok&=sensPort[2].configure(pPort,index_mp);
-    sensors_ok&=sensPort[3].configure(pPort,index_ip);
-    sensors_ok&=sensPort[4].configure(pPort,middle_mp);
-    sensors_ok&=sensPort[5].configure(pPort,middle_ip);
-    sensors_ok&=sensPort[6].configure(pPort,ring_mp);
-    sensors_ok&=sensPort[7].configure(pPort,ring_pip);
-    sensors_ok&=sensPort[8].configure(pPort,ring_dip);
-    sensors_ok&=sensPort[9].configure(pPort,little_mp);
-    sensors_ok&=sensPort[10].configure(pPort,little_pip);
-    sensors_ok&=sensPort[11].configure(pPort,little_dip);
+    for (int i=0,k=0; i<5; i++)
+    {
+        for (size_t c=0; c<fingersLayout[i].analogs.size(); c++,k++)
+        {
+            Property prop;
+            prop.put("name","Out_"+to_string(c));
+            prop.put("index",fingersLayout[i].analogs[c]);
+            sensors_ok&=sensPort[k].configure(pPort,prop);
+        }
+    }
 
     if (!sensors_ok)
     {
@@ -381,33 +550,20 @@ bool SpringyFingersModel::fromProperty(const Property &options)
     }
 
     printMessage(log::info,1,"attaching sensors to fingers ...");
-    fingers[0].attachSensor(sensEncs[0]);
-    fingers[0].attachSensor(sensPort[0]);
-    fingers[0].attachSensor(sensPort[1]);
-
-    fingers[1].attachSensor(sensEncs[1]);
-    fingers[1].attachSensor(sensPort[2]);
-    fingers[1].attachSensor(sensPort[3]);
-
-    fingers[2].attachSensor(sensEncs[2]);
-    fingers[2].attachSensor(sensPort[4]);
-    fingers[2].attachSensor(sensPort[5]);
-
-    fingers[3].attachSensor(sensEncs[3]);
-    fingers[3].attachSensor(sensPort[6]);
-    fingers[3].attachSensor(sensPort[7]);
-    fingers[3].attachSensor(sensPort[8]);
-
-    fingers[4].attachSensor(sensEncs[4]);
-    fingers[4].attachSensor(sensPort[9]);
-    fingers[4].attachSensor(sensPort[10]);
-    fingers[4].attachSensor(sensPort[11]);
-
-    attachNode(fingers[0]);
-    attachNode(fingers[1]);
-    attachNode(fingers[2]);
-    attachNode(fingers[3]);
-    attachNode(fingers[4]);
+    for (int i=0,k=0; i<5; i++)
+    {
+        fingers[i].attachSensor(sensEncs[i]);
+        for (size_t c=0; c<fingersLayout[i].analogs.size(); c++,k++)
+            fingers[i].attachSensor(sensPort[k]);
+
+        attachNode(fingers[i]);
+    }
+
+    // same layout of the sensors, for the evaluation all at once
+    lock_guard<mutex> lck(mtxBatch);
+    batch.clear();
+    for (int i=0; i<5; i++)
+        batch.addFinger(fingers[i],fingersLayout[i].joint,fingersLayout[i].analogs);
 
     printMessage(log::info,1,"configuration complete");
     return configured=true;
@@ -687,21 +843,12 @@ bool SpringyFingersModel::calibrate(const Property &options)
 /************************************************************************/
 bool SpringyFingersModel::getOutput(Value &out) const
 {
-    if (configured)
+    Vector fingersOut;
+    if (getOutput(fingersOut))
     {
-        Value val[5];
-        fingers[0].getOutput(val[0]);
-        fingers[1].getOutput(val[1]);
-        fingers[2].getOutput(val[2]);
-        fingers[3].getOutput(val[3]);
-        fingers[4].getOutput(val[4]);
-        
         Bottle bOut; Bottle &ins=bOut.addList();
-        ins.addFloat64(val[0].asFloat64());
-        ins.addFloat64(val[1].asFloat64());
-        ins.addFloat64(val[2].asFloat64());
-        ins.addFloat64(val[3].asFloat64());
-        ins.addFloat64(val[4].asFloat64());
+        for (size_t i=0; i<fingersOut.length(); i++)
+            ins.addFloat64(fingersOut[i]);
 
         out=bOut.get(0);
         return true;
@@ -711,6 +858,46 @@ bool SpringyFingersModel::getOutput(Value &out) const
 }
 
 
+/************************************************************************/
+bool SpringyFingersModel::getOutput(Vector &out) const
+{
+    if (configured)
+    {
+        int nAxes;
+        if (!ienc->getAxes(&nAxes))
+            return false;
+
+        Vector encs(nAxes),analogs;
+        if (!ienc->getEncoders(encs.data()))
+            return false;
+
+        static_cast<iCub::perception::Port*>(port)->getValues(analogs);
+
+        // resort to the fingers sensors if the machines cannot be packed
+        bool batched;
+        {
+            lock_guard<mutex> lck(mtxBatch);
+            batched=batch.evaluate(encs,analogs,out);
+        }
+
+        if (!batched)
+        {
+            out.resize(5);
+            for (int i=0; i<5; i++)
+            {
+                Value val;
+                fingers[i].getOutput(val);
+                out[i]=val.asFloat64();
+            }
+        }
+
+        return true;
+    }
+    else
+        return false;
+}
+
+
 /************************************************************************/
 void SpringyFingersModel::calibrateFinger(SpringyFinger &finger, const int joint,
                                           const double min, const double max)
@@ -819,6 +1006,10 @@ void SpringyFingersModel::close()
         port->close();
 
     nodes.clear();
+    mtxBatch.lock();
+    batch.clear();
+    mtxBatch.unlock();
+    ienc=NULL;
 
     configured=false;
 }
@@ -48,6 +48,8 @@ namespace skinDynLib
 */
 class skinContact : public dynContact
 {
+    friend class skinContactPacket;
+
 protected:
     // id of the skin patch where the contact is applied
     SkinPart skinPart;
@@ -0,0 +1,165 @@
+/*
+ * Copyright (C) 2022 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+/**
+ * Compact binary representation of a list of skin contacts.
+ *
+ * \section intro_sec Description
+ *
+ * A skinContactList travels as nested lists, one per contact, with every
+ * number tagged and every taxel id appended one by one. A skinContactPacket
+ * carries the same information as two blocks of fixed-layout data, one
+ * record per contact and one array with the ids of the active taxels (which
+ * can be left out), so that both ends transfer them with one copy and the
+ * receiver accesses the contacts in place without building any skinContact.
+ * The data are in the byte order of the sender, as all the machines of the
+ * robot are little endian.
+ *
+ * \section tested_os_sec Tested OS
+ *
+ * Windows, Linux
+ **/
+
+#ifndef __SKINCONTPACKET_H__
+#define __SKINCONTPACKET_H__
+
+#include <vector>
+#include <yarp/os/Portable.h>
+#include "iCub/skinDynLib/skinContact.h"
+#include "iCub/skinDynLib/skinContactList.h"
+
+namespace iCub
+{
+namespace skinDynLib
+{
+
+/**
+* @ingroup skinDynLib
+*
+* Fixed-layout record of a skin contact within a skinContactPacket.
+*/
+struct skinContactRecord
+{
+    unsigned long long contactId;
+    int bodyPart;
+    int linkNumber;
+    int skinPart;
+    unsigned int activeTaxels;
+    double CoP[3];
+    double F[3];
+    double Mu[3];
+    double geoCenter[3];
+    double normalDir[3];
+    double pressure;
+    // index of the first taxel id of the contact in the taxel array
+    unsigned int taxelOffset;
+    unsigned int reserved;
+};
+
+/**
+* @ingroup skinDynLib
+*
+* Class representing a list of external contacts acting on the iCub' skin
+* in a compact binary form.
+*/
+class skinContactPacket : public yarp::os::Portable
+{
+protected:
+    static const int TAXEL_LIST = 0x1;
+
+    int flags;
+    std::vector<skinContactRecord> records;
+    std::vector<unsigned int> taxels;
+
+public:
+    //~~~~~~~~~~~~~~~~~~~~~~
+    //   CONSTRUCTORS
+    //~~~~~~~~~~~~~~~~~~~~~~
+    skinContactPacket();
+
+    /**
+    * Fill the packet in with the given contacts. The memory is reused
+    * from one call to the next.
+    * @param l the list of contacts
+    * @param withTaxelList if false the ids of the active taxels are left out
+    */
+    void fromSkinContactList(const skinContactList &l, bool withTaxelList=true);
+
+    /**
+    * Empty the packet.
+    */
+    void clear();
+
+    //~~~~~~~~~~~~~~~~~~~~~~
+    //   GET methods
+    //~~~~~~~~~~~~~~~~~~~~~~
+    /**
+    * Get the number of contacts.
+    */
+    size_t size() const { return records.size(); }
+
+    /**
+    * Tell whether the ids of the active taxels are included.
+    */
+    bool hasTaxelList() const { return (flags&TAXEL_LIST)!=0; }
+
+    /**
+    * Access the i-th contact in place.
+    */
+    const skinContactRecord &operator[](size_t i) const { return records[i]; }
+
+    /**
+    * Access the ids of the taxels activated by the i-th contact.
+    * @return a pointer to getRecord(i).activeTaxels ids, NULL if the
+    *         packet does not include them
+    */
+    const unsigned int *getTaxelList(size_t i) const;
+
+    /**
+    * Build the i-th contact. If the taxel ids are not included the
+    * contact has a list of zeros of the right length.
+    */
+    skinContact toSkinContact(size_t i) const;
+
+    /**
+    * Build the whole list of contacts.
+    */
+    skinContactList toSkinContactList() const;
+
+    /**
+    * Compare two packets regardless of the contact ids, which the
+    * skin assigns anew at every cycle.
+    * @return true if the packets hold the same contacts
+    */
+    bool sameContacts(const skinContactPacket &p) const;
+
+    //~~~~~~~~~~~~~~~~~~~~~~~~~
+    //   SERIALIZATION methods
+    //~~~~~~~~~~~~~~~~~~~~~~~~~
+    /*
+    * Read skinContactPacket from a connection.
+    * return true iff a skinContactPacket was read correctly
+    */
+    virtual bool read(yarp::os::ConnectionReader& connection) override;
+
+    /**
+    * Write skinContactPacket to a connection.
+    * The packet is represented as a list of 3 elements that are:
+    * - an int, i.e. the flags
+    * - a blob with the contact records
+    * - a blob with the active taxel ids (empty if not included)
+    * return true iff a skinContactPacket was written correctly
+    */
+    virtual bool write(yarp::os::ConnectionWriter& connection) const override;
+};
+
+}
+
+}
+#endif
+
@@ -0,0 +1,193 @@
+/*
+ * Copyright (C) 2022 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <cstring>
+#include <cstddef>
+
+#include <yarp/os/ConnectionReader.h>
+#include <yarp/os/ConnectionWriter.h>
+
+#include "iCub/skinDynLib/skinContactPacket.h"
+
+using namespace std;
+using namespace yarp::os;
+using namespace iCub::skinDynLib;
+
+
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//   CONSTRUCTORS
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+skinContactPacket::skinContactPacket()
+:flags(0){}
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+void skinContactPacket::fromSkinContactList(const skinContactList &l, bool withTaxelList)
+{
+    flags = withTaxelList ? TAXEL_LIST : 0;
+    records.resize(l.size());
+    taxels.clear();
+
+    for(size_t i=0; i<l.size(); i++)
+    {
+        const skinContact &c = l[i];
+        skinContactRecord &r = records[i];
+        // zero the padding too, so that records can be compared bytewise
+        memset(&r, 0, sizeof(skinContactRecord));
+
+        r.contactId     = c.getId();
+        r.bodyPart      = c.getBodyPart();
+        r.linkNumber    = c.getLinkNumber();
+        r.skinPart      = c.getSkinPart();
+        r.activeTaxels  = c.getActiveTaxels();
+        for(int k=0;k<3;k++)
+        {
+            r.CoP[k]        = c.getCoP()[k];
+            r.F[k]          = c.getForce()[k];
+            r.Mu[k]         = c.getMoment()[k];
+            r.geoCenter[k]  = c.getGeoCenter()[k];
+            r.normalDir[k]  = c.getNormalDir()[k];
+        }
+        r.pressure      = c.getPressure();
+        r.taxelOffset   = taxels.size();
+
+        if(withTaxelList)
+        {
+            const vector<unsigned int> &list = c.taxelList;
+            taxels.insert(taxels.end(), list.begin(), list.begin()+r.activeTaxels);
+        }
+    }
+}
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+void skinContactPacket::clear()
+{
+    records.clear();
+    taxels.clear();
+}
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//   GET methods
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+const unsigned int *skinContactPacket::getTaxelList(size_t i) const
+{
+    if(!hasTaxelList() || records[i].activeTaxels==0)
+        return NULL;
+    return &taxels[records[i].taxelOffset];
+}
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+skinContact skinContactPacket::toSkinContact(size_t i) const
+{
+    const skinContactRecord &r = records[i];
+    skinContact c;
+    c.contactId     = (unsigned long)r.contactId;
+    c.bodyPart      = (BodyPart)r.bodyPart;
+    c.linkNumber    = r.linkNumber;
+    c.skinPart      = (SkinPart)r.skinPart;
+    for(int k=0;k<3;k++)
+    {
+        c.CoP[k]        = r.CoP[k];
+        c.F[k]          = r.F[k];
+        c.Mu[k]         = r.Mu[k];
+        c.geoCenter[k]  = r.geoCenter[k];
+        c.normalDir[k]  = r.normalDir[k];
+    }
+    c.setForce(c.F);
+
+    const unsigned int *list = getTaxelList(i);
+    if(list!=NULL)
+        c.setTaxelList(vector<unsigned int>(list, list+r.activeTaxels));
+    else
+        c.setActiveTaxels(r.activeTaxels);
+    c.pressure      = r.pressure;
+
+    return c;
+}
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+skinContactList skinContactPacket::toSkinContactList() const
+{
+    skinContactList res;
+    res.reserve(size());
+    for(size_t i=0; i<size(); i++)
+        res.push_back(toSkinContact(i));
+    return res;
+}
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+bool skinContactPacket::sameContacts(const skinContactPacket &p) const
+{
+    if(flags!=p.flags || records.size()!=p.records.size() || taxels!=p.taxels)
+        return false;
+
+    const size_t skip = offsetof(skinContactRecord, bodyPart);
+    for(size_t i=0; i<records.size(); i++)
+        if(memcmp((const char*)&records[i]+skip, (const char*)&p.records[i]+skip,
+                  sizeof(skinContactRecord)-skip)!=0)
+            return false;
+
+    return true;
+}
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//   SERIALIZATION methods
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+bool skinContactPacket::read(ConnectionReader& connection)
+{
+    // - an int, i.e. the flags
+    // - a blob with the contact records
+    // - a blob with the active taxel ids
+    if(connection.expectInt32()!=BOTTLE_TAG_LIST || connection.expectInt32()!=3)
+        return false;
+
+    if(connection.expectInt32()!=BOTTLE_TAG_INT32)
+        return false;
+    flags = connection.expectInt32();
+
+    if(connection.expectInt32()!=BOTTLE_TAG_BLOB)
+        return false;
+    int len = connection.expectInt32();
+    if(len<0 || len%sizeof(skinContactRecord)!=0)
+        return false;
+    records.resize(len/sizeof(skinContactRecord));
+    if(len>0 && !connection.expectBlock((char*)records.data(), len))
+        return false;
+
+    if(connection.expectInt32()!=BOTTLE_TAG_BLOB)
+        return false;
+    len = connection.expectInt32();
+    if(len<0 || len%sizeof(unsigned int)!=0)
+        return false;
+    taxels.resize(len/sizeof(unsigned int));
+    if(len>0 && !connection.expectBlock((char*)taxels.data(), len))
+        return false;
+
+    // do not trust the offsets coming from the network
+    if(hasTaxelList())
+        for(size_t i=0; i<records.size(); i++)
+            if((size_t)records[i].taxelOffset+records[i].activeTaxels>taxels.size())
+                return false;
+
+    return !connection.isError();
+}
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+bool skinContactPacket::write(ConnectionWriter& connection) const
+{
+    connection.appendInt32(BOTTLE_TAG_LIST);
+    connection.appendInt32(3);
+
+    connection.appendInt32(BOTTLE_TAG_INT32);
+    connection.appendInt32(flags);
+
+    // the blocks are sent straight from the vectors,
+    // which the port keeps alive until the write is over
+    connection.appendInt32(BOTTLE_TAG_BLOB);
+    connection.appendInt32(records.size()*sizeof(skinContactRecord));
+    if(!records.empty())
+        connection.appendExternalBlock((const char*)records.data(), records.size()*sizeof(skinContactRecord));
+
+    connection.appendInt32(BOTTLE_TAG_BLOB);
+    connection.appendInt32(taxels.size()*sizeof(unsigned int));
+    if(!taxels.empty())
+        connection.appendExternalBlock((const char*)taxels.data(), taxels.size()*sizeof(unsigned int));
+
+    return !connection.isError();
+}
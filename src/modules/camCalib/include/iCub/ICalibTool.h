@@ -9,6 +9,10 @@
 #ifndef __UZH_ICALIBTOOL__
 #define __UZH_ICALIBTOOL__
 
+// opencv
+#include <opencv2/core.hpp>
+#include <opencv2/imgproc.hpp>
+
 // yarp
 #include <yarp/sig/Image.h>
 #include <yarp/os/IConfig.h>
@@ -28,9 +32,44 @@ public:
 
     virtual void apply(const yarp::sig::ImageOf<yarp::sig::PixelRgb> & in,
                        yarp::sig::ImageOf<yarp::sig::PixelRgb> & out) = 0;    
+
+    /** Apply calibration between two views of 8-bit 3-channel images,
+      * e.g. the halves of a side-by-side stereo frame. out must already
+      * have the size of in: it is written in place and never reallocated.
+      */
+    virtual void apply(const cv::Mat & in, cv::Mat & out) = 0;
 };
 
 
+/**
+ * Wraps the pixels of a yarp image in a cv::Mat header, without copies
+ * and without swapping the channels order.
+ */
+inline cv::Mat wrapCvMat(const yarp::sig::ImageOf<yarp::sig::PixelRgb> & img)
+{
+    return cv::Mat(img.height(),img.width(),CV_8UC3,
+                   (void*)img.getRawImage(),img.getRowSize());
+}
+
+
+/**
+ * cv::remap() with fixed-point maps (CV_16SC2 + CV_16UC1), split on
+ * stripes of rows that are processed in parallel: the maps hold absolute
+ * source coordinates, hence each stripe reads the whole input but only
+ * writes its own rows of out.
+ */
+inline void parallelRemap(const cv::Mat & in, cv::Mat & out,
+                          const cv::Mat & map1, const cv::Mat & map2)
+{
+    cv::parallel_for_(cv::Range(0,out.rows),[&](const cv::Range & rows)
+    {
+        cv::Mat dst=out.rowRange(rows);
+        cv::remap(in,dst,map1.rowRange(rows),map2.rowRange(rows),
+                  cv::INTER_LINEAR);
+    });
+}
+
+
 #endif
 
  
@@ -44,8 +44,9 @@ class PinholeCalibTool : public ICalibTool
     CvMat           *_intrinsic_matrix_scaled;
     CvMat           *_distortion_coeffs;;
 
-    IplImage        *_mapUndistortX;
-    IplImage        *_mapUndistortY;
+    // fixed-point undistortion maps (CV_16SC2 + CV_16UC1)
+    cv::Mat         _mapUndistort1;
+    cv::Mat         _mapUndistort2;
 
     bool _needInit;
 
@@ -100,6 +101,9 @@ public:
     */
     void apply(const yarp::sig::ImageOf<yarp::sig::PixelRgb> & in,
                yarp::sig::ImageOf<yarp::sig::PixelRgb> & out);    
+
+    /** Apply calibration writing into the preallocated view out. */
+    void apply(const cv::Mat & in, cv::Mat & out);
     
 };
 
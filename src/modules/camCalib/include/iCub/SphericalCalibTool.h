@@ -30,8 +30,9 @@ class SphericalCalibTool : public ICalibTool
 {
 private:
 
-    IplImage        *_mapX;
-    IplImage        *_mapY;
+    // fixed-point projection maps (CV_16SC2 + CV_16UC1)
+    cv::Mat         _map1;
+    cv::Mat         _map2;
 
     double          _fx, _fx_scaled;
     double          _fy, _fy_scaled;
@@ -66,6 +67,7 @@ public:
     // ICalibTool
     void apply(const yarp::sig::ImageOf<yarp::sig::PixelRgb> & in,
                yarp::sig::ImageOf<yarp::sig::PixelRgb> & out);    
+    void apply(const cv::Mat & in, cv::Mat & out);
 };
 
 
@@ -6,12 +6,43 @@
  *
  */
 
+#include <cmath>
+#include <algorithm>
+
 #include <iCub/CamCalibModule.h>
 
 using namespace std;
 using namespace yarp::os;
 using namespace yarp::sig;
 
+namespace
+{
+    // Integer saturation stage evaluated on stripes of rows in parallel:
+    // the gain is in 8.8 fixed point and the mean of the channels is
+    // computed as (sum*21846)>>16, i.e. sum/3 within one unit.
+    void applySaturation(ImageOf<PixelRgb> &img, const double sat)
+    {
+        const int gain=(int)floor(256.0*sat+0.5);
+        const int width=(int)img.width();
+        cv::parallel_for_(cv::Range(0,(int)img.height()),[&](const cv::Range &rows)
+        {
+            for (int r=rows.start; r<rows.end; r++)
+            {
+                unsigned char *pixel=img.getPixelAddress(0,r);
+                for (int c=0; c<width; c++, pixel+=3)
+                {
+                    int mean=((pixel[0]+pixel[1]+pixel[2])*21846)>>16;
+                    for (int i=0; i<3; i++)
+                    {
+                        int sn=mean+(((int)pixel[i]-mean)*gain)/256;
+                        pixel[i]=(unsigned char)std::min(255,std::max(0,sn));
+                    }
+                }
+            }
+        });
+    }
+}
+
 CamCalibPort::CamCalibPort()
 {
     portImgOut=NULL;
@@ -49,28 +80,8 @@ void CamCalibPort::onRead(ImageOf<PixelRgb> &yrpImgIn)
         {
             calibTool->apply(yrpImgIn,yrpImgOut);
 
-            for (int r =0; r <yrpImgOut.height(); r++)
-            {
-                for (int c=0; c<yrpImgOut.width(); c++)
-                {
-                    unsigned char *pixel = yrpImgOut.getPixelAddress(c,r);
-                    double mean = (1.0/3.0)*(pixel[0]+pixel[1]+pixel[2]);
-
-                    for(int i=0; i<3; i++)
-                    {
-                        double s=pixel[i]-mean;
-                        double sn=currSat*s;
-                        sn+=mean;
-
-                        if(sn<0.0)
-                            sn=0.0;
-                        else if(sn>255.0)
-                            sn=255.0;
-
-                        pixel[i]=(unsigned char)sn;
-                    }
-                }
-            }
+            if (currSat!=1.0)
+                applySaturation(yrpImgOut,currSat);
 
             if (verbose)
                 yDebug("calibrated in %g [s]\n",Time::now()-t1);
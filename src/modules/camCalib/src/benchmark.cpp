@@ -0,0 +1,259 @@
+/*
+ * Copyright (C) 2022 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+// Per-frame latency of the calibration tools across resolutions.
+// Frames are taken from a recording of yarpdatadumper (the images listed
+// in its data.log), or synthesized if no recording is given; each frame is
+// scaled to every requested resolution and rectified with the same tool
+// used by the module, optionally as a side-by-side stereo pair.
+
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+
+#include <opencv2/core.hpp>
+#include <opencv2/imgproc.hpp>
+
+#include <yarp/os/all.h>
+#include <yarp/sig/all.h>
+#include <yarp/sig/ImageFile.h>
+
+#include <iCub/CalibToolFactory.h>
+#include <iCub/PinholeCalibTool.h>
+#include <iCub/SphericalCalibTool.h>
+
+using namespace std;
+using namespace yarp::os;
+using namespace yarp::sig;
+
+
+/************************************************************************/
+bool loadRecording(const string &dir, const int maxFrames, vector<cv::Mat> &frames)
+{
+    ifstream log((dir+"/data.log").c_str());
+    if (!log.is_open())
+    {
+        yError("unable to open %s/data.log",dir.c_str());
+        return false;
+    }
+
+    string line;
+    while (getline(log,line) && ((int)frames.size()<maxFrames))
+    {
+        // the image file name is the first token with an image extension
+        istringstream str(line);
+        string token;
+        while (str>>token)
+        {
+            string::size_type dot=token.rfind('.');
+            string ext=(dot==string::npos)?"":token.substr(dot);
+            if ((ext==".ppm") || (ext==".png") || (ext==".jpg"))
+            {
+                ImageOf<PixelRgb> img;
+                if (yarp::sig::file::read(img,dir+"/"+token))
+                    frames.push_back(wrapCvMat(img).clone());
+                else
+                    yWarning("unable to read %s/%s",dir.c_str(),token.c_str());
+                break;
+            }
+        }
+    }
+
+    return !frames.empty();
+}
+
+
+/************************************************************************/
+void synthesizeFrames(const int n, vector<cv::Mat> &frames)
+{
+    cv::RNG rng(0);
+    for (int i=0; i<n; i++)
+    {
+        cv::Mat frame(480,640,CV_8UC3);
+        rng.fill(frame,cv::RNG::UNIFORM,0,256);
+        cv::GaussianBlur(frame,frame,cv::Size(9,9),0.0);
+        for (int x=0; x<frame.cols; x+=40)
+            cv::line(frame,cv::Point(x,0),cv::Point(x,frame.rows-1),cv::Scalar(255,255,255));
+        for (int y=0; y<frame.rows; y+=40)
+            cv::line(frame,cv::Point(0,y),cv::Point(frame.cols-1,y),cv::Scalar(255,255,255));
+        frames.push_back(frame);
+    }
+}
+
+
+/************************************************************************/
+double percentile(vector<double> &samples, const double p)
+{
+    if (samples.empty())
+        return 0.0;
+
+    std::sort(samples.begin(),samples.end());
+    size_t i=(size_t)(p*(samples.size()-1)+0.5);
+    return samples[std::min(i,samples.size()-1)];
+}
+
+
+/************************************************************************/
+int main(int argc, char *argv[])
+{
+    CalibToolFactories& pool = CalibToolFactories::getPool();
+    pool.add(new CalibToolFactoryOf<PinholeCalibTool>("pinhole"));
+    pool.add(new CalibToolFactoryOf<SphericalCalibTool>("spherical"));
+
+    Network::init();
+
+    ResourceFinder rf;
+    rf.setDefaultConfigFile("camCalib.ini");
+    rf.setDefaultContext("cameraCalibration");
+    rf.configure(argc,argv);
+
+    if (rf.check("help"))
+    {
+        printf("Options\n");
+        printf("\t--from, --context, --group: calibration parameters, as for the module (default group: CAMERA_CALIBRATION)\n");
+        printf("\t--images    <dir>: yarpdatadumper recording of the camera (default: synthetic frames)\n");
+        printf("\t--sizes  \"(w h ...)\": output resolutions (default: (320 240 640 480 1024 768 1280 960))\n");
+        printf("\t--frames      <N>: frames processed per resolution (default: 300)\n");
+        printf("\t--threads     <N>: OpenCV worker threads, 1 to disable the parallel remap (default: all)\n");
+        printf("\t--dual           : frames are processed as side-by-side stereo pairs\n");
+        printf("\n");
+        Network::fini();
+        return 0;
+    }
+
+    Bottle botConfig(rf.toString());
+    botConfig.setMonitor(rf.getMonitor());
+    string strGroup=rf.check("group",Value("CAMERA_CALIBRATION")).asString();
+    if (botConfig.check(strGroup))
+    {
+        Bottle &group=botConfig.findGroup(strGroup);
+        botConfig.fromString(group.toString());
+    }
+    else
+    {
+        yError() << "Group " << strGroup << " not found.";
+        Network::fini();
+        return 1;
+    }
+
+    string calibToolName=botConfig.check("projection",Value("pinhole")).asString();
+    ICalibTool *calibTool[2];
+    for (int i=0; i<2; i++)
+    {
+        calibTool[i]=pool.get(calibToolName.c_str());
+        if ((calibTool[i]==NULL) || !calibTool[i]->open(botConfig))
+        {
+            yError() << "unable to instantiate the" << calibToolName << "tool";
+            Network::fini();
+            return 1;
+        }
+    }
+
+    if (rf.check("threads"))
+        cv::setNumThreads(rf.find("threads").asInt32());
+
+    int nFrames=std::max(1,rf.check("frames",Value(300)).asInt32());
+    bool dual=rf.check("dual");
+
+    vector<cv::Mat> frames;
+    if (rf.check("images"))
+    {
+        if (!loadRecording(rf.find("images").asString(),50,frames))
+        {
+            Network::fini();
+            return 1;
+        }
+    }
+    else
+        synthesizeFrames(10,frames);
+
+    vector<int> sizes={320,240,640,480,1024,768,1280,960};
+    if (Bottle *b=rf.find("sizes").asList())
+    {
+        sizes.clear();
+        for (int i=0; i+1<b->size(); i+=2)
+        {
+            sizes.push_back(b->get(i).asInt32());
+            sizes.push_back(b->get(i+1).asInt32());
+        }
+    }
+
+    yInfo("%s tool, %d frames, %d threads%s",calibToolName.c_str(),(int)frames.size(),
+          cv::getNumThreads(),dual?", side-by-side pairs":"");
+
+    for (size_t s=0; s+1<sizes.size(); s+=2)
+    {
+        int w=sizes[s];
+        int h=sizes[s+1];
+
+        // scale the frames beforehand to measure the calibration only
+        vector<ImageOf<PixelRgb>> inputs(frames.size());
+        for (size_t i=0; i<frames.size(); i++)
+        {
+            inputs[i].resize(dual?2*w:w,h);
+            cv::Mat in=wrapCvMat(inputs[i]);
+            if (dual)
+            {
+                cv::Mat half=in(cv::Rect(0,0,w,h));
+                cv::resize(frames[i],half,half.size());
+                half=in(cv::Rect(w,0,w,h));
+                cv::resize(frames[i],half,half.size());
+            }
+            else
+                cv::resize(frames[i],in,in.size());
+        }
+
+        ImageOf<PixelRgb> out;
+        out.resize(inputs[0].width(),inputs[0].height());
+        cv::Mat outMat=wrapCvMat(out);
+
+        // the first frame builds the maps
+        vector<double> latencies;
+        latencies.reserve(nFrames);
+        for (int n=0; n<=nFrames; n++)
+        {
+            const ImageOf<PixelRgb> &in=inputs[n%inputs.size()];
+            double t0=Time::now();
+            if (dual)
+            {
+                cv::Mat inMat=wrapCvMat(in);
+                cv::Mat outLeft=outMat(cv::Rect(0,0,w,h));
+                cv::Mat outRight=outMat(cv::Rect(w,0,w,h));
+                calibTool[0]->apply(inMat(cv::Rect(0,0,w,h)),outLeft);
+                calibTool[1]->apply(inMat(cv::Rect(w,0,w,h)),outRight);
+            }
+            else
+                calibTool[0]->apply(in,out);
+            double dt=Time::now()-t0;
+
+            if (n>0)
+                latencies.push_back(dt);
+        }
+
+        double mean=0.0;
+        for (auto &l:latencies)
+            mean+=l;
+        mean/=latencies.size();
+
+        yInfo("*** %5dx%-5d: mean=%.3f [ms] p50=%.3f [ms] p99=%.3f [ms] max=%.3f [ms] => %.1f [fps]",
+              w,h,1e3*mean,1e3*percentile(latencies,0.5),1e3*percentile(latencies,0.99),
+              1e3*percentile(latencies,1.0),1.0/mean);
+    }
+
+    for (int i=0; i<2; i++)
+    {
+        calibTool[i]->close();
+        delete calibTool[i];
+    }
+
+    Network::fini();
+    return 0;
+}
@@ -112,6 +112,17 @@
  *
  * <tt>camCalib --name /icub/camcalib/left --context cameraCalibration --from icubEyes.ini --group CAMERA_CALIBRATION_LEFT</tt>
  *
+ * \section benchmark_sec Benchmark
+ *
+ * The companion executable \c camCalibBenchmark measures the per-frame
+ * latency of the calibration across resolutions, on the frames of a
+ * yarpdatadumper recording (\c --images \c <dir>) or on synthetic ones:
+ *
+ * <tt>camCalibBenchmark --context cameraCalibration --from icubEyes.ini --group CAMERA_CALIBRATION_LEFT --images ./dump --sizes "(320 240 640 480)"</tt>
+ *
+ * Use \c --threads \c 1 to measure the remap without row parallelism
+ * and \c --dual to process side-by-side stereo pairs as dualCamCalib does.
+ *
  * More information on camera calibration:\n
  * OpenCV: http://opencvlibrary.sourceforge.net/CvReference#cv_3d\n
  * Matlab Toolbox: http://www.vision.caltech.edu/bouguetj/calib_doc/\n
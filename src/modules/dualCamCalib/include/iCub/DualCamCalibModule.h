@@ -42,6 +42,10 @@ private:
     yarp::sig::ImageOf<yarp::sig::PixelRgb>* leftImage;
     yarp::sig::ImageOf<yarp::sig::PixelRgb>* rightImage;
 
+    // fused: in dual mode, each half of the input frame is rectified directly
+    // into the corresponding half of the output image (no intermediate copies)
+    bool fused;
+
     yarp::os::BufferedPort<yarp::sig::ImageOf<yarp::sig::PixelRgb> > imageInLeft;
     yarp::os::BufferedPort<yarp::sig::ImageOf<yarp::sig::PixelRgb> > imageInRight;
     yarp::os::BufferedPort<yarp::sig::ImageOf<yarp::sig::PixelRgb> > imageOut;
@@ -55,6 +59,8 @@ private:
     yarp::sig::ImageOf<yarp::sig::PixelRgb> calibratedImgLeft;
     yarp::sig::ImageOf<yarp::sig::PixelRgb> calibratedImgRight;
 
+    void placeImage(const yarp::sig::ImageOf<yarp::sig::PixelRgb> &img,
+                    yarp::sig::ImageOf<yarp::sig::PixelRgb> &out, bool second);
 
 public:
 
@@ -19,6 +19,7 @@ CamCalibModule::CamCalibModule()
     requested_fps=0;
     time_lastOut=yarp::os::Time::now();
     dualImage_mode = false;
+    fused = false;
 }
 
 CamCalibModule::~CamCalibModule()
@@ -109,6 +110,13 @@ bool CamCalibModule::configure(yarp::os::ResourceFinder &rf)
         yInfo() << "Dual mode activate!!";
     }
 
+    // in dual mode the side-by-side frame is rectified in a single
+    // pass, unless the split into two intermediate images is requested
+    fused = dualImage_mode && !rf.check("no_fused") &&
+            (calibToolLeft!=NULL) && (calibToolRight!=NULL);
+    if (fused)
+        yInfo() << "Dual frames are rectified in a single pass";
+
     if(dualImage_mode)
     {
         leftImage  = new yarp::sig::ImageOf<yarp::sig::PixelRgb>;
@@ -186,23 +194,32 @@ bool CamCalibModule::interruptModule()
     return true;
 }
 
+void CamCalibModule::placeImage(const yarp::sig::ImageOf<yarp::sig::PixelRgb> &img,
+                                yarp::sig::ImageOf<yarp::sig::PixelRgb> &out, bool second)
+{
+    int w = img.width();
+    int h = img.height();
+    int outw = (align == ALIGN_WIDTH) ? 2*w : w;
+    int outh = (align == ALIGN_WIDTH) ? h : 2*h;
+    if (out.width() != outw || out.height() != outh)
+        out.resize(outw, outh);
+
+    int x = (second && align == ALIGN_WIDTH)  ? w : 0;
+    int y = (second && align == ALIGN_HEIGHT) ? h : 0;
+    cv::Mat outMat = wrapCvMat(out);
+    cv::Mat dst = outMat(cv::Rect(x,y,w,h));
+    wrapCvMat(img).copyTo(dst);
+}
+
 bool CamCalibModule::updateModule()
 {
     bool lready=false;
     bool rready=false;
-    bool init=false;
 
-    int dual_rowsize_pixels, dual_height_pixels, single_rowsize_pixels;
-    int dual_rowsize_bytes,  single_rowsize_bytes;
-
-    int outw = 0;
-    int outh = 0;
-
-    unsigned char *left_raw, *right_raw, *dual_raw;
+    yarp::sig::ImageOf<yarp::sig::PixelRgb> &calibratedImgOut=imageOut.prepare();
 
     if(dualImage_mode)
     {
-        // read the dual image and split it up into 2 separated images for calibration
         yarp::sig::ImageOf<yarp::sig::PixelRgb>* dual = imageInLeft.read();
         if(dual == NULL)
         {
@@ -210,27 +227,42 @@ bool CamCalibModule::updateModule()
             return true;
         }
 
-        dual_rowsize_pixels = dual->width();
-        single_rowsize_pixels = dual_rowsize_pixels/2;
-        dual_height_pixels = dual->height();
+        int single_w = dual->width()/2;
+        int h = dual->height();
 
-        dual_rowsize_bytes = dual->getRowSize();
-        single_rowsize_bytes = dual_rowsize_bytes/2;
-
-        leftImage->resize(dual_rowsize_pixels/2, dual_height_pixels);
-        rightImage->resize(dual_rowsize_pixels/2, dual_height_pixels);
-
-        leftImage->setQuantum(dual->getQuantum());
-        rightImage->setQuantum(dual->getQuantum());
+        if (fused)
+        {
+            // rectify the two halves of the side-by-side frame straight
+            // into their places within the output image in a single pass,
+            // without splitting the input nor copying the results
+            int outw = (align == ALIGN_WIDTH) ? 2*single_w : single_w;
+            int outh = (align == ALIGN_WIDTH) ? h : 2*h;
+            if (calibratedImgOut.width() != outw || calibratedImgOut.height() != outh)
+                calibratedImgOut.resize(outw, outh);
+
+            cv::Mat dualMat = wrapCvMat(*dual);
+            cv::Mat outMat  = wrapCvMat(calibratedImgOut);
+            cv::Mat outLeft  = outMat(cv::Rect(0,0,single_w,h));
+            cv::Mat outRight = (align == ALIGN_WIDTH) ? outMat(cv::Rect(single_w,0,single_w,h)) :
+                                                        outMat(cv::Rect(0,h,single_w,h));
+
+            calibToolLeft->apply(dualMat(cv::Rect(0,0,single_w,h)),outLeft);
+            calibToolRight->apply(dualMat(cv::Rect(single_w,0,single_w,h)),outRight);
+            lready=true;
+            rready=true;
+        }
+        else
+        {
+            // split the dual image up into 2 separated images for calibration
+            leftImage->resize(single_w, h);
+            rightImage->resize(single_w, h);
 
-        left_raw  = leftImage->getRawImage();
-        right_raw = rightImage->getRawImage();
-        dual_raw  = dual->getRawImage();
+            leftImage->setQuantum(dual->getQuantum());
+            rightImage->setQuantum(dual->getQuantum());
 
-        for(int h=0; h<dual_height_pixels; h++)
-        {
-            memcpy(left_raw+(h*single_rowsize_bytes),  dual_raw+(h*dual_rowsize_bytes),                         single_rowsize_bytes);
-            memcpy(right_raw+(h*single_rowsize_bytes), dual_raw+(h*dual_rowsize_bytes) + single_rowsize_bytes,  single_rowsize_bytes);
+            cv::Mat dualMat = wrapCvMat(*dual);
+            dualMat(cv::Rect(0,0,single_w,h)).copyTo(wrapCvMat(*leftImage));
+            dualMat(cv::Rect(single_w,0,single_w,h)).copyTo(wrapCvMat(*rightImage));
         }
     }
     else
@@ -239,83 +271,19 @@ bool CamCalibModule::updateModule()
         rightImage = imageInRight.read(false);
     }
 
-    yarp::sig::ImageOf<yarp::sig::PixelRgb> &calibratedImgOut=imageOut.prepare();
-
-    if (calibToolLeft!=NULL && leftImage!=NULL)
+    if (!fused)
     {
-        calibToolLeft->apply(*leftImage,calibratedImgLeft);
-        lready=true;
-
-        if (init==false)
+        if (calibToolLeft!=NULL && leftImage!=NULL)
         {
-            if (align == ALIGN_WIDTH)
-            {
-                outw = calibratedImgLeft.width()*2;
-                outh = calibratedImgLeft.height();
-            }
-            else if (align==ALIGN_HEIGHT)
-            {
-                outw = calibratedImgLeft.width();
-                outh = calibratedImgLeft.height()*2;
-            }
-            else
-            {
-                yError() << "Invalid alignment";
-            }
-            calibratedImgOut.copy(calibratedImgLeft,outw,outh);
-            init=true;
+            calibToolLeft->apply(*leftImage,calibratedImgLeft);
+            placeImage(calibratedImgLeft,calibratedImgOut,false);
+            lready=true;
         }
-
-        calibratedImgOut.resize(outw, outh);
-        for (int r=0; r<calibratedImgLeft.height(); r++)
-        for (int c=0; c<calibratedImgLeft.width(); c++)
-        {
-            unsigned char *pixel = calibratedImgOut.getPixelAddress(c,r);
-
-            pixel[0] = *(calibratedImgLeft.getPixelAddress(c,r)+0);
-            pixel[1] = *(calibratedImgLeft.getPixelAddress(c,r)+1);
-            pixel[2] = *(calibratedImgLeft.getPixelAddress(c,r)+2);
-        }
-
-    }
-    if (calibToolRight!=NULL && rightImage!=NULL)
-    {
-        calibToolRight->apply(*rightImage,calibratedImgRight);
-        rready=true;
-
-        if (init==false)
-        {
-            int outw = 0;
-            int outh = 0;
-            if (align == ALIGN_WIDTH)
-            {
-                outw = calibratedImgLeft.width()*2;
-                outh = calibratedImgLeft.height();
-            }
-            else if (align==ALIGN_HEIGHT)
-            {
-                outw = calibratedImgLeft.width();
-                outh = calibratedImgLeft.height()*2;
-            }
-            else
-            {
-                yError() << "Invalid alignment";
-            }
-            calibratedImgOut.copy(calibratedImgRight,outw,outh);
-            init=true;
-        }
-
-        for (int r=0; r<calibratedImgLeft.height(); r++)
-        for (int c=0; c<calibratedImgLeft.width(); c++)
+        if (calibToolRight!=NULL && rightImage!=NULL)
         {
-            int cp = 0;
-            int rp = 0;
-            if      (align == ALIGN_WIDTH)  {cp = c+calibratedImgLeft.width();  rp = r;}
-            else if (align == ALIGN_HEIGHT) {cp = c; rp = r+calibratedImgLeft.height();}
-            unsigned char *pixel = calibratedImgOut.getPixelAddress(cp,rp);
-            pixel[0] = *(calibratedImgRight.getPixelAddress(c,r)+0);
-            pixel[1] = *(calibratedImgRight.getPixelAddress(c,r)+1);
-            pixel[2] = *(calibratedImgRight.getPixelAddress(c,r)+2);
+            calibToolRight->apply(*rightImage,calibratedImgRight);
+            placeImage(calibratedImgRight,calibratedImgOut,true);
+            rready=true;
         }
     }
 
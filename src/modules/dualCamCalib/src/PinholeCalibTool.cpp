@@ -5,17 +5,13 @@
  */
 
 #include <utility>
-#include <yarp/cv/Cv.h>
 #include <iCub/PinholeCalibTool.h>
 
 using namespace std;
 using namespace yarp::os;
 using namespace yarp::sig;
-using namespace yarp::cv;
 
 PinholeCalibTool::PinholeCalibTool(){
-    _mapUndistortX = NULL;
-    _mapUndistortY = NULL;
     _intrinsic_matrix = cvCreateMat(3,3, CV_32F);
     _intrinsic_matrix_scaled = cvCreateMat(3,3, CV_32F);
     _distortion_coeffs = cvCreateMat(1, 4, CV_32F);
@@ -29,12 +25,8 @@ PinholeCalibTool::~PinholeCalibTool(){
 }
 
 bool PinholeCalibTool::close(){
-    if (_mapUndistortX != NULL)
-        cvReleaseImage(&_mapUndistortX);
-    _mapUndistortX = NULL;
-    if (_mapUndistortY != NULL)
-        cvReleaseImage(&_mapUndistortY);
-    _mapUndistortY = NULL;
+    _mapUndistort1.release();
+    _mapUndistort2.release();
     cvReleaseMat(&_intrinsic_matrix);
     cvReleaseMat(&_intrinsic_matrix_scaled);
     cvReleaseMat(&_distortion_coeffs);
@@ -137,14 +129,6 @@ bool PinholeCalibTool::configure (Searchable &config){
 
 bool PinholeCalibTool::init(CvSize currImgSize, CvSize calibImgSize){
 
-    if (_mapUndistortX != NULL)
-        cvReleaseImage(&_mapUndistortX);
-    _mapUndistortX = NULL;
-    if (_mapUndistortY != NULL)
-        cvReleaseImage(&_mapUndistortY);
-    _mapUndistortY = NULL;
-
-
     // Scale the intrinsics if required:
     // if current image size is not the same as the size for
     // which calibration parameters are specified we need to
@@ -175,20 +159,30 @@ bool PinholeCalibTool::init(CvSize currImgSize, CvSize calibImgSize){
         CV_MAT_ELEM( *_intrinsic_matrix_scaled , float, 2, 2) = CV_MAT_ELEM( *_intrinsic_matrix , float, 2, 2);
     }
     
-    _mapUndistortX = cvCreateImage(currImgSize, IPL_DEPTH_32F, 1);
-    _mapUndistortY = cvCreateImage(currImgSize, IPL_DEPTH_32F, 1);
-
-    /* init the undistortion matrices */
+    /* init the undistortion matrices: the maps are directly generated in
+       fixed-point format, which cv::remap() evaluates with integer
+       arithmetic and lookup tables instead of float coordinates */
     cv::initUndistortRectifyMap(cv::cvarrToMat(_intrinsic_matrix_scaled), cv::cvarrToMat(_distortion_coeffs), cv::Mat(),
                                 cv::cvarrToMat(_intrinsic_matrix_scaled), cv::Size(currImgSize.width, currImgSize.height),
-                                CV_32FC1,cv::cvarrToMat(_mapUndistortX), cv::cvarrToMat(_mapUndistortY));
+                                CV_16SC2,_mapUndistort1,_mapUndistort2);
+
     _needInit = false;
     return true;
 }
 
 void PinholeCalibTool::apply(const ImageOf<PixelRgb> & in, ImageOf<PixelRgb> & out){
 
-    CvSize inSize = cvSize(in.width(),in.height());
+    // the output buffer is recycled as long as the size does not change
+    if (out.width() != in.width() || out.height() != in.height())
+        out.resize(in.width(),in.height());
+
+    cv::Mat outMat = wrapCvMat(out);
+    apply(wrapCvMat(in),outMat);
+}
+
+void PinholeCalibTool::apply(const cv::Mat & in, cv::Mat & out){
+
+    CvSize inSize = cvSize(in.cols,in.rows);
 
     // check if reallocation required
     if ( inSize.width  != _oldImgSize.width || 
@@ -196,22 +190,16 @@ void PinholeCalibTool::apply(const ImageOf<PixelRgb> & in, ImageOf<PixelRgb> & o
         _needInit)
         init(inSize,_calibImgSize);
 
-    cv::Mat outMat;
-    cv::remap( toCvMat(const_cast<ImageOf<PixelRgb>&>(in)), outMat,
-             cv::cvarrToMat(_mapUndistortX), cv::cvarrToMat(_mapUndistortY),
-             cv::INTER_LINEAR );
-    out=fromCvMat<PixelRgb>(outMat);
+    parallelRemap(in,out,_mapUndistort1,_mapUndistort2);
 
     // painting crosshair at calibration center
     if (_drawCenterCross){
-        yarp::sig::PixelRgb pix = yarp::sig::PixelRgb(255,255,255);
-        yarp::sig::draw::addCrossHair(out, pix, (int)CV_MAT_ELEM( *_intrinsic_matrix_scaled , float, 0, 2),
-                                            (int)CV_MAT_ELEM( *_intrinsic_matrix_scaled , float, 1, 2),
-                                            10);
+        cv::drawMarker(out, cv::Point((int)CV_MAT_ELEM( *_intrinsic_matrix_scaled , float, 0, 2),
+                                      (int)CV_MAT_ELEM( *_intrinsic_matrix_scaled , float, 1, 2)),
+                       cv::Scalar(255,255,255), cv::MARKER_CROSS, 20);
     }
 
     // buffering old image size
     _oldImgSize.width  = inSize.width;
     _oldImgSize.height = inSize.height;
 }
-
@@ -7,18 +7,14 @@
  */
 
 #include <utility>
-#include <yarp/cv/Cv.h>
 #include <iCub/SphericalCalibTool.h>
 #include <stdio.h>
 
 using namespace std;
 using namespace yarp::os;
 using namespace yarp::sig;
-using namespace yarp::cv;
 
 SphericalCalibTool::SphericalCalibTool(){
-    _mapX = NULL;
-    _mapY = NULL;
     _oldImgSize.width = -1;
     _oldImgSize.height = -1;
     _needInit = true;
@@ -33,12 +29,8 @@ bool SphericalCalibTool::open(Searchable &config){
 }
 
 bool SphericalCalibTool::close(){
-    if (_mapX != NULL)
-        cvReleaseImage(&_mapX);
-    _mapX = NULL;
-    if (_mapY != NULL)
-        cvReleaseImage(&_mapY);
-    _mapY = NULL;
+    _map1.release();
+    _map2.release();
     return true;
 }
 
@@ -95,13 +87,6 @@ bool SphericalCalibTool::configure (Searchable &config){
 
 bool SphericalCalibTool::init(CvSize currImgSize, CvSize calibImgSize){
 
-     if (_mapX != NULL)
-        cvReleaseImage(&_mapX);
-    _mapX = NULL;
-    if (_mapY != NULL)
-        cvReleaseImage(&_mapY);
-    _mapY = NULL;
-
     // Scale the intrinsics if required:
     // if current image size is not the same as the size for
     // which calibration parameters are specified we need to
@@ -122,25 +107,37 @@ bool SphericalCalibTool::init(CvSize currImgSize, CvSize calibImgSize){
         _cy_scaled = _cy;
     }
 
-    _mapX = cvCreateImage(currImgSize, IPL_DEPTH_32F, 1);
-    _mapY = cvCreateImage(currImgSize, IPL_DEPTH_32F, 1);
-
-    
+    cv::Mat mapX(currImgSize.height, currImgSize.width, CV_32FC1);
+    cv::Mat mapY(currImgSize.height, currImgSize.width, CV_32FC1);
 
     if(!compute_sp_map(currImgSize.height, currImgSize.width, 
                        currImgSize.height, currImgSize.width,
                         _fx_scaled, _fy_scaled, _cx_scaled, _cy_scaled, 
                         _k1, _k2, _p1, _p2, 
-                        (float*)_mapX->imageData, (float*)_mapY->imageData))
+                        (float*)mapX.data, (float*)mapY.data))
         return false;
 
+    // the float maps are only needed to build the fixed-point ones,
+    // which cv::remap() evaluates with integer arithmetic
+    cv::convertMaps(mapX, mapY, _map1, _map2, CV_16SC2);
+
     _needInit = false;
     return true;
 }
 
 void SphericalCalibTool::apply(const ImageOf<PixelRgb> & in, ImageOf<PixelRgb> & out){
 
-    CvSize inSize = cvSize(in.width(),in.height());
+    // the output buffer is recycled as long as the size does not change
+    if (out.width() != in.width() || out.height() != in.height())
+        out.resize(in.width(),in.height());
+
+    cv::Mat outMat = wrapCvMat(out);
+    apply(wrapCvMat(in),outMat);
+}
+
+void SphericalCalibTool::apply(const cv::Mat & in, cv::Mat & out){
+
+    CvSize inSize = cvSize(in.cols,in.rows);
 
     // check if reallocation required
     if ( inSize.width  != _oldImgSize.width || 
@@ -148,18 +145,12 @@ void SphericalCalibTool::apply(const ImageOf<PixelRgb> & in, ImageOf<PixelRgb> &
         _needInit)
         init(inSize,_calibImgSize);
 
-    out.resize(inSize.width, inSize.height);
-
-    cv::Mat outMat=toCvMat(out);
-    cv::remap( toCvMat(const_cast<ImageOf<PixelRgb>&>(in)), outMat,
-               cv::cvarrToMat(_mapX), cv::cvarrToMat(_mapY),
-               cv::INTER_LINEAR );
-    out=fromCvMat<PixelRgb>(outMat);
+    parallelRemap(in,out,_map1,_map2);
 
     // painting crosshair at calibration center
     if (_drawCenterCross){
-        yarp::sig::PixelRgb pix = yarp::sig::PixelRgb(255,255,255);
-        yarp::sig::draw::addCrossHair(out, pix, (int)_cx_scaled, (int)_cy_scaled, 10);
+        cv::drawMarker(out, cv::Point((int)_cx_scaled, (int)_cy_scaled),
+                       cv::Scalar(255,255,255), cv::MARKER_CROSS, 20);
     }
 
     // buffering old image size
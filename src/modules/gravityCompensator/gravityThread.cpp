@@ -43,6 +43,9 @@ using namespace iCub::iDyn;
 using namespace iCub::skinDynLib;
 using namespace std;
 
+// snapshots older than this are considered lost [s]
+#define KINSTATE_TIMEOUT    0.1
+
 Vector gravityCompensatorThread::evalVelUp(const Vector &x)
 {
     AWPolyElement el;
@@ -296,6 +299,9 @@ bool gravityCompensatorThread::readAndUpdate(bool waitMeasure)
     }
     */
 
+    if (kinState.isOpen())
+        return readKinematicState();
+
     if (inertial_enabled)
     {
         inertial = port_inertial->read(waitMeasure);
@@ -340,6 +346,57 @@ bool gravityCompensatorThread::readAndUpdate(bool waitMeasure)
     return b;
 }
 
+bool gravityCompensatorThread::readKinematicState()
+{
+    // the snapshot is accessed in place
+    unsigned long long seq;
+    const iCubKinematicState *state = kinState.read(seq);
+    if ((state==nullptr) || (Time::now()-state->timestamp>KINSTATE_TIMEOUT))
+        return false;
+
+    for (size_t i=0;i<ICUB_KINSTATE_UP_DOF;i++)
+        all_q_up(i) = state->q_up[i];
+    for (size_t i=0;i<ICUB_KINSTATE_LOW_DOF;i++)
+        all_q_low(i) = state->q_low[i];
+
+    if (inertial_enabled)
+    {
+        d2p0[0] = state->d2p0[0];
+        d2p0[1] = state->d2p0[1];
+        d2p0[2] = state->d2p0[2];
+    }
+    else
+    {
+        d2p0[0] = 0;
+        d2p0[1] = 0;
+        d2p0[2] = 9.81;
+    }
+    w0 = 0.0;
+    dw0 = 0.0;
+
+    if (!kinState.check(seq))
+        return false;
+
+    for (size_t i=0;i<q_head.length();i++)
+        encoders_head(i) = q_head(i) = all_q_up(i);
+    for (size_t i=0;i<q_larm.length();i++)
+        encoders_arm_left(i) = q_larm(i) = all_q_up(q_head.length()+i);
+    for (size_t i=0;i<q_rarm.length();i++)
+        encoders_arm_right(i) = q_rarm(i) = all_q_up(q_head.length()+q_larm.length()+i);
+    for (size_t i=0;i<q_torso.length();i++)
+        encoders_torso(2-i) = q_torso(i) = all_q_low(i);
+    for (size_t i=0;i<q_lleg.length();i++)
+        encoders_leg_left(i) = q_lleg(i) = all_q_low(q_torso.length()+i);
+    for (size_t i=0;i<q_rleg.length();i++)
+        encoders_leg_right(i) = q_rleg(i) = all_q_low(q_torso.length()+q_lleg.length()+i);
+
+    setZeroJntAngVelAcc();
+    setUpperMeasure();
+    setLowerMeasure();
+
+    return true;
+}
+
 bool gravityCompensatorThread::getLowerEncodersSpeedAndAcceleration()
 {
     bool b = true;
@@ -566,6 +623,11 @@ bool gravityCompensatorThread::threadInit()
         case VOCAB_CM_UNKNOWN:                yError("UNKNOWN  \n");    break;
     }
 
+    //-----------SHARED KINEMATIC STATE----------------//
+    // attached once: without it the robot is read through the ports
+    if (!kinematic_state.empty() && !kinState.open(kinematic_state))
+        yWarning("unable to attach to the kinematic state %s, reading the robot instead\n", kinematic_state.c_str());
+
     thread_status = STATUS_OK;
 
     return true;
@@ -865,7 +927,18 @@ void gravityCompensatorThread::run()
     }
     else
     {
-        if(Network::exists("/"+wholeBodyName+"/filtered/inertial:o"))
+        bool connected;
+        if (kinState.isOpen())
+        {
+            unsigned long long seq;
+            connected = (kinState.read(seq)!=nullptr);
+        }
+        else
+        {
+            connected = Network::exists("/"+wholeBodyName+"/filtered/inertial:o");
+        }
+
+        if(connected)
         {
             yInfo("connection exists! starting calibration...\n");
             //the following delay is required because even if the filtered port exists, may be the 
@@ -873,7 +946,8 @@ void gravityCompensatorThread::run()
             Time::delay(1.0); 
 
             isCalibrated = true;
-            Network::connect("/"+wholeBodyName+"/filtered/inertial:o","/gravityCompensator/inertial:i");
+            if (!kinState.isOpen())
+                Network::connect("/"+wholeBodyName+"/filtered/inertial:o","/gravityCompensator/inertial:i");
             setZeroJntAngVelAcc();
             setUpperMeasure();
             setLowerMeasure();
@@ -990,6 +1064,8 @@ void gravityCompensatorThread::threadRelease()
     if (linEstLow)         {delete linEstLow;  linEstLow = nullptr;}
     if (quadEstLow)        {delete quadEstLow; quadEstLow = nullptr;}
 
+    kinState.close();
+
     //closing ports
     port_inertial->interrupt();
     port_inertial->close();
@@ -31,6 +31,7 @@
 #include <iCub/ctrl/adaptWinPolyEstimator.h>
 #include <iCub/iDyn/iDyn.h>
 #include <iCub/iDyn/iDynBody.h>
+#include <iCub/iDyn/iDynSharedState.h>
 
 using namespace yarp::os;
 using namespace yarp::sig;
@@ -150,6 +151,9 @@ private:
     Vector ampli_LA, ampli_RA, ampli_LL, ampli_RL, ampli_TO;
     bool isCalibrated;
     bool inertial_enabled;
+
+    iCubKinematicStateReader kinState;
+    bool readKinematicState();
     
     Vector evalVelUp(const Vector &x);
     Vector evalVelLow(const Vector &x);
@@ -165,6 +169,7 @@ public:
     
     int gravity_mode;
     int external_mode;
+    std::string kinematic_state;
 
     gravityCompensatorThread(std::string _wholeBodyName, int _rate, PolyDriver *_ddLA, PolyDriver *_ddRA, PolyDriver *_ddH, PolyDriver *_ddLL, PolyDriver *_ddRL, PolyDriver *_ddT, version_tag icub_type, bool _inertial_enabled);
 
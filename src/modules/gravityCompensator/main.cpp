@@ -34,6 +34,14 @@ http://wiki.icub.org/wiki/Force_Control
 --no_legs
 - This option disables the gravity compensation for the legs joints.
 
+--kinematic_state \e name
+- Takes the joints angles and the inertial measure from the shared
+  memory ring \e name published by wholeBodyDynamics (launched with
+  the same option) instead of reading the encoders and the inertial
+  port. Both modules must run on the same machine, and wholeBodyDynamics
+  must be publishing when gravityCompensator starts: otherwise the
+  encoders and the inertial port are read as usual.
+
 \section portsa_sec Ports Accessed
 The port the service is listening to.
 
@@ -367,9 +375,18 @@ public:
             yInfo("'no_inertial' option found. Disabling inertial measurment.\n");
         }
 
+        //------------------CHECK FOR KINEMATIC STATE -----------//
+        std::string kinematic_state;
+        if (rf.check("kinematic_state"))
+        {
+            kinematic_state = rf.find("kinematic_state").asString();
+            yInfo("'kinematic_state' option found. Reading the robot state from %s.\n", kinematic_state.c_str());
+        }
+
         //--------------------------THREAD--------------------------
 
         g_comp = new gravityCompensatorThread(wholeBodyName, rate, dd_left_arm, dd_right_arm, dd_head, dd_left_leg, dd_right_leg, dd_torso, icub_type, inertial_enabled);
+        g_comp->kinematic_state = kinematic_state;
         yInfo("ft thread istantiated...\n");
         g_comp->start();
         yInfo("thread started\n");
@@ -542,6 +559,7 @@ int main(int argc, char * argv[])
         yInfo() << "--no_head          disables the head";
         yInfo() << "--wholebody_name   the wholeBodyDyanmics port prefix (e.g. 'wholeBodyDynamics' / 'wholeBodyDynamicsTree')";
         yInfo() << "--no_inertial      disables the inertial";
+        yInfo() << "--kinematic_state  the shared kinematic state published by wholeBodyDynamics";
         yInfo() << "--gravity_on       enables gravity compensation (default)";
         yInfo() << "--gravity_off      disables gravity compensation";
         yInfo() << "--external_on      enables external torque command (default)";
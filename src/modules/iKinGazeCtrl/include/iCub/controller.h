@@ -110,6 +110,7 @@ protected:
     Vector v,vNeck,vEyes;
     Vector q0,qd,qdNeck,qdEyes;
     Vector fbTorso,fbHead,fbNeck,fbEyes;
+    Vector xd_ex,x_ex,counterv_ex;
     vector<int> neckJoints,eyesJoints;
     vector<int> jointsToSet;
 
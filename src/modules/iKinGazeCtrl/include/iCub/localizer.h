@@ -56,6 +56,7 @@ protected:
 
     Matrix eyeCAbsFrame;
     Matrix invEyeCAbsFrame;
+    Vector x_ex;
     double eyesHalfBaseline;
 
     Matrix *PrjL, *invPrjL;
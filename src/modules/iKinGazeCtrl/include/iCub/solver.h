@@ -87,7 +87,9 @@ protected:
     Vector fbHead;
     Vector qd,fp;
     Matrix eyesJ;
+    DLSSolver eyesDLS;
     Vector counterRotGain;
+    Vector v_ex,counterv_ex;
 
     Vector getEyesCounterVelocity(const Matrix &eyesJ, const Vector &fp);
 
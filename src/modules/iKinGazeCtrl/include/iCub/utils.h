@@ -20,6 +20,7 @@
 #define __UTILS_H__
 
 #include <mutex>
+#include <atomic>
 #include <condition_variable>
 #include <string>
 #include <algorithm>
@@ -89,17 +90,152 @@ public:
 };
 
 
+// This class holds a fixed-size block of data published
+// through a sequence lock: writers are serialized among
+// themselves, whereas readers never block and simply retry
+// the copy if a write overlapped it.
+template<size_t N>
+class StateBlock
+{
+protected:
+    mutex               mtxWrite;
+    atomic<unsigned int> seq;
+    atomic<size_t>      len;
+    atomic<double>      stamp;
+    atomic<double>      data[N];
+
+    /************************************************************************/
+    void beginWrite()
+    {
+        mtxWrite.lock();
+        seq.store(seq.load(memory_order_relaxed)+1,memory_order_relaxed);
+        atomic_thread_fence(memory_order_release);
+    }
+
+    /************************************************************************/
+    void endWrite()
+    {
+        seq.store(seq.load(memory_order_relaxed)+1,memory_order_release);
+        mtxWrite.unlock();
+    }
+
+    /************************************************************************/
+    void store(const double *src, const size_t n)
+    {
+        yAssert(n<=N);
+        for (size_t i=0; i<n; i++)
+            data[i].store(src[i],memory_order_relaxed);
+        len.store(n,memory_order_relaxed);
+    }
+
+public:
+    /************************************************************************/
+    StateBlock() : seq(0), len(0), stamp(0.0)
+    {
+        for (size_t i=0; i<N; i++)
+            data[i].store(0.0,memory_order_relaxed);
+    }
+
+    /************************************************************************/
+    void write(const double *src, const size_t n)
+    {
+        beginWrite();
+        store(src,n);
+        endWrite();
+    }
+
+    /************************************************************************/
+    void write(const Vector &src)
+    {
+        write(src.data(),src.length());
+    }
+
+    /************************************************************************/
+    void write(const Vector &src, const double t)
+    {
+        beginWrite();
+        store(src.data(),src.length());
+        stamp.store(t,memory_order_relaxed);
+        endWrite();
+    }
+
+    /************************************************************************/
+    void write(const size_t i, const double val)
+    {
+        beginWrite();
+        if (i<len.load(memory_order_relaxed))
+            data[i].store(val,memory_order_relaxed);
+        endWrite();
+    }
+
+    /************************************************************************/
+    void resize(const size_t n, const double val)
+    {
+        yAssert(n<=N);
+        beginWrite();
+        for (size_t i=len.load(memory_order_relaxed); i<n; i++)
+            data[i].store(val,memory_order_relaxed);
+        len.store(n,memory_order_relaxed);
+        endWrite();
+    }
+
+    // copies at most n elements and returns the number of
+    // the update they belong to along with the size of the block
+    /************************************************************************/
+    unsigned int read(double *dst, const size_t n, double *t=nullptr,
+                      size_t *size=nullptr) const
+    {
+        for (;;)
+        {
+            unsigned int s=seq.load(memory_order_acquire);
+            if (s&0x01)
+                continue;
+
+            size_t l=len.load(memory_order_relaxed);
+            size_t m=std::min(n,l);
+            for (size_t i=0; i<m; i++)
+                dst[i]=data[i].load(memory_order_relaxed);
+            if (t!=nullptr)
+                *t=stamp.load(memory_order_relaxed);
+
+            atomic_thread_fence(memory_order_acquire);
+            if (seq.load(memory_order_relaxed)==s)
+            {
+                if (size!=nullptr)
+                    *size=l;
+                return (s>>1);
+            }
+        }
+    }
+
+    // the size is taken within the same update as the data, and
+    // the destination is reallocated only if the size changed
+    /************************************************************************/
+    unsigned int read(Vector &dst, double *t=nullptr) const
+    {
+        double buf[N];
+        size_t l;
+        unsigned int u=read(buf,N,t,&l);
+        if (dst.length()!=l)
+            dst.resize(l);
+        std::copy(buf,buf+l,dst.data());
+        return u;
+    }
+
+    /************************************************************************/
+    size_t size() const { return len.load(memory_order_acquire); }
+};
+
+
 // This class handles the data exchange among components.
 class ExchangeData
 {
 protected:
-    mutex  mtx[8];
-    Vector xd,qd;
-    Vector x,q,torso;
-    Vector v,counterv;
-    Matrix S;
+    StateBlock<16> xd,qd;
+    StateBlock<16> x,q,torso;
+    StateBlock<16> v,counterv;
+    StateBlock<16> S;
     Vector imu;
-    double x_stamp;
 
 public:
     ExchangeData();
@@ -128,6 +264,16 @@ public:
     Vector  get_counterv();
     Matrix  get_fpFrame();
 
+    // non-allocating getters returning the update number
+    unsigned int get_xd(Vector &_xd);
+    unsigned int get_qd(Vector &_qd);
+    unsigned int get_x(Vector &_x, double &stamp);
+    unsigned int get_q(Vector &_q);
+    unsigned int get_torso(Vector &_torso);
+    unsigned int get_v(Vector &_v);
+    unsigned int get_counterv(Vector &_counterv);
+    unsigned int get_fpFrame(Matrix &_S);
+
     std::pair<Vector,bool>  get_gyro();
     std::pair<Vector,bool>  get_accel();
 
@@ -671,9 +671,11 @@ void Controller::run()
     
     // get data
     double x_stamp;
-    Vector xd=commData->get_xd();
-    Vector x=commData->get_x(x_stamp);
-    qd=commData->get_qd();
+    Vector &xd=xd_ex;
+    Vector &x=x_ex;
+    commData->get_xd(xd);
+    commData->get_x(x,x_stamp);
+    commData->get_qd(qd);
 
     // read feedbacks
     q_stamp=Time::now();
@@ -830,10 +832,16 @@ void Controller::run()
         if (unplugCtrlEyes)
         {
             if (Time::now()-saccadeStartTime>=Ts)
-                vEyes=commData->get_counterv();
+            {
+                commData->get_counterv(counterv_ex);
+                vEyes=counterv_ex;
+            }
         }
         else
-            vEyes=mjCtrlEyes->computeCmd(eyesTime,qdEyes-fbEyes)+commData->get_counterv();
+        {
+            commData->get_counterv(counterv_ex);
+            vEyes=mjCtrlEyes->computeCmd(eyesTime,qdEyes-fbEyes)+counterv_ex;
+        }
 
         // stabilization
         if (commData->stabilizationOn)
@@ -0,0 +1,282 @@
+/*
+ * Copyright (C) 2022 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+// Stress test of the ExchangeData: four periodic threads replicate
+// the exchange pattern of Controller, Localizer, EyePinvRefGen and
+// Solver at their nominal periods, while extra threads keep hammering
+// the same data; per-cycle latency and period jitter are reported.
+
+#include <cstdio>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#include <iCub/utils.h>
+
+
+/************************************************************************/
+class StressThread : public PeriodicThread
+{
+protected:
+    ExchangeData *commData;
+    string name;
+    double nominalPeriod;
+    double work;
+    double lastStart;
+    Vector xd,qd,x,q,torso,v,counterv;
+    Matrix S;
+
+    /************************************************************************/
+    void spin()
+    {
+        // emulate the computation carried out in the cycle
+        double t0=Time::now();
+        volatile double acc=0.0;
+        while (Time::now()-t0<work)
+            for (int i=0; i<100; i++)
+                acc+=sqrt((double)i);
+    }
+
+    /************************************************************************/
+    virtual void exchange()=0;
+
+public:
+    vector<double> latencies;
+    vector<double> jitters;
+
+    /************************************************************************/
+    StressThread(ExchangeData *commData, const string &name, const int period,
+                 const double work) : PeriodicThread((double)period/1000.0),
+                 commData(commData), name(name), nominalPeriod((double)period/1000.0),
+                 work(work), lastStart(-1.0), S(4,4)
+    {
+        xd.resize(3,0.0); x.resize(3,0.0);
+        qd.resize(6,0.0); q.resize(6,0.0);
+        torso.resize(3,0.0); v.resize(6,0.0);
+        counterv.resize(3,0.0);
+        S=eye(4,4);
+    }
+
+    /************************************************************************/
+    bool threadInit() override
+    {
+        latencies.reserve(100000);
+        jitters.reserve(100000);
+        return true;
+    }
+
+    /************************************************************************/
+    void run() override
+    {
+        double t0=Time::now();
+        bool record=(latencies.size()<latencies.capacity());
+        if (record && (lastStart>0.0))
+            jitters.push_back(fabs(t0-lastStart-nominalPeriod));
+        lastStart=t0;
+
+        exchange();
+        spin();
+
+        // samples are preallocated to keep the cycle allocation-free
+        if (record)
+            latencies.push_back(Time::now()-t0);
+    }
+
+    /************************************************************************/
+    const string &getName() const { return name; }
+};
+
+
+/************************************************************************/
+class CtrlStress : public StressThread
+{
+    void exchange() override
+    {
+        double stamp;
+        commData->get_xd(xd);
+        commData->get_x(x,stamp);
+        commData->get_qd(qd);
+        commData->get_counterv(counterv);
+        q[0]+=1e-3;
+        commData->set_q(q);
+        commData->set_torso(torso);
+        commData->set_v(v);
+    }
+
+public:
+    CtrlStress(ExchangeData *commData, const double work) :
+               StressThread(commData,"controller",10,work) { }
+};
+
+
+/************************************************************************/
+class LocStress : public StressThread
+{
+    void exchange() override
+    {
+        double stamp;
+        commData->get_x(x,stamp);
+        commData->get_q(q);
+        commData->get_torso(torso);
+        commData->get_fpFrame(S);
+    }
+
+public:
+    LocStress(ExchangeData *commData, const double work) :
+              StressThread(commData,"localizer",10,work) { }
+};
+
+
+/************************************************************************/
+class EyesStress : public StressThread
+{
+    void exchange() override
+    {
+        commData->get_v(v);
+        commData->get_counterv(counterv);
+        commData->set_counterv(counterv);
+        commData->set_xd(xd);
+        commData->set_x(x,Time::now());
+        commData->set_fpFrame(S);
+        commData->set_qd(3,qd[3]);
+        commData->set_qd(4,qd[4]);
+        commData->set_qd(5,qd[5]);
+    }
+
+public:
+    EyesStress(ExchangeData *commData, const double work) :
+               StressThread(commData,"eyePinvRefGen",20,work) { }
+};
+
+
+/************************************************************************/
+class SlvStress : public StressThread
+{
+    void exchange() override
+    {
+        commData->get_q(q);
+        commData->get_torso(torso);
+        commData->get_fpFrame(S);
+        commData->set_xd(xd);
+        commData->set_qd(qd);
+    }
+
+public:
+    SlvStress(ExchangeData *commData, const double work) :
+              StressThread(commData,"solver",20,work) { }
+};
+
+
+/************************************************************************/
+class LoadThread : public Thread
+{
+    ExchangeData *commData;
+    Vector x,q;
+
+public:
+    /************************************************************************/
+    explicit LoadThread(ExchangeData *commData) : commData(commData),
+                                                  x(3,0.0), q(6,0.0) { }
+
+    /************************************************************************/
+    void run() override
+    {
+        double stamp;
+        while (!isStopping())
+        {
+            commData->get_x(x,stamp);
+            commData->get_q(q);
+            commData->set_x(x,stamp);
+        }
+    }
+};
+
+
+/************************************************************************/
+double percentile(vector<double> &samples, const double p)
+{
+    if (samples.empty())
+        return 0.0;
+
+    std::sort(samples.begin(),samples.end());
+    size_t i=(size_t)(p*(samples.size()-1)+0.5);
+    return samples[std::min(i,samples.size()-1)];
+}
+
+
+/************************************************************************/
+int main(int argc, char *argv[])
+{
+    Network yarp;
+
+    ResourceFinder rf;
+    rf.configure(argc,argv);
+
+    if (rf.check("help"))
+    {
+        printf("Options\n");
+        printf("\t--duration <s>: test duration (default: 10.0)\n");
+        printf("\t--load     <N>: number of extra threads hammering the data (default: 4)\n");
+        printf("\t--work    <ms>: emulated computation per cycle (default: 1.0)\n");
+        printf("\n");
+        return 0;
+    }
+
+    double duration=rf.check("duration",Value(10.0)).asFloat64();
+    int nLoad=std::max(0,rf.check("load",Value(4)).asInt32());
+    double work=rf.check("work",Value(1.0)).asFloat64()/1000.0;
+
+    ExchangeData commData;
+    commData.set_xd(Vector(3,0.0));
+    commData.set_x(Vector(3,0.0),0.0);
+    commData.set_qd(Vector(6,0.0));
+    commData.set_q(Vector(6,0.0));
+    commData.set_torso(Vector(3,0.0));
+    commData.resize_v(6,0.0);
+    commData.resize_counterv(3,0.0);
+    commData.set_fpFrame(eye(4,4));
+
+    vector<StressThread*> threads;
+    threads.push_back(new CtrlStress(&commData,work));
+    threads.push_back(new LocStress(&commData,work));
+    threads.push_back(new EyesStress(&commData,work));
+    threads.push_back(new SlvStress(&commData,work));
+
+    vector<LoadThread*> load;
+    for (int i=0; i<nLoad; i++)
+    {
+        load.push_back(new LoadThread(&commData));
+        load.back()->start();
+    }
+
+    yInfo("running for %g [s] with %d load threads ...",duration,nLoad);
+    for (auto &t:threads)
+        t->start();
+    Time::delay(duration);
+    for (auto &t:threads)
+        t->stop();
+    for (auto &l:load)
+    {
+        l->stop();
+        delete l;
+    }
+
+    for (auto &t:threads)
+    {
+        yInfo("*** %-14s: %6d cycles; latency [us] p50=%.1f p99=%.1f max=%.1f; jitter [us] p50=%.1f p99=%.1f max=%.1f",
+              t->getName().c_str(),(int)t->latencies.size(),
+              1e6*percentile(t->latencies,0.5),1e6*percentile(t->latencies,0.99),
+              1e6*percentile(t->latencies,1.0),
+              1e6*percentile(t->jitters,0.5),1e6*percentile(t->jitters,0.99),
+              1e6*percentile(t->jitters,1.0));
+        delete t;
+    }
+
+    return 0;
+}
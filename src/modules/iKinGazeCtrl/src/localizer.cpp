@@ -634,12 +634,12 @@ void Localizer::handleAnglesInput()
 void Localizer::handleAnglesOutput()
 {
     double x_stamp;
-    Vector x=commData->get_x(x_stamp);
+    commData->get_x(x_ex,x_stamp);
     txInfo_ang.update(x_stamp);
 
     if (port_anglesOut.getOutputCount()>0)
     {
-        port_anglesOut.prepare()=CTRL_RAD2DEG*getAbsAngles(x);
+        port_anglesOut.prepare()=CTRL_RAD2DEG*getAbsAngles(x_ex);
         port_anglesOut.setEnvelope(txInfo_ang);
         port_anglesOut.write();
     }
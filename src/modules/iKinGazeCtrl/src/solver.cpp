@@ -260,12 +260,15 @@ Vector EyePinvRefGen::getEyesCounterVelocity(const Matrix &eyesJ, const Vector &
     HN.setSubcol(fph,0,3);
 
     chainNeck->setHN(HN);
-    Vector ocr_fprelv=chainNeck->GeoJacobian()*commData->get_v().subVector(0,2);
+    commData->get_v(v_ex);
+    Vector ocr_fprelv=chainNeck->GeoJacobian()*v_ex.subVector(0,2);
     ocr_fprelv=ocr_fprelv.subVector(0,2);
     chainNeck->setHN(eye(4,4));
 
     // ********** blend the contributions
-    return -1.0*(pinv(eyesJ)*(counterRotGain[0]*vor_fprelv+counterRotGain[1]*ocr_fprelv));
+    eyesDLS.setJacobian(eyesJ);
+    eyesDLS.factorize();
+    return -1.0*eyesDLS.solve(counterRotGain[0]*vor_fprelv+counterRotGain[1]*ocr_fprelv);
 }
 
 
@@ -393,7 +396,9 @@ void EyePinvRefGen::run()
         // converge on target
         if (CartesianHelper::computeFixationPointData(*chainEyeL,*chainEyeR,fp,eyesJ))
         {
-            Vector v=EYEPINVREFGEN_GAIN*(pinv(eyesJ)*(xd-fp));
+            eyesDLS.setJacobian(eyesJ);
+            eyesDLS.factorize();
+            Vector v=EYEPINVREFGEN_GAIN*eyesDLS.solve(xd-fp);
 
             // update eyes chains in actual configuration for velocity compensation
             chainEyeL->setAng(nJointsTorso+3,fbHead[3]);               chainEyeR->setAng(nJointsTorso+3,fbHead[3]);
@@ -417,7 +422,8 @@ void EyePinvRefGen::run()
             }
 
             // update reference
-            qd=I->integrate(v+commData->get_counterv());
+            commData->get_counterv(counterv_ex);
+            qd=I->integrate(v+counterv_ex);
         }
         else
             commData->set_counterv(zeros((int)qd.length()));
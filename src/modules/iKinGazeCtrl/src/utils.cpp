@@ -23,15 +23,6 @@
 #include <iCub/utils.h>
 #include <iCub/solver.h>
 
-constexpr int32_t MUTEX_XD       = 0;
-constexpr int32_t MUTEX_QD       = 1;
-constexpr int32_t MUTEX_X        = 2;
-constexpr int32_t MUTEX_Q        = 3;
-constexpr int32_t MUTEX_TORSO    = 4;
-constexpr int32_t MUTEX_V        = 5;
-constexpr int32_t MUTEX_COUNTERV = 6;
-constexpr int32_t MUTEX_FPFRAME  = 7;
-
 /************************************************************************/
 xdPort::xdPort(void *_slv) : slv(_slv)
 {   
@@ -167,7 +158,6 @@ ExchangeData::ExchangeData()
 /************************************************************************/
 void ExchangeData::resize_v(const int sz, const double val)
 {
-    lock_guard<mutex> lg(mtx[MUTEX_V]);
     v.resize(sz,val);
 }
 
@@ -175,7 +165,6 @@ void ExchangeData::resize_v(const int sz, const double val)
 /************************************************************************/
 void ExchangeData::resize_counterv(const int sz, const double val)
 {
-    lock_guard<mutex> lg(mtx[MUTEX_COUNTERV]);
     counterv.resize(sz,val);
 }
 
@@ -183,88 +172,79 @@ void ExchangeData::resize_counterv(const int sz, const double val)
 /************************************************************************/
 void ExchangeData::set_xd(const Vector &_xd)
 {
-    lock_guard<mutex> lg(mtx[MUTEX_XD]);
-    xd=_xd;
+    xd.write(_xd);
 }
 
 
 /************************************************************************/
 void ExchangeData::set_qd(const Vector &_qd)
 {
-    lock_guard<mutex> lg(mtx[MUTEX_QD]);
-    qd=_qd;
+    qd.write(_qd);
 }
 
 
 /************************************************************************/
 void ExchangeData::set_qd(const int i, const double val)
 {
-    lock_guard<mutex> lg(mtx[MUTEX_QD]);
-    qd[i]=val;
+    qd.write(i,val);
 }
 
 
 /************************************************************************/
 void ExchangeData::set_x(const Vector &_x)
 {
-    lock_guard<mutex> lg(mtx[MUTEX_X]);
-    x=_x;
+    x.write(_x);
 }
 
 
 /************************************************************************/
 void ExchangeData::set_x(const Vector &_x, const double stamp)
 {
-    lock_guard<mutex> lg(mtx[MUTEX_X]);
-    x=_x;
-    x_stamp=stamp;
+    x.write(_x,stamp);
 }
 
 
 /************************************************************************/
 void ExchangeData::set_q(const Vector &_q)
 {
-    lock_guard<mutex> lg(mtx[MUTEX_Q]);
-    q=_q;
+    q.write(_q);
 }
 
 
 /************************************************************************/
 void ExchangeData::set_torso(const Vector &_torso)
 {
-    lock_guard<mutex> lg(mtx[MUTEX_TORSO]);
-    torso=_torso;
+    torso.write(_torso);
 }
 
 
 /************************************************************************/
 void ExchangeData::set_v(const Vector &_v)
 {
-    lock_guard<mutex> lg(mtx[MUTEX_V]);
-    v=_v;
+    v.write(_v);
 }
 
 
 /************************************************************************/
 void ExchangeData::set_counterv(const Vector &_counterv)
 {
-    lock_guard<mutex> lg(mtx[MUTEX_COUNTERV]);
-    counterv=_counterv;
+    counterv.write(_counterv);
 }
 
 
 /************************************************************************/
 void ExchangeData::set_fpFrame(const Matrix &_S)
 {
-    lock_guard<mutex> lg(mtx[MUTEX_FPFRAME]);
-    S=_S;
+    yAssert((_S.rows()==4) && (_S.cols()==4));
+    S.write(_S.data(),16);
 }
 
+
 /************************************************************************/
 Vector ExchangeData::get_xd()
 {
-    lock_guard<mutex> lg(mtx[MUTEX_XD]);
-    Vector _xd=xd;
+    Vector _xd;
+    xd.read(_xd);
     return _xd;
 }
 
@@ -272,8 +252,8 @@ Vector ExchangeData::get_xd()
 /************************************************************************/
 Vector ExchangeData::get_qd()
 {
-    lock_guard<mutex> lg(mtx[MUTEX_QD]);
-    Vector _qd=qd;
+    Vector _qd;
+    qd.read(_qd);
     return _qd;
 }
 
@@ -281,8 +261,8 @@ Vector ExchangeData::get_qd()
 /************************************************************************/
 Vector ExchangeData::get_x()
 {
-    lock_guard<mutex> lg(mtx[MUTEX_X]);
-    Vector _x=x;
+    Vector _x;
+    x.read(_x);
     return _x;
 }
 
@@ -290,9 +270,8 @@ Vector ExchangeData::get_x()
 /************************************************************************/
 Vector ExchangeData::get_x(double &stamp)
 {
-    lock_guard<mutex> lg(mtx[MUTEX_X]);
-    Vector _x=x;
-    stamp=x_stamp;
+    Vector _x;
+    x.read(_x,&stamp);
     return _x;
 }
 
@@ -300,8 +279,8 @@ Vector ExchangeData::get_x(double &stamp)
 /************************************************************************/
 Vector ExchangeData::get_q()
 {
-    lock_guard<mutex> lg(mtx[MUTEX_Q]);
-    Vector _q=q;
+    Vector _q;
+    q.read(_q);
     return _q;
 }
 
@@ -309,8 +288,8 @@ Vector ExchangeData::get_q()
 /************************************************************************/
 Vector ExchangeData::get_torso()
 {
-    lock_guard<mutex> lg(mtx[MUTEX_TORSO]);
-    Vector _torso=torso;
+    Vector _torso;
+    torso.read(_torso);
     return _torso;
 }
 
@@ -318,8 +297,8 @@ Vector ExchangeData::get_torso()
 /************************************************************************/
 Vector ExchangeData::get_v()
 {
-    lock_guard<mutex> lg(mtx[MUTEX_V]);
-    Vector _v=v;
+    Vector _v;
+    v.read(_v);
     return _v;
 }
 
@@ -327,8 +306,8 @@ Vector ExchangeData::get_v()
 /************************************************************************/
 Vector ExchangeData::get_counterv()
 {
-    lock_guard<mutex> lg(mtx[MUTEX_COUNTERV]);
-    Vector _counterv=counterv;
+    Vector _counterv;
+    counterv.read(_counterv);
     return _counterv;
 }
 
@@ -336,11 +315,69 @@ Vector ExchangeData::get_counterv()
 /************************************************************************/
 Matrix ExchangeData::get_fpFrame()
 {
-    lock_guard<mutex> lg(mtx[MUTEX_FPFRAME]);
-    Matrix _S=S;
+    Matrix _S(4,4);
+    S.read(_S.data(),16);
     return _S;
 }
 
+
+/************************************************************************/
+unsigned int ExchangeData::get_xd(Vector &_xd)
+{
+    return xd.read(_xd);
+}
+
+
+/************************************************************************/
+unsigned int ExchangeData::get_qd(Vector &_qd)
+{
+    return qd.read(_qd);
+}
+
+
+/************************************************************************/
+unsigned int ExchangeData::get_x(Vector &_x, double &stamp)
+{
+    return x.read(_x,&stamp);
+}
+
+
+/************************************************************************/
+unsigned int ExchangeData::get_q(Vector &_q)
+{
+    return q.read(_q);
+}
+
+
+/************************************************************************/
+unsigned int ExchangeData::get_torso(Vector &_torso)
+{
+    return torso.read(_torso);
+}
+
+
+/************************************************************************/
+unsigned int ExchangeData::get_v(Vector &_v)
+{
+    return v.read(_v);
+}
+
+
+/************************************************************************/
+unsigned int ExchangeData::get_counterv(Vector &_counterv)
+{
+    return counterv.read(_counterv);
+}
+
+
+/************************************************************************/
+unsigned int ExchangeData::get_fpFrame(Matrix &_S)
+{
+    if ((_S.rows()!=4) || (_S.cols()!=4))
+        _S.resize(4,4);
+    return S.read(_S.data(),16);
+}
+
 /************************************************************************/
 std::pair<Vector,bool>  ExchangeData::get_gyro() {
     std::pair<Vector, bool> ret;
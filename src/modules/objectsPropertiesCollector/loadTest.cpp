@@ -0,0 +1,319 @@
+/*
+ * Copyright (C) 2022 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+// Load-test client for objectsPropertiesCollector: fills the database
+// with synthetic items and then hammers it with [ask]/[get] requests from
+// several concurrent clients, reporting the throughput and the latency
+// percentiles.
+
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <sstream>
+
+#include <yarp/os/all.h>
+
+using namespace std;
+using namespace yarp::os;
+
+static const char *colors[]={"red","green","blue","yellow","black","white","orange","pink"};
+static const int nColors=sizeof(colors)/sizeof(colors[0]);
+
+
+/************************************************************************/
+class Client : public Thread
+{
+protected:
+    string local,remote;
+    int nRequests;
+    double getRatio;
+    int nItems;
+    int firstId;
+    unsigned int seed;
+    RpcClient port;
+
+    /************************************************************************/
+    int rnd(const int n)
+    {
+        seed=1103515245*seed+12345;
+        return (int)((seed>>16)%(unsigned int)n);
+    }
+
+    /************************************************************************/
+    void prepareRequest(Bottle &cmd)
+    {
+        cmd.clear();
+        if (rnd(1000)<(int)(1000.0*getRatio))
+        {
+            cmd.addVocab32(Vocab32::encode("get"));
+            Bottle &content=cmd.addList();
+            Bottle &id=content.addList();
+            id.addString("id");
+            id.addInt32(firstId+rnd(nItems));
+            return;
+        }
+
+        cmd.addVocab32(Vocab32::encode("ask"));
+        Bottle &content=cmd.addList();
+        switch (rnd(3))
+        {
+            // equality on a highly selective property
+            case 0:
+            {
+                Bottle &cond=content.addList();
+                cond.addString("name");
+                cond.addString("==");
+                ostringstream name; name<<"obj_"<<rnd(nItems);
+                cond.addString(name.str());
+                break;
+            }
+
+            // range combined with equality
+            case 1:
+            {
+                Bottle &cond1=content.addList();
+                cond1.addString("x");
+                cond1.addString("<");
+                cond1.addFloat64(0.1*rnd(10));
+                content.addString("&&");
+                Bottle &cond2=content.addList();
+                cond2.addString("color");
+                cond2.addString("==");
+                cond2.addString(colors[rnd(nColors)]);
+                break;
+            }
+
+            // disjunction of ranges
+            default:
+            {
+                Bottle &cond1=content.addList();
+                cond1.addString("size");
+                cond1.addString(">=");
+                cond1.addInt32(95+rnd(5));
+                content.addString("||");
+                Bottle &cond2=content.addList();
+                cond2.addString("size");
+                cond2.addString("<");
+                cond2.addInt32(rnd(5));
+            }
+        }
+    }
+
+public:
+    vector<double> latencies;
+    int failures;
+
+    /************************************************************************/
+    Client(const string &local, const string &remote, const int nRequests,
+           const int nItems, const int firstId, const double getRatio,
+           const unsigned int seed) :
+           local(local), remote(remote), nRequests(nRequests), getRatio(getRatio),
+           nItems(nItems), firstId(firstId), seed(seed), failures(0) { }
+
+    /************************************************************************/
+    bool threadInit() override
+    {
+        if (!port.open(local))
+            return false;
+
+        return Network::connect(local,remote);
+    }
+
+    /************************************************************************/
+    void run() override
+    {
+        latencies.reserve(nRequests);
+
+        Bottle cmd,reply;
+        for (int i=0; (i<nRequests) && !isStopping(); i++)
+        {
+            prepareRequest(cmd);
+
+            double t0=Time::now();
+            bool ok=port.write(cmd,reply);
+            latencies.push_back(Time::now()-t0);
+
+            if (!ok || (reply.get(0).asVocab32()!=Vocab32::encode("ack")))
+                failures++;
+        }
+    }
+
+    /************************************************************************/
+    void threadRelease() override
+    {
+        port.close();
+    }
+};
+
+
+/************************************************************************/
+bool populate(const string &local, const string &remote, const int nItems,
+              vector<int> &ids)
+{
+    RpcClient port;
+    if (!port.open(local))
+        return false;
+
+    if (!Network::connect(local,remote))
+    {
+        port.close();
+        return false;
+    }
+
+    unsigned int seed=1;
+    ids.clear();
+    for (int i=0; i<nItems; i++)
+    {
+        seed=1103515245*seed+12345;
+
+        Bottle cmd,reply;
+        cmd.addVocab32(Vocab32::encode("add"));
+        Bottle &content=cmd.addList();
+
+        ostringstream name; name<<"obj_"<<i;
+        Bottle &pName=content.addList();
+        pName.addString("name"); pName.addString(name.str());
+
+        Bottle &pColor=content.addList();
+        pColor.addString("color"); pColor.addString(colors[(seed>>16)%nColors]);
+
+        Bottle &pX=content.addList();
+        pX.addString("x"); pX.addFloat64(((seed>>8)%1000)/1000.0);
+
+        Bottle &pSize=content.addList();
+        pSize.addString("size"); pSize.addInt32((seed>>4)%100);
+
+        if (!port.write(cmd,reply) || (reply.get(0).asVocab32()!=Vocab32::encode("ack")))
+        {
+            yError("unable to add item #%d",i);
+            port.close();
+            return false;
+        }
+
+        ids.push_back(reply.get(1).asList()->get(1).asInt32());
+    }
+
+    port.close();
+    return true;
+}
+
+
+/************************************************************************/
+void cleanup(const string &local, const string &remote, const vector<int> &ids)
+{
+    RpcClient port;
+    if (!port.open(local))
+        return;
+
+    if (Network::connect(local,remote))
+    {
+        for (size_t i=0; i<ids.size(); i++)
+        {
+            Bottle cmd,reply;
+            cmd.addVocab32(Vocab32::encode("del"));
+            Bottle &content=cmd.addList();
+            Bottle &id=content.addList();
+            id.addString("id"); id.addInt32(ids[i]);
+            port.write(cmd,reply);
+        }
+    }
+
+    port.close();
+}
+
+
+/************************************************************************/
+double percentile(const vector<double> &sorted, const double p)
+{
+    if (sorted.empty())
+        return 0.0;
+
+    size_t i=(size_t)(p*(sorted.size()-1)+0.5);
+    return sorted[std::min(i,sorted.size()-1)];
+}
+
+
+/************************************************************************/
+int main(int argc, char *argv[])
+{
+    Network yarp;
+
+    ResourceFinder rf;
+    rf.configure(argc,argv);
+
+    if (rf.check("help"))
+    {
+        printf("Options\n");
+        printf("\t--name        <name>: local ports prefix (default: objectsPropertiesCollectorLoadTest)\n");
+        printf("\t--remote      <name>: collector name (default: objectsPropertiesCollector)\n");
+        printf("\t--items          <N>: number of items added before the test (default: 1000)\n");
+        printf("\t--requests       <N>: number of requests sent by each client (default: 10000)\n");
+        printf("\t--clients        <N>: number of concurrent clients (default: 4)\n");
+        printf("\t--get-ratio      <r>: fraction of [get] requests over [ask] requests (default: 0.2)\n");
+        printf("\t--keep              : do not remove the added items at the end\n");
+        printf("\n");
+        return 0;
+    }
+
+    if (!yarp.checkNetwork())
+    {
+        yError("YARP server not available!");
+        return 1;
+    }
+
+    string name="/"+rf.check("name",Value("objectsPropertiesCollectorLoadTest")).asString();
+    string remote="/"+rf.check("remote",Value("objectsPropertiesCollector")).asString()+"/rpc";
+    int nItems=std::max(1,rf.check("items",Value(1000)).asInt32());
+    int nRequests=std::max(1,rf.check("requests",Value(10000)).asInt32());
+    int nClients=std::max(1,rf.check("clients",Value(4)).asInt32());
+    double getRatio=rf.check("get-ratio",Value(0.2)).asFloat64();
+
+    vector<int> ids;
+    yInfo("adding %d items ...",nItems);
+    double t0=Time::now();
+    if (!populate(name+"/populate",remote,nItems,ids))
+        return 1;
+    yInfo("items added in %g [s]",Time::now()-t0);
+
+    vector<Client*> clients;
+    for (int i=0; i<nClients; i++)
+    {
+        ostringstream local; local<<name<<"/client_"<<i;
+        clients.push_back(new Client(local.str(),remote,nRequests,nItems,ids.front(),getRatio,i+1));
+    }
+
+    yInfo("running %d clients x %d requests ...",nClients,nRequests);
+    t0=Time::now();
+    for (size_t i=0; i<clients.size(); i++)
+        clients[i]->start();
+    for (size_t i=0; i<clients.size(); i++)
+        clients[i]->join();
+    double dt=Time::now()-t0;
+
+    vector<double> latencies;
+    int failures=0;
+    for (size_t i=0; i<clients.size(); i++)
+    {
+        latencies.insert(latencies.end(),clients[i]->latencies.begin(),clients[i]->latencies.end());
+        failures+=clients[i]->failures;
+        delete clients[i];
+    }
+    std::sort(latencies.begin(),latencies.end());
+
+    yInfo("*** %d requests in %g [s] => %g [requests/s]; %d failures",
+          (int)latencies.size(),dt,latencies.size()/dt,failures);
+    yInfo("*** latency [ms]: p50=%g p90=%g p99=%g max=%g",
+          1e3*percentile(latencies,0.5),1e3*percentile(latencies,0.9),
+          1e3*percentile(latencies,0.99),latencies.empty()?0.0:1e3*latencies.back());
+
+    if (!rf.check("keep"))
+        cleanup(name+"/cleanup",remote,ids);
+
+    return 0;
+}
@@ -43,6 +43,13 @@ The user can set, get, add, remove items and make queries
 to the database. \n 
 Importantly, the module is capable of running in real-time.
 
+Queries are served through per-property secondary indexes (hash
+tables for string equality, ordered sets for numeric comparisons)
+kept up to date at each change: for each group of conditions in
+logical "and" only the items selected by the most selective
+condition are inspected. Requests that do not modify the content
+(e.g. [get], [ask], [time]) can be served concurrently.
+
 \section proto_sec Protocol
  
 Notation used hereafter to explain available commands: [.] is a 
@@ -164,6 +171,17 @@ this is not a real limitation since nested conditions can be
 properly expanded: indeed, the previous example can be cast back 
 to (cond1)&&(cond2) || (cond1)&&(cond3). 
  
+ 
+<b>changes feed</b> \n 
+<i>Format</i>: [feed] [add] ((prop0 "<" <val0>) || ...)/[del] 
+"port_name" \n 
+<i>Reply</i>: [nack]; [ack] ["port_name"] \n 
+<i>Action</i>: [add] opens a new port that streams only the 
+changes regarding the items that satisfy the given conditions 
+(same syntax of the [ask] command; omit the conditions or use 
+(all) to receive every change) before or after the change 
+itself; the name of the port is returned. [del] closes the port. 
+ 
 <b>quit</b> \n 
 <i>Format</i>: [quit] \n 
 <i>Reply</i>: [ack] \n 
@@ -200,8 +218,26 @@ to (cond1)&&(cond2) || (cond1)&&(cond3).
 --async-bc 
 - Broadcast the database content whenever a change occurs. 
  
+--no-journal 
+- Every change is normally appended to the journal file 
+  <dbFileName>.journal (in the home context path) as soon as it
+  occurs; at startup the journal is replayed on top of the 
+  snapshot. This option disables the journal, so that changes 
+  are stored only when the snapshot is taken.
+ 
+--journal-compact <N>
+- Take a new snapshot of the database, which empties the 
+  journal, after \e N changes have been journaled. If not 
+  specified, \e N is 1000. 
+ 
 --stats 
-- Enable statistics printouts.
+- Enable statistics printouts, including the bandwidth used by 
+  the broadcast and changes ports.
+
+The companion tool \e objectsPropertiesCollectorLoadTest fills 
+the database with synthetic items and stresses it with [ask] and 
+[get] requests from concurrent clients, reporting the throughput 
+and the latency percentiles (use --help for the options). 
  
 \section portsa_sec Ports Accessed
 None.
@@ -217,6 +253,12 @@ None.
 - \e /<moduleName>/modify:i the port used to modify the database
   content complying with the data format implemented for the
   broadcast port.
+
+- \e /<moduleName>/changes:o streams each change as soon as it
+  occurs, in the form "add" <id> (("prop0" <val0>) ...), "set" 
+  <id> (("prop0" <val0>) ...), "del" <id> [("prop0" ...)] or 
+  "clear". The same format is used by the ports opened with the
+  [feed] command.
  
 \section in_files_sec Input Data Files
 None.
@@ -257,11 +299,27 @@ reply: [ack] (id (1))
 
 #include <cstdio>
 #include <cstdarg>
+#include <cmath>
+#include <climits>
+#include <atomic>
 #include <mutex>
+#include <shared_mutex>
 #include <sstream>
+#include <fstream>
 #include <string>
+#include <vector>
+#include <set>
 #include <map>
+#include <unordered_map>
+#include <utility>
 #include <deque>
+#include <algorithm>
+
+#ifdef _WIN32
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+    #include <windows.h>
+#endif
 
 #include <yarp/os/all.h>
 
@@ -280,6 +338,7 @@ using namespace yarp::os;
 #define CMD_ASK                         createVocab32('a','s','k')
 #define CMD_SYNC                        createVocab32('s','y','n','c')
 #define CMD_ASYNC                       createVocab32('a','s','y','n')
+#define CMD_FEED                        createVocab32('f','e','e','d')
 #define CMD_QUIT                        createVocab32('q','u','i','t')
 #define CMD_BYE                         createVocab32('b','y','e')
                                         
@@ -297,6 +356,10 @@ using namespace yarp::os;
 #define BCTAG_EMPTY                     ("empty")
 #define BCTAG_SYNC                      ("sync")
 #define BCTAG_ASYNC                     ("async")
+#define CHG_ADD                         ("add")
+#define CHG_SET                         ("set")
+#define CHG_DEL                         ("del")
+#define CHG_CLEAR                       ("clear")
 
 
 namespace relationalOperators
@@ -415,21 +478,66 @@ protected:
     struct Condition
     {
         string prop;
+        string op;
         bool (*compare)(Value&,Value&);
         Value val;
     };
 
+    /************************************************************************/
+    struct Index    // secondary index of a single property
+    {
+        std::set<int> ids;                                  // items having the property
+        unordered_map<string,std::set<int>> strings;        // equality on strings
+        std::set<pair<int,int>>    ints;                    // ordered (value,id)
+        std::set<pair<double,int>> doubles;                 // ordered (value,id)
+    };
+
     ResourceFinder *rf;
     map<int,Item> itemsMap;
-    mutex mtx;
+    unordered_map<string,Index> indexes;
+    shared_timed_mutex mtx;
+    mutex mtxBroadcast;
     int  idCnt;
     bool initialized;
     bool nosavedb;
     bool quitting;
 
+    /************************************************************************/
+    struct Subscriber
+    {
+        BufferedPort<Bottle> *port;
+        deque<Condition> condList;
+        vector<vector<size_t>> groups;  // no filter if empty
+    };
+
     BufferedPort<Bottle> *pBroadcastPort;
     bool asyncBroadcast;
 
+    /************************************************************************/
+    struct Delta    // change waiting to be sent out of the lock
+    {
+        Bottle entry;
+        vector<BufferedPort<Bottle>*> ports;
+    };
+
+    BufferedPort<Bottle> *pChangesPort;
+    deque<Subscriber> subscribers;
+    string feedPrefix;
+    int subscribersCnt;
+    deque<Delta> pending;
+    mutex mtxPending;
+    mutex mtxFeed;
+
+    FILE *journalFile;
+    string journalFileName;
+    int journalEntries;
+    int journalCompaction;
+    mutex mtxJournal;
+
+    bool stats;
+    atomic<size_t> bcBytes;
+    atomic<size_t> feedBytes;
+
     /************************************************************************/
     void clear()
     {
@@ -437,72 +545,554 @@ protected:
             delete it->second.prop;
 
         itemsMap.clear();
+        indexes.clear();
     }
 
     /************************************************************************/
     void eraseItem(map<int,Item>::iterator &it)
     {
+        unindexItem(it->first,it->second.prop);
         delete it->second.prop;
         itemsMap.erase(it);
     }
 
     /************************************************************************/
-    void write(FILE *stream)
+    void indexValue(const int id, const string &prop, Value &val)
     {
-        int i=0;
-        for (map<int,Item>::iterator it=itemsMap.begin(); it!=itemsMap.end(); it++)
-            fprintf(stream,"item_%d (%s %d) (%s)\n",
-                    i++,PROP_ID,it->first,it->second.prop->toString().c_str());
+        Index &index=indexes[prop];
+        index.ids.insert(id);
+
+        if (val.isString())
+            index.strings[val.asString()].insert(id);
+        else if (val.isInt32())
+            index.ints.insert(make_pair(val.asInt32(),id));
+        else if (val.isFloat64() && !std::isnan(val.asFloat64()))
+            index.doubles.insert(make_pair(val.asFloat64(),id));
     }
 
     /************************************************************************/
-    bool recursiveCheck(Property *item, deque<Condition> &condList,
-                        deque<string> &opList, const unsigned int i=0)
+    void unindexValue(const int id, const string &prop, Value &val)
     {
-        bool result;
-        if (item->check(condList[i].prop))
+        unordered_map<string,Index>::iterator it=indexes.find(prop);
+        if (it==indexes.end())
+            return;
+
+        Index &index=it->second;
+        index.ids.erase(id);
+
+        if (val.isString())
         {
-            // take the current value of the item's property under test
-            Value &val=item->find(condList[i].prop);
+            unordered_map<string,std::set<int>>::iterator bucket=index.strings.find(val.asString());
+            if (bucket!=index.strings.end())
+            {
+                bucket->second.erase(id);
+                if (bucket->second.empty())
+                    index.strings.erase(bucket);
+            }
+        }
+        else if (val.isInt32())
+            index.ints.erase(make_pair(val.asInt32(),id));
+        else if (val.isFloat64() && !std::isnan(val.asFloat64()))
+            index.doubles.erase(make_pair(val.asFloat64(),id));
+
+        if (index.ids.empty())
+            indexes.erase(it);
+    }
+
+    /************************************************************************/
+    void indexItem(const int id, Property *prop)
+    {
+        Bottle content; content.read(*prop);
+        for (int i=0; i<content.size(); i++)
+        {
+            if (Bottle *option=content.get(i).asList())
+            {
+                string name=option->get(0).asString();
+                indexValue(id,name,prop->find(name));
+            }
+        }
+    }
 
-            // compute the condition over the current value
-            result=(*condList[i].compare)(val,condList[i].val);
+    /************************************************************************/
+    void unindexItem(const int id, Property *prop)
+    {
+        Bottle content; content.read(*prop);
+        for (int i=0; i<content.size(); i++)
+        {
+            if (Bottle *option=content.get(i).asList())
+            {
+                string name=option->get(0).asString();
+                unindexValue(id,name,prop->find(name));
+            }
         }
+    }
+
+    /************************************************************************/
+    template<typename T>
+    size_t selectRange(const std::set<pair<T,int>> &s, const string &op, const T val,
+                       vector<int> *ids)
+    {
+        typename std::set<pair<T,int>>::const_iterator lo=s.begin();
+        typename std::set<pair<T,int>>::const_iterator hi=s.end();
+
+        if (op=="==")
+        {
+            lo=s.lower_bound(make_pair(val,INT_MIN));
+            hi=s.upper_bound(make_pair(val,INT_MAX));
+        }
+        else if (op==">")
+            lo=s.upper_bound(make_pair(val,INT_MAX));
+        else if (op==">=")
+            lo=s.lower_bound(make_pair(val,INT_MIN));
+        else if (op=="<")
+            hi=s.lower_bound(make_pair(val,INT_MIN));
+        else if (op=="<=")
+            hi=s.upper_bound(make_pair(val,INT_MAX));
         else
-            result=false;
+            return 0;
 
-        if ((i+1)>=condList.size())
-            return result;
-        else if (opList[i]=="||")
-            return (result||recursiveCheck(item,condList,opList,i+1));
-        else    // at this point we know we deal with "&&" operations
+        size_t cnt=0;
+        for (; lo!=hi; lo++, cnt++)
+            if (ids!=NULL)
+                ids->push_back(lo->second);
+
+        return cnt;
+    }
+
+    /************************************************************************/
+    size_t selectCandidates(Condition &cond, vector<int> *ids)
+    {
+        // return the number of items that may satisfy the condition
+        // according to the indexes and fill the ids list if provided
+        unordered_map<string,Index>::iterator it=indexes.find(cond.prop);
+        if (it==indexes.end())
+            return 0;
+
+        Index &index=it->second;
+        if (cond.op.empty() || (cond.op=="!="))
+        {
+            if (ids!=NULL)
+                ids->insert(ids->end(),index.ids.begin(),index.ids.end());
+            return index.ids.size();
+        }
+        else if (cond.val.isString())
+        {
+            if (cond.op!="==")
+                return 0;
+
+            unordered_map<string,std::set<int>>::iterator bucket=index.strings.find(cond.val.asString());
+            if (bucket==index.strings.end())
+                return 0;
+
+            if (ids!=NULL)
+                ids->insert(ids->end(),bucket->second.begin(),bucket->second.end());
+            return bucket->second.size();
+        }
+        else if (cond.val.isInt32())
+            return selectRange(index.ints,cond.op,cond.val.asInt32(),ids);
+        else if (cond.val.isFloat64())
         {
-            unsigned int j;
-            for (j=i+1; j<condList.size(); j++)
+            // NaN does not compare with anything and is kept out of
+            // the ordered sets, which it would otherwise corrupt
+            if (std::isnan(cond.val.asFloat64()))
+                return 0;
+            return selectRange(index.doubles,cond.op,cond.val.asFloat64(),ids);
+        }
+        else
+            return 0;
+    }
+
+    /************************************************************************/
+    bool checkConditions(Property *item, deque<Condition> &condList,
+                         const vector<size_t> &group)
+    {
+        for (size_t i=0; i<group.size(); i++)
+        {
+            Condition &cond=condList[group[i]];
+            if (!item->check(cond.prop))
+                return false;
+
+            Value &val=item->find(cond.prop);
+            if (!(*cond.compare)(val,cond.val))
+                return false;
+        }
+
+        return true;
+    }
+
+    /************************************************************************/
+    bool parseConditions(Bottle *content, deque<Condition> &condList,
+                         vector<vector<size_t>> &groups)
+    {
+        deque<string> opList;
+
+        // we cannot accept a conditions string ending with
+        // a boolean operator
+        if (!(content->size()&0x01))
+        {
+            yWarning("uncorrect conditions received!");
+            return false;
+        }
+
+        // parse the received conditions and build the lists
+        for (int i=0; i<content->size(); i+=2)
+        {
+            if (Bottle *b=content->get(i).asList())
             {
-                if (result)
+                Condition condition;
+                string operation;
+
+                if (b->size()==1)
+                {
+                    condition.prop=b->get(0).asString();
+                    condition.compare=&relationalOperators::alwaysTrue;
+                }
+                else if (b->size()>2)
+                {
+                    condition.prop=b->get(0).asString();
+                    operation=b->get(1).asString();
+                    condition.op=operation;
+                    condition.val=b->get(2);
+
+                    if (operation==">")
+                        condition.compare=&relationalOperators::greater;
+                    else if (operation==">=")
+                        condition.compare=&relationalOperators::greaterEqual;
+                    else if (operation=="<")
+                        condition.compare=&relationalOperators::lower;
+                    else if (operation=="<=")
+                        condition.compare=&relationalOperators::lowerEqual;
+                    else if (operation=="==")
+                        condition.compare=&relationalOperators::equal;
+                    else if (operation=="!=")
+                        condition.compare=&relationalOperators::notEqual;
+                    else
+                    {
+                        yWarning("unknown relational operator '%s'!",operation.c_str());
+                        return false;
+                    }
+                }
+                else
+                {
+                    yWarning("wrong condition given!");
+                    return false;
+                }
+
+                condList.push_back(condition);
+
+                if ((i+1)<content->size())
                 {
-                    if (item->check(condList[j].prop))
+                    operation=content->get(i+1).asString();
+                    if ((operation!="||") && (operation!="&&"))
                     {
-                        Value &val=item->find(condList[j].prop);
-                        result=result&&(*condList[j].compare)(val,condList[j].val);
+                        yWarning("unknown boolean operator '%s'!",operation.c_str());
+                        return false;
                     }
                     else
-                        result=false;
+                        opList.push_back(operation);
                 }
+            }
+            else
+            {
+                yWarning("wrong condition given!");
+                return false;
+            }
+        }
+
+        // "&&" takes precedence over "||": split the conditions
+        // in groups to be put in logical "or"
+        groups.assign(1,vector<size_t>());
+        for (size_t i=0; i<condList.size(); i++)
+        {
+            groups.back().push_back(i);
+            if ((i<opList.size()) && (opList[i]=="||"))
+                groups.push_back(vector<size_t>());
+        }
+
+        return true;
+    }
 
-                if (j<opList.size())
-                    if (opList[j]=="||")
+    /************************************************************************/
+    bool matchConditions(Property *item, deque<Condition> &condList,
+                         vector<vector<size_t>> &groups)
+    {
+        for (size_t i=0; i<groups.size(); i++)
+            if (checkConditions(item,condList,groups[i]))
+                return true;
+
+        return false;
+    }
+
+    /************************************************************************/
+    static size_t sizeOf(Bottle &bottle)
+    {
+        size_t size=0;
+        bottle.toBinary(&size);
+        return size;
+    }
+
+    /************************************************************************/
+    void applyAdd(const int id, Bottle &content)
+    {
+        map<int,Item>::iterator it=itemsMap.find(id);
+        if (it!=itemsMap.end())
+            eraseItem(it);
+
+        Item &item=itemsMap[id];
+        item.prop=new Property(content.toString().c_str());
+        indexItem(id,item.prop);
+
+        if (idCnt<=id)
+            idCnt=id+1;
+    }
+
+    /************************************************************************/
+    void applySet(const int id, Property *pProp, Bottle &content)
+    {
+        for (int i=0; i<content.size(); i++)
+        {
+            if (Bottle *option=content.get(i).asList())
+            {
+                if (option->size()<2)
+                    continue;
+
+                string prop=option->get(0).asString();
+                Value  val=option->get(1);
+
+                if (prop==PROP_ID)
+                    continue;
+
+                if (pProp->check(prop))
+                {
+                    unindexValue(id,prop,pProp->find(prop));
+                    pProp->unput(prop);
+                }
+
+                pProp->put(prop,val);
+                indexValue(id,prop,pProp->find(prop));
+            }
+        }
+    }
+
+    /************************************************************************/
+    void applyDel(map<int,Item>::iterator &it, Bottle *propSet)
+    {
+        if (propSet!=NULL)
+        {
+            Property *pProp=it->second.prop;
+            for (int i=0; i<propSet->size(); i++)
+            {
+                string prop=propSet->get(i).asString();
+                if (pProp->check(prop))
+                {
+                    unindexValue(it->first,prop,pProp->find(prop));
+                    pProp->unput(prop);
+                }
+            }
+        }
+        else
+            eraseItem(it);
+    }
+
+    /************************************************************************/
+    int replay(const string &fileName)
+    {
+        ifstream fin(fileName.c_str());
+        if (!fin.is_open())
+            return 0;
+
+        int cnt=0;
+        string line;
+        while (getline(fin,line))
+        {
+            Bottle entry(line);
+            if (entry.size()==0)
+                continue;
+
+            string type=entry.get(0).asString();
+            if (type==CHG_CLEAR)
+            {
+                clear();
+                cnt++;
+                continue;
+            }
+
+            int id=entry.get(1).asInt32();
+            Bottle *content=entry.get(2).asList();
+            if (type==CHG_ADD)
+            {
+                if (content!=NULL)
+                    applyAdd(id,*content);
+            }
+            else
+            {
+                map<int,Item>::iterator it=itemsMap.find(id);
+                if (it==itemsMap.end())
+                    continue;
+
+                if (type==CHG_SET)
+                {
+                    if (content!=NULL)
+                        applySet(id,it->second.prop,*content);
+                }
+                else if (type==CHG_DEL)
+                    applyDel(it,content);
+            }
+
+            cnt++;
+        }
+
+        return cnt;
+    }
+
+    /************************************************************************/
+    void openJournal(const bool append)
+    {
+        lock_guard<mutex> lck(mtxJournal);
+        journalFile=fopen(journalFileName.c_str(),append?"a":"w");
+        if (journalFile==NULL)
+            yWarning("unable to open the journal %s!",journalFileName.c_str());
+        journalEntries=0;
+    }
+
+    /************************************************************************/
+    void closeJournal()
+    {
+        lock_guard<mutex> lck(mtxJournal);
+        if (journalFile!=NULL)
+        {
+            fclose(journalFile);
+            journalFile=NULL;
+        }
+    }
+
+    /************************************************************************/
+    void journal(Bottle &entry)
+    {
+        lock_guard<mutex> lck(mtxJournal);
+        if (journalFile!=NULL)
+        {
+            fprintf(journalFile,"%s\n",entry.toString().c_str());
+            fflush(journalFile);
+            journalEntries++;
+        }
+    }
+
+    /************************************************************************/
+    void matchSubscribers(const int id, vector<bool> &matches)
+    {
+        matches.assign(subscribers.size(),false);
+
+        map<int,Item>::iterator it=itemsMap.find(id);
+        if (it==itemsMap.end())
+            return;
+
+        for (size_t i=0; i<subscribers.size(); i++)
+        {
+            Subscriber &sub=subscribers[i];
+            matches[i]=sub.groups.empty() ||
+                       matchConditions(it->second.prop,sub.condList,sub.groups);
+        }
+    }
+
+    /************************************************************************/
+    void publish(Bottle &entry, const vector<bool> &before, const vector<bool> &after)
+    {
+        // the write lock is held here: store the change and queue it
+        // for the subscribers whose filter is matched by the item either
+        // before or after the change; it is sent by flushFeed() once the
+        // lock is released, so that slow readers do not stall the database
+        journal(entry);
+
+        Delta delta;
+        if (pChangesPort!=NULL)
+            delta.ports.push_back(pChangesPort);
+
+        for (size_t i=0; i<subscribers.size(); i++)
+        {
+            bool match=((i<before.size()) && before[i]) ||
+                       ((i<after.size()) && after[i]);
+            if (match)
+                delta.ports.push_back(subscribers[i].port);
+        }
+
+        if (!delta.ports.empty())
+        {
+            delta.entry=entry;
+            lock_guard<mutex> lck(mtxPending);
+            pending.push_back(delta);
+        }
+    }
+
+    /************************************************************************/
+    void flushFeed()
+    {
+        // to be called without holding the database lock; the changes
+        // are sent in the order they were published, and the thread
+        // that is already flushing takes care of the ones queued meanwhile
+        while (true)
+        {
+            {
+                unique_lock<mutex> lckFeed(mtxFeed,try_to_lock);
+                if (!lckFeed.owns_lock())
+                    return;
+
+                while (true)
+                {
+                    deque<Delta> deltas;
+                    {
+                        lock_guard<mutex> lck(mtxPending);
+                        deltas.swap(pending);
+                    }
+
+                    if (deltas.empty())
                         break;
+
+                    for (size_t i=0; i<deltas.size(); i++)
+                    {
+                        for (size_t j=0; j<deltas[i].ports.size(); j++)
+                        {
+                            BufferedPort<Bottle> *port=deltas[i].ports[j];
+                            if (port->getOutputCount()>0)
+                            {
+                                Bottle &bottle=port->prepare();
+                                bottle=deltas[i].entry;
+                                if (stats)
+                                    feedBytes+=sizeOf(bottle);
+                                port->writeStrict();
+                            }
+                        }
+                    }
+                }
             }
 
-            if (j>=condList.size())
-                return result;
-            else
-                return (result||recursiveCheck(item,condList,opList,j+1));
+            lock_guard<mutex> lck(mtxPending);
+            if (pending.empty())
+                return;
+        }
+    }
+
+    /************************************************************************/
+    void dropPending(BufferedPort<Bottle> *port)
+    {
+        // mtxFeed is held by the caller
+        lock_guard<mutex> lck(mtxPending);
+        for (size_t i=0; i<pending.size(); i++)
+        {
+            vector<BufferedPort<Bottle>*> &ports=pending[i].ports;
+            ports.erase(std::remove(ports.begin(),ports.end(),port),ports.end());
         }
     }
 
+    /************************************************************************/
+    void write(FILE *stream)
+    {
+        int i=0;
+        for (map<int,Item>::iterator it=itemsMap.begin(); it!=itemsMap.end(); it++)
+            fprintf(stream,"item_%d (%s %d) (%s)\n",
+                    i++,PROP_ID,it->first,it->second.prop->toString().c_str());
+    }
+
     /************************************************************************/
     void run()
     {
@@ -515,6 +1105,14 @@ public:
     {
         pBroadcastPort=NULL;
         asyncBroadcast=false;
+        pChangesPort=NULL;
+        subscribersCnt=0;
+        journalFile=NULL;
+        journalEntries=0;
+        journalCompaction=1000;
+        stats=false;
+        bcBytes=0;
+        feedBytes=0;
         initialized=false;
         nosavedb=false;
         quitting=false;
@@ -528,6 +1126,8 @@ public:
             stop();
 
         save();
+        closeJournal();
+        closeFeed();
         clear();
     }
 
@@ -542,8 +1142,19 @@ public:
         }
 
         nosavedb=rf.check("no-save-db");
-        if (!rf.check("no-load-db"))
+        stats=rf.check("stats");
+        feedPrefix="/"+rf.check("name",Value("objectsPropertiesCollector")).asString();
+        journalCompaction=rf.check("journal-compact",Value(1000)).asInt32();
+        journalFileName=rf.getHomeContextPath()+"/"+rf.find("db").asString()+".journal";
+
+        double t0=Time::now();
+        bool loaddb=!rf.check("no-load-db");
+        if (loaddb)
             load();
+        yInfo("database loaded in %g [s] (%d items)",Time::now()-t0,(int)itemsMap.size());
+
+        if (!nosavedb && !rf.check("no-journal"))
+            openJournal(loaddb);
 
         dump();
         initialized=true;
@@ -564,62 +1175,65 @@ public:
         pBroadcastPort=&broadcastPort;
     }
 
+    /************************************************************************/
+    void setChangesPort(BufferedPort<Bottle> &changesPort)
+    {
+        pChangesPort=&changesPort;
+    }
+
     /************************************************************************/
     void load()
     {
         string dbFileName=rf->findFile("db");
-        if (dbFileName.empty())
-        {
-            yWarning("requested database to be loaded not found!");
-            return;
-        }
-
-        yInfo("loading database from %s ...",dbFileName.c_str());
-
-        lock_guard<mutex> lck(mtx);
+        lock_guard<shared_timed_mutex> lck(mtx);
         clear();
         idCnt=0;
 
-        Property finProperty;
-        finProperty.fromConfigFile(dbFileName);
-
-        Bottle finBottle; finBottle.read(finProperty);
-        for (int i=0; i<finBottle.size(); i++)
+        if (dbFileName.empty())
+            yWarning("requested database to be loaded not found!");
+        else
         {
-            ostringstream tag;
-            tag<<"item_"<<i;
-            Bottle &b1=finBottle.findGroup(tag.str());
-
-            if (b1.isNull())
-                continue;
+            yInfo("loading database from %s ...",dbFileName.c_str());
 
-            if (b1.size()<3)
+            ifstream fin(dbFileName.c_str());
+            string line;
+            while (getline(fin,line))
             {
-                yWarning("error while loading %s!",tag.str().c_str());
-                continue;
-            }
+                Bottle b1(line);
+                string tag=b1.get(0).asString();
+                if (tag.compare(0,5,"item_")!=0)
+                    continue;
 
-            Bottle *b2=b1.get(1).asList();
-            Bottle *b3=b1.get(2).asList();
-            if ((b2==NULL) || (b3==NULL))
-            {
-                yWarning("error while loading %s!",tag.str().c_str());
-                continue;
-            }
+                if (b1.size()<3)
+                {
+                    yWarning("error while loading %s!",tag.c_str());
+                    continue;
+                }
 
-            if (b2->size()<2)
-            {
-                yWarning("error while loading %s!",tag.str().c_str());
-                continue;
-            }
+                Bottle *b2=b1.get(1).asList();
+                Bottle *b3=b1.get(2).asList();
+                if ((b2==NULL) || (b3==NULL))
+                {
+                    yWarning("error while loading %s!",tag.c_str());
+                    continue;
+                }
 
-            int id=b2->get(1).asInt32();
-            itemsMap[id].prop=new Property(b3->toString().c_str());
+                if (b2->size()<2)
+                {
+                    yWarning("error while loading %s!",tag.c_str());
+                    continue;
+                }
 
-            if (idCnt<=id)
-                idCnt=id+1;
+                applyAdd(b2->get(1).asInt32(),*b3);
+            }
         }
 
+        // bring the snapshot up to date with the changes
+        // occurred after it was taken
+        int cnt=replay(journalFileName);
+        if (cnt>0)
+            yInfo("replayed %d changes from %s",cnt,journalFileName.c_str());
+
         yInfo("database loaded");
     }
 
@@ -629,23 +1243,63 @@ public:
         if (nosavedb)
             return;
 
-        lock_guard<mutex> lck(mtx);
+        shared_lock<shared_timed_mutex> lck(mtx);
         string dbFileName=rf->getHomeContextPath();
         dbFileName+="/";
         dbFileName+=rf->find("db").asString();
         yInfo("saving database in %s ...",dbFileName.c_str());
 
-        FILE *fout=fopen(dbFileName.c_str(),"w");
+        // write the snapshot aside and then replace the old one,
+        // so that snapshot+journal is consistent at any time
+        string tmpFileName=dbFileName+".tmp";
+        FILE *fout=fopen(tmpFileName.c_str(),"w");
+        if (fout==NULL)
+        {
+            yError("unable to write %s!",tmpFileName.c_str());
+            return;
+        }
+
         write(fout);
         fclose(fout);
 
+        // the replacement is atomic: either the old or the new
+        // snapshot is found on disk, never none of them
+        lock_guard<mutex> lckJournal(mtxJournal);
+    #ifdef _WIN32
+        bool replaced=(MoveFileExA(tmpFileName.c_str(),dbFileName.c_str(),
+                                   MOVEFILE_REPLACE_EXISTING|MOVEFILE_WRITE_THROUGH)!=0);
+    #else
+        bool replaced=(::rename(tmpFileName.c_str(),dbFileName.c_str())==0);
+    #endif
+        if (!replaced)
+        {
+            yError("unable to replace %s!",dbFileName.c_str());
+            ::remove(tmpFileName.c_str());
+            return;
+        }
+
+        // the journal is now part of the snapshot
+        if (journalFile!=NULL)
+        {
+            fclose(journalFile);
+            journalFile=fopen(journalFileName.c_str(),"w");
+            journalEntries=0;
+        }
+
         yInfo("database stored");
     }
 
+    /************************************************************************/
+    bool needCompaction()
+    {
+        lock_guard<mutex> lck(mtxJournal);
+        return ((journalFile!=NULL) && (journalEntries>=journalCompaction));
+    }
+
     /************************************************************************/
     void dump()
     {
-        lock_guard<mutex> lck(mtx);
+        shared_lock<shared_timed_mutex> lck(mtx);
         yInfo("dumping database content ...");
 
         if (itemsMap.size()==0)
@@ -661,7 +1315,8 @@ public:
         {
             if (pBroadcastPort->getOutputCount()>0)
             {
-                lock_guard<mutex> lck(mtx);
+                lock_guard<mutex> lckBroadcast(mtxBroadcast);
+                shared_lock<shared_timed_mutex> lck(mtx);
                 Bottle &bottle=pBroadcastPort->prepare();
                 bottle.clear();
 
@@ -678,13 +1333,15 @@ public:
                     idList.addInt32(it->first);
                 }
 
+                if (stats)
+                    bcBytes+=sizeOf(bottle);
                 pBroadcastPort->writeStrict();
             }
         }
     }
 
     /************************************************************************/
-    bool add(Bottle *content)
+    bool add(Bottle *content, int &id)
     {
         if (content==NULL)
             return false;
@@ -695,10 +1352,23 @@ public:
             return false;
         }
 
-        lock_guard<mutex> lck(mtx);
-        itemsMap[idCnt].prop=new Property(content->toString().c_str());
-        itemsMap[idCnt].lastUpdate=Time::now();
+        {
+            lock_guard<shared_timed_mutex> lck(mtx);
+            id=idCnt;
+            applyAdd(id,*content);
+            itemsMap[id].lastUpdate=Time::now();
+
+            Bottle entry;
+            entry.addString(CHG_ADD);
+            entry.addInt32(id);
+            entry.addList()=*content;
+
+            vector<bool> after;
+            matchSubscribers(id,after);
+            publish(entry,vector<bool>(),after);
+        }
 
+        flushFeed();
         return true;
     }
 
@@ -714,8 +1384,16 @@ public:
             {
                 if (content->get(0).asVocab32()==OPT_ALL)
                 {
-                    lock_guard<mutex> lck(mtx);
-                    clear();
+                    {
+                        lock_guard<shared_timed_mutex> lck(mtx);
+                        clear();
+
+                        Bottle entry;
+                        entry.addString(CHG_CLEAR);
+                        publish(entry,vector<bool>(subscribers.size(),true),vector<bool>());
+                    }
+
+                    flushFeed();
                     yInfo("database cleared");
                     return true;
                 }
@@ -730,25 +1408,35 @@ public:
 
         int id=content->find(PROP_ID).asInt32();
 
-        lock_guard<mutex> lck(mtx);
-        map<int,Item>::iterator it=itemsMap.find(id);
-        if (it!=itemsMap.end())
         {
+            lock_guard<shared_timed_mutex> lck(mtx);
+            map<int,Item>::iterator it=itemsMap.find(id);
+            if (it==itemsMap.end())
+                return false;
+
+            Bottle entry;
+            entry.addString(CHG_DEL);
+            entry.addInt32(id);
+
+            vector<bool> before,after;
+            matchSubscribers(id,before);
+
             Bottle *propSet=content->find(PROP_SET).asList();
             if (propSet!=NULL)
             {
-                for (int i=0; i<propSet->size(); i++)
-                    it->second.prop->unput(propSet->get(i).asString());
-
+                entry.addList()=*propSet;
+                applyDel(it,propSet);
                 it->second.lastUpdate=Time::now();
+                matchSubscribers(id,after);
             }
             else
-                eraseItem(it);
+                applyDel(it,NULL);
 
-            return true;
+            publish(entry,before,after);
         }
 
-        return false;
+        flushFeed();
+        return true;
     }
 
     /************************************************************************/
@@ -765,7 +1453,7 @@ public:
 
         int id=content->find(PROP_ID).asInt32();
 
-        lock_guard<mutex> lck(mtx);
+        shared_lock<shared_timed_mutex> lck(mtx);
         map<int,Item>::iterator it=itemsMap.find(id);
         if (it!=itemsMap.end())
         {
@@ -808,40 +1496,33 @@ public:
 
         int id=content->find(PROP_ID).asInt32();
 
-        lock_guard<mutex> lck(mtx);
-        map<int,Item>::iterator it=itemsMap.find(id);
-        if (it!=itemsMap.end())
         {
+            lock_guard<shared_timed_mutex> lck(mtx);
+            map<int,Item>::iterator it=itemsMap.find(id);
+            if (it==itemsMap.end())
+                return false;
+
             string owner=it->second.owner;
-            if ((owner==OPT_OWNERSHIP_ALL) || (owner==agent))
-            {
-                Property *pProp=it->second.prop;
-                for (int i=0; i<content->size(); i++)
-                {
-                    if (Bottle *option=content->get(i).asList())
-                    {
-                        if (option->size()<2)
-                            continue;
+            if ((owner!=OPT_OWNERSHIP_ALL) && (owner!=agent))
+                return false;
 
-                        string prop=option->get(0).asString();
-                        Value  val=option->get(1);
+            vector<bool> before,after;
+            matchSubscribers(id,before);
 
-                        if (prop==PROP_ID)
-                            continue;
+            applySet(id,it->second.prop,*content);
+            it->second.lastUpdate=Time::now();
 
-                        pProp->unput(prop);
-                        pProp->put(prop,val);
-                    }
-                    else
-                        continue;
-                }
+            Bottle entry;
+            entry.addString(CHG_SET);
+            entry.addInt32(id);
+            entry.addList()=*content;
 
-                it->second.lastUpdate=Time::now();
-                return true;
-            }
+            matchSubscribers(id,after);
+            publish(entry,before,after);
         }
 
-        return false;
+        flushFeed();
+        return true;
     }
 
     /************************************************************************/
@@ -858,7 +1539,7 @@ public:
 
         int id=content->find(PROP_ID).asInt32();
 
-        lock_guard<mutex> lck(mtx);
+        lock_guard<shared_timed_mutex> lck(mtx);
         map<int,Item>::iterator it=itemsMap.find(id);
         if (it!=itemsMap.end())
         {
@@ -887,7 +1568,7 @@ public:
 
         int id=content->find(PROP_ID).asInt32();
 
-        lock_guard<mutex> lck(mtx);
+        lock_guard<shared_timed_mutex> lck(mtx);
         map<int,Item>::iterator it=itemsMap.find(id);
         if (it!=itemsMap.end())
         {
@@ -916,7 +1597,7 @@ public:
 
         int id=content->find(PROP_ID).asInt32();
 
-        lock_guard<mutex> lck(mtx);
+        shared_lock<shared_timed_mutex> lck(mtx);
         map<int,Item>::iterator it=itemsMap.find(id);
         if (it!=itemsMap.end())
         {
@@ -943,7 +1624,7 @@ public:
 
         int id=content->find(PROP_ID).asInt32();
 
-        lock_guard<mutex> lck(mtx);
+        shared_lock<shared_timed_mutex> lck(mtx);
         map<int,Item>::iterator it=itemsMap.find(id);
         if (it!=itemsMap.end())
         {
@@ -967,7 +1648,7 @@ public:
         if (content==NULL)
             return false;
 
-        lock_guard<mutex> lck(mtx);
+        shared_lock<shared_timed_mutex> lck(mtx);
         if (content->size()==1)
         {
             if (content->get(0).isVocab32() || content->get(0).isString())
@@ -985,94 +1666,147 @@ public:
         }
 
         deque<Condition> condList;
-        deque<string>    opList;
-
-        // we cannot accept a conditions string ending with
-        // a boolean operator
-        if (!(content->size()&0x01))
-        {
-            yWarning("uncorrect conditions received!");
+        vector<vector<size_t>> groups;
+        if (!parseConditions(content,condList,groups))
             return false;
-        }
 
-        // parse the received conditions and build the lists
-        for (int i=0; i<content->size(); i+=2)
+        std::set<int> ids;
+        vector<int> candidates;
+        for (size_t i=0; i<groups.size(); i++)
         {
-            if (Bottle *b=content->get(i).asList())
+            // scan only the items selected by the most
+            // selective condition of the group
+            vector<size_t> &group=groups[i];
+            size_t best=0;
+            size_t bestCnt=selectCandidates(condList[group[0]],NULL);
+            for (size_t j=1; (j<group.size()) && (bestCnt>0); j++)
             {
-                Condition condition;
-                string operation;
-
-                if (b->size()==1)
+                size_t cnt=selectCandidates(condList[group[j]],NULL);
+                if (cnt<bestCnt)
                 {
-                    condition.prop=b->get(0).asString();
-                    condition.compare=&relationalOperators::alwaysTrue;
+                    best=j;
+                    bestCnt=cnt;
                 }
-                else if (b->size()>2)
-                {
-                    condition.prop=b->get(0).asString();
-                    operation=b->get(1).asString();
-                    condition.val=b->get(2);
+            }
 
-                    if (operation==">")
-                        condition.compare=&relationalOperators::greater;
-                    else if (operation==">=")
-                        condition.compare=&relationalOperators::greaterEqual;
-                    else if (operation=="<")
-                        condition.compare=&relationalOperators::lower;
-                    else if (operation=="<=")
-                        condition.compare=&relationalOperators::lowerEqual;
-                    else if (operation=="==")
-                        condition.compare=&relationalOperators::equal;
-                    else if (operation=="!=")
-                        condition.compare=&relationalOperators::notEqual;
-                    else
-                    {
-                        yWarning("unknown relational operator '%s'!",operation.c_str());
-                        return false;
-                    }
-                }
-                else
-                {
-                    yWarning("wrong condition given!");
-                    return false;
-                }
+            if (bestCnt==0)
+                continue;
 
-                condList.push_back(condition);
+            candidates.clear();
+            candidates.reserve(bestCnt);
+            selectCandidates(condList[group[best]],&candidates);
 
-                if ((i+1)<content->size())
-                {
-                    operation=content->get(i+1).asString();
-                    if ((operation!="||") && (operation!="&&"))
-                    {
-                        yWarning("unknown boolean operator '%s'!",operation.c_str());
-                        return false;
-                    }
-                    else
-                        opList.push_back(operation);
-                }
-            }
-            else
+            for (size_t j=0; j<candidates.size(); j++)
             {
-                yWarning("wrong condition given!");
-                return false;
+                map<int,Item>::iterator it=itemsMap.find(candidates[j]);
+                if (it!=itemsMap.end())
+                    if (checkConditions(it->second.prop,condList,group))
+                        ids.insert(it->first);
             }
         }
 
         response.clear();
+        for (std::set<int>::iterator it=ids.begin(); it!=ids.end(); it++)
+            response.addInt32(*it);
 
-        // apply the conditions to each item
-        for (map<int,Item>::iterator it=itemsMap.begin(); it!=itemsMap.end(); it++)
+        return true;
+    }
+
+    /************************************************************************/
+    bool subscribe(Bottle *content, string &portName)
+    {
+        Subscriber sub;
+        if (content!=NULL)
+        {
+            bool all=false;
+            if (content->size()==1)
+                if (content->get(0).isVocab32() || content->get(0).isString())
+                    all=(content->get(0).asVocab32()==OPT_ALL);
+
+            if (!all && !parseConditions(content,sub.condList,sub.groups))
+                return false;
+        }
+
+        ostringstream name;
+        {
+            lock_guard<shared_timed_mutex> lck(mtx);
+            name<<feedPrefix<<"/changes/"<<subscribersCnt++<<":o";
+        }
+
+        // register the port outside the lock, it takes a while
+        sub.port=new BufferedPort<Bottle>;
+        if (!sub.port->open(name.str()))
+        {
+            delete sub.port;
+            return false;
+        }
+
+        lock_guard<shared_timed_mutex> lck(mtx);
+        subscribers.push_back(sub);
+        portName=name.str();
+
+        return true;
+    }
+
+    /************************************************************************/
+    bool unsubscribe(const string &portName)
+    {
+        BufferedPort<Bottle> *port=NULL;
+        {
+            lock_guard<shared_timed_mutex> lck(mtx);
+            for (deque<Subscriber>::iterator it=subscribers.begin(); it!=subscribers.end(); it++)
+            {
+                if (it->port->getName()==portName)
+                {
+                    port=it->port;
+                    subscribers.erase(it);
+                    break;
+                }
+            }
+        }
+
+        if (port==NULL)
+            return false;
+
+        // wait for the changes being sent and forget those still queued
         {
-            // do recursion and keep only the item that
-            // satisfies the whole list of conditions
-            if (recursiveCheck(it->second.prop,condList,opList))
-                response.addInt32(it->first);
+            lock_guard<mutex> lckFeed(mtxFeed);
+            dropPending(port);
         }
 
+        port->interrupt();
+        port->close();
+        delete port;
         return true;
     }
 
+    /************************************************************************/
+    void closeFeed()
+    {
+        lock_guard<shared_timed_mutex> lck(mtx);
+        lock_guard<mutex> lckFeed(mtxFeed);
+        {
+            lock_guard<mutex> lckPending(mtxPending);
+            pending.clear();
+        }
+
+        for (size_t i=0; i<subscribers.size(); i++)
+        {
+            subscribers[i].port->interrupt();
+            subscribers[i].port->close();
+            delete subscribers[i].port;
+        }
+
+        subscribers.clear();
+    }
+
+    /************************************************************************/
+    void getBandwidthStats(size_t &bcBytes, size_t &feedBytes) const
+    {
+        bcBytes=this->bcBytes;
+        feedBytes=this->feedBytes;
+    }
+
     /************************************************************************/
     void periodicHandler(const double dt)   // manage the items life-timers
     {
@@ -1086,18 +1820,29 @@ public:
                 double lifeTimer=pProp->find(PROP_LIFETIMER).asFloat64()-dt;
                 if (lifeTimer<=0.0)
                 {
+                    Bottle entry;
+                    entry.addString(CHG_DEL);
+                    entry.addInt32(it->first);
+
+                    vector<bool> before;
+                    matchSubscribers(it->first,before);
                     eraseItem(it);
+                    publish(entry,before,vector<bool>());
+
                     erased=true;
                     break;
                 }
                 else
                 {
+                    unindexValue(it->first,PROP_LIFETIMER,pProp->find(PROP_LIFETIMER));
                     pProp->unput(PROP_LIFETIMER);
                     pProp->put(PROP_LIFETIMER,lifeTimer);
+                    indexValue(it->first,PROP_LIFETIMER,pProp->find(PROP_LIFETIMER));
                 }
             }
         }
         mtx.unlock();
+        flushFeed();
 
         if (asyncBroadcast && erased)
             broadcast(BCTAG_ASYNC);
@@ -1132,14 +1877,14 @@ public:
                     break;
                 }
 
+                int id;
                 Bottle *content=command.get(1).asList();
-                if (add(content))
+                if (add(content,id))
                 {
                     reply.addVocab32(REP_ACK);
                     Bottle &b=reply.addList();
                     b.addString(PROP_ID);
-                    b.addInt32(idCnt);
-                    idCnt++;
+                    b.addInt32(id);
 
                     if (asyncBroadcast)
                         broadcast(BCTAG_ASYNC);
@@ -1389,6 +2134,41 @@ public:
                 break;
             }
 
+            //-----------------
+            case CMD_FEED:
+            {
+                if (command.size()<2)
+                {
+                    reply.addVocab32(REP_NACK);
+                    break;
+                }
+
+                int opt=command.get(1).asVocab32();
+                if (opt==Vocab32::encode("add"))
+                {
+                    string portName;
+                    Bottle *content=(command.size()>=3)?command.get(2).asList():NULL;
+                    if (subscribe(content,portName))
+                    {
+                        reply.addVocab32(REP_ACK);
+                        reply.addString(portName);
+                    }
+                    else
+                        reply.addVocab32(REP_NACK);
+                }
+                else if ((opt==Vocab32::encode("del")) && (command.size()>=3))
+                {
+                    if (unsubscribe(command.get(2).asString()))
+                        reply.addVocab32(REP_ACK);
+                    else
+                        reply.addVocab32(REP_NACK);
+                }
+                else
+                    reply.addVocab32(REP_NACK);
+
+                break;
+            }
+
             //-----------------
             case CMD_QUIT:
             case CMD_BYE:
@@ -1420,6 +2200,10 @@ public:
         mtx.lock();
         clear();
 
+        Bottle entry;
+        entry.addString(CHG_CLEAR);
+        publish(entry,vector<bool>(subscribers.size(),true),vector<bool>());
+
         if (type!=BCTAG_EMPTY)
         {
             idCnt=0;
@@ -1434,10 +2218,17 @@ public:
                             if (idList->get(0).asString()==PROP_ID)
                             {
                                 int id=idList->get(1).asInt32();
-                                itemsMap[id].prop=new Property(item->tail().toString().c_str());
+                                Bottle props=item->tail();
+                                applyAdd(id,props);
+
+                                Bottle entry;
+                                entry.addString(CHG_ADD);
+                                entry.addInt32(id);
+                                entry.addList()=props;
 
-                                if (idCnt<=id)
-                                    idCnt=id+1;
+                                vector<bool> after;
+                                matchSubscribers(id,after);
+                                publish(entry,vector<bool>(),after);
                             }
                         }
                     }
@@ -1446,6 +2237,7 @@ public:
         }
 
         mtx.unlock();
+        flushFeed();
 
         if (asyncBroadcast)
             broadcast(BCTAG_ASYNC);
@@ -1462,6 +2254,7 @@ protected:
     DataBase *pDataBase;
     unsigned int nCalls;
     double cumTime;
+    mutex mtx;
 
     /************************************************************************/
     bool read(ConnectionReader &connection)
@@ -1473,8 +2266,12 @@ protected:
         Bottle reply;
         double t0=Time::now();
         pDataBase->respond(connection,command,reply);
-        cumTime+=Time::now()-t0;
+        double dt=Time::now()-t0;
+
+        mtx.lock();
+        cumTime+=dt;
         nCalls++;
+        mtx.unlock();
 
         if (ConnectionWriter *writer=connection.getWriter())
             reply.write(*writer);
@@ -1498,8 +2295,9 @@ public:
     }
 
     /************************************************************************/
-    void getStats(unsigned int &nCalls, double &cumTime) const
+    void getStats(unsigned int &nCalls, double &cumTime)
     {
+        lock_guard<mutex> lck(mtx);
         nCalls=this->nCalls;
         cumTime=this->cumTime;
     }
@@ -1540,11 +2338,14 @@ private:
     DataBaseModifyPort   modifyPort;
     RpcServer            rpcPort;
     BufferedPort<Bottle> bcPort;
+    BufferedPort<Bottle> changesPort;
 
     int cnt;
     bool stats;
     unsigned int nCallsOld;
     double cumTimeOld;
+    size_t bcBytesOld;
+    size_t feedBytesOld;
 
 public:
     /************************************************************************/
@@ -1555,17 +2356,21 @@ public:
 
         string name=rf.check("name",Value("objectsPropertiesCollector")).asString();
         dataBase.setBroadcastPort(bcPort);
+        dataBase.setChangesPort(changesPort);
         rpcProcessor.setDataBase(dataBase);
         rpcPort.setReader(rpcProcessor);
         modifyPort.setDataBase(dataBase);
         modifyPort.useCallback();
         rpcPort.open("/"+name+"/rpc");
         bcPort.open("/"+name+"/broadcast:o");
+        changesPort.open("/"+name+"/changes:o");
         modifyPort.open("/"+name+"/modify:i");
 
         cnt=0;
         nCallsOld=0;
         cumTimeOld=0.0;
+        bcBytesOld=0;
+        feedBytesOld=0;
 
         return true;
     }
@@ -1578,11 +2383,14 @@ public:
 
         rpcPort.interrupt();
         bcPort.interrupt();
+        changesPort.interrupt();
         modifyPort.interrupt();
 
         rpcPort.close();
         bcPort.close();
+        changesPort.close();
         modifyPort.close();
+        dataBase.closeFeed();
 
         return true;
     }
@@ -1593,7 +2401,8 @@ public:
         dataBase.periodicHandler(getPeriod());
 
         // back-up straightaway the database each 15 minutes
-        if ((++cnt)*getPeriod()>(15.0*60.0))
+        // or as soon as the journal grows too much
+        if (((++cnt)*getPeriod()>(15.0*60.0)) || dataBase.needCompaction())
         {
             dataBase.save();
             cnt=0;
@@ -1609,8 +2418,16 @@ public:
             yInfo("*** Statistics: received %d/%g [requests/s]; %g [ms/request] spent on average",
                   calls,getPeriod(),timeSpent==0.0?0.0:(1e3*timeSpent)/(double)calls);
 
+            size_t bcBytes,feedBytes;
+            dataBase.getBandwidthStats(bcBytes,feedBytes);
+            yInfo("*** Statistics: broadcast %g [kB/s]; changes feed %g [kB/s]",
+                  (bcBytes-bcBytesOld)/(1024.0*getPeriod()),
+                  (feedBytes-feedBytesOld)/(1024.0*getPeriod()));
+
             nCallsOld=nCalls;
             cumTimeOld=cumTime;
+            bcBytesOld=bcBytes;
+            feedBytesOld=feedBytes;
         }
 
         return !dataBase.isQuitting();
@@ -1644,6 +2461,8 @@ int main(int argc, char *argv[])
         printf("\t--no-save-db        : prevent from saving the content of database at shutdown\n");
         printf("\t--sync-bc        <T>: broadcast the database content each T seconds\n");
         printf("\t--async-bc          : broadcast the database content whenever a change occurs\n");
+        printf("\t--no-journal        : do not keep the journal of changes between two snapshots\n");
+        printf("\t--journal-compact <N>: take a new snapshot after N journaled changes (default: 1000)\n");
         printf("\t--stats             : enable statistics printouts\n");
         printf("\n");
         return 0;
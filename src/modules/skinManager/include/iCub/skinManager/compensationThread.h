@@ -35,6 +35,7 @@
 
 #include "iCub/skinManager/compensator.h"
 #include "iCub/skinDynLib/skinContactList.h"
+#include "iCub/skinDynLib/skinContactPacket.h"
 
 using namespace std;
 using namespace yarp::os; 
@@ -139,9 +140,22 @@ private:
 
     // SKIN EVENTS
     bool skinEventsOn;
+    bool compactTaxelList;                      // if true the compact skin events carry the ids of the active taxels
+    double keepAlive;                           // max time (in sec) without sending the same compact skin events
+    double lastCompactEventsTime;
+    skinContactList skinEventsList;             // skin events, when nobody reads them as a skinContactList
+    skinContactPacket lastCompactEvents;        // last compact skin events sent
+
+    // timing of the skin events
+    double timingReport;                        // period (in sec) of the timing report, 0 if disabled
+    double timingReportTime;
+    double skinEventsTime, skinEventsMaxTime;   // time (in sec) spent in sendSkinEvents()
+    unsigned int skinEventsCounter;
+    unsigned int compactEventsSent, compactEventsSkipped;
 
     /* ports */
     BufferedPort<skinContactList> skinEventsPort;   // skin events output port
+    BufferedPort<skinContactPacket> skinEventsCompactPort;  // compact skin events output port
     BufferedPort<Vector> monitorPort;               // monitoring output port (streaming)
     BufferedPort<Bottle> infoPort;                  // info output port
 
@@ -155,6 +169,7 @@ private:
     void sendDebugMsg(string msg);
     void sendErrorMsg(string msg);
     void sendSkinEvents();
+    void reportSkinEventsTiming();
 
 };
 
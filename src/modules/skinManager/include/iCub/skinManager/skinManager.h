@@ -125,6 +125,12 @@ These are the parameters of this section:
     missing calibration procedure for that skin part).
  - \c maxNeighborDist \c 0.015 \n
     maximum distance between two neighbor tactile sensors (in meters).
+ - \c compactTaxelList \c [true] \n
+    if false the compact skin events do not carry the ids of the active taxels.
+ - \c keepAlive \c [0.1] \n
+    compact skin events equal to the last ones sent are not sent again for this long (in seconds).
+ - \c timingReport \c [0] \n
+    period (in seconds) of the report of the time spent in sending the skin events, 0 to disable it.
  
 
 \section portsa_sec Ports Accessed
@@ -151,6 +157,9 @@ will be accessed.
     an error in the sensor reading or an excessive drift of the baseline of a taxel.\n
 - "/"+moduleName+"/skin_events:o": \n
     outputs a iCub::skinDynLib::skinContactList containing the list of contacts.
+- "/"+moduleName+"/skin_events_compact:o": \n
+    outputs the same contacts as a iCub::skinDynLib::skinContactPacket, which is cheaper to send and to receive,
+    only when they change or after "keepAlive" seconds.
 
 <b>Input ports</b>
 - For each port specified in the "inputPorts" parameter a local port is created with the name
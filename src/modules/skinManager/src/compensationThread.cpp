@@ -139,11 +139,22 @@ bool CompensationThread::threadInit()
     if(!skinEventsConf.isNull()){
         yDebug("SKIN_EVENTS section found");
         string eventPortName = "/" + moduleName + "/skin_events:o";  // output skin events
+        string compactEventPortName = "/" + moduleName + "/skin_events_compact:o";
         if(!skinEventsPort.open(eventPortName.c_str()))
             sendErrorMsg("Unable to open port "+eventPortName);
+        else if(!skinEventsCompactPort.open(compactEventPortName.c_str()))
+            sendErrorMsg("Unable to open port "+compactEventPortName);
         else
             skinEventsOn = true;
 
+        compactTaxelList = skinEventsConf.check("compactTaxelList", Value(true)).asBool();
+        keepAlive = skinEventsConf.check("keepAlive", Value(0.1)).asFloat64();
+        timingReport = skinEventsConf.check("timingReport", Value(0.0)).asFloat64();
+        lastCompactEventsTime = 0.0;
+        timingReportTime = Time::now();
+        skinEventsTime = skinEventsMaxTime = 0.0;
+        skinEventsCounter = compactEventsSent = compactEventsSkipped = 0;
+
         if(skinEventsConf.check("skinParts")){
             Bottle* skinPartList = skinEventsConf.find("skinParts").asList();
             if(skinPartList->size() != portNum){
@@ -249,7 +260,11 @@ void CompensationThread::run(){
 }
 
 void CompensationThread::sendSkinEvents(){
-    skinContactList &skinEvents = skinEventsPort.prepare();
+    double startTime = Time::now();
+
+    // build the list in place only if someone reads it
+    bool sendList = skinEventsPort.getOutputCount()>0;
+    skinContactList &skinEvents = sendList ? skinEventsPort.prepare() : skinEventsList;
     skinEvents.clear();
 
     skinContactList temp;
@@ -267,8 +282,45 @@ void CompensationThread::sendSkinEvents(){
         /*printf("SkinContacts:\n%s\n", skinEvents.toString().c_str());*/
 #endif
     
-    skinEventsPort.setEnvelope(timestamp);
-    skinEventsPort.write();     // send something anyway (if there is no contact the bottle is empty)
+    if(sendList){
+        skinEventsPort.setEnvelope(timestamp);
+        skinEventsPort.write();     // send something anyway (if there is no contact the bottle is empty)
+    }
+
+    // the compact events are sent when the contacts change, and every keepAlive
+    // seconds anyway so that the receivers can tell a still contact from a dead port
+    if(skinEventsCompactPort.getOutputCount()>0){
+        skinContactPacket &packet = skinEventsCompactPort.prepare();
+        packet.fromSkinContactList(skinEvents, compactTaxelList);
+        if(!packet.sameContacts(lastCompactEvents) || startTime-lastCompactEventsTime>=keepAlive){
+            lastCompactEvents = packet;
+            lastCompactEventsTime = startTime;
+            skinEventsCompactPort.setEnvelope(timestamp);
+            skinEventsCompactPort.write();
+            compactEventsSent++;
+        }
+        else{
+            skinEventsCompactPort.unprepare();
+            compactEventsSkipped++;
+        }
+    }
+
+    double time = Time::now()-startTime;
+    skinEventsTime += time;
+    skinEventsMaxTime = max(skinEventsMaxTime, time);
+    skinEventsCounter++;
+    if(timingReport>0.0 && startTime-timingReportTime>=timingReport)
+        reportSkinEventsTiming();
+}
+
+void CompensationThread::reportSkinEventsTiming(){
+    yInfo("skin events: %u cycles, mean time %.1f us, max time %.1f us, compact events sent %u, skipped %u",
+          skinEventsCounter, 1e6*skinEventsTime/skinEventsCounter, 1e6*skinEventsMaxTime,
+          compactEventsSent, compactEventsSkipped);
+
+    timingReportTime = Time::now();
+    skinEventsTime = skinEventsMaxTime = 0.0;
+    skinEventsCounter = compactEventsSent = compactEventsSkipped = 0;
 }
 
 void CompensationThread::checkErrors(){
@@ -69,6 +69,18 @@ http://wiki.icub.org/wiki/Force_Control
 --no_legs
 - this option disables the dynamics computation for the legs joints
 
+--kinematic_state \e name
+- publishes at each cycle the joints positions, velocities and
+  accelerations, the end-effector poses and the inertial measure
+  in the shared memory ring \e name (see iDynSharedState), so that
+  other modules running on the same machine (e.g. gravityCompensator)
+  can use them instead of reading the robot themselves. Available
+  on POSIX systems only.
+
+--skin_timing \e period
+- prints every \e period seconds the mean and maximum time spent
+  in reading the skin contacts and adding them to the model.
+
 \section portsa_sec Ports Accessed
 The port the service is listening to.
 
@@ -217,6 +229,8 @@ private:
     bool     auto_drift_comp;
     bool     default_ee_cont;       // true: when skin detects no contact, the ext contact is supposed at the end effector
                                     // false: ext contact is supposed at the last location where skin detected a contact
+    string   kinematic_state;       // name of the shared kinematic state, empty if not published
+    double   skin_timing;           // period of the skin contacts timing report, 0 if disabled
 
     dataFilter *inertialFilter{};
     BufferedPort<Vector> port_filtered_output;
@@ -551,6 +565,15 @@ public:
             yInfo("Default contact at the end effector\n");
         }
 
+        //---------------------KINEMATIC STATE------------------//
+        if (rf.check("kinematic_state"))
+        {
+            kinematic_state = rf.find("kinematic_state").asString();
+            yInfo("Publishing the kinematic state in %s\n", kinematic_state.c_str());
+        }
+
+        skin_timing = rf.check("skin_timing",Value(0.0)).asFloat64();
+
         //---------------------DEVICES--------------------------//
         if(head_enabled)
         {
@@ -738,6 +761,8 @@ public:
         inv_dyn->w0_dw0_enabled=w0_dw0_enabled;
         inv_dyn->dumpvel_enabled=dump_vel_enabled;
         inv_dyn->default_ee_cont=default_ee_cont;
+        inv_dyn->kinematic_state=kinematic_state;
+        inv_dyn->skin_timing_report=skin_timing;
 
         yInfo("ft thread istantiated...\n");
         Time::delay(5.0);
@@ -28,7 +28,9 @@
 #include <iCub/ctrl/adaptWinPolyEstimator.h>
 #include <iCub/iDyn/iDyn.h>
 #include <iCub/iDyn/iDynBody.h>
+#include <iCub/iDyn/iDynSharedState.h>
 #include <iCub/skinDynLib/skinContact.h>
+#include <iCub/skinDynLib/skinContactPacket.h>
 
 #include "observerThread.h"
 
@@ -275,6 +277,10 @@ inverseDynamics::inverseDynamics(int _rate, PolyDriver *_ddAL, PolyDriver *_ddAR
     icub_sens = new iCubWholeBody(icub_type, DYNAMIC, VERBOSE);
     first = true;
     skinContactsTimestamp = 0.0;
+    skin_timing_report = 0.0;
+    skinTimingStart = Time::now();
+    skinTimingSum = skinTimingMax = 0.0;
+    skinTimingCount = skinTimingMessages = 0;
 
     //--------------INTERFACE INITIALIZATION-------------//
     iencs_arm_left = 0;
@@ -327,6 +333,7 @@ inverseDynamics::inverseDynamics(int _rate, PolyDriver *_ddAL, PolyDriver *_ddAR
 	port_external_cartesian_wrench_RF = new BufferedPort<Vector>;
 	port_external_cartesian_wrench_LF = new BufferedPort<Vector>;
     port_skin_contacts = new BufferedPort<skinContactList>;
+    port_skin_packets = new BufferedPort<skinContactPacket>;
     port_com_all      = new BufferedPort<Vector>;
     port_com_lb       = new BufferedPort<Vector>;
     port_com_ub       = new BufferedPort<Vector>;
@@ -390,6 +397,7 @@ inverseDynamics::inverseDynamics(int _rate, PolyDriver *_ddAL, PolyDriver *_ddAR
     port_com_to ->open(string("/"+local_name+"/torso/com:o").c_str());
     port_com_all_foot->open(string("/"+local_name+"/com_foot:o").c_str());
     port_skin_contacts->open(string("/"+local_name+"/skin_contacts:i").c_str());
+    port_skin_packets->open(string("/"+local_name+"/skin_contacts_compact:i").c_str());
     port_monitor->open(string("/"+local_name+"/monitor:o").c_str());
     port_contacts->open(string("/"+local_name+"/contacts:o").c_str());
     port_dumpvel->open(string("/"+local_name+"/va:o").c_str());
@@ -488,6 +496,9 @@ bool inverseDynamics::threadInit()
     // the queue previous_status now contains status_queue_size elements, and we can calibrate
     calibrateOffset();
 
+    if (!kinematic_state.empty() && !kinStateWriter.open(kinematic_state))
+        yWarning("the kinematic state will not be published\n");
+
     thread_status = STATUS_OK;
     return true;
 }
@@ -585,6 +596,9 @@ void inverseDynamics::run()
         current_status.inertial_dw0.zero();
     }
 
+    if (kinStateWriter.isOpen())
+        publishKinematicState();
+
     Vector F_up(6, 0.0);
     icub->upperTorso->setInertialMeasure(current_status.inertial_w0,current_status.inertial_dw0,current_status.inertial_d2p0);
     icub->upperTorso->setSensorMeasurement(F_RArm,F_LArm,F_up);
@@ -1028,6 +1042,9 @@ void inverseDynamics::threadRelease()
         InertialEst = 0;
     }
 
+    yInfo( "Closing the kinematic state\n");
+    kinStateWriter.close();
+
     yInfo( "Closing RATorques port\n");
     closePort(port_RATorques);
     yInfo( "Closing LATorques port\n");
@@ -1092,6 +1109,8 @@ void inverseDynamics::threadRelease()
     closePort(port_inertial_thread);
     yInfo( "Closing skin_contacts port\n");
     closePort(port_skin_contacts);
+    yInfo( "Closing skin_contacts_compact port\n");
+    closePort(port_skin_packets);
     yInfo( "Closing monitor port\n");
     closePort(port_monitor);
     yInfo( "Closing dump port\n");
@@ -1478,8 +1497,17 @@ void inverseDynamics::setZeroJntAngVelAcc()
 
 void inverseDynamics::addSkinContacts()
 {
-    skinContactList *scl = port_skin_contacts->read(false);
-    if(scl)
+    double startTime = Time::now();
+
+    // the compact skin events are preferred when both are connected
+    skinContactPacket *scp = port_skin_packets->read(false);
+    skinContactList *scl = (scp==nullptr) ? port_skin_contacts->read(false) : nullptr;
+    if(scp)
+    {
+        skinContactsTimestamp = Time::now();
+        addSkinContactPacket(*scp);
+    }
+    else if(scl)
     {
         skinContactsTimestamp = Time::now();
         if(scl->empty() && !default_ee_cont)   // if no skin contacts => leave the old contacts but reset pressure and contact list
@@ -1489,22 +1517,23 @@ void inverseDynamics::addSkinContacts()
                 skinContact.setPressure(0.0);
                 skinContact.setActiveTaxels(0);
             }
-            return;
         }
-
-        map<BodyPart, skinContactList> contactsPerBp = scl->splitPerBodyPart();
-        // if there are more than 1 contact and less than 10 taxels are active then suppose zero moment
-        for(auto & it : contactsPerBp)
-            if(it.second.size()>1)
-                for(auto & c : it.second)
-                    if(c.getActiveTaxels()<10)
-                        c.fixMoment();
-
-        icub->upperTorso->clearContactList();
-        icub->upperTorso->leftSensor->addContacts(contactsPerBp[LEFT_ARM].toDynContactList());
-        icub->upperTorso->rightSensor->addContacts(contactsPerBp[RIGHT_ARM].toDynContactList());
-        skinContacts = contactsPerBp[LEFT_ARM];
-        skinContacts.insert(skinContacts.end(), contactsPerBp[RIGHT_ARM].begin(), contactsPerBp[RIGHT_ARM].end());
+        else
+        {
+            map<BodyPart, skinContactList> contactsPerBp = scl->splitPerBodyPart();
+            // if there are more than 1 contact and less than 10 taxels are active then suppose zero moment
+            for(auto & it : contactsPerBp)
+                if(it.second.size()>1)
+                    for(auto & c : it.second)
+                        if(c.getActiveTaxels()<10)
+                            c.fixMoment();
+
+            icub->upperTorso->clearContactList();
+            icub->upperTorso->leftSensor->addContacts(contactsPerBp[LEFT_ARM].toDynContactList());
+            icub->upperTorso->rightSensor->addContacts(contactsPerBp[RIGHT_ARM].toDynContactList());
+            skinContacts = contactsPerBp[LEFT_ARM];
+            skinContacts.insert(skinContacts.end(), contactsPerBp[RIGHT_ARM].begin(), contactsPerBp[RIGHT_ARM].end());
+        }
     }
     else if(Time::now()-skinContactsTimestamp>SKIN_EVENTS_TIMEOUT && skinContactsTimestamp!=0.0)
     {
@@ -1513,6 +1542,107 @@ void inverseDynamics::addSkinContacts()
         skinContacts.clear();
         add_legs_once = true;
     }
+
+    if (skin_timing_report>0.0)
+    {
+        double time = Time::now()-startTime;
+        skinTimingSum += time;
+        skinTimingMax = std::max(skinTimingMax, time);
+        skinTimingCount++;
+        skinTimingMessages += (scp || scl) ? 1 : 0;
+        if (startTime-skinTimingStart>=skin_timing_report)
+        {
+            yInfo("skin contacts: %u cycles, %u messages, mean time %.1f us, max time %.1f us\n",
+                  skinTimingCount, skinTimingMessages, 1e6*skinTimingSum/skinTimingCount, 1e6*skinTimingMax);
+            skinTimingStart = startTime;
+            skinTimingSum = skinTimingMax = 0.0;
+            skinTimingCount = skinTimingMessages = 0;
+        }
+    }
+}
+
+void inverseDynamics::addSkinContactPacket(const skinContactPacket &scp)
+{
+    // same as for the skinContactList, but only the contacts on the arms
+    // are turned into objects, straight from the records of the packet
+    if(scp.size()==0 && !default_ee_cont)
+    {
+        for(auto & skinContact : skinContacts)
+        {
+            skinContact.setPressure(0.0);
+            skinContact.setActiveTaxels(0);
+        }
+        return;
+    }
+
+    size_t numLeft=0, numRight=0;
+    for(size_t i=0; i<scp.size(); i++)
+    {
+        if(scp[i].bodyPart==LEFT_ARM)       numLeft++;
+        else if(scp[i].bodyPart==RIGHT_ARM) numRight++;
+    }
+
+    dynContactList leftContacts, rightContacts;
+    skinContactList rightSkinContacts;
+    skinContacts.clear();
+    for(size_t i=0; i<scp.size(); i++)
+    {
+        const skinContactRecord &r = scp[i];
+        if(r.bodyPart!=LEFT_ARM && r.bodyPart!=RIGHT_ARM)
+            continue;
+
+        // if there are more than 1 contact and less than 10 taxels are active then suppose zero moment
+        skinContact c = scp.toSkinContact(i);
+        if(((r.bodyPart==LEFT_ARM)?numLeft:numRight)>1 && r.activeTaxels<10)
+            c.fixMoment();
+
+        if(r.bodyPart==LEFT_ARM)
+        {
+            leftContacts.push_back(c);
+            skinContacts.push_back(c);
+        }
+        else
+        {
+            rightContacts.push_back(c);
+            rightSkinContacts.push_back(c);
+        }
+    }
+    skinContacts.insert(skinContacts.end(), rightSkinContacts.begin(), rightSkinContacts.end());
+
+    icub->upperTorso->clearContactList();
+    icub->upperTorso->leftSensor->addContacts(leftContacts);
+    icub->upperTorso->rightSensor->addContacts(rightContacts);
+}
+
+void inverseDynamics::publishKinematicState()
+{
+    // the limbs already hold the angles set by readAndUpdate()
+    iCubKinematicState &state=kinStateWriter.prepare();
+    state.timestamp=current_status.timestamp;
+    memcpy(state.q_up,current_status.all_q_up.data(),sizeof(state.q_up));
+    memcpy(state.dq_up,current_status.all_dq_up.data(),sizeof(state.dq_up));
+    memcpy(state.d2q_up,current_status.all_d2q_up.data(),sizeof(state.d2q_up));
+    memcpy(state.q_low,current_status.all_q_low.data(),sizeof(state.q_low));
+    memcpy(state.dq_low,current_status.all_dq_low.data(),sizeof(state.dq_low));
+    memcpy(state.d2q_low,current_status.all_d2q_low.data(),sizeof(state.d2q_low));
+    memcpy(state.w0,current_status.inertial_w0.data(),sizeof(state.w0));
+    memcpy(state.dw0,current_status.inertial_dw0.data(),sizeof(state.dw0));
+    memcpy(state.d2p0,current_status.inertial_d2p0.data(),sizeof(state.d2p0));
+
+    iDynLimb *limbs[ICUB_KINSTATE_LIMBS];
+    limbs[KINSTATE_HEAD]=icub->upperTorso->up;
+    limbs[KINSTATE_LEFT_ARM]=icub->upperTorso->left;
+    limbs[KINSTATE_RIGHT_ARM]=icub->upperTorso->right;
+    limbs[KINSTATE_TORSO]=icub->lowerTorso->up;
+    limbs[KINSTATE_LEFT_LEG]=icub->lowerTorso->left;
+    limbs[KINSTATE_RIGHT_LEG]=icub->lowerTorso->right;
+    for (int i=0; i<ICUB_KINSTATE_LIMBS; i++)
+    {
+        Matrix H=limbs[i]->getH();
+        memcpy(state.H[i],H.data(),sizeof(state.H[i]));
+    }
+
+    kinStateWriter.write();
 }
 
 void inverseDynamics::sendMonitorData()
@@ -26,7 +26,9 @@
 #include <iCub/ctrl/adaptWinPolyEstimator.h>
 #include <iCub/iDyn/iDyn.h>
 #include <iCub/iDyn/iDynBody.h>
+#include <iCub/iDyn/iDynSharedState.h>
 #include <iCub/skinDynLib/skinContactList.h>
+#include <iCub/skinDynLib/skinContactPacket.h>
 
 #include <iostream>
 #include <iomanip>
@@ -137,6 +139,8 @@ public:
     bool       auto_drift_comp;
     bool       default_ee_cont;
     bool       add_legs_once;
+    string     kinematic_state;
+    double     skin_timing_report;
 
 private:
     string      robot_name;
@@ -180,9 +184,14 @@ private:
     const  long double zero_sens_tolerance;
     double skinContactsTimestamp;
 
+    // time spent in reading the skin contacts
+    double skinTimingStart, skinTimingSum, skinTimingMax;
+    unsigned int skinTimingCount, skinTimingMessages;
+
     //input ports
     BufferedPort<Vector> *port_inertial_thread;
     BufferedPort<iCub::skinDynLib::skinContactList> *port_skin_contacts;
+    BufferedPort<iCub::skinDynLib::skinContactPacket> *port_skin_packets;
 
     //output ports
     BufferedPort<Bottle> *port_RATorques;
@@ -256,6 +265,8 @@ private:
     list<iCubStatus> previous_status;
     list<iCubStatus> not_moving_status;
 
+    iCubKinematicStateWriter kinStateWriter;
+
     Vector encoders_arm_left;
     Vector encoders_arm_right;
     Vector encoders_head;
@@ -306,6 +317,8 @@ private:
     void setLowerMeasure(bool _init=false);
 
     void addSkinContacts();
+    void addSkinContactPacket(const iCub::skinDynLib::skinContactPacket &scp);
+    void publishKinematicState();
 
 public:
     inverseDynamics(int _rate, PolyDriver *_ddAL, PolyDriver *_ddAR,
@@ -0,0 +1,138 @@
+/*
+ * Copyright (C) 2022 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+// Downloads one firmware to the boards of several CAN drivers at the same time
+// by means of cDownloadScheduler, and reports the time spent for each board.
+//
+// canLoader-parallel --from buses.ini --firmware myFirmware.hex [--boardIds "(1 2 3)"] [--verbose]
+//
+// buses.ini lists the drivers in "buses" and has one group for each of them with the
+// parameters given to cDownloader::initdriver(). All the boards found on every driver
+// are programmed (or only the ones in --boardIds) and they must be of the type of the
+// firmware. fakeBuses.ini runs on fakecan devices whose boards emulate the bootloader.
+
+#include "downloader.h"
+#include "downloadScheduler.h"
+
+#include <yarp/os/Property.h>
+#include <yarp/os/Bottle.h>
+#include <yarp/os/Log.h>
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace yarp::os;
+
+int main(int argc, char *argv[])
+{
+    Property options;
+    options.fromCommand(argc, argv);
+
+    if (!options.check("from") || !options.check("firmware"))
+    {
+        yInfo("canLoader-parallel --from buses.ini --firmware myFirmware.hex [--boardIds \"(1 2 3)\"] [--verbose]\n");
+        return 1;
+    }
+
+    bool verbose = options.check("verbose");
+    Bottle *ids = options.find("boardIds").asList();
+
+    Property config;
+    if (!config.fromConfigFile(options.find("from").asString()))
+    {
+        yError("cannot read %s\n", options.find("from").asString().c_str());
+        return 1;
+    }
+
+    Bottle *buses = config.find("buses").asList();
+    if (buses == NULL || buses->size() == 0)
+    {
+        yError("no buses in %s\n", options.find("from").asString().c_str());
+        return 1;
+    }
+
+    cDownloadScheduler scheduler(verbose);
+    if (scheduler.load(options.find("firmware").asString()) != 0)
+    {
+        yError("invalid firmware file %s\n", options.find("firmware").asString().c_str());
+        return 1;
+    }
+    yInfo("%s: %zu records, %zu bytes\n", options.find("firmware").asString().c_str(),
+          scheduler.image().size(), scheduler.image().payload());
+
+    std::vector<cDownloader*> downloaders;
+    std::vector<std::string> names;
+    for (size_t b=0; b<buses->size(); b++)
+    {
+        std::string name = buses->get(b).asString();
+
+        Property params;
+        params.fromString(config.findGroup(name).tail().toString());
+
+        cDownloader *downloader = new cDownloader(verbose);
+        if (downloader->initdriver(params, verbose) != 0 || downloader->initschede() != 0)
+        {
+            yError("%s: no driver or no boards found\n", name.c_str());
+            downloader->stopdriver();
+            delete downloader;
+            continue;
+        }
+
+        int selected = 0;
+        for (int i=0; i<downloader->board_list_size; i++)
+        {
+            bool wanted = (ids == NULL);
+            for (size_t k=0; ids && k<ids->size(); k++)
+            {
+                wanted |= (ids->get(k).asInt32() == downloader->board_list[i].pid);
+            }
+            downloader->board_list[i].selected = wanted;
+            selected += wanted ? 1 : 0;
+        }
+        yInfo("%s: %d boards found, %d selected\n", name.c_str(), downloader->board_list_size, selected);
+
+        scheduler.add(downloader);
+        downloaders.push_back(downloader);
+        names.push_back(name);
+    }
+
+    if (downloaders.empty())
+    {
+        return 1;
+    }
+
+    int errors = scheduler.run();
+
+    // the time it would have taken one bus after the other
+    std::vector<double> jobTime(downloaders.size(), 0.0);
+    const std::vector<cDownloadScheduler::sResult> &results = scheduler.results();
+    for (size_t r=0; r<results.size(); r++)
+    {
+        const cDownloadScheduler::sResult &res = results[r];
+        printf("%-10s CAN%d:%-2d %-12s %s %.2f s\n", names[res.job].c_str(), res.bus, res.pid,
+               eoboards_type2string2((eObrd_type_t)res.type, eobool_true), res.ok ? "OK " : "ERR", res.time);
+        jobTime[res.job] = res.time;
+    }
+
+    double sequential = 0;
+    for (size_t j=0; j<jobTime.size(); j++)
+    {
+        sequential += jobTime[j];
+    }
+    printf("%zu boards, %d errors, download time %.2f s (%.2f s one bus after the other)\n",
+           results.size(), (errors > 0) ? errors : 0, scheduler.total_time(), sequential);
+
+    for (size_t d=0; d<downloaders.size(); d++)
+    {
+        downloaders[d]->stopdriver();
+        delete downloaders[d];
+    }
+
+    return (errors == 0) ? 0 : 1;
+}
@@ -0,0 +1,146 @@
+/*
+ * Copyright (C) 2022 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include "downloadScheduler.h"
+
+#include <yarp/os/Time.h>
+#include <yarp/os/Log.h>
+
+#include <thread>
+
+using namespace yarp::os;
+
+//*****************************************************************/
+
+cDownloadScheduler::cDownloadScheduler(bool verbose)
+{
+    _verbose = verbose;
+    m_total_time = 0;
+}
+
+int cDownloadScheduler::load(const std::string &file)
+{
+    return m_image.load(file, _verbose);
+}
+
+int cDownloadScheduler::add(cDownloader *downloader)
+{
+    m_jobs.push_back(downloader);
+    return m_jobs.size()-1;
+}
+
+void cDownloadScheduler::clear()
+{
+    m_jobs.clear();
+    m_results.clear();
+    m_total_time = 0;
+}
+
+//*****************************************************************/
+
+int cDownloadScheduler::run()
+{
+    m_results.clear();
+    m_total_time = 0;
+
+    if (m_jobs.empty() || m_image.empty())
+    {
+        if(_verbose) yError ("Nothing to download\n");
+        return -1;
+    }
+
+    std::vector<std::vector<sResult> > results(m_jobs.size());
+    std::vector<std::thread> threads;
+
+    double start = Time::now();
+
+    // the first job runs in the calling thread
+    for (size_t j=1; j<m_jobs.size(); j++)
+    {
+        threads.push_back(std::thread(&cDownloadScheduler::run_job, this, (int)j, std::ref(results[j])));
+    }
+    run_job(0, results[0]);
+    for (size_t t=0; t<threads.size(); t++)
+    {
+        threads[t].join();
+    }
+
+    m_total_time = Time::now() - start;
+
+    int errors = 0;
+    for (size_t j=0; j<results.size(); j++)
+    {
+        for (size_t b=0; b<results[j].size(); b++)
+        {
+            m_results.push_back(results[j][b]);
+            if (!results[j][b].ok) errors++;
+        }
+    }
+
+    return errors;
+}
+
+//*****************************************************************/
+
+void cDownloadScheduler::run_job(int job, std::vector<sResult> &results)
+{
+    cDownloader *downloader = m_jobs[job];
+
+    int download_type = icubCanProto_boardType__unknown;
+    for (int i=0; i<downloader->board_list_size; i++)
+    {
+        sBoard &board = downloader->board_list[i];
+        if (!board.selected)
+            continue;
+
+        if (download_type == icubCanProto_boardType__unknown)
+        {
+            download_type = board.type;
+        }
+        else if (board.type != download_type)
+        {
+            if(_verbose) yError ("job %d: the selected boards are of different types\n", job);
+            download_type = -1;
+            break;
+        }
+
+        board.status = BOARD_RUNNING;
+    }
+
+    double start = Time::now();
+
+    bool done = false;
+    if (download_type >= 0 && download_type != icubCanProto_boardType__unknown &&
+        downloader->startschede(CanPacket::everyCANbus) > 0)
+    {
+        done = (downloader->download_image(CanPacket::everyCANbus, ID_BROADCAST, download_type, m_image) == 0);
+        downloader->stopscheda(CanPacket::everyCANbus, ID_BROADCAST);
+    }
+
+    double time = Time::now() - start;
+
+    for (int i=0; i<downloader->board_list_size; i++)
+    {
+        sBoard &board = downloader->board_list[i];
+        if (!board.selected)
+            continue;
+
+        sResult result;
+        result.job  = job;
+        result.bus  = board.bus;
+        result.pid  = board.pid;
+        result.type = board.type;
+        result.ok   = done && (board.status == BOARD_DOWNLOADING);
+        result.time = time;
+        results.push_back(result);
+
+        board.status = result.ok ? BOARD_OK : BOARD_ERR;
+    }
+}
+
+// eof
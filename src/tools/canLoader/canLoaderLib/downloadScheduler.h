@@ -0,0 +1,65 @@
+/*
+ * Copyright (C) 2022 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef DOWNLOADSCHEDULER_H
+#define DOWNLOADSCHEDULER_H
+
+#include "downloader.h"
+#include "hexImage.h"
+
+#include <string>
+#include <vector>
+
+//*****************************************************************/
+
+// Downloads one firmware to the selected boards of many cDownloader at the same time.
+// Every cDownloader owns its driver (a CAN device, or the CAN buses of an ETH board) and
+// is served by its own thread. Inside a cDownloader the selected boards are programmed
+// together with broadcast frames, and the acks of every board are checked one by one:
+// a board which fails is reported and does not stop the others.
+// The firmware file is read and validated only once, in load().
+class cDownloadScheduler
+{
+public:
+    struct sResult
+    {
+        int    job;     // the index of the cDownloader, as returned by add()
+        int    bus;
+        int    pid;
+        int    type;
+        bool   ok;
+        double time;    // seconds from the start of the job to the end of the download
+    };
+
+    cDownloadScheduler(bool verbose = true);
+
+    int  load(const std::string &file);
+    int  add(cDownloader *downloader);
+    void clear();
+
+    // the selected boards of every cDownloader must be of the same type, the one of the file.
+    // Returns the number of boards which failed, -1 if there is nothing to do.
+    int  run();
+
+    const cHexImage& image() const { return m_image; }
+    const std::vector<sResult>& results() const { return m_results; }
+    double total_time() const { return m_total_time; }
+
+private:
+    void run_job(int job, std::vector<sResult> &results);
+
+    bool                       _verbose;
+    cHexImage                  m_image;
+    std::vector<cDownloader*>  m_jobs;
+    std::vector<sResult>       m_results;
+    double                     m_total_time;
+};
+
+#endif
+
+// eof
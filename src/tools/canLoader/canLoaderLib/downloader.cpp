@@ -3156,6 +3156,44 @@ int cDownloader::download_motorola_line(char* line, int len, int bus, int board_
     return -1;
 }
 
+//*****************************************************************/
+// marco.accame on 25may17:
+// here is extra safety to avoid an accidental loading of stm32 code (which starts at 0x0800) on dspic based boards.
+// the bootloader on dspic boards in such a case erases the first sector which tells to execute to the bootloader
+// at reset with teh result that the board become unreachable.
+// as we shall release strain2.hex and mtb4.hex which use stm32 mpus w/ code at 0x0800 and beyond, any accidental
+// attempt to program an old strain w/ strain2.hex becomes more probable. As the damage is high (removal of the the
+// FT sensor + disassembly + re-programming + recalibration), some sort of protection is mandatory.
+// instead, strain2/mtb4 are safe if any attempt is done to program them with old strain.hex/skin.hex code
+
+bool cDownloader::page_is_allowed(unsigned int page, int board_type)
+{
+    if(page < 0x0800)
+    {
+        return true;
+    }
+
+    // only mtb4, strain2, rfe, sg3, psc, mtb4w are allowed to use such a code space.
+    if((icubCanProto_boardType__mtb4 == board_type) || (icubCanProto_boardType__strain2 == board_type) ||
+       (icubCanProto_boardType__rfe == board_type) || (icubCanProto_boardType__sg3 == board_type) ||
+       (icubCanProto_boardType__psc == board_type) || (icubCanProto_boardType__mtb4w == board_type) ||
+       (icubCanProto_boardType__pmc == board_type)
+       || (icubCanProto_boardType__amcbldc == board_type)
+       || (icubCanProto_boardType__mtb4c == board_type)
+       || (icubCanProto_boardType__strain2c == board_type)
+      )
+    {   // it is ok
+        return true;
+    }
+
+    // be careful with that axe, eugene. ahhhhhhhhhhhhhhhh
+    char msg[32] = {0};
+    snprintf(msg, sizeof(msg), "0x%04X", page);
+    yError() << "Upload of FW to board" << eoboards_type2string2((eObrd_type_t)board_type, eobool_true) << "is aborted because it was detected a wrong page number =" << msg << "in the .hex file";
+    yError() << "You must have loaded the .hex file of another board. Perform a new discovery, check the file name and retry.";
+    return false;
+}
+
 //*****************************************************************/
 // This function read one line of the hexintel file and send it to a board using the correct protocol
 // Return values:
@@ -3251,40 +3289,11 @@ int cDownloader::download_hexintel_line(char* line, int len, int bus, int board_
                 sprsPage=getvalue(line+i,4);
                 i=i+4;
 
-                // marco.accame on 25may17:
-                // here is extra safety to avoid an accidental loading of stm32 code (which starts at 0x0800) on dspic based boards.
-                // the bootloader on dspic boards in such a case erases the first sector which tells to execute to the bootloader
-                // at reset with teh result that the board become unreachable.
-                // as we shall release strain2.hex and mtb4.hex which use stm32 mpus w/ code at 0x0800 and beyond, any accidental
-                // attempt to program an old strain w/ strain2.hex becomes more probable. As the damage is high (removal of the the
-                // FT sensor + disassembly + re-programming + recalibration), some sort of protection is mandatory.
-                // instead, strain2/mtb4 are safe if any attempt is done to program them with old strain.hex/skin.hex code
-                if(sprsPage >= 0x0800)
-                {   // only mtb4, strain2, rfe, sg3, psc, mtb4w are allowed to use such a code space.
-                    if((icubCanProto_boardType__mtb4 == board_type) || (icubCanProto_boardType__strain2 == board_type) ||
-                       (icubCanProto_boardType__rfe == board_type) || (icubCanProto_boardType__sg3 == board_type) ||
-                       (icubCanProto_boardType__psc == board_type) || (icubCanProto_boardType__mtb4w == board_type) ||
-                       (icubCanProto_boardType__pmc == board_type) 
-                       || (icubCanProto_boardType__amcbldc == board_type)
-                       || (icubCanProto_boardType__mtb4c == board_type)
-                       || (icubCanProto_boardType__strain2c == board_type) 
-                      )
-                    {   // it is ok
-                    }
-                    else
-                    {   // be careful with that axe, eugene. ahhhhhhhhhhhhhhhh
-                        //if(_verbose)
-                        {
-                            char msg[32] = {0};
-                            snprintf(msg, sizeof(msg), "0x%04X", sprsPage);
-                            yError() << "Upload of FW to board" << eoboards_type2string2((eObrd_type_t)board_type, eobool_true) << "is aborted because it was detected a wrong page number =" << msg << "in the .hex file";
-                            yError() << "You must have loaded the .hex file of another board. Perform a new discovery, check the file name and retry.";
-                        }
-                        return -1;
-                    }
+                if(!page_is_allowed(sprsPage, board_type))
+                {
+                    return -1;
                 }
 
-
             break;
             }
             sprsState=SPRS_STATE_CHECKSUM;
@@ -3542,6 +3551,381 @@ int cDownloader::download_file(int bus, int board_pid, int download_type, bool b
         }
 }
 
+//*****************************************************************/
+// Starts the bootloader of all the selected boards of the bus (of every bus with CanPacket::everyCANbus).
+// Differently from calling startscheda() for each board, the commands are sent to all the boards before
+// waiting, hence the boards erase their flash at the same time.
+// Return values:
+// n  the number of boards started (they go to BOARD_WAITING, the ones which did not answer to BOARD_ERR)
+// -1 Fatal error
+
+int cDownloader::startschede(int bus)
+{
+    // check if driver is running
+    if (m_idriver == NULL)
+        {
+            if(_verbose) yError ("START_CMD: Driver not ready\n");
+            return -1;
+        }
+
+    vector<int> boards;
+    for (int i=0; i<board_list_size; i++)
+        {
+            if (board_list[i].selected==true && board_list[i].status==BOARD_RUNNING &&
+                (bus==CanPacket::everyCANbus || board_list[i].bus==bus))
+                boards.push_back(i);
+        }
+
+    if (boards.empty())
+        return 0;
+
+    // the first command makes the application jump to the bootloader, the second one is for the bootloader
+    double wait = 0;
+    for (int jump=0; jump<2; jump++)
+        {
+            for (size_t b=0; b<boards.size(); b++)
+                {
+                    sBoard &board = board_list[boards[b]];
+
+                    txBuffer[0].setId(build_id(ID_MASTER, board.pid));
+                    txBuffer[0].getData()[0]= ICUBCANPROTO_BL_BOARD;
+
+                    switch (board.type)
+                    {
+                    case icubCanProto_boardType__dsp:
+                    case icubCanProto_boardType__pic:
+                    case icubCanProto_boardType__2dc:
+                    case icubCanProto_boardType__4dc:
+                    case icubCanProto_boardType__bll:
+                        txBuffer[0].setLen(1);
+                        wait = (wait > 250) ? wait : 250;
+                        break;
+                    default:
+                        txBuffer[0].setLen(2);
+                        txBuffer[0].getData()[1]= (int) board.eeprom;
+                        wait = 1500;
+                        break;
+                    }
+
+                    set_bus(txBuffer[0], board.bus);
+                    if (m_idriver->send_message(txBuffer, 1)==0 && jump==1)
+                        {
+                            if(_verbose) yError ("START_CMD: Unable to send message to board %d\n", board.pid);
+                            board.status=BOARD_ERR;
+                        }
+                }
+
+            // marco.accame: wait some more time (it was 500 ms) to wait amcbldc and pmc boards to erase their flash
+            drv_sleep((jump==0) ? wait : 2000);
+        }
+
+    for (size_t b=0; b<boards.size(); b++)
+        {
+            if (board_list[boards[b]].status==BOARD_RUNNING)
+                board_list[boards[b]].status=BOARD_WAITING;
+        }
+
+    int started = collect_acks(ICUBCANPROTO_BL_BOARD, 1);
+
+    for (size_t b=0; b<boards.size(); b++)
+        {
+            if (board_list[boards[b]].status==BOARD_DOWNLOADING)
+                board_list[boards[b]].status=BOARD_WAITING;
+        }
+
+    return started;
+}
+
+//*****************************************************************/
+// Downloads the whole image to the boards in BOARD_WAITING or BOARD_DOWNLOADING, with broadcast frames
+// if board_pid is ID_BROADCAST. Every board acks the records by itself: differently from download_file(),
+// a board which misses an ack goes to BOARD_ERR and the download goes on with the others.
+// progress counts the records sent out of file_length.
+// Return values:
+// 0  Download terminated, the boards still in BOARD_DOWNLOADING received the whole image
+// -1 Fatal error in sending one command, or no board left
+
+int cDownloader::download_image(int bus, int board_pid, int download_type, const cHexImage &image)
+{
+    if (m_idriver == NULL)
+        {
+            if(_verbose) yError ("Driver not ready\n");
+            return -1;
+        }
+
+    bool motorola = false;
+    switch (download_type)
+    {
+        case icubCanProto_boardType__dsp:
+        case icubCanProto_boardType__2dc:
+        case icubCanProto_boardType__4dc:
+        case icubCanProto_boardType__bll:
+            motorola = true;
+        break;
+        case icubCanProto_boardType__unknown:
+            if(_verbose) yError ("Unknown board type\n");
+            return -1;
+        default:
+            motorola = false;
+        break;
+    }
+
+    if (image.empty() || motorola != image.isMotorola())
+        {
+            if(_verbose) yError ("The file does not contain the firmware of the selected boards\n");
+            return -1;
+        }
+
+    progress = 0;
+    file_length = image.size();
+
+    for (size_t r=0; r<image.size(); r++)
+        {
+            int ret = motorola ? download_motorola_record(image[r], bus, board_pid)
+                               : download_hexintel_record(image[r], bus, board_pid, download_type);
+            if (ret != 0)
+                {
+                    if(_verbose) yError("fatal error during download: abort\n");
+                    return -1;
+                }
+            progress++;
+        }
+
+    return 0;
+}
+
+//*****************************************************************/
+// The frames of the payload of one record, 6 bytes each
+
+int cDownloader::send_data_frames(const sHexRecord &record, int bus, int board_pid, double pause)
+{
+    int length = record.data.size();
+    int frames = (length + 5) / 6;
+
+    txBuffer[0].setId(build_id(ID_MASTER,board_pid));
+    for (int j=0; j<frames; j++)
+        {
+            int n = (j<frames-1) ? 6 : length-6*j;
+
+            txBuffer[0].getData()[0]=ICUBCANPROTO_BL_DATA;
+            txBuffer[0].setLen(n+1);
+            for (int k=0; k<6; k++)
+                {
+                    txBuffer[0].getData()[k+1] = (k<n) ? record.data[6*j+k] : 0;
+                }
+
+            //send here
+            set_bus(txBuffer[0], bus);
+            if (m_idriver->send_message(txBuffer,1)==0)
+                {
+                    if(_verbose) yError ("Unable to send message\n");
+                    return -1;
+                }
+
+            //pause
+            if (pause > 0) drv_sleep(pause);
+        }
+
+    return 0;
+}
+
+//*****************************************************************/
+
+int cDownloader::download_hexintel_record(const sHexRecord &record, int bus, int board_pid, int board_type)
+{
+    switch (record.type)
+    {
+    case SPRS_TYPE_4:
+
+        return page_is_allowed(record.page, board_type) ? 0 : -1;
+
+    case SPRS_TYPE_0:
+
+        txBuffer[0].setId(build_id(ID_MASTER,board_pid));
+        txBuffer[0].setLen(7);
+        txBuffer[0].getData()[0]= ICUBCANPROTO_BL_ADDRESS;
+        txBuffer[0].getData()[1]= record.data.size();
+        txBuffer[0].getData()[2]= (unsigned char) ((record.address) & 0x00FF);
+        txBuffer[0].getData()[3]= (unsigned char) ((record.address>>8) & 0x00FF);
+        txBuffer[0].getData()[4]= record.memoryType;
+        txBuffer[0].getData()[5]= (unsigned char) ((record.page) & 0x00FF);
+        txBuffer[0].getData()[6]= (unsigned char) ((record.page >>8) & 0x00FF);
+
+        set_bus(txBuffer[0], bus);
+        if (m_idriver->send_message(txBuffer,1)==0)
+            {
+                if(_verbose) yError ("Unable to send message\n");
+                return -1;
+            }
+        drv_sleep(10);
+
+        if (send_data_frames(record, bus, board_pid, 5) != 0)
+            return -1;
+
+        //receive one ack for the whole line from every board
+        return (collect_acks(ICUBCANPROTO_BL_DATA, 10) > 0) ? 0 : -1;
+
+    case SPRS_TYPE_1:
+
+        txBuffer[0].setId(build_id(ID_MASTER,board_pid));
+        txBuffer[0].setLen(5);
+        txBuffer[0].getData()[0]= ICUBCANPROTO_BL_START;
+        txBuffer[0].getData()[1]= 0;
+        txBuffer[0].getData()[2]= 0;
+        txBuffer[0].getData()[3]= 0;
+        txBuffer[0].getData()[4]= 0;
+
+        set_bus(txBuffer[0], bus);
+        if (m_idriver->send_message(txBuffer,1)==0)
+            {
+                if(_verbose) yError ("Unable to send message\n");
+                return -1;
+            }
+        drv_sleep(5);
+
+        return (collect_acks(ICUBCANPROTO_BL_START, 1) > 0) ? 0 : -1;
+    }
+
+    return 0;
+}
+
+//*****************************************************************/
+
+int cDownloader::download_motorola_record(const sHexRecord &record, int bus, int board_pid)
+{
+    switch (record.type)
+    {
+    case SPRS_TYPE_3:
+
+        txBuffer[0].setId(build_id(ID_MASTER,board_pid));
+        txBuffer[0].setLen(5);
+        txBuffer[0].getData()[0]= ICUBCANPROTO_BL_ADDRESS;
+        txBuffer[0].getData()[1]= record.data.size();
+        txBuffer[0].getData()[2]= (unsigned char) ((record.address) & 0x00FF);
+        txBuffer[0].getData()[3]= (unsigned char) ((record.address>>8) & 0x00FF);
+        txBuffer[0].getData()[4]= record.memoryType;
+
+        set_bus(txBuffer[0], bus);
+        if (m_idriver->send_message(txBuffer,1)==0)
+            {
+                if(_verbose) yError ("Unable to send message\n");
+                return -1;
+            }
+
+        if (send_data_frames(record, bus, board_pid, 0) != 0)
+            return -1;
+
+        // as in download_motorola_line() the acks of the lines are just waited for, not verified
+        m_idriver->receive_message(rxBuffer, active_boards());
+        return 0;
+
+    case SPRS_TYPE_7:
+
+        txBuffer[0].setId(build_id(ID_MASTER,board_pid));
+        txBuffer[0].setLen(5);
+        txBuffer[0].getData()[0]= ICUBCANPROTO_BL_START;
+        txBuffer[0].getData()[4]= record.data[0];
+        txBuffer[0].getData()[3]= record.data[1];
+        txBuffer[0].getData()[2]= record.data[2];
+        txBuffer[0].getData()[1]= record.data[3];
+
+        set_bus(txBuffer[0], bus);
+        if (m_idriver->send_message(txBuffer,1)==0)
+            {
+                if(_verbose) yError ("Unable to send message\n");
+                return -1;
+            }
+        drv_sleep(10+5);
+
+        return (collect_acks(ICUBCANPROTO_BL_START, 1) > 0) ? 0 : -1;
+    }
+
+    return 0;
+}
+
+//*****************************************************************/
+// The number of selected boards which are taking part to the download
+
+int cDownloader::active_boards()
+{
+    int n=0;
+    for (int i=0; i<board_list_size; i++)
+        {
+            if (board_list[i].selected==true &&
+                (board_list[i].status == BOARD_WAITING || board_list[i].status == BOARD_DOWNLOADING))
+                n++;
+        }
+    return n;
+}
+
+//*****************************************************************/
+// Waits up to timeout seconds for the ack of command from each board taking part to the download.
+// It returns as soon as all of them answered: the boards which acked go to BOARD_DOWNLOADING,
+// the others to BOARD_ERR. Returns the number of boards which acked.
+
+int cDownloader::collect_acks(int command, double timeout)
+{
+    int pending=0;
+    for (int i=0; i<board_list_size; i++)
+        {
+            if (board_list[i].selected==true &&
+                (board_list[i].status == BOARD_WAITING || board_list[i].status == BOARD_DOWNLOADING))
+                {
+                    board_list[i].status = BOARD_WAITING_ACK;
+                    pending++;
+                }
+        }
+
+    double start=Time::now();
+    while (pending>0)
+        {
+            double left=timeout-(Time::now()-start);
+            if (left<=0)
+                break;
+
+            int howMany = (pending < (int)rxBuffer.size()) ? pending : (int)rxBuffer.size();
+            int read_messages = m_idriver->receive_message(rxBuffer, howMany, left);
+
+            for (int k=0; k<read_messages; k++)
+                {
+                    // the answer to ICUBCANPROTO_BL_BOARD is only checked for the command, as in startscheda()
+                    if ((rxBuffer[k].getData()[0]!=command) ||
+                        (((rxBuffer[k].getId() >> 8) & 0x07) != ICUBCANPROTO_CLASS_BOOTLOADER))
+                        continue;
+                    if ((command != ICUBCANPROTO_BL_BOARD) &&
+                        ((rxBuffer[k].getLen() != 2) || (rxBuffer[k].getData()[1]!=1)))
+                        continue;
+
+                    for (int i=0; i<board_list_size; i++)
+                        {
+                            if (board_list[i].selected==true &&
+                                board_list[i].status == BOARD_WAITING_ACK &&
+                                board_list[i].pid == get_src_from_id(rxBuffer[k].getId()) &&
+                                board_list[i].bus == rxBuffer[k].getCanBus())
+                                {
+                                    board_list[i].status=BOARD_DOWNLOADING;
+                                    pending--;
+                                    break;
+                                }
+                        }
+                }
+        }
+
+    int acked=0;
+    for (int i=0; i<board_list_size; i++)
+        {
+            if (board_list[i].selected==true && board_list[i].status == BOARD_WAITING_ACK)
+                {
+                    if(_verbose) yError ("No ACK of command %d received from board CAN%d:%d\n", command, board_list[i].bus, board_list[i].pid);
+                    board_list[i].status=BOARD_ERR;
+                }
+            else if (board_list[i].selected==true && board_list[i].status == BOARD_DOWNLOADING)
+                acked++;
+        }
+
+    return acked;
+}
+
 void cDownloader::clean_rx(void)
 {
     m_idriver->receive_message(rxBuffer,64,0.001);
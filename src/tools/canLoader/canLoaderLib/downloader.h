@@ -75,6 +75,7 @@ void drv_sleep (double time);
 
 
 #include "driver.h"
+#include "hexImage.h"
 
 #include "EoBoards.h"
 #include "EoCommon.h"
@@ -138,6 +139,13 @@ int get_dst_from_id (int id);
 
 int verify_ack(int command, int read_messages);
 
+bool page_is_allowed(unsigned int page, int board_type);
+int download_motorola_record(const sHexRecord &record, int bus, int board_pid);
+int download_hexintel_record(const sHexRecord &record, int bus, int board_pid, int board_type);
+int send_data_frames(const sHexRecord &record, int bus, int board_pid, double pause);
+int active_boards();
+int collect_acks(int command, double timeout);
+
 //Luca
 enum { ampl_gain_numberOf = 13 };
 
@@ -163,6 +171,8 @@ int initschede			();
 int startscheda			(int bus, int board_pid, bool board_eeprom, int download_type);
 int stopscheda			(int bus, int board_pid);
 int download_file		(int bus, int board_pid, int download_type, bool eeprom);
+int startschede			(int bus);
+int download_image		(int bus, int board_pid, int download_type, const cHexImage &image);
 int open_file			(std::string file);
 int change_card_address	(int bus, int target_id, int new_id, int board_type);
 int change_board_info	(int bus, int target_id, char* board_info);
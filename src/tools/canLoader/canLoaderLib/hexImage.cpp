@@ -0,0 +1,224 @@
+/*
+ * Copyright (C) 2022 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include "hexImage.h"
+#include "downloader.h"
+
+#include <yarp/os/Log.h>
+
+#include <fstream>
+#include <string.h>
+
+namespace
+{
+    int hexdigit(char c)
+    {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+        return -1;
+    }
+
+    // the value of the n hex digits at line, -1 if they are not all hex digits
+    long hexvalue(const char *line, int n)
+    {
+        long value = 0;
+        for (int i=0; i<n; i++)
+        {
+            int d = hexdigit(line[i]);
+            if (d < 0) return -1;
+            value = (value << 4) | d;
+        }
+        return value;
+    }
+}
+
+//*****************************************************************/
+
+cHexImage::cHexImage()
+{
+    motorola = false;
+}
+
+void cHexImage::clear()
+{
+    motorola = false;
+    records.clear();
+}
+
+size_t cHexImage::payload() const
+{
+    size_t bytes = 0;
+    for (size_t i=0; i<records.size(); i++)
+    {
+        if (records[i].type == SPRS_TYPE_0 || records[i].type == SPRS_TYPE_3)
+            bytes += records[i].data.size();
+    }
+    return bytes;
+}
+
+//*****************************************************************/
+
+int cHexImage::load(const std::string &file, bool verbose)
+{
+    clear();
+
+    std::ifstream filestr(file.c_str());
+    if (!filestr.is_open())
+    {
+        if(verbose) yError ("Error opening file %s\n", file.c_str());
+        return -1;
+    }
+
+    unsigned int page = 0;
+    int lineno = 0;
+    std::string line;
+    while (std::getline(filestr, line))
+    {
+        lineno++;
+
+        // windows files and trailing blanks
+        while (!line.empty() && (line.back() == '\r' || line.back() == ' ' || line.back() == '\t'))
+            line.pop_back();
+
+        //avoid to download empty lines
+        if (line.empty())
+            continue;
+
+        if (records.empty() && line[0] == 'S')
+            motorola = true;
+
+        int ret = motorola ? parse_motorola_line(line.c_str(), line.size())
+                           : parse_hexintel_line(line.c_str(), line.size(), page);
+        if (ret != 0)
+        {
+            if(verbose) yError ("%s: invalid record at line %d\n", file.c_str(), lineno);
+            clear();
+            return -1;
+        }
+    }
+
+    if (records.empty())
+    {
+        if(verbose) yError ("%s: no records found\n", file.c_str());
+        return -1;
+    }
+
+    return 0;
+}
+
+//*****************************************************************/
+// :LLAAAATT<data>CC where the sum of all the bytes is zero
+
+int cHexImage::parse_hexintel_line(const char *line, int len, unsigned int &page)
+{
+    if (line[0] != ':' || len < 11 || (len % 2) == 0)
+        return -1;
+
+    unsigned long int checksum = 0;
+    for (int i=1; i<len; i=i+2)
+    {
+        long value = hexvalue(line+i, 2);
+        if (value < 0) return -1;
+        checksum += value;
+    }
+    if ((checksum & 0xFF) != 0x00)
+        return -1;
+
+    int length = hexvalue(line+1, 2);
+    if (len != 11 + 2*length)
+        return -1;
+
+    sHexRecord record;
+    record.type = line[8];
+    record.address = hexvalue(line+3, 4);
+    record.memoryType = 0;
+
+    switch (record.type)
+    {
+    case SPRS_TYPE_0:
+        record.page = page;
+        for (int k=0; k<length; k++)
+            record.data.push_back((unsigned char) hexvalue(line+9+2*k, 2));
+        break;
+
+    case SPRS_TYPE_4:
+        if (length != 2) return -1;
+        page = hexvalue(line+9, 4);
+        record.page = page;
+        break;
+
+    case SPRS_TYPE_1:
+        record.page = page;
+        break;
+
+    default:
+        // the other records are not sent to the boards
+        return 0;
+    }
+
+    records.push_back(record);
+    return 0;
+}
+
+//*****************************************************************/
+// STLL<address><data>CC where the sum of the bytes from LL on is 0xFF
+
+int cHexImage::parse_motorola_line(const char *line, int len)
+{
+    if (line[0] != 'S' || len < 4 || (len % 2) != 0)
+        return -1;
+
+    unsigned long int checksum = 0;
+    for (int i=2; i<len; i=i+2)
+    {
+        long value = hexvalue(line+i, 2);
+        if (value < 0) return -1;
+        checksum += value;
+    }
+    if ((checksum & 0xFF) != 0xFF)
+        return -1;
+
+    int count = hexvalue(line+2, 2);
+    if (len != 4 + 2*count)
+        return -1;
+
+    sHexRecord record;
+    record.type = line[1];
+    record.page = 0;
+    record.memoryType = 0;
+
+    switch (record.type)
+    {
+    case SPRS_TYPE_0:
+        return 0;
+
+    case SPRS_TYPE_3:
+        if (count < 5) return -1;
+        record.memoryType = (hexvalue(line+4, 4) == 0x0020) ? 1 : 0;
+        record.address = hexvalue(line+8, 4);
+        for (int k=0; k<count-4-1; k++)
+            record.data.push_back((unsigned char) hexvalue(line+12+2*k, 2));
+        break;
+
+    case SPRS_TYPE_7:
+        if (count != 5) return -1;
+        record.address = 0;
+        for (int k=0; k<4; k++)
+            record.data.push_back((unsigned char) hexvalue(line+4+2*k, 2));
+        break;
+
+    default:
+        return -1;
+    }
+
+    records.push_back(record);
+    return 0;
+}
+
+// eof
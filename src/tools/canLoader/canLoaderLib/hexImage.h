@@ -0,0 +1,58 @@
+/*
+ * Copyright (C) 2022 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef HEXIMAGE_H
+#define HEXIMAGE_H
+
+#include <string>
+#include <vector>
+
+//*****************************************************************/
+
+// one record of the firmware which has to be sent to the bootloader
+struct sHexRecord
+{
+    char                       type;        // SPRS_TYPE_0 / 1 / 4 for hexintel, SPRS_TYPE_3 / 7 for motorola
+    unsigned long int          address;     // the 16 bits address of the record (lower 16 bits for motorola)
+    unsigned int               page;        // hexintel: the page in use (or the new one for SPRS_TYPE_4)
+    int                        memoryType;  // motorola: 1 for the 0x0020xxxx space, 0 otherwise
+    std::vector<unsigned char> data;        // the payload (the 4 bytes of the entry point for SPRS_TYPE_7)
+};
+
+//*****************************************************************/
+
+// the firmware file (.hex or .S) parsed once and kept in memory, so that it can be sent
+// by many cDownloader at the same time without reading and validating it line by line.
+class cHexImage
+{
+public:
+    cHexImage();
+
+    // returns 0 if the file is read and all its records have a valid checksum, -1 otherwise
+    int load(const std::string &file, bool verbose = true);
+    void clear();
+
+    bool isMotorola() const { return motorola; }
+    bool empty() const { return records.empty(); }
+    size_t size() const { return records.size(); }
+    const sHexRecord& operator[](size_t i) const { return records[i]; }
+
+    // the bytes of the program
+    size_t payload() const;
+
+private:
+    int parse_hexintel_line(const char *line, int len, unsigned int &page);
+    int parse_motorola_line(const char *line, int len);
+
+    bool motorola;
+    std::vector<sHexRecord> records;
+};
+
+#endif
+
+// eof
@@ -82,6 +82,10 @@
  *
  * logToFile                     //if present, this options creates a log file for each data port
  *
+ * binaryLog    [file]           //if present, all data are sampled by one thread and stored in a binary log (no ports are opened)
+ *
+ * ringSize     n                //number of samples buffered between the sampling thread and the disk writer [default: 4096]
+ *
  * \endcode
  * 
  * If no such file can be found, the application is started
@@ -163,6 +167,19 @@
  *
  * \endcode
  *
+ * For high rate acquisitions the binaryLog option replaces the per-data
+ * threads and ports with a single thread that reads all the selected
+ * interfaces once per period into a preallocated ring, while a background
+ * thread flushes the ring to a compact binary file. Sampling jitter,
+ * missed periods and samples dropped because the ring was full are
+ * reported every few seconds. The binary file can be converted into the
+ * same text files created by logToFile with:
+ * \code
+ *
+ * controlBoardDumper --exportBinaryLog _controlBoardDumper_head_binary.log
+ *
+ * \endcode
+ *
  * \section portsa_sec Ports Accessed
  * For each part initalized (e.g. head):
  * <ul>
@@ -193,6 +210,7 @@
 #include <yarp/os/LogStream.h>
 
 #include "dumperThread.h"
+#include "recorderThread.h"
 #include <string>
 
 #define NUMBER_OF_AVAILABLE_STANDARD_DATA_TO_DUMP 17
@@ -394,6 +412,8 @@ private:
     int nData;
 
     boardDumperThread *myDumper;
+    boardRecorderThread *myRecorder;
+    double lastStatsTime;
 
     //time stamp
     IPreciselyTimed *istmp;
@@ -433,7 +453,12 @@ private:
 public:
     DumpModule() : useDebugClient(false)
     { 
+        nData=0;
+        myDumper=0;
+        myRecorder=0;
+        lastStatsTime=0.0;
         istmp=0;
+        imot=0;
         ienc=0;
         imotenc=0;
         ipid=0;
@@ -443,6 +468,113 @@ public:
         iimod=0;
     }
 
+    GetData *getGetter(const std::string &data)
+    {
+        GetData *getter = 0;
+        if ((data == "getEncoders") && ddBoard.view(ienc))
+        {
+            myGetEncs.setInterface(ienc);
+            getter = &myGetEncs;
+        }
+        else if ((data == "getEncoderSpeeds") && ddBoard.view(ienc))
+        {
+            myGetSpeeds.setInterface(ienc);
+            getter = &myGetSpeeds;
+        }
+        else if ((data == "getEncoderAccelerations") && ddBoard.view(ienc))
+        {
+            myGetAccs.setInterface(ienc);
+            getter = &myGetAccs;
+        }
+        else if ((data == "getPosPidReferences") && ddBoard.view(ipid))
+        {
+            myGetPidRefs.setInterface(ipid);
+            getter = &myGetPidRefs;
+        }
+        else if ((data == "getTrqPidReferences") && ddBoard.view(itrq))
+        {
+            myGetTrqRefs.setInterface(itrq);
+            getter = &myGetTrqRefs;
+        }
+        else if ((data == "getControlModes") && ddBoard.view(icmod))
+        {
+            myGetControlModes.setInterface(icmod, nJoints);
+            getter = &myGetControlModes;
+        }
+        else if ((data == "getInteractionModes") && ddBoard.view(iimod))
+        {
+            myGetInteractionModes.setInterface(iimod, nJoints);
+            getter = &myGetInteractionModes;
+        }
+        else if ((data == "getPositionErrors") && ddBoard.view(ipid))
+        {
+            myGetPosErrs.setInterface(ipid);
+            getter = &myGetPosErrs;
+        }
+        else if ((data == "getOutputs") && ddBoard.view(ipid))
+        {
+            myGetOuts.setInterface(ipid);
+            getter = &myGetOuts;
+        }
+        else if ((data == "getCurrents") && ddBoard.view(iamp))
+        {
+            myGetCurrs.setInterface(iamp);
+            getter = &myGetCurrs;
+        }
+        else if ((data == "getTorques") && ddBoard.view(itrq))
+        {
+            myGetTrqs.setInterface(itrq);
+            getter = &myGetTrqs;
+        }
+        else if ((data == "getTorqueErrors") && ddBoard.view(ipid))
+        {
+            myGetTrqErrs.setInterface(ipid);
+            getter = &myGetTrqErrs;
+        }
+        else if ((data == "getTemperatures") && ddBoard.view(imot))
+        {
+            myGetTemps.setInterface(imot);
+            getter = &myGetTemps;
+        }
+        else if ((data == "getMotorEncoders") && ddBoard.view(imotenc))
+        {
+            myGetMotorEncs.setInterface(imotenc);
+            getter = &myGetMotorEncs;
+        }
+        else if ((data == "getMotorEncoderSpeeds") && ddBoard.view(imotenc))
+        {
+            myGetMotorSpeeds.setInterface(imotenc);
+            getter = &myGetMotorSpeeds;
+        }
+        else if ((data == "getMotorEncoderAccelerations") && ddBoard.view(imotenc))
+        {
+            myGetMotorAccs.setInterface(imotenc);
+            getter = &myGetMotorAccs;
+        }
+        else if ((data == "getMotorsPwm") && ddBoard.view(iamp))
+        {
+            myGetMotPwm.setInterface(iamp);
+            if ((ienc == 0) && !ddBoard.view(ienc))
+                return 0;
+            ienc->getAxes(&myGetMotPwm.n_joint_part);
+            getter = &myGetMotPwm;
+        }
+
+        if (getter)
+        {
+            yInfo("Initializing a %s getter\n", data.c_str());
+            if (ddBoard.view(istmp))
+            {
+                yInfo("%s::The time stamp initalization interfaces was successfull! \n", data.c_str());
+                getter->setStamp(istmp);
+            }
+            else
+                yError("Problems getting the time stamp interfaces \n");
+        }
+
+        return getter;
+    }
+
     virtual bool configure(ResourceFinder &rf)
     {
         // get command line options
@@ -563,324 +695,54 @@ public:
         //boardDumperThread *myDumper = new boardDumperThread(&dd, rate, portPrefix, dataToDump[0]);
         //myDumper->setThetaMap(thetaMap, nJoints);
 
+        if (rf.check("binaryLog"))
+        {
+            // a single sampling thread reads all the requested data
+            // and a background writer streams them to disk
+            Value &binaryLog=rf.find("binaryLog");
+            std::string binaryLogName=(binaryLog.isString() ? binaryLog.asString() : "");
+            if (binaryLogName.empty())
+            {
+                binaryLogName=portPrefix;
+                for (size_t i=0; i<binaryLogName.length(); i++)
+                    if (binaryLogName[i]=='/') binaryLogName[i]='_';
+                binaryLogName+="binary.log";
+            }
+
+            int nAxes=0;
+            if (!ddBoard.view(ienc) || !ienc->getAxes(&nAxes))
+            {
+                yError("Unable to retrieve the number of axes\n");
+                return false;
+            }
+
+            myRecorder = new boardRecorderThread;
+            for (int i = 0; i < nData; i++)
+            {
+                GetData *getter = getGetter(dataToDump[i]);
+                if (getter)
+                    myRecorder->addChannel(portPrefix + dataToDump[i], getter);
+                else
+                    yError("%s is not available and will not be recorded\n", dataToDump[i].c_str());
+            }
+
+            if (!myRecorder->setup(rate, nAxes, thetaMap, nJoints, binaryLogName,
+                                   rf.check("ringSize",Value(4096)).asInt32()))
+                return false;
+
+            return myRecorder->start();
+        }
+
         myDumper = new boardDumperThread[nData];
 
         for (int i = 0; i < nData; i++)
             {
-                if (dataToDump[i] == "getEncoders" )
-                {
-                    if (ddBoard.view(ienc))
-                        {
-                            yInfo("Initializing a getEncs thread\n");
-                            myDumper[i].setDevice(&ddBoard, &ddDebug, rate, portPrefix, dataToDump[i], logToFile);
-                            myDumper[i].setThetaMap(thetaMap, nJoints);
-                            myGetEncs.setInterface(ienc);
-                            if (ddBoard.view(istmp))
-                            {
-                                yInfo("getEncoders::The time stamp initalization interfaces was successfull! \n");
-                                myGetEncs.setStamp(istmp);
-                            }
-                            else
-                                yError("Problems getting the time stamp interfaces \n");
-                            myDumper[i].setGetter(&myGetEncs);
-                        }
-                }
-                else if (dataToDump[i] == "getEncoderSpeeds")
+                GetData *getter = getGetter(dataToDump[i]);
+                if (getter)
                 {
-                    if (ddBoard.view(ienc))
-                        {
-                            yInfo("Initializing a getSpeeds thread\n");
-                            myDumper[i].setDevice(&ddBoard, &ddDebug, rate, portPrefix, dataToDump[i], logToFile);
-                            myDumper[i].setThetaMap(thetaMap, nJoints);
-                            myGetSpeeds.setInterface(ienc);
-                            if (ddBoard.view(istmp))
-                            {
-                                yInfo("getEncodersSpeed::The time stamp initalization interfaces was successfull! \n");
-                                myGetSpeeds.setStamp(istmp);
-                            }
-                            else
-                                yError("Problems getting the time stamp interfaces \n");
-                            myDumper[i].setGetter(&myGetSpeeds);
-                        }
-                }
-                else if (dataToDump[i] == "getEncoderAccelerations")
-                {
-                    if (ddBoard.view(ienc))
-                        {
-                            yInfo("Initializing a getAccs thread\n");
-                            myDumper[i].setDevice(&ddBoard, &ddDebug, rate, portPrefix, dataToDump[i], logToFile);
-                            myDumper[i].setThetaMap(thetaMap, nJoints);
-                            myGetAccs.setInterface(ienc);
-                            if (ddBoard.view(istmp))
-                            {
-                                yInfo("getEncoderAccelerations::The time stamp initalization interfaces was successfull! \n");
-                                myGetAccs.setStamp(istmp);
-                            }
-                            else
-                                yError("Problems getting the time stamp interfaces \n");
-                            myDumper[i].setGetter(&myGetAccs);
-                        }
-                }
-                else if (dataToDump[i] == "getPosPidReferences")
-                {
-                    if (ddBoard.view(ipid))
-                        {
-                            yInfo("Initializing a getErrs thread\n");
-                            myDumper[i].setDevice(&ddBoard, &ddDebug, rate, portPrefix, dataToDump[i], logToFile);
-                            myDumper[i].setThetaMap(thetaMap, nJoints);
-                            myGetPidRefs.setInterface(ipid);
-                            if (ddBoard.view(istmp))
-                            {
-                                yInfo("getPosPidReferences::The time stamp initalization interfaces was successfull! \n");
-                                myGetPidRefs.setStamp(istmp);
-                            }
-                            else
-                                yError("Problems getting the time stamp interfaces \n");
-                            myDumper[i].setGetter(&myGetPidRefs);
-                        }
-                }
-                 else if (dataToDump[i] == "getTrqPidReferences")
-                 {
-                     if (ddBoard.view(itrq))
-                        {
-                            yInfo("Initializing a getErrs thread\n");
-                            myDumper[i].setDevice(&ddBoard, &ddDebug, rate, portPrefix, dataToDump[i], logToFile);
-                            myDumper[i].setThetaMap(thetaMap, nJoints);
-                            myGetTrqRefs.setInterface(itrq);
-                            if (ddBoard.view(istmp))
-                            {
-                                yInfo("getTrqPidReferences::The time stamp initalization interfaces was successfull! \n");
-                                myGetTrqRefs.setStamp(istmp);
-                            }
-                            else
-                                yError("Problems getting the time stamp interfaces \n");
-                            myDumper[i].setGetter(&myGetTrqRefs);
-                        }
-                }
-                 else if (dataToDump[i] == "getControlModes")
-                {
-                    if (ddBoard.view(icmod))
-                        {
-                            yInfo("Initializing a getErrs thread\n");
-                            myDumper[i].setDevice(&ddBoard, &ddDebug, rate, portPrefix, dataToDump[i], logToFile);
-                            myDumper[i].setThetaMap(thetaMap, nJoints);
-                            myGetControlModes.setInterface(icmod, nJoints);
-                            if (ddBoard.view(istmp))
-                            {
-                                yInfo("getControlModes::The time stamp initalization interfaces was successfull! \n");
-                                myGetControlModes.setStamp(istmp);
-                            }
-                            else
-                                yError("Problems getting the time stamp interfaces \n");
-                            myDumper[i].setGetter(&myGetControlModes);
-                        }
-                 }
-                 else if (dataToDump[i] == "getInteractionModes")
-                 {
-                     if (ddBoard.view(iimod))
-                        {
-                            yInfo("Initializing a getErrs thread\n");
-                            myDumper[i].setDevice(&ddBoard, &ddDebug, rate, portPrefix, dataToDump[i], logToFile);
-                            myDumper[i].setThetaMap(thetaMap, nJoints);
-                            myGetInteractionModes.setInterface(iimod, nJoints);
-                            if (ddBoard.view(istmp))
-                            {
-                                yInfo("getInteractionModes::The time stamp initalization interfaces was successfull! \n");
-                                myGetInteractionModes.setStamp(istmp);
-                            }
-                            else
-                                yError("Problems getting the time stamp interfaces \n");
-                            myDumper[i].setGetter(&myGetInteractionModes);
-                        }
-                 }
-                else if (dataToDump[i] == "getPositionErrors")
-                 {
-                     if (ddBoard.view(ipid))
-                        {
-                            yInfo("Initializing a getErrs thread\n");
-                            myDumper[i].setDevice(&ddBoard, &ddDebug, rate, portPrefix, dataToDump[i], logToFile);
-                            myDumper[i].setThetaMap(thetaMap, nJoints);
-                            myGetPosErrs.setInterface(ipid);
-                            if (ddBoard.view(istmp))
-                            {
-                                yInfo("getPositionErrors::The time stamp initalization interfaces was successfull! \n");
-                                myGetPosErrs.setStamp(istmp);
-                            }
-                            else
-                                yError("Problems getting the time stamp interfaces \n");
-                            myDumper[i].setGetter(&myGetPosErrs);
-                        }
-                 }
-                else if (dataToDump[i] == "getOutputs")
-                 {
-                     if (ddBoard.view(ipid))
-                        {
-                            yInfo("Initializing a getOuts thread\n");
-                            myDumper[i].setDevice(&ddBoard, &ddDebug, rate, portPrefix, dataToDump[i], logToFile);
-                            myDumper[i].setThetaMap(thetaMap, nJoints);
-                            myGetOuts.setInterface(ipid);
-                            if (ddBoard.view(istmp))
-                            {
-                                yInfo("getOutputs::The time stamp initalization interfaces was successfull! \n");
-                                myGetOuts.setStamp(istmp);
-                            }
-                            else
-                                yError("Problems getting the time stamp interfaces \n");
-                            myDumper[i].setGetter(&myGetOuts);
-                        }
-                }
-                else if (dataToDump[i] == "getCurrents")
-                {
-                    if (ddBoard.view(iamp))
-                        {
-                            yInfo("Initializing a getCurrs thread\n");
-                            myDumper[i].setDevice(&ddBoard, &ddDebug, rate, portPrefix, dataToDump[i], logToFile);
-                            myDumper[i].setThetaMap(thetaMap, nJoints);
-                            myGetCurrs.setInterface(iamp);
-                            if (ddBoard.view(istmp))
-                            {
-                                yInfo("getCurrents::The time stamp initalization interfaces was successfull! \n");
-                                myGetCurrs.setStamp(istmp);
-                            }
-                            else
-                                yError("Problems getting the time stamp interfaces \n");
-                               
-                            myDumper[i].setGetter(&myGetCurrs);
-                        }
-                }
-                else if (dataToDump[i] == "getTorques")
-                {
-                    if (ddBoard.view(itrq))
-                        {
-                            yInfo("Initializing a getTorques thread\n");
-                            myDumper[i].setDevice(&ddBoard, &ddDebug, rate, portPrefix, dataToDump[i], logToFile);
-                            myDumper[i].setThetaMap(thetaMap, nJoints);
-                            myGetTrqs.setInterface(itrq);
-                            if (ddBoard.view(istmp))
-                            {
-                                yInfo("getTorques::The time stamp initalization interfaces was successfull! \n");
-                                myGetTrqs.setStamp(istmp);
-                            }
-                            else
-                                yError("Problems getting the time stamp interfaces \n");
-                               
-                            myDumper[i].setGetter(&myGetTrqs);
-                        }
-                }
-                else if (dataToDump[i] == "getTorqueErrors")
-                {
-                    if (ddBoard.view(ipid))
-                        {
-                            yInfo("Initializing a getTorqueErrors thread\n");
-                            myDumper[i].setDevice(&ddBoard, &ddDebug, rate, portPrefix, dataToDump[i], logToFile);
-                            myDumper[i].setThetaMap(thetaMap, nJoints);
-                            myGetTrqErrs.setInterface(ipid);
-                            if (ddBoard.view(istmp))
-                            {
-                                yInfo("getTorqueErrors::The time stamp initalization interfaces was successfull! \n");
-                                myGetTrqErrs.setStamp(istmp);
-                            }
-                            else
-                                yError("Problems getting the time stamp interfaces \n");
-                               
-                            myDumper[i].setGetter(&myGetTrqErrs);
-                        }
-                }
-                else if (dataToDump[i] == "getTemperatures")
-                {
-                    if (ddBoard.view(imotenc))
-                        {
-                            yInfo("Initializing a getTemps thread\n");
-                            myDumper[i].setDevice(&ddBoard, &ddDebug, rate, portPrefix, dataToDump[i], logToFile);
-                            myDumper[i].setThetaMap(thetaMap, nJoints);
-                            myGetTemps.setInterface(imot);
-                            if (ddBoard.view(istmp))
-                            {
-                                yInfo("getEncoders::The time stamp initalization interfaces was successfull! \n");
-                                myGetTemps.setStamp(istmp);
-                            }
-                            else
-                                yError("Problems getting the time stamp interfaces \n");
-                            myDumper[i].setGetter(&myGetTemps);
-                        }
-                }
-                else if (dataToDump[i] == "getMotorEncoders")
-                {
-                    if (ddBoard.view(imotenc))
-                        {
-                            yInfo("Initializing a getEncs thread\n");
-                            myDumper[i].setDevice(&ddBoard, &ddDebug, rate, portPrefix, dataToDump[i], logToFile);
-                            myDumper[i].setThetaMap(thetaMap, nJoints);
-                            myGetMotorEncs.setInterface(imotenc);
-                            if (ddBoard.view(istmp))
-                            {
-                                yInfo("getEncoders::The time stamp initalization interfaces was successfull! \n");
-                                myGetMotorEncs.setStamp(istmp);
-                            }
-                            else
-                                yError("Problems getting the time stamp interfaces \n");
-                            myDumper[i].setGetter(&myGetMotorEncs);
-                        }
-                }
-                else if (dataToDump[i] == "getMotorEncoderSpeeds")
-                {
-                    if (ddBoard.view(imotenc))
-                        {
-                            yInfo("Initializing a getSpeeds thread\n");
-                            myDumper[i].setDevice(&ddBoard, &ddDebug, rate, portPrefix, dataToDump[i], logToFile);
-                            myDumper[i].setThetaMap(thetaMap, nJoints);
-                            myGetMotorSpeeds.setInterface(imotenc);
-                            if (ddBoard.view(istmp))
-                            {
-                                yInfo("getEncodersSpeed::The time stamp initalization interfaces was successfull! \n");
-                                myGetMotorSpeeds.setStamp(istmp);
-                            }
-                            else
-                                yError("Problems getting the time stamp interfaces \n");
-                            myDumper[i].setGetter(&myGetMotorSpeeds);
-                        }
-                }
-                else if (dataToDump[i] == "getMotorEncoderAccelerations")
-                {
-                    if (ddBoard.view(imotenc))
-                        {
-                            yInfo("Initializing a getAccs thread\n");
-                            myDumper[i].setDevice(&ddBoard, &ddDebug, rate, portPrefix, dataToDump[i], logToFile);
-                            myDumper[i].setThetaMap(thetaMap, nJoints);
-                            myGetMotorAccs.setInterface(imotenc);
-                            if (ddBoard.view(istmp))
-                            {
-                                yInfo("getEncoderAccelerations::The time stamp initalization interfaces was successfull! \n");
-                                myGetMotorAccs.setStamp(istmp);
-                            }
-                            else
-                                yError("Problems getting the time stamp interfaces \n");
-                            myDumper[i].setGetter(&myGetMotorAccs);
-                        }
-                }
-                else if (dataToDump[i] == "getMotorsPwm")
-                 {
-                     if (ddBoard.view(iamp))
-                        {
-                            yInfo("Initializing a getMotPwm thread\n");
-                            myDumper[i].setDevice(&ddBoard, &ddDebug, rate, portPrefix, dataToDump[i], logToFile);
-                            myDumper[i].setThetaMap(thetaMap, nJoints);
-                            myGetMotPwm.setInterface(iamp);
-                            if(ienc == 0)
-                            {
-                                if(!ddBoard.view(ienc))
-                                    return false;
-                            }
-                            ienc->getAxes(&myGetMotPwm.n_joint_part);
-                            if (ddBoard.view(istmp))
-                            {
-                                yInfo("getMotorsPwm::The time stamp initalization interfaces was successfull! \n");
-                                myGetMotPwm.setStamp(istmp);
-                            }
-                            else
-                                yError("Problems getting the time stamp interfaces \n");
-                            myDumper[i].setGetter(&myGetMotPwm);
-                        }
+                    myDumper[i].setDevice(&ddBoard, &ddDebug, rate, portPrefix, dataToDump[i], logToFile);
+                    myDumper[i].setThetaMap(thetaMap, nJoints);
+                    myDumper[i].setGetter(getter);
                 }
             }
         Time::delay(1);
@@ -892,17 +754,31 @@ public:
 
     virtual bool updateModule()
     {
+        if (myRecorder && (Time::now()-lastStatsTime>=5.0))
+        {
+            myRecorder->printStats();
+            lastStatsTime=Time::now();
+        }
         return true;
     }
 
     virtual bool close()
     {
         yInfo("Stopping dumper class\n");
-        for(int i = 0; i < nData; i++)
-            myDumper[i].stop();
+        if (myRecorder)
+        {
+            myRecorder->stop();
+            delete myRecorder;
+        }
+
+        if (myDumper)
+        {
+            for(int i = 0; i < nData; i++)
+                myDumper[i].stop();
 
-        yInfo("Deleting dumper class\n");
-        delete[] myDumper;
+            yInfo("Deleting dumper class\n");
+            delete[] myDumper;
+        }
 
         //finally close the dd of the remote control board
         yInfo("Closing the device driver\n");
@@ -962,11 +838,19 @@ int main(int argc, char *argv[])
         printf (" getTemperatures         (motor temperatures)\n");
         printf ("\n3) controlBoardDumper --robot icub --part left_arm --rate 10  --joints \"(0 1 2)\" --dataToDumpAll\n");
         printf ("   All data from the controlBoarWrapper will be dumped, including data from the debugInterface (getRotorxxx).\n");
-        printf ("\n --logToFile can be used to create log files storing the data\n\n");
+        printf ("\n --logToFile can be used to create log files storing the data\n");
+        printf ("\n4) controlBoardDumper --robot icub --part left_arm --rate 1 --joints \"(0 1 2)\" --binaryLog [file] [--ringSize n]\n");
+        printf ("   A single thread samples all the selected data and a background writer stores them in a binary log;\n");
+        printf ("   no data ports are opened. Sampling jitter and dropped ticks are reported periodically.\n");
+        printf ("\n5) controlBoardDumper --exportBinaryLog file\n");
+        printf ("   Converts a binary log into the text files produced by --logToFile.\n\n");
 
         return 0;
     }
 
+    if (rf.check("exportBinaryLog"))
+        return (exportBinaryLog(rf.find("exportBinaryLog").asString()) ? 0 : 1);
+
     if (!yarp.checkNetwork())
     {
         yError()<<"YARP server not available!";
@@ -0,0 +1,365 @@
+/*
+ * Copyright (C) 2022 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+
+#include <yarp/os/Bottle.h>
+#include <yarp/os/Time.h>
+#include <yarp/os/Log.h>
+
+#include "recorderThread.h"
+
+
+/************************************************************************/
+sampleRing::sampleRing() : capacity(0), recordLen(0), head(0), tail(0)
+{
+}
+
+
+/************************************************************************/
+void sampleRing::resize(size_t records, size_t recordLen)
+{
+    // one slot is kept free to tell full from empty
+    this->capacity=records+1;
+    this->recordLen=recordLen;
+    buffer.assign(capacity*recordLen,0.0);
+    head=tail=0;
+}
+
+
+/************************************************************************/
+double *sampleRing::beginWrite()
+{
+    size_t h=head.load(std::memory_order_relaxed);
+    if ((h+1)%capacity==tail.load(std::memory_order_acquire))
+        return nullptr;
+
+    return &buffer[h*recordLen];
+}
+
+
+/************************************************************************/
+void sampleRing::commitWrite()
+{
+    size_t h=head.load(std::memory_order_relaxed);
+    head.store((h+1)%capacity,std::memory_order_release);
+}
+
+
+/************************************************************************/
+const double *sampleRing::beginRead()
+{
+    size_t t=tail.load(std::memory_order_relaxed);
+    if (t==head.load(std::memory_order_acquire))
+        return nullptr;
+
+    return &buffer[t*recordLen];
+}
+
+
+/************************************************************************/
+void sampleRing::commitRead()
+{
+    size_t t=tail.load(std::memory_order_relaxed);
+    tail.store((t+1)%capacity,std::memory_order_release);
+}
+
+
+/************************************************************************/
+binaryLogWriter::binaryLogWriter(sampleRing &r) : ring(r), file(NULL), written(0)
+{
+}
+
+
+/************************************************************************/
+bool binaryLogWriter::open(const std::string &fileName, const std::vector<std::string> &channels,
+                           const int *map, int nJoints, double period)
+{
+    file=fopen(fileName.c_str(),"wb");
+    if (file==NULL)
+    {
+        yError("error opening binary log: %s\n",fileName.c_str());
+        return false;
+    }
+
+    int32_t nChannels=(int32_t)channels.size();
+    int32_t nj=(int32_t)nJoints;
+    fwrite(CBD_BINLOG_MAGIC,1,CBD_BINLOG_MAGIC_LEN,file);
+    fwrite(&nChannels,sizeof(int32_t),1,file);
+    fwrite(&nj,sizeof(int32_t),1,file);
+    fwrite(&period,sizeof(double),1,file);
+    for (int i=0; i<nJoints; i++)
+    {
+        int32_t j=(int32_t)map[i];
+        fwrite(&j,sizeof(int32_t),1,file);
+    }
+    for (size_t i=0; i<channels.size(); i++)
+    {
+        int32_t len=(int32_t)channels[i].length();
+        fwrite(&len,sizeof(int32_t),1,file);
+        fwrite(channels[i].c_str(),1,len,file);
+    }
+
+    written=0;
+    return true;
+}
+
+
+/************************************************************************/
+void binaryLogWriter::flush()
+{
+    size_t len=ring.getRecordLen();
+    while (const double *rec=ring.beginRead())
+    {
+        fwrite(rec,sizeof(double),len,file);
+        ring.commitRead();
+        written++;
+    }
+}
+
+
+/************************************************************************/
+void binaryLogWriter::run()
+{
+    while (!isStopping())
+    {
+        flush();
+        Time::delay(0.005);
+    }
+
+    // drain what the sampler produced before stopping
+    flush();
+    fclose(file);
+    file=NULL;
+}
+
+
+/************************************************************************/
+boardRecorderThread::boardRecorderThread() : PeriodicThread(0.5), period(0.5),
+                                             writer(ring)
+{
+    tick=0.0;
+    lastTime=-1.0;
+    dtSum=dtSum2=maxJitter=0.0;
+    dtCnt=0;
+    missedTicks=0;
+    droppedRecords=0;
+}
+
+
+/************************************************************************/
+boardRecorderThread::~boardRecorderThread()
+{
+}
+
+
+/************************************************************************/
+void boardRecorderThread::addChannel(const std::string &name, GetData *g)
+{
+    names.push_back(name);
+    getters.push_back(g);
+}
+
+
+/************************************************************************/
+bool boardRecorderThread::setup(int rate, int nAxes, const int *map, int nMap,
+                                const std::string &fileName, int ringSize)
+{
+    for (int i=0; i<nMap; i++)
+    {
+        if ((map[i]<0) || (map[i]>=nAxes))
+        {
+            yError("joint %d out of range [0,%d)\n",map[i],nAxes);
+            return false;
+        }
+    }
+
+    dataMap.assign(map,map+nMap);
+
+    // getters write the whole part, except the mode getters that
+    // fill one entry per dumped joint
+    data.assign(std::max(nAxes,nMap),0.0);
+
+    ring.resize(std::max(ringSize,2),CBD_BINLOG_RECORD_HDR+names.size()*dataMap.size());
+    logFileName=fileName;
+
+    period=(double)rate/1000.0;
+    return setPeriod(period);
+}
+
+
+/************************************************************************/
+bool boardRecorderThread::threadInit()
+{
+    if (!writer.open(logFileName,names,dataMap.data(),(int)dataMap.size(),period))
+        return false;
+
+    yInfo("binary log opened: %s\n",logFileName.c_str());
+    return writer.start();
+}
+
+
+/************************************************************************/
+void boardRecorderThread::run()
+{
+    double now=Time::now();
+
+    double *rec=ring.beginWrite();
+    if (rec!=nullptr)
+    {
+        Stamp stmp(-1,0.0);
+        bool stamped=false;
+
+        double *dst=rec+CBD_BINLOG_RECORD_HDR;
+        for (size_t c=0; c<getters.size(); c++)
+        {
+            getters[c]->getData(data.data());
+            if (!stamped)
+                stamped=getters[c]->getStamp(stmp) && stmp.isValid();
+
+            for (size_t i=0; i<dataMap.size(); i++)
+                *dst++=data[dataMap[i]];
+        }
+
+        if (!stamped)
+            stmp=Stamp(-1,0.0);
+
+        rec[0]=tick;
+        rec[1]=stmp.getCount();
+        rec[2]=stmp.getTime();
+        ring.commitWrite();
+    }
+
+    std::lock_guard<std::mutex> lck(mtx);
+    if (rec==nullptr)
+        droppedRecords++;
+
+    if (lastTime>0.0)
+    {
+        double dt=now-lastTime;
+        dtSum+=dt;
+        dtSum2+=dt*dt;
+        dtCnt++;
+        maxJitter=std::max(maxJitter,fabs(dt-period));
+
+        int elapsedTicks=(int)floor(dt/period+0.5);
+        if (elapsedTicks>1)
+            missedTicks+=elapsedTicks-1;
+    }
+    lastTime=now;
+    tick+=1.0;
+}
+
+
+/************************************************************************/
+void boardRecorderThread::threadRelease()
+{
+    writer.stop();
+    printStats();
+    yInfo("binary log closed: %s (%d records)\n",logFileName.c_str(),
+          (int)writer.getWrittenRecords());
+}
+
+
+/************************************************************************/
+void boardRecorderThread::printStats()
+{
+    std::lock_guard<std::mutex> lck(mtx);
+    double mean=(dtCnt>0)?dtSum/dtCnt:0.0;
+    double sd=(dtCnt>1)?sqrt(std::max(0.0,dtSum2/dtCnt-mean*mean)):0.0;
+
+    yInfo("recorder: ticks=%d period=%.3f[ms] mean=%.3f[ms] std=%.3f[ms] max_jitter=%.3f[ms] missed_ticks=%d dropped_records=%d written=%d\n",
+          (int)tick,1e3*period,1e3*mean,1e3*sd,1e3*maxJitter,(int)missedTicks,
+          (int)droppedRecords,(int)writer.getWrittenRecords());
+}
+
+
+/************************************************************************/
+bool exportBinaryLog(const std::string &fileName)
+{
+    FILE *in=fopen(fileName.c_str(),"rb");
+    if (in==NULL)
+    {
+        yError("unable to open %s\n",fileName.c_str());
+        return false;
+    }
+
+    char magic[CBD_BINLOG_MAGIC_LEN];
+    int32_t nChannels=0,nJoints=0;
+    double period=0.0;
+    bool ok=(fread(magic,1,CBD_BINLOG_MAGIC_LEN,in)==CBD_BINLOG_MAGIC_LEN) &&
+            (memcmp(magic,CBD_BINLOG_MAGIC,CBD_BINLOG_MAGIC_LEN)==0);
+    ok=ok && (fread(&nChannels,sizeof(int32_t),1,in)==1);
+    ok=ok && (fread(&nJoints,sizeof(int32_t),1,in)==1);
+    ok=ok && (fread(&period,sizeof(double),1,in)==1);
+    ok=ok && (nChannels>0) && (nJoints>0);
+    if (!ok)
+    {
+        yError("%s is not a valid controlBoardDumper binary log\n",fileName.c_str());
+        fclose(in);
+        return false;
+    }
+
+    std::vector<int32_t> joints(nJoints);
+    ok=(fread(joints.data(),sizeof(int32_t),nJoints,in)==(size_t)nJoints);
+
+    std::vector<FILE*> out(nChannels,(FILE*)NULL);
+    for (int32_t c=0; ok && (c<nChannels); c++)
+    {
+        int32_t len=0;
+        ok=(fread(&len,sizeof(int32_t),1,in)==1) && (len>0) && (len<1024);
+        if (!ok)
+            break;
+
+        std::string name(len,'\0');
+        ok=(fread(&name[0],1,len,in)==(size_t)len);
+        if (!ok)
+            break;
+
+        // same naming scheme used by boardDumperThread::threadInit()
+        std::replace(name.begin(),name.end(),'/','_');
+        name+=".log";
+        out[c]=fopen(name.c_str(),"w");
+        if (out[c]==NULL)
+        {
+            yError("unable to create %s\n",name.c_str());
+            ok=false;
+        }
+        else
+            yInfo("exporting to %s\n",name.c_str());
+    }
+
+    size_t records=0;
+    if (ok)
+    {
+        std::vector<double> rec(CBD_BINLOG_RECORD_HDR+nChannels*nJoints);
+        while (fread(rec.data(),sizeof(double),rec.size(),in)==rec.size())
+        {
+            const double *src=rec.data()+CBD_BINLOG_RECORD_HDR;
+            for (int32_t c=0; c<nChannels; c++)
+            {
+                Bottle bData;
+                for (int32_t i=0; i<nJoints; i++)
+                    bData.addFloat64(*src++);
+
+                fprintf(out[c],"%d %f %s\n",(int)rec[1],rec[2],bData.toString().c_str());
+            }
+            records++;
+        }
+        yInfo("exported %d records\n",(int)records);
+    }
+
+    for (size_t c=0; c<out.size(); c++)
+        if (out[c]!=NULL)
+            fclose(out[c]);
+
+    fclose(in);
+    return ok;
+}
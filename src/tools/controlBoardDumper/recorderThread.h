@@ -0,0 +1,124 @@
+/*
+ * Copyright (C) 2022 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef __CONTROLBOARDDUMPER_RECORDERTHREAD_H__
+#define __CONTROLBOARDDUMPER_RECORDERTHREAD_H__
+
+#include <string>
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <cstdio>
+#include <cstdint>
+
+#include <yarp/os/Thread.h>
+#include <yarp/os/PeriodicThread.h>
+
+#include "genericControlBoardDumper.h"
+
+/*
+ * Binary log layout (native endianness):
+ *
+ *   header : char magic[8] = "CBDBIN01"
+ *            int32 nChannels, int32 nJoints
+ *            float64 period [s]
+ *            int32 joints[nJoints]
+ *            nChannels times: int32 len, char name[len]
+ *   records: float64 tick, float64 stampCount, float64 stampTime,
+ *            float64 data[nChannels][nJoints]
+ */
+#define CBD_BINLOG_MAGIC        "CBDBIN01"
+#define CBD_BINLOG_MAGIC_LEN    8
+#define CBD_BINLOG_RECORD_HDR   3
+
+
+// Single-producer/single-consumer ring of fixed-size records,
+// entirely allocated at configuration time.
+class sampleRing
+{
+public:
+    sampleRing();
+    void resize(size_t records, size_t recordLen);
+
+    double *beginWrite();       // null if the ring is full
+    void    commitWrite();
+    const double *beginRead();  // null if the ring is empty
+    void    commitRead();
+
+    size_t getRecordLen() const { return recordLen; }
+
+private:
+    std::vector<double> buffer;
+    size_t capacity;
+    size_t recordLen;
+    std::atomic<size_t> head;
+    std::atomic<size_t> tail;
+};
+
+
+class binaryLogWriter: public Thread
+{
+public:
+    binaryLogWriter(sampleRing &r);
+    bool open(const std::string &fileName, const std::vector<std::string> &channels,
+              const int *map, int nJoints, double period);
+    void run();
+    size_t getWrittenRecords() const { return written; }
+
+private:
+    sampleRing &ring;
+    FILE *file;
+    std::atomic<size_t> written;
+
+    void flush();
+};
+
+
+// Samples every requested interface of one part from a single thread
+// and hands fixed-size records over to a background writer.
+class boardRecorderThread: public PeriodicThread
+{
+public:
+    boardRecorderThread();
+    ~boardRecorderThread();
+
+    void addChannel(const std::string &name, GetData *g);
+    bool setup(int rate, int nAxes, const int *map, int nMap,
+               const std::string &fileName, int ringSize);
+
+    bool threadInit();
+    void run();
+    void threadRelease();
+    void printStats();
+
+private:
+    std::vector<std::string> names;
+    std::vector<GetData*> getters;
+    std::vector<int> dataMap;
+    std::vector<double> data;
+    std::string logFileName;
+    double period;
+
+    sampleRing ring;
+    binaryLogWriter writer;
+
+    // timing instrumentation
+    std::mutex mtx;
+    double tick;
+    double lastTime;
+    double dtSum, dtSum2, maxJitter;
+    size_t dtCnt;
+    size_t missedTicks;
+    size_t droppedRecords;
+};
+
+
+// Converts a binary log into the per-data text files produced with --logToFile.
+bool exportBinaryLog(const std::string &fileName);
+
+#endif
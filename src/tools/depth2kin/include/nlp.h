@@ -19,19 +19,31 @@
 #define __DEPTH2KIN_NLP_H__
 
 #include <string>
-#include <deque>
+#include <vector>
 
 #include <yarp/sig/all.h>
 
+#include <IpoptConfig.h>
 #include <IpIpoptApplication.hpp>
 
 #define ALIGN_IPOPT_MAX_ITER    300
+#define ALIGN_EVAL_CHUNK        256
+
+// MUMPS calls are serialized by Ipopt from 3.14 onward,
+// so that independent solvers can run concurrently
+#if (IPOPT_VERSION_MAJOR>3) || ((IPOPT_VERSION_MAJOR==3) && (IPOPT_VERSION_MINOR>=14))
+    #define ALIGN_CONCURRENT_SOLVERS
+#endif
 
 
 /****************************************************************/
 yarp::sig::Matrix computeH(const yarp::sig::Vector &x);
 
 
+/****************************************************************/
+class EvalPool;
+
+
 /****************************************************************/
 class EyeAligner
 {
@@ -41,10 +53,18 @@ protected:
     yarp::sig::Vector x0;
     yarp::sig::Matrix Prj;
 
-    std::deque<yarp::sig::Vector> p2d;
-    std::deque<yarp::sig::Vector> p3d;
+    // samples packed contiguously as (u,v) and (x,y,z,1)
+    std::vector<double> p2d;
+    std::vector<double> p3d;
+
+    int numStarts;
+    int numThreads;
 
-    double evalError(const yarp::sig::Matrix &H);
+    double evalError(const yarp::sig::Matrix &H, EvalPool &pool);
+    yarp::sig::Vector getStartingPoint(const int k) const;
+    bool solve(const yarp::sig::Vector &x0, const int max_iter, const int print_level,
+               const std::string &derivative_test, EvalPool &pool,
+               yarp::sig::Vector &x) const;
 
 public:
     EyeAligner();
@@ -55,6 +75,11 @@ public:
     void clearPoints();
     size_t getNumPoints() const;
     bool setInitialGuess(const yarp::sig::Matrix &H);
+    void setNumStarts(const int numStarts);
+    int getNumStarts() const;
+    void setNumThreads(const int numThreads);
+    int getNumThreads() const;
+    double evalError(const yarp::sig::Matrix &H, const int threads=1);
     bool calibrate(yarp::sig::Matrix &H, double &error, const int max_iter=ALIGN_IPOPT_MAX_ITER,
                    const int print_level=0, const std::string &derivative_test="none");
 };
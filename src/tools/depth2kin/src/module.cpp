@@ -24,6 +24,7 @@
 #include <limits>
 #include <algorithm>
 #include <utility>
+#include <thread>
 
 #include <yarp/cv/Cv.h>
 #include <opencv2/imgproc/imgproc_c.h>
@@ -874,6 +875,100 @@ void CalibModule::doTest()
 
             yInfo("#3c \"check logging data\"");
             ok&=log("experts");
+
+            break;
+        }
+
+        //*******************
+        case 4:
+        {
+            yInfo("#4a \"check parallel evaluation against serial one\"");
+            yInfo("#4b \"check multi-start alignment\"");
+
+            vector<pair<Vector,Vector>> samples;
+
+            // recorded data given as rows "u v x y z", or synthetic data
+            string fileName=rf->check("test_file",Value("")).asString();
+            if (!fileName.empty())
+            {
+                ifstream fin(fileName.c_str());
+                Vector p2d(2),p3d(4,1.0);
+                while (fin>>p2d[0]>>p2d[1]>>p3d[0]>>p3d[1]>>p3d[2])
+                {
+                    aligner.addPoints(p2d,p3d);
+                    samples.push_back(make_pair(p2d,p3d));
+                }
+                yInfo("loaded %d points from file %s",
+                      (int)aligner.getNumPoints(),fileName.c_str());
+            }
+            else
+            {
+                Matrix Prj=aligner.getProjection();
+                for (int i=0; i<5000; i++)
+                {
+                    Vector p3d(4);
+                    p3d[0]=Rand::scalar(-0.5,0.5);
+                    p3d[1]=Rand::scalar(-0.5,0.5);
+                    p3d[2]=Rand::scalar(0.1,1.0);
+                    p3d[3]=1.0;
+
+                    Vector p2d=Prj*invH*p3d;
+                    p2d=p2d/p2d[2];
+                    p2d.pop_back();
+                    p2d+=NormRand::vector(2,0.0,5.0);
+
+                    aligner.addPoints(p2d,p3d);
+                    samples.push_back(make_pair(p2d,p3d));
+                }
+            }
+
+            int starts=aligner.getNumStarts();
+            int threads=aligner.getNumThreads();
+
+            Matrix H1,H2,H3; double error1,error2,error3;
+            aligner.setNumStarts(1);
+            aligner.setNumThreads(1);
+            double t0=Time::now();
+            bool ok1=aligner.calibrate(H1,error1);
+            double t1=Time::now()-t0;
+
+            aligner.setNumThreads(threads);
+            t0=Time::now();
+            bool ok2=aligner.calibrate(H2,error2);
+            double t2=Time::now()-t0;
+
+            aligner.setNumStarts(std::max(starts,4));
+            t0=Time::now();
+            bool ok3=aligner.calibrate(H3,error3);
+            double t3=Time::now()-t0;
+
+            yInfo("serial:      error=%g; time=%g [s]",error1,t1);
+            yInfo("parallel:    error=%g; time=%g [s]",error2,t2);
+            yInfo("multi-start: error=%g; time=%g [s] (%d starts)",
+                  error3,t3,aligner.getNumStarts());
+            yInfo("solution_H\n%s",H3.toString(5,5).c_str());
+
+            // the chunked evaluation against the plain per-sample error
+            Matrix PrjH=aligner.getProjection()*SE3inv(H3);
+            double error=0.0;
+            for (auto &s:samples)
+            {
+                Vector p=PrjH*s.second;
+                error+=norm(s.first-p.subVector(0,1)/p[2]);
+            }
+            error/=std::max((size_t)1,samples.size());
+            double error_serial=aligner.evalError(H3,1);
+            double error_parallel=aligner.evalError(H3,std::max(threads,4));
+            yInfo("evaluation:  per-sample=%g; serial=%g; parallel=%g",
+                  error,error_serial,error_parallel);
+
+            // the single start does not depend on the number of threads,
+            // whereas the multi-start result is not compared against the
+            // single start since the best start is ranked by convergence
+            // first and only then by error
+            ok=ok1 && ok2 && ok3 && (H1==H2) && (error1==error2) &&
+               (error_serial==error_parallel) &&
+               (fabs(error_serial-error)<=1e-9*std::max(1.0,error));
         }
     }
 
@@ -928,6 +1023,8 @@ bool CalibModule::configure(ResourceFinder &rf)
     min[5]=-CTRL_DEG2RAD*15.0; max[5]=CTRL_DEG2RAD*15.0;    // yaw
     aligner.setBounds(min,max);
     aligner.setInitialGuess(eye(4,4));
+    aligner.setNumStarts(rf.check("aligner_starts",Value(1)).asInt32());
+    aligner.setNumThreads(rf.check("threads",Value(0)).asInt32());
 
     if (test>=0)
     {
@@ -1409,10 +1506,18 @@ string CalibModule::getCalibrationType()
 Property CalibModule::calibrate(const bool rm_outliers)
 {
     lock_guard<mutex> lck(mtx);
-    double error;
+    double error,errorAligner;
     Matrix H;
     Property reply;
 
+    // the eyes alignment does not depend on the experts,
+    // hence the two fits can run side by side
+    thread alignerThread;
+#ifdef ALIGN_CONCURRENT_SOLVERS
+    if (exp_depth2kin && exp_aligneyes)
+        alignerThread=thread([&]() { aligner.calibrate(H,errorAligner); });
+#endif
+
     if (exp_depth2kin)
     {
         if (rm_outliers)
@@ -1425,8 +1530,11 @@ Property CalibModule::calibrate(const bool rm_outliers)
 
     if (exp_aligneyes)
     {
-        aligner.calibrate(H,error);
-        reply.put("aligner",error);
+        if (alignerThread.joinable())
+            alignerThread.join();
+        else
+            aligner.calibrate(H,errorAligner);
+        reply.put("aligner",errorAligner);
 
         Matrix HL,HR;
         if (getGazeParams("left","extrinsics",HL) && getGazeParams("right","extrinsics",HR))
@@ -18,7 +18,12 @@
 #include <cmath>
 #include <algorithm>
 #include <string>
-#include <deque>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
 
 #include <yarp/sig/all.h>
 #include <yarp/dev/all.h>
@@ -57,26 +62,198 @@ Matrix computeH(const Ipopt::Number *x)
 }
 
 
+/****************************************************************/
+void packProjection(const Matrix &M, double *m)
+{
+    for (int r=0; r<3; r++)
+        for (int c=0; c<4; c++)
+            m[4*r+c]=M(r,c);
+}
+
+
+/****************************************************************/
+void evalChunk(const double *p2d, const double *p3d, const size_t begin,
+               const size_t end, const double *PrjH, const double *dPrjH,
+               const bool squared, double *acc)
+{
+    for (size_t i=begin; i<end; i++)
+    {
+        const double *m=p2d+2*i;
+        const double *q=p3d+4*i;
+
+        double u_num=PrjH[0]*q[0]+PrjH[1]*q[1]+PrjH[2]*q[2]+PrjH[3]*q[3];
+        double v_num=PrjH[4]*q[0]+PrjH[5]*q[1]+PrjH[6]*q[2]+PrjH[7]*q[3];
+        double lambda=PrjH[8]*q[0]+PrjH[9]*q[1]+PrjH[10]*q[2]+PrjH[11]*q[3];
+
+        double du=m[0]-u_num/lambda;
+        double dv=m[1]-v_num/lambda;
+        double d2=du*du+dv*dv;
+        acc[0]+=(squared?d2:sqrt(d2));
+
+        if (dPrjH!=NULL)
+        {
+            double lambda2=lambda*lambda;
+            for (int j=0; j<6; j++)
+            {
+                const double *D=dPrjH+12*j;
+                double du_num=D[0]*q[0]+D[1]*q[1]+D[2]*q[2]+D[3]*q[3];
+                double dv_num=D[4]*q[0]+D[5]*q[1]+D[6]*q[2]+D[7]*q[3];
+                double tmp_dot=D[8]*q[0]+D[9]*q[1]+D[10]*q[2]+D[11]*q[3];
+
+                double dp2d_u=(du_num*lambda-tmp_dot*u_num)/lambda2;
+                double dp2d_v=(dv_num*lambda-tmp_dot*v_num)/lambda2;
+                acc[1+j]-=2.0*(du*dp2d_u+dv*dp2d_v);
+            }
+        }
+    }
+}
+
+
+/****************************************************************/
+class EvalPool
+{
+protected:
+    vector<thread> helpers;
+    mutex mtx;
+    condition_variable cvStart;
+    condition_variable cvDone;
+    function<void(const size_t)> job;
+    size_t round;
+    size_t busy;
+    bool quit;
+
+    /****************************************************************/
+    void loop(const size_t id)
+    {
+        size_t seen=0;
+        unique_lock<mutex> lck(mtx);
+        while (true)
+        {
+            cvStart.wait(lck,[&](){ return quit || (round!=seen); });
+            if (quit)
+                break;
+
+            // the job is not touched by run() until all the helpers are done
+            seen=round;
+            lck.unlock();
+            job(id);
+            lck.lock();
+            if (--busy==0)
+                cvDone.notify_one();
+        }
+    }
+
+public:
+    /****************************************************************/
+    EvalPool(const int threads) : round(0), busy(0), quit(false)
+    {
+        for (int t=1; t<threads; t++)
+            helpers.push_back(thread(&EvalPool::loop,this,(size_t)t));
+    }
+
+    /****************************************************************/
+    size_t size() const
+    {
+        return helpers.size()+1;
+    }
+
+    /****************************************************************/
+    void run(const function<void(const size_t)> &job)
+    {
+        // job(0) runs in the calling thread, job(1..size()-1) in the helpers
+        if (helpers.empty())
+        {
+            job(0);
+            return;
+        }
+
+        {
+            lock_guard<mutex> lck(mtx);
+            this->job=job;
+            busy=helpers.size();
+            round++;
+        }
+        cvStart.notify_all();
+
+        job(0);
+
+        unique_lock<mutex> lck(mtx);
+        cvDone.wait(lck,[&](){ return (busy==0); });
+    }
+
+    /****************************************************************/
+    virtual ~EvalPool()
+    {
+        {
+            lock_guard<mutex> lck(mtx);
+            quit=true;
+        }
+        cvStart.notify_all();
+
+        for (auto &h:helpers)
+            h.join();
+    }
+};
+
+
+/****************************************************************/
+void evalSamples(const vector<double> &p2d, const vector<double> &p3d,
+                 const double *PrjH, const double *dPrjH, const bool squared,
+                 EvalPool &pool, double *res)
+{
+    // samples are reduced in chunks of fixed size whose partial sums
+    // are added up in order, so that the result does not depend on
+    // the number of threads; each thread is given at least 8 chunks
+    // to pay off its wake-up
+    size_t N=p2d.size()/2;
+    size_t nChunks=(N+ALIGN_EVAL_CHUNK-1)/ALIGN_EVAL_CHUNK;
+    vector<double> acc(7*nChunks,0.0);
+
+    size_t nThreads=std::max((size_t)1,std::min(pool.size(),nChunks/8));
+    size_t stride=(nChunks+nThreads-1)/nThreads;
+
+    auto worker=[&](const size_t t)
+    {
+        for (size_t c=std::min(nChunks,t*stride); c<std::min(nChunks,(t+1)*stride); c++)
+            evalChunk(p2d.data(),p3d.data(),c*ALIGN_EVAL_CHUNK,
+                      std::min(N,(c+1)*ALIGN_EVAL_CHUNK),
+                      PrjH,dPrjH,squared,&acc[7*c]);
+    };
+
+    if (nThreads>1)
+        pool.run(worker);
+    else
+        worker(0);
+
+    for (int j=0; j<7; j++)
+        res[j]=0.0;
+    for (size_t c=0; c<nChunks; c++)
+        for (int j=0; j<7; j++)
+            res[j]+=acc[7*c+j];
+}
+
+
 /****************************************************************/
 class EyeAlignerNLP : public Ipopt::TNLP
 {
 protected:
-    const deque<Vector> &p2d;
-    const deque<Vector> &p3d;
-    const Matrix        &Prj;
+    const vector<double> &p2d;
+    const vector<double> &p3d;
+    const Matrix         &Prj;
 
     Vector min;
     Vector max;    
     Vector x0;
     Vector x;
+    EvalPool &pool;
 
 public:
     /****************************************************************/
-    EyeAlignerNLP(const deque<Vector> &_p2d,
-                  const deque<Vector> &_p3d,
+    EyeAlignerNLP(const vector<double> &_p2d,
+                  const vector<double> &_p3d,
                   const Vector &_min, const Vector &_max,
-                  const Matrix &_Prj) :
-                  p2d(_p2d), p3d(_p3d), Prj(_Prj)
+                  const Matrix &_Prj, EvalPool &_pool) :
+                  p2d(_p2d), p3d(_p3d), Prj(_Prj), pool(_pool)
     {
         min=_min;
         max=_max;
@@ -136,21 +313,16 @@ public:
     bool eval_f(Ipopt::Index n, const Ipopt::Number *x, bool new_x,
                 Ipopt::Number &obj_value)
     {
-        Matrix PrjH=Prj*SE3inv(computeH(x));
+        double PrjH[12];
+        packProjection(Prj*SE3inv(computeH(x)),PrjH);
 
         obj_value=0.0;
-        if (p2d.size()>0)
+        size_t N=p2d.size()/2;
+        if (N>0)
         {
-            for (size_t i=0; i<p2d.size(); i++)
-            {
-                Vector p2di=PrjH*p3d[i];
-                p2di=p2di/p2di[2];
-                p2di.pop_back();
-
-                obj_value+=norm2(p2d[i]-p2di);
-            }
-
-            obj_value/=p2d.size();
+            double res[7];
+            evalSamples(p2d,p3d,PrjH,NULL,true,pool,res);
+            obj_value=res[0]/N;
         }
 
         return true;
@@ -192,74 +364,26 @@ public:
         Matrix dHdx3=dRx.transposed()*invRy*invRz; dHdx3.setCol(3,dHdx3*p);
         Matrix dHdx4=invRx*dRy.transposed()*invRz; dHdx4.setCol(3,dHdx4*p);
         Matrix dHdx5=invRx*invRy*dRz.transposed(); dHdx5.setCol(3,dHdx5*p);
-        
-        Matrix dPrjHdx0=Prj*dHdx0;
-        Matrix dPrjHdx1=Prj*dHdx1;
-        Matrix dPrjHdx2=Prj*dHdx2;
-        Matrix dPrjHdx3=Prj*dHdx3;
-        Matrix dPrjHdx4=Prj*dHdx4;
-        Matrix dPrjHdx5=Prj*dHdx5;
 
-        Matrix PrjH=Prj*SE3inv(computeH(x));
+        // the per-sample loop runs on the packed rows of the projections
+        double PrjH[12],dPrjH[72];
+        packProjection(Prj*SE3inv(computeH(x)),PrjH);
+        packProjection(Prj*dHdx0,dPrjH);
+        packProjection(Prj*dHdx1,dPrjH+12);
+        packProjection(Prj*dHdx2,dPrjH+24);
+        packProjection(Prj*dHdx3,dPrjH+36);
+        packProjection(Prj*dHdx4,dPrjH+48);
+        packProjection(Prj*dHdx5,dPrjH+60);
 
         grad_f[0]=grad_f[1]=grad_f[2]=0.0;
         grad_f[3]=grad_f[4]=grad_f[5]=0.0;
-        if (p2d.size()>0)
+        size_t N=p2d.size()/2;
+        if (N>0)
         {
-            for (size_t i=0; i<p2d.size(); i++)
-            {
-                Vector p2di=PrjH*p3d[i];
-                p2di=p2di/p2di[2];
-                p2di.pop_back();
-
-                Vector d=p2d[i]-p2di;
-
-                double u_num=dot(PrjH.getRow(0),p3d[i]);
-                double v_num=dot(PrjH.getRow(1),p3d[i]);
-                double lambda=dot(PrjH.getRow(2),p3d[i]);
-                double lambda2=lambda*lambda;
-                double tmp_dot;
-
-                Vector dp2d_dx0(2);
-                tmp_dot=dot(dPrjHdx0.getRow(2),p3d[i]);
-                dp2d_dx0[0]=(dot(dPrjHdx0.getRow(0),p3d[i])*lambda-tmp_dot*u_num)/lambda2;
-                dp2d_dx0[1]=(dot(dPrjHdx0.getRow(1),p3d[i])*lambda-tmp_dot*v_num)/lambda2;
-
-                Vector dp2d_dx1(2);
-                tmp_dot=dot(dPrjHdx1.getRow(2),p3d[i]);
-                dp2d_dx1[0]=(dot(dPrjHdx1.getRow(0),p3d[i])*lambda-tmp_dot*u_num)/lambda2;
-                dp2d_dx1[1]=(dot(dPrjHdx1.getRow(1),p3d[i])*lambda-tmp_dot*v_num)/lambda2;
-
-                Vector dp2d_dx2(2);
-                tmp_dot=dot(dPrjHdx2.getRow(2),p3d[i]);
-                dp2d_dx2[0]=(dot(dPrjHdx2.getRow(0),p3d[i])*lambda-tmp_dot*u_num)/lambda2;
-                dp2d_dx2[1]=(dot(dPrjHdx2.getRow(1),p3d[i])*lambda-tmp_dot*v_num)/lambda2;
-
-                Vector dp2d_dx3(2);
-                tmp_dot=dot(dPrjHdx3.getRow(2),p3d[i]);
-                dp2d_dx3[0]=(dot(dPrjHdx3.getRow(0),p3d[i])*lambda-tmp_dot*u_num)/lambda2;
-                dp2d_dx3[1]=(dot(dPrjHdx3.getRow(1),p3d[i])*lambda-tmp_dot*v_num)/lambda2;
-
-                Vector dp2d_dx4(2);
-                tmp_dot=dot(dPrjHdx4.getRow(2),p3d[i]);
-                dp2d_dx4[0]=(dot(dPrjHdx4.getRow(0),p3d[i])*lambda-tmp_dot*u_num)/lambda2;
-                dp2d_dx4[1]=(dot(dPrjHdx4.getRow(1),p3d[i])*lambda-tmp_dot*v_num)/lambda2;
-
-                Vector dp2d_dx5(2);
-                tmp_dot=dot(dPrjHdx5.getRow(2),p3d[i]);
-                dp2d_dx5[0]=(dot(dPrjHdx5.getRow(0),p3d[i])*lambda-tmp_dot*u_num)/lambda2;
-                dp2d_dx5[1]=(dot(dPrjHdx5.getRow(1),p3d[i])*lambda-tmp_dot*v_num)/lambda2;
-
-                grad_f[0]-=2.0*dot(d,dp2d_dx0);
-                grad_f[1]-=2.0*dot(d,dp2d_dx1);
-                grad_f[2]-=2.0*dot(d,dp2d_dx2);
-                grad_f[3]-=2.0*dot(d,dp2d_dx3);
-                grad_f[4]-=2.0*dot(d,dp2d_dx4);
-                grad_f[5]-=2.0*dot(d,dp2d_dx5);
-            }
-
+            double res[7];
+            evalSamples(p2d,p3d,PrjH,dPrjH,true,pool,res);
             for (Ipopt::Index i=0; i<n; i++)
-                grad_f[i]/=p2d.size();
+                grad_f[i]=res[1+i]/N;
         }
 
         return true;
@@ -308,7 +432,7 @@ public:
 
 
 /****************************************************************/
-EyeAligner::EyeAligner() : Prj(eye(3,4))
+EyeAligner::EyeAligner() : Prj(eye(3,4)), numStarts(1), numThreads(0)
 {
     min.resize(6); max.resize(6);
     min[0]=-1.0;   max[0]=1.0;
@@ -324,26 +448,81 @@ EyeAligner::EyeAligner() : Prj(eye(3,4))
 
 
 /****************************************************************/
-double EyeAligner::evalError(const Matrix &H)
+double EyeAligner::evalError(const Matrix &H, const int threads)
 {
-    Matrix PrjH=Prj*SE3inv(H);
+    EvalPool pool(threads);
+    return evalError(H,pool);
+}
+
+
+/****************************************************************/
+double EyeAligner::evalError(const Matrix &H, EvalPool &pool)
+{
+    double PrjH[12];
+    packProjection(Prj*SE3inv(H),PrjH);
 
     double error=0.0;
-    if (p2d.size()>0)
+    size_t N=getNumPoints();
+    if (N>0)
     {
-        for (size_t i=0; i<p2d.size(); i++)
-        {
-            Vector p2di=PrjH*p3d[i];
-            p2di=p2di/p2di[2];
-            p2di.pop_back();
+        double res[7];
+        evalSamples(p2d,p3d,PrjH,NULL,false,pool,res);
+        error=res[0]/N;
+    }
+
+    return error;
+}
 
-            error+=norm(p2d[i]-p2di);
+
+/****************************************************************/
+Vector EyeAligner::getStartingPoint(const int k) const
+{
+    if (k<=0)
+        return x0;
+
+    // further starts are spread within the bounds
+    // according to the Halton sequence
+    const int base[]={2, 3, 5, 7, 11, 13};
+    Vector x(x0.length());
+    for (size_t i=0; i<x.length(); i++)
+    {
+        double f=1.0,r=0.0;
+        for (int j=k; j>0; j/=base[i])
+        {
+            f/=base[i];
+            r+=f*(j%base[i]);
         }
 
-        error/=p2d.size();
+        x[i]=min[i]+r*(max[i]-min[i]);
     }
 
-    return error;
+    return x;
+}
+
+
+/****************************************************************/
+bool EyeAligner::solve(const Vector &x0, const int max_iter, const int print_level,
+                       const string &derivative_test, EvalPool &pool, Vector &x) const
+{
+    Ipopt::SmartPtr<Ipopt::IpoptApplication> app=new Ipopt::IpoptApplication;
+    app->Options()->SetNumericValue("tol",1e-8);
+    app->Options()->SetIntegerValue("acceptable_iter",0);
+    app->Options()->SetStringValue("mu_strategy","adaptive");
+    app->Options()->SetIntegerValue("max_iter",max_iter);
+    app->Options()->SetStringValue("nlp_scaling_method","gradient-based");
+    app->Options()->SetStringValue("hessian_approximation","limited-memory");
+    app->Options()->SetIntegerValue("print_level",print_level);
+    app->Options()->SetStringValue("derivative_test",derivative_test.c_str());
+    app->Options()->SetStringValue("derivative_test_print_all","yes");
+    app->Initialize();
+
+    Ipopt::SmartPtr<EyeAlignerNLP> nlp=new EyeAlignerNLP(p2d,p3d,min,max,Prj,pool);
+
+    nlp->set_x0(x0);
+    Ipopt::ApplicationReturnStatus status=app->OptimizeTNLP(GetRawPtr(nlp));
+
+    x=nlp->get_result();
+    return (status==Ipopt::Solve_Succeeded);
 }
 
 
@@ -386,8 +565,8 @@ bool EyeAligner::addPoints(const Vector &p2di, const Vector &p3di)
 {
     if ((p2di.length()>=2) && (p3di.length()>=4))
     {
-        p2d.push_back(p2di.subVector(0,1));
-        p3d.push_back(p3di.subVector(0,3));
+        p2d.insert(p2d.end(),p2di.data(),p2di.data()+2);
+        p3d.insert(p3d.end(),p3di.data(),p3di.data()+4);
 
         return true;
     }
@@ -407,7 +586,7 @@ void EyeAligner::clearPoints()
 /****************************************************************/
 size_t EyeAligner::getNumPoints() const
 {
-    return p2d.size();
+    return p2d.size()/2;
 }
 
 
@@ -430,34 +609,91 @@ bool EyeAligner::setInitialGuess(const Matrix &H)
 }
 
 
+/****************************************************************/
+void EyeAligner::setNumStarts(const int numStarts)
+{
+    this->numStarts=std::max(numStarts,1);
+}
+
+
+/****************************************************************/
+int EyeAligner::getNumStarts() const
+{
+    return numStarts;
+}
+
+
+/****************************************************************/
+void EyeAligner::setNumThreads(const int numThreads)
+{
+    this->numThreads=numThreads;
+}
+
+
+/****************************************************************/
+int EyeAligner::getNumThreads() const
+{
+    return numThreads;
+}
+
+
 /****************************************************************/
 bool EyeAligner::calibrate(Matrix &H, double &error, const int max_iter,
                            const int print_level, const string &derivative_test)
 {
-    if (p2d.size()>0)
+    if (getNumPoints()>0)
     {
-        Ipopt::SmartPtr<Ipopt::IpoptApplication> app=new Ipopt::IpoptApplication;
-        app->Options()->SetNumericValue("tol",1e-8);
-        app->Options()->SetIntegerValue("acceptable_iter",0);
-        app->Options()->SetStringValue("mu_strategy","adaptive");
-        app->Options()->SetIntegerValue("max_iter",max_iter);
-        app->Options()->SetStringValue("nlp_scaling_method","gradient-based");
-        app->Options()->SetStringValue("hessian_approximation","limited-memory");
-        app->Options()->SetIntegerValue("print_level",print_level);
-        app->Options()->SetStringValue("derivative_test",derivative_test.c_str());
-        app->Options()->SetStringValue("derivative_test_print_all","yes");
-        app->Initialize();
-
-        Ipopt::SmartPtr<EyeAlignerNLP> nlp=new EyeAlignerNLP(p2d,p3d,min,max,Prj);
-
-        nlp->set_x0(x0);
-        Ipopt::ApplicationReturnStatus status=app->OptimizeTNLP(GetRawPtr(nlp));
-
-        Vector x=nlp->get_result();
-        H=computeH(x);
-        error=evalError(H);
-
-        return (status==Ipopt::Solve_Succeeded);
+        int threads=numThreads;
+        if (threads<=0)
+            threads=std::min(4,std::max(1,(int)thread::hardware_concurrency()));
+
+        // the starts are shared among the available threads, while
+        // the spare ones are left to the evaluation of the samples;
+        // the console output of the solvers would be interleaved,
+        // hence they run one at a time when printing
+    #ifdef ALIGN_CONCURRENT_SOLVERS
+        int solvers=(print_level>0)?1:std::min(numStarts,threads);
+    #else
+        int solvers=1;
+    #endif
+        int evalThreads=std::max(1,threads/solvers);
+
+        vector<Vector> x(numStarts);
+        vector<double> errors(numStarts);
+        vector<char> success(numStarts);
+        atomic<int> next(0);
+
+        // each solver keeps its evaluation threads across the starts
+        auto worker=[&]()
+        {
+            EvalPool pool(evalThreads);
+            for (int k=next++; k<numStarts; k=next++)
+            {
+                success[k]=solve(getStartingPoint(k),max_iter,print_level,
+                                 derivative_test,pool,x[k]);
+                errors[k]=evalError(computeH(x[k]),pool);
+            }
+        };
+
+        vector<thread> workers;
+        for (int i=1; i<solvers; i++)
+            workers.push_back(thread(worker));
+        worker();
+        for (auto &w:workers)
+            w.join();
+
+        // converged solutions come first, then the smallest error;
+        // ties go to the earliest start, which is the initial guess
+        int best=0;
+        for (int k=1; k<numStarts; k++)
+            if ((success[k]>success[best]) ||
+                ((success[k]==success[best]) && (errors[k]<errors[best])))
+                best=k;
+
+        H=computeH(x[best]);
+        error=errors[best];
+
+        return (success[best]!=0);
     }
     else
         return false;
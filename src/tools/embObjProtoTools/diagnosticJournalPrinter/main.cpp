@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+// Prints the diagnostic messages saved by the embObj devices in the journal given by
+// PC104/diagnosticJournal, parsed as yarprobotinterface logs them. The journal holds the
+// messages before any rate limiting. The names of boards and axes are not available offline.
+//
+// diagnosticJournalPrinter --file <journal> [--board 10.0.1.1]
+
+#include <cstdio>
+#include <string>
+
+#include <yarp/os/Property.h>
+
+#include "diagnosticAsyncLogger.h"
+
+using namespace yarp::os;
+using namespace Diagnostic;
+using namespace Diagnostic::LowLevel;
+
+
+static const char * severityName(SeverityOfError severity)
+{
+    switch(severity)
+    {
+        case SeverityOfError::info:     return "INFO";
+        case SeverityOfError::debug:    return "DEBUG";
+        case SeverityOfError::warning:  return "WARNING";
+        case SeverityOfError::error:    return "ERROR";
+        case SeverityOfError::fatal:    return "FATAL";
+        default:                        return "ERROR";
+    }
+}
+
+
+int main(int argc, char *argv[])
+{
+    Property options;
+    options.fromCommand(argc, argv);
+
+    if(!options.check("file"))
+    {
+        printf("usage: diagnosticJournalPrinter --file <journal> [--board <ip address>]\n");
+        return 1;
+    }
+
+    std::string filename = options.find("file").asString();
+    std::string board = options.check("board", Value("")).asString();
+
+    Journal journal;
+    if(!journal.open(filename))
+    {
+        fprintf(stderr, "cannot read %s: it is missing or it is not a diagnostic journal of this version\n", filename.c_str());
+        return 1;
+    }
+
+    Record record;
+    double start = -1.0;
+    size_t count = 0;
+    while(journal.read(record))
+    {
+        if(start < 0.0)
+        {
+            start = record.arrivaltime;
+        }
+
+        EmbeddedInfo info;
+        AsyncLogger::decode(nullptr, record, info);
+        if(!board.empty() && (board != info.sourceBoardIpAddrStr))
+        {
+            continue;
+        }
+
+        std::string str_toi;
+        info.timeOfInfo.toString(str_toi);
+        printf("%12.6f %-7s from BOARD %s time=%s : %s\n", record.arrivaltime - start, severityName(info.severity),
+               info.sourceBoardIpAddrStr.c_str(), str_toi.c_str(), info.finalMessage.c_str());
+        count++;
+    }
+
+    printf("%zu messages\n", count);
+
+    return 0;
+}
@@ -18,6 +18,15 @@ const int EthUpdater::partition_APPLICATION = uprot_partitionAPPLICATION;
 const int EthUpdater::partition_LOADER = uprot_partitionLOADER;
 const int EthUpdater::partition_UPDATER = uprot_partitionUPDATER;
 
+// not yet in EoUpdaterProtocol.h: a bit not used by eOuprot_proc_capabilities_t
+const eOuprot_proc_capabilities_t EthUpdater::capability_PROG_windowed = (eOuprot_proc_capabilities_t)(1 << 30);
+
+// windowed transfer: a chunk is sent again to the boards which have not acknowledged it
+// after PROG_RETRANSMIT seconds, and they are given up after PROG_TIMEOUT seconds (the
+// same time the stop-and-wait transfer waits for the replies of a chunk).
+static const double PROG_RETRANSMIT = 0.1;
+static const double PROG_TIMEOUT = 10.0;
+
 
 #define PRINT_DEBUG_INFO_ON_TERMINAL
 
@@ -906,6 +915,16 @@ std::string EthUpdater::cmdProgram(FILE *programFile, int partition, void (*upda
         return earlyexit;
     }
 
+    // more chunks in flight only if every board can match the acks to them
+    mProgWindowed = (mProgWindow > 1) && isCmdSupported(capability_PROG_windowed, address);
+    mInFlight.clear();
+
+    // boards which refused the start are not waited for
+    for (int i=0; i<mN2Prog; ++i)
+    {
+        mProgFailed[i] = (mBoard2Prog[i]->mSuccess != mNProgSteps);
+    }
+
     int addrH=0;
     int baseAddress=0;
     int bytesToWrite=0;
@@ -939,7 +958,7 @@ std::string EthUpdater::cmdProgram(FILE *programFile, int partition, void (*upda
                     {
                         cmdData->size[0]= bytesToWrite    &0xFF;
                         cmdData->size[1]=(bytesToWrite>>8)&0xFF;
-                        sendPROG(uprot_OPC_PROG_DATA, cmdData, HEAD_SIZE+bytesToWrite, mN2Prog,1000);
+                        sendPROGdata(cmdData, HEAD_SIZE+bytesToWrite);
                         updateProgressBar(float(bytesWritten+=bytesToWrite)/fileSize);
                         bytesToWrite=0;
                     }
@@ -970,7 +989,7 @@ std::string EthUpdater::cmdProgram(FILE *programFile, int partition, void (*upda
                 beof=true;
                 cmdData->size[0] =  bytesToWrite    &0xFF;
                 cmdData->size[1] = (bytesToWrite>>8)&0xFF;
-                sendPROG(uprot_OPC_PROG_DATA, cmdData, HEAD_SIZE+bytesToWrite, mN2Prog, 1000);
+                sendPROGdata(cmdData, HEAD_SIZE+bytesToWrite);
                 updateProgressBar(1.0f);
                 bytesToWrite=0;
             }
@@ -985,7 +1004,7 @@ std::string EthUpdater::cmdProgram(FILE *programFile, int partition, void (*upda
                 {
                     cmdData->size[0] =  bytesToWrite    &0xFF;
                     cmdData->size[1] = (bytesToWrite>>8)&0xFF;
-                    sendPROG(uprot_OPC_PROG_DATA, cmdData, HEAD_SIZE+bytesToWrite, mN2Prog, 1000);
+                    sendPROGdata(cmdData, HEAD_SIZE+bytesToWrite);
                     updateProgressBar(float(bytesWritten+=bytesToWrite)/fileSize);
                     bytesToWrite=0;
                 }
@@ -999,7 +1018,7 @@ std::string EthUpdater::cmdProgram(FILE *programFile, int partition, void (*upda
             {
                 cmdData->size[0]=  bytesToWrite    &0xFF;
                 cmdData->size[1]= (bytesToWrite>>8)&0xFF;
-                sendPROG(uprot_OPC_PROG_DATA, cmdData, HEAD_SIZE+bytesToWrite, mN2Prog,1000);
+                sendPROGdata(cmdData, HEAD_SIZE+bytesToWrite);
                 updateProgressBar(float(bytesWritten+=bytesToWrite)/fileSize);
                 bytesToWrite=0;
             }
@@ -1009,6 +1028,9 @@ std::string EthUpdater::cmdProgram(FILE *programFile, int partition, void (*upda
     }
 
 
+    // all the chunks must be acknowledged (or given up) before the end
+    flushPROGwindow();
+
     // now we send the end
     memset(cmdEnd, EOUPROT_VALUE_OF_UNUSED_BYTE, sizeof(eOuprot_cmd_PROG_END_t));
     cmdEnd->opc = uprot_OPC_PROG_END;
@@ -1106,6 +1128,146 @@ int EthUpdater::sendPROG(const uint8_t opc, void * data, int size, int answers,
 }
 
 
+void EthUpdater::sendPROGdata(void * data, int size)
+{
+    if (!mProgWindowed)
+    {
+        sendPROG(uprot_OPC_PROG_DATA, data, size, mN2Prog, 1000);
+        return;
+    }
+
+    // the tx buffer is reused for the next chunk, hence we keep a copy for the retransmissions
+    const eOuprot_cmd_PROG_DATA_t * cmd = (const eOuprot_cmd_PROG_DATA_t*) data;
+
+    mInFlight.emplace_back();
+    ProgChunk &chunk = mInFlight.back();
+    memcpy(chunk.packet, data, size);
+    chunk.size = size;
+    chunk.address = cmd->address[0] | (cmd->address[1]<<8) | (cmd->address[2]<<16) | (cmd->address[3]<<24);
+    chunk.firstSent = chunk.lastSent = Time::now();
+
+    for(int k=0; k<mN2Prog; k++)
+    {
+        chunk.acked[k] = mProgFailed[k];
+        if (!mProgFailed[k])
+        {
+            mSocket.SendTo(chunk.packet, chunk.size, mPort, mBoard2Prog[k]->mAddress);
+        }
+    }
+
+    ++mNChunks;
+    ++mNProgSteps;
+
+    while (mInFlight.size() >= (size_t)mProgWindow)
+    {
+        receivePROGacks(10);
+    }
+}
+
+
+
+void EthUpdater::receivePROGacks(int wait_msec)
+{
+    ACE_UINT16 rxPort;
+    ACE_UINT32 rxAddress;
+    ssize_t nrec;
+
+    const ssize_t ackSize = sizeof(eOuprot_cmdREPLY_t) + 4;
+
+    // the first receive waits, then we take whatever is already queued
+    while ((nrec = mSocket.ReceiveFrom(mRxBuffer, sizeof(mRxBuffer), rxAddress, rxPort, wait_msec)) > 0)
+    {
+        wait_msec = 0;
+
+        eOuprot_cmdREPLY_t * reply = (eOuprot_cmdREPLY_t*) mRxBuffer;
+
+        if ((uprot_OPC_PROG_DATA != reply->opc) || (rxAddress == mMyAddress) || (nrec < ackSize))
+        {
+            continue;
+        }
+
+        const uint8_t * echo = mRxBuffer + sizeof(eOuprot_cmdREPLY_t);
+        ACE_UINT32 chunkAddress = echo[0] | (echo[1]<<8) | (echo[2]<<16) | (echo[3]<<24);
+
+        int b = 0;
+        while ((b < mN2Prog) && (mBoard2Prog[b]->mAddress != rxAddress)) ++b;
+        if (b == mN2Prog)
+        {
+            continue;
+        }
+
+        // acks of chunks already completed or given up are duplicates
+        for (size_t c=0; c<mInFlight.size(); ++c)
+        {
+            if ((mInFlight[c].address == chunkAddress) && !mInFlight[c].acked[b])
+            {
+                mInFlight[c].acked[b] = true;
+                if (uprot_RES_OK == reply->res)
+                {
+                    ++(mBoard2Prog[b]->mSuccess);
+                }
+                else
+                {
+                    mProgFailed[b] = true;
+                }
+                break;
+            }
+        }
+    }
+
+    double now = Time::now();
+
+    for (size_t c=0; c<mInFlight.size(); )
+    {
+        ProgChunk &chunk = mInFlight[c];
+
+        bool complete = true;
+        for (int b=0; b<mN2Prog; ++b)
+        {
+            complete = complete && chunk.acked[b];
+        }
+
+        if (complete || (now - chunk.firstSent > PROG_TIMEOUT))
+        {
+            // the boards which never replied miss a step and are reported as NOK:
+            // we do not send them the following chunks
+            for (int b=0; b<mN2Prog; ++b)
+            {
+                mProgFailed[b] = mProgFailed[b] || !chunk.acked[b];
+            }
+            mInFlight.erase(mInFlight.begin() + c);
+            continue;
+        }
+
+        if (now - chunk.lastSent > PROG_RETRANSMIT)
+        {
+            // only to the boards which missed it
+            for (int b=0; b<mN2Prog; ++b)
+            {
+                if (!chunk.acked[b])
+                {
+                    mSocket.SendTo(chunk.packet, chunk.size, mPort, mBoard2Prog[b]->mAddress);
+                }
+            }
+            chunk.lastSent = now;
+        }
+
+        ++c;
+    }
+}
+
+
+
+void EthUpdater::flushPROGwindow()
+{
+    while (!mInFlight.empty())
+    {
+        receivePROGacks(10);
+    }
+}
+
+
+
 bool EthUpdater::cmdChangeMask(ACE_UINT32 newMask, ACE_UINT32 address)
 {
     bool ret = false;
@@ -16,6 +16,7 @@
 #include "BoardList.h"
 
 #include <vector>
+#include <deque>
 using namespace std;
 
 class EthUpdater
@@ -38,12 +39,33 @@ protected:
     
     DSocket mSocket;
 
+    // a PROG_DATA chunk in flight, with the boards which have acknowledged it
+    struct ProgChunk
+    {
+        unsigned char packet[uprot_UDPmaxsize];
+        int size;
+        ACE_UINT32 address;
+        double firstSent;
+        double lastSent;
+        bool acked[256];
+    };
+
+    int mProgWindow;
+    bool mProgWindowed;
+    bool mProgFailed[256];
+    std::deque<ProgChunk> mInFlight;
+
 public:
     static const int partition_APPLICATION;
     static const int partition_LOADER;
     static const int partition_UPDATER;
 
-    EthUpdater()
+    // capability of the eUpdater processes which accept more than one PROG_DATA chunk in flight.
+    // they acknowledge each chunk with the usual eOuprot_cmdREPLY_t followed by the 4 bytes of
+    // the address field of the chunk, so that the acks can be matched to the chunks.
+    static const eOuprot_proc_capabilities_t capability_PROG_windowed;
+
+    EthUpdater() : mProgWindow(8), mProgWindowed(false)
     {
     }
 
@@ -175,11 +197,22 @@ public:
     // - uprot_canDO_PROG_application:  for programming into the application partition (the third)
     std::string cmdProgram(FILE *programFile, int partition, void (*updateProgressBar)(float), ACE_UINT32 address = 0);
 
+    // number of PROG_DATA chunks that cmdProgram() keeps in flight. it is used only if all the boards
+    // being programmed have capability_PROG_windowed, otherwise (or if window is 1) every chunk waits
+    // for the replies of all the boards before the next one is sent.
+    void setProgWindow(int window) { mProgWindow = (window < 1) ? 1 : window; }
+    int getProgWindow() { return mProgWindow; }
+
 protected:
 
     void sendCommandSelected(void * cmd, uint16_t len);
     int sendPROG(const uint8_t opc, void * data, int size, int answers, int retry);
 
+    // windowed transfer of the PROG_DATA chunks
+    void sendPROGdata(void * data, int size);
+    void receivePROGacks(int wait_msec);
+    void flushPROGwindow();
+
 private:
 
     // in here are methods which we prefer not to be used, but which may be useful in special cases
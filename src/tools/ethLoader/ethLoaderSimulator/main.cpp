@@ -0,0 +1,328 @@
+/*
+ * Copyright (C) 2022 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+// Local simulation of the eUpdater of N boards, to check the firmware transfer of
+// EthUpdater::cmdProgram() and to time it with and without the windowed mode.
+//
+// Every simulated board is a thread with its own UDP socket bound to 127.0.1.<n>
+// (on Linux the whole 127.0.0.0/8 network is loopback), which replies to PROG_START,
+// PROG_DATA and PROG_END as a board does, writes the chunks in its own memory after
+// --write_ms milliseconds and drops every received PROG_DATA with probability --loss
+// (EthUpdater does not retry PROG_START and PROG_END, whatever the mode).
+// The same synthetic firmware is sent first in stop-and-wait mode, then with
+// --window chunks in flight, and the memory of every board is compared with it.
+// Stop-and-wait never retransmits, hence it is skipped when --loss is not zero.
+//
+// ethLoaderSimulator [--boards 30] [--window 8] [--kbytes 256] [--write_ms 1]
+//                    [--loss 0.0] [--port 3180]
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <algorithm>
+#include <random>
+#include <thread>
+#include <atomic>
+#include <chrono>
+
+#include <yarp/os/Property.h>
+#include <yarp/os/Time.h>
+
+#include "EthUpdater.h"
+
+using namespace yarp::os;
+
+namespace
+{
+    const ACE_UINT32 hostAddress = 0x7F000001;     // 127.0.0.1
+    const ACE_UINT32 boardAddress = 0x7F000100;    // 127.0.1.x
+    const ACE_UINT32 flashBase = 0x08000000;
+
+    class SimBoard
+    {
+    public:
+        SimBoard(int id, ACE_UINT16 port, double writeTime, double loss) :
+            mAddress(boardAddress+id+1), mPort(port), mWriteTime(writeTime),
+            mLoss(loss), mRandom(id), mRun(false)
+        {
+        }
+
+        bool start()
+        {
+            if (!mSocket.Create(mPort, mAddress))
+            {
+                return false;
+            }
+            mRun = true;
+            mThread = std::thread(&SimBoard::run, this);
+            return true;
+        }
+
+        void stop()
+        {
+            mRun = false;
+            if (mThread.joinable())
+            {
+                mThread.join();
+            }
+            mSocket.Close();
+        }
+
+        ACE_UINT32 address() const { return mAddress; }
+        // the content of the flash from flashBase
+        std::vector<uint8_t> memory()
+        {
+            std::lock_guard<std::mutex> lck(mMutex);
+            return mMemory;
+        }
+
+    private:
+        void reply(uint8_t opc, const uint8_t *echo, ACE_UINT32 to, ACE_UINT16 port)
+        {
+            uint8_t packet[sizeof(eOuprot_cmdREPLY_t)+4];
+            memset(packet, EOUPROT_VALUE_OF_UNUSED_BYTE, sizeof(packet));
+
+            eOuprot_cmdREPLY_t *r = (eOuprot_cmdREPLY_t*) packet;
+            r->opc = opc;
+            r->res = uprot_RES_OK;
+
+            size_t len = sizeof(eOuprot_cmdREPLY_t);
+            if (echo)
+            {
+                // the acknowledgement of EthUpdater::capability_PROG_windowed
+                memcpy(packet+len, echo, 4);
+                len += 4;
+            }
+
+            mSocket.SendTo(packet, len, port, to);
+        }
+
+        void run()
+        {
+            std::uniform_real_distribution<double> uniform(0.0, 1.0);
+            uint8_t rx[uprot_UDPmaxsize];
+
+            while (mRun)
+            {
+                ACE_UINT32 from;
+                ACE_UINT16 port;
+                ssize_t n = mSocket.ReceiveFrom(rx, sizeof(rx), from, port, 50);
+                if (n <= 0)
+                {
+                    continue;
+                }
+
+                switch (rx[0])
+                {
+                case uprot_OPC_PROG_START:
+                {
+                    std::lock_guard<std::mutex> lck(mMutex);
+                    mMemory.clear();
+                    reply(uprot_OPC_PROG_START, NULL, from, port);
+                    break;
+                }
+
+                case uprot_OPC_PROG_DATA:
+                {
+                    const eOuprot_cmd_PROG_DATA_t *cmd = (const eOuprot_cmd_PROG_DATA_t*) rx;
+                    ACE_UINT32 address = cmd->address[0] | (cmd->address[1]<<8) | (cmd->address[2]<<16) | (cmd->address[3]<<24);
+                    int size = cmd->size[0] | (cmd->size[1]<<8);
+
+                    if (uniform(mRandom) < mLoss)
+                    {
+                        break;
+                    }
+
+                    std::this_thread::sleep_for(std::chrono::duration<double>(mWriteTime));
+                    std::lock_guard<std::mutex> lck(mMutex);
+                    if (address >= flashBase)
+                    {
+                        size_t offset = address - flashBase;
+                        mMemory.resize(std::max(mMemory.size(), offset+size));
+                        memcpy(mMemory.data()+offset, cmd->data, size);
+                    }
+                    reply(uprot_OPC_PROG_DATA, cmd->address, from, port);
+                    break;
+                }
+
+                case uprot_OPC_PROG_END:
+                    reply(uprot_OPC_PROG_END, NULL, from, port);
+                    break;
+                }
+            }
+        }
+
+        ACE_UINT32 mAddress;
+        ACE_UINT16 mPort;
+        double mWriteTime;
+        double mLoss;
+        std::mt19937 mRandom;
+        std::atomic<bool> mRun;
+        std::thread mThread;
+        DSocket mSocket;
+        std::mutex mMutex;
+        std::vector<uint8_t> mMemory;
+    };
+
+    // Intel HEX firmware of the given size, 16 bytes per record as produced by the toolchains
+    FILE* makeFirmware(std::vector<uint8_t> &image, int kbytes)
+    {
+        FILE *f = tmpfile();
+        if (!f)
+        {
+            return NULL;
+        }
+
+        std::mt19937 random(1);
+        image.resize(1024*kbytes);
+        for (auto &b : image)
+        {
+            b = random() & 0xFF;
+        }
+
+        int lastH = -1;
+        for (size_t offset=0; offset<image.size(); offset+=16)
+        {
+            ACE_UINT32 address = flashBase + offset;
+            int addrH = address >> 16;
+            if (addrH != lastH)
+            {
+                int sum = 2 + 4 + (addrH>>8) + (addrH&0xFF);
+                fprintf(f, ":02000004%04X%02X\n", addrH, (-sum)&0xFF);
+                lastH = addrH;
+            }
+
+            int size = (int)std::min<size_t>(16, image.size()-offset);
+            int addrL = address & 0xFFFF;
+            int sum = size + (addrL>>8) + (addrL&0xFF);
+            fprintf(f, ":%02X%04X00", size, addrL);
+            for (int i=0; i<size; ++i)
+            {
+                fprintf(f, "%02X", image[offset+i]);
+                sum += image[offset+i];
+            }
+            fprintf(f, "%02X\n", (-sum)&0xFF);
+        }
+        fprintf(f, ":00000001FF\n");
+
+        return f;
+    }
+
+    void noProgress(float)
+    {
+    }
+}
+
+
+int main(int argc, char *argv[])
+{
+    Property options;
+    options.fromCommand(argc, argv);
+
+    int nBoards = options.check("boards", Value(30)).asInt32();
+    int window = options.check("window", Value(8)).asInt32();
+    int kbytes = options.check("kbytes", Value(256)).asInt32();
+    double writeTime = 0.001*options.check("write_ms", Value(1.0)).asFloat64();
+    double loss = options.check("loss", Value(0.0)).asFloat64();
+    ACE_UINT16 port = (ACE_UINT16) options.check("port", Value(3180)).asInt32();
+
+    if ((nBoards < 1) || (nBoards > 250))
+    {
+        fprintf(stderr, "--boards must be in [1,250]\n");
+        return 1;
+    }
+
+    std::vector<uint8_t> image;
+    FILE *firmware = makeFirmware(image, kbytes);
+    if (!firmware)
+    {
+        fprintf(stderr, "cannot create the firmware file\n");
+        return 1;
+    }
+
+    std::vector<SimBoard*> boards;
+    for (int i=0; i<nBoards; ++i)
+    {
+        boards.push_back(new SimBoard(i, port, writeTime, loss));
+        if (!boards.back()->start())
+        {
+            fprintf(stderr, "cannot bind the board socket on 127.0.1.%d:%d\n", i+1, port);
+            return 1;
+        }
+    }
+
+    EthUpdater updater;
+    if (!updater.create(port, hostAddress))
+    {
+        fprintf(stderr, "cannot bind the updater socket\n");
+        return 1;
+    }
+
+    printf("%d boards, %d KB of firmware, %.1f ms per chunk write, %.1f%% packet loss\n",
+           nBoards, kbytes, 1000.0*writeTime, 100.0*loss);
+
+    int failures = 0;
+    const int windows[] = { 1, window };
+    for (int w : windows)
+    {
+        if ((w == 1) && (loss > 0.0))
+        {
+            printf("window  1: skipped, lost chunks are not retransmitted\n");
+            continue;
+        }
+
+        // the boards advertise the windowed transfer only if we want to use it
+        updater.getBoardList().empty();
+        for (int i=0; i<nBoards; ++i)
+        {
+            ACE_UINT32 caps = uprot_canDO_PROG_application;
+            if (w > 1)
+            {
+                caps |= EthUpdater::capability_PROG_windowed;
+            }
+            updater.getBoardList().addBoard(new BoardInfo(boards[i]->address(), 0xFFFFFF00, i, 1, 0, 1, caps));
+        }
+        updater.getBoardList().selectAll(true);
+        updater.setProgWindow(w);
+
+        fseek(firmware, 0, SEEK_SET);
+        double t0 = Time::now();
+        std::string result = updater.cmdProgram(firmware, EthUpdater::partition_APPLICATION, noProgress);
+        double elapsed = Time::now() - t0;
+
+        // the boards write the last chunk before replying, so their memory is complete
+        int good = 0;
+        for (int i=0; i<nBoards; ++i)
+        {
+            good += (boards[i]->memory() == image) ? 1 : 0;
+        }
+        int ok = 0;
+        for (size_t pos = result.find(" OK"); pos != std::string::npos; pos = result.find(" OK", pos+1))
+        {
+            ++ok;
+        }
+
+        printf("window %2d: %.3f s, %d/%d boards OK, %d/%d images verified\n", w, elapsed, ok, nBoards, good, nBoards);
+        if ((ok != nBoards) || (good != nBoards))
+        {
+            ++failures;
+        }
+    }
+
+    for (auto board : boards)
+    {
+        board->stop();
+        delete board;
+    }
+    fclose(firmware);
+
+    return failures ? 1 : 0;
+}
@@ -8,67 +8,28 @@
 #include <yarp/os/all.h>
 
 #include <iostream>
+#include <algorithm>
 #include <math.h>
 
+#include "imageCompositing.h"
+
 using namespace yarp::os;
 using namespace yarp::sig;
 void printFrame(int h, int w, int c);
 
-void merge(const ImageOf<PixelRgb> &imgR, const ImageOf<PixelRgb> &imgL, ImageOf<PixelRgb> &out, size_t start_lx, size_t start_ly, size_t start_rx, size_t start_ry, double alpha1,double alpha2)
+void merge(const ImageOf<PixelRgb> &imgR, const ImageOf<PixelRgb> &imgL, ImageOf<PixelRgb> &out, size_t start_lx, size_t start_ly, size_t start_rx, size_t start_ry, int alpha1, int alpha2)
 {
     size_t max_w = (imgR.width() > imgL.width()) ? imgR.width() : imgL.width();
     size_t max_h = (imgR.height() > imgL.height()) ? imgR.height() : imgL.height();
+    // the buffers of the output port are recycled: reallocate only on size changes
     if (out.width()  != max_w || out.height() != max_h)  out.resize(max_w, max_h);
 
-    start_lx = (start_lx < max_w) ? start_lx : max_w;
-    start_ly = (start_ly < max_h) ? start_ly : max_h;
-    start_rx = (start_rx < max_w) ? start_rx : max_w;
-    start_ry = (start_ry < max_h) ? start_ry : max_h;
-    size_t end_lx = (start_lx + imgL.width() < max_w) ? (start_lx + imgL.width()) : max_w;
-    size_t end_ly = (start_ly + imgL.height() < max_h) ? (start_ly + imgL.height()) : max_h;
-    size_t end_rx = (start_rx + imgR.width() < max_w) ? (start_rx + imgR.width()) : max_w;
-    size_t end_ry = (start_ry + imgR.height() < max_h) ? (start_ry + imgR.height()) : max_h;
-
     //canvas
-    for (size_t r_dst = 0; r_dst < max_h; r_dst++)
-    {
-        unsigned char       *tmp_dst = out.getRow(r_dst);
-
-        for (size_t c_dst = 0; c_dst < max_w; c_dst++)
-        {
-            tmp_dst[0 + c_dst * 3] = 0;
-            tmp_dst[1 + c_dst * 3] = 0;
-            tmp_dst[2 + c_dst * 3] = 0;
-        }
-    }
-
-    //left image
-    for (size_t r_dst = start_ly, r_src = 0; r_dst < end_ly; r_dst++, r_src++)
-    {
-        unsigned char       *tmp_dst = out.getRow(r_dst);
-        const unsigned char *tmp_src = imgL.getRow(r_src);
+    imageCompositing::clear(out);
 
-        for (size_t c_dst = start_lx, c_src = 0; c_dst < end_lx; c_dst++, c_src++)
-        {
-            tmp_dst[0 + c_dst * 3] = tmp_dst[0 + c_dst * 3] + (unsigned char)(double(tmp_src[0 + c_src * 3]) * alpha1);
-            tmp_dst[1 + c_dst * 3] = tmp_dst[1 + c_dst * 3] + (unsigned char)(double(tmp_src[1 + c_src * 3]) * alpha1);
-            tmp_dst[2 + c_dst * 3] = tmp_dst[2 + c_dst * 3] + (unsigned char)(double(tmp_src[2 + c_src * 3]) * alpha1);
-        }
-    }
-    
-    //right image
-    for (size_t r_dst = start_ry, r_src = 0; r_dst < end_ry; r_dst++, r_src++)
-    {
-        unsigned char       *tmp_dst = out.getRow(r_dst);
-        const unsigned char *tmp_src = imgR.getRow(r_src);
-
-        for (size_t c_dst = start_rx, c_src = 0; c_dst < end_rx; c_dst++, c_src++)
-        {
-            tmp_dst[0 + c_dst * 3] = tmp_dst[0 + c_dst * 3] + (unsigned char)(double(tmp_src[0 + c_src * 3]) * alpha2);
-            tmp_dst[1 + c_dst * 3] = tmp_dst[1 + c_dst * 3] + (unsigned char)(double(tmp_src[1 + c_src * 3]) * alpha2);
-            tmp_dst[2 + c_dst * 3] = tmp_dst[2 + c_dst * 3] + (unsigned char)(double(tmp_src[2 + c_src * 3]) * alpha2);
-        }
-    }
+    //left and right images, clipped to the canvas
+    imageCompositing::blendAdd(imgL, out, (int)std::min(start_lx, max_w), (int)std::min(start_ly, max_h), alpha1);
+    imageCompositing::blendAdd(imgR, out, (int)std::min(start_rx, max_w), (int)std::min(start_ry, max_h), alpha2);
 }
 
 int main(int argc, char *argv[])
@@ -100,6 +61,11 @@ int main(int argc, char *argv[])
     if (rf.check("alpha1")) alpha1 = rf.find("alpha1").asFloat64();
     if (rf.check("alpha2")) alpha2 = rf.find("alpha2").asFloat64();
     yDebug("left offset:%lu,%lu right offset:%lu,%lu, alpha1:%f, alpha2:%f", start_lx, start_ly, start_rx, start_ry, alpha1, alpha2);
+    if (alpha1 < 0.0 || alpha1 > 1.0 || alpha2 < 0.0 || alpha2 > 1.0)
+        yWarning("alpha values are clamped to [0,1]");
+    // weights are applied in 8.8 fixed point, the sum saturates at 255
+    int alpha1_fx = imageCompositing::alphaToFixed(alpha1);
+    int alpha2_fx = imageCompositing::alphaToFixed(alpha2);
     if (rf.check("help"))
     {
         yDebug() << "Available options:";
@@ -117,11 +83,13 @@ int main(int argc, char *argv[])
         ImageOf< PixelRgb> *imgR=right.read(true);
         ImageOf< PixelRgb> *imgL=left.read(true);
 
+        // prepare() hands out a buffer that is not in flight, hence the next
+        // frame is composed while the previous one is still being sent
         ImageOf< PixelRgb> &outImg=out.prepare();
 
         if (imgR!=0 && imgL!=0)
         {
-            merge(*imgR, *imgL, outImg, start_lx, start_ly, start_rx, start_ry,alpha1,alpha2);
+            merge(*imgR, *imgL, outImg, start_lx, start_ly, start_rx, start_ry, alpha1_fx, alpha2_fx);
 
             out.write();
             c++;
@@ -0,0 +1,155 @@
+/*
+ * Copyright (C) 2022 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+// Throughput of the compositing kernels on synthetic frames: the blending
+// of imageBlender (both with the SIMD kernel and with its scalar reference)
+// and the split/merge of side-by-side frames of imageSplitter, at several
+// resolutions up to a pair of full HD images.
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <functional>
+#include <algorithm>
+
+#include <yarp/os/all.h>
+#include <yarp/sig/Image.h>
+
+#include "imageCompositing.h"
+
+using namespace std;
+using namespace yarp::os;
+using namespace yarp::sig;
+
+
+/************************************************************************/
+void fill(ImageOf<PixelRgb> &img, unsigned int seed)
+{
+    for (size_t r=0; r<img.height(); r++)
+    {
+        unsigned char *row=img.getRow(r);
+        for (size_t i=0; i<img.width()*3; i++)
+        {
+            seed=1103515245*seed+12345;
+            row[i]=(unsigned char)(seed>>16);
+        }
+    }
+}
+
+
+/************************************************************************/
+void measure(const string &name, const size_t bytes, const int frames,
+             const std::function<void()> &op)
+{
+    op();   // warm-up
+
+    double t0=Time::now();
+    for (int i=0; i<frames; i++)
+        op();
+    double dt=(Time::now()-t0)/frames;
+
+    yInfo("    %-22s: %8.3f [ms/frame] %8.1f [fps] %8.1f [MB/s]",
+          name.c_str(),1e3*dt,1.0/dt,1e-6*bytes/dt);
+}
+
+
+/************************************************************************/
+int main(int argc, char *argv[])
+{
+    Network::init();
+
+    ResourceFinder rf;
+    rf.configure(argc,argv);
+
+    if (rf.check("help"))
+    {
+        printf("Options\n");
+        printf("\t--sizes \"(w h ...)\": single image resolutions (default: (320 240 640 480 1280 720 1920 1080))\n");
+        printf("\t--frames       <N>: frames processed per kernel (default: 200)\n");
+        printf("\n");
+        Network::fini();
+        return 0;
+    }
+
+    int frames=std::max(1,rf.check("frames",Value(200)).asInt32());
+    vector<int> sizes={320,240,640,480,1280,720,1920,1080};
+    if (Bottle *b=rf.find("sizes").asList())
+    {
+        sizes.clear();
+        for (size_t i=0; i+1<b->size(); i+=2)
+        {
+            sizes.push_back(b->get(i).asInt32());
+            sizes.push_back(b->get(i+1).asInt32());
+        }
+    }
+
+    yInfo("SIMD kernel: %s",imageCompositing::hasSIMD()?"SSE2":"not available");
+    int alpha=imageCompositing::alphaToFixed(0.5);
+
+    for (size_t s=0; s+1<sizes.size(); s+=2)
+    {
+        size_t w=sizes[s];
+        size_t h=sizes[s+1];
+        size_t bytes=w*h*3;
+
+        ImageOf<PixelRgb> left,right,dual,out;
+        left.resize(w,h);   fill(left,1);
+        right.resize(w,h);  fill(right,2);
+        out.resize(w,h);
+        imageCompositing::merge(left,right,dual,true);
+
+        yInfo("*** %dx%d",(int)w,(int)h);
+
+        // imageBlender: canvas + two weighted images
+        measure("blend",3*bytes,frames,[&]() {
+            imageCompositing::clear(out);
+            imageCompositing::blendAdd(left,out,0,0,alpha);
+            imageCompositing::blendAdd(right,out,0,0,alpha);
+        });
+
+        measure("blend (scalar)",3*bytes,frames,[&]() {
+            imageCompositing::clear(out);
+            for (size_t r=0; r<h; r++)
+            {
+                imageCompositing::blendAddRowScalar(left.getRow(r),out.getRow(r),3*w,alpha);
+                imageCompositing::blendAddRowScalar(right.getRow(r),out.getRow(r),3*w,alpha);
+            }
+        });
+
+        // the per-pixel floating point blending it replaces
+        measure("blend (per-pixel double)",3*bytes,frames,[&]() {
+            for (size_t r=0; r<h; r++)
+                for (size_t c=0; c<w; c++)
+                    for (int k=0; k<3; k++)
+                        out.getPixelAddress(c,r)[k]=0;
+            for (size_t r=0; r<h; r++)
+            {
+                unsigned char *dst=out.getRow(r);
+                const unsigned char *srcL=left.getRow(r);
+                const unsigned char *srcR=right.getRow(r);
+                for (size_t i=0; i<3*w; i++)
+                    dst[i]=dst[i]+(unsigned char)(double(srcL[i])*0.5);
+                for (size_t i=0; i<3*w; i++)
+                    dst[i]=dst[i]+(unsigned char)(double(srcR[i])*0.5);
+            }
+        });
+
+        // imageSplitter: deinterleave a side-by-side frame and back
+        measure("split",2*bytes,frames,[&]() {
+            imageCompositing::split(dual,left,right,true);
+        });
+
+        measure("merge",2*bytes,frames,[&]() {
+            imageCompositing::merge(left,right,dual,true);
+        });
+    }
+
+    Network::fini();
+    return 0;
+}
@@ -0,0 +1,210 @@
+/*
+ * Copyright (C) 2022 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <cstring>
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+    #include <emmintrin.h>
+    #define IMAGE_COMPOSITING_SSE2
+#endif
+
+#include "imageCompositing.h"
+
+using namespace yarp::sig;
+
+
+namespace
+{
+    // The row of an image, as a byte span.
+    inline size_t rowBytes(const Image &img)
+    {
+        return (size_t)img.width()*img.getPixelSize();
+    }
+
+    // Rows are contiguous when there is no padding at their end.
+    inline bool contiguous(const Image &img)
+    {
+        return (rowBytes(img)==img.getRowSize());
+    }
+
+    // Clips the rectangle of src placed at (x,y) to the area of dst: on
+    // success it returns the offsets within src and the extent in pixels.
+    bool clip(const Image &src, const Image &dst, int x, int y,
+              int &srcX, int &srcY, int &w, int &h)
+    {
+        srcX=std::max(0,-x);
+        srcY=std::max(0,-y);
+        w=std::min((int)src.width(),(int)dst.width()-x)-srcX;
+        h=std::min((int)src.height(),(int)dst.height()-y)-srcY;
+        return (w>0) && (h>0) && (src.getPixelSize()==dst.getPixelSize());
+    }
+
+    // Resizes img only if it does not have the requested geometry, so that
+    // the buffers of the output ports are recycled from frame to frame.
+    void conform(Image &img, size_t w, size_t h, size_t quantum)
+    {
+        if (img.getQuantum()!=quantum)
+            img.setQuantum(quantum);
+        if ((img.width()!=w) || (img.height()!=h))
+            img.resize(w,h);
+    }
+}
+
+
+/************************************************************************/
+int imageCompositing::alphaToFixed(double alpha)
+{
+    alpha=std::min(1.0,std::max(0.0,alpha));
+    return (int)(256.0*alpha+0.5);
+}
+
+
+/************************************************************************/
+void imageCompositing::blendAddRowScalar(const unsigned char *src, unsigned char *dst,
+                                         size_t len, int alpha)
+{
+    for (size_t i=0; i<len; i++)
+    {
+        int v=dst[i]+((src[i]*alpha)>>8);
+        dst[i]=(unsigned char)(v<255?v:255);
+    }
+}
+
+
+/************************************************************************/
+void imageCompositing::blendAddRow(const unsigned char *src, unsigned char *dst,
+                                   size_t len, int alpha)
+{
+    size_t i=0;
+#ifdef IMAGE_COMPOSITING_SSE2
+    // 16 bytes at a time: widen to 16 bits, multiply (255*256 still fits
+    // in 16 unsigned bits), shift back, narrow and add with saturation
+    const __m128i zero=_mm_setzero_si128();
+    const __m128i a=_mm_set1_epi16((short)alpha);
+    for (; i+16<=len; i+=16)
+    {
+        __m128i s=_mm_loadu_si128((const __m128i*)(src+i));
+        __m128i d=_mm_loadu_si128((const __m128i*)(dst+i));
+        __m128i lo=_mm_srli_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(s,zero),a),8);
+        __m128i hi=_mm_srli_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(s,zero),a),8);
+        _mm_storeu_si128((__m128i*)(dst+i),_mm_adds_epu8(d,_mm_packus_epi16(lo,hi)));
+    }
+#endif
+    blendAddRowScalar(src+i,dst+i,len-i,alpha);
+}
+
+
+/************************************************************************/
+bool imageCompositing::hasSIMD()
+{
+#ifdef IMAGE_COMPOSITING_SSE2
+    return true;
+#else
+    return false;
+#endif
+}
+
+
+/************************************************************************/
+void imageCompositing::clear(Image &img, unsigned char value)
+{
+    if (contiguous(img))
+    {
+        memset(img.getRawImage(),value,img.getRawImageSize());
+        return;
+    }
+
+    size_t len=rowBytes(img);
+    for (size_t r=0; r<img.height(); r++)
+        memset(img.getRow(r),value,len);
+}
+
+
+/************************************************************************/
+void imageCompositing::copy(const Image &src, Image &dst, int x, int y)
+{
+    int srcX,srcY,w,h;
+    if (!clip(src,dst,x,y,srcX,srcY,w,h))
+        return;
+
+    size_t ps=dst.getPixelSize();
+    size_t len=w*ps;
+    for (int r=0; r<h; r++)
+        memcpy(dst.getRow(y+srcY+r)+(x+srcX)*ps,src.getRow(srcY+r)+srcX*ps,len);
+}
+
+
+/************************************************************************/
+void imageCompositing::blendAdd(const Image &src, Image &dst, int x, int y, int alpha)
+{
+    int srcX,srcY,w,h;
+    if (!clip(src,dst,x,y,srcX,srcY,w,h) || (alpha<=0))
+        return;
+
+    size_t ps=dst.getPixelSize();
+    size_t len=w*ps;
+    for (int r=0; r<h; r++)
+        blendAddRow(src.getRow(srcY+r)+srcX*ps,dst.getRow(y+srcY+r)+(x+srcX)*ps,len,alpha);
+}
+
+
+/************************************************************************/
+bool imageCompositing::split(const Image &in, Image &first, Image &second, bool horizontal)
+{
+    if ((in.getPixelSize()!=first.getPixelSize()) || (in.getPixelSize()!=second.getPixelSize()))
+        return false;
+
+    size_t w=horizontal?in.width()/2:in.width();
+    size_t h=horizontal?in.height():in.height()/2;
+    conform(first,w,h,in.getQuantum());
+    conform(second,w,h,in.getQuantum());
+
+    size_t len=rowBytes(first);
+    if (!horizontal && contiguous(in) && contiguous(first) && contiguous(second))
+    {
+        // the two halves are contiguous blocks of memory
+        memcpy(first.getRawImage(),in.getRawImage(),h*len);
+        memcpy(second.getRawImage(),in.getRow(h),h*len);
+        return true;
+    }
+
+    for (size_t r=0; r<h; r++)
+    {
+        const unsigned char *row1=in.getRow(r);
+        const unsigned char *row2=horizontal?row1+len:in.getRow(h+r);
+        memcpy(first.getRow(r),row1,len);
+        memcpy(second.getRow(r),row2,len);
+    }
+
+    return true;
+}
+
+
+/************************************************************************/
+bool imageCompositing::merge(const Image &first, const Image &second, Image &out, bool horizontal)
+{
+    if ((first.width()!=second.width()) || (first.height()!=second.height()) ||
+        (first.getPixelSize()!=second.getPixelSize()) || (first.getPixelSize()!=out.getPixelSize()))
+        return false;
+
+    size_t w=first.width();
+    size_t h=first.height();
+    conform(out,horizontal?2*w:w,horizontal?h:2*h,first.getQuantum());
+
+    size_t len=rowBytes(first);
+    for (size_t r=0; r<h; r++)
+    {
+        unsigned char *row1=out.getRow(r);
+        unsigned char *row2=horizontal?row1+len:out.getRow(h+r);
+        memcpy(row1,first.getRow(r),len);
+        memcpy(row2,second.getRow(r),len);
+    }
+
+    return true;
+}
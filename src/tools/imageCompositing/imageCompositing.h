@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2022 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef ICUB_TOOLS_IMAGE_COMPOSITING_H
+#define ICUB_TOOLS_IMAGE_COMPOSITING_H
+
+#include <cstddef>
+#include <yarp/sig/Image.h>
+
+/**
+ * Compositing kernels shared by imageBlender and imageSplitter.
+ *
+ * All the functions work on the raw rows of the images, hence on any pixel
+ * type, and honour the row padding. Canvas fills and copies are plain
+ * memset/memcpy on rows (or on the whole buffer when rows are contiguous);
+ * blending is done in fixed point with saturating adds, vectorized with
+ * SSE2 where available and with a pixel-exact scalar fallback elsewhere.
+ */
+namespace imageCompositing
+{
+    /**
+     * Quantizes a blending weight to the 8.8 fixed-point format used by the
+     * kernels: the result is in [0,256] and alpha is clamped to [0,1].
+     */
+    int alphaToFixed(double alpha);
+
+    /**
+     * dst[i] = min(255, dst[i] + ((src[i]*alpha)>>8)) for i in [0,len),
+     * with alpha in 8.8 fixed point as returned by alphaToFixed().
+     */
+    void blendAddRow(const unsigned char *src, unsigned char *dst, size_t len, int alpha);
+
+    /** Scalar reference of blendAddRow(). */
+    void blendAddRowScalar(const unsigned char *src, unsigned char *dst, size_t len, int alpha);
+
+    /** True if blendAddRow() runs the SIMD code path. */
+    bool hasSIMD();
+
+    /** Sets all the bytes of the image to value. */
+    void clear(yarp::sig::Image &img, unsigned char value=0);
+
+    /**
+     * Copies src into dst with its top-left corner at (x,y), clipping it
+     * to the area of dst. Pixel sizes must match.
+     */
+    void copy(const yarp::sig::Image &src, yarp::sig::Image &dst, int x, int y);
+
+    /**
+     * Adds src weighted by alpha (8.8 fixed point) to dst with its top-left
+     * corner at (x,y), clipping it to the area of dst. Pixel sizes must match.
+     */
+    void blendAdd(const yarp::sig::Image &src, yarp::sig::Image &dst, int x, int y, int alpha);
+
+    /**
+     * Deinterleaves a frame holding two images side by side (horizontal) or
+     * one above the other (vertical) into first and second, which are
+     * resized only if needed. Returns false on pixel size mismatch.
+     */
+    bool split(const yarp::sig::Image &in, yarp::sig::Image &first, yarp::sig::Image &second,
+               bool horizontal);
+
+    /**
+     * Interleaves two images of the same size into a single frame, side by
+     * side (horizontal) or one above the other (vertical): the inverse of
+     * split(). Returns false on size or pixel size mismatch.
+     */
+    bool merge(const yarp::sig::Image &first, const yarp::sig::Image &second, yarp::sig::Image &out,
+               bool horizontal);
+}
+
+#endif  // ICUB_TOOLS_IMAGE_COMPOSITING_H
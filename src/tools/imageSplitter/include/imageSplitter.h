@@ -19,15 +19,15 @@
 class ImageSplitter: public yarp::os::RFModule
 {
 private:
-    int method;  // tmp, just for testing different methods of filling the output images
     bool horizontal;
 
     yarp::os::BufferedPort<yarp::sig::ImageOf<yarp::sig::PixelRgb> > inputPort;
     yarp::os::BufferedPort<yarp::sig::ImageOf<yarp::sig::PixelRgb> > outLeftPort;
     yarp::os::BufferedPort<yarp::sig::ImageOf<yarp::sig::PixelRgb> > outRightPort;
 
-    int inWidth, inHeight;
-    int outWidth, outHeight;
+    // timing statistics
+    int counter;
+    double elapsed;
 
 public:
     ImageSplitter();
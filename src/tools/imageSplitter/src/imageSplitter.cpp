@@ -7,6 +7,7 @@
 #include <yarp/os/LogStream.h>
 
 #include <imageSplitter.h>
+#include <imageCompositing.h>
 
 using namespace std;
 using namespace yarp::os;
@@ -15,13 +16,12 @@ using namespace yarp::sig;
 ImageSplitter::ImageSplitter()
 {
     horizontal = true;
-    method = 2;
+    counter = 0;
+    elapsed = 0.0;
 }
 
 ImageSplitter::~ImageSplitter()
 {
-    horizontal = true;
-    method = 2;
 }
 
 bool ImageSplitter::configure(yarp::os::ResourceFinder &rf)
@@ -122,36 +122,11 @@ bool ImageSplitter::configure(yarp::os::ResourceFinder &rf)
         }
     }
 
-    // choose filling method
+    // the filling method is now picked by the compositing kernels: rows are
+    // copied one by one, or in a single block when the halves are contiguous
     if(rf.check("m"))
-    {
-        string align = rf.find("m").asString();
-        if(align == "pixel")
-        {
-            method = 0;
-        }
-        else if(align == "pixel2")
-        {
-            method = 1;
-        }
-        else if(align == "line")
-        {
-            method = 2;
-        }
-        else if(align == "whole")
-        {
-            if(horizontal)
-                yError() << "Cannot use 'whole' method for input image horizontally aligned";
-            method = 3;
-        }
-        else
-        {
-            yError() << "Methods are pixel, line, whole; got " << align;
-            return false;
-        }
-    }
+        yWarning() << "The 'm' parameter is deprecated and ignored";
 
-    yInfo() << "using method " << method;
     return true;
 }
 
@@ -169,176 +144,29 @@ bool ImageSplitter::close()
 bool ImageSplitter::updateModule()
 {
     ImageOf<PixelRgb> *inputImage    = inputPort.read();
+    if (inputImage == nullptr)
+        return true;
+
     yarp::os::Stamp stamp;
     inputPort.getEnvelope(stamp);
 
+    // prepare() hands out buffers that are not in flight, hence the next
+    // frame is split while the previous ones are still being sent; the
+    // kernels reallocate them only if the size of the input changes
     ImageOf<PixelRgb> &outLeftImage  = outLeftPort.prepare();
     ImageOf<PixelRgb> &outRightImage = outRightPort.prepare();
 
-    inWidth  = inputImage->width();
-    inHeight = inputImage->height();
-
-    if(horizontal)  // input image is horizontally aligned
-    {
-        outWidth  = inWidth/2;
-        outHeight = inHeight;
-    }
-    else
-    {
-        outWidth  = inWidth;
-        outHeight = inHeight/2;
-    }
+    double start = yarp::os::Time::now();
 
-    outLeftImage.setQuantum(inputImage->getQuantum());
-    outRightImage.setQuantum(inputImage->getQuantum());
-    outLeftImage.resize(outWidth, outHeight);
-    outRightImage.resize(outWidth, outHeight);
-
-    // alloc and compute some vars for efficency
-    int h2, w2;
-    unsigned char *pixelLeft, *pixelRight;
-    unsigned char *pixelInputL, *pixelInputR;
-    unsigned char *pixelInput = inputImage->getRawImage();
-    int dualImage_rowSizeByte = inputImage->getRowSize();
-    int singleImage_rowSizeByte = outLeftImage.getRowSize();
-    int singleImage_wholeSizeByte = outWidth * outHeight * outLeftImage.getPixelSize();
-
-    static int counter = 0;
-    static double start = 0;
-    start = yarp::os::Time::now();
-
-    switch(method)
+    if (!imageCompositing::split(*inputImage, outLeftImage, outRightImage, horizontal))
     {
-        case 0: // pixel by pixel
-        {
-            if(horizontal)
-            {
-                for(int h=0; h<outHeight; h++)
-                {
-                    for(int w1=0; w1<outWidth; w1++)
-                    {
-                        w2 = w1+outWidth;
-                        pixelLeft = outLeftImage.getPixelAddress(w1, h);
-                        pixelLeft[0] = *(inputImage->getPixelAddress(w1, h)+0);
-                        pixelLeft[1] = *(inputImage->getPixelAddress(w1, h)+1);
-                        pixelLeft[2] = *(inputImage->getPixelAddress(w1, h)+2);
-
-                        pixelRight = outRightImage.getPixelAddress(w1, h);
-                        pixelRight[0] = *(inputImage->getPixelAddress(w2, h)+0);
-                        pixelRight[1] = *(inputImage->getPixelAddress(w2, h)+1);
-                        pixelRight[2] = *(inputImage->getPixelAddress(w2, h)+2);
-                    }
-                }
-            }
-            else
-            {
-                for(int h1=0; h1<outHeight; h1++)
-                {
-                    for(int w=0; w<outWidth; w++)
-                    {
-                        h2 = h1+outHeight;
-                        pixelLeft = outLeftImage.getPixelAddress(w, h1);
-                        pixelLeft[0] = *(inputImage->getPixelAddress(w, h1)+0);
-                        pixelLeft[1] = *(inputImage->getPixelAddress(w, h1)+1);
-                        pixelLeft[2] = *(inputImage->getPixelAddress(w, h1)+2);
-
-                        pixelRight = outRightImage.getPixelAddress(w, h1);
-                        pixelRight[0] = *(inputImage->getPixelAddress(w, h2)+0);
-                        pixelRight[1] = *(inputImage->getPixelAddress(w, h2)+1);
-                        pixelRight[2] = *(inputImage->getPixelAddress(w, h2)+2);
-                    }
-                }
-            }
-        } break;
-
-        case 1: // pixel by pixel, a bit better
-        {
-            if(horizontal)
-            {
-                pixelLeft  = outLeftImage.getRawImage();
-                pixelRight = outRightImage.getRawImage();
-
-                pixelInputL = pixelInput;
-                pixelInputR = pixelInput+singleImage_rowSizeByte;
-                for(int h=0, idx=0, idx2=0; h<outHeight; h++)
-                {
-                    for(int w=0; w<outWidth; w++)
-                    {
-                        pixelLeft[idx++] = *(pixelInputL++);
-                        pixelLeft[idx++] = *(pixelInputL++);
-                        pixelLeft[idx++] = *(pixelInputL++);
-
-                        pixelRight[idx2++] = *(pixelInputR++);
-                        pixelRight[idx2++] = *(pixelInputR++);
-                        pixelRight[idx2++] = *(pixelInputR++);
-                    }
-                    pixelInputL += singleImage_rowSizeByte;
-                    pixelInputR += singleImage_rowSizeByte;
-                }
-            }
-            else
-            {
-
-            }
-        } break;
-
-        case 2: // line by line
-        {
-            if(horizontal)
-            {
-                pixelLeft  = outLeftImage.getRawImage();
-                pixelRight = outRightImage.getRawImage();
-
-                for(int h=0; h<inHeight; h++)
-                {
-                    memcpy(pixelLeft  + h*singleImage_rowSizeByte, pixelInput,                          singleImage_rowSizeByte);
-                    memcpy(pixelRight + h*singleImage_rowSizeByte, pixelInput+=singleImage_rowSizeByte, singleImage_rowSizeByte);
-                    pixelInput+= dualImage_rowSizeByte/2;
-                }
-            }
-            else
-            {
-                pixelLeft  = outLeftImage.getRawImage();
-                pixelRight = outRightImage.getRawImage();
-                pixelInputL = pixelInput;
-                pixelInputR = pixelInput+singleImage_wholeSizeByte;
-
-                for(int h=0; h<outHeight; h++)
-                {
-                    memcpy(pixelLeft  + h*singleImage_rowSizeByte, pixelInputL, singleImage_rowSizeByte);
-                    memcpy(pixelRight + h*singleImage_rowSizeByte, pixelInputR, singleImage_rowSizeByte);
-                    pixelInputL+= singleImage_rowSizeByte;
-                    pixelInputR+= singleImage_rowSizeByte;
-                }
-            }
-        } break;
-
-        case 3: // whole image, only if input image is vertically aligned
-        {
-            if(horizontal)
-            {
-                yError() << "Cannot use this copy method with horizontally aligned source image.";
-            }
-            else
-            {
-                pixelLeft  = outLeftImage.getRawImage();
-                pixelRight = outRightImage.getRawImage();
-
-                memcpy(pixelLeft,  pixelInput,                            singleImage_wholeSizeByte);
-                memcpy(pixelRight, pixelInput+ singleImage_wholeSizeByte, singleImage_wholeSizeByte);
-            }
-        } break;
-
-        default:
-        {
-            yError() << " @line " << __LINE__ << "unhandled switch case, we should not be here!";
-        }
+        yError() << "Cannot split the input image";
+        outLeftPort.unprepare();
+        outRightPort.unprepare();
+        return true;
     }
 
-    static double end = 0;
-    static double elapsed = 0;
-    end = yarp::os::Time::now();
-    elapsed += (end-start);
+    elapsed += yarp::os::Time::now() - start;
 
     counter++;
     if((counter % 100) == 0)
@@ -41,12 +41,15 @@ class BroadcastingThread: public PeriodicThread
 {
 private:
     action_class          *actions;
+    mutex                 *actions_mtx;
     robotDriver           *driver;
     BufferedPort<Bottle>  port_data_out;
 
 public:
     BroadcastingThread(int period=1): PeriodicThread((double)period/1000.0)
     {
+        actions=NULL;
+        actions_mtx=NULL;
         port_data_out.open("/trajectoryPlayer/all_joints_data_out:o");
     }
 
@@ -61,9 +64,9 @@ public:
         if (p)  driver=p;
     }
 
-    void attachActions(action_class *a)
+    void attachActions(action_class *a, mutex *m)
     {
-        if (a)  actions=a;
+        if (a && m)  { actions=a; actions_mtx=m; }
     }
 
     bool threadInit()
@@ -119,20 +122,25 @@ public:
             //invalid driver
         }
 
-        int j = actions->current_action;
-
         Bottle& bot2 = this->port_data_out.prepare();
-        bot2.clear();
-        bot2.addInt32(actions->action_vector[j].counter);
-        bot2.addFloat64(actions->action_vector[j].time);
+        int size = 0;
+        {
+            //the rows point into the trajectory buffer, which the working
+            //thread may swap or unmap while loading: copy them under its lock
+            lock_guard<mutex> lck(*actions_mtx);
+            if (actions->action_vector.size()==0) return;
+            action_struct row = actions->action_vector[actions->current_action];
 
-        int size = this->actions->action_vector[j].get_n_joints();
-        double *ll = actions->action_vector[j].q_joints;
+            bot2.clear();
+            bot2.addInt32(row.counter);
+            bot2.addFloat64(row.time);
 
-        bot2.addString("commands:");
-        for (int ix=0;ix<size;ix++)
-        {
-            bot2.addFloat64(ll[ix]);
+            size = row.get_n_joints();
+            bot2.addString("commands:");
+            for (int ix=0;ix<size;ix++)
+            {
+                bot2.addFloat64(row.q_joints[ix]);
+            }
         }
         bot2.addString("encoders:");
         for (int ix=0;ix<size;ix++)
@@ -206,7 +214,7 @@ public:
         if (!driver) return false;
         if (!enable_execute_joint_command) return true;
 
-        double *ll = actions.action_vector[action_id].q_joints;
+        const double *ll = actions.action_vector[action_id].q_joints;
         int nj = actions.action_vector[action_id].get_n_joints();
 
         for (int j = 0; j < nj; j++)
@@ -223,7 +231,7 @@ public:
         bot.clear();
         bot.addInt32(actions.action_vector[action_id].counter);
         bot.addFloat64(actions.action_vector[action_id].time);
-        bot.addString(actions.action_vector[action_id].tag.c_str());
+        bot.addString(actions.action_vector[action_id].tag);
         //@@@ you can add stuff here...
 
         //send the output command
@@ -250,7 +258,7 @@ public:
         }
 
         //send the joints angles on debug port
-        double *ll = actions.action_vector[action_id].q_joints;
+        const double *ll = actions.action_vector[action_id].q_joints;
         Bottle& bot2 = this->port_command_joints.prepare();
         bot2.clear();
         bot2.addInt32(actions.action_vector[action_id].counter);
@@ -272,6 +280,10 @@ public:
     void run()
     {
         lock_guard<mutex> lck(mtx);
+        if (!actions.update_loading())
+        {
+            yError("unable to load the sequence file");
+        }
         double current_time = yarp::os::Time::now();
         if (actions.current_status==ACTION_IDLE)
         {
@@ -279,12 +291,11 @@ public:
         }
         else if (actions.current_status == ACTION_STOP)
         {
-            int nj = actions.action_vector[0].get_n_joints();
             actions.current_status = ACTION_IDLE;
         }
         else if (actions.current_status == ACTION_RESET)
         {
-            int nj = actions.action_vector[0].get_n_joints();
+            int nj = actions.action_vector.get_n_joints();
             for (int j = 0; j < nj; j++)
             {
                 driver->setControlMode(j, VOCAB_CM_POSITION);
@@ -341,7 +352,7 @@ public:
         {
             if (actions.action_vector.size()>0)
             {
-                double *ll = actions.action_vector[0].q_joints;
+                const double *ll = actions.action_vector[0].q_joints;
                 int nj = actions.action_vector[0].get_n_joints();
                 for (int j = 0; j < nj; j++)
                 {
@@ -406,6 +417,10 @@ public:
                     }
                 }
             }
+            else if (actions.loading)
+            {
+                //wait for the background loader
+            }
             else
             {
                 yWarning("no sequence in memory");
@@ -430,6 +445,15 @@ protected:
     WorkingThread       w_thread;
     BroadcastingThread  b_thread;
 
+    void resume()
+    {
+        //restart the clock from the current action, so that playback
+        //continues from there instead of catching up
+        action_class &actions = w_thread.actions;
+        w_thread.start_time = yarp::os::Time::now() - actions.action_vector[actions.current_action].time;
+        actions.current_status = ACTION_RUNNING;
+    }
+
 public:
     scriptModule() 
     {
@@ -494,6 +518,8 @@ public:
         }
         yInfo() << "Using parameters:"  << rf.toString();
 
+        w_thread.actions.use_cache = !rf.check("no_cache");
+
         //*** open the position file
         yInfo() << "opening file...";
         if (rf.check("filename")==true)
@@ -575,6 +601,7 @@ public:
                         cout << "load" << endl;
                         cout << "forever" << endl;
                         cout << "list" << endl;
+                        cout << "seek <time>" << endl;
                         reply.addVocab32("many");
                         reply.addVocab32("ack");
                         reply.addString("Available commands:");
@@ -586,16 +613,17 @@ public:
                         reply.addString("load");
                         reply.addString("forever");
                         reply.addString("list");
+                        reply.addString("seek <time>");
                     }
                 else if  (cmdstring == "start")
                     {
                         if (this->w_thread.actions.current_action == 0)
                             this->w_thread.actions.current_status = ACTION_START;
                         else
-                            this->w_thread.actions.current_status = ACTION_RUNNING;
+                            resume();
                         this->w_thread.actions.forever = false;
 
-                        this->b_thread.attachActions(&w_thread.actions);
+                        this->b_thread.attachActions(&w_thread.actions, &w_thread.mtx);
                         if (this->b_thread.isRunning()==false) b_thread.start();
 
                         reply.addVocab32("ack");
@@ -605,7 +633,7 @@ public:
                         if (this->w_thread.actions.current_action == 0)
                             this->w_thread.actions.current_status = ACTION_START;
                         else
-                            this->w_thread.actions.current_status = ACTION_RUNNING;
+                            resume();
                         w_thread.actions.forever = true;
                         reply.addVocab32("ack");
                     }
@@ -637,14 +665,14 @@ public:
                 else if  (cmdstring == "load")
                     {
                         string filename = command.get(1).asString().c_str();
-                        if (!w_thread.actions.openFile(filename, robot.n_joints))
+                        if (!w_thread.actions.openFile(filename, robot.n_joints, false))
                         {
-                            yError() << "Unable to parse file";
+                            yError() << "Unable to load file";
                             reply.addVocab32("error");
                         }
                         else
                         {
-                            yInfo() << "File opened";
+                            yInfo() << "Loading file in background";
                             reply.addVocab32("ack");
                         }
                     }
@@ -662,6 +690,23 @@ public:
                         this->w_thread.actions.print();
                         reply.addVocab32("ack");
                     }
+                else if  (cmdstring == "seek")
+                    {
+                        if (w_thread.actions.action_vector.size()==0 || (!command.get(1).isFloat64() && !command.get(1).isInt32()))
+                        {
+                            yError() << "Unable to seek: empty sequence or invalid time";
+                            reply.addVocab32("error");
+                        }
+                        else
+                        {
+                            size_t i = w_thread.actions.action_vector.find(command.get(1).asFloat64());
+                            w_thread.actions.current_action = i;
+                            if (w_thread.actions.current_status == ACTION_RUNNING)
+                                resume();
+                            reply.addVocab32("ack");
+                            reply.addInt32((int)i);
+                        }
+                    }
                 else
                     {
                         reply.addVocab32("nack");
@@ -709,11 +754,21 @@ int main(int argc, char *argv[])
         yInfo() << "\t--execute      activate the iPid->setReference() control";
         yInfo() << "\t--period       <period>: the period in ms of the internal thread (default 5)";
         yInfo() << "\t--verbose      to display additional infos";
+        yInfo() << "\t--no_cache     do not use/create the binary cache <filename>.cache";
+        yInfo() << "\t--benchmark    <filename>:  measure loading time and memory of a file (with --joints) and exit";
+        yInfo() << "\t--rows         <n>:         with --benchmark, first generate a file of n rows";
         return 0;
     }
 
     Network yarp;
 
+    if (rf.check("benchmark"))
+    {
+        int n_joints = rf.check("joints", Value(6)).asInt32();
+        int rows = rf.check("rows", Value(0)).asInt32();
+        return benchmark_loading(rf.find("benchmark").asString(), n_joints, rows) ? 0 : -1;
+    }
+
     if (!yarp.checkNetwork())
     {
         yError() << "yarp.checkNetwork() failed.";
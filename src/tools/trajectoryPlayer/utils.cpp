@@ -35,6 +35,17 @@
 #include <string>
 #include <vector>
 #include <deque>
+#include <algorithm>
+#include <cstring>
+#include <cstdio>
+#include <cmath>
+#include <sys/stat.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
 
 using namespace std;
 using namespace yarp::os;
@@ -44,165 +55,531 @@ using namespace yarp::math;
 
 #include "utils.h"
 
-// ******************** ACTION CLASS
+// ******************** TRAJECTORY BUFFER
+#define TRAJECTORY_CACHE_MAGIC  "TPCACHE1"
 
-int action_struct::get_n_joints()
-{ 
-    return N_JOINTS;
+// binary cache layout (native endianness), followed by
+// double time[rows], double q[rows][n_joints], int32 counter[rows]
+struct trajectory_cache_header
+{
+    char     magic[8];
+    int64_t  src_size;
+    int64_t  src_mtime;
+    double   fix_time;
+    int32_t  n_joints;
+    int32_t  reserved;
+    uint64_t rows;
+};
+
+static size_t cache_length(const trajectory_cache_header &h)
+{
+    return sizeof(trajectory_cache_header) + (size_t)h.rows*sizeof(double) +
+           (size_t)h.rows*h.n_joints*sizeof(double) + (size_t)h.rows*sizeof(int32_t);
 }
 
-action_struct::action_struct(int n)
+static bool check_cache_header(const trajectory_cache_header &h, int64_t src_size, int64_t src_mtime, double fix_time, int n_joints)
 {
-    N_JOINTS = n;
-    q_joints = new double [N_JOINTS];
-    for (int i=0; i<N_JOINTS; i++) q_joints[i]=0.0;
-    tag = "UNKNOWN";
+    return (memcmp(h.magic, TRAJECTORY_CACHE_MAGIC, sizeof(h.magic))==0) &&
+           (h.src_size==src_size) && (h.src_mtime==src_mtime) &&
+           (h.fix_time==fix_time) && (h.n_joints==n_joints);
 }
 
-action_struct::action_struct(const action_struct& as)
+static double resident_memory_mb()
 {
-    N_JOINTS = as.N_JOINTS;
-    counter = as.counter;
-    time = as.time;
-    tag = as.tag;
-    q_joints = new double [N_JOINTS];
-    for (int i=0; i< N_JOINTS; i++)
+#ifdef __linux__
+    long pages_total=0, pages_resident=0;
+    FILE* f = fopen("/proc/self/statm","r");
+    if (f)
     {
-        q_joints[i]=as.q_joints[i];
+        if (fscanf(f, "%ld %ld", &pages_total, &pages_resident)!=2) pages_resident=0;
+        fclose(f);
     }
+    return (double)pages_resident*sysconf(_SC_PAGESIZE)/(1024.0*1024.0);
+#else
+    return -1.0;
+#endif
+}
+
+trajectory_buffer::trajectory_buffer()
+{
+    N_JOINTS = 0;
+    n_rows = 0;
+    map_addr = 0;
+    map_len = 0;
+    update_pointers();
+}
+
+trajectory_buffer::~trajectory_buffer()
+{
+    unmap();
+}
+
+void trajectory_buffer::update_pointers()
+{
+    if (map_addr) return;
+    counter_p = counter_v.data();
+    time_p = time_v.data();
+    q_p = q_v.data();
 }
 
-action_struct & action_struct::operator=(const action_struct & as)
+void trajectory_buffer::unmap()
 {
-    if(this == &as)
-        return *this;
-    N_JOINTS = as.N_JOINTS;
-    counter = as.counter;
-    time = as.time;
-    tag = as.tag;
-    q_joints = new double [N_JOINTS];
-    for (int i=0; i< N_JOINTS; i++)
+    if (map_addr)
     {
-        q_joints[i]=as.q_joints[i];
+#ifndef _WIN32
+        munmap(map_addr, map_len);
+#endif
+        map_addr = 0;
+        map_len = 0;
     }
-    return *this;
 }
 
-action_struct::~action_struct()
+void trajectory_buffer::materialize()
+{
+    if (!map_addr) return;
+    counter_v.assign(counter_p, counter_p+n_rows);
+    time_v.assign(time_p, time_p+n_rows);
+    q_v.assign(q_p, q_p+n_rows*N_JOINTS);
+    unmap();
+    update_pointers();
+}
+
+void trajectory_buffer::clear()
+{
+    unmap();
+    //release the memory, not just the content
+    std::vector<int32_t>().swap(counter_v);
+    std::vector<double>().swap(time_v);
+    std::vector<double>().swap(q_v);
+    N_JOINTS = 0;
+    n_rows = 0;
+    update_pointers();
+}
+
+void trajectory_buffer::reserve(size_t rows, int n_joints)
+{
+    materialize();
+    counter_v.reserve(rows);
+    time_v.reserve(rows);
+    q_v.reserve(rows*n_joints);
+    update_pointers();
+}
+
+void trajectory_buffer::swap(trajectory_buffer &other)
+{
+    std::swap(N_JOINTS, other.N_JOINTS);
+    std::swap(n_rows, other.n_rows);
+    counter_v.swap(other.counter_v);
+    time_v.swap(other.time_v);
+    q_v.swap(other.q_v);
+    std::swap(counter_p, other.counter_p);
+    std::swap(time_p, other.time_p);
+    std::swap(q_p, other.q_p);
+    std::swap(map_addr, other.map_addr);
+    std::swap(map_len, other.map_len);
+    update_pointers();
+    other.update_pointers();
+}
+
+size_t trajectory_buffer::memory_usage() const
+{
+    if (map_addr) return map_len;
+    return counter_v.capacity()*sizeof(int32_t) + time_v.capacity()*sizeof(double) + q_v.capacity()*sizeof(double);
+}
+
+action_struct trajectory_buffer::operator[](size_t i) const
+{
+    action_struct a;
+    a.counter  = counter_p[i];
+    a.time     = time_p[i];
+    a.q_joints = q_p + i*N_JOINTS;
+    a.tag      = "UNKNOWN";
+    a.n_joints = N_JOINTS;
+    return a;
+}
+
+bool trajectory_buffer::append(int counter, double time, const double* q, int n_joints)
 {
-    if (q_joints)
-    { 
-        delete []q_joints;
-        q_joints = 0;
+    if (n_rows==0) N_JOINTS = n_joints;
+    if (n_joints != N_JOINTS)
+    {
+        yError("trajectory has %d joints, cannot add a row with %d joints", N_JOINTS, n_joints);
+        return false;
     }
+    materialize();
+    counter_v.push_back(counter);
+    time_v.push_back(time);
+    q_v.insert(q_v.end(), q, q+n_joints);
+    n_rows++;
+    update_pointers();
+    return true;
 }
 
-void action_class::clear()
+bool trajectory_buffer::append(const trajectory_buffer &other, int counter_offset, double time_offset)
 {
-    forever = false;
-    current_action = 0;
-    current_status = ACTION_IDLE;
-    action_vector.clear();
+    if (other.n_rows==0) return true;
+    if (n_rows==0) N_JOINTS = other.N_JOINTS;
+    if (other.N_JOINTS != N_JOINTS)
+    {
+        yError("trajectory has %d joints, cannot append a sequence with %d joints", N_JOINTS, other.N_JOINTS);
+        return false;
+    }
+    materialize();
+    counter_v.reserve(n_rows+other.n_rows);
+    time_v.reserve(n_rows+other.n_rows);
+    for (size_t i=0; i<other.n_rows; i++)
+    {
+        counter_v.push_back(other.counter_p[i]+counter_offset);
+        time_v.push_back(other.time_p[i]+time_offset);
+    }
+    q_v.insert(q_v.end(), other.q_p, other.q_p+other.n_rows*N_JOINTS);
+    n_rows += other.n_rows;
+    update_pointers();
+    return true;
 }
 
-action_class::action_class()
+bool trajectory_buffer::insert(int counter, double time, const double* q, int n_joints)
+{
+    if (n_rows==0) N_JOINTS = n_joints;
+    if (n_joints != N_JOINTS)
+    {
+        yError("trajectory has %d joints, cannot add a row with %d joints", N_JOINTS, n_joints);
+        return false;
+    }
+    materialize();
+    //insertion in the vector based on the timestamp
+    size_t pos = std::upper_bound(time_v.begin(), time_v.end(), time) - time_v.begin();
+    counter_v.insert(counter_v.begin()+pos, counter);
+    time_v.insert(time_v.begin()+pos, time);
+    q_v.insert(q_v.begin()+pos*N_JOINTS, q, q+n_joints);
+    n_rows++;
+    update_pointers();
+    return true;
+}
+
+size_t trajectory_buffer::find(double t) const
+{
+    //rows are sorted by time, so the timestamps are the index
+    if (n_rows==0) return 0;
+    size_t i = std::lower_bound(time_p, time_p+n_rows, t) - time_p;
+    return (i<n_rows) ? i : n_rows-1;
+}
+
+bool trajectory_buffer::save_cache(const string &filename, int64_t src_size, int64_t src_mtime, double fix_time) const
 {
+    trajectory_cache_header h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, TRAJECTORY_CACHE_MAGIC, sizeof(h.magic));
+    h.src_size  = src_size;
+    h.src_mtime = src_mtime;
+    h.fix_time  = fix_time;
+    h.n_joints  = N_JOINTS;
+    h.rows      = n_rows;
+
+    FILE* f = fopen(filename.c_str(), "wb");
+    if (f==NULL) return false;
+    bool ok = (fwrite(&h, sizeof(h), 1, f)==1);
+    ok = ok && (fwrite(time_p, sizeof(double), n_rows, f)==n_rows);
+    ok = ok && (fwrite(q_p, sizeof(double), n_rows*N_JOINTS, f)==n_rows*N_JOINTS);
+    ok = ok && (fwrite(counter_p, sizeof(int32_t), n_rows, f)==n_rows);
+    ok = (fclose(f)==0) && ok;
+    if (!ok) remove(filename.c_str());
+    return ok;
+}
+
+bool trajectory_buffer::map_cache(const string &filename, int64_t src_size, int64_t src_mtime, double fix_time, int n_joints)
+{
+    trajectory_cache_header h;
+#ifndef _WIN32
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd<0) return false;
+    struct stat st;
+    if ((fstat(fd, &st)!=0) || ((size_t)st.st_size<sizeof(h)))
+    {
+        close(fd);
+        return false;
+    }
+    void* addr = mmap(0, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (addr==MAP_FAILED) return false;
+
+    memcpy(&h, addr, sizeof(h));
+    if (!check_cache_header(h, src_size, src_mtime, fix_time, n_joints) || (cache_length(h)!=(size_t)st.st_size))
+    {
+        munmap(addr, (size_t)st.st_size);
+        return false;
+    }
+    //playback walks the rows in order
+    madvise(addr, (size_t)st.st_size, MADV_SEQUENTIAL);
+
     clear();
+    map_addr  = addr;
+    map_len   = (size_t)st.st_size;
+    N_JOINTS  = n_joints;
+    n_rows    = (size_t)h.rows;
+    time_p    = (const double*)((const char*)addr + sizeof(h));
+    q_p       = time_p + n_rows;
+    counter_p = (const int32_t*)(q_p + n_rows*N_JOINTS);
+    return true;
+#else
+    FILE* f = fopen(filename.c_str(), "rb");
+    if (f==NULL) return false;
+    bool ok = (fread(&h, sizeof(h), 1, f)==1) && check_cache_header(h, src_size, src_mtime, fix_time, n_joints);
+    if (ok)
+    {
+        clear();
+        n_rows = (size_t)h.rows;
+        N_JOINTS = n_joints;
+        time_v.resize(n_rows);
+        q_v.resize(n_rows*N_JOINTS);
+        counter_v.resize(n_rows);
+        ok = (fread(time_v.data(), sizeof(double), n_rows, f)==n_rows) &&
+             (fread(q_v.data(), sizeof(double), n_rows*N_JOINTS, f)==n_rows*N_JOINTS) &&
+             (fread(counter_v.data(), sizeof(int32_t), n_rows, f)==n_rows);
+        update_pointers();
+        if (!ok) clear();
+    }
+    fclose(f);
+    return ok;
+#endif
 }
 
-void action_class::print()
+// ******************** TRAJECTORY LOADER
+trajectory_loader::trajectory_loader()
+{
+    n_joints = 0;
+    fix_time = 0.0;
+    use_cache = false;
+    ok = false;
+    done = true;
+    aborting = false;
+}
+
+bool trajectory_loader::load(const string &file, int n, double fixTime, bool cache)
 {
-    for (action_it=action_vector.begin(); action_it<action_vector.end(); action_it++)
+    if (isRunning()) return false;
+    filename  = file;
+    n_joints  = n;
+    fix_time  = fixTime;
+    use_cache = cache;
+    ok = false;
+    done = false;
+    aborting = false;
+    buffer.clear();
+    if (!start())
     {
-        yInfo ("%d %f ",action_it->counter,action_it->time);
-        for (int i=0; i< action_it->get_n_joints(); i++)
-            yInfo("%f ", action_it->q_joints[i]);
-        yInfo ("\n");
+        done = true;
+        return false;
     }
+    return true;
 }
 
-bool action_class::openFile(string filename, int n_joints)
+bool trajectory_loader::take(trajectory_buffer &dest)
 {
-    bool ret = true;
-    FILE* data_file = 0;
-    data_file = fopen(filename.c_str(),"r");
-    if (data_file!=NULL)
+    join();
+    dest.swap(buffer);
+    buffer.clear();
+    return ok;
+}
+
+void trajectory_loader::parse_line(const char* b, const char* e, vector<double> &q, double &time)
+{
+    const char* p = b;
+    int j = 0;
+    while (j < n_joints)
+    {
+        while (p<e && (*p==' ' || *p=='\t' || *p=='\r')) p++;
+        if (p>=e) break;
+        //the token cannot cross the end of the line, which is always '\n' or '\0'
+        char* endp = 0;
+        double v = strtod(p, &endp);
+        q[j++] = (endp==p) ? 0.0 : v;
+        p = endp;
+        while (p<e && *p!=' ' && *p!='\t' && *p!='\r') p++;
+    }
+    if (j==0) return; //blank line
+    for (; j < n_joints; j++) q[j] = 0.0;
+
+    buffer.append((int)buffer.size(), time, q.data(), n_joints);
+    time = time + fix_time;
+}
+
+bool trajectory_loader::parse_file(int64_t file_size)
+{
+    FILE* data_file = fopen(filename.c_str(), "rb");
+    if (data_file==NULL)
+    {
+        yError("unable to open file %s", filename.c_str());
+        return false;
+    }
+
+    std::vector<char> chunk(1<<20);
+    std::string carry;
+    vector<double> q(n_joints, 0.0);
+    double time = 0.0;
+    bool first = true;
+    size_t n;
+    while (!aborting && ((n = fread(chunk.data(), 1, chunk.size(), data_file)) > 0))
     {
-        char* bb = 0;
-        int   line =0;
-        do
+        const char* line = chunk.data();
+        const char* end = line + n;
+
+        //guess the number of rows from the first chunk to avoid reallocations
+        if (first)
         {
-            char command_line[1024];
-            bb = fgets (command_line, 1024, data_file);
-            if (bb == 0) break;
-            //if(!parseCommandLine(command_line, line++))
-            //  if(!parseCommandLineFixTime(command_line, line++, 1.0/25.0)) //25hz
-            if(!parseCommandLineFixTime(command_line, line++, 1.0/50.0, n_joints)) //50hz
-                {
-                    yError ("error parsing file, line %d\n", line);
-                    ret = false;
-                    break;
-                };
+            size_t lines = std::count(line, end, '\n');
+            if (lines > 0)
+            {
+                buffer.reserve((size_t)(1.05*(double)file_size*lines/n)+1, n_joints);
+            }
+            first = false;
         }
-        while (1);
 
-        fclose (data_file);
+        const char* nl;
+        while ((nl = (const char*)memchr(line, '\n', end-line)) != 0)
+        {
+            if (!carry.empty())
+            {
+                carry.append(line, nl);
+                parse_line(carry.c_str(), carry.c_str()+carry.size(), q, time);
+                carry.clear();
+            }
+            else
+            {
+                parse_line(line, nl, q, time);
+            }
+            line = nl+1;
+        }
+        carry.append(line, end);
     }
-    else 
+    if (!carry.empty() && !aborting)
     {
-        yError("unable to find file\n");
-        ret = false;
+        parse_line(carry.c_str(), carry.c_str()+carry.size(), q, time);
     }
-    return ret;
+
+    bool ret = (ferror(data_file)==0);
+    fclose(data_file);
+    if (!ret) yError("error reading file %s", filename.c_str());
+    return ret && !aborting;
 }
 
-bool action_class::parseCommandLineFixTime(const char* command_line, int line, double fixTime, int n_joints)
+void trajectory_loader::run()
 {
-    static int count = 0;
-    static double time =0.0;
-    action_struct tmp_action(n_joints);
+    double t0 = yarp::os::Time::now();
+    struct stat st;
+    if (stat(filename.c_str(), &st)!=0)
+    {
+        yError("unable to find file %s", filename.c_str());
+        ok = false;
+        done = true;
+        return;
+    }
 
-    tmp_action.counter = count; count = count + 1;
-    tmp_action.time    = time;  time = time+fixTime;
-        
-    char* tok;
-    size_t ss = strlen(command_line);
-    char* cline = new char [ss];
-    strcpy(cline,command_line);
-    tok = strtok (cline," ");
-    int i=0;
-    int joints_count = 0;
-    while (tok != 0 && joints_count < n_joints)
+    string cache_file = filename + ".cache";
+    const char* source = "cache";
+    if (!use_cache || !buffer.map_cache(cache_file, (int64_t)st.st_size, (int64_t)st.st_mtime, fix_time, n_joints))
     {
-        sscanf(tok, "%lf", &tmp_action.q_joints[i++]);
-        tok = strtok (NULL," ");
-        joints_count++;
+        source = "text";
+        ok = parse_file((int64_t)st.st_size);
+        if (ok && use_cache && !buffer.save_cache(cache_file, (int64_t)st.st_size, (int64_t)st.st_mtime, fix_time))
+        {
+            yWarning("unable to write cache file %s", cache_file.c_str());
+        }
+    }
+    else
+    {
+        ok = true;
     }
 
-    //insertion in the vector based on the timestamp
-    /*for (action_it=action_vector.begin(); action_it<action_vector.end(); action_it++)
+    if (ok)
     {
-        if (tmp_action.time > action_it->time) break;
+        yInfo("loaded %zu rows of %d joints from %s (%s) in %.3f s; buffer %.1f MB, resident memory %.1f MB",
+              buffer.size(), n_joints, filename.c_str(), source, yarp::os::Time::now()-t0,
+              buffer.memory_usage()/(1024.0*1024.0), resident_memory_mb());
     }
-    action_vector.insert(action_it,tmp_action);*/
+    done = true;
+}
 
-    if (action_vector.size()==0) 
+// ******************** ACTION CLASS
+void action_class::clear()
+{
+    //a file still being loaded is dropped together with the sequence
+    if (loading)
     {
-        action_vector.push_back(tmp_action);
-        return true;
+        loader.abort();
+        trajectory_buffer dropped;
+        loader.take(dropped);
+        loading = false;
+    }
+    forever = false;
+    current_action = 0;
+    current_status = ACTION_IDLE;
+    action_vector.clear();
+}
+
+action_class::action_class()
+{
+    use_cache = true;
+    fix_time = 1.0/50.0; //50hz
+    loading = false;
+    clear();
+}
+
+void action_class::print()
+{
+    for (size_t i=0; i<action_vector.size(); i++)
+    {
+        action_struct a = action_vector[i];
+        yInfo ("%d %f ",a.counter,a.time);
+        for (int j=0; j< a.get_n_joints(); j++)
+            yInfo("%f ", a.q_joints[j]);
+        yInfo ("\n");
     }
+}
 
-    for (action_it=action_vector.end()-1; action_it>=action_vector.begin(); action_it--)
+bool action_class::openFile(string filename, int n_joints, bool wait)
+{
+    if (loading)
+    {
+        yError("file %s is still being loaded", filename.c_str());
+        return false;
+    }
+    if (!loader.load(filename, n_joints, fix_time, use_cache))
     {
-        if (tmp_action.time > action_it->time) break;
+        yError("unable to start loading %s", filename.c_str());
+        return false;
     }
-    action_vector.insert(action_it+1,tmp_action);
-    return true;
+    loading = true;
+    if (!wait) return true;
+
+    loader.join();
+    return update_loading();
+}
+
+bool action_class::update_loading()
+{
+    if (!loading || !loader.is_done()) return true;
+    loading = false;
+
+    trajectory_buffer loaded;
+    if (!loader.take(loaded)) return false;
+
+    if (action_vector.size()==0)
+    {
+        action_vector.swap(loaded);
+        return true;
+    }
+
+    //a new file is queued after the sequence already in memory
+    action_struct last = action_vector[action_vector.size()-1];
+    return action_vector.append(loaded, last.counter+1, last.time+fix_time);
 }
 
 bool action_class::parseCommandLine(const char* command_line, int line, int n_joints)
 {
-    action_struct tmp_action(n_joints);
+    int counter = 0;
+    double time = 0.0;
+    vector<double> q(std::max(n_joints, 6), 0.0);
     //use strtok for runtime-defined number of entries
     char command_line_format [1000];
     sprintf(command_line_format, "%%d %%lf    ");
@@ -213,29 +590,76 @@ bool action_class::parseCommandLine(const char* command_line, int line, int n_jo
     }
 
     int ret = sscanf(command_line, "%d %lf    %lf %lf %lf %lf %lf %lf", 
-    &tmp_action.counter,
-    &tmp_action.time,
+    &counter,
+    &time,
             
-    &tmp_action.q_joints[0],
-    &tmp_action.q_joints[1],
-    &tmp_action.q_joints[2],
-    &tmp_action.q_joints[3],
-    &tmp_action.q_joints[4],
-    &tmp_action.q_joints[5]
+    &q[0],
+    &q[1],
+    &q[2],
+    &q[3],
+    &q[4],
+    &q[5]
     );
 
     if (ret == n_joints+2) 
     {
-        //insertion in the vector based on the timestamp
-        for (action_it=action_vector.begin(); action_it<action_vector.end(); action_it++)
-            if (tmp_action.time > action_it->time) break;
-        action_vector.insert(action_it,tmp_action);
-        return true;
+        return action_vector.insert(counter, time, q.data(), n_joints);
     }
             
     return false;
 }
 
+// ******************** LOADING BENCHMARK
+bool benchmark_loading(const string &filename, int n_joints, int rows)
+{
+    if (rows > 0)
+    {
+        yInfo("generating %d rows of %d joints in %s", rows, n_joints, filename.c_str());
+        FILE* f = fopen(filename.c_str(), "w");
+        if (f==NULL)
+        {
+            yError("unable to create %s", filename.c_str());
+            return false;
+        }
+        for (int i=0; i<rows; i++)
+        {
+            for (int j=0; j<n_joints; j++)
+                fprintf(f, "%.3f ", 30.0*sin(2.0*M_PI*(0.1+0.01*j)*i/50.0));
+            fprintf(f, "\n");
+        }
+        fclose(f);
+    }
+    remove((filename+".cache").c_str());
+
+    yInfo("resident memory before loading: %.1f MB", resident_memory_mb());
+    double checksum = 0.0;
+    for (int pass=0; pass<2; pass++)
+    {
+        //first pass parses the text and writes the cache, second pass maps it
+        action_class actions;
+        double t0 = yarp::os::Time::now();
+        if (!actions.openFile(filename, n_joints))
+        {
+            yError("unable to load %s", filename.c_str());
+            return false;
+        }
+        double dt = yarp::os::Time::now()-t0;
+
+        t0 = yarp::os::Time::now();
+        size_t seeks = 100000;
+        size_t n = actions.action_vector.size();
+        double duration = (n>0) ? actions.action_vector[n-1].time : 0.0;
+        for (size_t i=0; i<seeks; i++)
+            checksum += actions.action_vector[actions.action_vector.find(duration*(i%1000)/1000.0)].counter;
+        double dt_seek = yarp::os::Time::now()-t0;
+
+        yInfo("%s: %zu rows, load %.3f s, buffer %.1f MB, resident memory %.1f MB, seek %.3f us",
+              (pass==0) ? "text" : "cache", n, dt, actions.action_vector.memory_usage()/(1024.0*1024.0),
+              resident_memory_mb(), 1e6*dt_seek/seeks);
+    }
+    yDebug("checksum %f", checksum);
+    return true;
+}
 
 // ******************** ROBOT DRIVER CLASS
 robotDriver::robotDriver()
@@ -36,6 +36,8 @@
 #include <vector>
 #include <deque>
 #include <map>
+#include <atomic>
+#include <cstdint>
 
 using namespace std;
 using namespace yarp::os;
@@ -58,40 +60,113 @@ using namespace yarp::math;
 #define ACTION_RESET   4
 
 // ******************** ACTION CLASS
-class action_struct
+// lightweight view of one row of the trajectory buffer
+struct action_struct
 {
-    int         N_JOINTS;
+    int           counter;
+    double        time;
+    const double* q_joints;
+    const char*   tag;
+    int           n_joints;
+
+    int get_n_joints() const { return n_joints; }
+};
+
+// the whole trajectory stored as a structure of arrays: either owned
+// by the buffer or memory-mapped straight from a binary cache file
+class trajectory_buffer
+{
+    int                  N_JOINTS;
+    size_t               n_rows;
+    std::vector<int32_t> counter_v;
+    std::vector<double>  time_v;
+    std::vector<double>  q_v;
+
+    const int32_t*       counter_p;
+    const double*        time_p;
+    const double*        q_p;
+    void*                map_addr;
+    size_t               map_len;
+
+    void update_pointers();
+    void unmap();
+    void materialize();
+
+    trajectory_buffer(const trajectory_buffer&);
+    trajectory_buffer & operator=(const trajectory_buffer&);
+
 public:
-    int         counter;
-    double      time;
-    double*     q_joints;
-    string      tag;
+    trajectory_buffer();
+    ~trajectory_buffer();
+
+    void   clear();
+    void   reserve(size_t rows, int n_joints);
+    void   swap(trajectory_buffer &other);
+    size_t size() const { return n_rows; }
+    int    get_n_joints() const { return N_JOINTS; }
+    bool   is_mapped() const { return map_addr!=0; }
+    size_t memory_usage() const;
+
+    action_struct operator[](size_t i) const;
+    bool   append(int counter, double time, const double* q, int n_joints);
+    bool   append(const trajectory_buffer &other, int counter_offset, double time_offset);
+    bool   insert(int counter, double time, const double* q, int n_joints);
+    size_t find(double t) const;
+
+    bool   save_cache(const string &filename, int64_t src_size, int64_t src_mtime, double fix_time) const;
+    bool   map_cache(const string &filename, int64_t src_size, int64_t src_mtime, double fix_time, int n_joints);
+};
+
+// parses a trajectory file in chunks on its own thread; blank lines
+// (empty or made of white spaces only) are skipped and do not count
+// as samples, hence they do not advance the time either
+class trajectory_loader: public Thread
+{
+    string            filename;
+    int               n_joints;
+    double            fix_time;
+    bool              use_cache;
+    bool              ok;
+    std::atomic<bool> done;
+    std::atomic<bool> aborting;
+    trajectory_buffer buffer;
+
+    bool parse_file(int64_t file_size);
+    void parse_line(const char* b, const char* e, vector<double> &q, double &time);
 
 public:
-    int get_n_joints();
-    action_struct(int n);
-    action_struct(const action_struct& as);
-    action_struct & operator=(const action_struct & as);
-    ~action_struct();
+    trajectory_loader();
+    bool load(const string &file, int n, double fixTime, bool cache);
+    bool is_done() const { return done; }
+    void abort() { aborting = true; }
+    bool take(trajectory_buffer &dest);
+    void run() override;
 };
 
 class action_class
 {
 public:
-    size_t         current_action;
-    int            current_status;
-    bool           forever;
-    std::deque<action_struct> action_vector;
-    std::deque<action_struct>::iterator action_it;
+    size_t            current_action;
+    int               current_status;
+    bool              forever;
+    bool              use_cache;
+    double            fix_time;
+    trajectory_buffer action_vector;
+    trajectory_loader loader;
+    bool              loading;
 
     void clear();
     action_class();
     void print();
-    bool openFile(string filename, int n_joints);
-    bool parseCommandLineFixTime(const char* command_line, int line, double fixTime, int n_joints);
+    bool openFile(string filename, int n_joints, bool wait=true);
+    bool update_loading();
     bool parseCommandLine(const char* command_line, int line, int n_joints);
 };
 
+// loads a (optionally generated) file from text and then from its cache,
+// reporting load time, memory and seek time
+bool benchmark_loading(const string &filename, int n_joints, int rows);
+
 // ******************** ROBOT DRIVER CLASS
 class robotDriver
 {
@@ -0,0 +1,433 @@
+/*
+ * Copyright (C) 2022 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include "ReplayEngine.h"
+
+#include <yarp/os/LogStream.h>
+#include <yarp/os/Time.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+
+using namespace yarp::os;
+using namespace yarp::dev;
+using namespace std;
+
+
+void SampleWindow::resize(size_t samples, size_t numAxes) {
+    m_capacity = std::max<size_t>(samples, 2);
+    m_stride = numAxes + 1;
+    m_buffer.assign(m_capacity * m_stride, 0.0);
+    m_head = 0;
+    m_tail = 0;
+}
+
+double* SampleWindow::beginWrite() {
+    size_t h = m_head.load(std::memory_order_relaxed);
+    if (h - m_tail.load(std::memory_order_acquire) >= m_capacity) {
+        return nullptr;
+    }
+    return &m_buffer[(h % m_capacity) * m_stride];
+}
+
+void SampleWindow::commitWrite() {
+    m_head.store(m_head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+size_t SampleWindow::size() const {
+    return m_head.load(std::memory_order_acquire) - m_tail.load(std::memory_order_relaxed);
+}
+
+const double* SampleWindow::peek(size_t i) const {
+    if (i >= size()) {
+        return nullptr;
+    }
+    return &m_buffer[((m_tail.load(std::memory_order_relaxed) + i) % m_capacity) * m_stride];
+}
+
+void SampleWindow::pop() {
+    m_tail.store(m_tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+
+bool PartTrack::open(const std::string& partName, const std::string& dataFile,
+                     yarp::dev::PolyDriver& driver, size_t windowSize, bool simulator) {
+    m_partName = partName;
+    m_simulator = simulator;
+    m_isArm = m_partName.find("arm") != std::string::npos;
+
+    bool ok = driver.view(m_posDir);
+    ok &= driver.view(m_enc);
+    ok &= driver.view(m_CM);
+    ok &= driver.view(m_posControl);
+    ok &= driver.view(m_controlLimits);
+    if (!ok) {
+        yError()<<"PartTrack: missing interfaces for part"<<m_partName;
+        return false;
+    }
+
+    m_posDir->getAxes(&m_numAxes);
+    m_ref.assign(m_numAxes, 0.0);
+    m_currState.assign(m_numAxes, 0.0);
+    m_min.assign(m_numAxes, 0.0);
+    m_max.assign(m_numAxes, 0.0);
+    m_limitWarned.assign(m_numAxes, false);
+    for (int i = 0; i<m_numAxes; i++) {
+        m_controlLimits->getLimits(i, &m_min[i], &m_max[i]);
+    }
+
+    m_file.open(dataFile);
+    if (!m_file.is_open()) {
+        yError()<<"PartTrack: unable to open"<<dataFile<<"for part"<<m_partName;
+        return false;
+    }
+    m_window.resize(windowSize, m_numAxes);
+    m_eof = false;
+    return true;
+}
+
+void PartTrack::close() {
+    if (m_file.is_open()) {
+        m_file.close();
+    }
+}
+
+bool PartTrack::parseLine(const std::string& line, double* sample) {
+    // yarpdatadumper lines are "<counter> <time> [<tx time>] <values>",
+    // possibly with the values enclosed in a list
+    m_tokens.clear();
+    const char* p = line.c_str();
+    while (*p != '\0') {
+        if (std::isspace(static_cast<unsigned char>(*p)) || *p == '(' || *p == ')') {
+            p++;
+            continue;
+        }
+        char* end = nullptr;
+        double v = std::strtod(p, &end);
+        if (end == p) {
+            return false;
+        }
+        m_tokens.push_back(v);
+        p = end;
+    }
+
+    if (m_tokens.size() < static_cast<size_t>(m_numAxes) + 2) {
+        return false;
+    }
+    sample[0] = m_tokens[1];
+    std::copy(m_tokens.end() - m_numAxes, m_tokens.end(), sample + 1);
+    return true;
+}
+
+bool PartTrack::fill() {
+    if (m_eof) {
+        return false;
+    }
+    std::string line;
+    while (double* sample = m_window.beginWrite()) {
+        if (!std::getline(m_file, line)) {
+            m_eof = true;
+            return false;
+        }
+        m_line++;
+        if (line.empty()) {
+            continue;
+        }
+        if (!parseLine(line, sample)) {
+            yWarning()<<"PartTrack: skipping malformed line"<<m_line<<"of part"<<m_partName;
+            continue;
+        }
+        m_window.commitWrite();
+    }
+    return true;
+}
+
+double PartTrack::firstTime() const {
+    const double* s = m_window.peek(0);
+    return s ? s[0] : std::numeric_limits<double>::infinity();
+}
+
+PartTrack::status PartTrack::reference(double t) {
+    // read before peeking, so that all the samples committed before eof are visible
+    bool eof = m_eof;
+    const double* s0 = m_window.peek(0);
+    if (!s0) {
+        if (eof) {
+            return status::done;
+        }
+        m_underruns++;
+        return m_hasRef ? status::underrun : status::waiting;
+    }
+    if (t < s0[0]) {
+        return m_hasRef ? status::ok : status::waiting;
+    }
+
+    // drop the samples already played
+    const double* s1 = m_window.peek(1);
+    while (s1 && s1[0] <= t) {
+        m_window.pop();
+        s0 = s1;
+        s1 = m_window.peek(1);
+    }
+
+    if (!s1) {
+        if (!eof) {
+            m_underruns++;
+            return m_hasRef ? status::underrun : status::waiting;
+        }
+        // last sample of the dataset
+        std::copy(s0 + 1, s0 + 1 + m_numAxes, m_ref.begin());
+        m_window.pop();
+    } else {
+        double dt = s1[0] - s0[0];
+        double a = (dt > 0.0) ? (t - s0[0]) / dt : 1.0;
+        for (int i = 0; i<m_numAxes; i++) {
+            m_ref[i] = s0[i+1] + a * (s1[i+1] - s0[i+1]);
+        }
+    }
+
+    for (int i = 0; i<m_numAxes; i++) {
+        if (m_ref[i]<m_min[i] || m_ref[i]>m_max[i]) {
+            if (!m_limitWarned[i]) {
+                yWarning()<<"PartTrack: joint"<<i<<"of"<<m_partName<<"exceeds the limits with"<<m_ref[i]<<", saturating";
+                m_limitWarned[i] = true;
+            }
+            m_ref[i] = std::min(std::max(m_ref[i], m_min[i]), m_max[i]);
+        }
+    }
+    m_hasRef = true;
+    return status::ok;
+}
+
+bool PartTrack::checkTolerance(double tolerance) {
+    if (m_simulator) {
+        return true;
+    }
+    if (!m_enc->getEncoders(m_currState.data())) {
+        yWarning()<<"PartTrack: unable to read the encoders of"<<m_partName;
+        return false;
+    }
+    for (int i = 0; i<m_numAxes; i++) {
+        if (m_isArm && i >= 5) { // 5 is for ignoring the hands in the security check
+            continue;
+        }
+        auto delta = std::fabs(m_ref[i] - m_currState[i]);
+        if (delta >= tolerance) {
+            yWarning()<<"PartTrack: joint"<<i<<"of"<<m_partName<<"is too far to the target position";
+            yWarning()<<"Desired: "<<m_ref[i]<<"current: "<<m_currState[i]<<"delta: "<<delta
+                      <<"Trying to reach it in Position Control, the playback will be paused";
+            return false;
+        }
+    }
+    return true;
+}
+
+bool PartTrack::send() {
+    return m_posDir->setPositions(m_ref.data());
+}
+
+bool PartTrack::positionMoveFallback() {
+    std::vector<int> cms (m_numAxes, VOCAB_CM_POSITION);
+    if (!m_CM->setControlModes(cms.data())) {
+        return false;
+    }
+    if (!m_posControl->positionMove(m_ref.data())) {
+        return false;
+    }
+    bool done{false};
+    while (!done) {
+        if (!m_posControl->checkMotionDone(&done)) {
+            return false;
+        }
+        if (!done) {
+            yarp::os::Time::delay(0.01);
+        }
+    }
+    std::vector<int> cmDir (m_numAxes, VOCAB_CM_POSITION_DIRECT);
+    return m_CM->setControlModes(cmDir.data());
+}
+
+
+void ReplayEngine::Loader::run() {
+    while (!isStopping()) {
+        bool pending{false};
+        for (auto& part : m_parts) {
+            pending |= part->fill();
+        }
+        if (!pending) {
+            break;
+        }
+        yarp::os::Time::delay(0.005);
+    }
+}
+
+ReplayEngine::ReplayEngine(double period) : PeriodicThread(period),
+                                            m_loader(m_parts),
+                                            m_period(period) {
+}
+
+ReplayEngine::~ReplayEngine() {
+    if (m_loader.isRunning()) {
+        m_loader.stop();
+    }
+}
+
+bool ReplayEngine::addPart(const std::string& partName, const std::string& dataFile,
+                           yarp::dev::PolyDriver& driver, size_t windowSize, bool simulator) {
+    auto part = std::make_unique<PartTrack>();
+    if (!part->open(partName, dataFile, driver, windowSize, simulator)) {
+        return false;
+    }
+    m_parts.push_back(std::move(part));
+    m_status.resize(m_parts.size(), PartTrack::status::waiting);
+    return true;
+}
+
+bool ReplayEngine::threadInit() {
+    if (m_parts.empty()) {
+        yError()<<"ReplayEngine: no parts to replay";
+        return false;
+    }
+
+    // prebuffer the look-ahead windows before starting the clock
+    m_dataStart = std::numeric_limits<double>::infinity();
+    for (auto& part : m_parts) {
+        part->fill();
+        m_dataStart = std::min(m_dataStart, part->firstTime());
+    }
+    if (std::isinf(m_dataStart)) {
+        yError()<<"ReplayEngine: the datasets are empty";
+        return false;
+    }
+
+    // reach the initial pose of every part in position control
+    for (auto& part : m_parts) {
+        if (part->reference(part->firstTime()) != PartTrack::status::ok) {
+            continue;
+        }
+        yInfo()<<"ReplayEngine: moving"<<part->getName()<<"to the initial position";
+        if (!part->positionMoveFallback()) {
+            yError()<<"ReplayEngine: unable to reach the initial position of"<<part->getName();
+            return false;
+        }
+    }
+
+    if (!m_loader.start()) {
+        return false;
+    }
+    m_t0 = yarp::os::Time::now();
+    return true;
+}
+
+void ReplayEngine::run() {
+    double now = yarp::os::Time::now();
+    if (m_paused || m_done) {
+        return;
+    }
+
+    // the same playback time for all the parts keeps them synchronized
+    double t = m_dataStart + (now - m_t0) * m_speed;
+    bool allDone{true};
+    for (size_t i = 0; i<m_parts.size(); i++) {
+        m_status[i] = m_parts[i]->reference(t);
+        allDone &= (m_status[i] == PartTrack::status::done);
+        if (m_status[i] == PartTrack::status::ok && !m_parts[i]->checkTolerance(m_tolerance)) {
+            m_faultyPart = m_parts[i].get();
+            m_pausedAt = now;
+            m_error = true;
+            m_paused = true;
+            return;
+        }
+    }
+
+    // references are sent back-to-back once all of them are ready
+    double t1 = yarp::os::Time::now();
+    for (size_t i = 0; i<m_parts.size(); i++) {
+        if (m_status[i] == PartTrack::status::ok) {
+            m_parts[i]->send();
+        }
+    }
+    double send = yarp::os::Time::now() - t1;
+
+    if (allDone) {
+        m_done = true;
+    }
+
+    std::lock_guard<std::mutex> lck(m_statsMutex);
+    if (m_lastTick > 0.0) {
+        double dt = now - m_lastTick;
+        m_dtSum += dt;
+        m_dtSum2 += dt * dt;
+        m_maxJitter = std::max(m_maxJitter, std::fabs(dt - m_period));
+        int elapsedTicks = static_cast<int>(std::floor(dt / m_period + 0.5));
+        if (elapsedTicks > 1) {
+            m_missedTicks += elapsedTicks - 1;
+        }
+    }
+    m_lastTick = now;
+    m_sendSum += send;
+    m_maxSend = std::max(m_maxSend, send);
+    m_ticks++;
+}
+
+void ReplayEngine::threadRelease() {
+    m_loader.stop();
+    printStats();
+}
+
+bool ReplayEngine::recover() {
+    if (!m_faultyPart) {
+        return false;
+    }
+    if (!m_faultyPart->positionMoveFallback()) {
+        return false;
+    }
+
+    // resume the playback from where it was paused
+    {
+        std::lock_guard<std::mutex> lck(m_statsMutex);
+        m_lastTick = -1.0;
+    }
+    m_t0 += yarp::os::Time::now() - m_pausedAt;
+    m_faultyPart = nullptr;
+    m_error = false;
+    m_paused = false;
+    return true;
+}
+
+ReplayEngine::Stats ReplayEngine::getStats() {
+    std::lock_guard<std::mutex> lck(m_statsMutex);
+    Stats stats;
+    size_t n = (m_ticks > 1) ? m_ticks - 1 : 0;
+    stats.ticks = m_ticks;
+    stats.meanPeriod = (n > 0) ? m_dtSum / n : 0.0;
+    stats.stdPeriod = (n > 1) ? std::sqrt(std::max(0.0, m_dtSum2 / n - stats.meanPeriod * stats.meanPeriod)) : 0.0;
+    stats.maxJitter = m_maxJitter;
+    stats.missedTicks = m_missedTicks;
+    stats.meanSend = (m_ticks > 0) ? m_sendSum / m_ticks : 0.0;
+    stats.maxSend = m_maxSend;
+    for (auto& part : m_parts) {
+        stats.underruns += part->getUnderruns();
+    }
+    return stats;
+}
+
+void ReplayEngine::printStats() {
+    Stats stats = getStats();
+    yInfo()<<"ReplayEngine: ticks"<<stats.ticks<<"period[ms]"<<1e3*m_period<<"mean[ms]"<<1e3*stats.meanPeriod
+           <<"std[ms]"<<1e3*stats.stdPeriod<<"max_jitter[ms]"<<1e3*stats.maxJitter<<"missed_ticks"<<stats.missedTicks
+           <<"send_mean[ms]"<<1e3*stats.meanSend<<"send_max[ms]"<<1e3*stats.maxSend;
+    for (auto& part : m_parts) {
+        if (part->getUnderruns() > 0) {
+            yWarning()<<"ReplayEngine:"<<part->getName()<<"had"<<part->getUnderruns()<<"buffer underruns";
+        }
+    }
+}
@@ -0,0 +1,181 @@
+/*
+ * Copyright (C) 2022 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef WHOLEBODYPLAYER_REPLAYENGINE_H
+#define WHOLEBODYPLAYER_REPLAYENGINE_H
+
+#include <yarp/os/PeriodicThread.h>
+#include <yarp/os/Thread.h>
+#include <yarp/dev/IPositionDirect.h>
+#include <yarp/dev/IPositionControl.h>
+#include <yarp/dev/IControlMode.h>
+#include <yarp/dev/IEncoders.h>
+#include <yarp/dev/IControlLimits.h>
+#include <yarp/dev/PolyDriver.h>
+
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * Fixed-size single-producer/single-consumer window of samples,
+ * each stored as [time, q_0 ... q_n-1].
+ */
+class SampleWindow
+{
+public:
+    void resize(size_t samples, size_t numAxes);
+    double* beginWrite();   // nullptr if the window is full
+    void commitWrite();
+    size_t size() const;
+    const double* peek(size_t i) const;  // i-th oldest sample, nullptr if not available
+    void pop();
+
+private:
+    std::vector<double> m_buffer;
+    size_t m_capacity{0};
+    size_t m_stride{0};
+    std::atomic<size_t> m_head{0};
+    std::atomic<size_t> m_tail{0};
+};
+
+
+/**
+ * One part of the robot: the dataset it replays and the interfaces
+ * of the control board it commands.
+ */
+class PartTrack
+{
+public:
+    enum class status : std::uint8_t {
+        waiting = 0,    // the part has not started yet
+        ok,
+        underrun,       // the loader did not keep up, the last reference is held
+        done
+    };
+
+    bool open(const std::string& partName, const std::string& dataFile,
+              yarp::dev::PolyDriver& driver, size_t windowSize, bool simulator);
+    void close();
+
+    // producer side: returns false once the whole file has been buffered
+    bool fill();
+
+    // consumer side
+    double firstTime() const;
+    status reference(double t);
+    bool checkTolerance(double tolerance);
+    bool send();
+    bool positionMoveFallback();
+
+    const std::string& getName() const { return m_partName; }
+    size_t getUnderruns() const { return m_underruns; }
+
+private:
+    bool parseLine(const std::string& line, double* sample);
+
+    std::string m_partName{};
+    std::ifstream m_file;
+    size_t m_line{0};
+    std::atomic<bool> m_eof{false};
+    SampleWindow m_window;
+
+    yarp::dev::IPositionDirect* m_posDir{nullptr};
+    yarp::dev::IEncoders* m_enc{nullptr};
+    yarp::dev::IControlMode* m_CM{nullptr};
+    yarp::dev::IPositionControl* m_posControl{nullptr};
+    yarp::dev::IControlLimits* m_controlLimits{nullptr};
+
+    std::vector<double> m_tokens;
+    std::vector<double> m_ref, m_currState, m_min, m_max;
+    std::vector<bool> m_limitWarned;
+    int m_numAxes{0};
+    bool m_simulator{false};
+    bool m_isArm{false};
+    bool m_hasRef{false};
+    std::atomic<size_t> m_underruns{0};
+};
+
+
+/**
+ * Replays the logged datasets of all parts from a single deadline-driven
+ * thread: the same playback time is used for every part at each tick and
+ * the references are linearly interpolated to the control rate, while a
+ * background loader keeps the look-ahead windows filled.
+ */
+class ReplayEngine : public yarp::os::PeriodicThread
+{
+public:
+    explicit ReplayEngine(double period);
+    ~ReplayEngine() override;
+
+    bool addPart(const std::string& partName, const std::string& dataFile,
+                 yarp::dev::PolyDriver& driver, size_t windowSize, bool simulator);
+    void setSpeed(double speed) { m_speed = speed; }
+    void setTolerance(double tolerance) { m_tolerance = tolerance; }
+
+    bool threadInit() override;
+    void run() override;
+    void threadRelease() override;
+
+    bool inError() const { return m_error; }
+    bool recover();
+    bool isDone() const { return m_done; }
+
+    struct Stats
+    {
+        size_t ticks{0};
+        double meanPeriod{0.0};     // [s]
+        double stdPeriod{0.0};      // [s]
+        double maxJitter{0.0};      // [s], largest deviation of a period from the nominal one
+        size_t missedTicks{0};
+        double meanSend{0.0};       // [s], time spent sending the references of all the parts in a tick
+        double maxSend{0.0};        // [s]
+        size_t underruns{0};        // of all the parts
+    };
+    Stats getStats();
+    void printStats();
+
+private:
+    class Loader : public yarp::os::Thread
+    {
+    public:
+        explicit Loader(std::vector<std::unique_ptr<PartTrack>>& parts) : m_parts(parts) {}
+        void run() override;
+    private:
+        std::vector<std::unique_ptr<PartTrack>>& m_parts;
+    };
+
+    std::vector<std::unique_ptr<PartTrack>> m_parts;
+    std::vector<PartTrack::status> m_status;
+    Loader m_loader;
+    double m_period;
+    double m_speed{1.0};
+    double m_tolerance{5.0};
+    double m_dataStart{0.0};
+    double m_t0{0.0};
+    double m_pausedAt{0.0};
+    std::atomic<bool> m_paused{false};
+    std::atomic<bool> m_error{false};
+    std::atomic<bool> m_done{false};
+    PartTrack* m_faultyPart{nullptr};
+
+    // timing instrumentation
+    std::mutex m_statsMutex;
+    double m_lastTick{-1.0};
+    double m_dtSum{0.0}, m_dtSum2{0.0}, m_maxJitter{0.0};
+    double m_sendSum{0.0}, m_maxSend{0.0};
+    size_t m_ticks{0};
+    size_t m_missedTicks{0};
+};
+
+#endif // WHOLEBODYPLAYER_REPLAYENGINE_H
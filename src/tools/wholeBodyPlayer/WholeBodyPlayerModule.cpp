@@ -23,6 +23,22 @@ double WholeBodyPlayerModule::getPeriod() {
 
 bool WholeBodyPlayerModule::updateModule() {
 
+    if (m_engine) {
+        if (m_engine->inError() && !m_engine->recover()) {
+            yError()<<"wholeBodyPlayer: the replay is stopped because the fallback failed.. closing";
+            return false;
+        }
+        if (Time::now() - m_lastStats > 5.0) {
+            m_engine->printStats();
+            m_lastStats = Time::now();
+        }
+        if (m_engine->isDone()) {
+            yInfo()<<"wholeBodyPlayer: replay completed";
+            return false;
+        }
+        return true;
+    }
+
     for (auto& rep : m_replayerVec){
         if (rep.m_replayPort->m_state == state::fatal_error) {
             yError()<<"wholeBodyPlayer: the port"<<rep.m_replayPort->getName()<<"is closed because something went wrong.. closing";
@@ -69,6 +85,17 @@ bool WholeBodyPlayerModule::configure(yarp::os::ResourceFinder& rf) {
        return false;
     }
 
+    auto dataset = rf.check("dataset",Value("")).asString();
+    auto device = rf.check("device",Value("remote_controlboard")).asString();
+    Property deviceConf;
+    if (rf.check("device-config")) {
+        auto configFile = rf.findFileByName(rf.find("device-config").asString());
+        if (configFile.empty() || !deviceConf.fromConfigFile(configFile)) {
+            yError()<<"wholeBodyPlayerModule: unable to read the device configuration"<<rf.find("device-config").asString();
+            return false;
+        }
+    }
+
     m_replayerVec.resize(partsBot->size());
 
     for (size_t i = 0; i<partsBot->size(); i++) {
@@ -78,13 +105,35 @@ bool WholeBodyPlayerModule::configure(yarp::os::ResourceFinder& rf) {
             yError()<<"wholeBodyPlayerModule: the part"<<partStr<<"is not available";
             return false;
         }
-        if (!m_replayerVec[i].open(robot, partStr, name))
+        if (!m_replayerVec[i].open(robot, partStr, name, device, &deviceConf, dataset.empty()))
         {
             yError()<<"wholeBodyPlayerModule: failed to open one replayer.. closing.";
             return false;
         }
     }
 
+    if (!dataset.empty()) {
+        auto period = rf.check("period",Value(0.01)).asFloat64();
+        auto window = rf.check("window",Value(1000)).asInt32();
+        m_engine = std::make_unique<ReplayEngine>(period);
+        m_engine->setSpeed(rf.check("speed",Value(1.0)).asFloat64());
+        m_engine->setTolerance(tolerance);
+        for (size_t i = 0; i<partsBot->size(); i++) {
+            auto partStr = partsBot->get(i).asString();
+            if (!m_engine->addPart(partStr, dataset+"/"+partStr+"/data.log", *m_replayerVec[i].m_remoteControlBoard,
+                                   static_cast<size_t>(std::max(window, 2)), m_replayerVec[i].m_simulator)) {
+                yError()<<"wholeBodyPlayerModule: failed to load the dataset of"<<partStr<<".. closing.";
+                return false;
+            }
+        }
+        if (!m_engine->start()) {
+            yError()<<"wholeBodyPlayerModule: failed to start the replay engine";
+            return false;
+        }
+        m_lastStats = Time::now();
+        return true;
+    }
+
     if (!m_rpcPort.open("/"+name+"/rpc:o")) {
         yError()<<"wholeBodyPlayerModule: failed to open"<<m_rpcPort.getName();
         return false;
@@ -104,13 +153,19 @@ bool WholeBodyPlayerModule::respond(const yarp::os::Bottle& command, yarp::os::B
 
 bool WholeBodyPlayerModule::interruptModule() {
     for (auto& rep : m_replayerVec){
-        rep.m_replayPort->interrupt();
+        if (rep.m_replayPort) {
+            rep.m_replayPort->interrupt();
+        }
     }
     m_rpcPort.interrupt();
     return true;
 }
 
 bool WholeBodyPlayerModule::close() {
+    if (m_engine) {
+        m_engine->stop();
+        m_engine.reset();
+    }
     for (auto& rep : m_replayerVec){
         rep.close();
     }
@@ -28,6 +28,22 @@
  * --robot  The name of the robot to be controlled (e.g icub, icubSim, cer). icub is the default value.
  * --name   The prefix to be given to the ports of the module. wholeBodyPlayer is the default value.
  * --parts  List of parts to be controlled. It has to be from one to all the following parts: "(head torso left_arm right_arm left_leg right_arm)"
+ * --dataset  Directory of a dataset logged by yarpdatadumper, with one <part>/data.log for each part. When given, the
+ *            module replays the dataset by itself instead of listening to yarpdataplayer (see below).
+ * --period   Period in seconds of the replay thread, i.e. the rate of the references sent in dataset mode. 0.01 is the default value.
+ * --window   Number of samples of each part buffered ahead of the playback time in dataset mode. 1000 is the default value.
+ * --speed    Playback speed factor in dataset mode. 1.0 is the default value.
+ * --device   Device opened for each part instead of remote_controlboard, e.g. fakeMotionControl to try a dataset offline.
+ * --device-config  Configuration file passed to the device given with --device.
+ *
+ * \section dataset Dataset mode
+ * In dataset mode a background thread reads the data.log files and keeps a look-ahead window of samples for each part,
+ * while a single periodic thread computes the playback time, linearly interpolates the samples of every part at that
+ * time and sends all the references back-to-back. Parts therefore stay synchronized to the logged timestamps
+ * regardless of the port delivery. The same tolerance check of the port mode applies: the playback is paused, the
+ * part reaches the target in position control, then the playback resumes. The command timing statistics (jitter,
+ * missed ticks, time spent sending) are printed every 5 seconds and at the end; the module closes once all the
+ * parts have been replayed.
  *
  * \section ports Ports
  * This module open one port for each part controlled, from which it receive data from yarpdataplayer.
@@ -35,6 +51,8 @@
  *
  * /<name>/<part>/state:i
  *
+ * No port is opened in dataset mode.
+ *
  * \section tested_os_sec Tested OS
  * Windows, Linux
  * \author Nicolo' Genesio
@@ -59,6 +77,8 @@
 #include <mutex>
 #include <yarp/os/RpcClient.h>
 
+#include "ReplayEngine.h"
+
 constexpr double tolerance = 5.0; //degrees
 
 enum class state : std::uint8_t {
@@ -202,11 +222,22 @@ private:
 struct Replayer {
     std::unique_ptr<ReplayPort> m_replayPort{nullptr};
     std::unique_ptr<yarp::dev::PolyDriver> m_remoteControlBoard{nullptr};
+    bool m_simulator{false};
 
-    bool open(const std::string& robot, const std::string& part, const std::string& moduleName="wholeBodyPlayer") {
+    bool open(const std::string& robot, const std::string& part, const std::string& moduleName="wholeBodyPlayer",
+              const std::string& device="remote_controlboard", const yarp::os::Property* deviceConf=nullptr,
+              bool usePort=true) {
         yarp::os::Property conf {{"device", yarp::os::Value("remote_controlboard")},
                                  {"remote", yarp::os::Value("/"+robot+"/"+part)},
                                  {"local",  yarp::os::Value("/"+moduleName+"/"+part+"/remoteControlBoard")}};
+        if (device != "remote_controlboard") {
+            conf.clear();
+            if (deviceConf) {
+                conf.fromString(deviceConf->toString());
+            }
+            conf.put("device", device);
+            conf.put("name", "/"+moduleName+"/"+part);
+        }
 
         yarp::dev::IControlMode* iCM{nullptr};
         yarp::dev::IPositionDirect* iPosDir{nullptr};
@@ -217,6 +248,7 @@ struct Replayer {
 
         if(robot == "icubSim")
             simulator=true;
+        m_simulator = simulator;
 
         m_remoteControlBoard = std::make_unique<yarp::dev::PolyDriver>();
 
@@ -231,7 +263,7 @@ struct Replayer {
         ok &= m_remoteControlBoard->view(iPosControl);
         ok &= m_remoteControlBoard->view(iControlLimits);
 
-        if (ok)
+        if (ok && usePort)
         {
             m_replayPort = std::make_unique<ReplayPort>(part, iPosDir, iEnc, iCM, iPosControl,iControlLimits, simulator);
             ok &= m_replayPort->open("/"+moduleName+"/"+part+"/state:i");
@@ -240,8 +272,12 @@ struct Replayer {
     }
 
     void close() {
-        m_replayPort->close();
-        m_remoteControlBoard->close();
+        if (m_replayPort) {
+            m_replayPort->close();
+        }
+        if (m_remoteControlBoard) {
+            m_remoteControlBoard->close();
+        }
     }
 };
 
@@ -264,6 +300,8 @@ public:
 
 private:
     std::vector<Replayer> m_replayerVec;
+    std::unique_ptr<ReplayEngine> m_engine{nullptr};
+    double m_lastStats{0.0};
     yarp::os::RpcClient   m_rpcPort;
     yarp::os::Bottle reqPause{"pause"}, reqPlay{"play"}, response;
 
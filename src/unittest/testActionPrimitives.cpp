@@ -0,0 +1,147 @@
+/*
+ * Copyright (C) 2022 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <yarp/sig/Matrix.h>
+#include <yarp/sig/Vector.h>
+
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include <iCub/action/actionPrimitives.h>
+
+using iCub::action::blendWayPoints;
+using yarp::sig::Matrix;
+using yarp::sig::Vector;
+
+namespace
+{
+// the periods are powers of 2, hence the times of the waypoints fall exactly on the samples
+constexpr double dt = 1.0 / 64.0;
+
+Vector point(double q0, double q1)
+{
+    Vector q(2);
+    q[0] = q0;
+    q[1] = q1;
+    return q;
+}
+
+Vector noLimits(double sign)
+{
+    return Vector(2, sign * std::numeric_limits<double>::max());
+}
+}  // namespace
+
+TEST(ActionPrimitives, blendWayPoints_timing_positive_001)
+{
+    std::vector<double> t{0.0, 0.5, 1.5, 2.0};
+    std::vector<Vector> qWP{point(0.0, 0.0), point(10.0, -5.0), point(-10.0, 5.0), point(5.0, 20.0)};
+
+    Matrix traj;
+    std::vector<size_t> wpSample;
+    ASSERT_TRUE(blendWayPoints(t, qWP, dt, noLimits(-1.0), noLimits(1.0), traj, wpSample));
+
+    // one sample per period, the first one at dt and the last one at the final time
+    ASSERT_EQ(traj.rows(), 128u);
+    ASSERT_EQ(traj.cols(), 2u);
+    ASSERT_EQ(wpSample.size(), 3u);
+    EXPECT_EQ(wpSample[0], 31u);
+    EXPECT_EQ(wpSample[1], 95u);
+    EXPECT_EQ(wpSample[2], 127u);
+
+    // the waypoints are attained at their times
+    for (size_t m = 0; m < wpSample.size(); m++)
+        for (size_t j = 0; j < 2; j++)
+            EXPECT_NEAR(traj(wpSample[m], j), qWP[m + 1][j], 1e-9) << "waypoint " << m + 1 << " joint " << j;
+}
+
+TEST(ActionPrimitives, blendWayPoints_blending_positive_001)
+{
+    std::vector<double> t{0.0, 1.0, 2.0, 3.0};
+    std::vector<Vector> qWP{point(0.0, 0.0), point(1.0, -1.0), point(2.0, -2.0), point(3.0, -3.0)};
+
+    Matrix traj;
+    std::vector<size_t> wpSample;
+    ASSERT_TRUE(blendWayPoints(t, qWP, dt, noLimits(-1.0), noLimits(1.0), traj, wpSample));
+    ASSERT_EQ(traj.rows(), 192u);
+
+    for (size_t j = 0; j < 2; j++)
+    {
+        double sign = (j == 0 ? 1.0 : -1.0);
+
+        // at rest at both ends
+        EXPECT_LT(std::fabs(traj(0, j) - qWP[0][j]) / dt, 0.05);
+        EXPECT_LT(std::fabs(traj(191, j) - traj(190, j)) / dt, 0.05);
+
+        // the intermediate waypoints are passed through without stopping and without
+        // corners: the velocity is the same on both sides of the waypoint
+        for (size_t m = 0; m < 2; m++)
+        {
+            size_t s = wpSample[m];
+            double vl = (traj(s, j) - traj(s - 1, j)) / dt;
+            double vr = (traj(s + 1, j) - traj(s, j)) / dt;
+            EXPECT_GT(sign * vl, 1.0) << "waypoint " << m + 1 << " joint " << j;
+            EXPECT_GT(sign * vr, 1.0) << "waypoint " << m + 1 << " joint " << j;
+            EXPECT_LT(std::fabs(vl - vr), 0.05) << "waypoint " << m + 1 << " joint " << j;
+        }
+
+        // the motion is monotonic as the waypoints are
+        for (size_t s = 1; s < traj.rows(); s++)
+            EXPECT_GT(sign * (traj(s, j) - traj(s - 1, j)), 0.0) << "sample " << s << " joint " << j;
+    }
+}
+
+TEST(ActionPrimitives, blendWayPoints_limits_positive_001)
+{
+    // the samples beyond the limits are clipped, the other joint keeps its peak
+    std::vector<double> t{0.0, 0.5, 1.0};
+    std::vector<Vector> qWP{point(0.0, 0.0), point(10.0, 10.0), point(0.0, 0.0)};
+    Vector qMin = point(-1.0, -100.0);
+    Vector qMax = point(9.0, 100.0);
+
+    Matrix traj;
+    std::vector<size_t> wpSample;
+    ASSERT_TRUE(blendWayPoints(t, qWP, dt, qMin, qMax, traj, wpSample));
+
+    double peak = -std::numeric_limits<double>::max();
+    for (size_t s = 0; s < traj.rows(); s++)
+    {
+        EXPECT_GE(traj(s, 0), qMin[0]);
+        EXPECT_LE(traj(s, 0), qMax[0]);
+        peak = std::max(peak, traj(s, 1));
+    }
+
+    EXPECT_EQ(traj(wpSample[0], 0), qMax[0]);
+    EXPECT_NEAR(peak, 10.0, 1e-9);
+}
+
+TEST(ActionPrimitives, blendWayPoints_wrong_input_negative_001)
+{
+    Matrix traj;
+    std::vector<size_t> wpSample;
+
+    // a single point
+    EXPECT_FALSE(blendWayPoints({0.0}, {point(0.0, 0.0)}, dt, noLimits(-1.0), noLimits(1.0), traj, wpSample));
+
+    // times and points do not match
+    EXPECT_FALSE(blendWayPoints({0.0, 1.0}, {point(0.0, 0.0)}, dt, noLimits(-1.0), noLimits(1.0), traj, wpSample));
+
+    // times not increasing
+    EXPECT_FALSE(blendWayPoints({0.0, 1.0, 1.0}, {point(0.0, 0.0), point(1.0, 1.0), point(2.0, 2.0)}, dt, noLimits(-1.0),
+                                noLimits(1.0), traj, wpSample));
+
+    // wrong period
+    EXPECT_FALSE(blendWayPoints({0.0, 1.0}, {point(0.0, 0.0), point(1.0, 1.0)}, 0.0, noLimits(-1.0), noLimits(1.0), traj,
+                                wpSample));
+
+    // points and limits of different sizes
+    EXPECT_FALSE(blendWayPoints({0.0, 1.0}, {point(0.0, 0.0), Vector(3, 1.0)}, dt, noLimits(-1.0), noLimits(1.0), traj,
+                                wpSample));
+}
@@ -0,0 +1,253 @@
+/*
+ * Copyright (C) 2022 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <yarp/math/Math.h>
+#include <yarp/math/SVD.h>
+#include <yarp/sig/Matrix.h>
+#include <yarp/sig/Vector.h>
+
+#include <algorithm>
+#include <cmath>
+
+#include "gtest/gtest.h"
+#include "testRandom.h"
+#include <iCub/iKin/iKinFwd.h>
+#include <iCub/iKin/iKinInv.h>
+
+using iCub::iKin::DLSSolver;
+using iCub::iKin::iCubArm;
+using iCub::iKin::iKinChain;
+using iCub::iKin::LMCtrl;
+using iCub::iKin::LMCtrl_GPM;
+using iCub::iKin::SteepCtrl;
+using yarp::sig::Matrix;
+using yarp::sig::Vector;
+
+namespace
+{
+// the former way of the controllers, through the SVD
+Matrix referencePinv(const Matrix &A)
+{
+    if (A.rows() >= A.cols())
+        return yarp::math::pinv(A);
+    else
+        return yarp::math::pinv(A.transposed()).transposed();
+}
+
+double referenceMinSingularValue(const Matrix &A)
+{
+    Matrix B = (A.rows() >= A.cols()) ? A : A.transposed();
+    Matrix U(B.rows(), B.cols()), V(B.cols(), B.cols());
+    Vector S(B.cols());
+    yarp::math::SVD(B, U, S, V);
+    return S[S.length() - 1];
+}
+
+// random joints angles within the limits
+Vector randomPose(unsigned int &seed, iKinChain &chain)
+{
+    Vector q(chain.getDOF());
+    for (unsigned int i = 0; i < chain.getDOF(); i++)
+        q[i] = chain(i).getMin() + 0.5 * (1.0 + 0.8 * nextRand(seed)) * (chain(i).getMax() - chain(i).getMin());
+    return q;
+}
+
+// gives access to the inverses computed by the controller
+class LMCtrlProbe : public LMCtrl
+{
+public:
+    LMCtrlProbe(iKinChain &c) : LMCtrl(c, IKINCTRL_POSE_FULL, 1.0, 1e-2, 2.0, 0.5, 1e-6, 1.0) {}
+    const Matrix &get_pinvJ() const { return pinvJ; }
+    const Matrix &get_pinvLM() const { return pinvLM; }
+    double get_svMin() const { return svMin; }
+};
+} // namespace
+
+TEST(DLSSolver, matches_svd_positive_001)
+{
+    unsigned int seed = 3;
+    const size_t cols[] = {3, 6, 7, 10};
+    for (size_t n : cols)
+    {
+        Matrix J = randomMatrix(seed, 6, n);
+        DLSSolver dls;
+        ASSERT_TRUE(dls.setJacobian(J));
+        ASSERT_TRUE(dls.factorize());
+
+        Matrix pinvJ = dls.getPinv();
+        ASSERT_EQ(pinvJ.rows(), n);
+        ASSERT_EQ(pinvJ.cols(), 6);
+        EXPECT_LT(maxDeviation(pinvJ, referencePinv(J)), 1e-10) << "n " << n;
+        EXPECT_NEAR(dls.getMinSingularValue(), referenceMinSingularValue(J), 1e-10) << "n " << n;
+
+        Vector e = randomVector(seed, 6, 1.0);
+        EXPECT_LT(maxDeviation(dls.solve(e), pinvJ * e), 1e-12) << "n " << n;
+
+        // projections onto the null space do not move the task
+        Vector z = randomVector(seed, n, 1.0);
+        Vector zN = dls.projectNullSpace(z);
+        EXPECT_LT(maxDeviation(zN, dls.getNullSpaceProjector() * z), 1e-12) << "n " << n;
+        if (n > 6)
+            EXPECT_LT(yarp::math::norm(J * zN), 1e-10) << "n " << n;
+        else
+            EXPECT_LT(yarp::math::norm(zN), 1e-10) << "n " << n;
+    }
+}
+
+TEST(DLSSolver, damped_and_weighted_positive_001)
+{
+    unsigned int seed = 5;
+    const size_t cols[] = {3, 7, 10};
+    for (size_t n : cols)
+    {
+        Matrix J = randomMatrix(seed, 6, n);
+        Vector w(n);
+        Matrix W(n, n);
+        W.zero();
+        for (size_t i = 0; i < n; i++)
+            W(i, i) = w[i] = 0.5 * (1.0 + nextRand(seed));
+        Matrix JWJt = J * W * J.transposed();
+
+        DLSSolver dls;
+        ASSERT_TRUE(dls.setJacobian(J, w));
+        EXPECT_FALSE(dls.setJacobian(J, Vector(n + 1, 1.0)));
+        ASSERT_TRUE(dls.setJacobian(J, w));
+
+        // damping lambda*I
+        ASSERT_TRUE(dls.factorize(0.3));
+        Matrix A = JWJt;
+        for (int i = 0; i < 6; i++)
+            A(i, i) += 0.3;
+        Matrix P = W * J.transposed() * yarp::math::pinv(A);
+        EXPECT_LT(maxDeviation(dls.getPinv(), P), 1e-10) << "n " << n;
+
+        Vector e = randomVector(seed, 6, 1.0);
+        EXPECT_LT(maxDeviation(dls.solve(e), P * e), 1e-10) << "n " << n;
+        Vector z = randomVector(seed, n, 1.0);
+        Matrix Pn = yarp::math::eye(n, n) - P * J;
+        EXPECT_LT(maxDeviation(dls.projectNullSpace(z), Pn * z), 1e-10) << "n " << n;
+
+        // Marquardt damping lambda*diag(J*W*Jt) on the same Gram matrix
+        ASSERT_TRUE(dls.factorize(0.1, true));
+        A = JWJt;
+        for (int i = 0; i < 6; i++)
+            A(i, i) += 0.1 * A(i, i);
+        P = W * J.transposed() * yarp::math::pinv(A);
+        EXPECT_LT(maxDeviation(dls.getPinv(), P), 1e-10) << "n " << n;
+    }
+}
+
+TEST(DLSSolver, near_singular_positive_001)
+{
+    unsigned int seed = 7;
+    Matrix J = randomMatrix(seed, 6, 7);
+    J.setRow(5, J.getRow(4));
+
+    // the Cholesky factorization gives up in favor of the SVD
+    DLSSolver dls;
+    ASSERT_TRUE(dls.setJacobian(J));
+    EXPECT_FALSE(dls.factorize());
+    EXPECT_LT(dls.getMinSingularValue(), 1e-6);
+
+    // while the damping restores it
+    EXPECT_TRUE(dls.factorize(1e-3));
+    Matrix A = J * J.transposed();
+    for (int i = 0; i < 6; i++)
+        A(i, i) += 1e-3;
+    EXPECT_LT(maxDeviation(dls.getPinv(), J.transposed() * yarp::math::pinv(A)), 1e-8);
+
+    EXPECT_FALSE(dls.setJacobian(Matrix(0, 0)));
+    EXPECT_FALSE(dls.factorize());
+}
+
+TEST(DLSSolver, warm_start_along_trajectory_positive_001)
+{
+    unsigned int seed = 11;
+    iCubArm arm("right");
+    arm.releaseLink(0);
+    arm.releaseLink(1);
+    arm.releaseLink(2);
+    iKinChain &chain = *arm.asChain();
+    ASSERT_EQ(chain.getDOF(), 10);
+
+    Vector q = randomPose(seed, chain);
+    Vector dq = randomVector(seed, chain.getDOF(), 0.01);
+    DLSSolver dls;
+    for (int k = 0; k < 200; k++)
+    {
+        chain.setAng(q + k * dq);
+        Matrix J = chain.GeoJacobian();
+        ASSERT_TRUE(dls.setJacobian(J));
+        dls.factorize();
+        double sv = referenceMinSingularValue(J);
+        ASSERT_NEAR(dls.getMinSingularValue(), sv, 1e-8 * std::max(sv, 1.0)) << "k " << k;
+    }
+}
+
+TEST(DLSSolver, lmctrl_matches_former_inverses_positive_001)
+{
+    unsigned int seed = 13;
+    const unsigned int released[] = {0, 3};
+    for (unsigned int torso : released)
+    {
+        iCubArm arm("left");
+        for (unsigned int i = 0; i < torso; i++)
+            arm.releaseLink(i);
+        iKinChain &chain = *arm.asChain();
+
+        Vector xd = chain.EndEffPose(randomPose(seed, chain));
+        Vector q0 = randomPose(seed, chain);
+        chain.setAng(q0);
+
+        LMCtrlProbe ctrl(chain);
+        ctrl.restart(q0);
+        for (int k = 0; (k < 500) && (ctrl.get_state() != IKINCTRL_STATE_INTARGET); k++)
+        {
+            double mu = ctrl.get_mu();
+            ctrl.iterate(xd);
+
+            Matrix J = ctrl.get_J();
+            Matrix LM = J * J.transposed();
+            for (int i = 0; i < 6; i++)
+                LM(i, i) += mu * LM(i, i);
+            ASSERT_LT(maxDeviation(ctrl.get_pinvLM(), J.transposed() * yarp::math::pinv(LM)), 1e-8) << "k " << k;
+            ASSERT_LT(maxDeviation(ctrl.get_pinvJ(), referencePinv(J)), 1e-8) << "k " << k;
+            ASSERT_NEAR(ctrl.get_svMin(), referenceMinSingularValue(J), 1e-8) << "k " << k;
+        }
+        EXPECT_EQ(ctrl.get_state(), IKINCTRL_STATE_INTARGET) << "dof " << chain.getDOF();
+    }
+}
+
+TEST(DLSSolver, controllers_converge_positive_001)
+{
+    unsigned int seed = 17;
+    iCubArm arm("right");
+    arm.releaseLink(0);
+    arm.releaseLink(1);
+    arm.releaseLink(2);
+    iKinChain &chain = *arm.asChain();
+
+    for (int trial = 0; trial < 5; trial++)
+    {
+        Vector xd = chain.EndEffPose(randomPose(seed, chain));
+        Vector q0 = randomPose(seed, chain);
+
+        chain.setAng(q0);
+        LMCtrl_GPM gpm(chain, IKINCTRL_POSE_FULL, 1.0, 1e-2, 2.0, 0.5, 1e-6, 1.0);
+        gpm.restart(q0);
+        for (int k = 0; (k < 500) && (gpm.get_state() != IKINCTRL_STATE_INTARGET); k++)
+            gpm.iterate(xd);
+        EXPECT_EQ(gpm.get_state(), IKINCTRL_STATE_INTARGET) << "trial " << trial;
+
+        chain.setAng(q0);
+        SteepCtrl steep(chain, IKINCTRL_STEEP_PINV, IKINCTRL_POSE_XYZ, 1.0, 0.5);
+        steep.restart(q0);
+        for (int k = 0; (k < 500) && (steep.get_state() != IKINCTRL_STATE_INTARGET); k++)
+            steep.iterate(xd);
+        EXPECT_EQ(steep.get_state(), IKINCTRL_STATE_INTARGET) << "trial " << trial;
+    }
+}
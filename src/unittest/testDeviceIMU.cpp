@@ -0,0 +1,193 @@
+/*
+ * Copyright (C) 2022 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+#include "gtest/gtest.h"
+
+#include "eo_imu_privData.h"
+
+#include <yarp/os/Network.h>
+#include <yarp/os/Time.h>
+
+#include <thread>
+
+#include "EOarray.h"
+#include "EoProtocolAS.h"
+
+using namespace yarp::dev;
+
+namespace
+{
+const double gyrFactor = 0.0625;
+
+// a gyroscope and an accelerometer on the same board
+void configure(SensorsData &sens)
+{
+	servConfigImu_t cfg{};
+	EOarray *array = eo_array_New(eOas_inertials3_descriptors_maxnumber, sizeof(eOas_inertial3_descriptor_t), &cfg.ethservice.configuration.data.as.inertial3.arrayofdescriptor);
+	for (eOas_sensor_t type : {eoas_imu_gyr, eoas_imu_acc})
+	{
+		eOas_inertial3_descriptor_t des = {};
+		des.typeofsensor = type;
+		eo_array_PushBack(array, &des);
+		cfg.id.push_back(eoas_sensor2string(type));
+		cfg.sensorName.push_back("");
+	}
+	sens.init(cfg, "testDeviceIMU");
+	sens.measConverter.Initialize(1.0, gyrFactor, 1.0, 1.0);
+}
+
+// a ROP of the stream of a sensor at 1 kHz: the values tell the number of the ROP
+eOas_inertial3_data_t makeRop(uint32_t n)
+{
+	eOas_inertial3_data_t data = {};
+	data.x = n % 1000;
+	data.y = -(int)(n % 1000);
+	data.z = 7;
+	return data;
+}
+
+void expectRop(const imuHistory_t::Sample &sample, uint32_t n)
+{
+	EXPECT_DOUBLE_EQ(gyrFactor * (n % 1000), sample.value.values[0]);
+	EXPECT_DOUBLE_EQ(-gyrFactor * (n % 1000), sample.value.values[1]);
+	EXPECT_DOUBLE_EQ(gyrFactor * 7, sample.value.values[2]);
+}
+}  // namespace
+
+TEST(embObjIMU, getSensorSamples_lossless_positive_001)
+{
+	// Setup
+	yarp::os::Network::init();
+	SensorsData sens;
+	configure(sens);
+
+	// Test: the gyroscope at 1 kHz read at 100 Hz, the samples stamped on reception with the yarp clock
+	const uint32_t rops = 5000;
+	uint64_t after = 0;
+	uint32_t received = 0;
+	std::vector<imuHistory_t::Sample> samples;
+	double start = yarp::os::Time::now();
+	for (uint32_t n = 0; n < rops; n++)
+	{
+		eOas_inertial3_data_t data = makeRop(n);
+		ASSERT_TRUE(sens.update(eoas_imu_gyr, 0, &data));
+
+		if ((n + 1) % 10 != 0)
+		{
+			continue;
+		}
+		uint64_t lost = 0;
+		samples.clear();
+		ASSERT_TRUE(sens.getSensorSamples(0, eoas_imu_gyr, after, samples, lost));
+		EXPECT_EQ(0u, lost);
+		ASSERT_EQ(10u, samples.size());
+		for (auto &sample : samples)
+		{
+			EXPECT_EQ(received + 1, sample.seq);
+			expectRop(sample, received);
+			EXPECT_GE(sample.timestamp, start);
+			EXPECT_LE(sample.timestamp, yarp::os::Time::now());
+			received++;
+		}
+		EXPECT_EQ(received, after);
+	}
+	EXPECT_EQ(rops, received);
+
+	// the latest value is the one of the last rop, the accelerometer got nothing
+	yarp::sig::Vector out;
+	double timestamp;
+	ASSERT_TRUE(sens.getSensorMeasure(0, eoas_imu_gyr, out, timestamp));
+	EXPECT_DOUBLE_EQ(gyrFactor * ((rops - 1) % 1000), out[0]);
+	EXPECT_DOUBLE_EQ(samples.back().timestamp, timestamp);
+
+	after = 0;
+	uint64_t lost = 0;
+	samples.clear();
+	ASSERT_TRUE(sens.getSensorSamples(0, eoas_imu_acc, after, samples, lost));
+	EXPECT_TRUE(samples.empty());
+	EXPECT_EQ(0u, after);
+}
+
+TEST(embObjIMU, getSensorSamples_overrun_positive_001)
+{
+	// Setup
+	yarp::os::Network::init();
+	SensorsData sens;
+	configure(sens);
+
+	const size_t capacity = 1024;
+	const size_t rops = 3 * capacity;
+	for (uint32_t n = 0; n < rops; n++)
+	{
+		eOas_inertial3_data_t data = makeRop(n);
+		ASSERT_TRUE(sens.update(eoas_imu_gyr, 0, &data));
+	}
+
+	// Test: a reader too slow gets the last capacity samples and knows how many it missed
+	std::vector<imuHistory_t::Sample> samples;
+	uint64_t after = 0;
+	uint64_t lost = 0;
+	ASSERT_TRUE(sens.getSensorSamples(0, eoas_imu_gyr, after, samples, lost));
+	EXPECT_EQ(rops - capacity, lost);
+	ASSERT_EQ(capacity, samples.size());
+	expectRop(samples.front(), rops - capacity);
+	expectRop(samples.back(), rops - 1);
+	EXPECT_EQ(rops, after);
+}
+
+TEST(embObjIMU, getSensorSamples_concurrent_positive_001)
+{
+	// Setup
+	yarp::os::Network::init();
+	SensorsData sens;
+	configure(sens);
+
+	// Test: the receiver thread writes as fast as it can, a reader never gets a torn sample
+	const uint32_t rops = 100000;
+	std::thread receiver([&]() {
+		for (uint32_t n = 0; n < rops; n++)
+		{
+			eOas_inertial3_data_t data = makeRop(n);
+			sens.update(eoas_imu_gyr, 0, &data);
+		}
+	});
+
+	std::vector<imuHistory_t::Sample> samples;
+	uint64_t after = 0;
+	uint64_t received = 0;
+	uint64_t missed = 0;
+	while (after < rops)
+	{
+		uint64_t lost = 0;
+		samples.clear();
+		ASSERT_TRUE(sens.getSensorSamples(0, eoas_imu_gyr, after, samples, lost));
+		missed += lost;
+		for (auto &sample : samples)
+		{
+			expectRop(sample, sample.seq - 1);
+		}
+		received += samples.size();
+	}
+	receiver.join();
+
+	EXPECT_EQ(rops, received + missed);
+}
+
+TEST(embObjIMU, getSensorSamples_not_configured_negative_001)
+{
+	// Setup
+	yarp::os::Network::init();
+	SensorsData sens;
+	configure(sens);
+
+	// Test: there is only one gyroscope and no magnetometer
+	std::vector<imuHistory_t::Sample> samples;
+	uint64_t after = 0;
+	uint64_t lost = 0;
+	EXPECT_FALSE(sens.getSensorSamples(1, eoas_imu_gyr, after, samples, lost));
+	EXPECT_FALSE(sens.getSensorSamples(0, eoas_imu_mag, after, samples, lost));
+	EXPECT_TRUE(samples.empty());
+}
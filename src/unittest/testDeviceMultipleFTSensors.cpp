@@ -11,6 +11,8 @@
 #include "embObjMultipleFTsensors.h"
 #include <ethResource.h>
 
+#include <thread>
+
 #include "EoProtocolAS.h"
 #include "testUtils.h"
 
@@ -33,6 +35,7 @@ using namespace yarp::dev;
 class embObjMultipleFTsensor_Mock : public yarp::dev::embObjMultipleFTsensors
 {
    public:
+	using yarp::dev::embObjMultipleFTsensors::ftHistory_;
 	using yarp::dev::embObjMultipleFTsensors::ftSensorsData_;
 	using yarp::dev::embObjMultipleFTsensors::initRegulars;
 	using yarp::dev::embObjMultipleFTsensors::sendConfig2boards;
@@ -181,6 +184,9 @@ TEST(MultiplembObjMultipleFTsensor, update_simple_positive_001)
 	eOas_ft_timedvalue_t data = {100, 1, 2, 3, {5, 6, 7, 8, 9, 10}};
 	yarp::sig::Vector expected = {5, 6, 7, 8, 9, 10};
 
+	device.ftSensorsData_.resize(1);
+	device.temperaturesensordata_.resize(1);
+
 	EXPECT_CALL(*privateData, isOpen()).WillRepeatedly(Return(true));
 
 	// Test
@@ -201,6 +207,9 @@ TEST(MultiplembObjMultipleFTsensor, update_simple_positive_002)
 	yarp::sig::Vector expected = {5, 6, 7, 8, 9, 10};
 	yarp::sig::Vector expectedEmpty = {0, 0, 0, 0, 0, 0};
 
+	device.ftSensorsData_.resize(2);
+	device.temperaturesensordata_.resize(2);
+
 	EXPECT_CALL(*privateData, isOpen()).WillRepeatedly(Return(true));
 
 	// Test
@@ -269,7 +278,7 @@ TEST(MultiplembObjMultipleFTsensor, getNrOfSixAxisForceTorqueSensors_positive_00
 	std::shared_ptr<embObjDevPrivData_Mock> privateData = std::make_shared<embObjDevPrivData_Mock>("test");
 	embObjMultipleFTsensor_Mock device(privateData);
 
-	device.ftSensorsData_ = {{{0}, {{1, 2, 3, 4, 5, 6}, 99.49}}};
+	device.ftSensorsData_ = {{{1, 2, 3, 4, 5, 6}, 99.49}};
 
 	EXPECT_CALL(*privateData, isOpen()).WillRepeatedly(Return(true));
 
@@ -289,7 +298,7 @@ TEST(MultiplembObjMultipleFTsensor, getNrOfSixAxisForceTorqueSensors_double_posi
 	std::shared_ptr<embObjDevPrivData_Mock> privateData = std::make_shared<embObjDevPrivData_Mock>("test");
 	embObjMultipleFTsensor_Mock device(privateData);
 
-	device.ftSensorsData_ = {{{0}, {{1, 2, 3, 4, 5, 6}, 99.49}}, {{1}, {{10, 20, 30, 40, 50, 60}, 99.49}}};
+	device.ftSensorsData_ = {{{1, 2, 3, 4, 5, 6}, 99.49}, {{10, 20, 30, 40, 50, 60}, 99.49}};
 
 	EXPECT_CALL(*privateData, isOpen()).WillRepeatedly(Return(true));
 
@@ -309,7 +318,7 @@ TEST(MultiplembObjMultipleFTsensor, getNrOfSgetTemperatureSensorMeasure_positive
 	std::shared_ptr<embObjDevPrivData_Mock> privateData = std::make_shared<embObjDevPrivData_Mock>("test");
 	embObjMultipleFTsensor_Mock device(privateData);
 
-	device.temperaturesensordata_ = {{{0}, {34, 99.49}}};
+	device.temperaturesensordata_ = {{34, 99.49}};
 
 	EXPECT_CALL(*privateData, isOpen()).WillRepeatedly(Return(true));
 
@@ -341,3 +350,195 @@ TEST(MultiplembObjMultipleFTsensor, calculateBoardTime_positive_001)
 
 	EXPECT_DOUBLE_EQ(1.0,diff);
 }
+
+TEST(MultiplembObjMultipleFTsensor, update_not_configured_negative_001)
+{
+	// Setup
+	std::shared_ptr<embObjDevPrivData_Mock> privateData = std::make_shared<embObjDevPrivData_Mock>("test");
+	embObjMultipleFTsensor_Mock device(privateData);
+	uint32_t id32First = eoprot_ID_get(eoprot_endpoint_analogsensors, eoprot_entity_as_ft, 1, eoprot_tag_as_ft_status_timedvalue);
+	eOas_ft_timedvalue_t data = {100, 1, 2, 3, {5, 6, 7, 8, 9, 10}};
+
+	device.ftSensorsData_.resize(1);
+	device.temperaturesensordata_.resize(1);
+
+	EXPECT_CALL(*privateData, isOpen()).WillRepeatedly(Return(true));
+
+	// Test
+	bool ret = device.update(id32First, 1, (void *)&data);
+	EXPECT_FALSE(ret);
+}
+
+namespace
+{
+// a ROP of the stream of a sensor at 1 kHz: every value tells the number of the ROP
+eOas_ft_timedvalue_t makeRop(uint32_t n)
+{
+	eOas_ft_timedvalue_t data = {};
+	data.age = 1000 * (n + 1);
+	data.temperature = n % 1000;
+	for (int k = 0; k < ftChannels_; k++)
+	{
+		data.values[k] = n + 0.5 * k;
+	}
+	return data;
+}
+
+void expectRop(const FtHistory::Sample &sample, uint32_t n)
+{
+	for (int k = 0; k < ftChannels_; k++)
+	{
+		EXPECT_FLOAT_EQ(n + 0.5 * k, sample.value.data_[k]);
+	}
+	EXPECT_DOUBLE_EQ(0.1 * (n % 1000), sample.value.temperature_);
+}
+
+void configure(embObjMultipleFTsensor_Mock &device, EthResource_Mock &deviceRes)
+{
+	ServiceParserMultipleFt_mock parser;
+	parser.ftInfo_ = {{"fakeId", {1, 100, eoas_ft_mode_calibrated, eobrd_unknown, 0, 0, 0, 0, 0, 0, 0}}, {"fakeId2", {1, 100, eoas_ft_mode_calibrated, eobrd_unknown, 0, 0, 0, 0, 0, 0, 0}}};
+	EXPECT_CALL(deviceRes, setcheckRemoteValue(_, _, 10, 0.010, 0.050)).WillRepeatedly(Return(true));
+	ASSERT_TRUE(device.sendConfig2boards(parser, &deviceRes));
+}
+}  // namespace
+
+TEST(MultiplembObjMultipleFTsensor, getSixAxisForceTorqueSensorSamples_lossless_positive_001)
+{
+	// Setup
+	yarp::os::Network::init();
+	std::shared_ptr<embObjDevPrivData_Mock> privateData = std::make_shared<embObjDevPrivData_Mock>("test");
+	embObjMultipleFTsensor_Mock device(privateData);
+	EthResource_Mock deviceRes;
+	configure(device, deviceRes);
+	uint32_t id32[2] = {eoprot_ID_get(eoprot_endpoint_analogsensors, eoprot_entity_as_ft, 0, eoprot_tag_as_ft_status_timedvalue),
+						eoprot_ID_get(eoprot_endpoint_analogsensors, eoprot_entity_as_ft, 1, eoprot_tag_as_ft_status_timedvalue)};
+
+	EXPECT_CALL(*privateData, isOpen()).WillRepeatedly(Return(true));
+
+	// Test: two sensors at 1 kHz, the reader of the first at 100 Hz, the one of the second at about 1 Hz
+	const uint32_t rops = 10000;
+	uint64_t after[2] = {0, 0};
+	uint32_t received[2] = {0, 0};
+	std::vector<FtHistory::Sample> samples;
+	for (uint32_t n = 0; n < rops; n++)
+	{
+		for (int s = 0; s < 2; s++)
+		{
+			eOas_ft_timedvalue_t data = makeRop(n);
+			ASSERT_TRUE(device.update(id32[s], 0, (void *)&data));
+		}
+
+		for (int s = 0; s < 2; s++)
+		{
+			uint32_t period = (0 == s) ? 10 : 1000;
+			if ((n + 1) % period != 0)
+			{
+				continue;
+			}
+			uint64_t lost = 0;
+			samples.clear();
+			ASSERT_TRUE(device.getSixAxisForceTorqueSensorSamples(s, after[s], samples, lost));
+			EXPECT_EQ(0u, lost);
+			ASSERT_EQ(period, samples.size());
+			for (auto &sample : samples)
+			{
+				EXPECT_EQ(received[s] + 1, sample.seq);
+				expectRop(sample, received[s]);
+				received[s]++;
+			}
+			EXPECT_EQ(received[s], after[s]);
+		}
+	}
+	EXPECT_EQ(rops, received[0]);
+	EXPECT_EQ(rops, received[1]);
+
+	// the latest value is still the one of the last rop
+	yarp::sig::Vector out;
+	double timestamp;
+	ASSERT_TRUE(device.getSixAxisForceTorqueSensorMeasure(1, out, timestamp));
+	EXPECT_FLOAT_EQ(rops - 1, out[0]);
+}
+
+TEST(MultiplembObjMultipleFTsensor, getSixAxisForceTorqueSensorSamples_overrun_positive_001)
+{
+	// Setup
+	yarp::os::Network::init();
+	std::shared_ptr<embObjDevPrivData_Mock> privateData = std::make_shared<embObjDevPrivData_Mock>("test");
+	embObjMultipleFTsensor_Mock device(privateData);
+	EthResource_Mock deviceRes;
+	configure(device, deviceRes);
+	uint32_t id32 = eoprot_ID_get(eoprot_endpoint_analogsensors, eoprot_entity_as_ft, 0, eoprot_tag_as_ft_status_timedvalue);
+
+	EXPECT_CALL(*privateData, isOpen()).WillRepeatedly(Return(true));
+
+	const size_t capacity = device.ftHistory_[0].capacity();
+	const size_t rops = 3 * capacity;
+	for (uint32_t n = 0; n < rops; n++)
+	{
+		eOas_ft_timedvalue_t data = makeRop(n);
+		ASSERT_TRUE(device.update(id32, 0, (void *)&data));
+	}
+
+	// Test: a reader too slow gets the last capacity samples and knows how many it missed
+	std::vector<FtHistory::Sample> samples;
+	uint64_t after = 0;
+	uint64_t lost = 0;
+	ASSERT_TRUE(device.getSixAxisForceTorqueSensorSamples(0, after, samples, lost));
+	EXPECT_EQ(rops - capacity, lost);
+	ASSERT_EQ(capacity, samples.size());
+	expectRop(samples.front(), rops - capacity);
+	expectRop(samples.back(), rops - 1);
+	EXPECT_EQ(rops, after);
+
+	// Test: by timestamp
+	double since = samples[samples.size() - 11].timestamp;
+	samples.clear();
+	ASSERT_TRUE(device.getSixAxisForceTorqueSensorSamples(0, since, samples));
+	ASSERT_EQ(10u, samples.size());
+	expectRop(samples.front(), rops - 10);
+
+	EXPECT_FALSE(device.getSixAxisForceTorqueSensorSamples(2, since, samples));
+}
+
+TEST(MultiplembObjMultipleFTsensor, getSixAxisForceTorqueSensorSamples_concurrent_positive_001)
+{
+	// Setup
+	yarp::os::Network::init();
+	std::shared_ptr<embObjDevPrivData_Mock> privateData = std::make_shared<embObjDevPrivData_Mock>("test");
+	embObjMultipleFTsensor_Mock device(privateData);
+	EthResource_Mock deviceRes;
+	configure(device, deviceRes);
+	uint32_t id32 = eoprot_ID_get(eoprot_endpoint_analogsensors, eoprot_entity_as_ft, 0, eoprot_tag_as_ft_status_timedvalue);
+
+	EXPECT_CALL(*privateData, isOpen()).WillRepeatedly(Return(true));
+
+	// Test: the receiver thread writes as fast as it can, a reader never gets a torn sample
+	const uint32_t rops = 200000;
+	std::thread receiver([&]() {
+		for (uint32_t n = 0; n < rops; n++)
+		{
+			eOas_ft_timedvalue_t data = makeRop(n);
+			device.update(id32, 0, (void *)&data);
+		}
+	});
+
+	std::vector<FtHistory::Sample> samples;
+	uint64_t after = 0;
+	uint64_t received = 0;
+	uint64_t missed = 0;
+	while (after < rops)
+	{
+		uint64_t lost = 0;
+		samples.clear();
+		ASSERT_TRUE(device.getSixAxisForceTorqueSensorSamples(0, after, samples, lost));
+		missed += lost;
+		for (auto &sample : samples)
+		{
+			expectRop(sample, sample.seq - 1);
+		}
+		received += samples.size();
+	}
+	receiver.join();
+
+	EXPECT_EQ(rops, received + missed);
+}
@@ -0,0 +1,192 @@
+/*
+ * Copyright (C) 2022 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "EoError.h"
+#include "diagnosticAsyncLogger.h"
+#include "gtest/gtest.h"
+
+using namespace Diagnostic::LowLevel;
+
+namespace
+{
+eOmn_info_basic_t makeInfo(eOerror_code_t code, uint64_t timestamp)
+{
+    eOmn_info_basic_t info{};
+    info.timestamp = timestamp;
+    info.properties.code = code;
+    info.properties.par64 = timestamp;
+    return info;
+}
+
+Record makeRecord(eOipv4addr_t ipv4, eOerror_code_t code, uint64_t timestamp)
+{
+    eOmn_info_basic_t info = makeInfo(code, timestamp);
+    Record r;
+    r.fill(0.0, ipv4, &info, nullptr);
+    return r;
+}
+
+const eOerror_code_t faultCode = eoerror_code_get(eoerror_category_MotionControl, eoerror_value_MC_motor_external_fault);
+const eOerror_code_t otherCode = eoerror_code_get(eoerror_category_System, eoerror_value_SYS_canservices_boards_lostcontact);
+const eOipv4addr_t board1 = eo_common_ipv4addr(10, 0, 1, 1);
+const eOipv4addr_t board2 = eo_common_ipv4addr(10, 0, 1, 2);
+} // namespace
+
+TEST(DiagnosticAsyncLogger, queue_fifo_and_full_positive_001)
+{
+    RecordQueue queue(5);
+    ASSERT_EQ(queue.capacity(), 8u);
+
+    for (uint64_t i = 0; i < 8; i++)
+        EXPECT_TRUE(queue.push(makeRecord(board1, faultCode, i)));
+    EXPECT_FALSE(queue.push(makeRecord(board1, faultCode, 8)));
+    EXPECT_EQ(queue.dropped(), 1u);
+
+    Record r;
+    for (uint64_t i = 0; i < 8; i++)
+    {
+        ASSERT_TRUE(queue.pop(r));
+        EXPECT_EQ(r.basic.timestamp, i);
+    }
+    EXPECT_FALSE(queue.pop(r));
+
+    // the cells are reused once freed
+    EXPECT_TRUE(queue.push(makeRecord(board2, otherCode, 9)));
+    ASSERT_TRUE(queue.pop(r));
+    EXPECT_EQ(r.ipv4, board2);
+    EXPECT_EQ(r.basic.properties.code, otherCode);
+}
+
+TEST(DiagnosticAsyncLogger, queue_many_producers_positive_001)
+{
+    const int producers = 4;
+    const uint64_t messages = 100000;
+    RecordQueue queue(256);
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; p++)
+        threads.emplace_back([&queue, p, messages]() {
+            for (uint64_t i = 0; i < messages; i++)
+                queue.push(makeRecord(p, faultCode, i));
+        });
+
+    // every producer must be seen in order, possibly with holes where the queue was full
+    std::vector<int64_t> last(producers, -1);
+    size_t popped = 0;
+    Record r;
+    auto drain = [&]() {
+        while (queue.pop(r))
+        {
+            ASSERT_LT(r.ipv4, (eOipv4addr_t)producers);
+            EXPECT_GT((int64_t)r.basic.timestamp, last[r.ipv4]);
+            EXPECT_EQ(r.basic.properties.par64, r.basic.timestamp);
+            last[r.ipv4] = r.basic.timestamp;
+            popped++;
+        }
+    };
+
+    std::thread consumer([&]() {
+        while (popped + queue.dropped() < producers * messages)
+            drain();
+    });
+
+    for (auto &t : threads)
+        t.join();
+    consumer.join();
+    drain();
+
+    EXPECT_EQ(popped + queue.dropped(), producers * messages);
+}
+
+TEST(DiagnosticAsyncLogger, aggregator_rate_limit_positive_001)
+{
+    Aggregator aggregator;
+    aggregator.config.window = 1.0;
+    aggregator.config.threshold = 3;
+
+    size_t admitted = 0;
+    for (uint64_t i = 0; i < 10; i++)
+        admitted += aggregator.admit(makeRecord(board1, faultCode, i), 0.05 * i) ? 1 : 0;
+    EXPECT_EQ(admitted, 3u);
+
+    // other boards and other codes have their own window
+    EXPECT_TRUE(aggregator.admit(makeRecord(board2, faultCode, 0), 0.5));
+    EXPECT_TRUE(aggregator.admit(makeRecord(board1, otherCode, 0), 0.5));
+
+    std::vector<Aggregator::Summary> summaries;
+    aggregator.expire(0.9, summaries);
+    EXPECT_TRUE(summaries.empty());
+
+    aggregator.expire(1.0, summaries);
+    ASSERT_EQ(summaries.size(), 1u);
+    EXPECT_EQ(summaries[0].suppressed, 7u);
+    EXPECT_EQ(summaries[0].last.basic.timestamp, 9u);
+    EXPECT_DOUBLE_EQ(summaries[0].duration, 1.0);
+
+    // a new window starts logging again
+    EXPECT_TRUE(aggregator.admit(makeRecord(board1, faultCode, 10), 1.1));
+
+    summaries.clear();
+    aggregator.flush(1.2, summaries);
+    EXPECT_TRUE(summaries.empty());
+
+    aggregator.config.threshold = 0;
+    for (uint64_t i = 0; i < 10; i++)
+        EXPECT_TRUE(aggregator.admit(makeRecord(board1, faultCode, i), 2.0));
+}
+
+TEST(DiagnosticAsyncLogger, journal_round_trip_positive_001)
+{
+    const std::string filename = "testDiagnosticJournal.bin";
+    const char verbal[] = "a verbal message";
+
+    std::vector<Record> written;
+    {
+        Journal journal;
+        ASSERT_TRUE(journal.create(filename));
+        for (uint64_t i = 0; i < 5; i++)
+        {
+            eOmn_info_basic_t info = makeInfo(faultCode, i);
+            Record r;
+            uint8_t extra[sizeof(r.extra)] = {0};
+            memcpy(extra, verbal, sizeof(verbal));
+            r.fill(1.5 * i, board1, &info, (i % 2) ? extra : nullptr);
+            ASSERT_TRUE(journal.write(r));
+            written.push_back(r);
+        }
+    }
+
+    Journal journal;
+    ASSERT_TRUE(journal.open(filename));
+    Record r;
+    for (auto &w : written)
+    {
+        ASSERT_TRUE(journal.read(r));
+        EXPECT_EQ(memcmp(&r, &w, sizeof(Record)), 0);
+    }
+    EXPECT_FALSE(journal.read(r));
+    journal.close();
+    remove(filename.c_str());
+}
+
+TEST(DiagnosticAsyncLogger, journal_foreign_file_negative_001)
+{
+    // anything but a journal is refused
+    const std::string filename = "testDiagnosticJournal.bin";
+    Journal journal;
+    FILE *f = fopen(filename.c_str(), "wb");
+    ASSERT_NE(f, nullptr);
+    fputs("not a journal", f);
+    fclose(f);
+    EXPECT_FALSE(journal.open(filename));
+    remove(filename.c_str());
+}
@@ -0,0 +1,794 @@
+/*
+ * Copyright (C) 2022 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include <yarp/os/Property.h>
+#include <yarp/os/SystemClock.h>
+
+#include <ace/INET_Addr.h>
+#include <ace/SOCK_Dgram.h>
+#include <ace/Time_Value.h>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <future>
+#include <map>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include <asyncEthResource.h>
+#include <ethManager.h>
+#include <ethResource.h>
+#include <theNVmanager.h>
+
+#include "EOrop.h"
+#include "EoManagement.h"
+#include "EoProtocolMC.h"
+#include "EoProtocolMN.h"
+
+using ::testing::_;
+using ::testing::Return;
+
+using yarp::os::SystemClock;
+
+namespace
+{
+// the ropframe as hostTransceiver.cpp sees it: header, rops, footer
+struct FrameHeader
+{
+    uint32_t startofframe;
+    uint16_t ropssizeof;
+    uint16_t ropsnumberof;
+    uint64_t ageofframe;
+    uint64_t sequencenumber;
+};
+constexpr uint32_t frameStart = 0x12345678;
+constexpr uint32_t frameEnd = 0x87654321;
+static_assert(sizeof(FrameHeader) + sizeof(frameEnd) == eo_ropframe_sizeforZEROrops, "unexpected size of the ropframe");
+
+// a rop is its head, the data padded to 4 bytes, then the signature and the time if the control says so
+struct RopHead
+{
+    eOropctrl_t ctrl;
+    uint8_t ropc;
+    uint16_t dsiz;
+    eOprotID32_t id32;
+};
+static_assert(sizeof(RopHead) == 8, "unexpected size of the head of a rop");
+
+constexpr uint16_t boardPort = 12345;
+constexpr size_t maxFrameSize = 768;
+
+// The board side of the protocol, enough for the configuration of a board: it keeps the value of the
+// set<> variables, replies to every ask<> with a say<> carrying the same signature and acknowledges the
+// service commands with a sig<> of their result. It can lose the first set<> of some variables, hold
+// its replies until the test releases them or ignore the host.
+class SimulatedBoard
+{
+   public:
+    SimulatedBoard(uint8_t ip4) : ip4(ip4), running(false), mute(false), held(false)
+    {
+    }
+
+    ~SimulatedBoard()
+    {
+        stop();
+    }
+
+    eOipv4addr_t ipv4() const
+    {
+        return eo_common_ipv4addr(127, 0, 0, ip4);
+    }
+
+    bool start()
+    {
+        ACE_INET_Addr local(boardPort, (ACE_UINT32)((127 << 24) | ip4));
+        if (-1 == socket.open(local))
+        {
+            return false;
+        }
+        running = true;
+        worker = std::thread([this]() { run(); });
+        return true;
+    }
+
+    void stop()
+    {
+        if (running)
+        {
+            {
+                std::lock_guard<std::mutex> lck(mtx);
+                running = false;
+            }
+            released.notify_all();
+            worker.join();
+            socket.close();
+        }
+    }
+
+    void setMute(bool on)
+    {
+        mute = on;
+    }
+
+    // the replies wait to be sent until releaseReplies() is called
+    void holdReplies()
+    {
+        std::lock_guard<std::mutex> lck(mtx);
+        held = true;
+    }
+
+    void releaseReplies()
+    {
+        {
+            std::lock_guard<std::mutex> lck(mtx);
+            held = false;
+        }
+        released.notify_all();
+    }
+
+    // the first set<> of id32 which arrives after this call is lost
+    void loseNextSet(eOprotID32_t id32)
+    {
+        std::lock_guard<std::mutex> lck(mtx);
+        lost.insert(id32);
+    }
+
+    void store(eOprotID32_t id32, const std::vector<uint8_t> &value)
+    {
+        std::lock_guard<std::mutex> lck(mtx);
+        values[id32] = value;
+    }
+
+    std::vector<uint8_t> value(eOprotID32_t id32)
+    {
+        std::lock_guard<std::mutex> lck(mtx);
+        return values[id32];
+    }
+
+    size_t numberOfSets(eOprotID32_t id32)
+    {
+        std::lock_guard<std::mutex> lck(mtx);
+        return sets[id32];
+    }
+
+    size_t numberOfAsks()
+    {
+        std::lock_guard<std::mutex> lck(mtx);
+        return asks;
+    }
+
+   private:
+    struct Reply
+    {
+        RopHead head;
+        std::vector<uint8_t> data;
+        uint32_t signature;
+    };
+
+    void run()
+    {
+        std::vector<uint8_t> buffer(1500);
+        ACE_Time_Value timeout(0, 10000);
+        while (running)
+        {
+            ACE_INET_Addr from;
+            ssize_t size = socket.recv(buffer.data(), buffer.size(), from, 0, &timeout);
+            if ((size < (ssize_t)eo_ropframe_sizeforZEROrops) || mute)
+            {
+                continue;
+            }
+            std::vector<Reply> replies = process(buffer.data(), size);
+            if (replies.empty())
+            {
+                continue;
+            }
+            {
+                std::unique_lock<std::mutex> lck(mtx);
+                released.wait(lck, [this]() { return !held || !running; });
+            }
+            send(replies, from);
+        }
+    }
+
+    std::vector<Reply> process(const uint8_t *frame, size_t size)
+    {
+        std::vector<Reply> replies;
+
+        FrameHeader header;
+        std::memcpy(&header, frame, sizeof(header));
+        if ((frameStart != header.startofframe) || (size < sizeof(header) + header.ropssizeof + sizeof(frameEnd)))
+        {
+            return replies;
+        }
+
+        std::lock_guard<std::mutex> lck(mtx);
+
+        size_t offset = sizeof(header);
+        for (uint16_t r = 0; r < header.ropsnumberof; r++)
+        {
+            RopHead head;
+            std::memcpy(&head, frame + offset, sizeof(head));
+            offset += sizeof(head);
+            const uint8_t *data = frame + offset;
+            offset += (head.dsiz + 3) & ~3;
+            uint32_t signature = 0;
+            if (1 == head.ctrl.plussign)
+            {
+                std::memcpy(&signature, frame + offset, sizeof(signature));
+                offset += sizeof(signature);
+            }
+            if (1 == head.ctrl.plustime)
+            {
+                offset += sizeof(uint64_t);
+            }
+
+            if (eo_ropcode_set == head.ropc)
+            {
+                sets[head.id32]++;
+                if (lost.erase(head.id32) > 0)
+                {
+                    continue;
+                }
+                values[head.id32].assign(data, data + head.dsiz);
+                if (eoprot_ID_get(eoprot_endpoint_management, eoprot_entity_mn_service, 0, eoprot_tag_mn_service_cmmnds_command) == head.id32)
+                {
+                    replies.push_back(commandResult(head.ctrl));
+                }
+            }
+            else if (eo_ropcode_ask == head.ropc)
+            {
+                asks++;
+                Reply reply;
+                reply.head = head;
+                reply.head.ctrl.plustime = 0;
+                reply.head.ropc = eo_ropcode_say;
+                reply.data = values[head.id32];
+                reply.data.resize(eoprot_variable_sizeof_get(ip4, head.id32), 0);
+                reply.head.dsiz = reply.data.size();
+                reply.signature = signature;
+                replies.push_back(reply);
+            }
+        }
+
+        return replies;
+    }
+
+    Reply commandResult(const eOropctrl_t &ctrl)
+    {
+        eOmn_service_command_result_t result;
+        std::memset(&result, 0, sizeof(result));
+        result.latestcommandisok = eobool_true;
+
+        Reply reply;
+        reply.head.ctrl = ctrl;
+        reply.head.ctrl.plustime = 0;
+        reply.head.ctrl.plussign = 0;
+        reply.head.ropc = eo_ropcode_sig;
+        reply.head.id32 = eoprot_ID_get(eoprot_endpoint_management, eoprot_entity_mn_service, 0, eoprot_tag_mn_service_status_commandresult);
+        reply.data.assign(reinterpret_cast<uint8_t *>(&result), reinterpret_cast<uint8_t *>(&result) + sizeof(result));
+        reply.head.dsiz = reply.data.size();
+        reply.signature = 0;
+        return reply;
+    }
+
+    // the replies leave in as few frames as they fit
+    void send(const std::vector<Reply> &replies, const ACE_INET_Addr &to)
+    {
+        std::vector<uint8_t> rops;
+        uint16_t numberofrops = 0;
+        for (const Reply &reply : replies)
+        {
+            std::vector<uint8_t> rop(sizeof(RopHead) + ((reply.data.size() + 3) & ~3), 0);
+            std::memcpy(rop.data(), &reply.head, sizeof(RopHead));
+            std::memcpy(rop.data() + sizeof(RopHead), reply.data.data(), reply.data.size());
+            if (1 == reply.head.ctrl.plussign)
+            {
+                const uint8_t *s = reinterpret_cast<const uint8_t *>(&reply.signature);
+                rop.insert(rop.end(), s, s + sizeof(reply.signature));
+            }
+            if (eo_ropframe_sizeforZEROrops + rops.size() + rop.size() > maxFrameSize)
+            {
+                sendFrame(rops, numberofrops, to);
+                rops.clear();
+                numberofrops = 0;
+            }
+            rops.insert(rops.end(), rop.begin(), rop.end());
+            numberofrops++;
+        }
+        sendFrame(rops, numberofrops, to);
+    }
+
+    void sendFrame(const std::vector<uint8_t> &rops, uint16_t numberofrops, const ACE_INET_Addr &to)
+    {
+        FrameHeader header;
+        header.startofframe = frameStart;
+        header.ropssizeof = rops.size();
+        header.ropsnumberof = numberofrops;
+        header.ageofframe = static_cast<uint64_t>(SystemClock::nowSystem() * 1e6);
+        header.sequencenumber = ++sequencenumber;
+
+        std::vector<uint8_t> frame(sizeof(header));
+        std::memcpy(frame.data(), &header, sizeof(header));
+        frame.insert(frame.end(), rops.begin(), rops.end());
+        const uint8_t *end = reinterpret_cast<const uint8_t *>(&frameEnd);
+        frame.insert(frame.end(), end, end + sizeof(frameEnd));
+
+        socket.send(frame.data(), frame.size(), to);
+    }
+
+    uint8_t ip4;
+    ACE_SOCK_Dgram socket;
+    std::thread worker;
+    std::atomic<bool> running;
+    std::atomic<bool> mute;
+    uint64_t sequencenumber{0};
+
+    std::mutex mtx;
+    std::map<eOprotID32_t, std::vector<uint8_t>> values;
+    std::map<eOprotID32_t, size_t> sets;
+    std::set<eOprotID32_t> lost;
+    size_t asks{0};
+    bool held;
+    std::condition_variable released;
+};
+
+// the device which requests the resource of a simulated board
+class LoopbackDevice : public eth::IethResource
+{
+   public:
+    bool initialised() override
+    {
+        return false;
+    }
+    bool update(eOprotID32_t id32, double timestamp, void *rxdata) override
+    {
+        return true;
+    }
+    eth::iethresType_t type() override
+    {
+        return eth::iethres_motioncontrol;
+    }
+};
+
+yarp::os::Property boardConfig(uint8_t ip4)
+{
+    std::string cfg = "(PC104 (PC104IpAddress \"127.0.0.1\") (PC104IpPort 12345) (PC104TXrate 1) (PC104RXrate 5)) ";
+    cfg += "(ETH_BOARD (ETH_BOARD_PROPERTIES (IpAddress \"127.0.0." + std::to_string(ip4) + "\") (IpPort 12345) (Type EMS4) (maxSizeRXpacket 768) (maxSizeROP 384)) ";
+    cfg += "(ETH_BOARD_SETTINGS (Name \"sim" + std::to_string(ip4) + "\")))";
+    yarp::os::Property config;
+    config.fromString(cfg);
+    return config;
+}
+
+// the configuration of some joints and motors, as embObjMotionControl::init() sends it
+void makeConfig(uint8_t ip4, uint8_t seed, std::vector<eOprotID32_t> &id32s, std::vector<std::vector<uint8_t>> &buffers)
+{
+    id32s.clear();
+    buffers.clear();
+    for (uint8_t j = 0; j < 4; j++)
+    {
+        id32s.push_back(eoprot_ID_get(eoprot_endpoint_motioncontrol, eoprot_entity_mc_joint, j, eoprot_tag_mc_joint_config));
+        id32s.push_back(eoprot_ID_get(eoprot_endpoint_motioncontrol, eoprot_entity_mc_motor, j, eoprot_tag_mc_motor_config));
+    }
+    for (size_t i = 0; i < id32s.size(); i++)
+    {
+        std::vector<uint8_t> b(eoprot_variable_sizeof_get(ip4, id32s[i]));
+        for (size_t k = 0; k < b.size(); k++)
+        {
+            b[k] = static_cast<uint8_t>(seed + 7 * i + 3 * k);
+        }
+        buffers.push_back(b);
+    }
+}
+
+std::vector<const void *> pointers(const std::vector<std::vector<uint8_t>> &buffers)
+{
+    std::vector<const void *> p;
+    for (const std::vector<uint8_t> &b : buffers)
+    {
+        p.push_back(b.data());
+    }
+    return p;
+}
+} // namespace
+
+// Two simulated boards on the loopback interface, reached through TheEthManager as the real ones
+class EthLoopback : public ::testing::Test
+{
+   protected:
+    static void SetUpTestSuite()
+    {
+        for (size_t b = 0; b < 2; b++)
+        {
+            boards[b] = new SimulatedBoard(2 + b);
+            if (false == boards[b]->start())
+            {
+                return;
+            }
+        }
+        for (size_t b = 0; b < 2; b++)
+        {
+            yarp::os::Property config = boardConfig(2 + b);
+            resources[b] = eth::TheEthManager::instance()->requestResource2(&devices[b], config);
+        }
+    }
+
+    static void TearDownTestSuite()
+    {
+        for (size_t b = 0; b < 2; b++)
+        {
+            if ((nullptr != resources[b]) && (-1 == eth::TheEthManager::instance()->releaseResource2(resources[b], &devices[b])))
+            {
+                eth::TheEthManager::instance()->killYourself();
+            }
+            resources[b] = nullptr;
+        }
+        for (size_t b = 0; b < 2; b++)
+        {
+            delete boards[b];
+            boards[b] = nullptr;
+        }
+    }
+
+    void SetUp() override
+    {
+        if ((nullptr == resources[0]) || (nullptr == resources[1]))
+        {
+            GTEST_SKIP() << "the simulated boards need 127.0.0.2 and 127.0.0.3 on the loopback interface";
+        }
+        for (size_t b = 0; b < 2; b++)
+        {
+            boards[b]->setMute(false);
+            boards[b]->releaseReplies();
+        }
+    }
+
+    static SimulatedBoard *boards[2];
+    static eth::AbstractEthResource *resources[2];
+    static LoopbackDevice devices[2];
+};
+
+SimulatedBoard *EthLoopback::boards[2] = {nullptr, nullptr};
+eth::AbstractEthResource *EthLoopback::resources[2] = {nullptr, nullptr};
+LoopbackDevice EthLoopback::devices[2];
+
+TEST_F(EthLoopback, setcheckRemoteValues_positive_001)
+{
+    // Setup
+    std::vector<eOprotID32_t> id32s;
+    std::vector<std::vector<uint8_t>> buffers;
+    makeConfig(2, 11, id32s, buffers);
+
+    // Test
+    bool ret = resources[0]->setcheckRemoteValues(id32s, pointers(buffers));
+
+    // Verify
+    EXPECT_TRUE(ret);
+    for (size_t i = 0; i < id32s.size(); i++)
+    {
+        EXPECT_EQ(boards[0]->value(id32s[i]), buffers[i]);
+    }
+}
+
+TEST_F(EthLoopback, setcheckRemoteValues_lost_sets_positive_001)
+{
+    // Setup: the board loses the first set<> of half the variables
+    std::vector<eOprotID32_t> id32s;
+    std::vector<std::vector<uint8_t>> buffers;
+    makeConfig(2, 23, id32s, buffers);
+    std::vector<size_t> sets(id32s.size());
+    for (size_t i = 0; i < id32s.size(); i++)
+    {
+        sets[i] = boards[0]->numberOfSets(id32s[i]);
+        if (0 == (i % 2))
+        {
+            boards[0]->loseNextSet(id32s[i]);
+        }
+    }
+
+    // Test
+    bool ret = resources[0]->setcheckRemoteValues(id32s, pointers(buffers));
+
+    // Verify: only the variables which did not verify are sent again
+    EXPECT_TRUE(ret);
+    for (size_t i = 0; i < id32s.size(); i++)
+    {
+        EXPECT_EQ(boards[0]->value(id32s[i]), buffers[i]);
+        EXPECT_EQ(boards[0]->numberOfSets(id32s[i]) - sets[i], (0 == (i % 2)) ? 2u : 1u);
+    }
+}
+
+TEST_F(EthLoopback, setcheckRemoteValues_mute_board_negative_001)
+{
+    // Setup
+    std::vector<eOprotID32_t> id32s;
+    std::vector<std::vector<uint8_t>> buffers;
+    makeConfig(2, 37, id32s, buffers);
+    boards[0]->setMute(true);
+
+    // Test
+    bool ret = resources[0]->setcheckRemoteValues(id32s, pointers(buffers), 2, 0.001, 0.050);
+
+    // Verify: it fails, but it leaves no session behind, so that the next group works
+    EXPECT_FALSE(ret);
+    boards[0]->setMute(false);
+    EXPECT_TRUE(eth::theNVmanager::getInstance().group_start());
+    EXPECT_TRUE(eth::theNVmanager::getInstance().group_stop(0.1));
+    EXPECT_TRUE(resources[0]->setcheckRemoteValues(id32s, pointers(buffers)));
+}
+
+TEST_F(EthLoopback, setcheckRemoteValues_inside_group_negative_001)
+{
+    // Setup
+    std::vector<eOprotID32_t> id32s;
+    std::vector<std::vector<uint8_t>> buffers;
+    makeConfig(2, 41, id32s, buffers);
+    eth::theNVmanager &nvman = eth::theNVmanager::getInstance();
+    ASSERT_TRUE(nvman.group_start());
+
+    // Test: it cannot open its own group, and it does not close the one of the caller
+    bool ret = resources[0]->setcheckRemoteValues(id32s, pointers(buffers));
+
+    // Verify
+    EXPECT_FALSE(ret);
+    EXPECT_FALSE(nvman.group_start());
+    EXPECT_TRUE(nvman.group_stop(0.1));
+}
+
+TEST_F(EthLoopback, group_ask_two_boards_positive_001)
+{
+    // Setup
+    std::vector<eOprotID32_t> id32s[2];
+    std::vector<std::vector<uint8_t>> stored[2];
+    std::vector<std::vector<uint8_t>> replies[2];
+    std::vector<void *> values[2];
+    for (size_t b = 0; b < 2; b++)
+    {
+        makeConfig(2 + b, 53 + b, id32s[b], stored[b]);
+        replies[b] = stored[b];
+        for (size_t i = 0; i < id32s[b].size(); i++)
+        {
+            boards[b]->store(id32s[b][i], stored[b][i]);
+            std::fill(replies[b][i].begin(), replies[b][i].end(), 0);
+            values[b].push_back(replies[b][i].data());
+        }
+    }
+    size_t asks[2] = {boards[0]->numberOfAsks(), boards[1]->numberOfAsks()};
+    eth::theNVmanager &nvman = eth::theNVmanager::getInstance();
+
+    // Test: a single transaction for both boards
+    bool ret = nvman.group_start();
+    for (size_t b = 0; b < 2; b++)
+    {
+        ret = nvman.group_ask(resources[b]->getTransceiver(), id32s[b], values[b]) && ret;
+    }
+    ret = nvman.group_stop(0.5) && ret;
+
+    // Verify
+    EXPECT_TRUE(ret);
+    for (size_t b = 0; b < 2; b++)
+    {
+        EXPECT_EQ(boards[b]->numberOfAsks() - asks[b], id32s[b].size());
+        EXPECT_EQ(replies[b], stored[b]);
+    }
+}
+
+TEST_F(EthLoopback, group_session_negative_001)
+{
+    // Setup
+    eth::theNVmanager &nvman = eth::theNVmanager::getInstance();
+    std::vector<eOprotID32_t> id32s = {eoprot_ID_get(eoprot_endpoint_motioncontrol, eoprot_entity_mc_joint, 0, eoprot_tag_mc_joint_config)};
+    std::vector<uint8_t> buffer(nvman.sizeOfNV(id32s[0]));
+    std::vector<void *> values = {buffer.data()};
+
+    // Test and verify: no session
+    EXPECT_FALSE(nvman.group_ask(resources[0]->getTransceiver(), id32s, values));
+    EXPECT_FALSE(nvman.group_stop(0.1));
+
+    // Test and verify: one session per thread
+    EXPECT_TRUE(nvman.group_start());
+    EXPECT_FALSE(nvman.group_start());
+    std::thread other([&nvman]() {
+        EXPECT_TRUE(nvman.group_start());
+        EXPECT_TRUE(nvman.group_stop(0.1));
+    });
+    other.join();
+    EXPECT_TRUE(nvman.group_ask(resources[0]->getTransceiver(), id32s, values));
+    EXPECT_TRUE(nvman.group_stop(0.5));
+    EXPECT_FALSE(nvman.group_stop(0.1));
+}
+
+TEST_F(EthLoopback, ask_replies_before_wait_positive_001)
+{
+    // Setup: replies as fast as possible, so that they may arrive while the asks are still being loaded
+    std::vector<eOprotID32_t> id32s;
+    std::vector<std::vector<uint8_t>> stored;
+    makeConfig(2, 67, id32s, stored);
+    for (size_t i = 0; i < id32s.size(); i++)
+    {
+        boards[0]->store(id32s[i], stored[i]);
+    }
+    std::vector<std::vector<uint8_t>> replies = stored;
+    std::vector<void *> values;
+    for (std::vector<uint8_t> &r : replies)
+    {
+        values.push_back(r.data());
+    }
+
+    // Test and verify
+    for (int n = 0; n < 50; n++)
+    {
+        ASSERT_TRUE(resources[0]->getRemoteValues(id32s, values, 0.5)) << "at attempt #" << n;
+    }
+    EXPECT_EQ(replies, stored);
+}
+
+TEST_F(EthLoopback, serviceCommand_two_threads_positive_001)
+{
+    // Setup
+    std::atomic<int> failures{0};
+    auto commands = [&failures](eOmn_serv_category_t category) {
+        for (int n = 0; n < 20; n++)
+        {
+            if (false == resources[0]->serviceStart(category, 0.2))
+            {
+                failures++;
+            }
+        }
+    };
+
+    // Test: two devices of the same board send their commands at the same time
+    std::thread mc(commands, eomn_serv_category_mc);
+    std::thread ft(commands, eomn_serv_category_ft);
+    mc.join();
+    ft.join();
+
+    // Verify
+    EXPECT_EQ(failures.load(), 0);
+}
+
+TEST_F(EthLoopback, async_bringup_two_boards_positive_001)
+{
+    // Setup: the boards hold their replies until both have been asked for something
+    std::vector<eOprotID32_t> id32s[2];
+    std::vector<std::vector<uint8_t>> buffers[2];
+    size_t asks[2];
+    for (size_t b = 0; b < 2; b++)
+    {
+        makeConfig(2 + b, 79 + b, id32s[b], buffers[b]);
+        asks[b] = boards[b]->numberOfAsks();
+        boards[b]->holdReplies();
+    }
+    eth::AsyncEthResource async0(resources[0]);
+    eth::AsyncEthResource async1(resources[1]);
+    eth::AsyncEthResource *async[2] = {&async0, &async1};
+
+    // Test: the bring-up of the two boards as the devices do it, one after the other without waiting
+    for (size_t b = 0; b < 2; b++)
+    {
+        eth::AsyncEthResource *a = async[b];
+        std::vector<eOprotID32_t> &i = id32s[b];
+        std::vector<std::vector<uint8_t>> &v = buffers[b];
+        ASSERT_TRUE(a->start([a, &i, &v]() { return a->setcheckRemoteValues(i, pointers(v)) && a->serviceStart(eomn_serv_category_mc); }));
+    }
+
+    // Verify: the second board is asked while the first one has not replied yet, that is the two
+    // bring-ups run at the same time; the replies are released in any case
+    bool concurrent = false;
+    for (int k = 0; (k < 200) && !concurrent; k++)
+    {
+        concurrent = (boards[0]->numberOfAsks() > asks[0]) && (boards[1]->numberOfAsks() > asks[1]);
+        if (!concurrent)
+        {
+            SystemClock::delaySystem(0.01);
+        }
+    }
+    for (size_t b = 0; b < 2; b++)
+    {
+        boards[b]->releaseReplies();
+    }
+    EXPECT_TRUE(concurrent);
+
+    // Verify: the calls of this thread wait for the end of the bring-up
+    std::vector<uint8_t> reply(buffers[1].back().size(), 0);
+    EXPECT_TRUE(async1.getRemoteValue(id32s[1].back(), reply.data(), 0.5));
+    EXPECT_EQ(reply, buffers[1].back());
+    EXPECT_TRUE(async0.wait());
+    EXPECT_TRUE(async1.wait());
+    for (size_t b = 0; b < 2; b++)
+    {
+        for (size_t i = 0; i < id32s[b].size(); i++)
+        {
+            EXPECT_EQ(boards[b]->value(id32s[b][i]), buffers[b][i]);
+        }
+    }
+}
+
+// a board whose bring-up is controlled by the test
+class BringUpEthResource_Mock : public eth::EthResource
+{
+   public:
+    MOCK_METHOD(bool, getLocalValue, (const eOprotID32_t, void *), (override));
+    MOCK_METHOD(bool, serviceStart, (eOmn_serv_category_t, double), (override));
+};
+
+TEST(AsyncEthResource, wait_for_bringup_positive_001)
+{
+    // Setup
+    BringUpEthResource_Mock res;
+    eth::AsyncEthResource async(&res);
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+    EXPECT_CALL(res, serviceStart(eomn_serv_category_mc, _)).WillOnce(Return(true));
+    EXPECT_CALL(res, getLocalValue(_, _)).WillOnce(Return(true));
+
+    // Test: the bring-up uses the board, then it waits for the test
+    ASSERT_TRUE(async.start([&async, released]() {
+        bool ok = async.serviceStart(eomn_serv_category_mc);
+        released.wait();
+        return ok;
+    }));
+    std::future<bool> call = std::async(std::launch::async, [&async]() {
+        uint8_t value[4];
+        return async.getLocalValue(0, value);
+    });
+
+    // Verify
+    EXPECT_EQ(call.wait_for(std::chrono::milliseconds(100)), std::future_status::timeout);
+    release.set_value();
+    EXPECT_TRUE(call.get());
+    EXPECT_TRUE(async.wait());
+}
+
+TEST(AsyncEthResource, failed_bringup_negative_001)
+{
+    // Setup
+    BringUpEthResource_Mock res;
+    eth::AsyncEthResource async(&res);
+    EXPECT_CALL(res, getLocalValue(_, _)).Times(0);
+
+    // Test
+    ASSERT_TRUE(async.start([]() { return false; }));
+    uint8_t value[4];
+    bool ret = async.getLocalValue(0, value);
+
+    // Verify
+    EXPECT_FALSE(ret);
+    EXPECT_FALSE(async.wait());
+    EXPECT_EQ(async.resource(), &res);
+}
+
+TEST(AsyncEthResource, start_twice_negative_001)
+{
+    // Setup
+    BringUpEthResource_Mock res;
+    eth::AsyncEthResource async(&res);
+
+    // Test and verify
+    EXPECT_TRUE(async.start([]() { return true; }));
+    EXPECT_FALSE(async.start([]() { return true; }));
+    EXPECT_TRUE(async.wait());
+}
+
+TEST(AsyncEthResource, no_bringup_positive_001)
+{
+    // Setup
+    BringUpEthResource_Mock res;
+    eth::AsyncEthResource async(&res);
+    EXPECT_CALL(res, getLocalValue(_, _)).WillOnce(Return(true));
+
+    // Test and verify: without a bring-up the calls go straight to the board
+    uint8_t value[4];
+    EXPECT_TRUE(async.getLocalValue(0, value));
+}
@@ -0,0 +1,234 @@
+/*
+ * Copyright (C) 2022 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <yarp/sig/Vector.h>
+
+#include <cmath>
+#include <cstring>
+#include <deque>
+#include <limits>
+
+#include "gtest/gtest.h"
+#include "testRandom.h"
+#include <iCub/ctrl/filters.h>
+
+using iCub::ctrl::Filter;
+using yarp::sig::Vector;
+
+namespace
+{
+// the former implementation of Filter, keeping the past values in deques of vectors
+class DequeFilter
+{
+public:
+    DequeFilter(const Vector &num, const Vector &den, const Vector &y0) : b(num), a(den), y(y0)
+    {
+        uold.assign(b.length() - 1, Vector(y0.length(), 0.0));
+        yold.assign(a.length() - 1, Vector(y0.length(), 0.0));
+        init(y0);
+    }
+
+    void init(const Vector &y0)
+    {
+        init(y0, uold.size() > 0 ? uold[0] : Vector(y0.length(), 0.0));
+    }
+
+    void init(const Vector &y0, const Vector &u0)
+    {
+        Vector u_init(y0.length(), 0.0);
+        Vector y_init = y0;
+        y = y0;
+
+        double sum_b = 0.0;
+        for (size_t i = 0; i < b.length(); i++)
+            sum_b += b[i];
+        double sum_a = 0.0;
+        for (size_t i = 0; i < a.length(); i++)
+            sum_a += a[i];
+
+        if (fabs(sum_b) > std::numeric_limits<double>::epsilon())
+        {
+            for (size_t j = 0; j < y0.length(); j++)
+                u_init[j] = y0[j] * (sum_a / sum_b);
+        }
+        else
+        {
+            u_init = u0;
+            if (fabs(sum_a - a[0]) > std::numeric_limits<double>::epsilon())
+                for (size_t j = 0; j < y.length(); j++)
+                    y_init[j] = y[j] * (a[0] / (a[0] - sum_a));
+        }
+
+        for (auto &v : yold)
+            v = y_init;
+        for (auto &v : uold)
+            v = u_init;
+    }
+
+    void setCoeffs(const Vector &num, const Vector &den)
+    {
+        b = num;
+        a = den;
+        uold.assign(b.length() - 1, Vector(y.length(), 0.0));
+        yold.assign(a.length() - 1, Vector(y.length(), 0.0));
+        init(y);
+    }
+
+    const Vector &filt(const Vector &u)
+    {
+        for (size_t j = 0; j < y.length(); j++)
+            y[j] = b[0] * u[j];
+        for (size_t i = 1; i < b.length(); i++)
+            for (size_t j = 0; j < y.length(); j++)
+                y[j] += b[i] * uold[i - 1][j];
+        for (size_t i = 1; i < a.length(); i++)
+            for (size_t j = 0; j < y.length(); j++)
+                y[j] -= a[i] * yold[i - 1][j];
+        for (size_t j = 0; j < y.length(); j++)
+            y[j] /= a[0];
+
+        uold.push_front(u);
+        uold.pop_back();
+        yold.push_front(y);
+        yold.pop_back();
+        return y;
+    }
+
+    Vector b, a, y;
+    std::deque<Vector> uold, yold;
+};
+
+// a stable denominator: den[0] dominates the other coefficients
+Vector randomDen(unsigned int &seed, size_t n)
+{
+    Vector den = randomVector(seed, n, 0.9 / n);
+    den[0] = 1.0 + 0.5 * nextRand(seed);
+    return den;
+}
+
+bool bitExact(const Vector &x, const Vector &y)
+{
+    return (x.length() == y.length()) && (0 == memcmp(x.data(), y.data(), x.length() * sizeof(double)));
+}
+
+void expectSameStates(Filter &filter, const DequeFilter &reference)
+{
+    std::deque<Vector> u, y;
+    filter.getStates(u, y);
+    ASSERT_EQ(u.size(), reference.uold.size());
+    ASSERT_EQ(y.size(), reference.yold.size());
+    for (size_t i = 0; i < u.size(); i++)
+        EXPECT_TRUE(bitExact(u[i], reference.uold[i]));
+    for (size_t i = 0; i < y.size(); i++)
+        EXPECT_TRUE(bitExact(y[i], reference.yold[i]));
+}
+} // namespace
+
+TEST(Filter, bit_exact_with_deques_positive_001)
+{
+    unsigned int seed = 7;
+    for (size_t dim : {1, 2, 3, 7, 16, 64})
+        for (size_t m = 1; m <= 5; m++)
+            for (size_t n = 1; n <= 5; n++)
+            {
+                Vector num = randomVector(seed, m, 1.0);
+                Vector den = randomDen(seed, n);
+                Vector y0 = randomVector(seed, dim, 2.0);
+                Filter filter(num, den, y0);
+                DequeFilter reference(num, den, y0);
+
+                for (int k = 0; k < 200; k++)
+                {
+                    Vector u = randomVector(seed, dim, 5.0);
+                    ASSERT_TRUE(bitExact(filter.filt(u), reference.filt(u))) << "dim " << dim << " m " << m << " n " << n << " k " << k;
+                }
+                expectSameStates(filter, reference);
+                EXPECT_TRUE(bitExact(filter.output(), reference.y));
+            }
+}
+
+TEST(Filter, init_and_coefficients_positive_001)
+{
+    unsigned int seed = 11;
+    const size_t dim = 6;
+    Vector num = randomVector(seed, 4, 1.0);
+    Vector den = randomDen(seed, 4);
+    Filter filter(num, den, randomVector(seed, dim, 1.0));
+    DequeFilter reference(num, den, filter.output());
+
+    auto run = [&](int steps) {
+        for (int k = 0; k < steps; k++)
+        {
+            Vector u = randomVector(seed, dim, 1.0);
+            ASSERT_TRUE(bitExact(filter.filt(u), reference.filt(u)));
+        }
+    };
+
+    run(50);
+
+    // the last input is the guess for the next one
+    Vector y0 = randomVector(seed, dim, 3.0);
+    filter.init(y0);
+    reference.init(y0);
+    expectSameStates(filter, reference);
+    run(50);
+
+    // same lengths: the history is kept
+    Vector num2 = randomVector(seed, 4, 1.0);
+    Vector den2 = randomDen(seed, 4);
+    EXPECT_TRUE(filter.adjustCoeffs(num2, den2));
+    reference.b = num2;
+    reference.a = den2;
+    run(50);
+    EXPECT_FALSE(filter.adjustCoeffs(randomVector(seed, 3, 1.0), den2));
+
+    // new lengths: the history is reinitialized to the current output
+    Vector num3 = randomVector(seed, 2, 1.0);
+    Vector den3 = randomDen(seed, 5);
+    filter.setCoeffs(num3, den3);
+    reference.setCoeffs(num3, den3);
+    expectSameStates(filter, reference);
+    run(50);
+
+    Vector num4, den4;
+    filter.getCoeffs(num4, den4);
+    EXPECT_TRUE(bitExact(num4, num3));
+    EXPECT_TRUE(bitExact(den4, den3));
+
+    // a different number of channels
+    Vector y1 = randomVector(seed, dim + 3, 1.0);
+    filter.init(y1);
+    DequeFilter reference1(num3, den3, y1);
+    for (int k = 0; k < 50; k++)
+    {
+        Vector u = randomVector(seed, dim + 3, 1.0);
+        ASSERT_TRUE(bitExact(filter.filt(u), reference1.filt(u)));
+    }
+}
+
+TEST(Filter, zero_gain_positive_001)
+{
+    // a derivative: sum(num)=0, hence the next input is needed to start without spikes
+    unsigned int seed = 13;
+    const size_t dim = 5;
+    Vector num = {1.0, -1.0};
+    Vector den = {1.0, -0.5};
+    Vector y0 = randomVector(seed, dim, 1.0);
+    Vector u0 = randomVector(seed, dim, 1.0);
+
+    Filter filter(num, den, y0);
+    DequeFilter reference(num, den, y0);
+    filter.init(y0, u0);
+    reference.init(y0, u0);
+    expectSameStates(filter, reference);
+
+    for (int k = 0; k < 100; k++)
+    {
+        Vector u = randomVector(seed, dim, 1.0);
+        ASSERT_TRUE(bitExact(filter.filt(u), reference.filt(u)));
+    }
+}
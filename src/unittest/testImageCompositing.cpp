@@ -0,0 +1,174 @@
+/*
+ * Copyright (C) 2022 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <yarp/sig/Image.h>
+
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "imageCompositing.h"
+#include "testRandom.h"
+
+using yarp::sig::ImageOf;
+using yarp::sig::PixelRgb;
+
+namespace
+{
+// uniform in [0,255]
+unsigned char randomByte(unsigned int &seed)
+{
+    return (unsigned char)(127.5 * (nextRand(seed) + 1.0));
+}
+
+void fillPattern(ImageOf<PixelRgb> &img, unsigned int seed)
+{
+    for (size_t r = 0; r < img.height(); r++)
+    {
+        unsigned char *row = img.getRow(r);
+        for (size_t i = 0; i < img.width() * 3; i++)
+            row[i] = randomByte(seed);
+    }
+}
+
+bool samePixels(const ImageOf<PixelRgb> &a, const ImageOf<PixelRgb> &b, int ax, int ay, int bx, int by, int w, int h)
+{
+    for (int r = 0; r < h; r++)
+        for (int c = 0; c < w; c++)
+            for (int k = 0; k < 3; k++)
+                if (a.getPixelAddress(ax + c, ay + r)[k] != b.getPixelAddress(bx + c, by + r)[k])
+                    return false;
+    return true;
+}
+}  // namespace
+
+TEST(ImageCompositing, alphaToFixed_positive_001)
+{
+    EXPECT_EQ(0, imageCompositing::alphaToFixed(0.0));
+    EXPECT_EQ(128, imageCompositing::alphaToFixed(0.5));
+    EXPECT_EQ(256, imageCompositing::alphaToFixed(1.0));
+    EXPECT_EQ(0, imageCompositing::alphaToFixed(-0.3));
+    EXPECT_EQ(256, imageCompositing::alphaToFixed(2.0));
+}
+
+TEST(ImageCompositing, blendAddRow_matches_scalar_positive_001)
+{
+    // Setup: odd lengths and offsets exercise both the SIMD body and the tail
+    std::vector<unsigned char> src(1031), dst1(1031), dst2(1031);
+    unsigned int seed = 7;
+    for (int alpha = 0; alpha <= 256; alpha++)
+    {
+        for (size_t i = 0; i < src.size(); i++)
+        {
+            src[i] = randomByte(seed);
+            dst1[i] = dst2[i] = randomByte(seed);
+        }
+
+        // Test
+        imageCompositing::blendAddRow(src.data() + 1, dst1.data() + 3, src.size() - 4, alpha);
+        imageCompositing::blendAddRowScalar(src.data() + 1, dst2.data() + 3, src.size() - 4, alpha);
+
+        ASSERT_EQ(dst1, dst2) << "alpha=" << alpha;
+    }
+}
+
+TEST(ImageCompositing, blendAddRow_saturates_positive_001)
+{
+    unsigned char src[32], dst[32];
+    for (int i = 0; i < 32; i++)
+    {
+        src[i] = 255;
+        dst[i] = (unsigned char)(200 + i);
+    }
+
+    imageCompositing::blendAddRow(src, dst, 32, 128);
+
+    for (int i = 0; i < 32; i++)
+    {
+        EXPECT_EQ(255, dst[i]);
+    }
+
+    // (src*alpha)>>8 truncates: 101*128/256 = 50.5 -> 50
+    unsigned char s = 101, d = 0;
+    imageCompositing::blendAddRow(&s, &d, 1, 128);
+    EXPECT_EQ(50, d);
+}
+
+TEST(ImageCompositing, blendAdd_clipping_positive_001)
+{
+    // Setup
+    ImageOf<PixelRgb> src, dst;
+    src.resize(7, 5);
+    dst.resize(10, 6);
+    fillPattern(src, 1);
+    imageCompositing::clear(dst, 0);
+
+    // Test: full weight on a zero canvas is a clipped copy
+    imageCompositing::blendAdd(src, dst, -2, 3, 256);
+
+    EXPECT_TRUE(samePixels(src, dst, 2, 0, 0, 3, 5, 3));
+    EXPECT_EQ(0, dst.getPixelAddress(5, 3)[0]);
+    EXPECT_EQ(0, dst.getPixelAddress(0, 2)[2]);
+}
+
+TEST(ImageCompositing, copy_clear_positive_001)
+{
+    ImageOf<PixelRgb> src, dst;
+    src.resize(4, 4);
+    dst.resize(9, 9);
+    fillPattern(src, 2);
+    imageCompositing::clear(dst, 17);
+
+    imageCompositing::copy(src, dst, 7, 6);
+
+    EXPECT_TRUE(samePixels(src, dst, 0, 0, 7, 6, 2, 3));
+    EXPECT_EQ(17, dst.getPixelAddress(6, 6)[1]);
+    EXPECT_EQ(17, dst.getPixelAddress(8, 5)[0]);
+}
+
+TEST(ImageCompositing, split_merge_horizontal_positive_001)
+{
+    // Setup
+    ImageOf<PixelRgb> dual, left, right, merged;
+    dual.resize(13, 4);
+    fillPattern(dual, 3);
+
+    // Test
+    ASSERT_TRUE(imageCompositing::split(dual, left, right, true));
+
+    EXPECT_EQ(6u, left.width());
+    EXPECT_EQ(4u, right.height());
+    EXPECT_TRUE(samePixels(dual, left, 0, 0, 0, 0, 6, 4));
+    EXPECT_TRUE(samePixels(dual, right, 6, 0, 0, 0, 6, 4));
+
+    ASSERT_TRUE(imageCompositing::merge(left, right, merged, true));
+    EXPECT_EQ(12u, merged.width());
+    EXPECT_TRUE(samePixels(dual, merged, 0, 0, 0, 0, 12, 4));
+}
+
+TEST(ImageCompositing, split_merge_vertical_positive_001)
+{
+    ImageOf<PixelRgb> dual, top, bottom, merged;
+    dual.resize(8, 10);
+    fillPattern(dual, 4);
+
+    ASSERT_TRUE(imageCompositing::split(dual, top, bottom, false));
+
+    EXPECT_TRUE(samePixels(dual, top, 0, 0, 0, 0, 8, 5));
+    EXPECT_TRUE(samePixels(dual, bottom, 0, 5, 0, 0, 8, 5));
+
+    ASSERT_TRUE(imageCompositing::merge(top, bottom, merged, false));
+    EXPECT_TRUE(samePixels(dual, merged, 0, 0, 0, 0, 8, 10));
+}
+
+TEST(ImageCompositing, merge_size_mismatch_negative_001)
+{
+    ImageOf<PixelRgb> a, b, out;
+    a.resize(4, 4);
+    b.resize(5, 4);
+
+    EXPECT_FALSE(imageCompositing::merge(a, b, out, true));
+}
@@ -0,0 +1,299 @@
+/*
+ * Copyright (C) 2022 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <yarp/sig/Matrix.h>
+#include <yarp/sig/Vector.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "testRandom.h"
+#include <iCub/ctrl/fixedKalman.h>
+#include <iCub/ctrl/kalman.h>
+
+using iCub::ctrl::FixedKalman;
+using iCub::ctrl::FixedKalmanBank;
+using iCub::ctrl::Kalman;
+using yarp::sig::Matrix;
+using yarp::sig::Vector;
+
+namespace
+{
+// a symmetric positive definite matrix
+Matrix randomCovariance(unsigned int &seed, size_t n, double gain)
+{
+    Matrix G(n, n), C(n, n);
+    for (size_t i = 0; i < n; i++)
+        for (size_t j = 0; j < n; j++)
+            G(i, j) = nextRand(seed);
+    for (size_t i = 0; i < n; i++)
+        for (size_t j = 0; j < n; j++)
+        {
+            double s = (i == j) ? 0.1 : 0.0;
+            for (size_t k = 0; k < n; k++)
+                s += G(i, k) * G(j, k);
+            C(i, j) = gain * s;
+        }
+    return C;
+}
+
+// position, velocity and acceleration sampled every dt
+Matrix constantAcceleration(double dt)
+{
+    Matrix A(3, 3);
+    A.zero();
+    A(0, 0) = A(1, 1) = A(2, 2) = 1.0;
+    A(0, 1) = A(1, 2) = dt;
+    A(0, 2) = 0.5 * dt * dt;
+    return A;
+}
+
+} // namespace
+
+TEST(FixedKalman, matches_kalman_positive_001)
+{
+    unsigned int seed = 3;
+    const double dt = 0.01;
+    Matrix A = constantAcceleration(dt);
+    Matrix H(1, 3);
+    H.zero();
+    H(0, 0) = 1.0;
+    Matrix Q = randomCovariance(seed, 3, 1e-3);
+    Matrix R = randomCovariance(seed, 1, 1e-2);
+
+    Kalman reference(A, H, Q, R);
+    FixedKalman<3, 1> filter(A, H, Q, R);
+
+    Vector x0 = randomVector(seed, 3, 1.0);
+    Matrix P0 = randomCovariance(seed, 3, 1.0);
+    ASSERT_TRUE(reference.init(x0, P0));
+    ASSERT_TRUE(filter.init(x0, P0));
+    EXPECT_FALSE(filter.init(Vector(2, 0.0), P0));
+
+    for (int k = 0; k < 500; k++)
+    {
+        Vector z(1, sin(k * dt) + 0.01 * nextRand(seed));
+        reference.filt(z);
+        filter.filt(z);
+        ASSERT_LT(maxDeviation(filter.get_x(), reference.get_x()), 1e-9) << "k " << k;
+        ASSERT_LT(maxDeviation(filter.get_P(), reference.get_P()), 1e-9) << "k " << k;
+        ASSERT_LT(maxDeviation(filter.get_K(), reference.get_K()), 1e-9) << "k " << k;
+        ASSERT_LT(maxDeviation(filter.get_S(), reference.get_S()), 1e-9) << "k " << k;
+        ASSERT_NEAR(filter.get_ValidationGate(), reference.get_ValidationGate(), 1e-9) << "k " << k;
+    }
+    EXPECT_LT(maxDeviation(filter.get_y(), reference.get_y()), 1e-9);
+}
+
+TEST(FixedKalman, matches_kalman_with_inputs_positive_001)
+{
+    unsigned int seed = 5;
+    Matrix A = randomCovariance(seed, 4, 0.1);
+    Matrix B(4, 2), H(2, 4);
+    for (size_t i = 0; i < 4; i++)
+        for (size_t j = 0; j < 2; j++)
+        {
+            B(i, j) = nextRand(seed);
+            H(j, i) = nextRand(seed);
+        }
+    Matrix Q = randomCovariance(seed, 4, 1e-2);
+    Matrix R = randomCovariance(seed, 2, 1e-1);
+
+    Kalman reference(A, B, H, Q, R);
+    FixedKalman<4, 2, 2> filter(A, B, H, Q, R);
+
+    for (int k = 0; k < 200; k++)
+    {
+        Vector u = randomVector(seed, 2, 1.0);
+        Vector z = randomVector(seed, 2, 1.0);
+        reference.predict(u);
+        filter.predict(u);
+        ASSERT_LT(maxDeviation(filter.get_x(), reference.get_x()), 1e-9) << "k " << k;
+        reference.correct(z);
+        filter.correct(z);
+        ASSERT_LT(maxDeviation(filter.get_x(), reference.get_x()), 1e-9) << "k " << k;
+        ASSERT_LT(maxDeviation(filter.get_P(), reference.get_P()), 1e-9) << "k " << k;
+        ASSERT_NEAR(filter.get_ValidationGate(), reference.get_ValidationGate(), 1e-9) << "k " << k;
+    }
+
+    // the model can be changed on the fly
+    Matrix R2 = randomCovariance(seed, 2, 1.0);
+    EXPECT_TRUE(reference.set_R(R2));
+    EXPECT_TRUE(filter.set_R(R2));
+    EXPECT_LT(maxDeviation(filter.get_R(), R2), 1e-15);
+    for (int k = 0; k < 50; k++)
+    {
+        Vector u = randomVector(seed, 2, 1.0);
+        Vector z = randomVector(seed, 2, 1.0);
+        reference.filt(u, z);
+        filter.filt(u, z);
+        ASSERT_LT(maxDeviation(filter.get_x(), reference.get_x()), 1e-9) << "k " << k;
+    }
+
+    // measurement noise must be positive definite
+    Matrix singular(2, 2);
+    singular.zero();
+    singular(0, 0) = 1.0;
+    EXPECT_FALSE(filter.set_R(singular));
+    EXPECT_FALSE(filter.set_A(Matrix(3, 3)));
+}
+
+TEST(FixedKalman, steady_state_positive_001)
+{
+    unsigned int seed = 7;
+    const double dt = 0.01;
+    Matrix A = constantAcceleration(dt);
+    Matrix H(1, 3);
+    H.zero();
+    H(0, 0) = 1.0;
+    Matrix Q = randomCovariance(seed, 3, 1e-3);
+    Matrix R = randomCovariance(seed, 1, 1e-2);
+
+    Kalman reference(A, H, Q, R);
+    FixedKalman<3, 1> filter(A, H, Q, R);
+    Matrix P0(3, 3);
+    P0.zero();
+    P0(0, 0) = P0(1, 1) = P0(2, 2) = 1.0;
+    reference.init(Vector(3, 0.0), P0);
+    filter.init(Vector(3, 0.0), P0);
+
+    // let the time-varying filter converge
+    for (int k = 0; k < 20000; k++)
+        reference.filt(Vector(1, sin(k * dt)));
+
+    ASSERT_TRUE(filter.computeSteadyState());
+    EXPECT_TRUE(filter.isSteadyState());
+    EXPECT_LT(maxDeviation(filter.get_K(), reference.get_K()), 1e-8);
+    EXPECT_LT(maxDeviation(filter.get_S(), reference.get_S()), 1e-8);
+
+    filter.init(reference.get_x(), filter.get_P());
+    Matrix K = filter.get_K();
+    for (int k = 0; k < 1000; k++)
+    {
+        Vector z(1, sin(k * dt) + 0.01 * nextRand(seed));
+        reference.filt(z);
+        filter.filt(z);
+        ASSERT_LT(maxDeviation(filter.get_x(), reference.get_x()), 1e-8) << "k " << k;
+        ASSERT_NEAR(filter.get_ValidationGate(), reference.get_ValidationGate(), 1e-6) << "k " << k;
+    }
+    EXPECT_LT(maxDeviation(filter.get_K(), K), 1e-15);
+
+    // changing the model drops the steady-state gain
+    EXPECT_TRUE(filter.set_Q(Q));
+    EXPECT_FALSE(filter.isSteadyState());
+}
+
+TEST(FixedKalman, correct_before_predict_negative_001)
+{
+    unsigned int seed = 5;
+    Matrix A = constantAcceleration(0.01);
+    Matrix H(1, 3);
+    H.zero();
+    H(0, 0) = 1.0;
+    Matrix Q = randomCovariance(seed, 3, 1e-3);
+    Matrix R = randomCovariance(seed, 1, 1e-2);
+
+    // nothing predicted yet: the innovation covariance is the one of the initial conditions
+    FixedKalman<3, 1> filter(A, H, Q, R);
+    Vector z(1, 0.5);
+    filter.correct(z);
+    for (size_t i = 0; i < 3; i++)
+        ASSERT_TRUE(std::isfinite(filter.get_x()[i]));
+    EXPECT_TRUE(std::isfinite(filter.get_ValidationGate()));
+    EXPECT_LT(maxDeviation(filter.get_S(), R), 1e-12);
+
+    // H picks the position
+    Vector x0 = randomVector(seed, 3, 1.0);
+    Matrix P0 = randomCovariance(seed, 3, 1.0);
+    Matrix S0(1, 1);
+    S0(0, 0) = P0(0, 0) + R(0, 0);
+    ASSERT_TRUE(filter.init(x0, P0));
+    EXPECT_LT(maxDeviation(filter.get_S(), S0), 1e-12);
+    filter.correct(z);
+    for (size_t i = 0; i < 3; i++)
+        ASSERT_TRUE(std::isfinite(filter.get_x()[i]));
+    EXPECT_TRUE(std::isfinite(filter.get_ValidationGate()));
+
+    // so for every filter of a bank
+    FixedKalmanBank<3, 1> bank(2, A, H, Q, R);
+    ASSERT_TRUE(bank.init(1, x0, P0));
+    Matrix zb(1, 2);
+    zb(0, 0) = zb(0, 1) = 0.5;
+    bank.correct(zb);
+    for (size_t k = 0; k < 2; k++)
+    {
+        EXPECT_LT(maxDeviation(bank.get_S(k), (k == 0) ? R : S0), 1e-12);
+        EXPECT_TRUE(std::isfinite(bank.get_ValidationGate()[k]));
+        for (size_t i = 0; i < 3; i++)
+            ASSERT_TRUE(std::isfinite(bank.get_x(k)[i]));
+    }
+}
+
+TEST(FixedKalmanBank, matches_fixed_kalman_positive_001)
+{
+    unsigned int seed = 11;
+    const size_t count = 7;
+    Matrix A = randomCovariance(seed, 3, 0.2);
+    Matrix B(3, 1), H(2, 3);
+    for (size_t i = 0; i < 3; i++)
+    {
+        B(i, 0) = nextRand(seed);
+        H(0, i) = nextRand(seed);
+        H(1, i) = nextRand(seed);
+    }
+    Matrix Q = randomCovariance(seed, 3, 1e-2);
+    Matrix R = randomCovariance(seed, 2, 1e-1);
+
+    FixedKalmanBank<3, 2, 1> bank(count, A, B, H, Q, R);
+    ASSERT_EQ(bank.size(), count);
+
+    // each filter with its own noise and initial conditions
+    std::vector<FixedKalman<3, 2, 1>> filters;
+    for (size_t k = 0; k < count; k++)
+    {
+        Matrix Qk = randomCovariance(seed, 3, 1e-2);
+        Matrix Rk = randomCovariance(seed, 2, 1e-1);
+        Vector x0 = randomVector(seed, 3, 1.0);
+        Matrix P0 = randomCovariance(seed, 3, 1.0);
+        filters.emplace_back(A, B, H, Qk, Rk);
+        filters.back().init(x0, P0);
+        ASSERT_TRUE(bank.set_Q(k, Qk));
+        ASSERT_TRUE(bank.set_R(k, Rk));
+        ASSERT_TRUE(bank.init(k, x0, P0));
+    }
+    EXPECT_FALSE(bank.init(count, Vector(3, 0.0), Q));
+
+    Matrix u(1, count), z(2, count);
+    for (int step = 0; step < 300; step++)
+    {
+        for (size_t k = 0; k < count; k++)
+        {
+            u(0, k) = nextRand(seed);
+            z(0, k) = nextRand(seed);
+            z(1, k) = nextRand(seed);
+            filters[k].filt(u.getCol(k), z.getCol(k));
+        }
+        bank.filt(u, z);
+
+        for (size_t k = 0; k < count; k++)
+        {
+            ASSERT_LT(maxDeviation(bank.get_x(k), filters[k].get_x()), 1e-12) << "step " << step << " filter " << k;
+            ASSERT_LT(maxDeviation(bank.get_P(k), filters[k].get_P()), 1e-12) << "step " << step << " filter " << k;
+            ASSERT_NEAR(bank.get_ValidationGate()[k], filters[k].get_ValidationGate(), 1e-12);
+        }
+    }
+
+    // the steady-state gains of the bank are those of the single filters
+    ASSERT_TRUE(bank.computeSteadyState());
+    for (size_t k = 0; k < count; k++)
+    {
+        ASSERT_TRUE(filters[k].computeSteadyState());
+        EXPECT_LT(maxDeviation(bank.get_K(k), filters[k].get_K()), 1e-10);
+        EXPECT_LT(maxDeviation(bank.get_S(k), filters[k].get_S()), 1e-10);
+    }
+}
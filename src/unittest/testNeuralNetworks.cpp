@@ -0,0 +1,149 @@
+/*
+ * Copyright (C) 2022 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <yarp/os/Bottle.h>
+#include <yarp/os/Property.h>
+#include <yarp/sig/Matrix.h>
+#include <yarp/sig/Vector.h>
+
+#include <cmath>
+#include <sstream>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "testRandom.h"
+#include <iCub/ctrl/neuralNetworks.h>
+
+using iCub::ctrl::ff2LayNN;
+using iCub::ctrl::ff2LayNN_tansig_purelin;
+using yarp::os::Property;
+using yarp::sig::Matrix;
+using yarp::sig::Vector;
+
+namespace
+{
+std::string list(unsigned int &seed, int n, double gain)
+{
+    std::ostringstream str;
+    str << "(";
+    for (int i = 0; i < n; i++)
+        str << " " << gain * nextRand(seed);
+    str << " )";
+    return str.str();
+}
+
+Property makeNetwork(int numInput, int numHidden, int numOutput, unsigned int seed)
+{
+    std::ostringstream str;
+    str << "(numInputNodes " << numInput << ") (numHiddenNodes " << numHidden << ") (numOutputNodes " << numOutput << ")";
+    for (int j = 0; j < numHidden; j++)
+        str << " (IW_" << j << " " << list(seed, numInput, 3.0) << ")";
+    str << " (b1 " << list(seed, numHidden, 2.0) << ")";
+    for (int k = 0; k < numOutput; k++)
+        str << " (LW_" << k << " " << list(seed, numHidden, 1.0) << ")";
+    str << " (b2 " << list(seed, numOutput, 1.0) << ")";
+    for (int i = 0; i < numInput; i++)
+        str << " (inMinMaxX_" << i << " (" << -1.0 - i << " " << 2.0 + i << ")) (inMinMaxY_" << i << " (-1.0 1.0))";
+    for (int k = 0; k < numOutput; k++)
+        str << " (outMinMaxX_" << k << " (" << -0.5 * k << " " << 3.0 << ")) (outMinMaxY_" << k << " (-1.0 1.0))";
+
+    Property options;
+    options.fromString(str.str());
+    return options;
+}
+
+// a network relying on the default batched layer functions
+class ff2LayNN_logsig_purelin : public ff2LayNN
+{
+public:
+    ff2LayNN_logsig_purelin(const Property &options) : ff2LayNN(options) {}
+
+    Vector hiddenLayerFcn(const Vector &x) const override
+    {
+        Vector y(x.length());
+        for (size_t i = 0; i < x.length(); i++)
+            y[i] = 1.0 / (1.0 + exp(-x[i]));
+        return y;
+    }
+
+    Vector outputLayerFcn(const Vector &x) const override { return x; }
+    Vector hiddenLayerGrad(const Vector &x) const override { return Vector(x.length(), 0.0); }
+    Vector outputLayerGrad(const Vector &x) const override { return Vector(x.length(), 1.0); }
+};
+
+Matrix makeInputs(size_t N, size_t numInput, unsigned int seed)
+{
+    // inputs span beyond the scaling ranges to hit the saturation of the tansig
+    Matrix X(N, numInput);
+    for (size_t n = 0; n < N; n++)
+        for (size_t i = 0; i < numInput; i++)
+            X(n, i) = 8.0 * nextRand(seed);
+    return X;
+}
+}  // namespace
+
+TEST(NeuralNetworks, batch_predict_matches_single_positive_001)
+{
+    ff2LayNN_tansig_purelin net(makeNetwork(4, 17, 3, 11));
+    ASSERT_TRUE(net.isValid());
+
+    Matrix X = makeInputs(257, 4, 5);
+    Matrix Y;
+    ASSERT_TRUE(net.predict(X, Y));
+    ASSERT_EQ(X.rows(), Y.rows());
+    ASSERT_EQ(3u, Y.cols());
+
+    for (size_t n = 0; n < X.rows(); n++)
+    {
+        Vector y = net.predict(X.getRow(n));
+        for (size_t k = 0; k < y.length(); k++)
+            EXPECT_NEAR(y[k], Y(n, k), 1e-12);
+    }
+}
+
+TEST(NeuralNetworks, batch_predict_default_layers_positive_001)
+{
+    ff2LayNN_logsig_purelin net(makeNetwork(2, 6, 2, 3));
+    ASSERT_TRUE(net.isValid());
+
+    Matrix X = makeInputs(31, 2, 9);
+    Matrix Y;
+    ASSERT_TRUE(net.predict(X, Y));
+
+    for (size_t n = 0; n < X.rows(); n++)
+    {
+        Vector y = net.predict(X.getRow(n));
+        for (size_t k = 0; k < y.length(); k++)
+            EXPECT_NEAR(y[k], Y(n, k), 1e-12);
+    }
+}
+
+TEST(NeuralNetworks, batch_predict_follows_weights_positive_001)
+{
+    // Setup: weights changed after a first prediction must be taken into account
+    ff2LayNN_tansig_purelin net(makeNetwork(3, 5, 1, 21));
+    Matrix X = makeInputs(8, 3, 2);
+    Matrix Y;
+    ASSERT_TRUE(net.predict(X, Y));
+
+    net.get_IW()[2][1] += 0.5;
+    net.get_b2()[0] -= 0.25;
+    ASSERT_TRUE(net.predict(X, Y));
+
+    for (size_t n = 0; n < X.rows(); n++)
+        EXPECT_NEAR(net.predict(X.getRow(n))[0], Y(n, 0), 1e-12);
+}
+
+TEST(NeuralNetworks, batch_predict_wrong_input_negative_001)
+{
+    ff2LayNN_tansig_purelin net(makeNetwork(3, 5, 2, 1));
+    Matrix Y;
+    EXPECT_FALSE(net.predict(Matrix(4, 2), Y));
+
+    ff2LayNN_tansig_purelin empty;
+    EXPECT_FALSE(empty.predict(Matrix(4, 3), Y));
+}
@@ -0,0 +1,174 @@
+/*
+ * Copyright (C) 2022 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <yarp/sig/Matrix.h>
+#include <yarp/sig/Vector.h>
+
+#include <algorithm>
+#include <cmath>
+
+#include "gtest/gtest.h"
+#include "testRandom.h"
+#include <iCub/iDyn/iDyn.h>
+#include <iCub/iDyn/iDynInv.h>
+
+using iCub::iDyn::iCubArmDyn;
+using iCub::iDyn::iCubLegDyn;
+using iCub::iDyn::iDynChain;
+using iCub::iDyn::iDynSensorArm;
+using iCub::iDyn::NewEulMode;
+using yarp::sig::Matrix;
+using yarp::sig::Vector;
+
+namespace
+{
+void setRandomState(unsigned int &seed, iDynChain &fixed, iDynChain &classic)
+{
+    Vector q = randomVector(seed, fixed.getDOF(), 1.0);
+    Vector dq = randomVector(seed, fixed.getDOF(), 2.0);
+    Vector ddq = randomVector(seed, fixed.getDOF(), 5.0);
+    fixed.setAng(q);
+    fixed.setDAng(dq);
+    fixed.setD2Ang(ddq);
+    classic.setAng(q);
+    classic.setDAng(dq);
+    classic.setD2Ang(ddq);
+}
+
+// forces, moments (base and end frames included), link kinematics and torques
+void expectSameOutputs(iDynChain &fixed, iDynChain &classic, double tol)
+{
+    EXPECT_LT(maxDeviation(fixed.getForcesNewtonEuler(), classic.getForcesNewtonEuler()), tol);
+    EXPECT_LT(maxDeviation(fixed.getMomentsNewtonEuler(), classic.getMomentsNewtonEuler()), tol);
+    EXPECT_LT(maxDeviation(fixed.getTorques(), classic.getTorques()), tol);
+    for (unsigned int i = 0; i < fixed.getN(); i++)
+    {
+        EXPECT_LT(maxDeviation(fixed.getAngVel(i), classic.getAngVel(i)), tol) << "link " << i;
+        EXPECT_LT(maxDeviation(fixed.getAngAcc(i), classic.getAngAcc(i)), tol) << "link " << i;
+        EXPECT_LT(maxDeviation(fixed.getLinAcc(i), classic.getLinAcc(i)), tol) << "link " << i;
+        EXPECT_LT(maxDeviation(fixed.getLinAccCOM(i), classic.getLinAccCOM(i)), tol) << "link " << i;
+    }
+}
+} // namespace
+
+TEST(NewtonEuler, chain_matches_classic_positive_001)
+{
+    const NewEulMode modes[] = {iCub::iDyn::STATIC, iCub::iDyn::DYNAMIC, iCub::iDyn::DYNAMIC_W_ROTOR,
+                                iCub::iDyn::DYNAMIC_CORIOLIS_GRAVITY};
+    unsigned int seed = 3;
+    for (NewEulMode mode : modes)
+    {
+        iCubArmDyn fixedArm("right");
+        iCubArmDyn classicArm("right");
+        iDynChain &fixed = *fixedArm.asChain();
+        iDynChain &classic = *classicArm.asChain();
+        EXPECT_TRUE(fixed.getFixedStorageNewtonEuler());
+        classic.setFixedStorageNewtonEuler(false);
+
+        // motor parameters, relevant in DYNAMIC_W_ROTOR only
+        for (unsigned int i = 0; i < fixed.getN(); i++)
+        {
+            double kr = 100.0 + 10.0 * i, Fv = 0.1 * (i + 1), Fs = 0.01 * (i + 1), Im = 1e-5 * (i + 1);
+            ASSERT_TRUE(fixed.setDynamicParameters(i, fixed.getMass(i), fixed.getCOM(i), fixed.getInertia(i), kr, Fv, Fs, Im));
+            ASSERT_TRUE(classic.setDynamicParameters(i, classic.getMass(i), classic.getCOM(i), classic.getInertia(i), kr, Fv, Fs, Im));
+        }
+
+        fixed.prepareNewtonEuler(mode);
+        classic.prepareNewtonEuler(mode);
+        for (int k = 0; k < 20; k++)
+        {
+            setRandomState(seed, fixed, classic);
+            Vector w0 = randomVector(seed, 3, 1.0);
+            Vector dw0 = randomVector(seed, 3, 1.0);
+            Vector ddp0 = randomVector(seed, 3, 10.0);
+            Vector Fend = randomVector(seed, 3, 5.0);
+            Vector Muend = randomVector(seed, 3, 0.5);
+            ASSERT_TRUE(fixed.computeNewtonEuler(w0, dw0, ddp0, Fend, Muend));
+            ASSERT_TRUE(classic.computeNewtonEuler(w0, dw0, ddp0, Fend, Muend));
+            expectSameOutputs(fixed, classic, 1e-10);
+        }
+    }
+}
+
+TEST(NewtonEuler, parameters_change_after_preparation_positive_001)
+{
+    unsigned int seed = 5;
+    iCubLegDyn fixedLeg("left");
+    iCubLegDyn classicLeg("left");
+    iDynChain &fixed = *fixedLeg.asChain();
+    iDynChain &classic = *classicLeg.asChain();
+    classic.setFixedStorageNewtonEuler(false);
+    fixed.prepareNewtonEuler(iCub::iDyn::DYNAMIC);
+    classic.prepareNewtonEuler(iCub::iDyn::DYNAMIC);
+
+    Vector ddp0(3, 0.0);
+    ddp0[2] = 9.81;
+    Vector z3(3, 0.0);
+    setRandomState(seed, fixed, classic);
+    fixed.computeNewtonEuler(z3, z3, ddp0, z3, z3);
+    classic.computeNewtonEuler(z3, z3, ddp0, z3, z3);
+    expectSameOutputs(fixed, classic, 1e-10);
+
+    // the packed constants follow the links edited after prepareNewtonEuler()
+    Matrix I(3, 3);
+    I.zero();
+    I(0, 0) = I(1, 1) = I(2, 2) = 0.01;
+    Matrix HC(4, 4);
+    HC.zero();
+    HC(0, 0) = HC(1, 1) = HC(2, 2) = HC(3, 3) = 1.0;
+    HC(0, 3) = 0.02;
+    HC(1, 3) = -0.01;
+    ASSERT_TRUE(fixed.setDynamicParameters(2, 1.5, HC, I));
+    ASSERT_TRUE(classic.setDynamicParameters(2, 1.5, HC, I));
+    ASSERT_TRUE(fixed.setMass(4, 0.7));
+    ASSERT_TRUE(classic.setMass(4, 0.7));
+
+    setRandomState(seed, fixed, classic);
+    fixed.computeNewtonEuler(z3, z3, ddp0, z3, z3);
+    classic.computeNewtonEuler(z3, z3, ddp0, z3, z3);
+    expectSameOutputs(fixed, classic, 1e-10);
+
+    // the switch can be flipped on a prepared chain
+    fixed.setFixedStorageNewtonEuler(false);
+    EXPECT_FALSE(fixed.getFixedStorageNewtonEuler());
+    fixed.computeNewtonEuler(z3, z3, ddp0, z3, z3);
+    expectSameOutputs(fixed, classic, 1e-15);
+}
+
+TEST(NewtonEuler, sensor_matches_classic_positive_001)
+{
+    const NewEulMode modes[] = {iCub::iDyn::STATIC, iCub::iDyn::DYNAMIC};
+    unsigned int seed = 7;
+    for (NewEulMode mode : modes)
+    {
+        iCubArmDyn fixedArm("left");
+        iCubArmDyn classicArm("left");
+        iDynChain &fixed = *fixedArm.asChain();
+        iDynChain &classic = *classicArm.asChain();
+        classic.setFixedStorageNewtonEuler(false);
+        iDynSensorArm fixedSensor(&fixedArm, mode);
+        iDynSensorArm classicSensor(&classicArm, mode);
+
+        for (int k = 0; k < 20; k++)
+        {
+            setRandomState(seed, fixed, classic);
+            Vector w0 = randomVector(seed, 3, 1.0);
+            Vector dw0 = randomVector(seed, 3, 1.0);
+            Vector ddp0 = randomVector(seed, 3, 10.0);
+            Vector z3(3, 0.0);
+            fixed.initNewtonEuler(w0, dw0, ddp0, z3, z3);
+            classic.initNewtonEuler(w0, dw0, ddp0, z3, z3);
+
+            Vector F = randomVector(seed, 3, 5.0);
+            Vector Mu = randomVector(seed, 3, 0.5);
+            ASSERT_TRUE(fixedSensor.computeFromSensorNewtonEuler(F, Mu));
+            ASSERT_TRUE(classicSensor.computeFromSensorNewtonEuler(F, Mu));
+            expectSameOutputs(fixed, classic, 1e-10);
+            EXPECT_LT(maxDeviation(fixedSensor.getForceMomentEndEff(), classicSensor.getForceMomentEndEff()), 1e-10);
+        }
+    }
+}
@@ -0,0 +1,59 @@
+/*
+ * Copyright (C) 2022 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#pragma once
+
+#include <yarp/sig/Matrix.h>
+#include <yarp/sig/Vector.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+// Reproducible pseudo-random data for the numerical tests: the same seed yields the same
+// sequence on every platform, whatever the standard library in use.
+
+// uniform in [-1,1]
+inline double nextRand(unsigned int &seed)
+{
+    seed = 1103515245 * seed + 12345;
+    return ((seed >> 16) & 0x7fff) / 16383.5 - 1.0;
+}
+
+inline yarp::sig::Vector randomVector(unsigned int &seed, size_t n, double gain)
+{
+    yarp::sig::Vector v(n);
+    for (size_t i = 0; i < n; i++)
+        v[i] = gain * nextRand(seed);
+    return v;
+}
+
+inline yarp::sig::Matrix randomMatrix(unsigned int &seed, size_t rows, size_t cols)
+{
+    yarp::sig::Matrix M(rows, cols);
+    for (size_t i = 0; i < rows; i++)
+        for (size_t j = 0; j < cols; j++)
+            M(i, j) = nextRand(seed);
+    return M;
+}
+
+inline double maxDeviation(const yarp::sig::Matrix &X, const yarp::sig::Matrix &Y)
+{
+    double dev = 0.0;
+    for (size_t i = 0; i < X.rows(); i++)
+        for (size_t j = 0; j < X.cols(); j++)
+            dev = std::max(dev, std::fabs(X(i, j) - Y(i, j)));
+    return dev;
+}
+
+inline double maxDeviation(const yarp::sig::Vector &x, const yarp::sig::Vector &y)
+{
+    double dev = 0.0;
+    for (size_t i = 0; i < x.length(); i++)
+        dev = std::max(dev, std::fabs(x[i] - y[i]));
+    return dev;
+}
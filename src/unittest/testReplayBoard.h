@@ -0,0 +1,324 @@
+/*
+ * Copyright (C) 2022 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#pragma once
+
+#include <yarp/dev/DeviceDriver.h>
+#include <yarp/dev/IControlLimits.h>
+#include <yarp/dev/IControlMode.h>
+#include <yarp/dev/IEncoders.h>
+#include <yarp/dev/IPositionControl.h>
+#include <yarp/dev/IPositionDirect.h>
+#include <yarp/os/Searchable.h>
+#include <yarp/os/Time.h>
+#include <yarp/os/Value.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <vector>
+
+// A control board which records every reference it gets with the time of its arrival, shared by the replay test
+// of the whole body player and by its benchmark.
+
+class ReplayBoard : public yarp::dev::DeviceDriver,
+                    public yarp::dev::IPositionDirect,
+                    public yarp::dev::IEncoders,
+                    public yarp::dev::IControlMode,
+                    public yarp::dev::IPositionControl,
+                    public yarp::dev::IControlLimits
+{
+   public:
+    struct Reference
+    {
+        double arrival;
+        double value;  // of the first joint
+    };
+
+    bool open(yarp::os::Searchable &config) override
+    {
+        axes = config.check("axes", yarp::os::Value(1)).asInt32();
+        q.assign(axes, 0.0);
+        modes.assign(axes, VOCAB_CM_POSITION);
+        return true;
+    }
+
+    bool close() override
+    {
+        return true;
+    }
+
+    std::vector<Reference> references()
+    {
+        std::lock_guard<std::mutex> lck(mtx);
+        return received;
+    }
+
+    // IPositionDirect
+    bool getAxes(int *ax) override
+    {
+        *ax = axes;
+        return true;
+    }
+    bool setPosition(int j, double ref) override
+    {
+        return false;
+    }
+    bool setPositions(const int n_joint, const int *joints, const double *refs) override
+    {
+        return false;
+    }
+    bool setPositions(const double *refs) override
+    {
+        std::lock_guard<std::mutex> lck(mtx);
+        received.push_back({yarp::os::Time::now(), refs[0]});
+        q.assign(refs, refs + axes);
+        return true;
+    }
+    bool getRefPosition(const int joint, double *ref) override
+    {
+        return false;
+    }
+    bool getRefPositions(double *refs) override
+    {
+        return false;
+    }
+    bool getRefPositions(const int n_joint, const int *joints, double *refs) override
+    {
+        return false;
+    }
+
+    // IEncoders
+    bool resetEncoder(int j) override
+    {
+        return false;
+    }
+    bool resetEncoders() override
+    {
+        return false;
+    }
+    bool setEncoder(int j, double val) override
+    {
+        return false;
+    }
+    bool setEncoders(const double *vals) override
+    {
+        return false;
+    }
+    bool getEncoder(int j, double *v) override
+    {
+        return false;
+    }
+    bool getEncoders(double *encs) override
+    {
+        std::lock_guard<std::mutex> lck(mtx);
+        std::copy(q.begin(), q.end(), encs);
+        return true;
+    }
+    bool getEncoderSpeed(int j, double *sp) override
+    {
+        return false;
+    }
+    bool getEncoderSpeeds(double *spds) override
+    {
+        return false;
+    }
+    bool getEncoderAcceleration(int j, double *spds) override
+    {
+        return false;
+    }
+    bool getEncoderAccelerations(double *accs) override
+    {
+        return false;
+    }
+
+    // IControlMode
+    bool getControlMode(int j, int *mode) override
+    {
+        return false;
+    }
+    bool getControlModes(int *modes) override
+    {
+        return false;
+    }
+    bool getControlModes(const int n_joint, const int *joints, int *modes) override
+    {
+        return false;
+    }
+    bool setControlMode(const int j, const int mode) override
+    {
+        return false;
+    }
+    bool setControlModes(const int n_joint, const int *joints, int *modes) override
+    {
+        return false;
+    }
+    bool setControlModes(int *modes) override
+    {
+        this->modes.assign(modes, modes + axes);
+        return true;
+    }
+
+    // IPositionControl: the moves are instantaneous
+    bool positionMove(int j, double ref) override
+    {
+        return false;
+    }
+    bool positionMove(const int n_joint, const int *joints, const double *refs) override
+    {
+        return false;
+    }
+    bool positionMove(const double *refs) override
+    {
+        std::lock_guard<std::mutex> lck(mtx);
+        q.assign(refs, refs + axes);
+        return true;
+    }
+    bool getTargetPosition(const int joint, double *ref) override
+    {
+        return false;
+    }
+    bool getTargetPositions(double *refs) override
+    {
+        return false;
+    }
+    bool getTargetPositions(const int n_joint, const int *joints, double *refs) override
+    {
+        return false;
+    }
+    bool relativeMove(int j, double delta) override
+    {
+        return false;
+    }
+    bool relativeMove(const int n_joint, const int *joints, const double *deltas) override
+    {
+        return false;
+    }
+    bool relativeMove(const double *deltas) override
+    {
+        return false;
+    }
+    bool checkMotionDone(int j, bool *flag) override
+    {
+        return false;
+    }
+    bool checkMotionDone(const int n_joint, const int *joints, bool *flag) override
+    {
+        return false;
+    }
+    bool checkMotionDone(bool *flag) override
+    {
+        *flag = true;
+        return true;
+    }
+    bool setRefSpeed(int j, double sp) override
+    {
+        return false;
+    }
+    bool setRefSpeeds(const int n_joint, const int *joints, const double *spds) override
+    {
+        return false;
+    }
+    bool setRefSpeeds(const double *spds) override
+    {
+        return false;
+    }
+    bool setRefAcceleration(int j, double acc) override
+    {
+        return false;
+    }
+    bool setRefAccelerations(const int n_joint, const int *joints, const double *accs) override
+    {
+        return false;
+    }
+    bool setRefAccelerations(const double *accs) override
+    {
+        return false;
+    }
+    bool getRefSpeed(int j, double *ref) override
+    {
+        return false;
+    }
+    bool getRefSpeeds(const int n_joint, const int *joints, double *spds) override
+    {
+        return false;
+    }
+    bool getRefSpeeds(double *spds) override
+    {
+        return false;
+    }
+    bool getRefAcceleration(int j, double *acc) override
+    {
+        return false;
+    }
+    bool getRefAccelerations(const int n_joint, const int *joints, double *accs) override
+    {
+        return false;
+    }
+    bool getRefAccelerations(double *accs) override
+    {
+        return false;
+    }
+    bool stop(int j) override
+    {
+        return false;
+    }
+    bool stop(const int n_joint, const int *joints) override
+    {
+        return false;
+    }
+    bool stop() override
+    {
+        return false;
+    }
+
+    // IControlLimits
+    bool setLimits(int axis, double min, double max) override
+    {
+        return false;
+    }
+    bool getLimits(int axis, double *min, double *max) override
+    {
+        *min = -1000.0;
+        *max = 1000.0;
+        return true;
+    }
+    bool setVelLimits(int axis, double min, double max) override
+    {
+        return false;
+    }
+    bool getVelLimits(int axis, double *min, double *max) override
+    {
+        return false;
+    }
+
+   private:
+    int axes{0};
+    std::mutex mtx;
+    std::vector<double> q;
+    std::vector<int> modes;
+    std::vector<Reference> received;
+};
+
+// a yarpdatadumper log of the given duration, every joint being gain times the time since start0
+inline void writeDataset(const std::filesystem::path &file, int axes, double gain, double start0, double start, double rate,
+                         double duration)
+{
+    std::ofstream out(file);
+    out.precision(12);
+    int n = static_cast<int>(duration * rate);
+    for (int i = 0; i <= n; i++)
+    {
+        double t = start + i / rate;
+        out << i << " " << t;
+        for (int j = 0; j < axes; j++)
+            out << " " << gain * (t - start0);
+        out << "\n";
+    }
+}
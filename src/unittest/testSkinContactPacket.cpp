@@ -0,0 +1,159 @@
+/*
+ * Copyright (C) 2022 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <yarp/os/Portable.h>
+#include <yarp/sig/Vector.h>
+
+#include <vector>
+
+#include "gtest/gtest.h"
+#include <iCub/skinDynLib/skinContactList.h>
+#include <iCub/skinDynLib/skinContactPacket.h>
+
+using iCub::skinDynLib::skinContact;
+using iCub::skinDynLib::skinContactList;
+using iCub::skinDynLib::skinContactPacket;
+using yarp::os::Portable;
+using yarp::sig::Vector;
+
+namespace
+{
+skinContactList makeContacts()
+{
+    Vector CoP(3), geo(3), normal(3), F(3), Mu(3);
+    skinContactList l;
+    for (int i = 0; i < 3; i++)
+    {
+        for (int k = 0; k < 3; k++)
+        {
+            CoP[k] = 0.01 * (i + k);
+            geo[k] = 0.02 * (i - k);
+            normal[k] = (k == i) ? 1.0 : 0.0;
+            F[k] = 1.5 * (k + 1);
+            Mu[k] = -0.5 * k;
+        }
+        std::vector<unsigned int> taxels;
+        for (int t = 0; t <= 4 * i; t++)
+            taxels.push_back(12 * i + t);
+        l.push_back(skinContact(i == 2 ? iCub::skinDynLib::RIGHT_ARM : iCub::skinDynLib::LEFT_ARM,
+                                iCub::skinDynLib::SKIN_LEFT_FOREARM, 4 + i, CoP, geo, taxels,
+                                10.0 * (i + 1), normal, F, Mu));
+    }
+
+    return l;
+}
+
+void expectSame(const skinContact &a, const skinContact &b, bool withTaxels)
+{
+    EXPECT_EQ(a.getId(), b.getId());
+    EXPECT_EQ(a.getBodyPart(), b.getBodyPart());
+    EXPECT_EQ(a.getLinkNumber(), b.getLinkNumber());
+    EXPECT_EQ(a.getSkinPart(), b.getSkinPart());
+    EXPECT_EQ(a.getActiveTaxels(), b.getActiveTaxels());
+    EXPECT_DOUBLE_EQ(a.getPressure(), b.getPressure());
+    for (int k = 0; k < 3; k++)
+    {
+        EXPECT_DOUBLE_EQ(a.getCoP()[k], b.getCoP()[k]);
+        EXPECT_DOUBLE_EQ(a.getForce()[k], b.getForce()[k]);
+        EXPECT_DOUBLE_EQ(a.getMoment()[k], b.getMoment()[k]);
+        EXPECT_DOUBLE_EQ(a.getGeoCenter()[k], b.getGeoCenter()[k]);
+        EXPECT_DOUBLE_EQ(a.getNormalDir()[k], b.getNormalDir()[k]);
+    }
+    if (withTaxels)
+        EXPECT_EQ(a.getTaxelList(), b.getTaxelList());
+    else
+        EXPECT_EQ(b.getTaxelList(), std::vector<unsigned int>(a.getActiveTaxels(), 0));
+}
+
+// the same contacts detected again, which get new ids
+skinContactList detectedAgain(const skinContactList &l)
+{
+    skinContactList again;
+    for (auto &c : l)
+        again.push_back(skinContact(c.getBodyPart(), c.getSkinPart(), c.getLinkNumber(), c.getCoP(),
+                                    c.getGeoCenter(), c.getTaxelList(), c.getPressure(),
+                                    c.getNormalDir(), c.getForce(), c.getMoment()));
+    return again;
+}
+} // namespace
+
+TEST(SkinContactPacket, skin_contact_packet_round_trip_positive_001)
+{
+    skinContactList l = makeContacts();
+    skinContactPacket sent;
+    sent.fromSkinContactList(l);
+
+    skinContactPacket received;
+    ASSERT_TRUE(Portable::copyPortable(sent, received));
+    ASSERT_EQ(received.size(), l.size());
+    ASSERT_TRUE(received.hasTaxelList());
+
+    skinContactList r = received.toSkinContactList();
+    for (size_t i = 0; i < l.size(); i++)
+    {
+        expectSame(l[i], r[i], true);
+        const unsigned int *taxels = received.getTaxelList(i);
+        ASSERT_NE(taxels, nullptr);
+        EXPECT_EQ(taxels[0], l[i].getTaxelList()[0]);
+    }
+}
+
+TEST(SkinContactPacket, skin_contact_packet_without_taxel_list_positive_001)
+{
+    skinContactList l = makeContacts();
+    skinContactPacket sent;
+    sent.fromSkinContactList(l, false);
+
+    skinContactPacket received;
+    ASSERT_TRUE(Portable::copyPortable(sent, received));
+    EXPECT_FALSE(received.hasTaxelList());
+    for (size_t i = 0; i < l.size(); i++)
+    {
+        EXPECT_EQ(received.getTaxelList(i), nullptr);
+        expectSame(l[i], received.toSkinContact(i), false);
+    }
+}
+
+TEST(SkinContactPacket, skin_contact_packet_empty_positive_001)
+{
+    skinContactPacket sent, received;
+    sent.fromSkinContactList(makeContacts());
+    ASSERT_TRUE(Portable::copyPortable(sent, received));
+
+    sent.clear();
+    ASSERT_TRUE(Portable::copyPortable(sent, received));
+    EXPECT_EQ(received.size(), 0u);
+    EXPECT_TRUE(received.toSkinContactList().empty());
+}
+
+TEST(SkinContactPacket, skin_contact_packet_same_contacts_positive_001)
+{
+    skinContactList l = makeContacts();
+    skinContactPacket a, b;
+    a.fromSkinContactList(l);
+
+    // the ids are ignored
+    b.fromSkinContactList(detectedAgain(l));
+    EXPECT_NE(a[0].contactId, b[0].contactId);
+    EXPECT_TRUE(a.sameContacts(b));
+}
+
+TEST(SkinContactPacket, skin_contact_packet_same_contacts_negative_001)
+{
+    skinContactList l = makeContacts();
+    skinContactPacket a, b;
+    a.fromSkinContactList(l);
+
+    skinContactList again = detectedAgain(l);
+    again[1].setPressure(again[1].getPressure() + 1.0);
+    b.fromSkinContactList(again);
+    EXPECT_FALSE(a.sameContacts(b));
+
+    again.pop_back();
+    b.fromSkinContactList(again);
+    EXPECT_FALSE(a.sameContacts(b));
+}
@@ -0,0 +1,206 @@
+/*
+ * Copyright (C) 2022 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <yarp/os/Property.h>
+#include <yarp/os/Value.h>
+#include <yarp/sig/Vector.h>
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "testRandom.h"
+#include <iCub/perception/sensors.h>
+#include <iCub/perception/springyFingers.h>
+
+using iCub::perception::Sensor;
+using iCub::perception::SpringyFinger;
+using iCub::perception::SpringyFingersBatch;
+using yarp::os::Property;
+using yarp::os::Value;
+using yarp::sig::Vector;
+
+namespace
+{
+// a sensor replaying the sample stored at the address it is configured with
+class ReplaySensor : public Sensor
+{
+public:
+    bool configure(void *source, const Property &options) override
+    {
+        this->source = source;
+        name = options.find("name").asString();
+        return configured = true;
+    }
+
+    bool getOutput(Value &in) const override
+    {
+        in = Value(*static_cast<const double *>(source));
+        return configured;
+    }
+};
+
+// the same layout of the hand as in SpringyFingersModel
+const char *names[5] = {"thumb", "index", "middle", "ring", "little"};
+const int joints[5] = {10, 12, 14, 15, 15};
+const std::vector<int> analogs[5] = {{1, 2}, {4, 5}, {7, 8}, {9, 10, 11}, {12, 13, 14}};
+
+class Hand
+{
+public:
+    Vector encs;
+    Vector analog;
+    SpringyFinger fingers[5];
+    ReplaySensor sensors[5][4];
+    SpringyFingersBatch batch;
+
+    Hand() : encs(16, 0.0), analog(15, 0.0)
+    {
+        for (int f = 0; f < 5; f++)
+        {
+            Property options;
+            options.put("name", names[f]);
+            fingers[f].fromProperty(options);
+
+            Property in;
+            in.put("name", "In_0");
+            sensors[f][0].configure(&encs[joints[f]], in);
+            fingers[f].attachSensor(sensors[f][0]);
+            for (size_t c = 0; c < analogs[f].size(); c++)
+            {
+                Property out;
+                out.put("name", "Out_" + std::to_string(c));
+                sensors[f][c + 1].configure(&analog[analogs[f][c]], out);
+                fingers[f].attachSensor(sensors[f][c + 1]);
+            }
+
+            batch.addFinger(fingers[f], joints[f], analogs[f]);
+        }
+    }
+
+    // distal joints following the motor joint as for a free finger,
+    // plus a deflection when pushing against an obstacle
+    void setJoint(int f, double q, double contact)
+    {
+        encs[joints[f]] = q;
+        for (size_t c = 0; c < analogs[f].size(); c++)
+            analog[analogs[f][c]] = 60.0 + (1.2 + 0.3 * c) * q + 8.0 * std::sin(0.05 * q + f) + contact * (c + 1);
+    }
+
+    void train(int f, unsigned int &seed, double phase)
+    {
+        fingers[f].calibrate(Property("(reset)"));
+        for (int k = 0; k < 60; k++)
+        {
+            double q = 10.0 + 80.0 * (0.5 + 0.5 * std::sin(0.11 * k + phase));
+            setJoint(f, q, 0.5 * nextRand(seed));
+            fingers[f].calibrate(Property("(feed)"));
+        }
+        fingers[f].calibrate(Property("(train)"));
+    }
+
+    Vector fingerOutputs()
+    {
+        Vector out(5);
+        for (int f = 0; f < 5; f++)
+        {
+            Value val;
+            fingers[f].getOutput(val);
+            out[f] = val.asFloat64();
+        }
+        return out;
+    }
+};
+
+// a recorded grasp: fingers closing at different speeds until they touch
+void playGrasp(Hand &hand, unsigned int &seed, int frame)
+{
+    for (int f = 0; f < 5; f++)
+    {
+        double q = std::min(90.0, 10.0 + (0.4 + 0.1 * f) * frame);
+        double contact = (q > 50.0 + 5.0 * f) ? 0.8 * (q - 50.0 - 5.0 * f) : 0.0;
+        hand.setJoint(f, q + 0.2 * nextRand(seed), contact + 0.3 * nextRand(seed));
+    }
+}
+
+void expectEqualOutputs(Hand &hand, const std::string &what)
+{
+    Vector batchOut;
+    ASSERT_TRUE(hand.batch.evaluate(hand.encs, hand.analog, batchOut)) << what;
+    ASSERT_EQ(batchOut.length(), 5);
+
+    Vector out = hand.fingerOutputs();
+    for (int f = 0; f < 5; f++)
+        ASSERT_NEAR(batchOut[f], out[f], 1e-9 * std::max(1.0, std::fabs(out[f]))) << what << " finger " << names[f];
+}
+} // namespace
+
+TEST(SpringyFingers, batch_matches_fingers_positive_001)
+{
+    unsigned int seed = 3;
+    Hand hand;
+    for (int f = 0; f < 5; f++)
+        hand.train(f, seed, 0.7 * f);
+    ASSERT_EQ(hand.batch.getNumFingers(), 5);
+
+    for (int frame = 0; frame < 300; frame++)
+    {
+        playGrasp(hand, seed, frame);
+        expectEqualOutputs(hand, "frame " + std::to_string(frame));
+    }
+}
+
+TEST(SpringyFingers, batch_follows_calibration_positive_001)
+{
+    unsigned int seed = 5;
+    Hand hand;
+
+    // untrained machines predict zeros
+    playGrasp(hand, seed, 100);
+    expectEqualOutputs(hand, "untrained");
+
+    for (int f = 0; f < 5; f++)
+        hand.train(f, seed, 0.3 * f);
+    playGrasp(hand, seed, 120);
+    expectEqualOutputs(hand, "trained");
+
+    // the batch picks up the new machine and gain of a finger
+    hand.train(3, seed, 2.0);
+    Property current;
+    hand.fingers[1].toProperty(current);
+    Property options(current.toString().c_str());
+    options.put("output_gain", 2.5);
+    hand.fingers[1].fromProperty(options);
+    for (int c = 0; c < 3; c++)
+        hand.fingers[1].attachSensor(hand.sensors[1][c]);
+    playGrasp(hand, seed, 140);
+    expectEqualOutputs(hand, "retrained");
+}
+
+TEST(SpringyFingers, batch_inconsistent_layout_negative_001)
+{
+    SpringyFinger ring;
+    Property options;
+    options.put("name", "ring");
+    ASSERT_TRUE(ring.fromProperty(options));
+
+    SpringyFingersBatch batch;
+    EXPECT_FALSE(batch.addFinger(ring, -1, {9, 10, 11}));
+    EXPECT_FALSE(batch.addFinger(ring, 15, {}));
+
+    // the ring finger senses three distal joints
+    ASSERT_TRUE(batch.addFinger(ring, 15, {9, 10}));
+    Vector out;
+    EXPECT_FALSE(batch.evaluate(Vector(16, 0.0), Vector(15, 0.0), out));
+
+    batch.clear();
+    ASSERT_TRUE(batch.addFinger(ring, 15, {9, 10, 11}));
+    EXPECT_TRUE(batch.evaluate(Vector(16, 0.0), Vector(15, 0.0), out));
+    EXPECT_FALSE(batch.evaluate(Vector(10, 0.0), Vector(15, 0.0), out));
+}
@@ -0,0 +1,141 @@
+/*
+ * Copyright (C) 2022 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+// Replay of a small dataset of two parts, sampled at different rates and starting at different times, on a
+// board which records every reference it gets with the time of its arrival. Every joint of the dataset is
+// 10 times the logged time, so the references of the two parts sent in the same tick must be equal.
+
+#include <yarp/dev/Drivers.h>
+#include <yarp/dev/PolyDriver.h>
+#include <yarp/os/Property.h>
+#include <yarp/os/Time.h>
+
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+
+#include "ReplayEngine.h"
+#include "gtest/gtest.h"
+#include "testReplayBoard.h"
+
+namespace
+{
+constexpr double period = 0.01;
+constexpr double gain = 10.0;  // [deg/s] of every joint of the dataset
+
+class WholeBodyPlayer : public ::testing::Test
+{
+   protected:
+    static void SetUpTestSuite()
+    {
+        yarp::dev::Drivers::factory().add(new yarp::dev::DriverCreatorOf<ReplayBoard>("replayBoard", "", "ReplayBoard"));
+    }
+
+    void SetUp() override
+    {
+        dir = std::filesystem::temp_directory_path() / "testWholeBodyPlayer";
+        std::filesystem::create_directories(dir);
+    }
+
+    void TearDown() override
+    {
+        std::filesystem::remove_all(dir);
+    }
+
+    bool openBoard(yarp::dev::PolyDriver &driver, ReplayBoard *&board, int axes)
+    {
+        yarp::os::Property options;
+        options.put("device", "replayBoard");
+        options.put("axes", axes);
+        return driver.open(options) && driver.view(board);
+    }
+
+    std::filesystem::path dir;
+};
+
+}  // namespace
+
+TEST_F(WholeBodyPlayer, replay_sync_positive_001)
+{
+    // head at 100 Hz, torso at 30 Hz starting 13 ms later and ending 0.5 s earlier
+    const double start0 = 1000.0;
+    writeDataset(dir / "head.log", 6, gain, start0, start0, 100.0, 2.0);
+    writeDataset(dir / "torso.log", 3, gain, start0, start0 + 0.013, 30.0, 1.5);
+
+    yarp::dev::PolyDriver headDriver, torsoDriver;
+    ReplayBoard *head = nullptr;
+    ReplayBoard *torso = nullptr;
+    ASSERT_TRUE(openBoard(headDriver, head, 6));
+    ASSERT_TRUE(openBoard(torsoDriver, torso, 3));
+
+    ReplayEngine engine(period);
+    ASSERT_TRUE(engine.addPart("head", (dir / "head.log").string(), headDriver, 20, false));
+    ASSERT_TRUE(engine.addPart("torso", (dir / "torso.log").string(), torsoDriver, 20, false));
+    ASSERT_TRUE(engine.start());
+
+    double t0 = yarp::os::Time::now();
+    while (!engine.isDone() && !engine.inError() && (yarp::os::Time::now() - t0 < 10.0))
+        yarp::os::Time::delay(0.05);
+    engine.stop();
+
+    ASSERT_FALSE(engine.inError());
+    ASSERT_TRUE(engine.isDone());
+
+    // cross-part sync: in every tick the torso reference is the one of the head
+    auto headRefs = head->references();
+    auto torsoRefs = torso->references();
+    ASSERT_GT(headRefs.size(), 150u);
+    ASSERT_GT(torsoRefs.size(), 100u);
+
+    // the torso holds its first and its last sample while the head moves
+    const double torsoStart = gain * 0.013 + 1e-6;
+    const double torsoEnd = gain * (1.5 + 0.013) - 1e-6;
+    size_t compared = 0;
+    for (const auto &t : torsoRefs)
+    {
+        if ((t.value <= torsoStart) || (t.value >= torsoEnd))
+            continue;
+
+        auto h = std::min_element(headRefs.begin(), headRefs.end(), [&t](const auto &a, const auto &b) {
+            return std::fabs(a.arrival - t.arrival) < std::fabs(b.arrival - t.arrival);
+        });
+        ASSERT_LT(std::fabs(h->arrival - t.arrival), 0.5 * period);
+        EXPECT_NEAR(h->value, t.value, 1e-6) << "at " << t.arrival - t0 << " [s]";
+        compared++;
+    }
+    EXPECT_GT(compared, 100u);
+
+    // the references of each part follow the playback time
+    for (size_t i = 1; i < headRefs.size(); i++)
+        EXPECT_GE(headRefs[i].value, headRefs[i - 1].value);
+
+    // the timing of the ticks is measured by wholeBodyPlayerBenchmark
+    ReplayEngine::Stats stats = engine.getStats();
+    EXPECT_GT(stats.ticks, 150u);
+    EXPECT_EQ(stats.underruns, 0u);
+
+    headDriver.close();
+    torsoDriver.close();
+}
+
+TEST_F(WholeBodyPlayer, replay_empty_dataset_negative_001)
+{
+    std::ofstream(dir / "empty.log").close();
+
+    yarp::dev::PolyDriver driver;
+    ReplayBoard *board = nullptr;
+    ASSERT_TRUE(openBoard(driver, board, 2));
+
+    ReplayEngine engine(period);
+    ASSERT_TRUE(engine.addPart("head", (dir / "empty.log").string(), driver, 20, false));
+    EXPECT_FALSE(engine.start());
+    EXPECT_TRUE(board->references().empty());
+
+    driver.close();
+}
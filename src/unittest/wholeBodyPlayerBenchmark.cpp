@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2022 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+// Timing of the ticks of the whole body player while it replays the same
+// dataset on a number of boards which record every reference they get: the
+// mean and the standard deviation of the period, the largest jitter, the
+// missed ticks and the time spent sending the references of all the parts in
+// a tick, together with the buffer underruns of the loader.
+//
+// wholeBodyPlayerBenchmark [--parts 6] [--axes 6] [--period 0.01] [--rate 100] [--duration 10]
+
+#include <cstdio>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <yarp/dev/Drivers.h>
+#include <yarp/dev/PolyDriver.h>
+#include <yarp/os/Property.h>
+#include <yarp/os/Time.h>
+#include <yarp/os/Value.h>
+
+#include "ReplayEngine.h"
+#include "testReplayBoard.h"
+
+using namespace yarp::os;
+using namespace yarp::dev;
+
+
+/***************************************************************************/
+int main(int argc, char *argv[])
+{
+    Property options;
+    options.fromCommand(argc,argv);
+
+    int parts=options.check("parts",Value(6)).asInt32();
+    int axes=options.check("axes",Value(6)).asInt32();
+    double period=options.check("period",Value(0.01)).asFloat64();
+    double rate=options.check("rate",Value(100.0)).asFloat64();
+    double duration=options.check("duration",Value(10.0)).asFloat64();
+
+    Drivers::factory().add(new DriverCreatorOf<ReplayBoard>("replayBoard","","ReplayBoard"));
+
+    auto dir=std::filesystem::temp_directory_path()/"wholeBodyPlayerBenchmark";
+    std::filesystem::create_directories(dir);
+
+    std::vector<std::unique_ptr<PolyDriver>> drivers;
+    ReplayEngine engine(period);
+    bool ok=true;
+    for (int i=0; (i<parts) && ok; i++)
+    {
+        std::string name="part"+std::to_string(i);
+        auto file=dir/(name+".log");
+        writeDataset(file,axes,10.0,0.0,0.0,rate,duration);
+
+        Property board;
+        board.put("device","replayBoard");
+        board.put("axes",axes);
+        drivers.push_back(std::make_unique<PolyDriver>());
+        ok=drivers.back()->open(board) &&
+           engine.addPart(name,file.string(),*drivers.back(),20,false);
+    }
+
+    if (ok && engine.start())
+    {
+        double t0=Time::now();
+        while (!engine.isDone() && !engine.inError() && (Time::now()-t0<2.0*duration+5.0))
+            Time::delay(0.05);
+        engine.stop();
+
+        ReplayEngine::Stats stats=engine.getStats();
+        printf("parts | period [ms] | mean [ms] | std [ms] | max jitter [ms] | missed | send mean [ms] | send max [ms] | underruns\n");
+        printf("%5d | %11.3f | %9.3f | %8.3f | %15.3f | %6zu | %14.3f | %13.3f | %9zu\n",
+               parts,1e3*period,1e3*stats.meanPeriod,1e3*stats.stdPeriod,1e3*stats.maxJitter,
+               stats.missedTicks,1e3*stats.meanSend,1e3*stats.maxSend,stats.underruns);
+        ok=!engine.inError();
+    }
+    else
+    {
+        printf("unable to start the replay\n");
+        ok=false;
+    }
+
+    for (auto &driver : drivers)
+        driver->close();
+    std::filesystem::remove_all(dir);
+
+    return (ok ? 0 : 1);
+}